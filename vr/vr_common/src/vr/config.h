@@ -18,6 +18,10 @@
 #	define VR_ENV_LOG_ROOT          VR_APP_NAME "_LOG_ROOT"
 #endif
 
+#if !defined (VR_ENV_LOG_ASYNC)
+#	define VR_ENV_LOG_ASYNC         VR_APP_NAME "_LOG_ASYNC"
+#endif
+
 #if !defined (VR_ENV_SIG_HANDLER)
 #	define VR_ENV_SIG_HANDLER       VR_APP_NAME "_SIG_HANDLER"
 #endif
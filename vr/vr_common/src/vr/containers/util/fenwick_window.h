@@ -16,23 +16,48 @@ template
 <
     std::size_t WINDOW      = (1L << 30), // in whatever units are meaningful for 'T'
     typename BIN_TYPE       = int16_t,
-    int32_t BIN_COUNT       = (2 * sys::cpu_info::cache::static_line_size () / sizeof (BIN_TYPE)) // [heuristic default] number of bins in window
+    int32_t BIN_COUNT       = (2 * sys::cpu_info::cache::static_line_size () / sizeof (BIN_TYPE)), // [heuristic default] number of bins in window
+    bool MEMOIZED           = false // if 'true', 'count()' is O(1) at the cost of a slightly larger footprint
 >
 struct fenwick_window_options
 {
     static constexpr std::size_t window     = WINDOW;
     using bin_type                          = BIN_TYPE;
     static constexpr int32_t bin_count      = BIN_COUNT;
+    static constexpr bool memoized          = MEMOIZED;
 
 }; // end of traits
 //............................................................................
-// TODO
-// - memoized impl, perhaps enabled by a trait?
+//............................................................................
+namespace impl
+{
+
+template<typename C, bool MEMOIZED>
+struct fenwick_window_memo
+{
+    VR_FORCEINLINE C memoized_count () const { return 0; } // never called
+    VR_FORCEINLINE void memoize (C const) { }
+
+}; // end of master
+
+template<typename C>
+struct fenwick_window_memo<C, /* MEMOIZED */true>
+{
+    VR_FORCEINLINE C memoized_count () const { return m_count; }
+    VR_FORCEINLINE void memoize (C const count) { m_count = count; }
+
+    C m_count { };
+
+}; // end of specialization
+
+} // end of 'impl'
+//............................................................................
+//............................................................................
 /**
  * @cite FTs
  */
 template<typename T, typename OPTIONS = fenwick_window_options<>>
-class fenwick_window final
+class fenwick_window final: private impl::fenwick_window_memo<std::conditional_t<(sizeof (typename OPTIONS::bin_type) > sizeof (int32_t)), typename OPTIONS::bin_type, int32_t>, OPTIONS::memoized>
 {
     private: // ..............................................................
 
@@ -47,10 +72,11 @@ class fenwick_window final
     public: // ...............................................................
 
         using options           = OPTIONS;
-        using window_count_type = int32_t;
+        using window_count_type = std::conditional_t<(sizeof (bin_type) > sizeof (int32_t)), bin_type, int32_t>;
 
         static constexpr std::size_t window ()  { return OPTIONS::window; }
         static constexpr int32_t bin_count ()   { return OPTIONS::bin_count; }
+        static constexpr bool memoized ()       { return OPTIONS::memoized; }
 
 
         fenwick_window (T const start_time) :
@@ -63,10 +89,17 @@ class fenwick_window final
         // ACCESSORs:
 
         /**
-         * @return running window count as of the last @ref add() time
+         * @return running window count as of the last @ref add() time [O(1) if @ref memoized()]
          */
         window_count_type count () const;
 
+        /**
+         * @return window count as of 'time' (which must not be earlier than the last @ref add()
+         *         time), i.e. what @ref count() would return after advancing the window right edge
+         *         to 'time' without adding anything
+         */
+        window_count_type count (T const time) const;
+
         // MUTATORs:
 
         /**
@@ -82,13 +115,17 @@ class fenwick_window final
          *
          *       [and of course such "rollback" must follow the add() it is trying to roll back
          *
+         *       a zero 'increment' is allowed and merely advances the window right edge
+         *
          * @return updated count (inclusive of 'increment' and 'time' progression)
          */
         template<bool CHECK_MONOTONICITY = true>
-        VR_ASSUME_HOT window_count_type add (T const time, int32_t const increment = 1);
+        VR_ASSUME_HOT window_count_type add (T const time, window_count_type const increment = 1);
 
     private: // ..............................................................
 
+        using memo          = impl::fenwick_window_memo<window_count_type, memoized ()>;
+
         vr_static_assert (vr_is_power_of_2 (window ()));
         vr_static_assert (vr_is_power_of_2 (bin_count ()));
 
@@ -105,6 +142,7 @@ class fenwick_window final
 
 
         VR_FORCEINLINE window_count_type count_impl (int32_t r, bool const front_window) const;
+        VR_FORCEINLINE window_count_type cumsum (window_data const & w, int32_t r) const;
 
         T m_time_index; // last addition "time" [in bin units]
         bool m_front_window;
@@ -146,10 +184,30 @@ fenwick_window<T, OPTIONS>::count_impl (int32_t r, bool const front_window) cons
 }
 //............................................................................
 
+template<typename T, typename OPTIONS>
+typename fenwick_window<T, OPTIONS>::window_count_type
+fenwick_window<T, OPTIONS>::cumsum (window_data const & w, int32_t r) const
+{
+    assert_within_inclusive (r, bin_count ());
+
+    window_count_type sum { };
+
+    while (r > 0) // O(log2(r))
+    {
+        sum += w [r - 1];
+        r ^= (r & - r); // turn off the rightmost 1-bit of 'r'
+    }
+
+    return sum;
+}
+//............................................................................
+
 template<typename T, typename OPTIONS>
 typename fenwick_window<T, OPTIONS>::window_count_type
 fenwick_window<T, OPTIONS>::count () const
 {
+    if (memoized ()) return memo::memoized_count ();
+
     int32_t r = (static_cast<uint32_t> (m_time_index) & _2_window_bin_mask ()); // current window right edge
 
     DLOG_trace1 << "count: time index: " << m_time_index << ", r: " << r << ", front window: " << m_front_window;
@@ -158,15 +216,42 @@ fenwick_window<T, OPTIONS>::count () const
 
     return count_impl (r, m_front_window);
 }
+
+template<typename T, typename OPTIONS>
+typename fenwick_window<T, OPTIONS>::window_count_type
+fenwick_window<T, OPTIONS>::count (T const time) const
+{
+    assert_nonnegative (time);
+
+    T const time_index = static_cast<T> (static_cast<T_unsigned> (time) >> log2_bin_width ());
+    assert_le (m_time_index, time_index, time);
+
+    if (time_index >= m_time_index + static_cast<T> (window () >> log2_bin_width ()))
+        return 0; // everything has slid out of the window
+
+    int32_t r = (static_cast<uint32_t> (time_index) & _2_window_bin_mask ());
+    bool const front_window = (r >= bin_count ());
+
+    r = (r & _window_bin_mask ()) + 1;
+
+    if (front_window == m_front_window)
+        return count_impl (r, front_window); // bins past the last 'add()' are all zero
+
+    // a window roll would make the current front window the new (partially slid out) back one
+    // and clear the new front one:
+
+    window_data const & bw = m_window [m_front_window];
+
+    return (bw [bin_count () - 1] - cumsum (bw, r));
+}
 //............................................................................
 
 template<typename T, typename OPTIONS>
 template<bool CHECK_MONOTONICITY>
 typename fenwick_window<T, OPTIONS>::window_count_type
-fenwick_window<T, OPTIONS>::add (T const time, int32_t const increment)
+fenwick_window<T, OPTIONS>::add (T const time, window_count_type const increment)
 {
     assert_nonnegative (time);
-    assert_nonzero (increment);
 
     T const time_index = static_cast<T> (static_cast<T_unsigned> (time) >> log2_bin_width ());
 
@@ -227,7 +312,10 @@ fenwick_window<T, OPTIONS>::add (T const time, int32_t const increment)
 
     m_time_index = time_index;
 
-    return count_impl (r, front_window);
+    window_count_type const count = count_impl (r, front_window);
+    memo::memoize (count);
+
+    return count;
 }
 
 } // end of 'util'
@@ -119,6 +119,71 @@ TEST (fenwick_window, undo)
     }
 }
 
+//............................................................................
+/*
+ * compare memoized/wide-bin and default variants against a brute force sliding sum
+ * over the last 'bin_count' bins, including look-ahead 'count (time)' queries
+ */
+TEST (fenwick_window, memoized)
+{
+    constexpr int64_t window    = 1024;
+    constexpr int32_t bin_count = 64;
+    constexpr int64_t bin_width = window / bin_count;
+
+    using window_counter    = fenwick_window<timestamp_t, fenwick_window_options<window, int16_t, bin_count>>;
+    using memo_counter      = fenwick_window<timestamp_t, fenwick_window_options<window, int64_t, bin_count, /* MEMOIZED */true>>;
+
+    vr_static_assert (std::is_same<memo_counter::window_count_type, int64_t>::value);
+
+    LOG_info << "sizeof (window_counter) = " << sizeof (window_counter) << ", sizeof (memo_counter) = " << sizeof (memo_counter);
+
+    uint64_t rnd = test::env::random_seed<uint64_t> (); // note: unsigned
+
+    window_counter wc { 0 };
+    memo_counter mc { 0 };
+
+    std::vector<std::pair<timestamp_t, int64_t>> history { };
+
+    auto const reference_count = [&history](timestamp_t const t)
+        {
+            int64_t sum { };
+            for (auto const & e : history)
+            {
+                if ((e.first / bin_width) > (t / bin_width) - bin_count) sum += e.second;
+            }
+            return sum;
+        };
+
+    timestamp_t t { };
+
+    for (int32_t i = 0; i < 20000; ++ i)
+    {
+        // mostly short gaps, occasionally longer than the window:
+
+        timestamp_t const dt = ((test::next_random (rnd) % 100) ? (test::next_random (rnd) % (bin_width / 2)) : (test::next_random (rnd) % (3 * window)));
+        t += dt;
+
+        int32_t const inc = 1 + (test::next_random (rnd) % 20); // int16 bins must not overflow
+        int64_t const wide_inc = inc * (1L << 40);
+
+        // look ahead before adding:
+
+        ASSERT_EQ (wc.count (t), reference_count (t)) << "[i: " << i << ", t: " << t << ']';
+        ASSERT_EQ (mc.count (t), reference_count (t) * (1L << 40)) << "[i: " << i << ", t: " << t << ']';
+
+        history.emplace_back (t, inc);
+        int64_t const expected = reference_count (t);
+
+        ASSERT_EQ (wc.add (t, inc), expected) << "[i: " << i << ", t: " << t << ']';
+        ASSERT_EQ (mc.add (t, wide_inc), expected * (1L << 40)) << "[i: " << i << ", t: " << t << ']';
+
+        ASSERT_EQ (wc.count (), expected);
+        ASSERT_EQ (mc.count (), expected * (1L << 40));
+
+        if (history.size () > 4096) history.erase (history.begin (), history.begin () + 2048); // keep the brute force cheap (gaps are short enough for this to be safe)
+    }
+}
+
 } // end of 'util'
 } // end of namespace
 //----------------------------------------------------------------------------
@@ -0,0 +1,422 @@
+#pragma once
+
+#include "vr/fields.h"
+#include "vr/tags.h"
+#include "vr/meta/structs.h"
+#include "vr/util/logging.h"
+#include "vr/util/ops_int.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace util
+{
+//............................................................................
+//............................................................................
+namespace impl_pht
+{
+/*
+ * splitmix64 finalizer: a bijection with good avalanche
+ */
+VR_FORCEINLINE uint64_t
+mix64 (uint64_t x)
+{
+    x ^= (x >> 30); x *= 0xBF58476D1CE4E5B9UL;
+    x ^= (x >> 27); x *= 0x94D049BB133111EBUL;
+    x ^= (x >> 31);
+
+    return x;
+}
+
+constexpr uint64_t initial_seed ()     { return 0x9E3779B97F4A7C15UL; }
+
+/*
+ * maps 'x' uniformly into [0, n) without a division
+ */
+VR_FORCEINLINE uint32_t
+reduce (uint32_t const x, uint32_t const n)
+{
+    return ((static_cast<uint64_t> (x) * n) >> 32);
+}
+
+} // end of 'impl_pht'
+//............................................................................
+//............................................................................
+/**
+ * a seeded 64-bit hash for @ref perfect_hash_table (specialize for other key types)
+ */
+template<typename K, typename = void>
+struct perfect_hash; // master
+
+template<typename K>
+struct perfect_hash<K,
+    typename std::enable_if<is_integral_or_pointer<K>::value>::type>
+{
+    VR_FORCEINLINE uint64_t operator() (K const & key, uint64_t const seed) const VR_NOEXCEPT
+    {
+        return impl_pht::mix64 (static_cast<uint64_t> (integral_cast (key)) ^ seed); // note: distinct keys never collide
+    }
+
+}; // end of specialization
+
+template<>
+struct perfect_hash<std::string>
+{
+    VR_FORCEINLINE uint64_t operator() (std::string const & key, uint64_t const seed) const VR_NOEXCEPT
+    {
+        char_const_ptr_t s = key.data ();
+        std::size_t len = key.size ();
+
+        uint64_t h = impl_pht::mix64 (seed + len); // note: not just 'seed ^ len', that could cancel with the tail bytes
+
+        for ( ; len >= sizeof (uint64_t); s += sizeof (uint64_t), len -= sizeof (uint64_t))
+        {
+            uint64_t w;
+            std::memcpy (& w, s, sizeof (w));
+
+            h = impl_pht::mix64 (h ^ w);
+        }
+
+        // the tail (of up to 7 bytes) with at most two (overlapping) loads:
+
+        uint64_t w { };
+        if (len >= sizeof (uint32_t))
+        {
+            uint32_t lo, hi;
+            std::memcpy (& lo, s, sizeof (lo));
+            std::memcpy (& hi, s + len - sizeof (uint32_t), sizeof (hi));
+
+            w = (lo | (static_cast<uint64_t> (hi) << 32));
+        }
+        else if (len)
+        {
+            w = (static_cast<uint8_t> (s [0]) | (static_cast<uint8_t> (s [len >> 1]) << 8) | (static_cast<uint8_t> (s [len - 1]) << 16));
+        }
+
+        return impl_pht::mix64 (h ^ w);
+    }
+
+}; // end of specialization
+//............................................................................
+/**
+ * an immutable map built once over a known key set using the "hash, displace,
+ * and compress" (CHD) scheme:
+ *
+ *  - key hashes are split into buckets of a few keys each;
+ *  - each bucket gets a displacement value chosen (largest buckets first) so that
+ *    its keys land in distinct free slots of a table with exactly one slot per key.
+ *
+ * a lookup is therefore a hash evaluation, one displacement load, and a single
+ * key compare in the slot it selects (no chains or probe sequences to follow,
+ * no data-dependent branches for integral keys)
+ *
+ * @note 'V' is a pointer type and @ref get() returns 'nullptr' for keys not in the map
+ *       (same as 'chained_scatter_table' with pointer values)
+ */
+template<typename K, typename V, typename HASH = perfect_hash<K> >
+class perfect_hash_table final // note: move-only
+{
+    private: // ..............................................................
+
+        vr_static_assert (std::is_pointer<V>::value);
+        vr_static_assert (std::is_default_constructible<HASH>::value);
+
+        using entry         = meta::make_compact_struct_t<meta::make_schema_t
+                            <
+                                meta::fdef_<K,  _key_>,
+                                meta::fdef_<V,  _value_>
+                            > >;
+
+    public: // ...............................................................
+
+        using size_type     = int32_t;
+
+        using key_type      = K;
+        using value_type    = V;
+        using mapped_type   = entry; // like 'chained_scatter_table', iteration visits entries with '_key_' and '_value_' fields
+        using hasher        = HASH;
+
+        using const_iterator    = entry const *;
+        using iterator          = entry *;
+
+        static constexpr int32_t bucket_size ()         { return 4; } // average number of keys per bucket
+        static constexpr uint32_t max_displacement ()   { return (1 << 20); }
+        static constexpr int32_t max_attempts ()        { return 32; } // each with a new seed
+
+
+        /**
+         * constructs an empty map
+         */
+        perfect_hash_table () :
+            perfect_hash_table (static_cast<std::pair<K, V> const *> (nullptr), static_cast<std::pair<K, V> const *> (nullptr))
+        {
+        }
+
+        /**
+         * @param begin start of a range of 'std::pair'-like (key, value) entries
+         * @param end end of the range
+         *
+         * @throws invalid_input if the key set contains duplicates
+         */
+        template<typename ITERATOR>
+        perfect_hash_table (ITERATOR const begin, ITERATOR const end);
+
+        perfect_hash_table (perfect_hash_table && rhs) = default;
+        perfect_hash_table & operator= (perfect_hash_table && rhs) = default;
+
+        // ACCESSORs:
+
+        size_type size () const
+        {
+            return m_size;
+        }
+
+        bool empty () const
+        {
+            return (! m_size);
+        }
+
+        /**
+         * @return value for 'key' or 'nullptr' if 'key' is not in the map
+         */
+        VR_FORCEINLINE V get (typename call_traits<K>::param key) const
+        {
+            uint64_t const h = HASH { } (key, m_seed);
+
+            entry const & e = m_entries [slot_of (h, m_displacements [impl_pht::reduce (h >> 32, m_bucket_count)], m_slot_count)];
+
+            // note: an empty map has a single slot with a 'nullptr' value
+
+            return ((field<_key_> (e) == key) ? field<_value_> (e) : nullptr);
+        }
+
+        // iteration:
+
+        const_iterator begin () const
+        {
+            return m_entries.get ();
+        }
+
+        const_iterator end () const
+        {
+            return (m_entries.get () + m_size);
+        }
+
+        // MUTATORs:
+
+        // iteration:
+
+        iterator begin ()
+        {
+            return m_entries.get ();
+        }
+
+        iterator end ()
+        {
+            return (m_entries.get () + m_size);
+        }
+
+    private: // ..............................................................
+
+        static VR_FORCEINLINE uint32_t slot_of (uint64_t const h, uint32_t const displacement, uint32_t const slot_count)
+        {
+            // a CHD-style '(f1 + d * f2) mod n', with a multiply-shift in place of the 'mod'
+            // (f1 and f2 come from disjoint halves of 'h', so that they are uncorrelated):
+
+            uint32_t const f1 = h;
+            uint32_t const f2 = ((h >> 32) | 1);
+
+            return impl_pht::reduce (f1 + displacement * f2, slot_count);
+        }
+
+        /*
+         * @return 'false' if placement failed for 'seed' (caller should retry with another one)
+         */
+        template<typename ITERATOR>
+        bool build (ITERATOR const begin, uint64_t const seed);
+
+
+        std::unique_ptr<uint32_t []> m_displacements;   // [m_bucket_count]
+        std::unique_ptr<entry []> m_entries;            // [m_slot_count], entries are in no particular order
+        uint64_t m_seed { };
+        uint32_t m_bucket_count { };
+        uint32_t m_slot_count { };
+        size_type m_size { };
+
+}; // end of class
+//............................................................................
+
+template<typename K, typename V, typename HASH>
+template<typename ITERATOR>
+perfect_hash_table<K, V, HASH>::perfect_hash_table (ITERATOR const begin, ITERATOR const end) :
+    m_size (std::distance (begin, end))
+{
+    check_nonnegative (m_size);
+
+    m_slot_count = std::max<uint32_t> (m_size, 1); // an empty map still has a (dummy) slot to keep get() branch-free
+    m_bucket_count = std::max<uint32_t> ((m_slot_count + bucket_size () - 1) / bucket_size (), 1);
+
+    m_displacements.reset (new uint32_t [m_bucket_count]);
+    m_entries.reset (new entry [m_slot_count]);
+
+    if (! m_size) // the dummy slot needs a 'nullptr' value
+    {
+        m_displacements [0] = 0;
+        field<_value_> (m_entries [0]) = nullptr;
+
+        return;
+    }
+
+    uint64_t seed = impl_pht::initial_seed ();
+
+    for (int32_t attempt = 0; attempt < max_attempts (); ++ attempt)
+    {
+        if (build (begin, seed))
+        {
+            LOG_trace2 << "built perfect hash table of size " << m_size << " (" << m_bucket_count << " bucket(s), attempt " << attempt << ')';
+            return;
+        }
+
+        seed = impl_pht::mix64 (seed + attempt + 1);
+    }
+
+    throw_x (illegal_state, "failed to build a perfect hash table of size " + string_cast (m_size) + " in " + string_cast (max_attempts ()) + " attempt(s)");
+}
+//............................................................................
+
+template<typename K, typename V, typename HASH>
+template<typename ITERATOR>
+bool
+perfect_hash_table<K, V, HASH>::build (ITERATOR const begin, uint64_t const seed)
+{
+    uint32_t const n = m_slot_count;
+    uint32_t const b_count = m_bucket_count;
+
+    // hash all keys and sort them into buckets (counting sort, stable):
+
+    std::vector<uint64_t> hashes (n);
+    std::vector<uint32_t> b_start (b_count + 1, 0);
+    {
+        ITERATOR i = begin;
+        for (uint32_t k = 0; k < n; ++ k, ++ i)
+        {
+            uint64_t const h = HASH { } (i->first, seed);
+
+            hashes [k] = h;
+            ++ b_start [impl_pht::reduce (h >> 32, b_count) + 1];
+        }
+
+        for (uint32_t b = 0; b < b_count; ++ b) b_start [b + 1] += b_start [b];
+    }
+
+    std::vector<uint32_t> b_keys (n); // key indices, grouped by bucket
+    {
+        std::vector<uint32_t> b_pos (b_start.begin (), b_start.end () - 1);
+
+        for (uint32_t k = 0; k < n; ++ k)
+        {
+            b_keys [b_pos [impl_pht::reduce (hashes [k] >> 32, b_count)] ++] = k;
+        }
+    }
+
+    // place buckets in the order of decreasing size:
+
+    std::vector<uint32_t> b_order (b_count);
+    for (uint32_t b = 0; b < b_count; ++ b) b_order [b] = b;
+
+    std::stable_sort (b_order.begin (), b_order.end (), [&b_start](uint32_t const lhs, uint32_t const rhs)
+        {
+            return ((b_start [lhs + 1] - b_start [lhs]) > (b_start [rhs + 1] - b_start [rhs]));
+        });
+
+    std::vector<int32_t> slot_keys (n, -1); // slot -> key index
+    std::vector<uint32_t> slots; // scratch
+
+    for (uint32_t const b : b_order)
+    {
+        uint32_t const k_begin = b_start [b];
+        uint32_t const k_end = b_start [b + 1];
+
+        if (k_begin == k_end)
+        {
+            m_displacements [b] = 0;
+            continue;
+        }
+
+        // keys with identical full hashes can't be separated by any displacement:
+
+        for (uint32_t k = k_begin; k < k_end; ++ k)
+        {
+            for (uint32_t k2 = k_begin; k2 < k; ++ k2)
+            {
+                if (VR_UNLIKELY (hashes [b_keys [k]] == hashes [b_keys [k2]]))
+                {
+                    ITERATOR i = begin; std::advance (i, b_keys [k]);
+                    ITERATOR i2 = begin; std::advance (i2, b_keys [k2]);
+
+                    if (i->first == i2->first)
+                        throw_x (invalid_input, "duplicate key " + print (i->first));
+
+                    return false; // a (very unlikely) 64-bit hash collision
+                }
+            }
+        }
+
+        uint32_t d = 0;
+        for ( ; d < max_displacement (); ++ d)
+        {
+            slots.clear ();
+
+            for (uint32_t k = k_begin; k < k_end; ++ k)
+            {
+                uint32_t const s = slot_of (hashes [b_keys [k]], d, n);
+
+                if ((slot_keys [s] >= 0) || (std::find (slots.begin (), slots.end (), s) != slots.end ()))
+                    break;
+
+                slots.push_back (s);
+            }
+
+            if (slots.size () == (k_end - k_begin)) // all of this bucket's keys fit
+                break;
+        }
+
+        if (VR_UNLIKELY (d == max_displacement ()))
+            return false;
+
+        m_displacements [b] = d;
+        for (uint32_t k = k_begin; k < k_end; ++ k)
+        {
+            slot_keys [slots [k - k_begin]] = b_keys [k];
+        }
+    }
+
+    // [assertion: every slot has been assigned exactly one key]
+
+    ITERATOR i = begin;
+    std::vector<ITERATOR> key_entries; key_entries.reserve (n);
+    for (uint32_t k = 0; k < n; ++ k, ++ i) key_entries.push_back (i);
+
+    for (uint32_t s = 0; s < n; ++ s)
+    {
+        assert_nonnegative (slot_keys [s]);
+        ITERATOR const & e = key_entries [slot_keys [s]];
+
+        field<_key_> (m_entries [s]) = e->first;
+        field<_value_> (m_entries [s]) = e->second;
+    }
+
+    m_seed = seed;
+
+    return true;
+}
+
+} // end of 'util'
+} // end of namespace
+//----------------------------------------------------------------------------
@@ -0,0 +1,166 @@
+
+#include "vr/macros.h" // VR_RELEASE
+#if VR_RELEASE // perf testcases in release builds only
+
+#include "vr/containers/util/chained_scatter_table.h"
+#include "vr/containers/util/perfect_hash_table.h"
+#include "vr/util/logging.h"
+
+#include "vr/test/timing.h"
+#include "vr/test/utility.h"
+
+#include <boost/unordered_map.hpp>
+#include <boost/unordered_set.hpp>
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace util
+{
+//............................................................................
+//............................................................................
+namespace
+{
+
+template<typename F>
+VR_NOINLINE int64_t
+measure (F && f, int32_t const passes)
+{
+    int64_t best { std::numeric_limits<int64_t>::max () };
+
+    for (int32_t pass = 0; pass < passes; ++ pass)
+    {
+        int64_t tsc = VR_TSC_START ();
+        {
+            f ();
+        }
+        VR_TSC_STOP (tsc);
+
+        best = std::min (best, tsc);
+    }
+
+    return best;
+}
+
+} // end of anonymous
+//............................................................................
+//............................................................................
+/*
+ * iid-like keys (the key set is a small fraction of the key space, most lookups
+ * in a market data view miss)
+ */
+TEST (perf_perfect_hash_table, integral_keys)
+{
+    using key_type      = int32_t;
+    using value_type    = int32_t const *;
+
+    int32_t const lookup_count  = 64 * 1024;
+    int32_t const passes        = 20;
+
+    int64_t const tsc_overhead = test::tsc_macro_overhead ();
+
+    uint64_t rnd = test::env::random_seed<uint64_t> ();
+
+    for (int32_t const size : { 64, 2000, 50000 })
+    {
+        boost::unordered_set<key_type> keys { };
+        while (signed_cast (keys.size ()) < size) keys.insert (test::next_random (rnd) % (50 * size));
+
+        std::vector<int32_t> const values (size);
+        std::vector<std::pair<key_type, value_type>> kvs;
+        for (key_type const k : keys) kvs.emplace_back (k, & values [kvs.size ()]);
+
+        perfect_hash_table<key_type, value_type> const pht { kvs.begin (), kvs.end () };
+
+        chained_scatter_table<key_type, value_type, identity_hash<key_type>> cst { size }; // how 'ref_data' and 'market_data_view' used to do it
+        for (auto const & kv : kvs) cst.put (kv.first, kv.second);
+        cst.rehash (cst.size ()); // trim to fit
+
+        for (int32_t const hit_pct : { 100, 10 })
+        {
+            std::vector<key_type> lookups (lookup_count);
+            for (key_type & k : lookups)
+            {
+                k = ((test::next_random (rnd) % 100) < hit_pct) ? kvs [test::next_random (rnd) % size].first : static_cast<key_type> (test::next_random (rnd) % (50 * size));
+            }
+
+            int64_t checksum { };
+
+            int64_t const t_cst = measure ([&]()
+                {
+                    for (key_type const k : lookups) checksum += (cst.get (k) != nullptr);
+                }, passes) - tsc_overhead;
+
+            int64_t const t_pht = measure ([&]()
+                {
+                    for (key_type const k : lookups) checksum += (pht.get (k) != nullptr);
+                }, passes) - tsc_overhead;
+
+            double const n = lookup_count;
+
+            LOG_info << "[size " << size << ", " << hit_pct << "% hits] get() (cycles/op): chained scatter " << std::setprecision (3) << (t_cst / n)
+                     << ", perfect " << (t_pht / n) << " (checksum " << checksum << ')';
+        }
+    }
+}
+
+/*
+ * symbol-like keys
+ */
+TEST (perf_perfect_hash_table, string_keys)
+{
+    using key_type      = std::string;
+    using value_type    = int32_t const *;
+
+    int32_t const lookup_count  = 64 * 1024;
+    int32_t const passes        = 20;
+
+    int64_t const tsc_overhead = test::tsc_macro_overhead ();
+
+    uint64_t rnd = test::env::random_seed<uint64_t> ();
+
+    for (int32_t const size : { 64, 2000 })
+    {
+        boost::unordered_set<key_type> keys { };
+        while (signed_cast (keys.size ()) < size)
+        {
+            std::string k (3 + test::next_random (rnd) % 4, ' ');
+            for (char & c : k) c = 'A' + test::next_random (rnd) % 26;
+
+            keys.insert (k);
+        }
+
+        std::vector<int32_t> const values (size);
+        std::vector<std::pair<key_type, value_type>> kvs;
+        for (key_type const & k : keys) kvs.emplace_back (k, & values [kvs.size ()]);
+
+        perfect_hash_table<key_type, value_type> const pht { kvs.begin (), kvs.end () };
+        boost::unordered_map<key_type, value_type> const um { kvs.begin (), kvs.end () };
+
+        std::vector<key_type> lookups (lookup_count);
+        for (key_type & k : lookups) k = kvs [test::next_random (rnd) % size].first;
+
+        int64_t checksum { };
+
+        int64_t const t_um = measure ([&]()
+            {
+                for (key_type const & k : lookups) checksum += (um.find (k) != um.end ());
+            }, passes) - tsc_overhead;
+
+        int64_t const t_pht = measure ([&]()
+            {
+                for (key_type const & k : lookups) checksum += (pht.get (k) != nullptr);
+            }, passes) - tsc_overhead;
+
+        double const n = lookup_count;
+
+        LOG_info << "[size " << size << "] get() (cycles/op): boost::unordered_map " << std::setprecision (3) << (t_um / n)
+                 << ", perfect " << (t_pht / n) << " (checksum " << checksum << ')';
+    }
+}
+
+} // end of 'util'
+} // end of namespace
+//----------------------------------------------------------------------------
+
+#endif // VR_RELEASE
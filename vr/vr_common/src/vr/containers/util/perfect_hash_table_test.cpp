@@ -0,0 +1,150 @@
+
+#include "vr/containers/util/perfect_hash_table.h"
+
+#include "vr/test/utility.h"
+
+#include <boost/unordered_set.hpp>
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace util
+{
+//............................................................................
+//............................................................................
+namespace
+{
+
+template<typename K>
+using kv_vector         = std::vector<std::pair<K, int32_t const *>>;
+
+template<typename K, typename V>
+void
+check_table (perfect_hash_table<K, V> const & t, std::vector<std::pair<K, V>> const & kvs)
+{
+    ASSERT_EQ (t.size (), signed_cast (kvs.size ()));
+
+    for (auto const & kv : kvs)
+    {
+        ASSERT_EQ (t.get (kv.first), kv.second) << "wrong lookup result for " << print (kv.first);
+    }
+
+    // iteration visits every entry exactly once:
+
+    boost::unordered_set<K> visited { };
+    for (auto const & e : t)
+    {
+        ASSERT_TRUE (visited.insert (field<_key_> (e)).second) << "visited " << print (field<_key_> (e)) << " more than once";
+        ASSERT_EQ (t.get (field<_key_> (e)), field<_value_> (e));
+    }
+    ASSERT_EQ (visited.size (), kvs.size ());
+}
+
+} // end of anonymous
+//............................................................................
+//............................................................................
+
+TEST (perfect_hash_table, empty)
+{
+    perfect_hash_table<int32_t, int32_t const *> const t { };
+
+    EXPECT_TRUE (t.empty ());
+    EXPECT_EQ (t.begin (), t.end ());
+
+    for (int32_t k : { 0, -1, 1, 12345 })
+    {
+        EXPECT_EQ (t.get (k), nullptr) << "k = " << k;
+    }
+}
+
+TEST (perfect_hash_table, integral_keys)
+{
+    uint64_t rnd = test::env::random_seed<uint64_t> ();
+
+    for (int32_t const size : { 1, 2, 3, 7, 100, 1000, 10000, 300000 })
+    {
+        boost::unordered_set<int32_t> keys { };
+        while (signed_cast (keys.size ()) < size)
+        {
+            keys.insert (static_cast<int32_t> (test::next_random (rnd))); // note: includes negative keys
+        }
+
+        std::vector<int32_t> const values (size);
+
+        kv_vector<int32_t> kvs;
+        for (int32_t const k : keys) kvs.emplace_back (k, & values [kvs.size ()]); // unique per key
+
+        perfect_hash_table<int32_t, int32_t const *> const t { kvs.begin (), kvs.end () };
+        check_table (t, kvs);
+
+        // keys not in the table:
+
+        for (int32_t r = 0; r < 10000; ++ r)
+        {
+            int32_t const k = test::next_random (rnd);
+            if (! keys.count (k))
+            {
+                ASSERT_EQ (t.get (k), nullptr) << "[size " << size << "] false positive for " << k;
+            }
+        }
+    }
+}
+
+TEST (perfect_hash_table, string_keys)
+{
+    uint64_t rnd = test::env::random_seed<uint64_t> ();
+
+    for (int32_t const size : { 1, 5, 100, 5000 })
+    {
+        boost::unordered_set<std::string> keys { };
+        while (signed_cast (keys.size ()) < size)
+        {
+            std::string k (test::next_random (rnd) % 20, ' '); // variable lengths, including empty and longer than a word
+            for (char & c : k) c = 'A' + test::next_random (rnd) % 26;
+
+            keys.insert (k);
+        }
+
+        std::vector<int32_t> const values (size);
+
+        kv_vector<std::string> kvs;
+        for (std::string const & k : keys) kvs.emplace_back (k, & values [kvs.size ()]);
+
+        perfect_hash_table<std::string, int32_t const *> const t { kvs.begin (), kvs.end () };
+        check_table (t, kvs);
+
+        for (std::string k : { "BHP.AX", "A_MUCH_LONGER_SYMBOL_THAN_USUAL", "?" })
+        {
+            if (! keys.count (k))
+            {
+                ASSERT_EQ (t.get (k), nullptr) << "[size " << size << "] false positive for " << print (k);
+            }
+        }
+    }
+}
+
+TEST (perfect_hash_table, duplicate_keys)
+{
+    int32_t const values [2] { };
+
+    kv_vector<int32_t> const kvs { { 1, & values [0] }, { 2, & values [1] }, { 1, & values [1] } };
+
+    EXPECT_THROW ((perfect_hash_table<int32_t, int32_t const *> { kvs.begin (), kvs.end () }), invalid_input);
+}
+
+TEST (perfect_hash_table, move)
+{
+    int32_t const values [1] { };
+
+    kv_vector<int32_t> const kvs { { 10, & values [0] } };
+
+    perfect_hash_table<int32_t, int32_t const *> t { };
+    t = perfect_hash_table<int32_t, int32_t const *> { kvs.begin (), kvs.end () };
+
+    EXPECT_EQ (t.get (10), & values [0]);
+    EXPECT_EQ (t.get (11), nullptr);
+}
+
+} // end of 'util'
+} // end of namespace
+//----------------------------------------------------------------------------
@@ -15,6 +15,87 @@ class fw_string; // forward
 namespace impl
 {
 
+template<std::size_t N>
+struct fw_string_storage
+{
+    using type                      = typename util::unsigned_type_of_size<N>::type;
+
+}; // end of master
+
+template<>
+struct fw_string_storage<16> // 'unsigned_type_of_size' stops at 8 bytes
+{
+    using type                      = native_uint128_t;
+
+}; // end of specialization
+//............................................................................
+/*
+ * width-specific primitives, selected at compile time by storage size: 4- and 8-byte
+ * strings are handled in GPRs, 16-byte ones in an xmm register
+ *
+ * note: since bytes past the null terminator are always nulls, lexicographic (std::strcmp()-like)
+ * order of two strings is the same as the order of their storage slots interpreted as big-endian
+ * unsigned integers
+ */
+template<typename ST, typename = void>
+struct fw_string_width_ops; // master
+
+template<typename ST>
+struct fw_string_width_ops<ST,
+    typename std::enable_if<((sizeof (ST) == sizeof (int32_t)) || (sizeof (ST) == sizeof (int64_t)))>::type>
+{
+    static VR_FORCEINLINE int32_t zero_index (ST const x) VR_NOEXCEPT
+    {
+        return util::ls_zero_index (x);
+    }
+
+    static VR_FORCEINLINE bool less (ST const lhs, ST const rhs) VR_NOEXCEPT
+    {
+        return (util::byteswap (lhs) < util::byteswap (rhs)); // 'bswap' is much cheaper than a 'pcmpistri'
+    }
+
+    static VR_FORCEINLINE uint32_t hash (ST const x) VR_NOEXCEPT
+    {
+        return util::i_crc32 (1, x);
+    }
+
+}; // end of specialization
+
+template<typename ST>
+struct fw_string_width_ops<ST,
+    typename std::enable_if<(sizeof (ST) == sizeof (native_uint128_t))>::type>
+{
+    static VR_FORCEINLINE __m128i load (ST const & x) VR_NOEXCEPT
+    {
+        return _mm_loadu_si128 (reinterpret_cast<__m128i const *> (& x));
+    }
+
+    static VR_FORCEINLINE int32_t zero_index (ST const & x) VR_NOEXCEPT
+    {
+        uint32_t const zeros = _mm_movemask_epi8 (_mm_cmpeq_epi8 (load (x), _mm_setzero_si128 ()));
+
+        return __builtin_ctz (zeros | (1 << sizeof (ST))); // a sentinel bit for a full-width string
+    }
+
+    static VR_FORCEINLINE bool less (ST const & lhs, ST const & rhs) VR_NOEXCEPT
+    {
+        __m128i const l = load (lhs);
+        __m128i const r = load (rhs);
+
+        uint32_t const ne = (~ _mm_movemask_epi8 (_mm_cmpeq_epi8 (l, r)) & 0xFFFF);                 // bytes that differ
+        uint32_t const le = _mm_movemask_epi8 (_mm_cmpeq_epi8 (_mm_max_epu8 (l, r), r));            // bytes with 'l <= r' (unsigned)
+
+        return ((ne & - ne) & le); // 'lhs < rhs' iff 'l < r' at the first differing byte
+    }
+
+    static VR_FORCEINLINE uint32_t hash (ST const & x) VR_NOEXCEPT
+    {
+        return util::i_crc32 (util::i_crc32 (1, static_cast<uint64_t> (x)), static_cast<uint64_t> (x >> 64));
+    }
+
+}; // end of specialization
+//............................................................................
+
 template<typename ST>
 struct fw_string_impl_nochecks
 {
@@ -51,9 +132,7 @@ struct fw_string_impl_nochecks
 
         data = { }; // make sure the whole storage slot had deterministic contents (for efficient comparisons, hashing, etc)
 
-        std::string::value_type * const VR_RESTRICT data_chars = reinterpret_cast<std::string::value_type *> (& data);
-
-        std::memcpy (data_chars, str, len); // TODO more efficient impl (no need to loop)
+        std::memcpy (& data, str, len); // note: never read past 'str + len'
 
         return true;
     }
@@ -122,11 +201,12 @@ class fw_string // ordered, hashable, copy/move-constructible, copy/move-assigna
 {
     public: // ...............................................................
 
-        using storage_type          = typename util::unsigned_type_of_size<N>::type;
+        using storage_type          = typename impl::fw_string_storage<N>::type;
 
     private: // ..............................................................
 
         using impl_ops              = impl::fw_string_impl<storage_type, CHECK_BOUNDS>;
+        using width_ops             = impl::fw_string_width_ops<storage_type>;
 
     public: // ...............................................................
 
@@ -185,7 +265,7 @@ class fw_string // ordered, hashable, copy/move-constructible, copy/move-assigna
 
         size_type size () const VR_NOEXCEPT
         {
-            return util::ls_zero_index (m_data);
+            return width_ops::zero_index (m_data);
         }
 
         size_type length () const VR_NOEXCEPT
@@ -284,7 +364,7 @@ class fw_string // ordered, hashable, copy/move-constructible, copy/move-assigna
 
         friend VR_FORCEINLINE std::size_t hash_value (fw_string const & obj) VR_NOEXCEPT
         {
-            return util::i_crc32 (1, obj.m_data);
+            return width_ops::hash (obj.m_data);
         }
 
         friend VR_ASSUME_COLD std::string __print__ (fw_string const & obj) VR_NOEXCEPT
@@ -314,86 +394,12 @@ class fw_string // ordered, hashable, copy/move-constructible, copy/move-assigna
 
 using fw_string4            = fw_string<4>;
 using fw_string8            = fw_string<8>;
+using fw_string16           = fw_string<16>;
 
 //............................................................................
 //............................................................................
 namespace impl
 {
-/*
- * note: I could just use '(lhs.m_data < rhs.m_data)' if I just wanted an ordered type;
- * instead, the impl below does lexicographic comparison (std:strcmp()-like)
- * <em>as long as positive chars are used</em>:
- */
-template<typename T, typename = void>
-struct fw_string_lexless; // end of master
-
-// TODO pshufb ?
-
-template<typename T>
-struct fw_string_lexless<T,
-    typename std::enable_if<(sizeof (T) == sizeof (int32_t))>::type>
-{
-    static VR_FORCEINLINE bool evaluate (int32_t const lhs, int32_t const rhs) VR_NOEXCEPT
-    {
-        xmmi_t temp_lhs, temp_rhs;
-        int32_t r { }; // note: zero init (hence the '&' modifier for %0 below)
-        asm
-        (
-            "movd %3, %1\n"
-            "movd %4, %2\n"
-            "pcmpistri %5, %1, %2\n"
-            "jnc     %=f\n"
-            "notl  %%ecx\n"
-            "addl $4, %%ecx\n" // ecx <- 3 - ecx (note: '4' is 'sizeof(T)')
-            "shll $3, %%ecx\n"
-            "pcmpgtb %1, %2\n" // (note: *signed* byte comparisons)
-            "movd %2,  %0\n"
-            "shll %%cl, %0\n"
-        "%=:            \n"
-                : "+&r" (r), "=x" (temp_lhs), "=x" (temp_rhs)
-                : "rm" (lhs), "rm" (rhs),
-                  "N" (_SIDD_CMP_EQUAL_EACH | _SIDD_NEGATIVE_POLARITY) // looking for the first diff byte
-                : "%ecx", "cc"
-        );
-
-        return r;
-    }
-
-}; // end of specialization
-
-template<typename T>
-struct fw_string_lexless<T,
-    typename std::enable_if<(sizeof (T) == sizeof (int64_t))>::type>
-{
-    static VR_FORCEINLINE bool evaluate (int64_t const lhs, int64_t const rhs) VR_NOEXCEPT
-    {
-        xmmi_t temp_lhs, temp_rhs;
-        int64_t r { }; // note: zero init (hence the '&' modifier for %0 below)
-        asm
-        (
-            "movq %3, %1\n"
-            "movq %4, %2\n"
-            "pcmpistri %5, %1, %2\n"
-            "jnc     %=f\n"
-            "notl  %%ecx\n"
-            "addl $8, %%ecx\n" // ecx <- 7 - ecx (note: '8' is 'sizeof(T)')
-            "shll $3, %%ecx\n"
-            "pcmpgtb %1, %2\n" // (note: *signed* byte comparisons)
-            "movq %2,  %0\n"
-            "shlq %%cl, %0\n"
-        "%=:            \n"
-                : "+&r" (r), "=x" (temp_lhs), "=x" (temp_rhs)
-                : "rm" (lhs), "rm" (rhs),
-                  "N" (_SIDD_CMP_EQUAL_EACH | _SIDD_NEGATIVE_POLARITY) // looking for the first diff byte
-                : "%ecx", "cc"
-        );
-
-        return r;
-    }
-
-}; // end of specialization
-//............................................................................
-
 // 'fw_string_ops' impl:
 
 template<std::size_t LHS_N, std::size_t RHS_N, bool CHECK_BOUNDS>
@@ -406,21 +412,19 @@ struct fw_string_ops
     }
 
 
-    template<std::size_t _ = LHS_N>
-    static VR_FORCEINLINE typename std::enable_if<(_ != RHS_N), bool>::type
+    /*
+     * note: I could just use '(lhs.m_data < rhs.m_data)' if I just wanted an ordered type;
+     * instead, the impl below does lexicographic comparison (std::strcmp()-like, i.e.
+     * with chars compared as unsigned)
+     */
+    static VR_FORCEINLINE bool
     less (fw_string<LHS_N, CHECK_BOUNDS> const & lhs, fw_string<RHS_N, CHECK_BOUNDS> const & rhs) VR_NOEXCEPT
     {
-        // TODO pcmpistri, handle different widths
-        throw_x (illegal_state, "not implemented yet");
-    }
+        // zero-extending the narrower operand (if any) is the same as null-padding it:
 
-    template<std::size_t _ = LHS_N>
-    static VR_FORCEINLINE typename std::enable_if<(_ == RHS_N), bool>::type
-    less (fw_string<LHS_N, CHECK_BOUNDS> const & lhs, fw_string<RHS_N, CHECK_BOUNDS> const & rhs) VR_NOEXCEPT
-    {
-        using signed_storage_type       = typename util::signed_type_of_size<LHS_N>::type;
+        using storage_type      = typename fw_string_storage<(LHS_N > RHS_N ? LHS_N : RHS_N)>::type;
 
-        return fw_string_lexless<signed_storage_type>::evaluate (lhs.m_data, rhs.m_data);
+        return fw_string_width_ops<storage_type>::less (static_cast<storage_type> (lhs.m_data), static_cast<storage_type> (rhs.m_data));
     }
 
 }; // end of class
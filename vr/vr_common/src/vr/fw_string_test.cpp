@@ -15,11 +15,27 @@ char const str_2 [] = "ab";
 
 char const str_4 [] = "abcd";
 char const str_8 [] = "abcdefgh";
+char const str_16 [] = "abcdefghijklmnop";
 
 char const str_5 [] = "abcdQ";
 char const str_9 [] = "abcdefghQ";
+char const str_17 [] = "abcdefghijklmnopQ";
 
-char const str_10 [] = "abcdefghQQ";
+char const str_18 [] = "abcdefghijklmnopQQ";
+
+// full-width and one-char-too-long strings for a given 'max_size':
+
+inline string_literal_t
+str_full (int32_t const max_size)
+{
+    return (max_size == 4 ? str_4 : (max_size == 8 ? str_8 : str_16));
+}
+
+inline string_literal_t
+str_over (int32_t const max_size)
+{
+    return (max_size == 4 ? str_5 : (max_size == 8 ? str_9 : str_17));
+}
 
 //............................................................................
 
@@ -28,7 +44,9 @@ using tested_fw_string_types    = gt::Types
     fw_string<4, false>,
     fw_string<4, true>,
     fw_string<8, false>,
-    fw_string<8, true>
+    fw_string<8, true>,
+    fw_string<16, false>,
+    fw_string<16, true>
 >;
 
 template<typename T> struct fw_string_test: public gt::Test { };
@@ -36,7 +54,6 @@ TYPED_TEST_CASE (fw_string_test, tested_fw_string_types);
 
 // TODO
 // - mutation/concatenation (w/ bounds checking)
-// - ops b/w different storage_type widths
 
 } // end of anonymous
 //............................................................................
@@ -71,25 +88,39 @@ TYPED_TEST (fw_string_test, construction)
         // some bounds checking:
         {
             ASSERT_NO_THROW ((string_type { str_2 }));
-            ASSERT_NO_THROW ((string_type { string_type::max_size () == 4 ? str_4 : str_8 }));
+            ASSERT_NO_THROW ((string_type { str_full (string_type::max_size ()) }));
 
-            ASSERT_NO_THROW ((string_type { str_10, string_type::max_size () }));
-            ASSERT_NO_THROW ((string_type { util::str_range { str_10, string_type::max_size () } }));
-            ASSERT_NO_THROW ((string_type { std::string { str_10, string_type::max_size () } }));
+            ASSERT_NO_THROW ((string_type { str_18, string_type::max_size () }));
+            ASSERT_NO_THROW ((string_type { util::str_range { str_18, string_type::max_size () } }));
+            ASSERT_NO_THROW ((string_type { std::string { str_18, string_type::max_size () } }));
 
             if (string_type::bounds_checked ())
             {
-                ASSERT_THROW ((string_type { string_type::max_size () == 4 ? str_5 : str_9 }), out_of_bounds);
-                ASSERT_THROW ((string_type { str_10 }), out_of_bounds);
+                ASSERT_THROW ((string_type { str_over (string_type::max_size ()) }), out_of_bounds);
+                ASSERT_THROW ((string_type { str_18 }), out_of_bounds);
 
-                ASSERT_THROW ((string_type { "012345678", string_type::max_size () + 1 }), out_of_bounds);
-                ASSERT_THROW ((string_type { util::str_range { "012345678", string_type::max_size () + 1 } }), out_of_bounds);
-                ASSERT_THROW ((string_type { std::string { "012345678" } }), out_of_bounds);
+                ASSERT_THROW ((string_type { "0123456789ABCDEFG", string_type::max_size () + 1 }), out_of_bounds);
+                ASSERT_THROW ((string_type { util::str_range { "0123456789ABCDEFG", string_type::max_size () + 1 } }), out_of_bounds);
+                ASSERT_THROW ((string_type { std::string { "0123456789ABCDEFG" } }), out_of_bounds);
 
                 ASSERT_THROW (s0.at (1), out_of_bounds);
             }
         }
 
+        // ranges that end before the storage width (only '[str, str + len)' may be read):
+
+        for (int32_t len = 0; len <= string_type::max_size (); ++ len)
+        {
+            std::unique_ptr<char []> const buf { new char [len] }; // exact size, so that an overread is detectable by ASan
+
+            for (int32_t i = 0; i < len; ++ i) buf [i] = 'a' + i;
+
+            string_type const s { buf.get (), len };
+
+            ASSERT_EQ (s.size (), len);
+            EXPECT_EQ (s, (util::str_range { buf.get (), len }));
+        }
+
         // mixed lhs/rhs equality:
 
         EXPECT_EQ (s0, "");
@@ -259,9 +290,11 @@ TYPED_TEST (fw_string_test, comparison)
         int32_t const lhs_len = test::next_random (rnd) % max_size;
         int32_t const rhs_len = test::next_random (rnd) % max_size;
         {
-            for (int32_t i = 0; i < lhs_len; ++ i) lhs_buf [i] = 1 + test::next_random (rnd) % 127; // positive chars
+            int32_t const alphabet = ((r & 1) ? 3 : 255); // a small alphabet produces long common prefixes
+
+            for (int32_t i = 0; i < lhs_len; ++ i) lhs_buf [i] = 1 + test::next_random (rnd) % alphabet; // any non-null chars
             lhs_buf [lhs_len] = '\0';
-            for (int32_t i = 0; i < rhs_len; ++ i) rhs_buf [i] = 1 + test::next_random (rnd) % 127; // positive chars
+            for (int32_t i = 0; i < rhs_len; ++ i) rhs_buf [i] = 1 + test::next_random (rnd) % alphabet; // any non-null chars
             rhs_buf [rhs_len] = '\0';
         }
 
@@ -280,6 +313,42 @@ TYPED_TEST (fw_string_test, comparison)
     }
 }
 
+TEST (fw_string, comparison_mixed_widths)
+{
+    using lhs_type              = fw_string<4>;
+    using rhs_type              = fw_string<16>;
+
+    char lhs_buf [lhs_type::max_size () + 1];
+    char rhs_buf [rhs_type::max_size () + 1];
+
+    uint64_t rnd = test::env::random_seed<uint64_t> (); // note: unsigned
+    int64_t const repeats = 100000;
+
+    for (int64_t r = 0; r < repeats; ++ r)
+    {
+        int32_t const lhs_len = test::next_random (rnd) % (lhs_type::max_size () + 1);
+        int32_t const rhs_len = test::next_random (rnd) % (rhs_type::max_size () + 1);
+        {
+            for (int32_t i = 0; i < lhs_len; ++ i) lhs_buf [i] = 'a' + test::next_random (rnd) % 3;
+            lhs_buf [lhs_len] = '\0';
+            for (int32_t i = 0; i < rhs_len; ++ i) rhs_buf [i] = 'a' + test::next_random (rnd) % 3;
+            rhs_buf [rhs_len] = '\0';
+        }
+
+        lhs_type const lhs { lhs_buf, lhs_len };
+        rhs_type const rhs { rhs_buf, rhs_len };
+        fw_string<8> const mid { rhs_buf, std::min (rhs_len, 8) };
+
+        int32_t const c_std = std::strcmp (lhs_buf, rhs_buf);
+
+        ASSERT_EQ (lhs < rhs, (c_std < 0)) << "failed for lhs '" << lhs_buf << "', rhs '" << rhs_buf << '\'';
+        ASSERT_EQ (rhs < lhs, (c_std > 0)) << "failed for lhs '" << lhs_buf << "', rhs '" << rhs_buf << '\'';
+        ASSERT_EQ (lhs == rhs, (c_std == 0)) << "failed for lhs '" << lhs_buf << "', rhs '" << rhs_buf << '\'';
+
+        ASSERT_EQ (lhs < mid, (std::strncmp (lhs_buf, rhs_buf, 8) < 0 )) << "failed for lhs '" << lhs_buf << "', rhs '" << rhs_buf << '\'';
+    }
+}
+
 TYPED_TEST (fw_string_test, mapping)
 {
     using string_type           = TypeParam; // test parameter
@@ -308,7 +377,7 @@ TYPED_TEST (fw_string_test, mapping)
     {
         int32_t const fws_len = test::next_random (rnd) % max_size;
         {
-            for (int32_t i = 0; i < fws_len; ++ i) fws_buf [i] = 1 + test::next_random (rnd) % 127; // positive chars
+            for (int32_t i = 0; i < fws_len; ++ i) fws_buf [i] = 1 + test::next_random (rnd) % 255; // any non-null chars
             fws_buf [fws_len] = '\0';
         }
 
@@ -12,6 +12,7 @@
 #include <boost/algorithm/string/replace.hpp>
 #include <boost/thread/tss.hpp>
 
+#include <atomic> // std::atomic_{load,store} () for 'std::shared_ptr'
 #include <mutex>
 
 //----------------------------------------------------------------------------
@@ -25,6 +26,7 @@ namespace io
 #define vr_STMT_PERSIST_AS_OF_1     "#1.pao.DAO"
 #define vr_STMT_PERSIST_AS_OF_2     "#2.pao.DAO"
 #define vr_STMT_DELETE_AS_OF        "#dao.DAO"
+#define vr_STMT_SNAPSHOT_AS_OF      "#sao.DAO"
 
 //............................................................................
 
@@ -86,6 +88,25 @@ table_info_callback (addr_t const data, int32_t col_count, char ** field_names,
     (* static_cast<bool *> (data)) = true;
     return 0;
 }
+//............................................................................
+/*
+ * all objects of a type valid as of a given date (immutable once published)
+ */
+struct as_of_snapshot final
+{
+    using obj_map           = boost::unordered_map</* ID key */std::string, /* obj JSON */std::string>;
+
+    as_of_snapshot (int32_t const sb, int64_t const generation) :
+        m_sb { sb },
+        m_generation { generation }
+    {
+    }
+
+    int32_t const m_sb;
+    int64_t const m_generation; // 'ifc_context::m_write_generation' value when the scan started
+    obj_map m_objs { };
+
+}; // end of class
 
 } // end of anonymous
 //............................................................................
@@ -105,6 +126,24 @@ struct object_DAO::ifc_context final
 
     VR_FORCEINLINE sql_connection_factory & sql_factory ();
 
+    void drop_snapshot ()
+    {
+        if (std::atomic_load (& m_snapshot)) std::atomic_store (& m_snapshot, std::shared_ptr<as_of_snapshot const> { });
+    }
+
+    /*
+     * invoked after a write of this type through 'c': invalidates any snapshot now and
+     * again once the writer's TX has ended (a snapshot scan in between would otherwise see
+     * pre-commit state)
+     */
+    void invalidate_snapshot (connection & c)
+    {
+        ++ m_write_generation;
+        drop_snapshot ();
+
+        c.at_tx_end (this, [this]() { ++ m_write_generation; drop_snapshot (); });
+    }
+
 
     object_DAO::pimpl & m_pimpl;
     impl::object_DAO_ifc m_ifc; // construct this before moving into the fields below
@@ -115,6 +154,9 @@ struct object_DAO::ifc_context final
     std::string const m_stmt_ID_persist_as_of_1 { m_table_name + vr_STMT_PERSIST_AS_OF_1 };
     std::string const m_stmt_ID_persist_as_of_2 { m_table_name + vr_STMT_PERSIST_AS_OF_2 };
     std::string const m_stmt_ID_delete_as_of { m_table_name + vr_STMT_DELETE_AS_OF };
+    std::string const m_stmt_ID_snapshot_as_of { m_table_name + vr_STMT_SNAPSHOT_AS_OF };
+    std::shared_ptr<as_of_snapshot const> m_snapshot { }; // note: accessed only via 'std::atomic_{load,store} ()'
+    std::atomic<int64_t> m_write_generation { }; // bumped by writes of this type (a snapshot is only valid if built entirely within one generation)
     boost::thread_specific_ptr<connection> m_ro_c_tls_cached { & null_delete }; // note: not 'static' by design
     boost::thread_specific_ptr<connection> m_rw_c_tls_cached { & null_delete }; // note: not 'static' by design
 
@@ -357,6 +399,23 @@ object_DAO_ifc::find_as_of (std::type_index const & tix, call_traits<util::date_
 
     int32_t const sb = util::date_as_int (date);
 
+    // check for a snapshot as of 'date' first:
+    {
+        std::shared_ptr<as_of_snapshot const> const snapshot = std::atomic_load (& ctx.m_snapshot);
+
+        if (snapshot && (snapshot->m_sb == sb) && (snapshot->m_generation == ctx.m_write_generation.load ())) // [a write may have raced with its publication]
+        {
+            auto const i = snapshot->m_objs.find (ctx.m_fns.m_kfn (ID));
+            if (i != snapshot->m_objs.end ())
+            {
+                std::string const & obj_str = i->second;
+                ctx.m_fns.m_ufn ({ obj_str.data (), static_cast<int32_t> (obj_str.size ()) }, optional_obj);
+            }
+
+            return; // [the snapshot is complete for 'date']
+        }
+    }
+
     DLOG_trace1 << "querying v[" << sb << "] obj ...";
 
     connection * c { };
@@ -453,6 +512,121 @@ object_DAO_ifc::find_as_of (std::type_index const & tix, call_traits<util::date_
 }
 //............................................................................
 
+int32_t
+object_DAO_ifc::snapshot_as_of (std::type_index const & tix, call_traits<util::date_t>::param date)
+{
+    assert_condition (! date.is_special (), date);
+
+    object_DAO::ifc_context & ctx = context<object_DAO::ifc_context> ();
+
+    int32_t const sb = util::date_as_int (date);
+
+    LOG_trace1 << "materializing [" << ctx.m_table_name << "] objs as of v[" << sb << "] ...";
+
+    connection * c { };
+    bool c_scoped { true }; // default to 'c' being scoped to this method
+    {
+        c = ctx.m_ro_c_tls_cached.get (); // note: check a value possibly acquired by 'tx_begin()'
+        if (c)
+            c_scoped = false;
+        else
+            c = & ctx.sql_factory ().acquire (ctx.m_pimpl.m_ro_cfg_name);
+    }
+
+    VR_SCOPE_EXIT ([& ctx, c, c_scoped, this]() { if (c_scoped) ctx.sql_factory ().release (* c); });
+
+    // acquire stmt cache associated with 'c's handle, if any:
+
+    ::sqlite3 * const handle = c_handle (* c);
+
+    ::sqlite3_stmt * stmt { }; // assigned below
+    {
+        std::string const & stmt_ID = ctx.m_stmt_ID_snapshot_as_of;
+
+        std::lock_guard<spin_lock> _1 { ctx.m_pimpl.m_type_map_ll_lock }; // acquire a light-weight lock first
+
+        sqlite_stmt_cache & stmt_cache = ctx.m_pimpl.stmt_cache_for (handle);
+
+        stmt = stmt_cache.cached (stmt_ID);
+        if (VR_UNLIKELY (stmt == nullptr))
+        {
+            std::string sql { };
+            {
+                std::stringstream ss { };
+
+                ss << "SELECT [" << ctx.m_key_name << "], [obj] "
+                      "FROM [" << ctx.m_table_name << "] "
+                      "WHERE [vb] <= @vb AND (@vb < [ve] OR [ve] IS NULL) "
+                      "ORDER BY [" << ctx.m_key_name << "] "
+                      ";";
+
+                sql = ss.str ();
+            }
+
+            DLOG_trace2 << "SQL: [" << sql << ']';
+
+            {
+                std::lock_guard<mutex_lock> _2 { ctx.m_pimpl.m_type_map_hl_lock }; // acquire a costlier lock next
+
+                stmt = stmt_cache.prepare (stmt_ID, sql, * c);
+            }
+        }
+    }
+    assert_nonnull (stmt);
+
+    // bind '@vb':
+
+    VR_CHECKED_SQLITE_CALL (::sqlite3_bind_int (stmt, ::sqlite3_bind_parameter_index (stmt, "@vb"), sb));
+
+    // execute, streaming the result set into a new snapshot:
+
+    int64_t const generation = ctx.m_write_generation.load (); // note: captured before the scan
+
+    std::shared_ptr<as_of_snapshot> const snapshot = std::make_shared<as_of_snapshot> (sb, generation);
+    as_of_snapshot::obj_map & objs = snapshot->m_objs;
+
+    while (true)
+    {
+        int32_t const rc = ::sqlite3_step (stmt);
+
+        if (VR_LIKELY (rc == SQLITE_ROW))
+        {
+            string_literal_t const key_str = reinterpret_cast<string_literal_t> (::sqlite3_column_text (stmt, 0)); // note: INTEGER keys get converted to text
+            string_literal_t const obj_str = reinterpret_cast<string_literal_t> (::sqlite3_column_text (stmt, 1));
+
+            if (VR_LIKELY ((key_str != nullptr) & (obj_str != nullptr)))
+            {
+                bool const inserted = objs.emplace (key_str, obj_str).second;
+                check_condition (inserted, key_str); // the validity intervals of an ID are not expected to overlap
+            }
+        }
+        else if (rc == SQLITE_DONE)
+            break;
+        else // TODO handle BUSY
+            throw_x (io_exception, "sqlite statement step error (" + string_cast (rc) + "): " + ::sqlite3_errstr (rc));
+    }
+
+    VR_CHECKED_SQLITE_CALL (::sqlite3_reset (stmt)); // this is a one-off scan, don't hold a read snapshot on 'c' longer than necessary
+
+    int32_t const r = objs.size ();
+
+    // publish unless a write of this type has happened (or ended its TX) since the scan started:
+
+    if (VR_LIKELY (ctx.m_write_generation.load () == generation))
+    {
+        std::atomic_store (& ctx.m_snapshot, std::shared_ptr<as_of_snapshot const> { snapshot }); // [still checked against 'm_write_generation' by readers]
+
+        LOG_trace1 << "materialized " << r << " [" << ctx.m_table_name << "] obj(s) as of v[" << sb << ']';
+    }
+    else
+    {
+        LOG_trace1 << "discarded " << r << " [" << ctx.m_table_name << "] obj(s) as of v[" << sb << "]: concurrent write";
+    }
+
+    return r;
+}
+//............................................................................
+
 bool
 object_DAO_ifc::persist_as_of (std::type_index const & tix, call_traits<util::date_t>::param date, addr_const_t/* T */ const obj)
 {
@@ -595,6 +769,8 @@ object_DAO_ifc::persist_as_of (std::type_index const & tix, call_traits<util::da
             else if (VR_UNLIKELY (rc != SQLITE_ROW)) // TODO handle BUSY
                 throw_x (io_exception, "sqlite statement step error (" + string_cast (rc) + "): " + ::sqlite3_errstr (rc));
         }
+
+        ctx.invalidate_snapshot (* c);
     }
 
     return rows_changed;
@@ -685,6 +861,8 @@ object_DAO_ifc::delete_as_of (std::type_index const & tix, call_traits<util::dat
 
     int32_t const rows_changed = ::sqlite3_changes (handle); // note: no races with other threads 'cause we still have the connection
 
+    if (rows_changed) ctx.invalidate_snapshot (* c);
+
     return rows_changed;
 }
 
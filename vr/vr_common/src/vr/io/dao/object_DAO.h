@@ -51,6 +51,18 @@ class object_DAO final: public util::di::component
              */
             VR_ASSUME_HOT optional<T> find_as_of (call_traits<date_t>::param date, typename call_traits<ID_value_type>::param ID); /* const */
 
+            /**
+             * materialize all objects valid as of 'date' with a single table scan into an immutable
+             * in-memory snapshot, from which subsequent 'find_as_of (date, ...)' calls (from any thread)
+             * are served; the snapshot is dropped by the next write of 'T' through this DAO (and again
+             * when that write's TX ends), and is not published at all if such a write overlaps the scan
+             *
+             * @note only one (the latest) snapshot date is retained per 'T'
+             *
+             * @return number of objects in the snapshot
+             */
+            VR_ASSUME_COLD int32_t snapshot_as_of (call_traits<date_t>::param date);
+
         }; // end of nested class
 
         /**
@@ -162,6 +174,13 @@ object_DAO::ro_ifc_impl<T, ID_FIELD>::find_as_of (call_traits<date_t>::param dat
 
     return r;
 }
+
+template<typename T, typename ID_FIELD>
+int32_t
+object_DAO::ro_ifc_impl<T, ID_FIELD>::snapshot_as_of (call_traits<date_t>::param date)
+{
+    return ifc_impl::snapshot_as_of (std::type_index { typeid (T) }, date);
+}
 //............................................................................
 //............................................................................
 
@@ -45,6 +45,11 @@ struct bind_ID<ID_VALUE_TYPE,
         return "INTEGER";
     }
 
+    static std::string key (ID_VALUE_TYPE const & ID) // same as sqlite's text conversion of the column value
+    {
+        return string_cast (ID);
+    }
+
 }; // end of specialization
 
 template<typename ID_VALUE_TYPE> // specialize for 'std::string'
@@ -61,6 +66,11 @@ struct bind_ID<ID_VALUE_TYPE,
         return "TEXT";
     }
 
+    static std::string key (std::string const & ID)
+    {
+        return ID;
+    }
+
 }; // end of specialization
 //............................................................................
 
@@ -90,6 +100,7 @@ unmarshall (util::str_range const & s, optional<T> & obj_optional)
 
 using bind_ID_fn        = void (*) (::sqlite3_stmt * const stmt, addr_const_t/* ID_value_type */ const ID, string_literal_t const ID_name);
 using bind_obj_ID_fn    = void (*) (::sqlite3_stmt * const stmt, addr_const_t/* T */ const obj, string_literal_t const ID_name);
+using ID_key_fn         = std::string (*) (addr_const_t/* ID_value_type */ const ID);
 
 using unmarshall_fn     = void (*) (util::str_range const & s, addr_t/* T */ const obj);
 using marshall_fn       = std::ostream & (*) (addr_const_t/* T */ const obj, std::ostream &);
@@ -99,6 +110,7 @@ struct type_erased_fns final
     string_literal_t const m_key_data_type;
     bind_ID_fn const m_bifn;
     bind_obj_ID_fn const m_bofn;
+    ID_key_fn const m_kfn;
     unmarshall_fn const m_ufn;
     marshall_fn const m_mfn;
 
@@ -120,6 +132,9 @@ struct make_erased_fns
         using bind_obj_ID_T_fn      = void (*) (::sqlite3_stmt * const stmt, T const & obj, string_literal_t const ID_name);
         bind_obj_ID_T_fn const bofn = & bind_obj_ID<T, ID_FIELD, ID_value_type>::evaluate;
 
+        using ID_key_T_fn           = std::string (*) (ID_value_type const & ID);
+        ID_key_T_fn const kfn       = & bind_ID<ID_value_type>::key;
+
         using umarshall_T_fn        = void (*) (util::str_range const & s, optional<T> & obj_optional);
         umarshall_T_fn const ufn    = & unmarshall<T>;
 
@@ -131,6 +146,7 @@ struct make_erased_fns
             bind_ID<ID_value_type>::data_type (),
             reinterpret_cast<bind_ID_fn> (bifn),
             reinterpret_cast<bind_obj_ID_fn> (bofn),
+            reinterpret_cast<ID_key_fn> (kfn),
             reinterpret_cast<unmarshall_fn> (ufn),
             reinterpret_cast<marshall_fn> (mfn)
         };
@@ -157,6 +173,8 @@ class object_DAO_ifc
 
         VR_ASSUME_HOT void find_as_of (std::type_index const & tix, call_traits<util::date_t>::param date, addr_const_t/* ID_value_type */ const ID, addr_t/* optional<T> */ const optional_obj);
 
+        VR_ASSUME_COLD int32_t snapshot_as_of (std::type_index const & tix, call_traits<util::date_t>::param date);
+
         // read/write:
 
         tx_guard<connection> tx_begin_rw ();
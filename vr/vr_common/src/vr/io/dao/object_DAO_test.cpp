@@ -610,6 +610,171 @@ TEST (object_DAO, populate_two_types)
         app.stop ();
     }
 }
+//............................................................................
+
+TEST (object_DAO, snapshot_as_of)
+{
+    fs::path const out_dir { test::unique_test_path () };
+    io::create_dirs (out_dir);
+
+    fs::path const db_file { out_dir / "db" };
+
+    settings const sql_cfg_ro
+    {
+        { "mode", "ro" },
+        { "cache", "shared" },
+        { "db", db_file.string () }
+    };
+
+    settings const sql_cfg_rwc
+    {
+        { "mode", "rwc" },
+        { "cache", "private" },
+        { "db", db_file.string () },
+        { "wal", true }
+    };
+
+    util::date_t const start = util::current_date_local ();
+
+    constexpr int32_t ID_count      = 200;
+    constexpr int32_t day_count     = 20;
+
+    util::di::container app { join_as_name ("APP", test::current_test_name ()) };
+
+    app.configure ()
+        ("sql", new sql_connection_factory { { { "sql.ro", sql_cfg_ro }, { "sql.rwc", sql_cfg_rwc } } })
+        ("DAO", new object_DAO { { { "cfg.ro", "sql.ro" }, { "cfg.rw", "sql.rwc" } } })
+    ;
+
+    app.start ();
+    {
+        object_DAO & dao = app ["DAO"];
+
+        // populate: ID 'k' appears on day 'k % 5', changes every 3 days and (for k % 7 == 0) is deleted on day 10:
+        {
+            auto & ifc = dao.rw_ifc<test_meta_object> (); // r/w
+
+            auto tx { ifc.tx_begin () };
+
+            for (int32_t day = 0; day < day_count; ++ day)
+            {
+                util::date_t const d = start + gd::days { day };
+
+                for (int32_t k = 0; k < ID_count; ++ k)
+                {
+                    if (day < (k % 5)) continue;
+
+                    if ((k % 7 == 0) && (day >= 10))
+                    {
+                        if (day == 10) ASSERT_TRUE (ifc.delete_as_of (d, k));
+                        continue;
+                    }
+
+                    test_meta_object obj { };
+                    {
+                        obj.key () = k;
+                        obj.state () = join_as_name<'.'> ("S", k, day / 3);
+                    }
+
+                    ifc.persist_as_of (d, obj);
+                }
+            }
+
+            tx.commit ();
+        }
+
+        auto & ifc = dao.ro_ifc<test_meta_object> (); // ro
+
+        for (int32_t day : { 0, 4, 9, 10, 19 })
+        {
+            util::date_t const d = start + gd::days { day };
+
+            // individual queries first:
+
+            std::vector<optional<test_meta_object>> expected { };
+            int32_t expected_count { };
+
+            for (int32_t k = 0; k < ID_count; ++ k)
+            {
+                expected.push_back (ifc.find_as_of (d, k));
+                expected_count += !! expected.back ();
+            }
+
+            ASSERT_EQ (expected_count, ifc.snapshot_as_of (d)) << "day " << day;
+
+            // same queries, now served from the snapshot:
+
+            for (int32_t k = 0; k < ID_count; ++ k)
+            {
+                optional<test_meta_object> const obj_result = ifc.find_as_of (d, k);
+
+                ASSERT_EQ (!! expected [k], !! obj_result) << "day " << day << ", ID " << k;
+                if (obj_result)
+                {
+                    EXPECT_EQ (expected [k]->key (), obj_result->key ());
+                    EXPECT_EQ (expected [k]->state (), obj_result->state ());
+                }
+            }
+
+            EXPECT_FALSE (ifc.find_as_of (d, ID_count)); // not in the db
+        }
+
+        // a write drops the snapshot:
+        {
+            util::date_t const d = start + gd::days { day_count - 1 };
+            ASSERT_TRUE (ifc.snapshot_as_of (d) > 0);
+
+            auto & rw_ifc = dao.rw_ifc<test_meta_object> ();
+            {
+                auto tx { rw_ifc.tx_begin () };
+
+                test_meta_object obj { };
+                {
+                    obj.key () = 1;
+                    obj.state () = "changed";
+                }
+                ASSERT_TRUE (rw_ifc.persist_as_of (d, obj));
+
+                tx.commit ();
+            }
+
+            optional<test_meta_object> const obj_result = ifc.find_as_of (d, 1);
+            ASSERT_TRUE (obj_result);
+            EXPECT_EQ ("changed", obj_result->state ());
+        }
+
+        // a snapshot taken while a write's TX is still open doesn't survive its commit:
+        {
+            util::date_t const d = start + gd::days { day_count };
+
+            auto & rw_ifc = dao.rw_ifc<test_meta_object> ();
+            {
+                auto tx { rw_ifc.tx_begin () };
+
+                test_meta_object obj { };
+                {
+                    obj.key () = 1;
+                    obj.state () = "changed again";
+                }
+                ASSERT_TRUE (rw_ifc.persist_as_of (d, obj));
+
+                ASSERT_TRUE (ifc.snapshot_as_of (d) > 0); // sees only committed state
+                {
+                    optional<test_meta_object> const obj_result = ifc.find_as_of (d, 1);
+                    ASSERT_TRUE (obj_result);
+                    EXPECT_EQ ("changed", obj_result->state ());
+                }
+
+                tx.commit ();
+            }
+
+            optional<test_meta_object> const obj_result = ifc.find_as_of (d, 1);
+            ASSERT_TRUE (obj_result);
+            EXPECT_EQ ("changed again", obj_result->state ());
+        }
+    }
+    app.stop ();
+}
 
 } // end of 'io'
 } // end of namespace
@@ -24,6 +24,8 @@ using window_t              = pos_t;
 VR_META_TAG (ring);
 VR_META_TAG (tape);
 
+VR_META_TAG (uring); // link recv aspect: poll via io_uring completions instead of recv syscalls
+
 //............................................................................
 
 constexpr pos_t default_mmap_reserve_size ()    { return (1L << 40); }
@@ -33,6 +35,7 @@ constexpr pos_t default_mmap_reserve_size ()    { return (1L << 40); }
 VR_META_TAG (ts_origin);
 VR_META_TAG (ts_local);
 VR_META_TAG (ts_local_delta);
+VR_META_TAG (ts_sent); // local (kernel or NIC) tx completion time of the request that a received message responds to
 
 VR_META_TAG (ts_last_recv);
 VR_META_TAG (ts_last_send);
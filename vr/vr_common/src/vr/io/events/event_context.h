@@ -14,6 +14,7 @@ using event_schema  = meta::make_schema_t
     meta::fdef_<timestamp_t,    _ts_local_>,
     meta::fdef_<timestamp_t,    _ts_local_delta_>,
     meta::fdef_<timestamp_t,    _ts_origin_>,
+    meta::fdef_<timestamp_t,    _ts_sent_>,
 
     meta::fdef_<int64_t,        net::_packet_index_>,
     meta::fdef_<uint16_t,       net::_src_port_>,
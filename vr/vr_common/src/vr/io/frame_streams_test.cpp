@@ -106,6 +106,15 @@ struct HDF_zlib_factory: public HDF_factory
 
 }; // end of class
 
+struct HDF_zlib_parallel_factory: public HDF_factory
+{
+    static ostream_type create (fs::path const & file)
+    {
+        return { { { "filter", filter::zlib }, { "chunk_size", 256 }, { "workers", 3 } }, file };
+    }
+
+}; // end of class
+
 struct HDF_blosc_factory: public HDF_factory
 {
     static ostream_type create (fs::path const & file)
@@ -127,7 +136,7 @@ struct scenario
 
 }; // end of scenario
 
-using scenarios         = gt::Types<CSV_factory, HDF_factory, HDF_zlib_factory, HDF_blosc_factory>;
+using scenarios         = gt::Types<CSV_factory, HDF_factory, HDF_zlib_factory, HDF_zlib_parallel_factory, HDF_blosc_factory>;
 
 template<typename T> struct frame_stream_test: public gt::Test { };
 TYPED_TEST_CASE (frame_stream_test, scenarios);
@@ -7,10 +7,18 @@
 #include "vr/utility.h"
 
 #if VR_USE_BLOSC // TODO ASX-60
+#   include <blosc.h>
 #   include <blosc_filter.h>
 #endif
 
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
 #include <hdf5.h>
+#include <zlib.h>
+
+#include <deque>
 
 //----------------------------------------------------------------------------
 namespace vr
@@ -61,7 +69,7 @@ namespace
 
 vr_static_assert (sizeof (::hid_t) == sizeof (bitset32_t));
 
-int32_t const chunk_size                    = 4 * 1024; // TODO experiment TODO make this a parm
+int32_t const default_chunk_size            = 4 * 1024; // rows per dataset chunk (overridden by "chunk_size" parm)
 
 int32_t const zlib_default_compression      = 6;
 
@@ -111,8 +119,11 @@ struct HDF_frame_stream_state_base
     HDF_frame_stream_state_base (fs::path const & file, bitset32_t const mode, arg_map const & parms) :
         m_file { file },
         m_mode { mode },
-        m_filter { parms.get<filter> ("filter", filter::none) }
+        m_filter { parms.get<filter> ("filter", filter::none) },
+        m_chunk_size { parms.get<int32_t> ("chunk_size", default_chunk_size) }
     {
+        check_positive (m_chunk_size);
+
         if (m_filter != filter::none)
         {
             for (int32_t a = 0; true; ++ a)
@@ -127,7 +138,7 @@ struct HDF_frame_stream_state_base
             }
         }
 
-        LOG_trace1 << "configured with " << print (m_filter) << " filter, " << m_filter_parms.size () << " filter parm(s)";
+        LOG_trace1 << "configured with " << print (m_filter) << " filter, " << m_filter_parms.size () << " filter parm(s), chunk size " << m_chunk_size;
     }
 
 
@@ -240,6 +251,7 @@ struct HDF_frame_stream_state_base
     ::hsize_t m_mem_space_size { }; // curent size of 'm_mem_space_ID'
     bitset32_t const m_mode;
     filter::enum_t const m_filter;
+    int32_t const m_chunk_size;
     std::vector<any> m_filter_parms;
 
 }; // end of class
@@ -330,7 +342,7 @@ struct dataset_creator final // stateless
 
         } // end of switch
 
-        ::hsize_t const dset_chunk_dim      = chunk_size;
+        ::hsize_t const dset_chunk_dim      = state.m_chunk_size;
         vr_CHECKED_H5_CALL (::H5Pset_chunk (dset_cpl, 1, & dset_chunk_dim));
         check_eq (::H5Pget_layout (dset_cpl), ::H5D_CHUNKED);
 
@@ -426,6 +438,407 @@ struct dataset_writer final // stateless
         vr_CHECKED_H5_CALL (::H5Dwrite (dset_ID, storage_type, mem_space_ID, dset_space, H5P_DEFAULT, col_raw));
     }
 
+}; // end of class
+//............................................................................
+/*
+ * the "parallel" write path (enabled with "workers" > 0 and a compressing filter):
+ *
+ * rows are staged into chunk-sized column batches; each full batch has its column
+ * chunks compressed by a pool of worker threads and a single I/O thread appends
+ * them, in chunk order, via HDF direct chunk writes (bypassing HDF's own filter
+ * pipeline); the 'write()' caller only ever copies into the next staging batch
+ *
+ * note: HDF is only touched by the I/O thread while the pipeline is running
+ */
+class chunk_pipeline final: noncopyable
+{
+    private: // ..............................................................
+
+        using lock_type             = boost::unique_lock<boost::mutex>;
+
+        struct chunk_batch final
+        {
+            int64_t m_chunk_index { -1 };
+            int32_t m_rows { };                                 // rows staged so far
+            width_type m_cols_pending { };                      // protected by 'm_mutex'
+            std::vector<std::unique_ptr<int8_t []>> m_raw { };  // per column, 'm_chunk_size' rows
+            std::vector<std::unique_ptr<int8_t []>> m_packed { };
+            std::vector<std::size_t> m_packed_size { };
+
+        }; // end of nested class
+
+        struct task final
+        {
+            chunk_batch * m_batch;
+            width_type m_col;
+
+        }; // end of nested class
+
+    public: // ...............................................................
+
+        chunk_pipeline (HDF_frame_stream_state_base const & state, attr_schema const & as, int32_t const workers) :
+            m_dset_IDs { state.m_attr_dset_IDs },
+            m_chunk_size { state.m_chunk_size },
+            m_filter { state.m_filter },
+            m_batches (workers + 2) // bound the number of batches in flight (staging + compressing + writing)
+        {
+            check_positive (workers);
+
+            switch (m_filter)
+            {
+                case filter::zlib:
+                {
+                    m_level = (state.m_filter_parms.size () > 0 ? any_get<int32_t> (state.m_filter_parms [0]) : zlib_default_compression);
+                }
+                break;
+
+#            if VR_USE_BLOSC
+                case filter::blosc:
+                {
+                    m_level = (state.m_filter_parms.size () > 0 ? any_get<int32_t> (state.m_filter_parms [0]) : blosc_default_compression);
+                    m_shuffle = (state.m_filter_parms.size () > 1 ? any_get<int32_t> (state.m_filter_parms [1]) : blosc_default_shuffle);
+                }
+                break;
+#            endif // VR_USE_BLOSC
+
+                default: throw_x (invalid_input, "parallel chunk writes not supported for filter " + print (m_filter));
+
+            } // end of switch
+
+            width_type const col_count { as.size () };
+            check_eq (signed_cast (m_dset_IDs.size ()), col_count);
+
+            for (width_type c = 0; c < col_count; ++ c)
+            {
+                int32_t const width = atype::width [as [c].atype ()];
+                std::size_t const raw_size = static_cast<std::size_t> (m_chunk_size) * width;
+
+                m_col_width.push_back (width);
+                m_packed_capacity.push_back (packed_capacity (raw_size));
+            }
+
+            for (chunk_batch & b : m_batches)
+            {
+                for (width_type c = 0; c < col_count; ++ c)
+                {
+                    b.m_raw.emplace_back (boost::make_unique_noinit<int8_t []> (static_cast<std::size_t> (m_chunk_size) * m_col_width [c]));
+                    b.m_packed.emplace_back (boost::make_unique_noinit<int8_t []> (m_packed_capacity [c]));
+                }
+                b.m_packed_size.resize (col_count);
+
+                m_free.push_back (& b);
+            }
+
+            LOG_trace1 << "starting " << workers << " compression worker(s), " << m_batches.size () << " batch(es) of " << m_chunk_size << " row(s)";
+
+            for (int32_t w = 0; w < workers; ++ w)
+            {
+                m_compressors.emplace_back ([this]() { compress_loop (); });
+            }
+            m_writer = boost::thread { [this]() { write_loop (); } };
+        }
+
+        ~chunk_pipeline () VR_NOEXCEPT // note: drops the current staging batch if 'finish()' hasn't been called
+        {
+            join ();
+        }
+
+
+        /*
+         * caller thread: copy 'row_count' rows of 'src' starting at 'src_row' into staging batches
+         */
+        void append (dataframe const & src, dataframe::size_type src_row, dataframe::size_type row_count)
+        {
+            while (row_count > 0)
+            {
+                chunk_batch & b = fill_batch ();
+
+                dataframe::size_type const n = std::min<dataframe::size_type> (row_count, m_chunk_size - b.m_rows);
+                assert_positive (n);
+
+                for (width_type c = 0, c_limit = m_col_width.size (); c < c_limit; ++ c)
+                {
+                    int32_t const width = m_col_width [c];
+
+                    std::memcpy (b.m_raw [c].get () + b.m_rows * width, byte_ptr_cast (src.at_raw<false> (c)) + src_row * width, n * width);
+                }
+
+                b.m_rows += n;
+                src_row += n;
+                row_count -= n;
+
+                if (b.m_rows == m_chunk_size) submit (b);
+            }
+        }
+
+        /*
+         * caller thread: submit the last (partial) batch, wait for all chunk writes to complete
+         * and join all pipeline threads
+         *
+         * @throws the first failure recorded by any pipeline thread
+         */
+        void finish ()
+        {
+            chunk_batch * const b = m_filling;
+            if ((b != nullptr) && b->m_rows)
+            {
+                // zero-pad the tail (HDF expects full-size chunks, the dataset extent hides the padding):
+
+                for (width_type c = 0, c_limit = m_col_width.size (); c < c_limit; ++ c)
+                {
+                    int32_t const width = m_col_width [c];
+
+                    std::memset (b->m_raw [c].get () + b->m_rows * width, 0, (m_chunk_size - b->m_rows) * width);
+                }
+
+                submit (* b);
+            }
+
+            join ();
+
+            if (m_failure != nullptr) std::rethrow_exception (m_failure); // note: non-null guard is required
+        }
+
+    private: // ..............................................................
+
+        std::size_t packed_capacity (std::size_t const raw_size) const
+        {
+            switch (m_filter)
+            {
+                case filter::zlib:  return ::compressBound (raw_size);
+#            if VR_USE_BLOSC
+                case filter::blosc: return (raw_size + BLOSC_MAX_OVERHEAD);
+#            endif // VR_USE_BLOSC
+
+                default: VR_ASSUME_UNREACHABLE ();
+
+            } // end of switch
+        }
+
+
+        chunk_batch & fill_batch ()
+        {
+            if (VR_LIKELY (m_filling != nullptr))
+                return (* m_filling);
+
+            chunk_batch * b;
+            {
+                lock_type _ { m_mutex };
+
+                while (m_free.empty () && (m_failure == nullptr)) m_free_cv.wait (_);
+
+                if (VR_UNLIKELY (m_failure != nullptr)) std::rethrow_exception (m_failure);
+
+                b = m_free.back ();
+                m_free.pop_back ();
+            }
+
+            b->m_chunk_index = m_chunk_count ++;
+            b->m_rows = 0;
+
+            return (* (m_filling = b));
+        }
+
+        void submit (chunk_batch & b)
+        {
+            m_filling = nullptr;
+            {
+                lock_type _ { m_mutex };
+
+                width_type const col_count = m_col_width.size ();
+
+                b.m_cols_pending = col_count;
+                m_submitted.push_back (& b);
+
+                for (width_type c = 0; c < col_count; ++ c)
+                {
+                    m_tasks.push_back ({ & b, c });
+                }
+            }
+            m_task_cv.notify_all ();
+        }
+
+        void join () VR_NOEXCEPT
+        {
+            {
+                lock_type _ { m_mutex };
+
+                m_closing = true;
+            }
+            m_task_cv.notify_all ();
+            m_io_cv.notify_all ();
+
+            for (boost::thread & t : m_compressors)
+            {
+                if (t.joinable ()) t.join ();
+            }
+            if (m_writer.joinable ()) m_writer.join ();
+        }
+
+        void record_failure (std::exception_ptr const & eptr)
+        {
+            {
+                lock_type _ { m_mutex };
+
+                if (m_failure == nullptr) m_failure = eptr;
+            }
+            m_task_cv.notify_all ();
+            m_io_cv.notify_all ();
+            m_free_cv.notify_all ();
+        }
+
+        // worker threads:
+
+        void compress_loop ()
+        {
+            while (true)
+            {
+                task t;
+                {
+                    lock_type _ { m_mutex };
+
+                    while (m_tasks.empty () && ! m_closing && (m_failure == nullptr)) m_task_cv.wait (_);
+
+                    if ((m_failure != nullptr) || m_tasks.empty ()) // the latter implies 'm_closing'
+                        return;
+
+                    t = m_tasks.front ();
+                    m_tasks.pop_front ();
+                }
+
+                try
+                {
+                    compress (* t.m_batch, t.m_col);
+                }
+                catch (...)
+                {
+                    record_failure (std::current_exception ());
+                    return;
+                }
+
+                bool batch_done;
+                {
+                    lock_type _ { m_mutex };
+
+                    batch_done = (-- t.m_batch->m_cols_pending == 0);
+                }
+                if (batch_done) m_io_cv.notify_one ();
+            }
+        }
+
+        void compress (chunk_batch & b, width_type const c)
+        {
+            std::size_t const raw_size = static_cast<std::size_t> (m_chunk_size) * m_col_width [c];
+
+            switch (m_filter)
+            {
+                case filter::zlib: // same format as produced by HDF's own deflate filter
+                {
+                    ::uLongf packed_size = m_packed_capacity [c];
+
+                    int32_t const rc = ::compress2 (reinterpret_cast<::Bytef *> (b.m_packed [c].get ()), & packed_size,
+                                                    reinterpret_cast<::Bytef const *> (b.m_raw [c].get ()), raw_size, m_level);
+                    if (VR_UNLIKELY (rc != Z_OK))
+                        throw_x (io_exception, "compress2() failed (rc " + string_cast (rc) + ") for column " + string_cast (c));
+
+                    b.m_packed_size [c] = packed_size;
+                }
+                break;
+
+#            if VR_USE_BLOSC
+                case filter::blosc: // same format as produced by 'FILTER_BLOSC'
+                {
+                    int32_t const rc = ::blosc_compress_ctx (m_level, m_shuffle, m_col_width [c], raw_size, b.m_raw [c].get (),
+                                                             b.m_packed [c].get (), m_packed_capacity [c], BLOSC_BLOSCLZ_COMPNAME, 0, 1);
+                    if (VR_UNLIKELY (rc <= 0))
+                        throw_x (io_exception, "blosc_compress_ctx() failed (rc " + string_cast (rc) + ") for column " + string_cast (c));
+
+                    b.m_packed_size [c] = rc;
+                }
+                break;
+#            endif // VR_USE_BLOSC
+
+                default: VR_ASSUME_UNREACHABLE ();
+
+            } // end of switch
+        }
+
+        void write_loop ()
+        {
+            while (true)
+            {
+                chunk_batch * b;
+                {
+                    lock_type _ { m_mutex };
+
+                    while ((m_failure == nullptr) && (m_submitted.empty () ? ! m_closing : (m_submitted.front ()->m_cols_pending > 0)))
+                        m_io_cv.wait (_);
+
+                    if ((m_failure != nullptr) || m_submitted.empty ()) // the latter implies 'm_closing'
+                        return;
+
+                    b = m_submitted.front ();
+                    m_submitted.pop_front ();
+                }
+
+                try
+                {
+                    write (* b);
+                }
+                catch (...)
+                {
+                    record_failure (std::current_exception ());
+                    return;
+                }
+
+                {
+                    lock_type _ { m_mutex };
+
+                    m_free.push_back (b);
+                }
+                m_free_cv.notify_one ();
+            }
+        }
+
+        void write (chunk_batch const & b)
+        {
+            ::hsize_t const offset      = b.m_chunk_index * m_chunk_size;
+            ::hsize_t const dset_extent = offset + b.m_rows; // only the last batch can be partial
+
+            for (width_type c = 0, c_limit = m_col_width.size (); c < c_limit; ++ c)
+            {
+                ::hid_t const dset_ID = m_dset_IDs [c];
+
+                vr_CHECKED_H5_CALL (::H5Dset_extent (dset_ID, & dset_extent));
+                vr_CHECKED_H5_CALL (::H5Dwrite_chunk (dset_ID, H5P_DEFAULT, 0, & offset, b.m_packed_size [c], b.m_packed [c].get ()));
+            }
+
+            DLOG_trace2 << "wrote chunk #" << b.m_chunk_index << " (" << b.m_rows << " row(s))";
+        }
+
+
+        std::vector<::hid_t> const & m_dset_IDs;
+        int32_t const m_chunk_size;
+        filter::enum_t const m_filter;
+        int32_t m_level { };
+        int32_t m_shuffle { };
+        std::vector<int32_t> m_col_width { };
+        std::vector<std::size_t> m_packed_capacity { };
+        std::vector<chunk_batch> m_batches; // fixed size after construction
+        chunk_batch * m_filling { };        // caller thread only
+        int64_t m_chunk_count { };          // caller thread only
+        boost::mutex m_mutex { };
+        boost::condition_variable m_task_cv { };
+        boost::condition_variable m_io_cv { };
+        boost::condition_variable m_free_cv { };
+        std::vector<chunk_batch *> m_free { };      // protected by 'm_mutex'
+        std::deque<task> m_tasks { };               // protected by 'm_mutex'
+        std::deque<chunk_batch *> m_submitted { };  // protected by 'm_mutex', in chunk order
+        std::exception_ptr m_failure { };           // protected by 'm_mutex'
+        bool m_closing { };                         // protected by 'm_mutex'
+        std::vector<boost::thread> m_compressors { };
+        boost::thread m_writer { };
+
 }; // end of class
 
 } // end of anonymous
@@ -690,10 +1103,15 @@ HDF_frame_istream_base::read (data::dataframe & dst)
 struct HDF_frame_ostream_base::state final: public HDF_frame_stream_state_base
 {
     state (fs::path const & file, bitset32_t const mode, arg_map const & parms) :
-        HDF_frame_stream_state_base (file, mode, parms)
+        HDF_frame_stream_state_base (file, mode, parms),
+        m_workers { parms.get<int32_t> ("workers", 0) }
     {
+        check_nonnegative (m_workers);
     }
 
+    int32_t const m_workers;
+    std::unique_ptr<chunk_pipeline> m_pipeline { }; // note: destructs (joins) before the base closes datasets
+
 }; // end of nested class
 //............................................................................
 // HDF_frame_ostream_base:
@@ -708,7 +1126,14 @@ HDF_frame_ostream_base::HDF_frame_ostream_base (HDF_frame_ostream_base && rhs) =
 
 HDF_frame_ostream_base::~HDF_frame_ostream_base ()
 {
-    close ();
+    try
+    {
+        close ();
+    }
+    catch (std::exception const & e) // can only happen with a chunk pipeline failure
+    {
+        LOG_error << "HDF ostream FAILED to close: " << exc_info (e);
+    }
 }
 //............................................................................
 
@@ -761,6 +1186,11 @@ HDF_frame_ostream_base::initialize (data::attr_schema::ptr const & schema)
             dispatch_on_atype (a.atype (), dataset_creator { }, a, this_);
         }
     }
+
+    if ((this_.m_workers > 0) && (this_.m_filter != filter::none))
+    {
+        this_.m_pipeline = std::make_unique<chunk_pipeline> (this_, as, this_.m_workers);
+    }
 }
 
 void
@@ -770,7 +1200,9 @@ HDF_frame_ostream_base::close ()
     {
         LOG_trace1 << "HDF ostream wrote " << m_state->m_rows_done << " row(s)";
 
-        m_state.reset ();
+        std::unique_ptr<state> const s { std::move (m_state) }; // releases the state even if 'finish()' throws
+
+        if (s->m_pipeline) s->m_pipeline->finish ();
     }
 }
 //............................................................................
@@ -799,10 +1231,20 @@ HDF_frame_ostream_base::write (data::dataframe const & src)
     attr_schema const & as = * m_schema;
     state & this_ = * m_state;
 
+    dataframe::size_type const rows_written = this_.m_rows_done;
+
+    if (this_.m_pipeline) // compression and I/O happen asynchronously, this only stages column data
+    {
+        this_.m_pipeline->append (src, 0, src_row_count);
+        this_.m_rows_done = rows_written + src_row_count;
+
+        m_last_io_df = & src;
+        return src_row_count;
+    }
+
     auto const mem_space = this_.resize_mem_space (src_row_count); // once for all column datasets
 
     width_type const col_count { as.size () };
-    dataframe::size_type const rows_written = this_.m_rows_done;
 
     for (width_type c = 0; c < col_count; ++ c)
     {
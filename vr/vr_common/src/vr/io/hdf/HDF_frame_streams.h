@@ -118,6 +118,14 @@ class HDF_frame_istream final: public impl::HDF_frame_istream_base
 }; // end of class
 //............................................................................
 /**
+ * recognized 'parms':
+ *
+ *  "filter"        compression filter (default: none), with optional "filter.<i>" filter parms
+ *  "chunk_size"    dataset chunk size, in rows (default: 4K)
+ *  "workers"       if positive and a compressing filter is set, the number of background threads
+ *                  compressing full column chunks (these are then appended in order via HDF direct
+ *                  chunk writes, leaving only data staging to the 'write()' caller)
+ *
  * @note default 'EXC_POLICY' is "exceptions"
  */
 template<typename EXC_POLICY = io::exceptions>
@@ -3,6 +3,8 @@
 
 #include "vr/io/net/socket_factory.h"
 
+#include <linux/errqueue.h> // sock_extended_err, SCM_TSTAMP_*
+
 //----------------------------------------------------------------------------
 namespace vr
 {
@@ -43,6 +45,24 @@ tcp_recv_poll (int32_t const fd, addr_t const dst, capacity_t const len)
     return rc;
 }
 
+capacity_t
+tcp_recvmsg_poll (int32_t const fd, ::msghdr * const mhdr)
+{
+    capacity_t rc = ::recvmsg (fd, mhdr, (MSG_DONTWAIT | MSG_NOSIGNAL));
+    if (VR_LIKELY (rc < 0)) // frequent case for a non-blocking socket
+    {
+        auto const e = errno;
+        if (VR_UNLIKELY (e != EAGAIN))
+            throw_x (io_exception, "recvmsg() error (" + string_cast (e) + "): " + std::strerror (e));
+
+        rc = 0; // EAGAIN
+    }
+    else if (rc == 0)
+        rc = -1; // EOF
+
+    return rc;
+}
+//............................................................................
 
 capacity_t
 tcp_send (int32_t const fd, addr_const_t const src, capacity_t const len)
@@ -61,6 +81,65 @@ tcp_send (int32_t const fd, addr_const_t const src, capacity_t const len)
 
     return rc;
 }
+//............................................................................
+
+bool
+tcp_tx_timestamp_poll (int32_t const fd, net::ts_policy::enum_t const tsp, uint32_t & id, timestamp_t & ts)
+{
+    union
+    {
+        ::cmsghdr m_cm;
+        int8_t m_data [256]; // SCM_TIMESTAMPING + IP(V6)_RECVERR (with the offender address)
+    }
+    cmhdr;
+
+    ::msghdr mhdr;
+
+    while (true) // skip error queue entries that are not tx timestamps
+    {
+        std::memset (& mhdr, 0, sizeof (mhdr));
+        {
+            mhdr.msg_control = & cmhdr;
+            mhdr.msg_controllen = sizeof (cmhdr);
+        }
+
+        if (::recvmsg (fd, & mhdr, (MSG_ERRQUEUE | MSG_DONTWAIT)) < 0)
+        {
+            auto const e = errno;
+            if (VR_LIKELY (e == EAGAIN))
+                return false;
+
+            throw_x (io_exception, "recvmsg(MSG_ERRQUEUE) error (" + string_cast (e) + "): " + std::strerror (e));
+        }
+
+        bool have_ts { false };
+        bool have_id { false };
+
+        for (::cmsghdr * cmsg = CMSG_FIRSTHDR (& mhdr); cmsg; cmsg = CMSG_NXTHDR (& mhdr, cmsg))
+        {
+            if ((cmsg->cmsg_level == SOL_SOCKET) && (cmsg->cmsg_type == SCM_TIMESTAMPING))
+            {
+                ::timespec const & t = (reinterpret_cast<::timespec const *> (CMSG_DATA (cmsg))) [tsp]; // HACK enum values are chosen to skip the unused slot #1
+
+                ts = t.tv_sec * _1_second () + t.tv_nsec;
+                have_ts = (ts != 0);
+            }
+            else if (((cmsg->cmsg_level == SOL_IP) && (cmsg->cmsg_type == IP_RECVERR)) || ((cmsg->cmsg_level == SOL_IPV6) && (cmsg->cmsg_type == IPV6_RECVERR)))
+            {
+                ::sock_extended_err const * const ee = reinterpret_cast<::sock_extended_err const *> (CMSG_DATA (cmsg));
+
+                if ((ee->ee_origin == SO_EE_ORIGIN_TIMESTAMPING) && (ee->ee_errno == ENOMSG) && (ee->ee_info == SCM_TSTAMP_SND))
+                {
+                    id = ee->ee_data;
+                    have_id = true;
+                }
+            }
+        }
+
+        if (have_ts && have_id)
+            return true;
+    }
+}
 
 } // end of 'impl'
 //............................................................................
@@ -31,17 +31,46 @@ open_TCP_socket (std::string const & host, std::string const & service, bool con
 extern VR_ASSUME_HOT capacity_t
 tcp_recv_poll (int32_t const fd, addr_t const dst, capacity_t const len);
 
+/*
+ * same as 'tcp_recv_poll()' but via recvmsg() (to receive ancillary data)
+ */
+extern VR_ASSUME_HOT capacity_t
+tcp_recvmsg_poll (int32_t const fd, ::msghdr * const mhdr);
+
 /*
  * returns a non-negative byte count, 0 on EAGAIN, throws on error
  */
 extern VR_ASSUME_HOT capacity_t
 tcp_send (int32_t const fd, addr_const_t const src, capacity_t const len);
 
+/*
+ * reads the socket error queue until a tx completion timestamp is found
+ *
+ * returns 'false' on EAGAIN, throws on error
+ */
+extern bool
+tcp_tx_timestamp_poll (int32_t const fd, net::ts_policy::enum_t const tsp, uint32_t & id, timestamp_t & ts);
+
 } // end of 'impl'
 //............................................................................
 //............................................................................
 // TODO parameterize time source (e.g. sim, sw/hw, etc)
 /**
+ * timestamping:
+ *
+ *  - with a 'recv<_timestamp_, ...>' aspect, '_ts_last_recv_' is the kernel (sw or hw) rx timestamp
+ *    of the latest data read by @ref recv_poll() (falls back to the time of the read if the kernel didn't
+ *    supply one);
+ *  - with a 'send<_timestamp_, ...>' aspect, '_ts_last_send_' is the time of the latest non-empty
+ *    @ref send_flush(); additionally, if "tx_timestamps" is set, the kernel reports tx completion
+ *    timestamps that can be matched to send positions via @ref send_ts_poll();
+ *
+ * recognized recv/send args:
+ *
+ *  - "tsp" (net::ts_policy, default 'hw_fallback_to_sw');
+ *  - "ifc" (std::string, the ifc to configure for hw timestamping, default none);
+ *  - "tx_timestamps" (bool, send args only, default 'false');
+ *
  * @see socket_link
  * @see link_base
  */
@@ -59,12 +88,18 @@ class TCP_link: public socket_link<TCP_link<ASPECTs ...>, ASPECTs ...>
             super (recv_args, send_args, impl::open_TCP_socket (host, service, true, disable_nagle), join_as_name<'_'> (host, service))
         {
             vr_static_assert (super::link_mode () == (mode::recv | mode::send)); // catch ifc usage errors early at compile-time
+
+            enable_timestamps (recv_args);
+            enable_timestamps (send_args);
         }
 
         TCP_link (net::socket_handle && sh, recv_arg_map const & recv_args, send_arg_map const & send_args) :
             super (recv_args, send_args, std::move (sh), "") // TODO use sh.peer_name()
         {
             vr_static_assert (super::link_mode () == (mode::recv | mode::send)); // catch ifc usage errors early at compile-time
+
+            enable_timestamps (recv_args);
+            enable_timestamps (send_args);
         }
 
 
@@ -73,6 +108,8 @@ class TCP_link: public socket_link<TCP_link<ASPECTs ...>, ASPECTs ...>
             super (recv_args, impl::open_TCP_socket (host, service, true, disable_nagle), join_as_name<'_'> (host, service))
         {
             vr_static_assert (super::link_mode () == mode::recv); // catch ifc usage errors early at compile-time
+
+            enable_timestamps (recv_args);
         }
 
         TCP_link (std::string const & host, std::string const & service, send_arg_map const & send_args,
@@ -80,6 +117,8 @@ class TCP_link: public socket_link<TCP_link<ASPECTs ...>, ASPECTs ...>
             super (send_args, impl::open_TCP_socket (host, service, true, disable_nagle), join_as_name<'_'> (host, service))
         {
             vr_static_assert (super::link_mode () == mode::send); // catch ifc usage errors early at compile-time
+
+            enable_timestamps (send_args);
         }
 
         ~TCP_link () VR_NOEXCEPT // calls 'close ()'
@@ -89,16 +128,71 @@ class TCP_link: public socket_link<TCP_link<ASPECTs ...>, ASPECTs ...>
 
         void close () VR_NOEXCEPT; // idempotent
 
+        // ACCESSORs:
+
+        /**
+         * @return cumulative count of bytes sent by this link
+         */
+        VR_FORCEINLINE pos_t const & send_position () const
+        {
+            return m_send_pos;
+        }
+
+        // MUTATORs:
+
+        /**
+         * read the next tx completion timestamp queued by the kernel, if any (requires a 'send<_timestamp_, ...>'
+         * aspect and "tx_timestamps" set; makes a syscall, so best done only when there are sent bytes not yet
+         * covered by a timestamp)
+         *
+         * @param pos [out] send position (see @ref send_position()) just past the last byte covered by 'ts'
+         * @param ts [out]
+         * @return 'false' if there are no (more) timestamps queued
+         */
+        bool send_ts_poll (pos_t & pos, timestamp_t & ts);
+
 
         // link_base:
 
         std::pair<addr_const_t, capacity_t> recv_poll_impl ();
         capacity_t send_flush_impl (capacity_t const len);
 
+        // socket_link:
+
+        static constexpr bool uring_multishot_ok ()     { return (! super::has_ts_last_recv ()); } // a byte stream can always be appended to the w-window, but rx timestamps need recvmsg()
+
     private: // ..............................................................
 
+        using ts_tag        = util::bool_constant<super::has_ts_last_recv ()>;
+        using uring_tag     = util::bool_constant<super::has_recv_uring ()>;
+
+        void enable_timestamps (recv_arg_map const & recv_args);
+        void enable_timestamps (send_arg_map const & send_args);
+
+        /*
+         * @param ts [out] set to the latest kernel rx timestamp, if any
+         * @return count of bytes received (and w-advanced over)
+         */
+        template<bool TS>
+        VR_FORCEINLINE capacity_t recv_drain (util::bool_constant<TS>, util::bool_constant<false> /* io_uring */, timestamp_t & ts);
+        template<bool TS>
+        VR_FORCEINLINE capacity_t recv_drain (util::bool_constant<TS>, util::bool_constant<true>  /* io_uring */, timestamp_t & ts);
+
+        VR_FORCEINLINE capacity_t recv_syscall (util::bool_constant<false> /* do timestamping */);
+        VR_FORCEINLINE capacity_t recv_syscall (util::bool_constant<true>  /* do timestamping */);
+
+        VR_FORCEINLINE void uring_arm (util::bool_constant<false> /* do timestamping */);
+        VR_FORCEINLINE void uring_arm (util::bool_constant<true>  /* do timestamping */);
+
+        VR_FORCEINLINE void recv_timestamp (util::bool_constant<false> /* do timestamping */, timestamp_t & ts) { }
+        VR_FORCEINLINE void recv_timestamp (util::bool_constant<true>  /* do timestamping */, timestamp_t & ts);
+
+        VR_NOINLINE void recv_eof ();
+
         using super::m_socket;
 
+        pos_t m_send_pos { };   // count of bytes sent so far
+
 }; // end of class
 //............................................................................
 
@@ -116,25 +210,116 @@ TCP_link<ASPECTs ...>::close () VR_NOEXCEPT
 //............................................................................
 
 template<typename ... ASPECTs>
-std::pair<addr_const_t, capacity_t>
-TCP_link<ASPECTs ...>::recv_poll_impl ()
+void
+TCP_link<ASPECTs ...>::recv_eof ()
 {
-    vr_static_assert (super::link_mode () & mode::recv); // catch ifc usage errors early at compile-time
+    if (super::has_state ())
+    {
+        super::state () = link_state::closed;
+    }
+
+    throw_x (eof_exception, "recv_poll(): EOF detected"); // TODO add link parms into the message
+}
+//............................................................................
+
+template<typename ... ASPECTs>
+void
+TCP_link<ASPECTs ...>::enable_timestamps (recv_arg_map const & recv_args)
+{
+    if (super::has_ts_last_recv ())
+    {
+        net::ts_policy::enum_t const tsp = m_socket.enable_rx_timestamps (recv_args.get<std::string> ("ifc", { }), recv_args.get<net::ts_policy> ("tsp", net::ts_policy::hw_fallback_to_sw));
+        LOG_trace1 << "rx timestamping: " << tsp;
+    }
+}
+
+template<typename ... ASPECTs>
+void
+TCP_link<ASPECTs ...>::enable_timestamps (send_arg_map const & send_args)
+{
+    if (super::has_ts_last_send () && send_args.get<bool> ("tx_timestamps", false))
+    {
+        net::ts_policy::enum_t const tsp = m_socket.enable_tx_timestamps (send_args.get<std::string> ("ifc", { }), send_args.get<net::ts_policy> ("tsp", net::ts_policy::hw_fallback_to_sw));
+        LOG_trace1 << "tx timestamping: " << tsp;
+    }
+}
+//............................................................................
 
+template<typename ... ASPECTs>
+capacity_t
+TCP_link<ASPECTs ...>::recv_syscall (util::bool_constant<false>)
+{
+    typename super::recv_impl & ifc = super::recv_ifc ();
+
+    return impl::tcp_recv_poll (m_socket.fd (), ifc.w_position (), ifc.w_window ());
+}
+
+template<typename ... ASPECTs>
+capacity_t
+TCP_link<ASPECTs ...>::recv_syscall (util::bool_constant<true>)
+{
+    typename super::recv_impl & ifc = super::recv_ifc ();
+
+    super::reset_ancillary (ifc.w_position (), ifc.w_window ());
+
+    return impl::tcp_recvmsg_poll (m_socket.fd (), super::mhdr ());
+}
+//............................................................................
+
+template<typename ... ASPECTs>
+void
+TCP_link<ASPECTs ...>::uring_arm (util::bool_constant<false>)
+{
+    typename super::recv_impl & ifc = super::recv_ifc ();
+
+    super::uring ().arm (ifc.w_position (), ifc.w_window ());
+}
+
+template<typename ... ASPECTs>
+void
+TCP_link<ASPECTs ...>::uring_arm (util::bool_constant<true>)
+{
+    impl::uring_recv & ur = super::uring ();
+
+    if (! ur.armed ()) // don't touch the ancillary context while the kernel may be using it
+    {
+        typename super::recv_impl & ifc = super::recv_ifc ();
+
+        super::reset_ancillary (ifc.w_position (), ifc.w_window ());
+        ur.arm (super::mhdr ());
+    }
+}
+//............................................................................
+
+template<typename ... ASPECTs>
+void
+TCP_link<ASPECTs ...>::recv_timestamp (util::bool_constant<true>, timestamp_t & ts)
+{
+    timestamp_t const rx_ts = super::rx_timestamp (m_socket.rx_timestamp_policy ());
+    if (rx_ts) ts = rx_ts; // a read that returns data from several segments reports the latest one
+}
+//............................................................................
+
+template<typename ... ASPECTs>
+template<bool TS>
+capacity_t
+TCP_link<ASPECTs ...>::recv_drain (util::bool_constant<TS>, util::bool_constant<false>, timestamp_t & ts)
+{
     typename super::recv_impl & ifc = super::recv_ifc ();
 
-    int32_t const fd = m_socket.fd ();
     capacity_t r { }; // total received in this invocation
 
     while (true) // try to drain 'fd', but only up until the point we'd block
     {
         assert_positive (ifc.w_window ());
-        capacity_t const rc = impl::tcp_recv_poll (fd, ifc.w_position (), ifc.w_window ());
+        capacity_t const rc = recv_syscall (util::bool_constant<TS> { });
 
         if (rc > 0)
         {
             DLOG_trace2 << "  recv_poll rc: " << rc;
 
+            recv_timestamp (util::bool_constant<TS> { }, ts);
+
             r += rc;
             ifc.w_advance (rc);
         }
@@ -143,14 +328,7 @@ TCP_link<ASPECTs ...>::recv_poll_impl ()
             if (VR_UNLIKELY (rc < 0)) // EOF
             {
                 if (r == 0) // guard necessary because may have accumulated some bytes in earlier loop iterations
-                {
-                    if (super::has_state ())
-                    {
-                        super::state () = link_state::closed;
-                    }
-
-                    throw_x (eof_exception, "recv_poll(): EOF detected"); // TODO add link parms into the message
-                }
+                    recv_eof ();
             }
 
             // [EAGAIN or EOF]
@@ -159,9 +337,63 @@ TCP_link<ASPECTs ...>::recv_poll_impl ()
         }
     }
 
+    return r;
+}
+
+template<typename ... ASPECTs>
+template<bool TS>
+capacity_t
+TCP_link<ASPECTs ...>::recv_drain (util::bool_constant<TS>, util::bool_constant<true>, timestamp_t & ts)
+{
+    typename super::recv_impl & ifc = super::recv_ifc ();
+    impl::uring_recv & ur = super::uring ();
+
+    assert_positive (ifc.w_window ()); // 'link_base' ensures
+    uring_arm (util::bool_constant<TS> { }); // no-op unless this is the first poll or the last request has completed
+
+    capacity_t r { }; // total received in this invocation
+
+    int32_t rc;
+    while (ur.poll (rc)) // reap completions, no syscall
+    {
+        if (VR_LIKELY (rc > 0))
+        {
+            DLOG_trace2 << "  recv_poll (uring) rc: " << rc;
+
+            recv_timestamp (util::bool_constant<TS> { }, ts); // [before re-arming]
+
+            r += rc;
+            ifc.w_advance (rc);
+
+            if (! ur.armed () && (ifc.w_window () > 0)) uring_arm (util::bool_constant<TS> { }); // single-shot mode: keep reading
+        }
+        else // EOF
+        {
+            if (r == 0) recv_eof (); // otherwise, let the caller have the data and see EOF on the next poll
+            break;
+        }
+    }
+
+    if (ifc.w_window () > 0) uring_arm (util::bool_constant<TS> { }); // keep a request in flight
+
+    return r;
+}
+//............................................................................
+
+template<typename ... ASPECTs>
+std::pair<addr_const_t, capacity_t>
+TCP_link<ASPECTs ...>::recv_poll_impl ()
+{
+    vr_static_assert (super::link_mode () & mode::recv); // catch ifc usage errors early at compile-time
+
+    typename super::recv_impl & ifc = super::recv_ifc ();
+
+    timestamp_t ts { };
+    capacity_t const r = recv_drain (ts_tag { }, uring_tag { }, ts);
+
     if (super::has_ts_last_recv ()) // track the latest non-zero read
     {
-        if (r > 0) super::ts_last_recv () = sys::realtime_utc ();
+        if (r > 0) super::ts_last_recv () = (ts ? ts : sys::realtime_utc ());
     }
 
     if (r > 0) DLOG_trace1 << "recv_poll(): exit (read " << r << ')';
@@ -195,6 +427,7 @@ TCP_link<ASPECTs ...>::send_flush_impl (capacity_t const len)
             assert_le (rc, ifc.size ()); // design invariant
 
             r += rc;
+            m_send_pos += rc;
             ifc.r_advance (rc); // can't do a single step on exit because a possible throw
         }
         else
@@ -213,6 +446,26 @@ TCP_link<ASPECTs ...>::send_flush_impl (capacity_t const len)
     DLOG_trace1 << "send_flush(" << len << "): exit (wrote " << r << ')';
     return r;
 }
+//............................................................................
+
+template<typename ... ASPECTs>
+bool
+TCP_link<ASPECTs ...>::send_ts_poll (pos_t & pos, timestamp_t & ts)
+{
+    vr_static_assert (super::has_ts_last_send ());
+
+    uint32_t id;
+    if (! impl::tcp_tx_timestamp_poll (m_socket.fd (), m_socket.tx_timestamp_policy (), id, ts))
+        return false;
+
+    // 'id' is the 32-bit offset of the last byte covered by 'ts', widen it
+    // using the fact that it can't be ahead of 'm_send_pos':
+
+    pos = m_send_pos - static_cast<uint32_t> (static_cast<uint32_t> (m_send_pos) - (id + 1));
+    assert_nonnegative (pos);
+
+    return true;
+}
 
 } // end of 'io'
 } // end of namespace
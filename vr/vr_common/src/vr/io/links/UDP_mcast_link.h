@@ -207,15 +207,34 @@ class UDP_mcast_link: public socket_link<UDP_mcast_link<ASPECTs ...>, ASPECTs ..
 
         capacity_t send_flush_impl (capacity_t const len);
 
+        // socket_link:
+
+        static constexpr bool uring_multishot_ok ()     { return false; } // an incrementally consumed provided buffer would truncate datagrams that don't fit into what's left of it
+
     private: // ..............................................................
 
+        using ts_tag        = util::bool_constant<super::has_ts_last_recv ()>;
+        using uring_tag     = util::bool_constant<super::has_recv_uring ()>;
 
         // TODO like the capture version, design is limited to reading at most a single packet per invocation;
         // it would be nice to leverage something like recvmmsg() but it's hard with zero-copy buffering and
         // also if ef_vi is in the future
 
-        VR_FORCEINLINE void recv_poll_impl (util::bool_constant<false> /* do timestamping */);
-        VR_FORCEINLINE void recv_poll_impl (util::bool_constant<true>  /* do timestamping */);
+        VR_FORCEINLINE void recv_poll_impl (util::bool_constant<false> /* do timestamping */, util::bool_constant<false> /* io_uring */);
+        VR_FORCEINLINE void recv_poll_impl (util::bool_constant<true>  /* do timestamping */, util::bool_constant<false> /* io_uring */);
+
+        template<bool TS>
+        VR_FORCEINLINE void recv_poll_impl (util::bool_constant<TS>, util::bool_constant<true> /* io_uring */);
+
+        // post-process a received datagram of 'rc' bytes at the w-position:
+
+        VR_FORCEINLINE void recv_complete (capacity_t const rc, util::bool_constant<false> /* do timestamping */);
+        VR_FORCEINLINE void recv_complete (capacity_t const rc, util::bool_constant<true>  /* do timestamping */);
+
+        // make sure there is an io_uring request in flight:
+
+        VR_FORCEINLINE void uring_arm (util::bool_constant<false> /* do timestamping */);
+        VR_FORCEINLINE void uring_arm (util::bool_constant<true>  /* do timestamping */);
 
         using super::m_socket; // this is used as multicast link [group membership is maintained by 'group_socket_handle' in 'recv' mode]
 
@@ -238,7 +257,7 @@ UDP_mcast_link<ASPECTs ...>::close () VR_NOEXCEPT
 
 template<typename ... ASPECTs>
 void
-UDP_mcast_link<ASPECTs ...>::recv_poll_impl (util::bool_constant<false>)
+UDP_mcast_link<ASPECTs ...>::recv_poll_impl (util::bool_constant<false>, util::bool_constant<false>)
 {
     typename super::recv_impl & ifc = super::recv_ifc ();
     assert_positive (ifc.w_window ()); // caller ensures
@@ -253,19 +272,12 @@ UDP_mcast_link<ASPECTs ...>::recv_poll_impl (util::bool_constant<false>)
         rc = 0; // EAGAIN
     }
 
-    if (rc > 0)
-    {
-        if (! (super::has_recv_filter () && filter_impl::drop (ifc.w_position (), rc)))
-        {
-            DLOG_trace2 << "  recv_poll rc: " << rc;
-            ifc.w_advance (rc);
-        }
-    }
+    if (rc > 0) recv_complete (rc, util::bool_constant<false> { });
 }
 
 template<typename ... ASPECTs>
 void
-UDP_mcast_link<ASPECTs ...>::recv_poll_impl (util::bool_constant<true>)
+UDP_mcast_link<ASPECTs ...>::recv_poll_impl (util::bool_constant<true>, util::bool_constant<false>)
 {
     typename super::recv_impl & ifc = super::recv_ifc ();
     assert_positive (ifc.w_window ()); // caller ensures
@@ -282,26 +294,91 @@ UDP_mcast_link<ASPECTs ...>::recv_poll_impl (util::bool_constant<true>)
         rc = 0; // EAGAIN
     }
 
-    if (rc > 0)
+    if (rc > 0) recv_complete (rc, util::bool_constant<true> { });
+}
+//............................................................................
+
+template<typename ... ASPECTs>
+template<bool TS>
+void
+UDP_mcast_link<ASPECTs ...>::recv_poll_impl (util::bool_constant<TS>, util::bool_constant<true>)
+{
+    typename super::recv_impl & ifc = super::recv_ifc ();
+    assert_positive (ifc.w_window ()); // caller ensures
+
+    uring_arm (util::bool_constant<TS> { }); // no-op unless this is the first poll or the last request has completed
+
+    int32_t rc;
+    if (super::uring ().poll (rc)) // no syscall
     {
-        if (! (super::has_recv_filter () && filter_impl::drop (ifc.w_position (), rc)))
-        {
-            // in a searing example of premature optimization, this is hardcoded to assume that
-            // timestamping is on and the timestamp(s) is(are) the only ancillary data expected;
-            // i.e. there is no loop over all CMSGs -- the first one is expected to be the only
-            // one and of type SCM_TIMESTAMPING:
+        if (rc > 0) recv_complete (rc, util::bool_constant<TS> { });
+
+        if (ifc.w_window () > 0) uring_arm (util::bool_constant<TS> { }); // keep a request in flight
+    }
+}
+//............................................................................
+
+template<typename ... ASPECTs>
+void
+UDP_mcast_link<ASPECTs ...>::uring_arm (util::bool_constant<false>)
+{
+    typename super::recv_impl & ifc = super::recv_ifc ();
 
-            ::cmsghdr * const cmsg = CMSG_FIRSTHDR (super::mhdr ());
-            assert_nonnull (cmsg);
-            assert_eq (cmsg->cmsg_type, SCM_TIMESTAMPING);
+    super::uring ().arm (ifc.w_position (), ifc.w_window ());
+}
 
-            ::timespec const & ts = (reinterpret_cast<::timespec const *> (CMSG_DATA (cmsg))) [m_socket.rx_timestamp_policy ()]; // HACK enum values are chosen to skip the unused slot #1
+template<typename ... ASPECTs>
+void
+UDP_mcast_link<ASPECTs ...>::uring_arm (util::bool_constant<true>)
+{
+    impl::uring_recv & ur = super::uring ();
 
-            super::ts_last_recv () = (ts.tv_sec * _1_second () + ts.tv_nsec);
+    if (! ur.armed ()) // don't touch the ancillary context while the kernel may be using it
+    {
+        typename super::recv_impl & ifc = super::recv_ifc ();
 
-            DLOG_trace2 << "  recv_poll rc: " << rc << ", ts: " << super::ts_last_recv ();
-            ifc.w_advance (rc);
-        }
+        super::reset_ancillary (ifc.w_position (), ifc.w_window ());
+        ur.arm (super::mhdr ());
+    }
+}
+//............................................................................
+
+template<typename ... ASPECTs>
+void
+UDP_mcast_link<ASPECTs ...>::recv_complete (capacity_t const rc, util::bool_constant<false>)
+{
+    typename super::recv_impl & ifc = super::recv_ifc ();
+
+    if (! (super::has_recv_filter () && filter_impl::drop (ifc.w_position (), rc)))
+    {
+        DLOG_trace2 << "  recv_poll rc: " << rc;
+        ifc.w_advance (rc);
+    }
+}
+
+template<typename ... ASPECTs>
+void
+UDP_mcast_link<ASPECTs ...>::recv_complete (capacity_t const rc, util::bool_constant<true>)
+{
+    typename super::recv_impl & ifc = super::recv_ifc ();
+
+    if (! (super::has_recv_filter () && filter_impl::drop (ifc.w_position (), rc)))
+    {
+        // in a searing example of premature optimization, this is hardcoded to assume that
+        // timestamping is on and the timestamp(s) is(are) the only ancillary data expected;
+        // i.e. there is no loop over all CMSGs -- the first one is expected to be the only
+        // one and of type SCM_TIMESTAMPING:
+
+        ::cmsghdr * const cmsg = CMSG_FIRSTHDR (super::mhdr ());
+        assert_nonnull (cmsg);
+        assert_eq (cmsg->cmsg_type, SCM_TIMESTAMPING);
+
+        ::timespec const & ts = (reinterpret_cast<::timespec const *> (CMSG_DATA (cmsg))) [m_socket.rx_timestamp_policy ()]; // HACK enum values are chosen to skip the unused slot #1
+
+        super::ts_last_recv () = (ts.tv_sec * _1_second () + ts.tv_nsec);
+
+        DLOG_trace2 << "  recv_poll rc: " << rc << ", ts: " << super::ts_last_recv ();
+        ifc.w_advance (rc);
     }
 }
 //............................................................................
@@ -314,7 +391,7 @@ UDP_mcast_link<ASPECTs ...>::recv_poll_impl ()
 
     typename super::recv_impl & ifc = super::recv_ifc ();
 
-    recv_poll_impl (util::bool_constant<super::has_ts_last_recv ()> {}); // throws on an error other than 'EAGAIN'
+    recv_poll_impl (ts_tag { }, uring_tag { }); // throws on an error other than 'EAGAIN'
 
     return { ifc.r_position (), ifc.size () }; // notes: this returns totals (since last 'recv_flush()')
 }
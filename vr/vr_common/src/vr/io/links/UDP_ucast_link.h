@@ -81,8 +81,18 @@ class UDP_ucast_link: public socket_link<UDP_ucast_link<ASPECTs ...>, ASPECTs ..
         std::pair<addr_const_t, capacity_t> recv_poll_impl ();
         capacity_t send_flush_impl (capacity_t const len);
 
+        // socket_link:
+
+        static constexpr bool uring_multishot_ok ()     { return false; } // an incrementally consumed provided buffer would truncate datagrams that don't fit into what's left of it
+
     private: // ..............................................................
 
+        /*
+         * receive at most one datagram
+         */
+        VR_FORCEINLINE capacity_t recv_one (util::bool_constant<false> /* io_uring */);
+        VR_FORCEINLINE capacity_t recv_one (util::bool_constant<true>  /* io_uring */);
+
         using super::m_socket;
 
 }; // end of class
@@ -101,6 +111,36 @@ UDP_ucast_link<ASPECTs ...>::close () VR_NOEXCEPT
 }
 //............................................................................
 
+template<typename ... ASPECTs>
+capacity_t
+UDP_ucast_link<ASPECTs ...>::recv_one (util::bool_constant<false>)
+{
+    typename super::recv_impl & ifc = super::recv_ifc ();
+
+    return impl::ucast_recv_poll (m_socket, ifc.w_position (), ifc.w_window ()); // throws on an error other than 'EAGAIN'
+}
+
+template<typename ... ASPECTs>
+capacity_t
+UDP_ucast_link<ASPECTs ...>::recv_one (util::bool_constant<true>)
+{
+    typename super::recv_impl & ifc = super::recv_ifc ();
+    impl::uring_recv & ur = super::uring ();
+
+    ur.arm (ifc.w_position (), ifc.w_window ()); // no-op unless this is the first poll or the last request has completed
+
+    int32_t rc { };
+    if (ur.poll (rc)) // no syscall
+    {
+        // [note: unlike TCP, a zero-length datagram is not EOF]
+
+        if ((rc > 0) && (ifc.w_window () > rc)) ur.arm (addr_plus (ifc.w_position (), rc), ifc.w_window () - rc); // keep a request in flight
+    }
+
+    return rc;
+}
+//............................................................................
+
 template<typename ... ASPECTs>
 std::pair<addr_const_t, capacity_t>
 UDP_ucast_link<ASPECTs ...>::recv_poll_impl ()
@@ -109,7 +149,7 @@ UDP_ucast_link<ASPECTs ...>::recv_poll_impl ()
 
     typename super::recv_impl & ifc = super::recv_ifc ();
 
-    capacity_t const rc = impl::ucast_recv_poll (m_socket, ifc.w_position (), ifc.w_window ()); // throws on an error other than 'EAGAIN'
+    capacity_t const rc = recv_one (util::bool_constant<super::has_recv_uring ()> { });
 
     if (rc > 0)
     {
@@ -89,6 +89,7 @@ struct default_traits_base
 
     static constexpr bool is_filtered ()            { return false; }
     static constexpr bool is_timestamped ()         { return false; }
+    static constexpr bool is_uring ()               { return false; }
 
 }; // end of traits
 
@@ -165,6 +166,7 @@ struct find_mode<MODE, T_DEFAULT, T, Ts ...>
         \
         static constexpr bool is_filtered ()            { return util::contains<_filter_, ASPECTs ...>::value; } \
         static constexpr bool is_timestamped ()         { return util::contains<_timestamp_, ASPECTs ...>::value; } \
+        static constexpr bool is_uring ()               { return util::contains<_uring_, ASPECTs ...>::value; } \
         \
     }; \
     /* */
@@ -297,6 +299,7 @@ struct link_a2t
     static constexpr bool has_recv_filter ()    { return recv_impl::traits::is_filtered (); }
     static constexpr bool has_ts_last_recv ()   { return recv_impl::traits::is_timestamped (); }
     static constexpr bool has_ts_last_send ()   { return send_impl::traits::is_timestamped (); }
+    static constexpr bool has_recv_uring ()     { return recv_impl::traits::is_uring (); }
 
     using field_seq     = meta::make_schema_t
                         <
@@ -383,6 +386,7 @@ class link_impl: public link_a2t<ASPECTs ...>::fields,
         static constexpr bool has_recv_filter ()    { return traits::has_recv_filter (); }
         static constexpr bool has_ts_last_recv ()   { return traits::has_ts_last_recv (); }
         static constexpr bool has_ts_last_send ()   { return traits::has_ts_last_send (); }
+        static constexpr bool has_recv_uring ()     { return traits::has_recv_uring (); }
 
         // TODO tuple forwarding in constructors instead of 'arg_map'?
 
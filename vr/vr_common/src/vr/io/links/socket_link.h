@@ -1,6 +1,7 @@
 #pragma once
 
 #include "vr/io/links/link_base.h"
+#include "vr/io/links/uring.h"
 #include "vr/io/net/socket_handle.h"
 
 //----------------------------------------------------------------------------
@@ -70,6 +71,21 @@ struct ancillary_context</* ENABLED */true>
         m_mhdr.msg_controllen = sizeof (m_cmhdr); // in/out parm
     }
 
+    /*
+     * @return timestamp from an SCM_TIMESTAMPING control message received with the last message
+     *         or 0 if there wasn't one
+     */
+    VR_FORCEINLINE timestamp_t rx_timestamp (net::ts_policy::enum_t const tsp) const
+    {
+        ::cmsghdr const * const cmsg = CMSG_FIRSTHDR (& m_mhdr); // note: timestamps are expected to be the only ancillary data
+        if (VR_UNLIKELY ((cmsg == nullptr) || (cmsg->cmsg_type != SCM_TIMESTAMPING)))
+            return 0;
+
+        ::timespec const & ts = (reinterpret_cast<::timespec const *> (CMSG_DATA (cmsg))) [tsp]; // HACK enum values are chosen to skip the unused slot #1
+
+        return (ts.tv_sec * _1_second () + ts.tv_nsec);
+    }
+
     struct ::iovec m_iov;
     struct ::msghdr m_mhdr;
     union
@@ -85,10 +101,13 @@ struct ancillary_context</* ENABLED */true>
 //............................................................................
 //............................................................................
 /**
+ * @note 'DERIVED' must provide 'static constexpr bool uring_multishot_ok ()' (consulted only
+ *       if there is a 'recv<_uring_, ...>' aspect, see @ref impl::uring_recv)
  */
 template<typename DERIVED, typename ... ASPECTs>
 class socket_link: public impl::socket_link_base, public link_base<DERIVED, ASPECTs ...>,
-                   public impl::ancillary_context<(link_base<DERIVED, ASPECTs ...>::has_ts_last_recv ())> // EBO
+                   public impl::ancillary_context<(link_base<DERIVED, ASPECTs ...>::has_ts_last_recv ())>, // EBO
+                   public impl::uring_context<(link_base<DERIVED, ASPECTs ...>::has_recv_uring ())> // EBO
 {
     private: // ..............................................................
 
@@ -101,6 +120,7 @@ class socket_link: public impl::socket_link_base, public link_base<DERIVED, ASPE
          * currently, this is non-trivial only for _recv_
          */
         using ancillary     = impl::ancillary_context<(super::has_ts_last_recv ())>;
+        using uring_ctx     = impl::uring_context<(super::has_recv_uring ())>;
 
     public: // ...............................................................
 
@@ -108,21 +128,24 @@ class socket_link: public impl::socket_link_base, public link_base<DERIVED, ASPE
 
         socket_link (recv_arg_map const & recv_args, send_arg_map const & send_args, net::socket_handle && sh, std::string const & name) :
             socket_link_base (std::move (sh)), // socket is constructed first
-            super (select_recv_parms (recv_args, super::recv_requires_file (), m_socket, name), select_send_parms (send_args, super::send_requires_file (), m_socket, name))
+            super (select_recv_parms (recv_args, super::recv_requires_file (), m_socket, name), select_send_parms (send_args, super::send_requires_file (), m_socket, name)),
+            uring_ctx (m_socket.fd (), DERIVED::uring_multishot_ok (), recv_args)
         {
             if (super::has_state ()) super::state () = link_state::open;
         }
 
         socket_link (recv_arg_map const & recv_args, net::socket_handle && sh, std::string const & name) :
             socket_link_base (std::move (sh)), // socket is constructed first
-            super (select_recv_parms (recv_args, super::recv_requires_file (), m_socket, name))
+            super (select_recv_parms (recv_args, super::recv_requires_file (), m_socket, name)),
+            uring_ctx (m_socket.fd (), DERIVED::uring_multishot_ok (), recv_args)
         {
             if (super::has_state ()) super::state () = link_state::open;
         }
 
         socket_link (send_arg_map const & send_args, net::socket_handle && sh, std::string const & name) :
             socket_link_base (std::move (sh)), // socket is constructed first
-            super (select_send_parms (send_args, super::send_requires_file (), m_socket, name))
+            super (select_send_parms (send_args, super::send_requires_file (), m_socket, name)),
+            uring_ctx (m_socket.fd (), false, arg_map { })
         {
             if (super::has_state ()) super::state () = link_state::open;
         }
@@ -135,6 +158,7 @@ class socket_link: public impl::socket_link_base, public link_base<DERIVED, ASPE
 
         void close () VR_NOEXCEPT // idemptotent
         {
+            uring_ctx::close (); // before the socket [cancels any recv in flight]
             base::close (); // chain
         }
 
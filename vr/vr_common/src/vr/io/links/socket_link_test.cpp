@@ -5,17 +5,24 @@
 #include "vr/io/links/link_factory.h"
 #include "vr/io/links/TCP_link.h"
 #include "vr/io/links/UDP_mcast_link.h"
+#include "vr/io/links/UDP_ucast_link.h"
 #include "vr/io/net/io.h" // print() override for ::ip
 #include "vr/io/net/socket_factory.h"
 #include "vr/io/net/utility.h" // min_size_or_zero, make_group_range_filter
 #include "vr/io/pcap/pcap_reader.h"
 #include "vr/io/stream_factory.h"
 #include "vr/mc/spinflag.h"
+#include "vr/sys/defs.h" // VR_CHECKED_SYS_CALL
+#include "vr/utility.h" // VR_SCOPE_EXIT
 
 #include "vr/test/data.h"
 #include "vr/test/mc.h"
 #include "vr/test/utility.h"
 
+#include <algorithm>
+
+#include <netinet/in.h>
+
 //----------------------------------------------------------------------------
 namespace vr
 {
@@ -507,6 +514,62 @@ struct tcp_peer
 }; // end of class
 //............................................................................
 
+template<typename LINK>
+void
+run_tcp_duplex (std::string const & server_port)
+{
+    constexpr int64_t send_limit    = VR_IF_THEN_ELSE (VR_DEBUG)(2000, 4000);
+
+    int64_t const seed = test::env::random_seed<int64_t> ();
+
+    // TODO try different 'capacity' values
+    // TODO scale transmitted data volume with 'capacity'
+
+    int32_t const capacity { 256 * 1024 }; // replicates 'market::ouch_link_capacity ()'
+
+    using client_task       = tcp_peer<LINK>;
+    using server_task       = tcp_peer<LINK>;
+
+    stop_flag server_stop_flag { }; // cl-padded
+
+    test::task_container tasks { };
+
+    // client determines the duration of data (echo) exchange
+
+    tasks.add ({ client_task { "localhost", server_port, capacity, server_stop_flag, seed,
+                                 {
+                                     { "send_limit", send_limit },
+                                 } } },
+        "client");
+    tasks.add ({ server_task { server_port, capacity, server_stop_flag, seed } },
+        "server");
+
+    server_task const & s = tasks ["server"];
+    client_task const & c = tasks ["client"];
+
+    tasks.start ();
+    tasks.stop ();
+
+    LOG_info << "client sent " << c.send_count () << " packet(s) (" << c.send_size () << " byte(s)), received " << c.recv_count () << " packet(s) (" << c.recv_size () << " byte(s))";
+    LOG_info << "server sent " << s.send_count () << " packet(s) (" << s.send_size () << " byte(s)), received " << s.recv_count () << " packet(s) (" << s.recv_size () << " byte(s))";
+
+    // validate message counts:
+
+    ASSERT_EQ (c.send_count (), send_limit);
+    EXPECT_EQ (c.recv_count (), send_limit); // client drives starting and stopping the exchange
+
+    EXPECT_EQ (s.recv_count (), c.send_count ()); // server received everything client thinks it's sent
+    EXPECT_EQ (s.send_count (), s.recv_count ()); // it's an echo server, after all
+
+    // validate data contents:
+
+    ASSERT_EQ (c.recv_size (), c.send_size ());
+    ASSERT_EQ (s.recv_size (), s.send_size ());
+
+    EXPECT_EQ (s.recv_size (), c.send_size ());
+}
+//............................................................................
+
 using buffer_tags        = gt::Types
 <
     _ring_,
@@ -580,61 +643,176 @@ TYPED_TEST (socket_link_test, tcp_duplex)
 {
     using buffer_tag        = TypeParam; // test parameter
 
-    constexpr int64_t send_limit    = VR_IF_THEN_ELSE (VR_DEBUG)(2000, 4000);
+    using link              = TCP_link<recv<_timestamp_, buffer_tag>, send<_timestamp_, buffer_tag>>;
 
-    int64_t const seed = test::env::random_seed<int64_t> ();
+    run_tcp_duplex<link> ("16661");
+}
+/*
+ * same as 'tcp_duplex' but with recv side polling io_uring completions (no rx
+ * timestamps, so that a multishot recv is used if the kernel supports it)
+ */
+TYPED_TEST (socket_link_test, tcp_duplex_uring)
+{
+    using buffer_tag        = TypeParam; // test parameter
 
-    using link              = TCP_link<recv<_timestamp_, buffer_tag>, send<_timestamp_, buffer_tag>>;
+    using link              = TCP_link<recv<_uring_, buffer_tag>, send<_timestamp_, buffer_tag>>;
 
-    // TODO try different 'capacity' values
-    // TODO scale transmitted data volume with 'capacity'
+    run_tcp_duplex<link> ("16662");
+}
+/*
+ * confirm that kernel (software) rx timestamps are delivered via 'ts_last_recv()'
+ * and tx completion timestamps cover all bytes flushed by the sender
+ */
+TEST (socket_link_test, tcp_timestamps)
+{
+    using link              = TCP_link<recv<_timestamp_, _ring_>, send<_timestamp_, _ring_>>;
 
-    int32_t const capacity { 256 * 1024 }; // replicates 'market::ouch_link_capacity ()'
+    std::string const server_port { "16663" };
+    int32_t const capacity { 64 * 1024 };
+    int32_t const len { 1000 };
+    int32_t const send_count { 10 };
 
-    using client_task       = tcp_peer<link>;
-    using server_task       = tcp_peer<link>;
+    arg_map const opt_args
+    {
+        { "tsp", net::ts_policy::sw },
+        { "tx_timestamps", true }
+    };
 
-    stop_flag server_stop_flag { }; // cl-padded
+    stop_flag server_stop_flag { };
 
-    test::task_container tasks { };
+    net::socket_handle lsh { net::socket_factory::create_TCP_server (server_port) };
 
-#define vr_SERVER_PORT "16661"
+    std::unique_ptr<link> const client = tcp_link_factory<link>::create ("tcp_client", "localhost", server_port, capacity, opt_args);
+    std::unique_ptr<link> const server = tcp_link_factory<link>::create ("tcp_server", lsh.accept (server_stop_flag, _1_second ()), capacity, opt_args);
 
-    // client determines the duration of data (echo) exchange
+    timestamp_t const ts_start = sys::realtime_utc ();
 
-    tasks.add ({ client_task { "localhost", vr_SERVER_PORT, capacity, server_stop_flag, seed,
-                                 {
-                                     { "send_limit", send_limit },
-                                 } } },
-        "client");
-    tasks.add ({ server_task { vr_SERVER_PORT, capacity, server_stop_flag, seed } },
-        "server");
+    for (int32_t i = 0; i < send_count; ++ i)
+    {
+        std::memset (client->send_allocate (len), i, len);
+        client->send_flush (len);
+    }
+    ASSERT_EQ (client->send_position (), send_count * len);
 
-    server_task const & s = tasks ["server"];
-    client_task const & c = tasks ["client"];
+    // drain tx timestamps (kernel delivers them asynchronously):
 
-    tasks.start ();
-    tasks.stop ();
+    pos_t ts_pos { };
+    timestamp_t ts_sent_last { };
 
-    LOG_info << "client sent " << c.send_count () << " packet(s) (" << c.send_size () << " byte(s)), received " << c.recv_count () << " packet(s) (" << c.recv_size () << " byte(s))";
-    LOG_info << "server sent " << s.send_count () << " packet(s) (" << s.send_size () << " byte(s)), received " << s.recv_count () << " packet(s) (" << s.recv_size () << " byte(s))";
+    for (int32_t retry = 0; (ts_pos < client->send_position ()) && (retry < 1000); ++ retry)
+    {
+        pos_t pos;
+        timestamp_t ts;
 
-    // validate message counts:
+        while (client->send_ts_poll (pos, ts))
+        {
+            EXPECT_GT (pos, ts_pos);
+            EXPECT_GE (ts, ts_sent_last);
 
-    ASSERT_EQ (c.send_count (), send_limit);
-    EXPECT_EQ (c.recv_count (), send_limit); // client drives starting and stopping the exchange
+            ts_pos = pos;
+            ts_sent_last = ts;
+        }
 
-    EXPECT_EQ (s.recv_count (), c.send_count ()); // server received everything client thinks it's sent
-    EXPECT_EQ (s.send_count (), s.recv_count ()); // it's an echo server, after all
+        if (ts_pos < client->send_position ()) sys::short_sleep_for (_1_millisecond ());
+    }
 
-    // validate data contents:
+    EXPECT_EQ (ts_pos, client->send_position ());
+    EXPECT_GE (ts_sent_last, ts_start);
 
-    ASSERT_EQ (c.recv_size (), c.send_size ());
-    ASSERT_EQ (s.recv_size (), s.send_size ());
+    // receive everything on the other end:
 
-    EXPECT_EQ (s.recv_size (), c.send_size ());
+    int64_t recv_size { };
+
+    for (int32_t retry = 0; (recv_size < client->send_position ()) && (retry < 1000); ++ retry)
+    {
+        std::pair<addr_const_t, capacity_t> const rc = server->recv_poll ();
+
+        if (rc.second > 0)
+        {
+            EXPECT_GE (server->ts_last_recv (), ts_start);
 
-#undef  vr_SERVER_PORT
+            recv_size += rc.second;
+            server->recv_flush (rc.second);
+        }
+        else
+        {
+            sys::short_sleep_for (_1_millisecond ());
+        }
+    }
+
+    EXPECT_EQ (recv_size, client->send_position ());
+}
+/*
+ * a '_uring_' UDP link asked for a multishot recv must still receive back-to-back
+ * maximum-size datagrams in full (an incrementally consumed provided buffer would
+ * truncate them once the space left in it got smaller than a datagram)
+ */
+TYPED_TEST (socket_link_test, udp_uring_full_size_datagrams)
+{
+    using buffer_tag        = TypeParam; // test parameter
+
+    using link              = UDP_ucast_link<recv<_uring_, buffer_tag>, send<_timestamp_, buffer_tag>>;
+
+    std::string const peer_port { "16664" };
+    int32_t const len { 65507 }; // max IPv4 UDP payload
+    int32_t const send_count { 64 }; // several times what fits into the link's w-window at once
+
+    // a plain UDP socket bound to 'peer_port' plays the peer:
+
+    int32_t const peer_fd = VR_CHECKED_SYS_CALL (::socket (AF_INET, SOCK_DGRAM, 0));
+    VR_SCOPE_EXIT ([peer_fd]() { ::close (peer_fd); });
+    {
+        ::sockaddr_in sa;
+        std::memset (& sa, 0, sizeof (sa));
+        {
+            sa.sin_family = AF_INET;
+            sa.sin_port = htons (std::stoi (peer_port));
+            sa.sin_addr.s_addr = htonl (INADDR_LOOPBACK);
+        }
+
+        VR_CHECKED_SYS_CALL (::bind (peer_fd, reinterpret_cast<::sockaddr const *> (& sa), sizeof (sa)));
+    }
+
+    fs::path const path = create_link_capture_path ("udp_uring", { { "root", test::unique_test_path () } }); // used by '_tape_' buffers
+
+    std::unique_ptr<link> const l = std::make_unique<link> ("127.0.0.1", peer_port,
+        recv_arg_map { { "uring_multishot", true }, { "path", path } }, // note: default (minimal) capacity
+        send_arg_map { { "capacity", 64 * 1024 }, { "path", path } });
+
+    // learn the link's (ephemeral) address from a datagram it sends:
+
+    ::sockaddr_in link_sa;
+    ::socklen_t link_sa_len { sizeof (link_sa) };
+    {
+        std::memset (l->send_allocate (1), 0, 1);
+        ASSERT_EQ (l->send_flush (1), 1);
+
+        char b;
+        ASSERT_EQ (::recvfrom (peer_fd, & b, 1, 0, reinterpret_cast<::sockaddr *> (& link_sa), & link_sa_len), 1);
+    }
+
+    std::unique_ptr<int8_t []> const buf { new int8_t [len] };
+
+    for (int32_t i = 0; i < send_count; ++ i)
+    {
+        std::memset (buf.get (), i, len);
+        ASSERT_EQ (::sendto (peer_fd, buf.get (), len, 0, reinterpret_cast<::sockaddr const *> (& link_sa), link_sa_len), len) << "datagram #" << i;
+
+        std::pair<addr_const_t, capacity_t> rc { };
+
+        for (int32_t retry = 0; (rc.second == 0) && (retry < 1000); ++ retry)
+        {
+            rc = l->recv_poll ();
+            if (rc.second == 0) sys::short_sleep_for (_1_millisecond ());
+        }
+
+        ASSERT_EQ (rc.second, len) << "datagram #" << i; // received, and in full
+
+        int8_t const * const data = static_cast<int8_t const *> (rc.first);
+        ASSERT_TRUE (std::all_of (data, data + len, [i](int8_t const b) { return (b == static_cast<int8_t> (i)); })) << "datagram #" << i;
+
+        l->recv_flush (len);
+    }
 }
 
 } // end of 'io'
@@ -0,0 +1,351 @@
+
+#include "vr/io/links/uring.h"
+
+#include "vr/io/exceptions.h"
+#include "vr/sys/defs.h" // VR_CHECKED_SYS_CALL
+#include "vr/sys/os.h"
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace io
+{
+namespace impl
+{
+//............................................................................
+//............................................................................
+namespace
+{
+
+constexpr uint32_t sq_entries ()        { return 4; }   // we never have more than one request in flight
+constexpr uint32_t cq_entries ()        { return 256; } // multishot completions can accumulate between polls
+constexpr uint32_t buf_ring_entries ()  { return 2; }   // one buffer in use at a time, but the kernel wants a power of 2
+constexpr uint16_t buf_group ()         { return 0; }
+
+constexpr uint32_t max_buf_len ()       { return (1U << 30); } // '_tape_' w-windows are "infinite"
+
+/*
+ * 'io_uring_buf_reg' with the 'flags' field newer kernel headers have in place of 'pad'
+ */
+struct buf_reg
+{
+    uint64_t ring_addr;
+    uint32_t ring_entries;
+    uint16_t bgid;
+    uint16_t flags;
+    uint64_t resv [3];
+
+}; // end of class
+
+vr_static_assert (sizeof (buf_reg) == sizeof (::io_uring_buf_reg));
+//............................................................................
+
+VR_FORCEINLINE int32_t
+io_uring_setup (uint32_t const entries, ::io_uring_params * const p)
+{
+    return ::syscall (__NR_io_uring_setup, entries, p);
+}
+
+VR_FORCEINLINE int32_t
+io_uring_enter (int32_t const fd, uint32_t const to_submit, uint32_t const min_complete, uint32_t const flags)
+{
+    return ::syscall (__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0);
+}
+
+VR_FORCEINLINE int32_t
+io_uring_register (int32_t const fd, uint32_t const opcode, void const * const arg, uint32_t const nr_args)
+{
+    return ::syscall (__NR_io_uring_register, fd, opcode, arg, nr_args);
+}
+//............................................................................
+
+addr_t
+mmap_ring (int32_t const fd, std::size_t const size, off_t const offset)
+{
+    addr_t const r = ::mmap (nullptr, size, (PROT_READ | PROT_WRITE), (MAP_SHARED | MAP_POPULATE), fd, offset);
+    if (VR_UNLIKELY (r == MAP_FAILED))
+    {
+        auto const e = errno;
+        throw_x (sys_exception, "io_uring mmap() error (" + string_cast (e) + "): " + std::strerror (e));
+    }
+
+    return r;
+}
+
+} // end of anonymous
+//............................................................................
+//............................................................................
+
+uring_recv::uring_recv (int32_t const socket_fd, bool const multishot_ok, arg_map const & args) :
+    m_socket_fd { socket_fd }
+{
+    check_nonnegative (socket_fd);
+
+    m_sqpoll = args.get<bool> ("uring_sqpoll", false);
+
+    ::io_uring_params p;
+    std::memset (& p, 0, sizeof (p));
+    {
+        p.flags = IORING_SETUP_CQSIZE;
+        p.cq_entries = cq_entries ();
+
+        if (m_sqpoll)
+        {
+            p.flags |= IORING_SETUP_SQPOLL;
+            p.sq_thread_idle = std::max<timestamp_t> (1, args.get<timestamp_t> ("uring_sqpoll_idle", _1_second ()) / _1_millisecond ());
+        }
+    }
+
+    m_fd = io_uring_setup (sq_entries (), & p);
+    if (VR_UNLIKELY (m_fd < 0))
+    {
+        auto const e = errno;
+        throw_x (sys_exception, "io_uring_setup() error (" + string_cast (e) + "): " + std::strerror (e));
+    }
+
+    try
+    {
+        m_sq_ring_size = p.sq_off.array + p.sq_entries * sizeof (uint32_t);
+        m_cq_ring_size = p.cq_off.cqes + p.cq_entries * sizeof (::io_uring_cqe);
+
+        if (p.features & IORING_FEAT_SINGLE_MMAP)
+        {
+            m_sq_ring_size = m_cq_ring_size = std::max (m_sq_ring_size, m_cq_ring_size);
+
+            m_sq_ring_addr = m_cq_ring_addr = mmap_ring (m_fd, m_sq_ring_size, IORING_OFF_SQ_RING);
+        }
+        else
+        {
+            m_sq_ring_addr = mmap_ring (m_fd, m_sq_ring_size, IORING_OFF_SQ_RING);
+            m_cq_ring_addr = mmap_ring (m_fd, m_cq_ring_size, IORING_OFF_CQ_RING);
+        }
+
+        m_sqes_size = p.sq_entries * sizeof (::io_uring_sqe);
+        m_sqes = static_cast<::io_uring_sqe *> (mmap_ring (m_fd, m_sqes_size, IORING_OFF_SQES));
+
+        m_sq_tail = static_cast<uint32_t *> (addr_plus (m_sq_ring_addr, p.sq_off.tail));
+        m_sq_mask = * static_cast<uint32_t const *> (addr_plus (m_sq_ring_addr, p.sq_off.ring_mask));
+        m_sq_flags = static_cast<uint32_t const *> (addr_plus (m_sq_ring_addr, p.sq_off.flags));
+
+        // SQ slot indirection is not used, make it an identity map once:
+
+        uint32_t * const sq_array = static_cast<uint32_t *> (addr_plus (m_sq_ring_addr, p.sq_off.array));
+        for (uint32_t i = 0; i < p.sq_entries; ++ i) sq_array [i] = i;
+
+        m_cq_head = static_cast<uint32_t *> (addr_plus (m_cq_ring_addr, p.cq_off.head));
+        m_cq_tail = static_cast<uint32_t const *> (addr_plus (m_cq_ring_addr, p.cq_off.tail));
+        m_cq_mask = * static_cast<uint32_t const *> (addr_plus (m_cq_ring_addr, p.cq_off.ring_mask));
+        m_cqes = static_cast<::io_uring_cqe const *> (addr_plus (m_cq_ring_addr, p.cq_off.cqes));
+
+        m_multishot = (multishot_ok && args.get<bool> ("uring_multishot", true) && register_buffer_ring ());
+    }
+    catch (...)
+    {
+        close ();
+        throw;
+    }
+
+    LOG_trace1 << "io_uring [fd " << m_fd << "] for socket fd " << socket_fd << ": " << (m_multishot ? "multishot" : "single-shot") << " recv, "
+               << (m_sqpoll ? "SQPOLL" : "no SQPOLL") << " (features: " << hex_string_cast (p.features) << ')';
+}
+
+uring_recv::~uring_recv () VR_NOEXCEPT
+{
+    close ();
+}
+//............................................................................
+
+void
+uring_recv::close () VR_NOEXCEPT
+{
+    if (m_fd < 0) return;
+
+    // closing the ring fd cancels the request in flight, if any:
+
+    VR_CHECKED_SYS_CALL_noexcept (::close (m_fd));
+    m_fd = -1;
+
+    if (m_sqes) ::munmap (m_sqes, m_sqes_size);
+    if (m_cq_ring_addr && (m_cq_ring_addr != m_sq_ring_addr)) ::munmap (m_cq_ring_addr, m_cq_ring_size);
+    if (m_sq_ring_addr) ::munmap (m_sq_ring_addr, m_sq_ring_size);
+    if (m_buf_ring) ::munmap (m_buf_ring, sys::os_info::static_page_size ());
+
+    m_sqes = nullptr;
+    m_sq_ring_addr = m_cq_ring_addr = nullptr;
+    m_buf_ring = nullptr;
+
+    m_armed = m_buf_provided = false;
+}
+//............................................................................
+
+bool
+uring_recv::register_buffer_ring ()
+{
+    std::size_t const size = sys::os_info::static_page_size (); // plenty for 'buf_ring_entries ()'
+
+    addr_t const br = ::mmap (nullptr, size, (PROT_READ | PROT_WRITE), (MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE), -1, 0);
+    if (VR_UNLIKELY (br == MAP_FAILED))
+    {
+        auto const e = errno;
+        throw_x (sys_exception, "mmap() error (" + string_cast (e) + "): " + std::strerror (e));
+    }
+
+    buf_reg reg;
+    std::memset (& reg, 0, sizeof (reg));
+    {
+        reg.ring_addr = reinterpret_cast<uint64_t> (br);
+        reg.ring_entries = buf_ring_entries ();
+        reg.bgid = buf_group ();
+        reg.flags = IOU_PBUF_RING_INC;
+    }
+
+    if (io_uring_register (m_fd, IORING_REGISTER_PBUF_RING, & reg, 1) < 0)
+    {
+        auto const e = errno;
+        LOG_warn << "io_uring [fd " << m_fd << "]: incremental buffer ring registration failed (" << e << "): " << std::strerror (e) << ", multishot recv disabled";
+
+        ::munmap (br, size);
+        return false;
+    }
+
+    m_buf_ring = static_cast<::io_uring_buf_ring *> (br);
+    m_buf_ring_tail = 0;
+
+    return true;
+}
+
+void
+uring_recv::provide_buffer (addr_t const dst, capacity_t const len)
+{
+    assert_positive (len);
+
+    uint16_t const tail = m_buf_ring_tail;
+    // note: not 'm_buf_ring->bufs [...]', in C++ '__DECLARE_FLEX_ARRAY' pads 'bufs' past the ring header
+    // instead of overlaying them as the kernel expects:
+
+    ::io_uring_buf & b = static_cast<::io_uring_buf *> (static_cast<addr_t> (m_buf_ring)) [tail & (buf_ring_entries () - 1)];
+    {
+        b.addr = reinterpret_cast<uint64_t> (dst);
+        b.len = std::min<capacity_t> (len, max_buf_len ());
+        b.bid = (tail & (buf_ring_entries () - 1));
+    }
+
+    __atomic_store_n (& m_buf_ring->tail, (m_buf_ring_tail = tail + 1), __ATOMIC_RELEASE);
+
+    m_buf_provided = true;
+}
+//............................................................................
+
+::io_uring_sqe &
+uring_recv::next_sqe ()
+{
+    ::io_uring_sqe & sqe = m_sqes [(* m_sq_tail) & m_sq_mask]; // '* m_sq_tail' is only written by us
+    std::memset (& sqe, 0, sizeof (sqe));
+
+    return sqe;
+}
+
+void
+uring_recv::submit ()
+{
+    __atomic_store_n (m_sq_tail, (* m_sq_tail) + 1, __ATOMIC_RELEASE);
+
+    if (m_sqpoll)
+    {
+        __atomic_thread_fence (__ATOMIC_SEQ_CST); // order the tail store before the flags load (the SQPOLL thread does the converse)
+
+        if (VR_UNLIKELY (__atomic_load_n (m_sq_flags, __ATOMIC_RELAXED) & IORING_SQ_NEED_WAKEUP))
+            io_uring_enter (m_fd, 0, 0, IORING_ENTER_SQ_WAKEUP);
+    }
+    else
+    {
+        int32_t const rc = io_uring_enter (m_fd, 1, 0, 0);
+        if (VR_UNLIKELY (rc != 1))
+        {
+            auto const e = errno;
+            throw_x (io_exception, "io_uring_enter() error (rc " + string_cast (rc) + ", errno " + string_cast (e) + "): " + std::strerror (e));
+        }
+    }
+
+    m_armed = true;
+}
+//............................................................................
+
+void
+uring_recv::submit_recv (addr_t const dst, capacity_t const len)
+{
+    ::io_uring_sqe & sqe = next_sqe ();
+    {
+        sqe.opcode = IORING_OP_RECV;
+        sqe.fd = m_socket_fd;
+
+        if (m_multishot) // data goes into the provided buffer
+        {
+            sqe.flags = IOSQE_BUFFER_SELECT;
+            sqe.buf_group = buf_group ();
+            sqe.ioprio = IORING_RECV_MULTISHOT;
+        }
+        else
+        {
+            assert_positive (len);
+
+            sqe.addr = reinterpret_cast<uint64_t> (dst);
+            sqe.len = std::min<capacity_t> (len, max_buf_len ());
+        }
+    }
+    submit ();
+}
+
+void
+uring_recv::submit_recvmsg (::msghdr * const mhdr)
+{
+    ::io_uring_sqe & sqe = next_sqe ();
+    {
+        sqe.opcode = IORING_OP_RECVMSG;
+        sqe.fd = m_socket_fd;
+        sqe.addr = reinterpret_cast<uint64_t> (mhdr);
+        sqe.len = 1;
+    }
+    submit ();
+}
+//............................................................................
+
+bool
+uring_recv::flush_overflow ()
+{
+    // the kernel has completions it could not post to the CQ ring, make it do so:
+
+    io_uring_enter (m_fd, 0, 0, IORING_ENTER_GETEVENTS);
+
+    return ((* m_cq_head) != __atomic_load_n (m_cq_tail, __ATOMIC_ACQUIRE));
+}
+
+void
+uring_recv::check_error (int32_t const res)
+{
+    assert_lt (res, 0);
+
+    switch (-res)
+    {
+        case ENOBUFS:   // multishot ran out of provided buffer space (the w-window filled up)
+        case EAGAIN:
+        case EINTR:
+        case ECANCELED:
+        {
+            DLOG_trace1 << "io_uring [fd " << m_fd << "]: transient recv completion error " << (- res);
+        }
+        return;
+
+        default: throw_x (io_exception, "io_uring recv error (" + string_cast (- res) + "): " + std::strerror (- res));
+
+    } // end of switch
+}
+
+} // end of 'impl'
+} // end of 'io'
+} // end of namespace
+//----------------------------------------------------------------------------
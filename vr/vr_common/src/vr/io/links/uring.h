@@ -0,0 +1,252 @@
+#pragma once
+
+#include "vr/arg_map.h"
+#include "vr/io/defs.h"
+#include "vr/util/logging.h"
+
+#include <linux/io_uring.h>
+#include <sys/socket.h>
+
+//----------------------------------------------------------------------------
+// UAPI additions not (yet) in all kernel headers:
+
+#if !defined (IOU_PBUF_RING_INC)
+#   define IOU_PBUF_RING_INC            2           // kernel 6.12+
+#endif
+
+#if !defined (IORING_CQE_F_BUF_MORE)
+#   define IORING_CQE_F_BUF_MORE        (1U << 4)   // kernel 6.12+
+#endif
+
+namespace vr
+{
+namespace io
+{
+//............................................................................
+//............................................................................
+namespace impl
+{
+/**
+ * a minimal io_uring recv "engine" for a single socket, used by links with the
+ * '_uring_' recv aspect (talks to the kernel via raw syscalls, no liburing dependency)
+ *
+ * keeps at most one recv request in flight and points it directly at the link's
+ * recv buffer w-window, so received bytes land exactly where the syscall-based
+ * links would have put them (and the zero-copy 'recv_poll()' contract is unchanged):
+ *
+ *  - multishot mode: a single multishot recv fed from a provided buffer ring with one
+ *    incrementally-consumed buffer spanning the w-window; this needs IOU_PBUF_RING_INC
+ *    (kernel 6.12+) and the engine falls back to single-shot mode without it; this is
+ *    only suitable for stream sockets: a datagram landing in the tail of the buffer
+ *    would be truncated to whatever space is left in it;
+ *
+ *  - single-shot mode: a recv (or recvmsg, if the link needs ancillary data) that is
+ *    re-armed after each completion;
+ *
+ * checking for completions is a CQ ring peek and never makes a syscall; (re-)arming
+ * a request costs one io_uring_enter() unless the ring has an SQPOLL kernel thread
+ *
+ * recognized 'recv_arg_map' args:
+ *
+ *  - "uring_multishot" (bool, default 'true');
+ *  - "uring_sqpoll" (bool, default 'false');
+ *  - "uring_sqpoll_idle" (timestamp_t, SQPOLL thread idle time before it goes to sleep, default 1s);
+ *
+ * @note the buffer memory must stay valid and stable (true for both '_ring_' and '_tape_'
+ *       buffers) until @ref close()
+ */
+class uring_recv final: noncopyable
+{
+    public: // ...............................................................
+
+        /**
+         * @param multishot_ok 'false' if the link's recv semantics don't allow a multishot recv
+         *        into a contiguous buffer (e.g. it may drop some datagrams or needs ancillary data)
+         */
+        uring_recv (int32_t const socket_fd, bool const multishot_ok, arg_map const & args);
+        ~uring_recv () VR_NOEXCEPT; // calls 'close ()'
+
+        void close () VR_NOEXCEPT; // idempotent
+
+        // ACCESSORs:
+
+        VR_FORCEINLINE bool multishot () const
+        {
+            return m_multishot;
+        }
+
+        /**
+         * @return 'true' if a recv request is in flight
+         */
+        VR_FORCEINLINE bool armed () const
+        {
+            return m_armed;
+        }
+
+        // MUTATORs:
+
+        /**
+         * make sure a recv request targeting '[dst, dst + len)' is in flight (no-op if
+         * one already is)
+         *
+         * @param len [must be positive]
+         */
+        VR_FORCEINLINE void arm (addr_t const dst, capacity_t const len)
+        {
+            if (m_multishot)
+            {
+                if (VR_UNLIKELY (! m_buf_provided)) provide_buffer (dst, len);
+                if (VR_UNLIKELY (! m_armed)) submit_recv (nullptr, 0);
+            }
+            else if (! m_armed)
+            {
+                submit_recv (dst, len);
+            }
+        }
+
+        /**
+         * single-shot mode only: make sure a recvmsg request for 'mhdr' is in flight
+         * (no-op if one already is)
+         *
+         * @note 'mhdr' and everything it points to must stay valid until the next completion
+         */
+        VR_FORCEINLINE void arm (::msghdr * const mhdr)
+        {
+            assert_condition (! m_multishot);
+
+            if (! m_armed) submit_recvmsg (mhdr);
+        }
+
+        /**
+         * reap one completion, if any (does not make a syscall unless the kernel reported
+         * a CQ overflow)
+         *
+         * @param rc [out] a positive byte count or 0 (EOF) if 'true' is returned
+         * @return 'false' if there are no (more) completions
+         *
+         * @throws io_exception for errors other than the transient ones (ENOBUFS, EAGAIN, EINTR, ECANCELED)
+         */
+        VR_FORCEINLINE bool poll (int32_t & rc)
+        {
+            while (true)
+            {
+                uint32_t const head = (* m_cq_head); // only written by us
+
+                if (head == __atomic_load_n (m_cq_tail, __ATOMIC_ACQUIRE))
+                {
+                    if (VR_LIKELY (! (__atomic_load_n (m_sq_flags, __ATOMIC_RELAXED) & IORING_SQ_CQ_OVERFLOW)))
+                        return false;
+
+                    if (! flush_overflow ()) return false;
+                    continue;
+                }
+
+                ::io_uring_cqe const & cqe = m_cqes [head & m_cq_mask];
+
+                int32_t const res = cqe.res;
+                uint32_t const flags = cqe.flags;
+
+                __atomic_store_n (m_cq_head, head + 1, __ATOMIC_RELEASE); // release the slot
+
+                if (! (flags & IORING_CQE_F_MORE)) m_armed = false; // this request is done
+                if ((flags & IORING_CQE_F_BUFFER) && ! (flags & IORING_CQE_F_BUF_MORE)) m_buf_provided = false; // buffer used up
+
+                if (VR_LIKELY (res >= 0))
+                {
+                    rc = res;
+                    return true;
+                }
+
+                check_error (res); // throws unless 'res' is a transient error
+            }
+        }
+
+    private: // ..............................................................
+
+        void provide_buffer (addr_t const dst, capacity_t const len);
+
+        VR_NOINLINE void submit_recv (addr_t const dst, capacity_t const len);
+        VR_NOINLINE void submit_recvmsg (::msghdr * const mhdr);
+
+        ::io_uring_sqe & next_sqe ();
+        void submit ();
+
+        VR_NOINLINE bool flush_overflow ();
+        VR_NOINLINE void check_error (int32_t const res);
+
+        bool register_buffer_ring ();
+
+
+        // CQ ring [hot]:
+
+        uint32_t * m_cq_head { };
+        uint32_t const * m_cq_tail { };
+        ::io_uring_cqe const * m_cqes { };
+        uint32_t m_cq_mask { };
+        uint32_t const * m_sq_flags { };
+        bool m_armed { false };         // a recv request is in flight
+        bool m_buf_provided { false };  // multishot mode: the kernel has (some of) a provided buffer left
+        bool m_multishot { false };
+        bool m_sqpoll { false };
+
+        // SQ ring:
+
+        uint32_t * m_sq_tail { };
+        uint32_t m_sq_mask { };
+        ::io_uring_sqe * m_sqes { };
+
+        // provided buffer ring (multishot mode):
+
+        ::io_uring_buf_ring * m_buf_ring { };
+        uint16_t m_buf_ring_tail { };
+
+        int32_t const m_socket_fd;
+        int32_t m_fd { -1 }; // the ring
+        addr_t m_sq_ring_addr { };
+        addr_t m_cq_ring_addr { };      // same as 'm_sq_ring_addr' if the kernel supports IORING_FEAT_SINGLE_MMAP
+        std::size_t m_sq_ring_size { };
+        std::size_t m_cq_ring_size { };
+        std::size_t m_sqes_size { };
+
+}; // end of class
+//............................................................................
+
+template<bool ENABLED = false>
+struct uring_context
+{
+    uring_context (int32_t const, bool const, arg_map const &)
+    {
+    }
+
+    void close () VR_NOEXCEPT // no-op
+    {
+    }
+
+}; // end of master
+
+template<>
+struct uring_context</* ENABLED */true>
+{
+    uring_context (int32_t const socket_fd, bool const multishot_ok, arg_map const & args) :
+        m_uring { socket_fd, multishot_ok, args }
+    {
+    }
+
+    void close () VR_NOEXCEPT // idempotent
+    {
+        m_uring.close ();
+    }
+
+    VR_FORCEINLINE uring_recv & uring ()
+    {
+        return m_uring;
+    }
+
+    uring_recv m_uring;
+
+}; // end of specialization
+
+} // end of 'impl'
+} // end of 'io'
+} // end of namespace
+//----------------------------------------------------------------------------
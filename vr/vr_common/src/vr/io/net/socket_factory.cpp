@@ -334,6 +334,50 @@ socket_factory::create_TCP_server (std::string const & service)
 }
 //............................................................................
 
+socket_handle
+socket_factory::create_UDP_server (std::string const & service)
+{
+    ::addrinfo hints;
+    {
+        std::memset (& hints, 0, sizeof (::addrinfo));
+
+        hints.ai_flags = (AI_PASSIVE | AI_NUMERICSERV);
+        hints.ai_family = AF_UNSPEC;        // IPv4 or IPv6
+        hints.ai_socktype = SOCK_DGRAM;     // UDP
+    }
+
+    ::addrinfo * gai_result { nullptr };
+    int32_t rc;
+    if (VR_UNLIKELY ((rc = ::getaddrinfo (nullptr, service.c_str (), & hints, & gai_result)) != 0))
+        throw_x (io_exception, "getaddrinfo(<local>, " + print (service) + ") failed: " + ::gai_strerror (rc));
+
+    auto _ = make_scope_exit ([gai_result]() { if (gai_result) ::freeaddrinfo (gai_result); });
+
+    for (::addrinfo * gai_r = gai_result; gai_r != nullptr; gai_r = gai_r->ai_next) // iterate over the 'getaddrinfo ()' result list
+    {
+        int32_t const fd = ::socket (gai_r->ai_family, gai_r->ai_socktype, gai_r->ai_protocol); // TODO SOCK_CLOEXEC
+        if (fd < 0)
+            continue; // try next address
+
+        {
+            int const on { 1 };
+            VR_CHECKED_SYS_CALL (::setsockopt (fd, SOL_SOCKET, SO_REUSEADDR, & on, sizeof (on)));
+        }
+
+        if (VR_LIKELY (::bind (fd, gai_r->ai_addr, gai_r->ai_addrlen) == 0))
+        {
+            LOG_trace1 << "opened UDP server socket fd " << fd << " for <" << print (service) << "> (" << sa_descriptor { gai_r->ai_family, gai_r->ai_addr, gai_r->ai_addrlen } << ')';
+            return { fd, gai_r->ai_family, false };
+        }
+
+        ::close (fd); // close 'fd' and try next address
+    }
+
+    auto const e = errno; // set from the last 'socket ()' or 'bind()'
+    throw_x (io_exception, "could not bind UDP server socket for <" + print (service) + "> to any address: " + std::strerror (e));
+}
+//............................................................................
+
 void
 socket_factory::set_TCP_fd_opts (int32_t const fd, bool const disable_nagle, bool const make_non_blocking)
 {
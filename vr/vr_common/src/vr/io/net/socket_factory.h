@@ -61,6 +61,14 @@ class socket_factory final: noncopyable
          */
         static socket_handle create_TCP_server (std::string const & service);
 
+        /**
+         * @note this is currently for testing and sim/mock tools
+         *
+         * @return UDP socket handle bound to 'service' on all local addresses (use
+         *         'MSG_DONTWAIT' and 'recvfrom()'/'sendto()' with it)
+         */
+        static socket_handle create_UDP_server (std::string const & service);
+
     private: // ..............................................................
 
         friend class socket_handle;
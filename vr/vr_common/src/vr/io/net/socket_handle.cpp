@@ -63,7 +63,9 @@ socket_handle::socket_handle (socket_handle && rhs) :
     m_fd { rhs.m_fd },
     m_family { rhs.m_family },
     m_opts_set { rhs.m_opts_set },
+    m_ts_flags { rhs.m_ts_flags },
     m_ts_policy { rhs.m_ts_policy },
+    m_tx_ts_policy { rhs.m_tx_ts_policy },
     m_peer_set { rhs.m_peer_set }
 {
     rhs.m_fd = -1; // grab fd ownership
@@ -323,61 +325,112 @@ ts_policy::enum_t
 socket_handle::enable_rx_timestamps (std::string const & ifc, ts_policy::enum_t const policy)
 {
     if (m_opts_set & (1L << SO_TIMESTAMPING)) return m_ts_policy;
-    LOG_trace1 << "  enabling SO_TIMESTAMPING for socket fd " << m_fd;
+    LOG_trace1 << "  enabling SO_TIMESTAMPING (rx) for socket fd " << m_fd;
 
-    bool hw_tx_on { false };
+    bool const hw_on = ((policy != ts_policy::sw) && enable_hw_timestamps (ifc));
 
-    if (policy != ts_policy::sw)
+    ts_policy::enum_t r;
+
+    int32_t flags { };
     {
-        try
+        if (hw_on) // implies ('hw_fallback_to_sw' or 'hw')
         {
-            ::hwtstamp_config req_cfg;
-            {
-                std::memset (& req_cfg, 0, sizeof (req_cfg));
-                req_cfg.tx_type = HWTSTAMP_TX_ON;
-                req_cfg.rx_filter = HWTSTAMP_FILTER_ALL; // TODO query for possible options here
-            }
-            ::ifreq req;
-            {
-                std::memset (& req, 0, sizeof (req));
-                std::strncpy (req.ifr_name, ifc.c_str (), sizeof (req.ifr_name));
-                req.ifr_data = char_ptr_cast (& req_cfg);
-            }
-
-            VR_CHECKED_SYS_CALL (::ioctl (m_fd, SIOCSHWTSTAMP, & req)); // note: update 'req' to reflect what's been granted
-            LOG_trace1 << "hw timestamping obtained: tx_type " << req_cfg.tx_type << ", rx_filter " << req_cfg.rx_filter;
-
-            hw_tx_on = (req_cfg.tx_type == HWTSTAMP_TX_ON);
+            flags = (SOF_TIMESTAMPING_RX_HARDWARE | /* report via control msg */SOF_TIMESTAMPING_RAW_HARDWARE);
+            r = ts_policy::hw;
         }
-        catch (sys_exception const & se)
+        else
         {
-            LOG_warn << "hw timestamping refused: " << se.what ();
+            if (policy == ts_policy::hw)
+                throw_x (sys_exception, "hardware-only rx timestamps requested, but hardware timestamping is not available");
+
+            flags = (SOF_TIMESTAMPING_RX_SOFTWARE | /* report via control msg */SOF_TIMESTAMPING_SOFTWARE);
+            r = ts_policy::sw;
         }
     }
 
+    set_timestamping_flags (flags);
+    m_opts_set |= (1L << SO_TIMESTAMPING);
+
+    return (m_ts_policy = r);
+}
+
+ts_policy::enum_t
+socket_handle::enable_tx_timestamps (std::string const & ifc, ts_policy::enum_t const policy)
+{
+    if (m_ts_flags & (SOF_TIMESTAMPING_TX_HARDWARE | SOF_TIMESTAMPING_TX_SOFTWARE)) return m_tx_ts_policy;
+    LOG_trace1 << "  enabling SO_TIMESTAMPING (tx) for socket fd " << m_fd;
+
+    bool const hw_on = ((policy != ts_policy::sw) && enable_hw_timestamps (ifc));
+
     ts_policy::enum_t r;
 
-    int flags { };
+    int32_t flags { SOF_TIMESTAMPING_OPT_ID | /* no payload copies in the error queue */SOF_TIMESTAMPING_OPT_TSONLY };
     {
-        if (hw_tx_on) // implies ('hw_fallback_to_sw' or 'hw')
+        if (hw_on)
         {
-            flags = (SOF_TIMESTAMPING_RX_HARDWARE | /* report via control msg */SOF_TIMESTAMPING_RAW_HARDWARE);
+            flags |= (SOF_TIMESTAMPING_TX_HARDWARE | /* report via control msg */SOF_TIMESTAMPING_RAW_HARDWARE);
             r = ts_policy::hw;
         }
         else
         {
             if (policy == ts_policy::hw)
-                throw_x (sys_exception, "hardware-only rx timestamps requested, but hardware timestamping is not available");
+                throw_x (sys_exception, "hardware-only tx timestamps requested, but hardware timestamping is not available");
 
-            flags = (SOF_TIMESTAMPING_RX_SOFTWARE | /* report via control msg */SOF_TIMESTAMPING_SOFTWARE);
+            flags |= (SOF_TIMESTAMPING_TX_SOFTWARE | /* report via control msg */SOF_TIMESTAMPING_SOFTWARE);
             r = ts_policy::sw;
         }
     }
 
-    VR_CHECKED_SYS_CALL (::setsockopt (m_fd, SOL_SOCKET, SO_TIMESTAMPING, & flags, sizeof (flags)));
-    m_opts_set |= (1L << SO_TIMESTAMPING);
+    set_timestamping_flags (flags);
 
-    return (m_ts_policy = r);
+    return (m_tx_ts_policy = r);
+}
+//............................................................................
+
+bool
+socket_handle::enable_hw_timestamps (std::string const & ifc)
+{
+    if (ifc.empty ()) // can only hope that the NIC has been configured elsewhere
+    {
+        LOG_trace1 << "  no ifc for socket fd " << m_fd << ", not attempting to configure hw timestamping";
+        return false;
+    }
+
+    try
+    {
+        ::hwtstamp_config req_cfg;
+        {
+            std::memset (& req_cfg, 0, sizeof (req_cfg));
+            req_cfg.tx_type = HWTSTAMP_TX_ON;
+            req_cfg.rx_filter = HWTSTAMP_FILTER_ALL; // TODO query for possible options here
+        }
+        ::ifreq req;
+        {
+            std::memset (& req, 0, sizeof (req));
+            std::strncpy (req.ifr_name, ifc.c_str (), sizeof (req.ifr_name));
+            req.ifr_data = char_ptr_cast (& req_cfg);
+        }
+
+        VR_CHECKED_SYS_CALL (::ioctl (m_fd, SIOCSHWTSTAMP, & req)); // note: update 'req' to reflect what's been granted
+        LOG_trace1 << "hw timestamping obtained: tx_type " << req_cfg.tx_type << ", rx_filter " << req_cfg.rx_filter;
+
+        return (req_cfg.tx_type == HWTSTAMP_TX_ON);
+    }
+    catch (sys_exception const & se)
+    {
+        LOG_warn << "hw timestamping refused: " << se.what ();
+    }
+
+    return false;
+}
+
+void
+socket_handle::set_timestamping_flags (int32_t const flags)
+{
+    int32_t const all_flags = (m_ts_flags | flags); // SO_TIMESTAMPING replaces the entire set
+
+    VR_CHECKED_SYS_CALL (::setsockopt (m_fd, SOL_SOCKET, SO_TIMESTAMPING, & all_flags, sizeof (all_flags)));
+    m_ts_flags = all_flags;
 }
 
 } // end of 'net'
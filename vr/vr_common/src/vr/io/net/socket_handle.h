@@ -50,6 +50,11 @@ class socket_handle final: noncopyable // move-constructible
             return m_ts_policy;
         }
 
+        ts_policy::enum_t const & tx_timestamp_policy () const
+        {
+            return m_tx_ts_policy;
+        }
+
         /*
          * 'true' means the socket has been connect()ed (for UDP this does *not* mean there's an actual connection)
          *  or comes from a TCP accept()
@@ -100,19 +105,37 @@ class socket_handle final: noncopyable // move-constructible
 
         // timestamping:
 
+        /**
+         * @param ifc [empty means don't attempt to configure 'ifc' for hw timestamping (e.g. for a TCP
+         *        socket; hw timestamps may still be granted if the NIC has been configured elsewhere)]
+         */
         ts_policy::enum_t enable_rx_timestamps (int32_t const ifc_index, ts_policy::enum_t const policy = ts_policy::hw_fallback_to_sw);
         ts_policy::enum_t enable_rx_timestamps (std::string const & ifc, ts_policy::enum_t const policy = ts_policy::hw_fallback_to_sw);
 
+        /**
+         * request tx completion timestamps (SOF_TIMESTAMPING_OPT_ID | SOF_TIMESTAMPING_OPT_TSONLY), to be
+         * read from the socket error queue; for a TCP socket, the timestamp ID is the (32-bit, wrapping)
+         * offset of the last byte of the corresponding send() in the stream of bytes sent after this call
+         *
+         * @param ifc [see @ref enable_rx_timestamps()]
+         */
+        ts_policy::enum_t enable_tx_timestamps (std::string const & ifc, ts_policy::enum_t const policy = ts_policy::hw_fallback_to_sw);
+
     private: // ..............................................................
 
         friend class socket_factory;
 
         socket_handle (int32_t const fd, int32_t const family, bool const peer_set);
 
+        bool enable_hw_timestamps (std::string const & ifc); // 'false' if hw timestamping is not available
+        void set_timestamping_flags (int32_t const flags); // adds to 'm_ts_flags'
+
         int32_t m_fd { -1 };
         int32_t m_family { };
         bitset64_t m_opts_set { };
+        int32_t m_ts_flags { }; // SO_TIMESTAMPING flags set so far
         ts_policy::enum_t m_ts_policy { ts_policy::hw_fallback_to_sw };
+        ts_policy::enum_t m_tx_ts_policy { ts_policy::hw_fallback_to_sw };
         bool const m_peer_set { false };
 
 }; // end of class
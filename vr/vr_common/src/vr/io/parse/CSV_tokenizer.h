@@ -10,6 +10,14 @@ namespace io
 namespace parse
 {
 
+/**
+ * vectorized tokenizer: locates delimiters a 64-byte block at a time (AVX2 if enabled
+ * at the compiler level, SSE otherwise) and matches tokens within delimited fields
+ *
+ * @note produces exactly the same tokens (or failures) as 'CSV_tokenize_FSM()'
+ *
+ * @return token count
+ */
 extern int32_t
 CSV_tokenize (string_literal_t const start, std::size_t const size, std::vector<CSV_token> & dst);
 
@@ -18,6 +26,18 @@ CSV_tokenize (std::string const & s, std::vector<CSV_token> & dst)
 {
     return CSV_tokenize (s.data (), s.size (), dst);
 }
+//............................................................................
+/**
+ * reference (ragel FSM) tokenizer, one byte at a time
+ */
+extern int32_t
+CSV_tokenize_FSM (string_literal_t const start, std::size_t const size, std::vector<CSV_token> & dst);
+
+inline int32_t
+CSV_tokenize_FSM (std::string const & s, std::vector<CSV_token> & dst)
+{
+    return CSV_tokenize_FSM (s.data (), s.size (), dst);
+}
 
 } // end of 'parse'
 } // end of 'io'
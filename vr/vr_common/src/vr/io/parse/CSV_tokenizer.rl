@@ -46,7 +46,7 @@ namespace
 //............................................................................
 
 VR_ASSUME_HOT int32_t
-CSV_tokenize (string_literal_t const start, std::size_t const size, std::vector<CSV_token> & tokens)
+CSV_tokenize_FSM (string_literal_t const start, std::size_t const size, std::vector<CSV_token> & tokens)
 {
     assert_empty (tokens);
     {
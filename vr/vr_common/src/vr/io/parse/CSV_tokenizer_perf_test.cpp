@@ -0,0 +1,107 @@
+
+#include "vr/macros.h" // VR_RELEASE
+#if VR_RELEASE // perf testcases in release builds only
+
+#include "vr/io/parse/CSV_tokenizer.h"
+#include "vr/sys/os.h"
+#include "vr/util/logging.h"
+
+#include "vr/test/utility.h"
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace io
+{
+namespace parse
+{
+//............................................................................
+//............................................................................
+namespace
+{
+
+using tokenizer         = int32_t (*) (string_literal_t const, std::size_t const, std::vector<CSV_token> &);
+
+/*
+ * @return best-of-'passes' throughput, in GB/s
+ */
+double
+measure_throughput (tokenizer const f, string_vector const & lines, int32_t const passes, int64_t & dummy)
+{
+    std::vector<CSV_token> tokens;
+    tokens.reserve (1024);
+
+    int64_t bytes { };
+    for (std::string const & line : lines) bytes += line.size ();
+
+    timestamp_t best { std::numeric_limits<timestamp_t>::max () };
+
+    for (int32_t pass = 0; pass < passes; ++ pass)
+    {
+        timestamp_t const start = sys::realtime_utc ();
+        {
+            for (std::string const & line : lines)
+            {
+                tokens.clear ();
+                dummy += f (line.data (), line.size (), tokens);
+            }
+        }
+        timestamp_t const stop = sys::realtime_utc ();
+
+        best = std::min (best, stop - start);
+    }
+
+    return (static_cast<double> (bytes) / best); // bytes/ns == GB/s
+}
+
+} // end of anonymous
+//............................................................................
+//............................................................................
+
+TEST (perf_CSV_tokenizer, throughput)
+{
+    // a mix of typical 'CSV_frame_ostream' output and ref/locate data-like lines:
+
+    string_vector const row_templates
+    {
+        "NA,110782,2033-Dec-01 23:59:59,+147933,-15768,\"X\",'ABC',+0.22451,\"A\",2030-Oct-17 08:07:06.118048237,-0.22451E-10",
+        "2018-Jun-12 10:00:00.000001234,\"BHP\",1234567,2950,2951,100,2500,-0.0125,0.0131,NA,NA,17",
+        "\"CBA\",\"AU000000CBA7\",\"equity\",5,\"AUD\",1,0,100000,2000,NA"
+    };
+
+    int32_t const line_count    = 100000;
+    int32_t const passes        = 10;
+
+    for (int32_t width : { 1, 4, 16 }) // repeat each template 'width' times per line
+    {
+        string_vector lines;
+        {
+            for (int32_t l = 0; l < line_count; ++ l)
+            {
+                std::string const & t = row_templates [l % row_templates.size ()];
+
+                std::string line { t };
+                for (int32_t w = 1; w < width; ++ w) (line += ',') += t;
+
+                lines.push_back (std::move (line)); // last use of 'line'
+            }
+        }
+
+        int64_t dummy { };
+
+        double const gbps_FSM   = measure_throughput (CSV_tokenize_FSM, lines, passes, dummy);
+        double const gbps       = measure_throughput (CSV_tokenize, lines, passes, dummy);
+
+        LOG_info << "[width " << width << ", ~" << lines [0].size () << " byte line(s)] FSM: " << std::setprecision (3) << gbps_FSM
+                 << " GB/s, vectorized: " << gbps << " GB/s (x" << (gbps / gbps_FSM) << "), dummy " << dummy;
+
+        EXPECT_GT (gbps, 0.0);
+    }
+}
+
+} // end of 'parse'
+} // end of 'io'
+} // end of namespace
+//----------------------------------------------------------------------------
+
+#endif // VR_RELEASE
@@ -0,0 +1,379 @@
+
+#include "vr/io/parse/CSV_tokenizer.h"
+
+#include "vr/asserts.h"
+#include "vr/containers/util/small_vector.h"
+#include "vr/util/intrinsics.h"
+
+#include <cstring>
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace io
+{
+namespace parse
+{
+//............................................................................
+//............................................................................
+namespace
+{
+/*
+ * structural pass: delimiters are located a 64-byte block at a time (as bitmasks),
+ * tokens are then matched within each delimited field
+ *
+ * note that the CSV grammar (see "grammars.rl") does not allow delimiters, quotes or
+ * newlines inside any token: a quoted name is 'nc+' between matching quotes and
+ * newlines are not part of any token; hence there is no need for a simdcsv-style
+ * "inside quotes" mask: a delimiter can never be escaped by quoting and any stray
+ * quote/newline byte fails token matching just as it does in the FSM version
+ */
+constexpr int32_t block_size            = 64;
+
+struct block_masks final
+{
+    uint64_t m_delimiters;
+    uint64_t m_digits;
+
+}; // end of class
+
+using block_mask_vector                 = util::small_vector<block_masks, 32>; // no heap allocation for lines of up to 2K
+
+VR_FORCEINLINE block_masks
+classify_block (string_literal_t const block)
+{
+#if defined (__AVX2__)
+
+    __m256i const d = _mm256_set1_epi8 (',');
+    __m256i const zero = _mm256_set1_epi8 ('0');
+    __m256i const nine = _mm256_set1_epi8 (9);
+
+    __m256i const v0 = _mm256_loadu_si256 (reinterpret_cast<__m256i const *> (block));
+    __m256i const v1 = _mm256_loadu_si256 (reinterpret_cast<__m256i const *> (block + 32));
+
+    // [x - '0' <= 9 unsigned] <=> [min (x - '0', 9) == x - '0']
+
+    __m256i const x0 = _mm256_sub_epi8 (v0, zero);
+    __m256i const x1 = _mm256_sub_epi8 (v1, zero);
+
+    uint64_t const d0 = static_cast<uint32_t> (_mm256_movemask_epi8 (_mm256_cmpeq_epi8 (v0, d)));
+    uint64_t const d1 = static_cast<uint32_t> (_mm256_movemask_epi8 (_mm256_cmpeq_epi8 (v1, d)));
+
+    uint64_t const n0 = static_cast<uint32_t> (_mm256_movemask_epi8 (_mm256_cmpeq_epi8 (_mm256_min_epu8 (x0, nine), x0)));
+    uint64_t const n1 = static_cast<uint32_t> (_mm256_movemask_epi8 (_mm256_cmpeq_epi8 (_mm256_min_epu8 (x1, nine), x1)));
+
+    return { (d0 | (d1 << 32)), (n0 | (n1 << 32)) };
+
+#else // SSE4.2 is the baseline (see "vr/util/intrinsics.h")
+
+    __m128i const d = _mm_set1_epi8 (',');
+    __m128i const zero = _mm_set1_epi8 ('0');
+    __m128i const nine = _mm_set1_epi8 (9);
+
+    block_masks r { };
+
+    for (int32_t i = 0; i < block_size; i += 16)
+    {
+        __m128i const v = _mm_loadu_si128 (reinterpret_cast<__m128i const *> (block + i));
+        __m128i const x = _mm_sub_epi8 (v, zero);
+
+        r.m_delimiters |= (static_cast<uint64_t> (static_cast<uint16_t> (_mm_movemask_epi8 (_mm_cmpeq_epi8 (v, d)))) << i);
+        r.m_digits |= (static_cast<uint64_t> (static_cast<uint16_t> (_mm_movemask_epi8 (_mm_cmpeq_epi8 (_mm_min_epu8 (x, nine), x)))) << i);
+    }
+
+    return r;
+
+#endif // __AVX2__
+}
+//............................................................................
+/*
+ * @return length of the run of digits starting at 'start + pos' (can cross block boundaries;
+ *         runs never cross delimiters and are stopped by the zero padding of the last block)
+ *
+ * @note 'pos' may equal the input size: 'masks' always has a (partial or all-zero) block
+ *       past the last input byte
+ */
+VR_FORCEINLINE int32_t
+digit_run (block_mask_vector const & masks, std::size_t const pos)
+{
+    std::size_t b = (pos / block_size);
+    int32_t const shift = (pos % block_size);
+
+    uint64_t m = ~(masks [b].m_digits >> shift) & (~0UL >> shift); // set bits are non-digits (clear past block end)
+    if (VR_LIKELY (m)) return __builtin_ctzll (m);
+
+    int32_t r = block_size - shift;
+    for (std::size_t const b_limit = masks.size (); ++ b < b_limit; r += block_size)
+    {
+        m = ~masks [b].m_digits;
+        if (m) return (r + __builtin_ctzll (m));
+    }
+
+    return r;
+}
+//............................................................................
+// character classes, as in "grammars.rl":
+
+VR_FORCEINLINE bool
+is_digit (char const c)
+{
+    return (static_cast<uint8_t> (c - '0') < 10);
+}
+
+VR_FORCEINLINE bool
+is_digit_le (char const c, char const max) // [0-'max']
+{
+    return (static_cast<uint8_t> (c - '0') <= static_cast<uint8_t> (max - '0'));
+}
+
+VR_FORCEINLINE bool
+is_sign (char const c)
+{
+    return ((c == '+') | (c == '-'));
+}
+
+VR_FORCEINLINE bool
+is_nc (char const c) // [.0-9a-zA-Z_]
+{
+    return (is_digit (c) | (static_cast<uint8_t> ((c | 0x20) - 'a') < 26) | (c == '_') | (c == '.'));
+}
+//............................................................................
+/*
+ * each matcher below returns the length of the longest match of its token pattern
+ * starting at 'p' and not extending past 'e' (or zero if there is no match):
+ */
+
+// num_int = [+\-]? digit+
+// num_fp  = [+\-]? digit* '.'? digit+ ([eE] [+\-]? digit+)?
+//
+// (both are matched in a single pass: 'num_fp' is only chosen if it is strictly longer)
+
+VR_FORCEINLINE int32_t
+match_number (string_literal_t const start, block_mask_vector const & masks, string_literal_t const p, string_literal_t const e, CSV_token::enum_t & t)
+{
+    string_literal_t i = p + is_sign (* p);
+
+    string_literal_t const d = i;
+    i += digit_run (masks, i - start);
+
+    bool fp { false };
+
+    // mantissa:
+
+    if ((i + 1 < e) && (* i == '.') && is_digit (i [1]))
+    {
+        i += 2;
+        i += digit_run (masks, i - start);
+
+        fp = true;
+    }
+    else if (i == d) // need at least one digit
+        return 0;
+
+    // optional exponent:
+
+    if ((i < e) && ((* i | 0x20) == 'e'))
+    {
+        string_literal_t x = i + 1;
+
+        if ((x < e) && is_sign (* x)) ++ x;
+
+        if ((x < e) && is_digit (* x))
+        {
+            ++ x;
+            i = x + digit_run (masks, x - start);
+
+            fp = true;
+        }
+    }
+
+    t = (fp ? CSV_token::num_fp : CSV_token::num_int);
+    return (i - p);
+}
+
+// datetime = year'-'month'-'day ' ' hh':'mm':'ss ( '.' digit{1,9} )?
+
+int32_t const datetime_min_size     = 20; // "YYYY-Mon-DD hh:mm:ss"
+
+VR_FORCEINLINE bool
+match_month (string_literal_t const p)
+{
+    static char const months [] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+
+    for (int32_t m = 0; m < 36; m += 3)
+    {
+        if ((p [0] == months [m]) & (p [1] == months [m + 1]) & (p [2] == months [m + 2]))
+            return true;
+    }
+
+    return false;
+}
+
+VR_FORCEINLINE int32_t
+match_datetime (string_literal_t const p, string_literal_t const e)
+{
+    if (((e - p) < datetime_min_size) || (p [4] != '-')) // cheap early exit for plain numbers
+        return 0;
+
+    bool const ok = ((p [0] == '1') | (p [0] == '2')) & is_digit (p [1]) & is_digit (p [2]) & is_digit (p [3]) & (p [4] == '-')
+                    & (p [8] == '-') & is_digit_le (p [9], '3') & is_digit (p [10]) & (p [11] == ' ')
+                    & is_digit_le (p [12], '2') & is_digit (p [13]) & (p [14] == ':')
+                    & is_digit_le (p [15], '5') & is_digit (p [16]) & (p [17] == ':')
+                    & is_digit_le (p [18], '5') & is_digit (p [19]);
+
+    if (! (ok && match_month (p + 5)))
+        return 0;
+
+    string_literal_t i = p + datetime_min_size;
+
+    if ((i + 1 < e) && (* i == '.') && is_digit (i [1]))
+    {
+        string_literal_t const f_limit = std::min (e, i + 1 + 9);
+
+        for (++ i; (i < f_limit) && is_digit (* i); ++ i) { }
+    }
+
+    return (i - p);
+}
+
+// qname = ( '\'' nc+ '\'' ) | ( '"' nc+ '"' )
+
+VR_FORCEINLINE int32_t
+match_qname (string_literal_t const p, string_literal_t const e)
+{
+    char const q = * p;
+
+    string_literal_t i = p + 1;
+    while ((i < e) && is_nc (* i)) ++ i;
+
+    return (((i < e) && (* i == q) && (i > p + 1)) ? (i + 1 - p) : 0);
+}
+//............................................................................
+/*
+ * equivalent of the FSM scanner's longest-match rule: if both 'num_fp' and 'num_int'
+ * match the same input, the weaker 'num_int' wins
+ */
+VR_FORCEINLINE int32_t
+match_token (string_literal_t const start, block_mask_vector const & masks, string_literal_t const p, string_literal_t const e, CSV_token::enum_t & t)
+{
+    switch (* p)
+    {
+        case '\'':
+        case '"':
+        {
+            t = CSV_token::quoted_name;
+            return match_qname (p, e);
+        }
+
+        case 'N':
+        {
+            t = CSV_token::NA_token;
+            return (((e - p) >= 2) && (p [1] == 'A') ? 2 : 0);
+        }
+
+        case '1':
+        case '2':
+        {
+            int32_t const dt_len = match_datetime (p, e);
+            if (dt_len)
+            {
+                t = CSV_token::datetime;
+                return dt_len;
+            }
+        }
+        /* no break */
+
+        case '0': case '3': case '4': case '5': case '6': case '7': case '8': case '9':
+        case '+': case '-': case '.':
+        {
+            return match_number (start, masks, p, e, t);
+        }
+
+        default: return 0;
+
+    } // end of switch
+}
+
+VR_ASSUME_COLD VR_NOINLINE void
+throw_tokenize_failure (string_literal_t const p, string_literal_t const end)
+{
+    throw_x (parse_failure, ("failed to tokenize '" + std::string { p, end }) + '\''); // TODO better capture, trim/prettify
+}
+
+VR_FORCEINLINE void
+tokenize_field (string_literal_t const start, block_mask_vector const & masks, string_literal_t p, string_literal_t const e, string_literal_t const end,
+                std::vector<CSV_token> & tokens)
+{
+    // a field normally contains exactly one token, but the FSM scanner allows adjacent ones:
+
+    while (p < e)
+    {
+        CSV_token::enum_t t;
+
+        int32_t const len = match_token (start, masks, p, e, t);
+        if (VR_UNLIKELY (len <= 0))
+            throw_tokenize_failure (p, end);
+
+        tokens.emplace_back (p, len, t);
+        p += len;
+    }
+}
+
+} // end of anonymous
+//............................................................................
+//............................................................................
+
+VR_ASSUME_HOT int32_t
+CSV_tokenize (string_literal_t const start, std::size_t const size, std::vector<CSV_token> & tokens)
+{
+    assert_empty (tokens);
+
+    string_literal_t const end = start + size;
+
+    // stage 1: classify all input bytes, a block at a time:
+
+    // note: one more block than 'b_full' even if 'size' is a multiple of 'block_size', so that
+    // there is always a zero-padded block to terminate digit runs that end at the input end
+
+    std::size_t const b_full = (size / block_size);
+
+    block_mask_vector masks (b_full + 1);
+    {
+        for (std::size_t b = 0; b < b_full; ++ b)
+        {
+            masks [b] = classify_block (start + b * block_size);
+        }
+
+        // partial (or empty) last block: work off a zero-padded copy so that the loads stay in bounds
+        {
+            alignas (block_size) char tail [block_size] { };
+            std::memcpy (tail, start + b_full * block_size, size - b_full * block_size);
+
+            masks [b_full] = classify_block (tail);
+        }
+    }
+
+    // stage 2: match tokens within delimited fields:
+
+    string_literal_t f = start; // current field start
+
+    for (std::size_t b = 0, b_limit = masks.size (); b < b_limit; ++ b)
+    {
+        for (uint64_t m = masks [b].m_delimiters; m; m &= (m - 1))
+        {
+            string_literal_t const d = start + b * block_size + __builtin_ctzll (m);
+
+            tokenize_field (start, masks, f, d, end, tokens);
+            f = d + 1;
+        }
+    }
+
+    tokenize_field (start, masks, f, end, end, tokens);
+
+    return tokens.size ();
+}
+
+} // end of 'parse'
+} // end of 'io'
+} // end of namespace
+//----------------------------------------------------------------------------
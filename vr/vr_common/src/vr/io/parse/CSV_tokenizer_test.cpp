@@ -30,6 +30,114 @@ TEST (CSV_tokenizer, sniff)
     }
 }
 
+
+TEST (CSV_tokenizer, sniff_FSM)
+{
+    std::string const line { "NA,110782,2033-Dec-01 23:59:59,+147933,-15768,\"X\",'ABC',+0.22451,\"A\",2030-Oct-17 08:07:06.118048237,-0.22451E-10" };
+
+    std::vector<CSV_token> tokens;
+    int32_t const token_count = CSV_tokenize_FSM (line, tokens);
+
+    ASSERT_EQ (token_count, 11);
+}
+/*
+ * 'CSV_tokenize()' must produce the same tokens or failures as 'CSV_tokenize_FSM()'
+ * (including for input that is not "well-formed" CSV, e.g. adjacent tokens, empty fields)
+ *
+ * note: the FSM leaves the token type unset when it backtracks out of a partially matched
+ * datetime into an int (e.g. "1107-2"), so such inputs are not generated here
+ */
+TEST (CSV_tokenizer, equivalence)
+{
+    string_vector const atoms
+    {
+        "NA", "N", "110782", "+147933", "-15768", "0", "00.00", ".5", "5.", "1e5", "1.e5", "1E+5", "-.5e-3", "+0.22451", "-0.22451E-10", "1.5.5", "+", "e",
+        "2033-Dec-01 23:59:59", "2030-Oct-17 08:07:06.118048237", "2033-Dec-01 23:59:59.1234567891", "2033-Dec-01 23:59:59.", "2033-Xyz-01 23:59:59",
+        "\"X\"", "'ABC'", "\"a.b_C\"", "'A''B'", "''", "'a\"", "'", "x", " ", "\n", "NAN", "12'ab'", ","
+    };
+
+    int64_t rnd = test::env::random_seed<int64_t> ();
+
+    for (int32_t i = 0; i < 100000; ++ i)
+    {
+        std::string line { };
+        {
+            int32_t const atom_count = unsigned_cast (test::next_random (rnd)) % 40; // long enough to cross several 64-byte blocks
+
+            for (int32_t a = 0; a < atom_count; ++ a)
+            {
+                line += atoms [unsigned_cast (test::next_random (rnd)) % atoms.size ()];
+                if (unsigned_cast (test::next_random (rnd)) % 4) line += ',';
+            }
+        }
+
+        std::vector<CSV_token> tokens_FSM;
+        std::vector<CSV_token> tokens;
+
+        bool failed_FSM { false };
+        bool failed { false };
+
+        try { CSV_tokenize_FSM (line, tokens_FSM); } catch (parse_failure const &) { failed_FSM = true; }
+        try { CSV_tokenize (line, tokens); } catch (parse_failure const &) { failed = true; }
+
+        ASSERT_EQ (failed, failed_FSM) << "failed for " << print (line);
+        if (failed) continue;
+
+        ASSERT_EQ (tokens.size (), tokens_FSM.size ()) << "failed for " << print (line);
+
+        for (int32_t t = 0, t_limit = tokens.size (); t < t_limit; ++ t)
+        {
+            ASSERT_EQ (tokens [t].m_start, tokens_FSM [t].m_start) << "failed for " << print (line) << ", token " << t;
+            ASSERT_EQ (tokens [t].m_size, tokens_FSM [t].m_size) << "failed for " << print (line) << ", token " << t;
+            ASSERT_EQ (tokens [t].m_type, tokens_FSM [t].m_type) << "failed for " << print (line) << ", token " << t;
+        }
+    }
+}
+/*
+ * inputs whose size is a multiple of the 64-byte classification block and that end
+ * in (or just past) a digit run, e.g. a trailing sign with no digits after it
+ */
+TEST (CSV_tokenizer, block_boundary)
+{
+    string_vector const lines
+    {
+        std::string (62, '1') + ",+",
+        std::string (62, '1') + ",-",
+        std::string (63, '1') + "+",
+        std::string (64, '1'),
+        std::string (63, '1') + ",",
+        std::string (62, '1') + ",1",
+        std::string (61, '1') + ",1.",
+        std::string (126, '1') + ",+",
+        std::string (127, '1') + "e"
+    };
+
+    for (std::string const & line : lines)
+    {
+        ASSERT_EQ (0, line.size () % 64) << print (line);
+
+        std::vector<CSV_token> tokens_FSM;
+        std::vector<CSV_token> tokens;
+
+        bool failed_FSM { false };
+        bool failed { false };
+
+        try { CSV_tokenize_FSM (line, tokens_FSM); } catch (parse_failure const &) { failed_FSM = true; }
+        try { CSV_tokenize (line, tokens); } catch (parse_failure const &) { failed = true; }
+
+        ASSERT_EQ (failed, failed_FSM) << "failed for " << print (line);
+        if (failed) continue;
+
+        ASSERT_EQ (tokens.size (), tokens_FSM.size ()) << "failed for " << print (line);
+
+        for (int32_t t = 0, t_limit = tokens.size (); t < t_limit; ++ t)
+        {
+            ASSERT_EQ (tokens [t].m_size, tokens_FSM [t].m_size) << "failed for " << print (line) << ", token " << t;
+            ASSERT_EQ (tokens [t].m_type, tokens_FSM [t].m_type) << "failed for " << print (line) << ", token " << t;
+        }
+    }
+}
+
 } // end of 'parse'
 } // end of 'io'
 } // end of namespace
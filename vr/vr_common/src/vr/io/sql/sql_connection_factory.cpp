@@ -46,10 +46,11 @@ struct cfg_connection_cache final // protected by 'm_lock'
 {
     using lock          = std::mutex;
 
-    cfg_connection_cache (uri const & db_url, int32_t const db_open_flags, int32_t const pool_min_size) :
+    cfg_connection_cache (uri const & db_url, int32_t const db_open_flags, int32_t const pool_min_size, bool const set_wal) :
         m_db_url { db_url },
         m_db_open_flags { db_open_flags },
-        m_pool_min_size { pool_min_size }
+        m_pool_min_size { pool_min_size },
+        m_set_wal { set_wal }
     {
         check_nonnegative (m_pool_min_size);
     }
@@ -59,6 +60,7 @@ struct cfg_connection_cache final // protected by 'm_lock'
     uri const m_db_url;
     int32_t const m_db_open_flags;
     int32_t const m_pool_min_size;
+    bool const m_set_wal;
     string_vector m_on_create_pragmas { };
     string_vector m_on_open_pragmas { };
     lock m_lock { };
@@ -100,10 +102,15 @@ struct sql_connection_factory::pimpl final
             // 'mode'       : 'ro', 'rw', 'rwc', 'memory' (implies 'rwc')
             // 'cache'      : 'private', 'shared' (default)
             // 'pool_size'  : <nonnegative int> (default: 0)
+            // 'wal'        : <bool> (default: false), put the db into WAL journal mode (done by writable connections,
+            //                the mode persists in the db file) so that readers and the writer don't block each other;
+            //                note that this only applies across connections that don't share a cache (other processes
+            //                or 'cache' : 'private'): 'shared' cache connections use sqlite's table-level locking regardless
 
             std::string const mode = cfg.at ("mode");
             std::string const cache = cfg.value ("cache", "shared");
             int32_t const pool_min_size = cfg.value ("pool_size", 0);
+            bool const wal = cfg.value ("wal", false);
 
             std::string db_uri_str { };
 
@@ -130,12 +137,16 @@ struct sql_connection_factory::pimpl final
 
             db_uri_str += "&cache="; db_uri_str += cache;
 
-            // TODO ASX-140: currently ro connections will lock out the db file for r/w
+            if (wal && (cache == "shared"))
+                LOG_warn << "sql connection cfg " << print (name) << ": WAL mode won't decouple readers from the writer within a shared cache";
+
+            // TODO ASX-140: currently ro connections will lock out the db file for r/w (unless the db is in WAL mode and
+            //               the connections are not in the same shared cache)
 
             uri const db_url { db_uri_str };
             int32_t const db_open_flags { SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_URI | SQLITE_OPEN_NOMUTEX }; // note: this must not be less permissive than URI 'mode'
 
-            auto const rc = m_cache_map.emplace (name, std::make_unique<cfg_connection_cache> (db_url, db_open_flags, pool_min_size));
+            auto const rc = m_cache_map.emplace (name, std::make_unique<cfg_connection_cache> (db_url, db_open_flags, pool_min_size, (wal && ((mode == "rw") || (mode == "rwc")))));
             if (! rc.second)
                 throw_x (invalid_input, "duplicate sql connection cfg name " + print (name));
 
@@ -316,6 +327,12 @@ struct sql_connection_factory::pimpl final
             }
         }
 
+        if (cfg.m_set_wal)
+        {
+            LOG_trace1 << "    setting WAL journal mode ...";
+            VR_CHECKED_SQLITE_CALL (::sqlite3_exec (handle, "PRAGMA journal_mode=WAL;", nullptr, nullptr, nullptr));
+        }
+
         for (std::string const & pragma : cfg.m_on_open_pragmas)
         {
             LOG_trace1 << "    executing [" << pragma << "] ...";
@@ -49,6 +49,8 @@ sqlite_connection::tx_commit ()
 
         assert_nonnull (m_handle);
         VR_CHECKED_SQLITE_CALL (::sqlite3_exec (m_handle, "COMMIT;", nullptr, nullptr, nullptr));
+
+        run_tx_end_actions ();
     }
 }
 
@@ -58,8 +60,51 @@ sqlite_connection::tx_rollback ()
     LOG_trace1 << "ROLLBACK " << m_handle;
 
     assert_nonnull (m_handle);
-    VR_CHECKED_SQLITE_CALL (::sqlite3_exec (m_handle, "ROLLBACK;", nullptr, nullptr, nullptr));
+    int32_t const rc = ::sqlite3_exec (m_handle, "ROLLBACK;", nullptr, nullptr, nullptr);
     m_nest_count = { };
+
+    run_tx_end_actions (); // [even if the rollback failed]
+
+    VR_CHECKED_SQLITE_CALL (rc);
+}
+//............................................................................
+
+void
+sqlite_connection::at_tx_end (addr_const_t const key, std::function<void ()> && action)
+{
+    if (! m_nest_count)
+    {
+        action ();
+        return;
+    }
+
+    for (auto const & ka : m_tx_end_actions)
+    {
+        if (ka.first == key) return;
+    }
+
+    m_tx_end_actions.emplace_back (key, std::move (action));
+}
+
+void
+sqlite_connection::run_tx_end_actions () VR_NOEXCEPT
+{
+    if (m_tx_end_actions.empty ()) return;
+
+    std::vector<std::pair<addr_const_t, std::function<void ()>>> actions { };
+    actions.swap (m_tx_end_actions); // in case an action starts a new TX on this connection
+
+    for (auto const & ka : actions)
+    {
+        try
+        {
+            ka.second ();
+        }
+        catch (std::exception const & e)
+        {
+            LOG_error << "TX end action failure: " << e.what ();
+        }
+    }
 }
 
 } // end of 'io'
@@ -3,6 +3,10 @@
 #include "vr/macros.h"
 #include "vr/types.h"
 
+#include <functional>
+#include <utility>
+#include <vector>
+
 struct sqlite3; // forward
 
 //----------------------------------------------------------------------------
@@ -58,6 +62,15 @@ class sqlite_connection: noncopyable
         void tx_commit ();
         void tx_rollback ();
 
+        /**
+         * arrange for 'action' to be invoked once the current (outermost) TX has ended, whether
+         * committed or rolled back; only the first action registered for a given 'key' during
+         * a TX is kept
+         *
+         * @note if no TX is open, 'action' is invoked immediately
+         */
+        void at_tx_end (addr_const_t const key, std::function<void ()> && action);
+
 
         template<typename A> class access_by;
 
@@ -70,8 +83,11 @@ class sqlite_connection: noncopyable
         friend class sqlite_stmt_cache;
         template<typename A> friend class access_by;
 
+        void run_tx_end_actions () VR_NOEXCEPT;
+
         ::sqlite3 * m_handle { }; // [owning]
         int32_t m_nest_count { }; // note:
+        std::vector<std::pair<addr_const_t, std::function<void ()>>> m_tx_end_actions { }; // [see 'at_tx_end()']
 
 }; // end of class
 
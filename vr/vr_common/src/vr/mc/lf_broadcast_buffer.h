@@ -0,0 +1,177 @@
+#pragma once
+
+#include "vr/enums.h"
+#include "vr/mc/cache_aware.h"
+#include "vr/mc/mc.h"
+#include "vr/util/type_traits.h"
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace mc
+{
+
+VR_ENUM (broadcast_read,
+    (
+        ok,
+        empty,      // nothing new past the cursor
+        overrun     // the producer has lapped the cursor, see 'lf_broadcast_buffer::resync()'
+    ),
+    printable
+
+); // end of enum
+//............................................................................
+/**
+ * a single-producer, multiple-consumer ring buffer in which every consumer sees
+ * every value (as opposed to values being distributed among consumers); each
+ * consumer reads through its own cursor (a position that the buffer does not
+ * know about), so there is no consumer registration and consumers share no
+ * mutable state
+ *
+ * the producer never waits: a slot is overwritten once the producer has lapped it
+ * and a consumer that has fallen more than 'CAPACITY' values behind finds out
+ * on its next read ('broadcast_read::overrun'); the intended use is for values to be
+ * incremental updates to some state that a consumer can resynchronize with by
+ * other means after an overrun
+ *
+ * each slot carries its own sequence (odd while being written), so both ends are
+ * wait-free and, as with @ref lf_spsc_buffer, need only x86-TSO and compiler fences
+ *
+ * @note 'T' is statically asserted to be trivially copyable
+ */
+template<typename T, int32_t CAPACITY>
+class lf_broadcast_buffer final: noncopyable
+{
+    private: // ..............................................................
+
+        vr_static_assert (std::is_trivially_copyable<T>::value);
+        vr_static_assert (vr_is_power_of_2 (CAPACITY));
+
+    public: // ...............................................................
+
+        using size_type     = signed_size_t;
+        using value_type    = T;
+
+        vr_static_assert (std::is_signed<size_type>::value);
+
+        static constexpr int32_t capacity ()    { return CAPACITY; }
+
+
+        lf_broadcast_buffer ()
+        {
+            __builtin_memset (m_data, 0, sizeof (m_data)); // slot seqs must start at zero ("never written")
+        }
+
+        // ACCESSORs:
+
+        /**
+         * @return number of values published so far (a new consumer cursor should start here)
+         */
+        VR_FORCEINLINE size_type position () const
+        {
+            return volatile_cast (m_position.value ());
+        }
+
+        /**
+         * @param cursor [advanced past 'out' iff returning 'broadcast_read::ok']
+         */
+        VR_FORCEINLINE broadcast_read::enum_t try_read (size_type & cursor, T & out) const; // note: never blocks
+
+        /**
+         * move an overrun 'cursor' to @ref position() (i.e. skip everything not yet read)
+         *
+         * @return number of values skipped
+         */
+        VR_ASSUME_COLD size_type resync (size_type & cursor) const
+        {
+            size_type const p = position ();
+            size_type const skipped = (p - cursor);
+
+            cursor = p;
+            return skipped;
+        }
+
+        // MUTATORs:
+
+        /**
+         * fill the next slot in place via 'f (T &)' and publish it
+         *
+         * @note must only be called by the (single) producer
+         */
+        template<typename F>
+        VR_FORCEINLINE void write (F && f);
+
+        /**
+         * @see write()
+         */
+        VR_FORCEINLINE void enqueue (T const & value)
+        {
+            write ([& value](T & dst) { dst = value; });
+        }
+
+    private: // ..............................................................
+
+        struct slot
+        {
+            size_type m_seq;    // '2 * position + 1' while being written, '2 * position + 2' after
+            T m_value;
+
+        }; // end of nested class
+
+        using entry         = cache_line_padded_field<slot>;
+
+        cache_line_padded_field<size_type> m_position { };  // [owned by P, read by Cs]
+        entry m_data [CAPACITY];
+
+}; // end of class
+//............................................................................
+
+template<typename T, int32_t CAPACITY>
+broadcast_read::enum_t
+lf_broadcast_buffer<T, CAPACITY>::try_read (size_type & cursor, T & out) const // force-inlined
+{
+    size_type const c = cursor;
+    slot const & s = m_data [c & (CAPACITY - 1)];
+
+    size_type const seq_expected = 2 * c + 2;
+    size_type const seq = volatile_cast (s.m_seq);
+
+    if (VR_LIKELY (seq < seq_expected)) // not yet (completely) written for position 'c'
+        return broadcast_read::empty;
+
+    if (VR_UNLIKELY (seq != seq_expected)) // already overwritten by a later lap
+        return broadcast_read::overrun;
+
+    compiler_fence ();
+    __builtin_memcpy (& out, & s.m_value, sizeof (T));
+    compiler_fence ();
+
+    if (VR_UNLIKELY (volatile_cast (s.m_seq) != seq_expected)) // overwritten while copying
+        return broadcast_read::overrun;
+
+    cursor = c + 1;
+    return broadcast_read::ok;
+}
+
+template<typename T, int32_t CAPACITY>
+template<typename F>
+void
+lf_broadcast_buffer<T, CAPACITY>::write (F && f) // force-inlined
+{
+    size_type const p = m_position.value (); // [owned by P]
+    slot & s = m_data [p & (CAPACITY - 1)];
+
+    volatile_cast (s.m_seq) = 2 * p + 1;
+    compiler_fence ();
+    {
+        f (s.m_value);
+    }
+    compiler_fence ();
+    volatile_cast (s.m_seq) = 2 * p + 2;
+
+    volatile_cast (m_position.value ()) = p + 1;
+}
+
+} // end of 'mc'
+} // end of namespace
+//----------------------------------------------------------------------------
@@ -0,0 +1,283 @@
+
+#include "vr/mc/lf_broadcast_buffer.h"
+#include "vr/mc/spinflag.h"
+#include "vr/util/intrinsics.h"
+
+#include "vr/test/mc.h"
+#include "vr/test/utility.h"
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace mc
+{
+//............................................................................
+//............................................................................
+namespace
+{
+
+using stop_flag             = mc::spinflag<true>;
+
+//............................................................................
+
+struct record
+{
+    int64_t m_seqnum;
+    uint64_t m_data [4];
+    uint32_t m_chksum;
+
+}; // end of class
+//............................................................................
+
+template<typename BUFFER>
+struct buffer_consumer
+{
+    buffer_consumer (BUFFER const & buf, stop_flag & done, stop_flag & sf) :
+        m_buf { buf },
+        m_done { done },
+        m_stop_flag { sf }
+    {
+    }
+
+    void operator() ()
+    {
+        try
+        {
+            typename BUFFER::size_type cursor = m_buf.position ();
+            record v;
+
+            while (! m_stop_flag.is_raised ())
+            {
+                broadcast_read::enum_t const rc = m_buf.try_read (cursor, v);
+
+                switch (rc)
+                {
+                    case broadcast_read::ok:
+                    {
+                        check_eq (v.m_seqnum, cursor - 1);
+
+                        uint32_t chksum { 1 };
+                        for (uint64_t d : v.m_data)
+                        {
+                            chksum = util::i_crc32 (chksum, d);
+                        }
+                        check_eq (v.m_chksum, chksum);
+
+                        ++ m_read_count;
+                    }
+                    break;
+
+                    case broadcast_read::empty:
+                    {
+                        if (m_done.is_raised () && (cursor == m_buf.position ())) // drained
+                        {
+                            m_cursor = cursor;
+                            return;
+                        }
+                    }
+                    break;
+
+                    case broadcast_read::overrun:
+                    {
+                        m_skip_count += m_buf.resync (cursor);
+                        ++ m_overrun_count;
+                    }
+                    break;
+
+                } // end of switch
+            }
+        }
+        catch (...)
+        {
+            m_stop_flag.raise ();
+            m_failure = std::current_exception ();
+        }
+    }
+
+    BUFFER const & m_buf;
+    int64_t m_cursor { };
+    int64_t m_read_count { };
+    int64_t m_skip_count { };
+    int64_t m_overrun_count { };
+    std::exception_ptr m_failure { };
+    stop_flag & m_done;
+    stop_flag & m_stop_flag;
+
+}; // end of class
+
+template<typename BUFFER>
+struct buffer_producer
+{
+    buffer_producer (BUFFER & buf, int64_t const repeats, stop_flag & done, stop_flag & sf, int64_t const seed) :
+        m_buf { buf },
+        m_repeats { repeats },
+        m_seed { seed },
+        m_done { done },
+        m_stop_flag { sf }
+    {
+    }
+
+    void operator() ()
+    {
+        uint64_t rnd = m_seed;
+
+        int64_t r { };
+        for ( ; ! m_stop_flag.is_raised () && (r < m_repeats); ++ r)
+        {
+            m_buf.write ([&](record & v)
+                {
+                    v.m_seqnum = r;
+
+                    uint32_t chksum { 1 };
+                    for (uint64_t & d : v.m_data)
+                    {
+                        d = test::next_random (rnd);
+                        chksum = util::i_crc32 (chksum, d);
+                    }
+                    v.m_chksum = chksum;
+                });
+
+            mc::pause (test::next_random (rnd) & 0x0F); // a random pause, so that consumers keep up most of the time
+        }
+
+        m_r_completed = r;
+        m_done.raise ();
+    }
+
+    BUFFER & m_buf;
+    int64_t const m_repeats;
+    int64_t const m_seed;
+    int64_t m_r_completed { };
+    stop_flag & m_done;
+    stop_flag & m_stop_flag;
+
+}; // end of class
+
+} // end of anonymous
+//............................................................................
+//............................................................................
+
+TEST (lf_broadcast_buffer, sniff)
+{
+    constexpr int32_t capacity  = 8;
+    using buffer_type           = lf_broadcast_buffer<record, capacity>;
+
+    using size_type             = buffer_type::size_type;
+
+    buffer_type buf { };
+    ASSERT_EQ (buf.position (), 0);
+
+    record v;
+
+    size_type c0 = buf.position (); // starts before the first write
+    ASSERT_EQ (buf.try_read (c0, v), broadcast_read::empty);
+    ASSERT_EQ (c0, 0);
+
+    for (int64_t r = 0; r < 3; ++ r)
+    {
+        buf.write ([r](record & dst) { dst.m_seqnum = r; });
+    }
+    ASSERT_EQ (buf.position (), 3);
+
+    size_type c1 = buf.position (); // starts after the first three writes
+
+    // every cursor sees every value:
+
+    for (int64_t r = 0; r < 3; ++ r)
+    {
+        ASSERT_EQ (buf.try_read (c0, v), broadcast_read::ok);
+        EXPECT_EQ (v.m_seqnum, r);
+        EXPECT_EQ (c0, r + 1);
+    }
+    ASSERT_EQ (buf.try_read (c0, v), broadcast_read::empty);
+    ASSERT_EQ (buf.try_read (c1, v), broadcast_read::empty);
+
+    record in { };
+    in.m_seqnum = 3;
+    buf.enqueue (in);
+
+    ASSERT_EQ (buf.try_read (c0, v), broadcast_read::ok);
+    EXPECT_EQ (v.m_seqnum, 3);
+    ASSERT_EQ (buf.try_read (c1, v), broadcast_read::ok);
+    EXPECT_EQ (v.m_seqnum, 3);
+
+    // lap 'c0' (but not 'c1'):
+
+    for (int64_t r = 4; r < 4 + capacity + 1; ++ r)
+    {
+        buf.write ([r](record & dst) { dst.m_seqnum = r; });
+
+        if (r == 4)
+        {
+            ASSERT_EQ (buf.try_read (c1, v), broadcast_read::ok);
+            EXPECT_EQ (v.m_seqnum, 4);
+        }
+    }
+
+    ASSERT_EQ (buf.try_read (c0, v), broadcast_read::overrun);
+    ASSERT_EQ (c0, 4); // unchanged
+
+    ASSERT_EQ (buf.try_read (c1, v), broadcast_read::ok); // 'c1' is exactly 'capacity' behind
+    EXPECT_EQ (v.m_seqnum, 5);
+
+    ASSERT_EQ (buf.resync (c0), capacity + 1);
+    ASSERT_EQ (c0, buf.position ());
+    ASSERT_EQ (buf.try_read (c0, v), broadcast_read::empty);
+}
+//............................................................................
+
+TEST (lf_broadcast_buffer, multicore)
+{
+    constexpr int32_t capacity  = 64;
+    using buffer_type           = lf_broadcast_buffer<record, capacity>;
+
+    buffer_type buf { };
+
+    using consumer_task         = buffer_consumer<buffer_type>;
+    using producer_task         = buffer_producer<buffer_type>;
+
+    int64_t const repeats       = 1000000;
+    int64_t const seed          = test::env::random_seed<int64_t> ();
+
+    stop_flag done { };
+    stop_flag sf { };
+
+    test::task_container tasks { };
+
+    tasks.add ({ consumer_task { buf, done, sf }, 1 }, "consumer.0"); // note: a consumer that starts late won't see the first values
+    tasks.add ({ consumer_task { buf, done, sf }, 2 }, "consumer.1");
+    tasks.add ({ producer_task { buf, repeats, done, sf, seed }, 3 }, "producer");
+
+    tasks.start ();
+    tasks.stop ();
+
+    producer_task const & p = tasks ["producer"];
+    EXPECT_EQ (p.m_r_completed, repeats);
+
+    for (std::string const name : { "consumer.0", "consumer.1" })
+    {
+        consumer_task const & c = tasks [name];
+
+        if (c.m_failure)
+        {
+            try
+            {
+                std::rethrow_exception (c.m_failure);
+            }
+            catch (std::exception const & e)
+            {
+                ADD_FAILURE () << name << ": " << exc_info (e);
+            }
+        }
+
+        LOG_info << name << ": read " << c.m_read_count << ", skipped " << c.m_skip_count << " in " << c.m_overrun_count << " overrun(s)";
+
+        EXPECT_EQ (c.m_cursor, repeats) << name;
+        EXPECT_LE (c.m_read_count + c.m_skip_count, repeats) << name;
+        EXPECT_GT (c.m_read_count, 0) << name;
+    }
+}
+
+} // end of 'mc'
+} // end of namespace
+//----------------------------------------------------------------------------
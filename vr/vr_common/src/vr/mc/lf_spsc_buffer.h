@@ -4,6 +4,8 @@
 #include "vr/mc/mc.h"
 #include "vr/util/type_traits.h"
 
+#include <algorithm>
+
 //----------------------------------------------------------------------------
 namespace vr
 {
@@ -29,6 +31,12 @@ class dequeue_result_impl; // forward
 template<typename T, int32_t CAPACITY>
 class enqueue_result_impl; // forward
 
+template<typename T, int32_t CAPACITY>
+class dequeue_batch_impl; // forward
+
+template<typename T, int32_t CAPACITY>
+class enqueue_batch_impl; // forward
+
 //............................................................................
 
 class lf_spsc_buffer_base
@@ -51,6 +59,8 @@ class lf_spsc_buffer_base
 
         template<typename T, int32_t CAPACITY> friend class dequeue_result_impl;
         template<typename T, int32_t CAPACITY> friend class enqueue_result_impl;
+        template<typename T, int32_t CAPACITY> friend class dequeue_batch_impl;
+        template<typename T, int32_t CAPACITY> friend class enqueue_batch_impl;
 
         vr_static_assert (std::is_signed<size_type>::value);
 
@@ -187,6 +197,127 @@ struct enqueue_result_impl
 
         lf_spsc_buffer_base::cl_producer_context * m_ctx; // note: use fully typed ptr to let compiler see the alignment
 
+}; // end of class
+//............................................................................
+
+template<typename T, int32_t CAPACITY>
+struct dequeue_batch_impl
+{
+    using size_type     = lf_spsc_buffer_base::size_type;
+
+    VR_FORCEINLINE dequeue_batch_impl (lf_spsc_buffer_base::cl_consumer_context * const ctx, size_type const size) :
+        m_ctx { ctx },
+        m_size { size }
+    {
+    }
+
+    /*
+     * release all slots in the batch with a single consumer position update
+     */
+    VR_FORCEINLINE ~dequeue_batch_impl ()
+    {
+        compiler_fence ();
+
+        if (VR_LIKELY (m_size > 0))
+        {
+            volatile_cast (m_ctx->value ().m_c_position) = m_ctx->value ().m_c_position + m_size;
+        }
+    }
+
+
+    VR_FORCEINLINE size_type size () const
+    {
+        return m_size;
+    }
+
+    VR_FORCEINLINE explicit operator bool () const
+    {
+        return (m_size > 0);
+    }
+
+    VR_FORCEINLINE T const & operator[] (size_type const i) const
+    {
+        assert_within (i, m_size);
+
+        lf_spsc_buffer_base::cl_consumer_context * const ctx { m_ctx };
+
+        return (* reinterpret_cast<T const *> (& reinterpret_cast<cache_line_slot const *> (ctx) [2 + (static_cast<uint32_t> (ctx->value ().m_c_position + i) & (CAPACITY - 1))]));
+    }
+
+    private:
+
+        lf_spsc_buffer_base::cl_consumer_context * const m_ctx;
+        size_type const m_size;
+
+}; // end of class
+
+
+template<typename T, int32_t CAPACITY>
+struct enqueue_batch_impl
+{
+    using size_type     = lf_spsc_buffer_base::size_type;
+
+    VR_FORCEINLINE enqueue_batch_impl (lf_spsc_buffer_base::cl_producer_context * const ctx, size_type const size) :
+        m_ctx { ctx },
+        m_size { size }
+    {
+    }
+
+    /*
+     * publish the committed prefix of the batch with a single producer position update
+     */
+    VR_FORCEINLINE ~enqueue_batch_impl ()
+    {
+        compiler_fence ();
+
+        if (VR_LIKELY (m_committed > 0))
+        {
+            volatile_cast (m_ctx->value ().m_p_position) = m_ctx->value ().m_p_position + m_committed;
+        }
+    }
+
+
+    VR_FORCEINLINE size_type size () const
+    {
+        return m_size;
+    }
+
+    VR_FORCEINLINE explicit operator bool () const
+    {
+        return (m_size > 0);
+    }
+
+    /**
+     * @param count number of leading slots to publish on destruction (slots past 'count' are abandoned)
+     */
+    VR_FORCEINLINE void commit (size_type const count)
+    {
+        assert_within_inclusive (count, m_size);
+
+        m_committed = count;
+    }
+
+    VR_FORCEINLINE void commit ()
+    {
+        commit (m_size);
+    }
+
+
+    VR_FORCEINLINE T & operator[] (size_type const i)
+    {
+        assert_within (i, m_size);
+
+        lf_spsc_buffer_base::cl_producer_context * const ctx { m_ctx };
+
+        return (* reinterpret_cast<T *> (& reinterpret_cast<cache_line_slot *> (ctx) [1 + (static_cast<uint32_t> (ctx->value ().m_p_position + i) & (CAPACITY - 1))]));
+    }
+
+    private:
+
+        lf_spsc_buffer_base::cl_producer_context * const m_ctx;
+        size_type const m_size;
+        size_type m_committed { };
+
 }; // end of class
 
 } // end of 'impl'
@@ -212,6 +343,12 @@ struct default_lf_spsq_buffer_options
  *
  * @note technically, this impl is "lock-free" and not "wait-free" but this
  *       distinction is not relevant when the use case is a polling loop
+ *
+ * each side keeps a local shadow of the other side's position and re-reads the shared
+ * one only when the shadow says the buffer is empty (consumer) or full (producer), so
+ * in steady state neither side touches the other side's cache line on every op;
+ * batch variants ('try_dequeue_batch()', 'try_enqueue_batch()') reserve up to N slots
+ * at once and release/publish them with a single position update
  */
 template<typename T, int32_t CAPACITY, typename OPTIONS = default_lf_spsq_buffer_options<T>>
 class lf_spsc_buffer final: public impl::lf_spsc_buffer_base
@@ -233,6 +370,9 @@ class lf_spsc_buffer final: public impl::lf_spsc_buffer_base
         using dequeue_result    = impl::dequeue_result_impl<T, CAPACITY>;
         using enqueue_result    = impl::enqueue_result_impl<T, CAPACITY>;
 
+        using dequeue_batch     = impl::dequeue_batch_impl<T, CAPACITY>;
+        using enqueue_batch     = impl::enqueue_batch_impl<T, CAPACITY>;
+
 
         lf_spsc_buffer ()
         {
@@ -245,6 +385,19 @@ class lf_spsc_buffer final: public impl::lf_spsc_buffer_base
 
         VR_FORCEINLINE enqueue_result try_enqueue (); // TODO 'spin_count' ?
 
+        /**
+         * @param n max number of slots to dequeue [must be positive]
+         * @return a batch of [0, n] slots, all released when the result goes out of scope
+         */
+        VR_FORCEINLINE dequeue_batch try_dequeue_batch (size_type const n);
+
+        /**
+         * @param n max number of slots to reserve [must be positive]
+         * @return a batch of [0, n] slots, of which the committed prefix is published when
+         *         the result goes out of scope
+         */
+        VR_FORCEINLINE enqueue_batch try_enqueue_batch (size_type const n);
+
     private: // ..............................................................
 
         using entry     = cache_line_padded_field<T>;
@@ -290,6 +443,52 @@ lf_spsc_buffer<T, CAPACITY, OPTIONS>::try_enqueue () // force-inlined
 
     return { & p_ctx };
 }
+//............................................................................
+
+template<typename T, int32_t CAPACITY, typename OPTIONS>
+typename lf_spsc_buffer<T, CAPACITY, OPTIONS>::dequeue_batch
+lf_spsc_buffer<T, CAPACITY, OPTIONS>::try_dequeue_batch (size_type const n) // force-inlined
+{
+    assert_positive (n);
+
+    cl_consumer_context & c_ctx = m_c_ctx;
+
+    size_type const c_pos = c_ctx.value ().m_c_position;
+    size_type & p_local { c_ctx.value ().m_p_local };
+
+    size_type available = (p_local - c_pos);
+
+    if (VR_UNLIKELY (available < n)) // refresh the shadow only if it can't satisfy the whole batch
+    {
+        p_local = volatile_cast (m_p_ctx.value ().m_p_position); // note 'm_p_local' side-effect
+        available = (p_local - c_pos);
+    }
+
+    return { & c_ctx, std::min (available, n) };
+}
+//............................................................................
+
+template<typename T, int32_t CAPACITY, typename OPTIONS>
+typename lf_spsc_buffer<T, CAPACITY, OPTIONS>::enqueue_batch
+lf_spsc_buffer<T, CAPACITY, OPTIONS>::try_enqueue_batch (size_type const n) // force-inlined
+{
+    assert_positive (n);
+
+    cl_producer_context & p_ctx = m_p_ctx;
+
+    size_type const p_pos_m_cap = (p_ctx.value ().m_p_position - CAPACITY);
+    size_type & c_local { p_ctx.value ().m_c_local };
+
+    size_type available = (c_local - p_pos_m_cap);
+
+    if (VR_UNLIKELY (available < n)) // refresh the shadow only if it can't satisfy the whole batch
+    {
+        c_local = volatile_cast (m_c_ctx.value ().m_c_position); // note 'm_c_local' side-effect
+        available = (c_local - p_pos_m_cap);
+    }
+
+    return { & p_ctx, std::min (available, n) };
+}
 
 } // end of 'mc'
 } // end of namespace
@@ -0,0 +1,285 @@
+#include "vr/macros.h" // VR_RELEASE
+#if VR_RELEASE // perf testcases in release builds only
+
+#include "vr/mc/lf_spsc_buffer.h"
+#include "vr/mc/mc.h"
+#include "vr/sys/cpu.h"
+#include "vr/util/logging.h"
+
+#include "vr/test/mc.h"
+#include "vr/test/utility.h"
+
+#include <algorithm>
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace mc
+{
+//............................................................................
+//............................................................................
+namespace
+{
+
+struct message
+{
+    int64_t m_tsc;              // producer TSC at enqueue time
+    int64_t m_seqnum;
+    uint64_t m_payload [2];
+
+}; // end of class
+
+constexpr int32_t capacity      = 1024;
+
+using buffer_type               = lf_spsc_buffer<message, capacity>;
+
+//............................................................................
+
+/*
+ *  same_core       SMT siblings
+ *  same_socket     different cores on the same socket
+ *  cross_socket    different sockets
+ */
+VR_ENUM (placement, (same_core, same_socket, cross_socket), iterable, printable);
+
+/*
+ * @return (consumer PU, producer PU) for 'p' or a pair of -1s if the machine topology
+ *         does not have such a pair
+ */
+std::pair<int32_t, int32_t>
+select_PUs (placement::enum_t const p)
+{
+    std::vector<sys::cpu_info::PU_location> const & PUs = sys::cpu_info::instance ().PU_topology ();
+
+    for (auto const & c : PUs)
+    {
+        for (auto const & pr : PUs)
+        {
+            if (pr.m_PU == c.m_PU) continue;
+
+            bool match { false };
+            switch (p)
+            {
+                case placement::same_core:      match = (c.m_core >= 0) && (pr.m_core == c.m_core); break;
+                case placement::same_socket:    match = (c.m_socket >= 0) && (pr.m_socket == c.m_socket) && (pr.m_core != c.m_core); break;
+                case placement::cross_socket:   match = (c.m_socket >= 0) && (pr.m_socket >= 0) && (pr.m_socket != c.m_socket); break;
+
+            } // end of switch
+
+            if (match) return { c.m_PU, pr.m_PU };
+        }
+    }
+
+    return { -1, -1 };
+}
+//............................................................................
+/*
+ * 'BATCH' of 1 means single-slot ops; 'pace' of 0 means saturating the buffer
+ */
+template<int32_t BATCH>
+struct consumer
+{
+    consumer (buffer_type & buf, int64_t const count, bool const record_latency) :
+        m_buf { buf },
+        m_count { count },
+        m_record_latency { record_latency }
+    {
+        if (m_record_latency) m_latencies.reserve (count);
+    }
+
+    void operator() ()
+    {
+        int64_t r { };
+        while (r < m_count)
+        {
+            if (BATCH == 1)
+            {
+                auto rc = m_buf.try_dequeue ();
+                if (rc)
+                {
+                    message const & m = rc;
+                    record (m, r ++);
+                }
+            }
+            else
+            {
+                auto rc = m_buf.try_dequeue_batch (BATCH);
+
+                for (int32_t i = 0; i < rc.size (); ++ i)
+                {
+                    record (rc [i], r ++);
+                }
+            }
+        }
+    }
+
+    VR_FORCEINLINE void record (message const & m, int64_t const r)
+    {
+        int64_t const now = tsc ();
+
+        if (VR_UNLIKELY (r == 0)) m_tsc_first = now;
+        m_tsc_last = now;
+
+        if (m_record_latency) m_latencies.push_back (now - m.m_tsc);
+        m_checksum += m.m_seqnum;
+    }
+
+    buffer_type & m_buf;
+    int64_t const m_count;
+    bool const m_record_latency;
+    std::vector<int64_t> m_latencies { };
+    int64_t m_tsc_first { };
+    int64_t m_tsc_last { };
+    int64_t m_checksum { };
+
+}; // end of class
+
+template<int32_t BATCH>
+struct producer
+{
+    producer (buffer_type & buf, int64_t const count, int64_t const pace_ticks) :
+        m_buf { buf },
+        m_count { count },
+        m_pace_ticks { pace_ticks }
+    {
+    }
+
+    void operator() ()
+    {
+        int64_t r { };
+        while (r < m_count)
+        {
+            if (m_pace_ticks > 0) // wait until the next send time
+            {
+                for (int64_t const t_next = tsc () + m_pace_ticks; tsc () < t_next; ) pause ();
+            }
+
+            if (BATCH == 1)
+            {
+                auto rc = m_buf.try_enqueue ();
+                if (rc)
+                {
+                    message & m = rc;
+                    fill (m, r ++);
+
+                    rc.commit ();
+                }
+            }
+            else
+            {
+                auto rc = m_buf.try_enqueue_batch (std::min<int64_t> ((m_pace_ticks > 0 ? 1 : BATCH), m_count - r));
+
+                for (int32_t i = 0; i < rc.size (); ++ i)
+                {
+                    fill (rc [i], r ++);
+                }
+
+                rc.commit ();
+            }
+        }
+    }
+
+    static VR_FORCEINLINE void fill (message & m, int64_t const r)
+    {
+        m.m_seqnum = r;
+        m.m_tsc = tsc (); // last, as close to the publish as possible
+    }
+
+    buffer_type & m_buf;
+    int64_t const m_count;
+    int64_t const m_pace_ticks;
+
+}; // end of class
+//............................................................................
+
+template<int32_t BATCH>
+void
+run_saturated (placement::enum_t const p, int32_t const PU_C, int32_t const PU_P, int64_t const count)
+{
+    buffer_type buf { };
+
+    using consumer_task     = consumer<BATCH>;
+    using producer_task     = producer<BATCH>;
+
+    test::task_container tasks { };
+
+    tasks.add ({ consumer_task { buf, count, false }, PU_C }, "consumer");
+    tasks.add ({ producer_task { buf, count, 0 }, PU_P }, "producer");
+
+    tasks.start ();
+    tasks.stop ();
+
+    consumer_task const & c = tasks ["consumer"];
+    EXPECT_EQ (c.m_checksum, count * (count - 1) / 2);
+
+    double const ns = (c.m_tsc_last - c.m_tsc_first) / tsc_ticks_per_ns ();
+
+    LOG_info << print (p) << " [PUs " << PU_C << ", " << PU_P << "], batch " << BATCH << ": "
+             << std::setprecision (4) << (1e9 * (count - 1) / ns) << " msg/s";
+}
+
+template<int32_t BATCH>
+void
+run_paced (placement::enum_t const p, int32_t const PU_C, int32_t const PU_P, int64_t const count, int64_t const pace_ns)
+{
+    buffer_type buf { };
+
+    using consumer_task     = consumer<BATCH>;
+    using producer_task     = producer<BATCH>;
+
+    double const ticks_per_ns = tsc_ticks_per_ns ();
+
+    test::task_container tasks { };
+
+    tasks.add ({ consumer_task { buf, count, true }, PU_C }, "consumer");
+    tasks.add ({ producer_task { buf, count, static_cast<int64_t> (pace_ns * ticks_per_ns) }, PU_P }, "producer");
+
+    tasks.start ();
+    tasks.stop ();
+
+    consumer_task & c = tasks ["consumer"];
+    std::vector<int64_t> & l = c.m_latencies;
+    ASSERT_EQ (signed_cast (l.size ()), count);
+
+    std::sort (l.begin (), l.end ());
+
+    LOG_info << print (p) << " [PUs " << PU_C << ", " << PU_P << "], batch " << BATCH << ": one-way latency (ns) p50 "
+             << std::setprecision (4) << (l [l.size () / 2] / ticks_per_ns) << ", p99 " << (l [(l.size () * 99) / 100] / ticks_per_ns);
+}
+
+} // end of anonymous
+//............................................................................
+//............................................................................
+/*
+ * saturated throughput and paced one-way latency, single-slot vs batch ops, for
+ * each producer/consumer placement supported by this machine
+ */
+TEST (perf_lf_spsc_buffer, placement)
+{
+    int64_t const count         = 10000000;
+    int64_t const paced_count   = 200000;
+    int64_t const pace_ns       = 1000;
+
+    for (placement::enum_t const p : placement::values ())
+    {
+        auto const PUs = select_PUs (p);
+
+        if (PUs.first < 0)
+        {
+            LOG_warn << "no PU pair for " << print (p) << " placement, skipping";
+            continue;
+        }
+
+        run_saturated<1> (p, PUs.first, PUs.second, count);
+        run_saturated<32> (p, PUs.first, PUs.second, count);
+
+        run_paced<1> (p, PUs.first, PUs.second, paced_count, pace_ns);
+        run_paced<32> (p, PUs.first, PUs.second, paced_count, pace_ns);
+    }
+}
+
+} // end of 'mc'
+} // end of namespace
+//----------------------------------------------------------------------------
+
+#endif // VR_RELEASE
@@ -161,6 +161,129 @@ struct buffer_producer
     std::exception_ptr m_failure { };
     stop_flag & m_stop_flag;
 
+}; // end of class
+//............................................................................
+/*
+ * batch versions of the above (same 'record2' validation)
+ */
+template<typename BUFFER, int32_t BATCH>
+struct batch_buffer_consumer
+{
+    batch_buffer_consumer (BUFFER & buf, int64_t const repeats, stop_flag & sf, int64_t const seed) :
+        m_buf { buf },
+        m_repeats { repeats },
+        m_seed { seed },
+        m_stop_flag { sf }
+    {
+    }
+
+    void operator() ()
+    {
+        int64_t r { };
+        try
+        {
+            while (! m_stop_flag.is_raised () && (r < m_repeats))
+            {
+                auto rc = m_buf.try_dequeue_batch (BATCH);
+
+                for (int32_t i = 0; i < rc.size (); ++ i)
+                {
+                    record2 const & v = rc [i];
+                    {
+                        check_eq (v.m_seqnum, r);
+
+                        uint32_t chksum { 1 };
+                        for (uint64_t d : v.m_data)
+                        {
+                            chksum = util::i_crc32 (chksum, d);
+                        }
+                        check_eq (v.m_chksum, chksum);
+                    }
+
+                    ++ r;
+                }
+            }
+        }
+        catch (...)
+        {
+            m_stop_flag.raise ();
+            m_failure = std::current_exception ();
+        }
+        m_r_completed = r;
+        LOG_info << "batch consumer DONE [completed: " << r << ']';
+    }
+
+    BUFFER & m_buf;
+    int64_t const m_repeats;
+    int64_t const m_seed;
+    int64_t m_r_completed { };
+    std::exception_ptr m_failure { };
+    stop_flag & m_stop_flag;
+
+}; // end of class
+
+template<typename BUFFER, int32_t BATCH>
+struct batch_buffer_producer
+{
+    batch_buffer_producer (BUFFER & buf, int64_t const repeats, stop_flag & sf, int64_t const seed) :
+        m_buf { buf },
+        m_repeats { repeats },
+        m_seed { seed },
+        m_stop_flag { sf }
+    {
+    }
+
+    void operator() ()
+    {
+        uint64_t rnd = m_seed;
+
+        int64_t r { };
+        try
+        {
+            while (! m_stop_flag.is_raised () && (r < m_repeats))
+            {
+                auto rc = m_buf.try_enqueue_batch (std::min<int64_t> (BATCH, m_repeats - r));
+
+                for (int32_t i = 0; i < rc.size (); ++ i)
+                {
+                    record2 & v = rc [i];
+                    {
+                        v.m_seqnum = r + i;
+
+                        uint32_t chksum { 1 };
+                        for (uint64_t & d : v.m_data)
+                        {
+                            d = test::next_random (rnd);
+                            chksum = util::i_crc32 (chksum, d);
+                        }
+                        v.m_chksum = chksum;
+                    }
+                }
+
+                // commit a (random) prefix of the batch, all of it most of the time:
+
+                int32_t const count = ((test::next_random (rnd) & 0x0F) ? rc.size () : (rc.size () / 2));
+
+                rc.commit (count);
+                r += count;
+            }
+        }
+        catch (...)
+        {
+            m_stop_flag.raise ();
+            m_failure = std::current_exception ();
+        }
+        m_r_completed = r;
+        LOG_info << "batch producer DONE [completed: " << r << ']';
+    }
+
+    BUFFER & m_buf;
+    int64_t const m_repeats;
+    int64_t const m_seed;
+    int64_t m_r_completed { };
+    std::exception_ptr m_failure { };
+    stop_flag & m_stop_flag;
+
 }; // end of class
 
 } // end of anonymous
@@ -279,6 +402,108 @@ TEST (lf_spsc_buffer, sniff)
         ASSERT_FALSE (dr);
     }
 }
+
+TEST (lf_spsc_buffer, batch_sniff)
+{
+    constexpr int32_t capacity  = 32;
+    using buffer_type           = lf_spsc_buffer<record, capacity>;
+
+    buffer_type buf { };
+
+    // empty queue batch dequeue should get nothing:
+    {
+        auto dr = buf.try_dequeue_batch (8);
+        ASSERT_FALSE (dr);
+        ASSERT_EQ (dr.size (), 0);
+    }
+
+    // uncommitted batch enqueue changes nothing:
+    {
+        auto er = buf.try_enqueue_batch (8);
+        ASSERT_EQ (er.size (), 8);
+    }
+    ASSERT_EQ (buf.size (), 0);
+
+    // partially committed batch enqueue publishes only the prefix:
+    {
+        auto er = buf.try_enqueue_batch (8);
+        ASSERT_EQ (er.size (), 8);
+
+        for (int32_t i = 0; i < er.size (); ++ i)
+        {
+            er [i].m_i64 = - i;
+            er [i].m_i32 = i;
+        }
+        er.commit (5);
+    }
+    ASSERT_EQ (buf.size (), 5);
+
+    // a batch dequeue gets no more than what's been published:
+    {
+        auto dr = buf.try_dequeue_batch (8);
+        ASSERT_EQ (dr.size (), 5);
+
+        for (int32_t i = 0; i < dr.size (); ++ i)
+        {
+            EXPECT_EQ (dr [i].m_i64, - i);
+            EXPECT_EQ (dr [i].m_i32, i);
+        }
+    }
+    ASSERT_EQ (buf.size (), 0); // empty again
+
+    // batches interoperate with single-slot ops and wrap around:
+
+    for (int32_t round = 0; round < 3; ++ round)
+    {
+        {
+            auto er = buf.try_enqueue_batch (capacity + 1); // more than capacity
+            ASSERT_EQ (er.size (), capacity);
+
+            for (int32_t i = 0; i < er.size (); ++ i)
+            {
+                er [i].m_i64 = round;
+                er [i].m_i32 = i;
+            }
+            er.commit ();
+        }
+        ASSERT_EQ (buf.size (), capacity); // full
+
+        {
+            auto er = buf.try_enqueue_batch (1);
+            ASSERT_FALSE (er); // full queue batch enqueue gets nothing
+        }
+        {
+            auto dr = buf.try_dequeue ();
+            ASSERT_TRUE (dr);
+
+            record const & v = dr;
+            EXPECT_EQ (v.m_i64, round);
+            EXPECT_EQ (v.m_i32, 0);
+        }
+        {
+            auto dr = buf.try_dequeue_batch (capacity);
+            ASSERT_EQ (dr.size (), capacity - 1);
+
+            for (int32_t i = 0; i < dr.size (); ++ i)
+            {
+                EXPECT_EQ (dr [i].m_i64, round);
+                EXPECT_EQ (dr [i].m_i32, i + 1);
+            }
+        }
+        ASSERT_EQ (buf.size (), 0);
+
+        // misalign positions for the next round:
+        {
+            auto er = buf.try_enqueue ();
+            ASSERT_TRUE (er);
+            er.commit ();
+        }
+        {
+            auto dr = buf.try_dequeue_batch (2);
+            ASSERT_EQ (dr.size (), 1);
+        }
+    }
+}
 //............................................................................
 //............................................................................
 
@@ -390,6 +615,61 @@ TYPED_TEST (lf_spsc_buffer_test, multicore)
 
     if (! ok) ADD_FAILURE () << "scenario<" << capacity << ", " << scenario::c_pause () << ", " << scenario::p_pause () << "> failed";
 }
+//............................................................................
+
+template<typename T> struct lf_spsc_buffer_batch_test: public gt::Test { };
+TYPED_TEST_CASE (lf_spsc_buffer_batch_test, scenarios); // note: pause parameters are not used
+
+TYPED_TEST (lf_spsc_buffer_batch_test, multicore)
+{
+    using scenario              = TypeParam; // test parameters
+
+    constexpr int32_t capacity  = scenario::capacity ();
+
+    using buffer_type           = lf_spsc_buffer<record2, capacity>;
+
+    buffer_type buf { };
+
+    using consumer_task         = batch_buffer_consumer<buffer_type, 16>;
+    using producer_task         = batch_buffer_producer<buffer_type, 7>; // not a divisor of consumer batch size
+
+    int32_t const PU_C          = 2;
+    int32_t const PU_P          = 3;
+
+    int64_t const repeats       = (capacity == 1 ? 10000 : 500000);
+    int64_t const seed          = test::env::random_seed<int64_t> ();
+
+    stop_flag sf { }; // cl-padded
+
+    test::task_container tasks { };
+
+    tasks.add ({ consumer_task { buf, repeats, sf, seed }, PU_C }, "consumer");
+    tasks.add ({ producer_task { buf, repeats, sf, seed }, PU_P }, "producer");
+
+    tasks.start ();
+    tasks.stop ();
+
+    consumer_task const & c = tasks ["consumer"];
+    producer_task const & p = tasks ["producer"];
+
+    for (std::exception_ptr const & f : { c.m_failure, p.m_failure })
+    {
+        if (f)
+        {
+            try
+            {
+                std::rethrow_exception (f);
+            }
+            catch (std::exception const & e)
+            {
+                ADD_FAILURE () << exc_info (e);
+            }
+        }
+    }
+
+    EXPECT_EQ (c.m_r_completed, repeats);
+    EXPECT_EQ (p.m_r_completed, repeats);
+}
 
 } // end of 'mc'
 } // end of namespace
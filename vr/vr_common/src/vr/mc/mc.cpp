@@ -1,6 +1,9 @@
 
 #include "vr/mc/mc.h"
 
+#include "vr/sys/os.h"
+#include "vr/util/logging.h"
+
 //----------------------------------------------------------------------------
 namespace vr
 {
@@ -16,6 +19,31 @@ pause (int64_t const repeat)
         pause ();
     }
 }
+//............................................................................
+
+double
+tsc_ticks_per_ns ()
+{
+    static double const g_ticks_per_ns = []()
+        {
+            timestamp_t const calibration_time = 10 * _1_millisecond ();
+
+            timestamp_t const t_start = sys::realtime_utc ();
+            int64_t const tsc_start = tsc ();
+
+            timestamp_t t;
+            while ((t = sys::realtime_utc ()) - t_start < calibration_time) pause ();
+
+            int64_t const tsc_end = tsc ();
+
+            double const r = static_cast<double> (tsc_end - tsc_start) / (t - t_start);
+            LOG_trace1 << "calibrated TSC at " << r << " tick(s)/ns";
+
+            return r;
+        }();
+
+    return g_ticks_per_ns;
+}
 
 } // end of 'mc'
 } // end of namespace
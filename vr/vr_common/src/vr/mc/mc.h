@@ -1,6 +1,9 @@
 #pragma once
 
 #include "vr/macros.h"
+#include "vr/types.h"
+
+#include <x86intrin.h>
 
 //----------------------------------------------------------------------------
 namespace vr
@@ -42,6 +45,22 @@ pause ()
 extern void
 pause (int64_t const repeat);
 
+//............................................................................
+/**
+ * @return current TSC value (not serializing, meant for cheap cycle accounting)
+ */
+VR_FORCEINLINE int64_t
+tsc ()
+{
+    return __rdtsc ();
+}
+
+/**
+ * @return TSC ticks per nanosecond [calibrated against the realtime clock on first use]
+ */
+extern double
+tsc_ticks_per_ns ();
+
 //............................................................................
 
 } // end of 'mc'
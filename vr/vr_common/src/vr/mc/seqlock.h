@@ -0,0 +1,135 @@
+#pragma once
+
+#include "vr/asserts.h"
+#include "vr/mc/mc.h"
+#include "vr/util/classes.h"
+
+#include <type_traits>
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace mc
+{
+/**
+ * a 'T' value published by a single writer to any number of readers via a
+ * sequence counter that is odd while a write is in progress
+ *
+ * the writer never waits for readers; a reader copies the value out and retries
+ * if it has observed a write in progress or one completed while it was copying
+ *
+ * like @ref lf_spsc_buffer, this relies on x86-TSO (stores are not reordered with
+ * other stores, loads are not reordered with other loads) and needs no atomic ops
+ * or mfence, only compiler fences
+ *
+ * @note 'T' must be trivially copyable (it is copied with memcpy)
+ */
+template<typename T>
+class seqlock final: noncopyable
+{
+    private: // ..............................................................
+
+        vr_static_assert (std::is_trivially_copyable<T>::value);
+
+    public: // ...............................................................
+
+        using value_type    = T;
+        using version_type  = int64_t;
+
+
+        seqlock ()
+        {
+            __builtin_memset (& m_value, 0, sizeof (m_value)); // readers may see this before the first write
+        }
+
+        // ACCESSORs:
+
+        /**
+         * @return version of the most recent write (even if no write is in progress,
+         *         0 if there have been no writes)
+         */
+        VR_FORCEINLINE version_type version () const
+        {
+            return volatile_cast (m_version);
+        }
+
+        /**
+         * @param out [set to a consistent copy of the value if returning 'true', clobbered otherwise]
+         * @param version [set to the version of 'out' if returning 'true']
+         *
+         * @return 'false' if a write was in progress or completed during the copy
+         */
+        VR_FORCEINLINE bool try_read (T & out, version_type & version) const
+        {
+            version_type const v = volatile_cast (m_version);
+            if (VR_UNLIKELY (v & 1))
+                return false;
+
+            compiler_fence ();
+            __builtin_memcpy (& out, & m_value, sizeof (T));
+            compiler_fence ();
+
+            version = v;
+            return (volatile_cast (m_version) == v);
+        }
+
+        /**
+         * spins until 'out' is set to a consistent copy of the value
+         *
+         * @return version of 'out'
+         */
+        VR_FORCEINLINE version_type read (T & out) const
+        {
+            version_type v;
+
+            while (VR_UNLIKELY (! try_read (out, v)))
+            {
+                pause ();
+            }
+
+            return v;
+        }
+
+        // MUTATORs:
+
+        /**
+         * update the value in place by invoking 'f (T &)', bracketed by version updates
+         *
+         * @note must only be called by the (single) writer
+         *
+         * @return version of the new value
+         */
+        template<typename F>
+        VR_FORCEINLINE version_type write (F && f)
+        {
+            version_type const v = m_version; // [owned by the writer]
+
+            volatile_cast (m_version) = v + 1;
+            compiler_fence ();
+            {
+                f (m_value);
+            }
+            compiler_fence ();
+            volatile_cast (m_version) = v + 2;
+
+            return (v + 2);
+        }
+
+        /**
+         * @see write()
+         */
+        VR_FORCEINLINE version_type store (T const & value)
+        {
+            return write ([& value](T & dst) { dst = value; });
+        }
+
+    private: // ..............................................................
+
+        version_type m_version { };
+        T m_value;
+
+}; // end of class
+
+} // end of 'mc'
+} // end of namespace
+//----------------------------------------------------------------------------
@@ -0,0 +1,205 @@
+
+#include "vr/mc/seqlock.h"
+#include "vr/mc/spinflag.h"
+
+#include "vr/test/mc.h"
+#include "vr/test/utility.h"
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace mc
+{
+//............................................................................
+//............................................................................
+namespace
+{
+
+using stop_flag             = mc::spinflag<true>;
+
+//............................................................................
+/*
+ * a value large enough to span several cache lines, with all words equal
+ * (so that a torn read is easy to detect)
+ */
+struct record
+{
+    int64_t m_data [40];
+
+}; // end of class
+
+using value_type            = seqlock<record>;
+
+//............................................................................
+
+struct writer
+{
+    writer (value_type & v, int64_t const repeats, stop_flag & sf) :
+        m_v { v },
+        m_repeats { repeats },
+        m_stop_flag { sf }
+    {
+    }
+
+    void operator() ()
+    {
+        int64_t r { };
+        while (! m_stop_flag.is_raised () && (r < m_repeats))
+        {
+            ++ r;
+
+            m_v.write ([r](record & dst)
+                {
+                    for (int64_t & d : dst.m_data) d = r;
+                });
+        }
+
+        m_stop_flag.raise (); // tell readers we're done
+        m_r_completed = r;
+    }
+
+    value_type & m_v;
+    int64_t const m_repeats;
+    int64_t m_r_completed { };
+    stop_flag & m_stop_flag;
+
+}; // end of class
+
+struct reader
+{
+    reader (value_type const & v, stop_flag & sf) :
+        m_v { v },
+        m_stop_flag { sf }
+    {
+    }
+
+    void operator() ()
+    {
+        try
+        {
+            record out;
+            value_type::version_type v_last { };
+
+            while (! m_stop_flag.is_raised ())
+            {
+                value_type::version_type const v = m_v.read (out);
+
+                check_ge (v, v_last);
+                check_zero (v & 1);
+
+                for (int64_t const d : out.m_data)
+                {
+                    check_eq (d, out.m_data [0]); // not torn
+                }
+                check_eq (2 * out.m_data [0], v); // the writer writes 'r' as the r-th value
+
+                if (v != v_last) ++ m_changes;
+                v_last = v;
+
+                ++ m_reads;
+            }
+        }
+        catch (...)
+        {
+            m_stop_flag.raise ();
+            m_failure = std::current_exception ();
+        }
+        LOG_info << "reader DONE [reads: " << m_reads << ", changes seen: " << m_changes << ']';
+    }
+
+    value_type const & m_v;
+    int64_t m_reads { };
+    int64_t m_changes { };
+    std::exception_ptr m_failure { };
+    stop_flag & m_stop_flag;
+
+}; // end of class
+
+} // end of anonymous
+//............................................................................
+//............................................................................
+
+TEST (seqlock, sniff)
+{
+    value_type v { };
+
+    ASSERT_EQ (v.version (), 0);
+
+    record out;
+    value_type::version_type version { -1 };
+
+    ASSERT_TRUE (v.try_read (out, version));
+    EXPECT_EQ (version, 0);
+    EXPECT_EQ (out.m_data [0], 0); // zero-initialized
+
+    for (int64_t r = 1; r < 5; ++ r)
+    {
+        record in;
+        for (int64_t & d : in.m_data) d = r;
+
+        ASSERT_EQ (v.store (in), 2 * r);
+        ASSERT_EQ (v.version (), 2 * r);
+
+        ASSERT_EQ (v.read (out), 2 * r);
+        EXPECT_EQ (out.m_data [0], r);
+        EXPECT_EQ (out.m_data [39], r);
+    }
+
+    // a read overlapping with a write should fail:
+
+    v.write ([&](record & dst)
+        {
+            ASSERT_FALSE (v.try_read (out, version));
+            ASSERT_EQ (v.version () & 1, 1);
+
+            dst.m_data [0] = -1;
+        });
+
+    ASSERT_TRUE (v.try_read (out, version));
+    EXPECT_EQ (version, 10);
+    EXPECT_EQ (out.m_data [0], -1);
+}
+//............................................................................
+
+TEST (seqlock, multicore)
+{
+    value_type v { };
+
+    int64_t const repeats       = 2000000;
+
+    stop_flag sf { };
+
+    test::task_container tasks { };
+
+    tasks.add ({ reader { v, sf }, 1 }, "reader.0");
+    tasks.add ({ reader { v, sf }, 2 }, "reader.1");
+    tasks.add ({ writer { v, repeats, sf }, 3 }, "writer");
+
+    tasks.start ();
+    tasks.stop ();
+
+    for (std::string const name : { "reader.0", "reader.1" })
+    {
+        reader const & r = tasks [name];
+
+        if (r.m_failure)
+        {
+            try
+            {
+                std::rethrow_exception (r.m_failure);
+            }
+            catch (std::exception const & e)
+            {
+                ADD_FAILURE () << name << ": " << exc_info (e);
+            }
+        }
+        EXPECT_GT (r.m_reads, 0) << name;
+    }
+
+    writer const & w = tasks ["writer"];
+    EXPECT_EQ (w.m_r_completed, repeats);
+}
+
+} // end of 'mc'
+} // end of namespace
+//----------------------------------------------------------------------------
@@ -32,6 +32,13 @@ class step_ctl
          */
         virtual VR_ASSUME_COLD void report_failure (std::exception_ptr const & eptr) VR_NOEXCEPT    = 0;
 
+        /**
+         * un-park whatever is running 'step' (if it is parked)
+         */
+        virtual void wake (steppable const * const step) VR_NOEXCEPT
+        {
+        }
+
     protected: // ............................................................
 
         friend class step_runnable; // grant access to 'sequencer()'
@@ -1,6 +1,8 @@
 
 #include "vr/mc/step_runnable.h"
 
+#include "vr/mc/atomic.h"
+#include "vr/settings.h"
 #include "vr/startable.h"
 #include "vr/util/di/container_barrier.h"
 
@@ -8,15 +10,52 @@
 
 #include <algorithm>
 
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
 //----------------------------------------------------------------------------
 namespace vr
 {
 namespace mc
 {
 //............................................................................
+//............................................................................
+namespace
+{
+
+VR_FORCEINLINE int64_t
+ns_to_tsc (timestamp_t const ns)
+{
+    return static_cast<int64_t> (ns * tsc_ticks_per_ns ());
+}
+
+} // end of anonymous
+//............................................................................
+//............................................................................
+
+idle_policy::idle_policy (settings const & cfg)
+{
+    // [member defaults are in effect at this point]
+
+    m_backoff = cfg.value ("backoff", m_backoff);
+    m_spin_for = cfg.value ("spin_for", m_spin_for);
+    m_pause_for = cfg.value ("pause_for", m_pause_for);
+    m_wait_for = cfg.value ("wait_for", m_wait_for);
+    m_park_timeout = cfg.value ("park_timeout", m_park_timeout);
+    m_report_interval = cfg.value ("report_interval", m_report_interval);
+
+    check_nonnegative (m_spin_for);
+    check_nonnegative (m_pause_for);
+    check_nonnegative (m_wait_for);
+    check_positive (m_park_timeout);
+}
+//............................................................................
+//............................................................................
 
 std::unique_ptr<step_runnable>
-step_runnable::create (int32_t const PU, std::string const & name, step_ctl & ctl, std::vector<steppable *> const & steps)
+step_runnable::create (int32_t const PU, std::string const & name, step_ctl & ctl, std::vector<steppable *> const & steps,
+                       idle_policy const & policy)
 {
     switch (steps.size ())
     {
@@ -28,7 +67,7 @@ step_runnable::create (int32_t const PU, std::string const & name, step_ctl & ct
             std::array<steppable *, LENGTH > a { }; \
             std::copy (steps.begin (), steps.end (), a.begin ()); \
             \
-            return std::unique_ptr<step_runnable> { new step_runnable_< LENGTH > { PU, name, ctl, std::move (a) } }; /* last use of 'a' */ \
+            return std::unique_ptr<step_runnable> { new step_runnable_< LENGTH > { PU, name, ctl, policy, std::move (a) } }; /* last use of 'a' */ \
         } \
         /* */
 
@@ -42,11 +81,25 @@ step_runnable::create (int32_t const PU, std::string const & name, step_ctl & ct
 }
 //............................................................................
 
-step_runnable::step_runnable (int32_t const PU, std::string const & name, step_ctl & ctl) :
+step_runnable::step_runnable (int32_t const PU, std::string const & name, step_ctl & ctl, idle_policy const & policy, int32_t const length) :
     bound_runnable (PU, name),
-    m_external_ctl { ctl }
+    m_external_ctl { ctl },
+    m_step_stats { new impl::step_stats [length] },
+    m_policy { policy },
+    m_length { length },
+    m_accounting { policy.accounting () },
+    m_spin_cycles { policy.m_backoff ? ns_to_tsc (policy.m_spin_for) : std::numeric_limits<int64_t>::max () }, // never back off if not enabled
+    m_pause_cycles { m_accounting ? ns_to_tsc (policy.m_spin_for + policy.m_pause_for) : 0 },
+    m_wait_cycles { m_accounting ? ns_to_tsc (policy.m_spin_for + policy.m_pause_for + policy.m_wait_for) : 0 },
+    m_report_cycles { m_accounting ? ns_to_tsc (policy.m_report_interval) : 0 }
 {
     LOG_trace1 << print (bound_runnable::name ()) << ": configured to bind to PU " << PU;
+
+    if (policy.m_backoff)
+    {
+        LOG_trace1 << print (bound_runnable::name ()) << ": idle backoff after " << policy.m_spin_for << " ns (pause " << policy.m_pause_for
+                   << " ns, wait " << policy.m_wait_for << " ns, park timeout " << policy.m_park_timeout << " ns)";
+    }
 }
 //............................................................................
 
@@ -161,6 +214,7 @@ step_runnable::request_stop (steppable const * const requestor) VR_NOEXCEPT
     if (requestor) LOG_trace1 << "stop request from " << util::instance_name (requestor);
 
     bound_runnable::stop_flag ().raise ();
+    wake (requestor); // in case we're parked
 
     m_external_ctl.request_stop (requestor); // delegate
 }
@@ -171,6 +225,27 @@ step_runnable::report_failure (std::exception_ptr const & eptr) VR_NOEXCEPT
     m_external_ctl.report_failure (eptr); // delegate
 }
 
+void
+step_runnable::wake (steppable const * const step) VR_NOEXCEPT
+{
+    if (! m_policy.m_backoff) return;
+
+    // Dekker-style against 'm_backing_off': either we see it set or the runnable's next pass
+    // over its steps sees whatever the caller has published ahead of this call:
+
+    __atomic_thread_fence (__ATOMIC_SEQ_CST);
+
+    if (__atomic_load_n (& m_backing_off, __ATOMIC_RELAXED)) // [only a shared read of the runnable's line otherwise]
+    {
+        __atomic_add_fetch (& m_wake_word, 1, __ATOMIC_SEQ_CST); // [also a full fence: Dekker-style against 'm_parked']
+
+        if (__atomic_load_n (& m_parked, __ATOMIC_SEQ_CST))
+        {
+            ::syscall (SYS_futex, & m_wake_word, FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+        }
+    }
+}
+
 util::di::container_barrier &
 step_runnable::sequencer ()
 {
@@ -178,6 +253,119 @@ step_runnable::sequencer ()
 }
 //............................................................................
 
+void
+step_runnable::report_stats (int64_t const tsc)
+{
+    int64_t const window = (tsc - m_report_start_tsc);
+
+    if ((m_report_cycles > 0) && (window > 0))
+    {
+        double const tpns = tsc_ticks_per_ns ();
+
+        LOG_info << print (name ()) << ": " << static_cast<int64_t> (window / tpns / 1000) << " us window, backoff "
+                 << static_cast<int64_t> (m_backoff_cycles / tpns / 1000) << " us, " << m_park_count << " park(s)";
+
+        for (int32_t i = 0; i < m_length; ++ i)
+        {
+            impl::step_stats const & ss = m_step_stats [i];
+
+            int64_t const busy = ss.m_cycles [false];
+            int64_t const idle = ss.m_cycles [true];
+
+            LOG_info << "  step " << i << ": busy " << (100.0 * busy / window) << "% (" << ss.m_count [false] << " step(s)), idle "
+                     << (100.0 * idle / window) << "% (" << ss.m_count [true] << " step(s))";
+        }
+    }
+
+    // start a new window:
+
+    std::fill (& m_step_stats [0], & m_step_stats [0] + m_length, impl::step_stats { });
+    m_backoff_cycles = 0;
+    m_park_count = 0;
+
+    m_report_start_tsc = tsc;
+    if (m_report_cycles > 0) m_next_report_tsc = tsc + m_report_cycles;
+}
+//............................................................................
+
+int64_t
+step_runnable::backoff (int64_t const idle_for, int64_t const tsc, int32_t const wake_word)
+{
+    if (m_policy.m_backoff)
+    {
+        if (! m_backing_off)
+        {
+            // advertise to 'wake ()'rs and make one more pass before waiting on 'm_wake_word'
+            // (that pass then snapshots the wake word, see 'run_accounted()'):
+
+            __atomic_store_n (& m_backing_off, true, __ATOMIC_RELAXED);
+            __atomic_thread_fence (__ATOMIC_SEQ_CST); // [pairs with the fence in 'wake ()']
+
+            return tsc;
+        }
+
+        if (idle_for < m_pause_cycles)
+        {
+            pause ();
+        }
+        else if (idle_for < m_wait_cycles)
+        {
+#       if defined (__WAITPKG__)
+
+            _umonitor (& m_wake_word);
+            if (__atomic_load_n (& m_wake_word, __ATOMIC_ACQUIRE) == wake_word) // re-check after arming the monitor
+            {
+                _umwait (0, m_idle_start_tsc + m_wait_cycles); // C0.2 until the end of this stage [further bounded by the OS limit]
+            }
+
+#       else
+
+            pause (16);
+
+#       endif // __WAITPKG__
+        }
+        else
+        {
+            park (wake_word);
+        }
+
+        int64_t const tsc_end = mc::tsc ();
+        m_backoff_cycles += (tsc_end - tsc);
+
+        if (__atomic_load_n (& m_wake_word, __ATOMIC_ACQUIRE) != wake_word) // woken: start spinning again
+        {
+            m_idle_start_tsc = 0;
+            __atomic_store_n (& m_backing_off, false, __ATOMIC_RELAXED);
+        }
+
+        return tsc_end; // don't charge backoff time to the first step
+    }
+
+    return tsc;
+}
+
+void
+step_runnable::park (int32_t const wake_word)
+{
+    timespec const timeout { static_cast<time_t> (m_policy.m_park_timeout / _1_second ()), static_cast<long> (m_policy.m_park_timeout % _1_second ()) };
+
+    __atomic_store_n (& m_parked, true, __ATOMIC_SEQ_CST); // [full fence: Dekker-style against 'm_wake_word']
+    {
+        if (! bound_runnable::stop_flag ().is_raised ())
+        {
+            bool const rcu_online = (m_rcu_mode != rcu_::none);
+            if (rcu_online) rcu_thread_offline (); // don't hold up grace periods while parked
+
+            ::syscall (SYS_futex, & m_wake_word, FUTEX_WAIT_PRIVATE, wake_word, & timeout, nullptr, 0); // [EAGAIN if woken since the last pass started]
+            ++ m_park_count;
+
+            if (rcu_online) rcu_thread_online ();
+        }
+    }
+    __atomic_store_n (& m_parked, false, __ATOMIC_RELEASE);
+}
+//............................................................................
+
 void
 step_runnable::set_step_ctl (steppable * const steps [], int32_t const length, step_ctl & ctl)
 {
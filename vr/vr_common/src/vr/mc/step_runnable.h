@@ -6,6 +6,7 @@
 #include "vr/mc/rcu.h"
 #include "vr/mc/step_ctl.h"
 #include "vr/mc/steppable.h"
+#include "vr/settings_fwd.h"
 #include "vr/sys/os.h"
 #include "vr/util/logging.h"
 
@@ -19,6 +20,20 @@ namespace mc
 namespace impl
 {
 
+struct step_stats final
+{
+    VR_FORCEINLINE void add (bool const idle, int64_t const cycles)
+    {
+        m_cycles [idle] += cycles;
+        ++ m_count [idle];
+    }
+
+    int64_t m_cycles [2] { };   // [busy, idle]
+    int64_t m_count [2] { };    // [busy, idle]
+
+}; // end of class
+//............................................................................
+
 template<int32_t I, int32_t I_LIMIT>
 struct step_invoker
 {
@@ -30,39 +45,147 @@ struct step_invoker
         step_invoker<(I + 1), I_LIMIT>::evaluate (steps); // recurse
     }
 
+    /*
+     * @param tsc [in/out] TSC at the start of step 'I', set to TSC at the end of the last step
+     * @return 'true' iff all steps starting with 'I' reported being idle
+     */
+    static VR_FORCEINLINE bool evaluate (std::array<steppable *, I_LIMIT> const & steps, step_stats * const stats, int64_t & tsc)
+    {
+        steppable & s = (* steps [I]);
+
+        s.step ();
+
+        int64_t const tsc_end = mc::tsc ();
+        bool const idle = s.m_idle;
+        s.m_idle = false;
+
+        stats [I].add (idle, tsc_end - tsc);
+        tsc = tsc_end;
+
+        bool const rest_idle = step_invoker<(I + 1), I_LIMIT>::evaluate (steps, stats, tsc); // recurse
+
+        return (idle & rest_idle);
+    }
+
 }; // end of master
 
 template<int32_t I_LIMIT> // end of recursion
 struct step_invoker<I_LIMIT, I_LIMIT>
 {
     static VR_FORCEINLINE void evaluate (std::array<steppable *, I_LIMIT> const &)  { }
+    static VR_FORCEINLINE bool evaluate (std::array<steppable *, I_LIMIT> const &, step_stats * const, int64_t &)    { return true; }
 
 }; // end of specialization
 
 } // end of 'impl'
 //............................................................................
 //............................................................................
+/**
+ * what a @ref step_runnable does when all of its steps report being idle
+ * (see @ref steppable::report_idle()); the default is to keep spinning and do no
+ * cycle accounting, i.e. to behave exactly as before this policy existed
+ *
+ * when 'backoff' is enabled, idle time (measured from the first all-idle pass over
+ * the steps) moves the runnable through these stages:
+ *
+ *  - [0, spin_for): tight spin;
+ *  - [spin_for, + pause_for): one 'pause' per pass;
+ *  - [.., + wait_for): 'umwait' on the runnable's wake word (if the CPU has WAITPKG, a 'pause' loop otherwise);
+ *  - after that: futex park for up to 'park_timeout' at a time;
+ *
+ * any step making progress resets this back to a tight spin; a parked runnable
+ * also resumes when any of its steps is @ref steppable::wake()d or a stop is requested
+ *
+ * @note all times are in ns
+ */
+struct idle_policy final
+{
+    idle_policy ()  = default;
+    idle_policy (settings const & cfg);
+
+    bool accounting () const
+    {
+        return (m_backoff || (m_report_interval > 0));
+    }
+
+
+    bool m_backoff { false };
+    timestamp_t m_spin_for { 10 * _1_microsecond () };
+    timestamp_t m_pause_for { 100 * _1_microsecond () };
+    timestamp_t m_wait_for { _1_millisecond () };
+    timestamp_t m_park_timeout { _1_millisecond () };
+    timestamp_t m_report_interval { }; // if positive, log per-step cycle accounting at (about) this interval
+
+}; // end of class
+//............................................................................
 
 class step_runnable: public bound_runnable, public step_ctl
 {
     public: // ...............................................................
 
         static VR_ASSUME_COLD std::unique_ptr<step_runnable> create (int32_t const PU, std::string const & name, step_ctl & ctl,
-                                                                     std::vector<steppable *> const & steps);
+                                                                     std::vector<steppable *> const & steps,
+                                                                     idle_policy const & policy = { });
 
 
         VR_ASSUME_COLD void request_stop (); // used by the container/external ctl
 
     protected: // ............................................................
 
-        VR_ASSUME_COLD step_runnable (int32_t const PU, std::string const & name, step_ctl & ctl);
+        VR_ASSUME_COLD step_runnable (int32_t const PU, std::string const & name, step_ctl & ctl, idle_policy const & policy, int32_t const length);
 
         // step_ctl:
 
         VR_ASSUME_COLD void request_stop (steppable const * const requestor) VR_NOEXCEPT final override;
         VR_ASSUME_COLD void report_failure (std::exception_ptr const & eptr) VR_NOEXCEPT final override;
+        void wake (steppable const * const step) VR_NOEXCEPT final override;
         util::di::container_barrier & sequencer () final override;
 
+        // cycle accounting and idle backoff:
+
+        /*
+         * @return wake word value to pass to 'after_pass()' [must be read before the pass over the steps]
+         */
+        VR_FORCEINLINE int32_t before_pass () const
+        {
+            return __atomic_load_n (& m_wake_word, __ATOMIC_ACQUIRE);
+        }
+
+        /*
+         * @param tsc TSC at the end of the last pass over the steps
+         * @param wake_word as returned by 'before_pass()' for this pass
+         * @return TSC to use as the start of the next pass
+         */
+        VR_FORCEINLINE int64_t after_pass (bool const all_idle, int64_t const tsc, int32_t const wake_word)
+        {
+            if (VR_UNLIKELY (tsc >= m_next_report_tsc)) report_stats (tsc);
+
+            if (! all_idle)
+            {
+                m_idle_start_tsc = 0;
+                if (VR_UNLIKELY (m_backing_off)) __atomic_store_n (& m_backing_off, false, __ATOMIC_RELAXED);
+
+                return tsc;
+            }
+
+            if (! m_idle_start_tsc)
+            {
+                m_idle_start_tsc = tsc;
+                return tsc;
+            }
+
+            int64_t const idle_for = (tsc - m_idle_start_tsc);
+            if (idle_for < m_spin_cycles)
+                return tsc;
+
+            return backoff (idle_for, tsc, wake_word);
+        }
+
+        VR_ASSUME_COLD void report_stats (int64_t const tsc); // also starts a new report window
+
+        VR_NOINLINE int64_t backoff (int64_t const idle_for, int64_t const tsc, int32_t const wake_word);
+        void park (int32_t const wake_word);
+
 
         VR_ASSUME_COLD bool rcu_register (steppable * const steps [], int32_t const length);
         VR_ASSUME_COLD void rcu_unregister ();
@@ -75,6 +198,23 @@ class step_runnable: public bound_runnable, public step_ctl
 
         step_ctl & m_external_ctl;
         rcu_::enum_t m_rcu_mode { rcu_::none };
+        std::unique_ptr<impl::step_stats []> const m_step_stats; // [length], current report window
+        idle_policy const m_policy;
+        int32_t const m_length;
+        bool const m_accounting;
+        // backoff thresholds, converted to TSC ticks:
+        int64_t const m_spin_cycles;
+        int64_t const m_pause_cycles;   // cumulative, i.e. "spin + pause"
+        int64_t const m_wait_cycles;    // cumulative, i.e. "spin + pause + wait"
+        int64_t const m_report_cycles;
+        int64_t m_next_report_tsc { std::numeric_limits<int64_t>::max () }; // set on thread start if reporting is enabled
+        int64_t m_report_start_tsc { };
+        int64_t m_idle_start_tsc { };   // zero if not in an all-idle streak
+        int64_t m_backoff_cycles { };   // current report window
+        int64_t m_park_count { };       // current report window
+        VR_ALIGNAS_CL int32_t m_wake_word { };  // futex/umwait word, bumped by 'wake ()' while 'm_backing_off'
+        int32_t m_backing_off { false };        // set (ahead of one more pass over the steps) before the runnable can wait on 'm_wake_word'
+        int32_t m_parked { false };             // set while in (or about to enter) a futex wait
 
 }; // end of class
 //............................................................................
@@ -110,8 +250,8 @@ class step_runnable_ final: public step_runnable
 
     public: // ...............................................................
 
-        VR_ASSUME_COLD step_runnable_ (int32_t const PU, std::string const & name, step_ctl & ctl, std::array<steppable *, LENGTH> && steps) :
-            step_runnable (PU, name, ctl),
+        VR_ASSUME_COLD step_runnable_ (int32_t const PU, std::string const & name, step_ctl & ctl, idle_policy const & policy, std::array<steppable *, LENGTH> && steps) :
+            step_runnable (PU, name, ctl, policy, LENGTH),
             m_steps { std::move (steps) }
         {
             super::set_step_ctl (& m_steps [0], LENGTH, * this); // set ourselves as the step controller for 'steps' to be able to interpose
@@ -124,6 +264,8 @@ class step_runnable_ final: public step_runnable
             super::bind ();
             bool const use_rcu = super::rcu_register (& m_steps [0], LENGTH);
             {
+                util::log_async_scope const _ { }; // no-op unless async logging is enabled via 'VR_ENV_LOG_ASYNC'
+
                 LOG_info << "PU " << sys::cpuid () << " running " << print (super::name ());
 
                 if (super::start_steps (& m_steps [0], LENGTH)) // after binding
@@ -134,12 +276,10 @@ class step_runnable_ final: public step_runnable
 
                     try
                     {
-                        while (VR_UNLIKELY (! stop_flag ().is_raised ())) // spin on a cache line that's local to this PU (and only shared with at most one other)
-                        {
-                            impl::step_invoker<0, LENGTH>::evaluate (m_steps);
-
-                            if (use_rcu) rcu_quiescent_state (); // we're using QSBR flavor of RCU
-                        }
+                        if (super::m_accounting)
+                            run_accounted (use_rcu);
+                        else
+                            run (use_rcu);
 
                         LOG_info << "DONE: " << print (super::name ());
                     }
@@ -163,6 +303,40 @@ class step_runnable_ final: public step_runnable
 
     private: // ..............................................................
 
+        VR_FORCEINLINE void run (bool const use_rcu)
+        {
+            while (VR_UNLIKELY (! stop_flag ().is_raised ())) // spin on a cache line that's local to this PU (and only shared with at most one other)
+            {
+                impl::step_invoker<0, LENGTH>::evaluate (m_steps);
+
+                if (use_rcu) rcu_quiescent_state (); // we're using QSBR flavor of RCU
+            }
+        }
+
+        VR_FORCEINLINE void run_accounted (bool const use_rcu)
+        {
+            impl::step_stats * const stats = super::m_step_stats.get ();
+
+            int64_t tsc = mc::tsc ();
+
+            super::m_report_start_tsc = tsc;
+            if (super::m_report_cycles > 0) super::m_next_report_tsc = tsc + super::m_report_cycles;
+
+            while (VR_UNLIKELY (! stop_flag ().is_raised ())) // spin on a cache line that's local to this PU (and only shared with at most one other)
+            {
+                int32_t const wake_word = super::before_pass (); // a 'wake ()' from here on will interrupt any backoff after this pass
+
+                bool const all_idle = impl::step_invoker<0, LENGTH>::evaluate (m_steps, stats, tsc);
+
+                if (use_rcu) rcu_quiescent_state (); // we're using QSBR flavor of RCU
+
+                tsc = super::after_pass (all_idle, tsc, wake_word);
+            }
+
+            super::report_stats (mc::tsc ()); // final (partial) window
+        }
+
+
         std::array<steppable *, LENGTH> const m_steps; // [non-owning]
 
 }; // end of class
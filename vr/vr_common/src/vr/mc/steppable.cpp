@@ -22,6 +22,13 @@ steppable::request_stop () VR_NOEXCEPT
         LOG_error << util::instance_name (this) << ": can't request step: no link to 'step_ctl'";
 }
 
+void
+steppable::wake () VR_NOEXCEPT
+{
+    if (VR_LIKELY (m_step_ctl != nullptr))
+        m_step_ctl->wake (this);
+}
+
 } // end of 'mc'
 } // end of namespace
 //----------------------------------------------------------------------------
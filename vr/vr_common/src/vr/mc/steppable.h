@@ -1,6 +1,7 @@
 #pragma once
 
 #include "vr/macros.h" // VR_ASSUME_HOT
+#include "vr/types.h"
 
 //----------------------------------------------------------------------------
 namespace vr
@@ -9,6 +10,12 @@ namespace mc
 {
 class step_runnable; // forward
 class step_ctl; // forward
+
+namespace impl
+{
+template<int32_t I, int32_t I_LIMIT> struct step_invoker; // forward
+
+} // end of 'impl'
 /**
  */
 class steppable
@@ -19,8 +26,29 @@ class steppable
 
         virtual VR_ASSUME_HOT void step ()  = 0;
 
+        /**
+         * if the 'step_runnable' running this step has backed off because all of its
+         * steps have been idle (see @ref report_idle()), make it resume spinning
+         *
+         * [meant to be invoked by producers of this step's input, from any thread;
+         * only a fence and a load unless the runnable is backing off]
+         */
+        void wake () VR_NOEXCEPT;
+
     protected: // ............................................................
 
+        /**
+         * a step that can tell that it has made no progress (had no input to consume, etc)
+         * should call this from its 'step()'
+         *
+         * [steps that never call this are accounted as always busy and hence never let
+         * their 'step_runnable' back off]
+         */
+        VR_FORCEINLINE void report_idle () VR_NOEXCEPT
+        {
+            m_idle = true;
+        }
+
         /**
          * inform the "powers that be" that we'd like to stop running
          *
@@ -32,8 +60,10 @@ class steppable
     private: // ..............................................................
 
         friend class step_runnable;
+        template<int32_t, int32_t> friend struct impl::step_invoker;
 
         step_ctl * m_step_ctl { }; // this is guaranteed to be set before the first 'step()'
+        bool m_idle { false }; // set by 'report_idle()', consumed by 'step_runnable' (if it does cycle accounting)
 
 }; // end of class
 //............................................................................
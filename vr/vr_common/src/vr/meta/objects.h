@@ -101,6 +101,7 @@ struct field_def_mark   { };
 struct fdef_mark        { };
 struct field_desc_mark  { };
 struct elide_mark       { };
+struct cold_mark        { };
 
 } // end of 'impl'
 //............................................................................
@@ -119,6 +120,18 @@ struct elide: public impl::elide_mark
 {
     static constexpr bool enabled ()    { return ENABLED; }
 
+}; // end of class
+
+/**
+ * marks a field as "cold", i.e. to be split off into a separate struct (see
+ * @ref hot_schema_t and @ref cold_schema_t) by containers that care about
+ * cache line density of frequently accessed ("hot") fields
+ */
+template<bool ENABLED = true> // note: parameter provided to support uniform mark use in templated code
+struct cold: public impl::cold_mark
+{
+    static constexpr bool enabled ()    { return ENABLED; }
+
 }; // end of class
 //............................................................................
 //............................................................................
@@ -126,26 +139,28 @@ namespace impl // resume 'impl'
 {
 
 using elide_default     = elide<false>;
+using cold_default      = cold<false>;
 
 //............................................................................
 /*
  * non-variadic normalized form of 'fdef_<>'
  */
-template<typename /* field_def<> */FIELD_DEF, bool ELIDE>
+template<typename /* field_def<> */FIELD_DEF, bool ELIDE, bool COLD = false>
 struct field_desc: public field_desc_mark // base used only for static [concept] checking
 {
     using field_def_type                    = FIELD_DEF;
     static constexpr bool elide ()          { return ELIDE; }
+    static constexpr bool cold ()           { return COLD; }
 
     using field_value_type                  = typename FIELD_DEF::value_type;
     using field_tag                         = typename FIELD_DEF::tag;
 
 }; // end of class
 
-template<typename /* field_def<> */FIELD_DEF, bool ELIDE, int32_t DECL_INDEX>
-struct field_desc_and_index final: public field_desc<FIELD_DEF, ELIDE>
+template<typename /* field_def<> */FIELD_DEF, bool ELIDE, bool COLD, int32_t DECL_INDEX>
+struct field_desc_and_index final: public field_desc<FIELD_DEF, ELIDE, COLD>
 {
-    using super                             = field_desc<FIELD_DEF, ELIDE>;
+    using super                             = field_desc<FIELD_DEF, ELIDE, COLD>;
     static constexpr int32_t decl_index ()  { return DECL_INDEX; }
 
 }; // end of class
@@ -159,6 +174,13 @@ struct elided_predicate
 {
      static constexpr bool value    = FIELD_DESC::elide ();
 
+}; // end of predicate
+
+template<typename /* field_desc[_and_index]<> */FIELD_DESC>
+struct cold_predicate
+{
+     static constexpr bool value    = (FIELD_DESC::cold () && ! FIELD_DESC::elide ());
+
 }; // end of predicate
 //............................................................................
 
@@ -183,7 +205,7 @@ struct make_field_desc
     static_assert (std::is_base_of<fdef_mark, FDEF>::value, "'FIELD' must be 'field<...>'");
 
     using field_def_type    = typename fdef_to_field_def<FDEF, FDEF::has_field_def ()>::type;
-    using type              = field_desc<field_def_type, FDEF::elide ()>;
+    using type              = field_desc<field_def_type, FDEF::elide (), FDEF::cold ()>;
 
 }; // end of mp metafunction
 
@@ -197,7 +219,7 @@ struct make_field_desc_and_index
     static_assert (std::is_base_of<field_desc_mark, FIELD_DESC>::value, "'FIELD_DESC' must be 'field_desc<...>'");
 
     using field_def_type    = typename FIELD_DESC::field_def_type;
-    using type              = field_desc_and_index<field_def_type, FIELD_DESC::elide (), FIELD_DECL_INDEX::value>;
+    using type              = field_desc_and_index<field_def_type, FIELD_DESC::elide (), FIELD_DESC::cold (), FIELD_DECL_INDEX::value>;
 
 }; // end of mp metafunction
 
@@ -224,7 +246,7 @@ struct make_schema_impl
 template<typename FIELD_DESC, typename TAG_set>
 struct materialize_field_desc_contained_in // used by 'select_fields_impl'
 {
-    using type          = field_desc<typename FIELD_DESC::field_def_type, (! bmp::mp_set_contains<TAG_set, typename FIELD_DESC::field_tag>::value)>;
+    using type          = field_desc<typename FIELD_DESC::field_def_type, (! bmp::mp_set_contains<TAG_set, typename FIELD_DESC::field_tag>::value), FIELD_DESC::cold ()>;
 
 }; // end of predicate
 
@@ -242,6 +264,29 @@ struct select_fields_impl
 
     using type          = bmp::mp_transform<materialize, FIELD_DESC_seq>;
 
+}; // end of metafunction
+//............................................................................
+
+template<typename FIELD_DESC, bool HOT>
+struct materialize_field_desc_in_part // used by 'split_schema_impl'
+{
+    using type          = field_desc<typename FIELD_DESC::field_def_type, (FIELD_DESC::elide () || (FIELD_DESC::cold () == HOT)), false>;
+
+}; // end of metafunction
+
+/*
+ * keep only hot ('HOT' == true) or cold ('HOT' == false) 'FIELD_DESC_seq' fields
+ */
+template<typename FIELD_DESC_seq, bool HOT>
+struct split_schema_impl
+{
+    static_assert (bmp::mp_is_list<FIELD_DESC_seq>::value, "'FIELD_DESC_seq' must be an mp11 list");
+
+    template<typename FIELD_DESC>
+    using materialize   = typename materialize_field_desc_in_part<FIELD_DESC, HOT>::type;
+
+    using type          = bmp::mp_transform<materialize, FIELD_DESC_seq>;
+
 }; // end of metafunction
 //............................................................................
 /*
@@ -775,8 +820,8 @@ struct field_offset_impl
 /**
  * allowed forms:
  *
- *  fdef_<T, TAG[, elide<...>]>
- *  fdef_<field_def<T, TAG>[, elide<...>]>
+ *  fdef_<T, TAG[, elide<...>][, cold<...>]>
+ *  fdef_<field_def<T, TAG>[, elide<...>][, cold<...>]>
  */
 template<typename ... Ts> // using a variadic form intentionally, for terser demangled names
 struct fdef_ final: public impl::fdef_mark
@@ -786,10 +831,11 @@ struct fdef_ final: public impl::fdef_mark
     using field_def_parm                        = util::find_derived_t<impl::field_def_mark, void, Ts ...>;
     static constexpr bool has_field_def ()      { return (! util::is_void<field_def_parm>::value); }
 
-    static_assert ((2 <= (arity + has_field_def ()) && (arity + has_field_def ()) <= 3),
-       "valid syntax is fdef_<T, TAG[, elide<...>]> and fdef_<field_def<T, TAG>[, elide<...>]>");
+    static_assert ((2 <= (arity + has_field_def ()) && (arity + has_field_def ()) <= 4),
+       "valid syntax is fdef_<T, TAG[, elide<...>][, cold<...>]> and fdef_<field_def<T, TAG>[, elide<...>][, cold<...>]>");
 
     static constexpr bool elide ()              { return util::find_derived_t<impl::elide_mark, impl::elide_default, Ts ...>::enabled (); }
+    static constexpr bool cold ()               { return util::find_derived_t<impl::cold_mark, impl::cold_default, Ts ...>::enabled (); }
 
 }; // end of class
 //............................................................................
@@ -807,6 +853,28 @@ using extend_schema_t       = typename impl::extend_schema_impl<FIELD_DESC_seq,
 template<typename FIELD_DESC_seq, typename ... TAGs>
 using select_fields_t       = typename impl::select_fields_impl<FIELD_DESC_seq, bmp::mp_list<TAGs ...>>::type;
 
+/**
+ * @note: cold fields are elided (and not removed from the schema)
+ */
+template<typename FIELD_DESC_seq>
+using hot_schema_t          = typename impl::split_schema_impl<FIELD_DESC_seq, true>::type;
+
+/**
+ * @note: hot fields are elided (and not removed from the schema)
+ */
+template<typename FIELD_DESC_seq>
+using cold_schema_t         = typename impl::split_schema_impl<FIELD_DESC_seq, false>::type;
+
+/**
+ * @return 'true' iff 'FIELD_DESC_seq' has at least one non-elided field marked 'cold<>'
+ */
+template<typename FIELD_DESC_seq>
+constexpr bool
+has_cold_fields ()
+{
+    return bmp::mp_any_of<FIELD_DESC_seq, impl::cold_predicate>::value;
+}
+
 template<typename ... FIELD_DEFs>
 using synthetic_meta_t      = typename impl::synthetic_meta<make_schema_t<FIELD_DEFs ...>>::type;
 
@@ -183,6 +183,55 @@ TEST (compact_struct, elided_fields)
 }
 //............................................................................
 
+TEST (compact_struct, cold_fields)
+{
+    using schema        = make_schema_t
+                        <
+                            fdef_<f0_field>,                                // hot by default
+                            fdef_<std::string,  f1, cold<>>,                // cold
+                            fdef_<int32_t,      f2, elide<>, cold<>>,       // elided (in both parts)
+                            fdef_<int64_t,      f3, cold<false>>,           // hot explicitly
+                            fdef_<fw_string8,   f4, cold<>, elide<false>>   // cold (option order doesn't matter)
+                        >;
+
+    vr_static_assert (has_cold_fields<schema> ());
+    vr_static_assert (! has_cold_fields<select_fields_t<schema, f0, f3>> ()); // elided cold fields don't count
+
+    using hot_type      = make_compact_struct_t<hot_schema_t<schema>>;
+    using cold_type     = make_compact_struct_t<cold_schema_t<schema>>;
+
+    vr_static_assert (has_field<f0, hot_type> ());
+    vr_static_assert (! (has_field<f1, hot_type> ()));
+    vr_static_assert (! (has_field<f2, hot_type> ()));
+    vr_static_assert (has_field<f3, hot_type> ());
+    vr_static_assert (! (has_field<f4, hot_type> ()));
+
+    vr_static_assert (! (has_field<f0, cold_type> ()));
+    vr_static_assert (has_field<f1, cold_type> ());
+    vr_static_assert (! (has_field<f2, cold_type> ()));
+    vr_static_assert (! (has_field<f3, cold_type> ()));
+    vr_static_assert (has_field<f4, cold_type> ());
+
+    vr_static_assert (sizeof (hot_type) == sizeof (int64_t) + sizeof (int64_t)); // f3 + f0 (padded)
+
+    // neither part has cold fields of its own:
+
+    vr_static_assert (! has_cold_fields<hot_schema_t<schema>> ());
+    vr_static_assert (! has_cold_fields<cold_schema_t<schema>> ());
+
+    // an unannotated schema is all hot:
+
+    using schema2       = make_schema_t
+                        <
+                            fdef_<int32_t,      f0>,
+                            fdef_<int64_t,      f1>
+                        >;
+
+    vr_static_assert (! has_cold_fields<schema2> ());
+    vr_static_assert ((std::is_same<make_compact_struct_t<hot_schema_t<schema2>>, make_compact_struct_t<schema2>>::value));
+}
+//............................................................................
+
 TEST (compact_struct, typesafe_enum_fields)
 {
     using schema        = make_schema_t
@@ -0,0 +1,198 @@
+
+#include "vr/stats/ddsketch.h"
+
+#include "vr/data/dataframe.h"
+#include "vr/util/logging.h"
+
+#include <algorithm>
+#include <limits>
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace stats
+{
+//............................................................................
+//............................................................................
+namespace
+{
+
+double
+check_relative_accuracy (double const relative_accuracy)
+{
+    check_positive (relative_accuracy);
+    check_lt (relative_accuracy, 1.0);
+
+    return relative_accuracy;
+}
+
+double
+check_min_value (double const min_value)
+{
+    check_ge (min_value, std::numeric_limits<double>::min ()); // positive and normal
+
+    return min_value;
+}
+
+/*
+ * a bucket spanning 'dy' in the log-linear index space has an end-to-start value ratio of
+ * at most '1 + dy' (the worst case is at the start of an octave), so 'gamma' is
+ * guaranteed by a bucket count per octave of '1 / (gamma - 1)'
+ */
+double
+multiplier (double const relative_accuracy)
+{
+    double const gamma = (1.0 + relative_accuracy) / (1.0 - relative_accuracy);
+
+    return (1.0 / (gamma - 1.0));
+}
+
+} // end of anonymous
+//............................................................................
+//............................................................................
+
+ddsketch::ddsketch (double const relative_accuracy, double const min_value, double const max_value) :
+    m_relative_accuracy { check_relative_accuracy (relative_accuracy) },
+    m_min_value { check_min_value (min_value) },
+    m_multiplier { multiplier (m_relative_accuracy) },
+    m_index_offset { static_cast<int32_t> (std::ceil (log2_approx (m_min_value) * m_multiplier)) },
+    m_half { [&]() { check_lt (min_value, max_value); return (static_cast<int32_t> (std::ceil (log2_approx (max_value) * m_multiplier)) - m_index_offset + 1); } () },
+    m_counts (2 * m_half + 1),
+    m_min { std::numeric_limits<double>::infinity () },
+    m_max { - std::numeric_limits<double>::infinity () }
+{
+    LOG_trace1 << "configured with relative accuracy " << m_relative_accuracy << ", " << m_half << " bucket(s) per sign";
+}
+//............................................................................
+
+double
+ddsketch::quantile (double const q) const
+{
+    check_nonnegative (q);
+    check_le (q, 1.0);
+
+    if (VR_UNLIKELY (! m_count))
+        return std::numeric_limits<double>::quiet_NaN ();
+
+    double const rank = q * (m_count - 1);
+
+    count_type cum { };
+    int32_t s = 0;
+
+    for (int32_t const s_limit = m_counts.size () - 1; s < s_limit; ++ s)
+    {
+        cum += m_counts [s];
+        if (cum > rank) break;
+    }
+
+    return std::min (std::max (bucket_value (s), m_min), m_max);
+}
+
+std::unique_ptr<data::dataframe>
+ddsketch::to_dataframe () const
+{
+    int64_t const rows = std::count_if (m_counts.begin (), m_counts.end (), [](count_type const c) { return (c > 0); });
+
+    int64_t row_capacity { 1 }; // dataframe capacity needs to be a power of 2
+    while (row_capacity < rows) row_capacity <<= 1;
+
+    std::unique_ptr<data::dataframe> df { std::make_unique<data::dataframe> (row_capacity, data::attr_schema { "value: f8; count: i8;" }) };
+
+    for (int32_t s = 0, s_limit = m_counts.size (); s < s_limit; ++ s)
+    {
+        if (m_counts [s] > 0) df->add_row (bucket_value (s), m_counts [s]);
+    }
+
+    return df;
+}
+//............................................................................
+
+void
+ddsketch::add (double const x, count_type const count)
+{
+    check_nonnegative (count);
+
+    if (count)
+    {
+        m_counts [slot (x)] += count;
+        m_count += count;
+
+        m_min = std::min (m_min, x);
+        m_max = std::max (m_max, x);
+    }
+}
+
+void
+ddsketch::add (data::dataframe const & src)
+{
+    double const * const values = src.at<double> ("value");
+    int64_t const * const counts = src.at<int64_t> ("count");
+
+    for (data::dataframe::size_type r = 0, r_limit = src.row_count (); r < r_limit; ++ r)
+    {
+        add (values [r], counts [r]);
+    }
+}
+
+void
+ddsketch::merge (ddsketch const & rhs)
+{
+    check_eq (m_multiplier, rhs.m_multiplier);
+    check_eq (m_index_offset, rhs.m_index_offset);
+    check_eq (m_half, rhs.m_half);
+
+    count_type * VR_RESTRICT const dst = m_counts.data ();
+    count_type const * VR_RESTRICT const src = rhs.m_counts.data ();
+
+    for (int32_t s = 0, s_limit = m_counts.size (); s < s_limit; ++ s)
+    {
+        dst [s] += src [s];
+    }
+
+    m_count += rhs.m_count;
+
+    m_min = std::min (m_min, rhs.m_min);
+    m_max = std::max (m_max, rhs.m_max);
+}
+
+void
+ddsketch::clear ()
+{
+    std::fill (m_counts.begin (), m_counts.end (), 0);
+    m_count = 0;
+
+    m_min = std::numeric_limits<double>::infinity ();
+    m_max = - std::numeric_limits<double>::infinity ();
+}
+//............................................................................
+
+double
+ddsketch::log2_approx_inverse (double const y)
+{
+    double const e = std::floor (y);
+
+    return std::ldexp (1.0 + (y - e), static_cast<int32_t> (e));
+}
+
+double
+ddsketch::bucket_value (int32_t const s) const
+{
+    if (s == m_half) return 0.0;
+
+    int32_t const k = (s > m_half ? s - m_half - 1 : m_half - 1 - s);
+    int32_t const i = k + m_index_offset;
+
+    // bucket 'i' covers index space '((i - 1) / M, i / M]', return the value
+    // with equal relative distance to both ends:
+
+    double const lo = log2_approx_inverse ((i - 1) / m_multiplier);
+    double const hi = log2_approx_inverse (i / m_multiplier);
+
+    double const v = (2.0 * lo * hi) / (lo + hi);
+
+    return (s > m_half ? v : - v);
+}
+
+} // end of 'stats'
+} // end of namespace
+//----------------------------------------------------------------------------
@@ -0,0 +1,181 @@
+#pragma once
+
+#include "vr/asserts.h"
+
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace data
+{
+class dataframe; // forward
+}
+
+namespace stats
+{
+/**
+ * a mergeable stream quantile sketch with bounded relative error (DDSketch with
+ * a log-linear index mapping)
+ *
+ * values are counted in a fixed set of buckets (allocated once, at construction time)
+ * whose boundaries grow geometrically by at most a factor of 'gamma = (1 + a)/(1 - a)',
+ * so that reporting a bucket's representative value is within relative error 'a'
+ * of any value that was counted in it; the bucket index of a value is a piecewise-linear
+ * approximation of 'log2 (|value|)' computed directly from its IEEE 754 exponent and
+ * mantissa bits (no transcendental function calls on the insert path)
+ *
+ * values with magnitude below 'min_value' are counted as zero, values with magnitude
+ * above 'max_value' saturate into the extreme buckets (exact min/max are tracked separately
+ * and used to clamp quantile estimates)
+ *
+ * sketches with identical construction parameters can be @ref merge()d exactly; a sketch
+ * can also be converted to a (value, count) @ref data::dataframe and fed into another sketch
+ * (with different parameters, if need be) via @ref add(), which allows persisting and
+ * combining them across processes/days
+ *
+ * @ref Masson, Rim, Lee "DDSketch: a fast and fully-mergeable quantile sketch with
+ *      relative-error guarantees", VLDB 2019
+ */
+class ddsketch final
+{
+    public: // ...............................................................
+
+        using count_type        = int64_t;
+
+        /**
+         * @param relative_accuracy [must be in (0, 1)]
+         * @param min_value [must be a positive normal number]
+         * @param max_value [must be greater than 'min_value']
+         */
+        ddsketch (double const relative_accuracy = 0.01, double const min_value = 1.0e-9, double const max_value = 1.0e+12);
+
+
+        // ACCESSORs:
+
+        double const & relative_accuracy () const
+        {
+            return m_relative_accuracy;
+        }
+
+        /**
+         * @return sample count so far
+         */
+        count_type const & count () const
+        {
+            return m_count;
+        }
+
+        /**
+         * @return exact min sample value [+inf if @ref count() is zero]
+         */
+        double const & min () const
+        {
+            return m_min;
+        }
+
+        /**
+         * @return exact max sample value [-inf if @ref count() is zero]
+         */
+        double const & max () const
+        {
+            return m_max;
+        }
+
+        /**
+         * @param q probability [must be in [0, 1]]
+         * @return quantile estimate [NaN if @ref count() is zero]
+         */
+        double quantile (double const q) const;
+
+        /**
+         * @return a dataframe with 'value' (f8) and 'count' (i8) columns, one row per
+         *         non-empty bucket, ordered by 'value'
+         */
+        std::unique_ptr<data::dataframe> to_dataframe () const;
+
+        // MUTATORs:
+
+        VR_FORCEINLINE void operator() (double const x)
+        {
+            ++ m_counts [slot (x)];
+            ++ m_count;
+
+            m_min = std::min (m_min, x);
+            m_max = std::max (m_max, x);
+        }
+
+        /**
+         * add 'x' with multiplicity 'count'
+         *
+         * @param count [must be non-negative]
+         */
+        void add (double const x, count_type const count);
+
+        /**
+         * add all (value, count) rows of a dataframe as created by @ref to_dataframe()
+         */
+        void add (data::dataframe const & src);
+
+        /**
+         * @param rhs [must have been constructed with the same parameters as this sketch]
+         */
+        void merge (ddsketch const & rhs);
+
+        void clear ();
+
+    private: // ..............................................................
+
+        /*
+         * a piecewise-linear approximation to 'log2 (x)' for a positive normal 'x'
+         * that is exact at powers of 2
+         */
+        static VR_FORCEINLINE double log2_approx (double const x)
+        {
+            uint64_t bits;
+            std::memcpy (& bits, & x, sizeof (bits));
+
+            int64_t const e = static_cast<int64_t> ((bits >> 52) & 0x7FF) - 1023;
+
+            return (static_cast<double> (e) + static_cast<double> (bits & 0x000FFFFFFFFFFFFF) * (1.0 / (1L << 52)));
+        }
+
+        static double log2_approx_inverse (double const y);
+
+        /*
+         * [0, m_half) are for negative values (in decreasing magnitude order), 'm_half' is for
+         * zero, (m_half, 2 * m_half] are for positive values (in increasing magnitude order)
+         */
+        VR_FORCEINLINE int32_t slot (double const x) const
+        {
+            double const ax = std::abs (x);
+
+            if (VR_UNLIKELY (! (ax >= m_min_value))) // note: also catches NaNs
+                return m_half;
+
+            int32_t const k = std::min<int32_t> (static_cast<int32_t> (std::ceil (log2_approx (ax) * m_multiplier)) - m_index_offset, m_half - 1);
+
+            return (x > 0 ? m_half + 1 + k : m_half - 1 - k);
+        }
+
+        double bucket_value (int32_t const s) const; // representative value for slot 's'
+
+
+        double const m_relative_accuracy;
+        double const m_min_value;
+        double const m_multiplier;      // bucket count per octave
+        int32_t const m_index_offset;   // bucket index of 'm_min_value'
+        int32_t const m_half;           // number of buckets for one sign
+        std::vector<count_type> m_counts;
+        count_type m_count { };
+        double m_min;
+        double m_max;
+
+}; // end of class
+
+} // end of 'stats'
+} // end of namespace
+//----------------------------------------------------------------------------
@@ -0,0 +1,213 @@
+
+#include "vr/stats/ddsketch.h"
+
+#include "vr/data/dataframe.h"
+#include "vr/util/logging.h"
+
+#include "vr/test/random.h"
+#include "vr/test/utility.h"
+
+#include <algorithm>
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace stats
+{
+//............................................................................
+//............................................................................
+namespace
+{
+
+std::vector<double> const &
+test_probabilities ()
+{
+    static std::vector<double> const g_probabilities { 0.0, 0.01, 0.25, 0.5, 0.75, 0.9, 0.99, 0.999, 1.0 };
+
+    return g_probabilities;
+}
+
+// exact quantile using the same rank convention as 'ddsketch::quantile()':
+
+double
+exact_quantile (std::vector<double> const & sorted, double const q)
+{
+    return sorted [static_cast<std::size_t> (q * (sorted.size () - 1))];
+}
+
+/*
+ * wide dynamic range, heavy tail (similar to latency data)
+ */
+std::vector<double>
+make_samples (int64_t const count, bool const with_negatives, uint64_t & rnd)
+{
+    std::vector<double> r (count);
+
+    for (double & v : r)
+    {
+        double const u = test::next_random<uint64_t, double> (rnd);
+
+        v = std::exp (20.0 * u); // in [1, e^20)
+        if (with_negatives && (test::next_random (rnd) & 1)) v = - v;
+    }
+
+    return r;
+}
+
+} // end of anonymous
+//............................................................................
+//............................................................................
+
+TEST (ddsketch, relative_accuracy)
+{
+    uint64_t rnd { test::env::random_seed<uint64_t> () };
+
+    int64_t const sample_count  = 100000;
+
+    for (double const a : { 0.05, 0.01, 0.001 })
+    {
+        for (bool const with_negatives : { false, true })
+        {
+            ddsketch ds { a };
+
+            std::vector<double> samples { make_samples (sample_count, with_negatives, rnd) };
+            for (double const v : samples) ds (v);
+
+            ASSERT_EQ (ds.count (), sample_count);
+
+            std::sort (samples.begin (), samples.end ());
+
+            EXPECT_EQ (ds.min (), samples.front ());
+            EXPECT_EQ (ds.max (), samples.back ());
+
+            for (double const q : test_probabilities ())
+            {
+                double const expected = exact_quantile (samples, q);
+                double const actual = ds.quantile (q);
+
+                LOG_trace1 << "[a: " << a << ", q: " << q << "] expected " << expected << ", actual " << actual;
+
+                EXPECT_LE (std::abs (actual - expected), a * std::abs (expected) * (1 + 1e-9)) << "a: " << a << ", q: " << q;
+            }
+        }
+    }
+}
+
+TEST (ddsketch, edge_cases)
+{
+    ddsketch ds { 0.01, 1.0, 1.0e6 };
+
+    EXPECT_TRUE (std::isnan (ds.quantile (0.5)));
+
+    ds (0.0);
+    ds (0.5); // below 'min_value', counted as zero
+    ds (1.0e9); // above 'max_value', saturates
+
+    ASSERT_EQ (ds.count (), 3);
+
+    EXPECT_EQ (ds.quantile (0.0), 0.0);
+    EXPECT_EQ (ds.quantile (0.5), 0.0);
+    EXPECT_LE (std::abs (ds.quantile (1.0) - 1.0e6), 0.01 * 1.0e6); // saturated
+
+    EXPECT_THROW (ds.quantile (1.5), invalid_input);
+    EXPECT_THROW (ds.add (1.0, -1), invalid_input);
+
+    ds.clear ();
+
+    ASSERT_EQ (ds.count (), 0);
+    EXPECT_TRUE (std::isnan (ds.quantile (0.5)));
+
+    EXPECT_THROW ((ddsketch { 0.0 }), invalid_input);
+    EXPECT_THROW ((ddsketch { 0.01, 0.0 }), invalid_input);
+    EXPECT_THROW ((ddsketch { 0.01, 1.0, 1.0 }), invalid_input);
+}
+
+TEST (ddsketch, merge)
+{
+    uint64_t rnd { test::env::random_seed<uint64_t> () };
+
+    int32_t const part_count    = 8;
+    int64_t const sample_count  = 10000; // per part
+
+    ddsketch all { };
+    ddsketch merged { };
+
+    for (int32_t p = 0; p < part_count; ++ p)
+    {
+        ddsketch part { };
+
+        for (double const v : make_samples (sample_count, true, rnd))
+        {
+            part (v);
+            all (v);
+        }
+
+        merged.merge (part);
+    }
+
+    ASSERT_EQ (merged.count (), all.count ());
+    EXPECT_EQ (merged.min (), all.min ());
+    EXPECT_EQ (merged.max (), all.max ());
+
+    for (double const q : test_probabilities ())
+    {
+        EXPECT_EQ (merged.quantile (q), all.quantile (q)) << "q: " << q; // merging is exact
+    }
+
+    EXPECT_THROW (merged.merge (ddsketch { 0.02 }), invalid_input);
+}
+
+TEST (ddsketch, dataframe_round_trip)
+{
+    uint64_t rnd { test::env::random_seed<uint64_t> () };
+
+    int64_t const sample_count  = 100000;
+    double const a              = 0.01;
+
+    ddsketch ds { a };
+
+    for (double const v : make_samples (sample_count, true, rnd)) ds (v);
+
+    std::unique_ptr<data::dataframe> const df = ds.to_dataframe ();
+
+    ASSERT_TRUE (df);
+    ASSERT_GT (df->row_count (), 0);
+
+    LOG_info << "sketch of " << sample_count << " sample(s) serialized into " << df->row_count () << " row(s)";
+
+    // same parameters: bucket values map back into their buckets exactly
+
+    {
+        ddsketch ds2 { a };
+        ds2.add (* df);
+
+        ASSERT_EQ (ds2.count (), ds.count ());
+
+        for (double q : { 0.01, 0.25, 0.5, 0.75, 0.99 }) // note: not 0 and 1, those are clamped by exact min/max
+        {
+            EXPECT_EQ (ds2.quantile (q), ds.quantile (q)) << "q: " << q;
+        }
+    }
+
+    // coarser parameters: errors compound
+
+    {
+        double const a2 = 0.02;
+
+        ddsketch ds2 { a2 };
+        ds2.add (* df);
+
+        ASSERT_EQ (ds2.count (), ds.count ());
+
+        for (double q : { 0.01, 0.25, 0.5, 0.75, 0.99 })
+        {
+            double const expected = ds.quantile (q);
+
+            EXPECT_LE (std::abs (ds2.quantile (q) - expected), 2 * a2 * std::abs (expected)) << "q: " << q;
+        }
+    }
+}
+
+} // end of 'stats'
+} // end of namespace
+//----------------------------------------------------------------------------
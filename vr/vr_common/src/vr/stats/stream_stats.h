@@ -1,13 +1,6 @@
 #pragma once
 
-#include "vr/asserts.h"
-
-VR_DIAGNOSTIC_PUSH ()
-VR_DIAGNOSTIC_IGNORE ("-Wdeprecated-declarations")
-#   include <boost/accumulators/accumulators.hpp>
-#   include <boost/accumulators/statistics/count.hpp>
-#   include <boost/accumulators/statistics/extended_p_square.hpp>
-VR_DIAGNOSTIC_POP ()
+#include "vr/stats/ddsketch.h"
 
 //----------------------------------------------------------------------------
 namespace vr
@@ -18,8 +11,6 @@ namespace stats
 //............................................................................
 namespace impl
 {
-namespace ba    = boost::accumulators;
-
 
 extern std::vector<double> const &
 check_ordered (std::vector<double> const & probabilities); // check ordering, duplicates, etc
@@ -30,8 +21,13 @@ class stream_stats_impl final: noncopyable
 {
     public: // ...............................................................
 
-        stream_stats_impl (std::vector<double> const & probabilities) :
-            m_acc_set { ba::tag::extended_p_square::probabilities = check_ordered (probabilities) },
+        /**
+         * @param sketch_args ('ddsketch' constructor args)
+         */
+        template<typename ... SKETCH_ARGs>
+        stream_stats_impl (std::vector<double> const & probabilities, SKETCH_ARGs && ... sketch_args) :
+            m_sketch { std::forward<SKETCH_ARGs> (sketch_args) ... },
+            m_probabilities { check_ordered (probabilities) },
             m_size { static_cast<int32_t> (probabilities.size ()) }
         {
         }
@@ -43,7 +39,7 @@ class stream_stats_impl final: noncopyable
          */
         std::size_t count () const
         {
-            return ba::count (m_acc_set);
+            return m_sketch.count ();
         }
 
         /**
@@ -53,7 +49,16 @@ class stream_stats_impl final: noncopyable
         {
             check_within (index, m_size);
 
-            return ba::extended_p_square (m_acc_set)[index];
+            return m_sketch.quantile (m_probabilities [index]);
+        }
+
+        /**
+         * @return quantile estimate for an arbitrary probability 'p' (not necessarily
+         *         one of those passed into the constructor)
+         */
+        double quantile (double const p) const
+        {
+            return m_sketch.quantile (p);
         }
 
         /**
@@ -64,22 +69,30 @@ class stream_stats_impl final: noncopyable
             return m_size;
         }
 
+        ddsketch const & sketch () const
+        {
+            return m_sketch;
+        }
+
         // MUTATORs:
 
         VR_FORCEINLINE void operator() (VARIATE const & sample)
         {
-            m_acc_set (sample);
+            m_sketch (static_cast<double> (sample));
         }
 
-    private: // ..............................................................
+        /**
+         * @param rhs [must have been constructed with the same sketch parameters]
+         */
+        void merge (stream_stats_impl const & rhs)
+        {
+            m_sketch.merge (rhs.m_sketch);
+        }
 
-        using acc_set       = ba::accumulator_set<VARIATE, ba::features
-                                <
-                                    ba::tag::count,
-                                    ba::tag::extended_p_square // note: depends on 'count' anyway
-                                > >;
+    private: // ..............................................................
 
-        acc_set m_acc_set;
+        ddsketch m_sketch;
+        std::vector<double> const m_probabilities;
         int32_t const m_size;
 
 }; // end of class
@@ -88,7 +101,8 @@ class stream_stats_impl final: noncopyable
 //............................................................................
 //............................................................................
 /**
- * a limited-memory stream quantile estimator (based on P^2 algorithm)
+ * a limited-memory stream quantile estimator for a fixed set of probabilities
+ * (a thin wrapper around a mergeable @ref ddsketch)
  */
 template<typename VARIATE>
 using stream_stats          = impl::stream_stats_impl<VARIATE>;
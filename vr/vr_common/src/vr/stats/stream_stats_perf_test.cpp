@@ -0,0 +1,139 @@
+
+#include "vr/macros.h" // VR_RELEASE
+#if VR_RELEASE // perf testcases in release builds only
+
+#include "vr/stats/stream_stats.h"
+#include "vr/util/logging.h"
+
+#include "vr/test/random.h"
+#include "vr/test/timing.h"
+#include "vr/test/utility.h"
+
+VR_DIAGNOSTIC_PUSH ()
+VR_DIAGNOSTIC_IGNORE ("-Wdeprecated-declarations")
+#   include <boost/accumulators/accumulators.hpp>
+#   include <boost/accumulators/statistics/count.hpp>
+#   include <boost/accumulators/statistics/extended_p_square.hpp>
+VR_DIAGNOSTIC_POP ()
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace stats
+{
+//............................................................................
+//............................................................................
+namespace
+{
+namespace ba    = boost::accumulators;
+
+using p_square_acc      = ba::accumulator_set<double, ba::features<ba::tag::count, ba::tag::extended_p_square>>; // what 'stream_stats' used to be
+
+template<typename F>
+VR_NOINLINE int64_t
+measure (F && f, int32_t const passes)
+{
+    int64_t best { std::numeric_limits<int64_t>::max () };
+
+    for (int32_t pass = 0; pass < passes; ++ pass)
+    {
+        int64_t tsc = VR_TSC_START ();
+        {
+            f ();
+        }
+        VR_TSC_STOP (tsc);
+
+        best = std::min (best, tsc);
+    }
+
+    return best;
+}
+
+} // end of anonymous
+//............................................................................
+//............................................................................
+/*
+ * per-sample insert cost and quantile accuracy on latency-like (TSC-scale, heavy-tailed)
+ * data, extended P^2 vs DDSketch
+ */
+TEST (perf_stream_stats, insert)
+{
+    std::vector<double> const probabilities { 0.25, 0.5, 0.75, 0.99, 0.999 };
+
+    int32_t const sample_count  = 1000000;
+    int32_t const passes        = 5;
+
+    int64_t const tsc_overhead = test::tsc_macro_overhead ();
+
+    uint64_t rnd = test::env::random_seed<uint64_t> ();
+
+    std::vector<double> samples (sample_count);
+    for (double & v : samples) v = 20.0 + std::exp (12.0 * test::next_random<uint64_t, double> (rnd) * test::next_random<uint64_t, double> (rnd));
+
+    std::unique_ptr<p_square_acc> ps;
+    std::unique_ptr<ddsketch> ds;
+
+    int64_t const t_ps = measure ([&]()
+        {
+            ps = std::make_unique<p_square_acc> (ba::tag::extended_p_square::probabilities = probabilities);
+            for (double const v : samples) (* ps)(v);
+        }, passes) - tsc_overhead;
+
+    int64_t const t_ds = measure ([&]()
+        {
+            ds = std::make_unique<ddsketch> ();
+            for (double const v : samples) (* ds)(v);
+        }, passes) - tsc_overhead;
+
+    double const n = sample_count;
+
+    LOG_info << "insert (cycles/op): extended P^2 " << std::setprecision (3) << (t_ps / n) << ", DDSketch " << (t_ds / n);
+
+    std::vector<double> sorted { samples };
+    std::sort (sorted.begin (), sorted.end ());
+
+    for (std::size_t i = 0; i < probabilities.size (); ++ i)
+    {
+        double const q = probabilities [i];
+        double const exact = sorted [static_cast<std::size_t> (q * (sample_count - 1))];
+
+        double const v_ps = ba::extended_p_square (* ps)[i];
+        double const v_ds = ds->quantile (q);
+
+        LOG_info << "  q " << q << ": exact " << exact << ", extended P^2 " << v_ps << " (rel err " << std::abs (v_ps - exact) / exact
+                 << "), DDSketch " << v_ds << " (rel err " << std::abs (v_ds - exact) / exact << ')';
+    }
+}
+
+/*
+ * merging sketches (e.g. from replay shards), which P^2 can't do at all
+ */
+TEST (perf_stream_stats, merge)
+{
+    int32_t const part_count    = 256;
+    int32_t const passes        = 5;
+
+    int64_t const tsc_overhead = test::tsc_macro_overhead ();
+
+    uint64_t rnd = test::env::random_seed<uint64_t> ();
+
+    std::vector<ddsketch> parts (part_count);
+    for (ddsketch & part : parts)
+    {
+        for (int32_t i = 0; i < 10000; ++ i) part (20.0 + std::exp (12.0 * test::next_random<uint64_t, double> (rnd)));
+    }
+
+    int64_t const t_merge = measure ([&]()
+        {
+            ddsketch all { };
+            for (ddsketch const & part : parts) all.merge (part);
+        }, passes) - tsc_overhead;
+
+    LOG_info << "merge (cycles/op): DDSketch " << std::setprecision (3) << (static_cast<double> (t_merge) / part_count);
+}
+
+} // end of 'stats'
+} // end of namespace
+//----------------------------------------------------------------------------
+
+#endif // VR_RELEASE
@@ -1,59 +1,85 @@
 #pragma once
 
 #include "vr/asserts.h"
-#include "vr/containers/intrusive.h"
+#include "vr/util/hashing.h"
 #include "vr/util/logging.h"
-#include "vr/util/memory.h"
+#include "vr/util/ops_int.h"
 
-#include <boost/iterator/iterator_facade.hpp>
-#include <iterator> // std::next()
+#include <algorithm>
+#include <iterator>
+#include <memory>
 
 //----------------------------------------------------------------------------
 namespace vr
 {
 /**
+ * "space saving" top-K summary of a stream of integral values, optionally weighted
+ *
+ * all state lives in flat arrays allocated once at construction time: items and count
+ * buckets are linked via 32-bit indices rather than pointers, and the value -> item
+ * index is an open-addressing (linear probing, backward-shift deletion) table sized
+ * for a load factor of at most 1/2
+ *
+ * @ref update(T const *, int32_t) pre-aggregates repeated values in a direct-mapped
+ * cache (~4x 'max_size' entries) before touching the summary, so that runs of a frequent value (typical of skewed data,
+ * which is what this summary is for) cost one weighted @ref add() rather than one bucket
+ * move per occurrence; weighted updates keep the usual space saving guarantees
+ * ('count() - count_error()' never exceeds the true count and 'count_error()' is less
+ * than 'count()'), although individual counts/errors can differ from those of one
+ * value at a time updates
+ *
+ * @param COUNT_TYPE can be narrowed (e.g. to 'int32_t') to make items more compact
+ *        if the stream size is known to fit
+ *
  * @ref Metwally et al
  */
-template<typename T> // split into base/T-specific
+template<typename T, typename COUNT_TYPE = int64_t, typename HASH = util::crc32_hash<T>>
 class stream_summary final: noncopyable
 {
     private: // ..............................................................
 
-        class bucket; // forward
+        vr_static_assert (std::is_integral<T>::value);
+        vr_static_assert (std::is_signed<COUNT_TYPE>::value);
+
+        using index_type        = int32_t; // [-1 means "none"]
+
+        using ops_checked       = util::ops_int<util::arg_policy<util::zero_arg_policy::ignore, 0>, true>;
+
+
         class iterator_impl; // forward
 
     public: // ...............................................................
 
         using size_type         = int32_t;
-        using count_type        = int64_t; // TODO define via traits with a default
+        using count_type        = COUNT_TYPE;
         using value_type        = T;
 
         using const_iterator    = iterator_impl;
 
-        struct item_context final: public intrusive::bi::list_base_hook<intrusive::bi_traits::link_mode>
+        /*
+         * what 'const_iterator' dereferences to
+         */
+        struct item_context final
         {
-            VR_FORCEINLINE T const & value () const;
-            VR_FORCEINLINE count_type const & count () const;
+            T const & value () const                { return m_value; }
+            count_type const & count () const       { return m_count; }
             /**
              * @return upper bound on by how much 'count()' is an overestimate of true count
              */
-            VR_FORCEINLINE count_type const & count_error () const;
+            count_type const & count_error () const { return m_count_error; }
 
             private:
 
-                friend class stream_summary;
+                friend class iterator_impl;
 
-                // TODO compactify 'm_count_error' and 'm_value'
-
-                bucket * m_parent { nullptr }; // not const: counts can migrate between buckets
-                count_type m_count_error { }; // upper bound on by how much 'count()' is an overestimate of true count
-                T m_value; // [not initialized by design] not const: can be replaced when summary evicts a min item
+                T m_value;
+                count_type m_count;
+                count_type m_count_error;
 
         }; // end of nested class
 
 
         stream_summary (size_type const max_size);
-        ~stream_summary ();
 
 
         // ACCESSORs:
@@ -66,351 +92,474 @@ class stream_summary final: noncopyable
             return m_items_allocated;
         }
 
+        /**
+         * iteration is in the order of decreasing counts
+         */
         const_iterator begin () const
         {
-            const bucket_list_const_reverse_iterator bucket_i_limit = m_buckets.rend ();
-            const bucket_list_const_reverse_iterator bucket_i = m_buckets.rbegin ();
-
-            if (bucket_i != bucket_i_limit)
-                return { bucket_i_limit, bucket_i, bucket_i->m_items.rbegin () };
-            else
-                return { bucket_i_limit, bucket_i, item_list_const_reverse_iterator { } };
+            return { this, m_bucket_tail };
         }
 
         const_iterator end () const
         {
-            bucket_list_const_reverse_iterator const bucket_i_limit = m_buckets.rend ();
-
-            return { bucket_i_limit, bucket_i_limit, item_list_const_reverse_iterator { } };
+            return { this, -1 };
         }
 
         // MUTATORs:
 
+        /**
+         * count 'value' with multiplicity 'count'
+         *
+         * @param count [must be positive]
+         */
+        VR_ASSUME_HOT void add (T const value, count_type const count = 1);
+
+        /**
+         * equivalent to a sequence of @ref add()s, but with repeated values pre-aggregated
+         *
+         * @note each call ends with an O(max_size) flush, so this is meant for large batches
+         */
         VR_ASSUME_HOT void update (T const * const values, int32_t const size); // TODO add an overload taking an iterator range
 
     private: // ..............................................................
 
-        /* overall structure is an ordered list of 'bucket''s, each of which
-         * defines an item count for all items currently grouped in this bucket -- these
-         * are represented by a list of 'item_context''s associated with each bucket.
-         *
-         * buckets are ordered by increasing count values; item_contexts are in arbitrary order
-         * within their respective sub-lists; each item_context points to its parent
-         * bucket via 'm_parent'.
-         *
-         * 'm_item_map' implements an O(1) hashmap lookup for any item currently
-         * being monitored (i.e. listed under one of the buckets).
+        /* overall structure is a doubly-linked list of 'bucket's ordered by increasing
+         * count, each of which heads a doubly-linked list of 'item's that currently have
+         * that count (in arbitrary order); an item refers to its bucket via 'm_bucket'
          */
 
-        using item_list     = intrusive::bi::list<item_context, intrusive::bi::constant_time_size<false> >; // doubly linked list (constant_time_size disabled; only empty() is used)
-        using item_map      = boost::unordered_map<T, item_context *>; // TODO faster map
+        struct item final
+        {
+            T m_value;
+            count_type m_count_error; // upper bound on by how much the bucket count is an overestimate of true count
+            index_type m_bucket;
+            index_type m_prev;
+            index_type m_next;
 
-        struct bucket final: public intrusive::bi::list_base_hook<intrusive::bi_traits::link_mode>
+        }; // end of nested class
+
+        struct bucket final
         {
-            count_type m_count { }; // TODO compactify
-            item_list m_items { };
+            count_type m_count;
+            index_type m_head; // first item [-1 if this bucket is free]
+            index_type m_prev;
+            index_type m_next; // next bucket in the count list, or in the free list
 
         }; // end of nested class
 
-        using bucket_list   = intrusive::bi::list<bucket>; // doubly linked list (defaults to constant_time_size)
+        struct combiner_entry final
+        {
+            T m_value;
+            count_type m_count; // [zero if this entry is empty]
+
+        }; // end of nested class
+
+        struct slot final
+        {
+            T m_key;
+            index_type m_item; // [-1 if this slot is empty]
 
-        // 'begin()/end()' actually work with reverse iterators (to traverse buckets in order of decreasing counts):
+        }; // end of nested class
 
-        using bucket_list_const_reverse_iterator        = typename bucket_list::const_reverse_iterator;
-        using item_list_const_reverse_iterator          = typename item_list::const_reverse_iterator;
 
-        class iterator_impl final: public boost::iterator_facade<iterator_impl, item_context const, boost::forward_traversal_tag>
+        class iterator_impl final
         {
             public:
 
-                iterator_impl () = default;
+                using iterator_category = std::forward_iterator_tag;
+                using value_type        = item_context;
+                using difference_type   = std::ptrdiff_t;
+                using pointer           = item_context const *;
+                using reference         = item_context const &;
 
-                iterator_impl (bucket_list_const_reverse_iterator const & bucket_i_limit, bucket_list_const_reverse_iterator const & bucket_i,
-                               item_list_const_reverse_iterator const & item_i) :
-                    m_bucket_i_limit { bucket_i_limit },
-                    m_bucket_i { bucket_i },
-                    m_item_i  {item_i }
+                iterator_impl (stream_summary const * const parent, index_type const b) :
+                    m_parent { parent },
+                    m_bucket { b },
+                    m_item { (b < 0 ? -1 : parent->m_buckets [b].m_head) }
                 {
+                    if (m_item >= 0) load ();
                 }
 
-            private:
+                reference operator* () const    { return m_current; }
+                pointer operator-> () const     { return (& m_current); }
 
-                friend class boost::iterator_core_access;
+                iterator_impl & operator++ ()
+                {
+                    m_item = m_parent->m_items [m_item].m_next;
 
-                // iterator_facade:
+                    if (m_item < 0)
+                    {
+                        m_bucket = m_parent->m_buckets [m_bucket].m_prev;
+                        if (m_bucket >= 0) m_item = m_parent->m_buckets [m_bucket].m_head;
+                    }
 
-                bool equal (iterator_impl const & rhs) const
+                    if (m_item >= 0) load ();
+
+                    return (* this);
+                }
+
+                iterator_impl operator++ (int)
                 {
-                    if (m_bucket_i == m_bucket_i_limit)
-                        return (rhs.m_bucket_i == rhs.m_bucket_i_limit);
-                    else
-                        return ((m_item_i == rhs.m_item_i) && (m_bucket_i == rhs.m_bucket_i));
+                    iterator_impl const r { * this };
+                    ++ (* this);
+                    return r;
                 }
 
-                item_context const & dereference () const
+                friend bool operator== (iterator_impl const & lhs, iterator_impl const & rhs)
                 {
-                    return (* m_item_i);
+                    return (lhs.m_item == rhs.m_item);
                 }
 
-                void increment ()
+                friend bool operator!= (iterator_impl const & lhs, iterator_impl const & rhs)
                 {
-                    ++ m_item_i;
-                    if (m_item_i == m_bucket_i->m_items.rend ())
-                    {
-                        ++ m_bucket_i;
+                    return (lhs.m_item != rhs.m_item);
+                }
 
-                        if (m_bucket_i != m_bucket_i_limit)
-                            m_item_i = m_bucket_i->m_items.rbegin ();
-                    }
+            private:
+
+                void load ()
+                {
+                    item const & i = m_parent->m_items [m_item];
+
+                    m_current.m_value = i.m_value;
+                    m_current.m_count = m_parent->m_buckets [i.m_bucket].m_count;
+                    m_current.m_count_error = i.m_count_error;
                 }
 
 
-                const bucket_list_const_reverse_iterator m_bucket_i_limit;
-                bucket_list_const_reverse_iterator m_bucket_i;
-                item_list_const_reverse_iterator m_item_i;
+                stream_summary const * m_parent;
+                index_type m_bucket;
+                index_type m_item;
+                item_context m_current { };
 
         }; // end of nested class
 
-        void increment_item_count (item_context * const item);
-        VR_FORCEINLINE void update_with_value (T const value);
 
+        // index:
+
+        VR_FORCEINLINE index_type slot_of (T const value) const
+        {
+            return (HASH { }(value) & m_slot_mask);
+        }
+
+        VR_FORCEINLINE index_type find (T const value) const;
+        void index_put (T const value, index_type const i);
+        void index_remove (T const value);
+
+        // bucket/item lists:
+
+        VR_FORCEINLINE index_type allocate_bucket (count_type const count);
+        VR_FORCEINLINE void free_bucket (index_type const b);
+        VR_FORCEINLINE void link_item (index_type const i, index_type const b);
+        VR_FORCEINLINE void unlink_item (index_type const i);
+
+        void place_item (index_type const i, count_type const count, index_type prev);
+        void increment_item_count (index_type const i, count_type const count);
 
 
         size_type const m_max_size;
+        index_type const m_slot_mask;
+        index_type const m_combiner_mask;
         size_type m_items_allocated { };
-        std::unique_ptr<bucket []> const m_bucket_holder;       // owns buckets in the intrusive list fields
-        std::unique_ptr<item_context []> const m_item_holder;   // owns item contexts in the intrusive list fields
-        bucket_list m_buckets; // (non-owning) intrusive list of buckets ordered by increasing 'm_count'
-        item_map m_item_map; // (non-owning) map item value -> monitored
-        bucket_list m_bucket_free_list; // (non-owning)
+        index_type m_bucket_head { -1 };    // min count
+        index_type m_bucket_tail { -1 };    // max count
+        index_type m_bucket_free { -1 };
+        std::unique_ptr<item []> const m_items;
+        std::unique_ptr<bucket []> const m_buckets;
+        std::unique_ptr<slot []> const m_slots;
+        std::unique_ptr<combiner_entry []> const m_combiner; // 'update()' pre-aggregation
 
 }; // end of class
 //............................................................................
 
-template<typename T>
-stream_summary<T>::stream_summary (size_type const max_size) :
+template<typename T, typename COUNT_TYPE, typename HASH>
+stream_summary<T, COUNT_TYPE, HASH>::stream_summary (size_type const max_size) :
     m_max_size { max_size },
-    m_bucket_holder { std::make_unique<bucket []> (max_size) },
-    m_item_holder { std::make_unique<item_context []> (max_size) }
+    m_slot_mask { (1 << ops_checked::log2_ceil (2 * std::max<size_type> (max_size, 1))) - 1 },
+    m_combiner_mask { std::min<index_type> (std::max<index_type> (2 * (m_slot_mask + 1), 256), (1 << 16)) - 1 },
+    m_items { std::make_unique<item []> (max_size) },
+    m_buckets { std::make_unique<bucket []> (max_size) },
+    m_slots { std::make_unique<slot []> (m_slot_mask + 1) },
+    m_combiner { std::make_unique<combiner_entry []> (m_combiner_mask + 1) } // note: zero-initialized
 {
     check_positive (max_size);
 
-    LOG_trace1 << "sizeof (item_context) = " << sizeof (item_context) << ", sizeof (bucket) = " << sizeof (bucket);
+    LOG_trace1 << "sizeof (item) = " << sizeof (item) << ", sizeof (bucket) = " << sizeof (bucket) << ", index slots: " << (m_slot_mask + 1);
 
-    for (size_type b = 0; b != max_size; ++ b)
+    for (index_type b = max_size; -- b >= 0; )
     {
-        m_bucket_free_list.push_back (m_bucket_holder [b]);
+        m_buckets [b].m_head = -1;
+        m_buckets [b].m_next = m_bucket_free;
+        m_bucket_free = b;
+    }
+
+    for (index_type s = 0; s <= m_slot_mask; ++ s)
+    {
+        m_slots [s].m_item = -1;
     }
 }
+//............................................................................
 
-template<typename T>
-stream_summary<T>::~stream_summary ()
+template<typename T, typename COUNT_TYPE, typename HASH>
+typename stream_summary<T, COUNT_TYPE, HASH>::index_type // forced inline
+stream_summary<T, COUNT_TYPE, HASH>::find (T const value) const
 {
-    if (intrusive::bi_traits::safe_mode ()) // compile-time guard
+    for (index_type s = slot_of (value); ; s = ((s + 1) & m_slot_mask))
     {
-        // in safe linking mode, explicit intrusive list clearing is necessary, otherwise
-        // bucket/item destructors will complain about being destroyed in still-linked state:
-
-        for (count_type b = 0; b != m_max_size; ++ b)
-        {
-            m_bucket_holder [b].m_items.clear ();
-        }
+        slot const & sl = m_slots [s];
 
-        m_buckets.clear ();
-        m_bucket_free_list.clear ();
+        if ((sl.m_item < 0) | (sl.m_key == value)) // note: load factor <= 1/2 guarantees an empty slot
+            return sl.m_item;
     }
 }
-//............................................................................
 
-template<typename T>
+template<typename T, typename COUNT_TYPE, typename HASH>
 void
-stream_summary<T>::increment_item_count (item_context * const item)
+stream_summary<T, COUNT_TYPE, HASH>::index_put (T const value, index_type const i)
 {
-    bucket * const parent = item->m_parent;
-    assert_condition (parent);
-
-    DLOG_trace2 << "incrementing item (" << item->m_value << "), current count = " << parent->m_count;
-
-    count_type const item_count = parent->m_count + 1;  // updated count for 'value'
+    index_type s = slot_of (value);
+    while (m_slots [s].m_item >= 0) s = ((s + 1) & m_slot_mask);
 
-    // move 'item' into the bucket for this larger count 'item_count':
-    // [three cases are possible: next bucket either does not exist (EOL) or
-    // has a count that's less than or equal to 'item_count']
-
-    item_list & parent_items = parent->m_items;
-    assert_nonempty (parent_items); // a bucket can only be empty in the middle of update
-
-    // unlink 'item' from its current parent list:
-
-    auto const ii = item_list::s_iterator_to (* item);
-    parent_items.erase (ii);
+    m_slots [s].m_key = value;
+    m_slots [s].m_item = i;
+}
 
-    // find next bucket:
+template<typename T, typename COUNT_TYPE, typename HASH>
+void
+stream_summary<T, COUNT_TYPE, HASH>::index_remove (T const value)
+{
+    index_type s = slot_of (value);
+    while (m_slots [s].m_key != value || m_slots [s].m_item < 0)
+    {
+        assert_condition (m_slots [s].m_item >= 0, "value not indexed: ", value);
+        s = ((s + 1) & m_slot_mask);
+    }
 
-    auto const bi = bucket_list::s_iterator_to (* parent);
-    auto const bi_next = std::next (bi);
+    // backward shift deletion: pull subsequent entries of the probe run into the hole
+    // if their home slot is not cyclically within (hole, their current slot]:
 
-    if (bi_next == m_buckets.end () || bi_next->m_count != item_count)
+    for (index_type j = s; ; )
     {
-        // a new bucket needs to be created to hold 'item_count'; however, if 'parent_items'
-        // became empty due to our current item unlinking above, re-use it:
+        j = ((j + 1) & m_slot_mask);
+
+        slot const & sl = m_slots [j];
+        if (sl.m_item < 0) break;
 
-        if (VR_LIKELY (! parent_items.empty ()))
+        index_type const home = slot_of (sl.m_key);
+        if (((j - home) & m_slot_mask) >= ((j - s) & m_slot_mask))
         {
-            // allocate a new 'bucket':
+            m_slots [s] = sl;
+            s = j;
+        }
+    }
 
-            assert_nonempty (m_bucket_free_list);
-            bucket & new_parent = m_bucket_free_list.front ();
-            m_bucket_free_list.pop_front ();
+    m_slots [s].m_item = -1;
+}
+//............................................................................
 
-            DLOG_trace2 << "allocated new bucket @" << & new_parent;
+template<typename T, typename COUNT_TYPE, typename HASH>
+typename stream_summary<T, COUNT_TYPE, HASH>::index_type // forced inline
+stream_summary<T, COUNT_TYPE, HASH>::allocate_bucket (count_type const count)
+{
+    index_type const b = m_bucket_free;
+    assert_nonnegative (b); // there can't be more non-empty buckets than items
 
-            new_parent.m_count = item_count;
-            new_parent.m_items.push_back (* item);
+    bucket & bk = m_buckets [b];
 
-            item->m_parent = & new_parent;
+    m_bucket_free = bk.m_next;
+    bk.m_count = count;
 
-            m_buckets.insert (bi_next, new_parent);
-        }
-        else
-        {
-            DLOG_trace2 << "re-using bucket @" << parent;
+    return b;
+}
 
-            parent->m_count = item_count;
-            parent_items.push_back (* item);
+template<typename T, typename COUNT_TYPE, typename HASH>
+void // forced inline
+stream_summary<T, COUNT_TYPE, HASH>::free_bucket (index_type const b)
+{
+    bucket & bk = m_buckets [b];
+    assert_lt (bk.m_head, 0);
 
-            // ['item''s parent link does not change]
-            // ['parent' keeps its position in the bucket list]
-        }
-    }
-    else
-    {
-        // move 'item' to the next bucket's item list:
+    // unlink from the count list:
 
-        DLOG_trace2 << "moving item (" << item->m_value << ") to bucket @" << & (* bi_next) << " with count " << bi_next->m_count;
+    if (bk.m_prev >= 0) m_buckets [bk.m_prev].m_next = bk.m_next; else m_bucket_head = bk.m_next;
+    if (bk.m_next >= 0) m_buckets [bk.m_next].m_prev = bk.m_prev; else m_bucket_tail = bk.m_prev;
 
-        bi_next->m_items.push_back (* item);
+    bk.m_next = m_bucket_free;
+    m_bucket_free = b;
+}
 
-        item->m_parent = & (* bi_next);
+template<typename T, typename COUNT_TYPE, typename HASH>
+void // forced inline
+stream_summary<T, COUNT_TYPE, HASH>::link_item (index_type const i, index_type const b)
+{
+    item & it = m_items [i];
+    bucket & bk = m_buckets [b];
 
-        // if the parent bucket becomes empty as a result, relocate it to the free list:
+    it.m_bucket = b;
+    it.m_prev = -1;
+    it.m_next = bk.m_head;
 
-        if (parent_items.empty ())
-        {
-            DLOG_trace2 << "freeing bucket @" << parent;
+    if (bk.m_head >= 0) m_items [bk.m_head].m_prev = i;
+    bk.m_head = i;
+}
 
-            m_buckets.erase (bi);
-            m_bucket_free_list.push_front (* parent);
-        }
-    }
+template<typename T, typename COUNT_TYPE, typename HASH>
+void // forced inline
+stream_summary<T, COUNT_TYPE, HASH>::unlink_item (index_type const i)
+{
+    item const & it = m_items [i];
+
+    if (it.m_prev >= 0) m_items [it.m_prev].m_next = it.m_next; else m_buckets [it.m_bucket].m_head = it.m_next;
+    if (it.m_next >= 0) m_items [it.m_next].m_prev = it.m_prev;
 }
 //............................................................................
 
-template<typename T>
-void // forced inline
-stream_summary<T>::update_with_value (T const value)
+template<typename T, typename COUNT_TYPE, typename HASH>
+void
+stream_summary<T, COUNT_TYPE, HASH>::place_item (index_type const i, count_type const count, index_type prev)
 {
-    DLOG_trace2 << '[' << (m_max_size - m_bucket_free_list.size ()) << ", " << m_items_allocated << "] update_with_value(" << value << ')';
+    // find the first bucket with count >= 'count' after 'prev' (or from the head if 'prev' is -1):
 
-    auto const vi = m_item_map.find (value);
+    index_type next = (prev < 0 ? m_bucket_head : m_buckets [prev].m_next);
 
-    if (VR_LIKELY (vi != m_item_map.end ()))
+    while ((next >= 0) && (m_buckets [next].m_count < count))
     {
-        // update this item's count, which requires moving it to another bucket:
+        prev = next;
+        next = m_buckets [next].m_next;
+    }
 
-        item_context * const item = vi->second;
-        increment_item_count (item);
+    if ((next >= 0) && (m_buckets [next].m_count == count))
+    {
+        link_item (i, next);
     }
-    else // 'value' is not in the map
+    else // insert a new bucket between 'prev' and 'next'
     {
-        item_context * item { nullptr };
+        index_type const b = allocate_bucket (count);
+        bucket & bk = m_buckets [b];
 
-        if (VR_LIKELY (m_items_allocated == m_max_size)) // monitored set size has reached max
-        {
-            // replace one of the items with the currently min count:
+        bk.m_head = -1;
+        bk.m_prev = prev;
+        bk.m_next = next;
 
-            assert_nonempty (m_buckets);
-            bucket & bmin = m_buckets.front ();
+        if (prev >= 0) m_buckets [prev].m_next = b; else m_bucket_head = b;
+        if (next >= 0) m_buckets [next].m_prev = b; else m_bucket_tail = b;
 
-            assert_nonempty (bmin.m_items);
-            item = & bmin.m_items.back (); // last item in the list more likely to have been accessed recently
+        link_item (i, b);
+    }
+}
 
-            // evict prev value:
+template<typename T, typename COUNT_TYPE, typename HASH>
+void
+stream_summary<T, COUNT_TYPE, HASH>::increment_item_count (index_type const i, count_type const count)
+{
+    index_type const b = m_items [i].m_bucket;
+    bucket & bk = m_buckets [b];
 
-            DLOG_trace2 << "evicting a min bucket @" << & bmin << ": value = " << item->m_value << ", count = " << bmin.m_count;
+    count_type const item_count = bk.m_count + count; // updated count for this item
 
-            m_item_map.erase (item->m_value); // update monitored set
-            item->m_value = value;
-            item->m_count_error = bmin.m_count;
+    // if 'i' is alone in its bucket and the new count doesn't overtake the next bucket's,
+    // just re-label the bucket:
 
-            increment_item_count (item);
-        }
-        else // add a new value to the monitored set
-        {
-            DLOG_trace2 << "adding a new monitored item (" << value << ") ...";
+    if ((bk.m_head == i) & (m_items [i].m_next < 0) && ((bk.m_next < 0) || (m_buckets [bk.m_next].m_count > item_count)))
+    {
+        bk.m_count = item_count;
+        return;
+    }
 
-            // allocate a new 'monitored':
+    unlink_item (i);
 
-            assert_lt (m_items_allocated, m_max_size);
-            item = & m_item_holder [m_items_allocated ++];
+    if (bk.m_head >= 0)
+        place_item (i, item_count, b);
+    else
+    {
+        index_type const prev = bk.m_prev;
 
-            // allocate a new 'bucket':
+        free_bucket (b);
+        place_item (i, item_count, prev);
+    }
+}
+//............................................................................
 
-            assert_nonempty (m_bucket_free_list);
-            bucket & parent = m_bucket_free_list.front ();
-            m_bucket_free_list.pop_front ();
+template<typename T, typename COUNT_TYPE, typename HASH>
+void
+stream_summary<T, COUNT_TYPE, HASH>::add (T const value, count_type const count)
+{
+    assert_positive (count);
 
-            DLOG_trace2 << "allocated new bucket @" << & parent;
+    index_type i = find (value);
 
-            parent.m_count =  { };
-            parent.m_items.push_back (* item);
+    if (VR_LIKELY (i >= 0))
+    {
+        increment_item_count (i, count);
+    }
+    else if (VR_LIKELY (m_items_allocated == m_max_size)) // monitored set size has reached max
+    {
+        // replace one of the items with the currently min count:
 
-            item->m_parent = & parent;
-            item->m_value = value;
+        assert_nonnegative (m_bucket_head);
+        bucket const & bmin = m_buckets [m_bucket_head];
 
-            m_buckets.push_front (parent); // bucket with 0 count goes to the head of the list
+        i = bmin.m_head;
+        item & it = m_items [i];
 
-            increment_item_count (item);
-        }
+        DLOG_trace2 << "evicting value " << it.m_value << " with count " << bmin.m_count;
 
-        m_item_map.emplace (value, item); // update monitored set
+        index_remove (it.m_value);
+
+        it.m_value = value;
+        it.m_count_error = bmin.m_count;
+
+        index_put (value, i);
+        increment_item_count (i, count);
+    }
+    else // add a new value to the monitored set
+    {
+        i = m_items_allocated ++;
+        item & it = m_items [i];
+
+        it.m_value = value;
+        it.m_count_error = 0;
+
+        index_put (value, i);
+        place_item (i, count, -1);
     }
 }
-//............................................................................
 
-template<typename T>
+template<typename T, typename COUNT_TYPE, typename HASH>
 void
-stream_summary<T>::update (T const * const values, int32_t const size)
+stream_summary<T, COUNT_TYPE, HASH>::update (T const * const values, int32_t const size)
 {
+    combiner_entry * const c = m_combiner.get ();
+
+    // pre-aggregate repeated values through a small direct-mapped cache, flushing
+    // an entry into the summary when it is displaced by a different value:
+
     for (int32_t i = 0; i < size; ++ i)
     {
-        assert_condition (m_items_allocated == signed_cast (m_item_map.size ()));
+        T const v = values [i];
+        combiner_entry & e = c [HASH { }(v) & m_combiner_mask];
 
-        update_with_value (values [i]);
-    }
-}
-//............................................................................
-//............................................................................
+        if (e.m_value == v) // note: also correct for an empty entry with a stale value
+            ++ e.m_count;
+        else
+        {
+            if (e.m_count) add (e.m_value, e.m_count);
 
-template<typename T> // forced inline
-T const &
-stream_summary<T>::item_context::value () const
-{
-    return m_value;
-}
+            e.m_value = v;
+            e.m_count = 1;
+        }
+    }
 
-template<typename T> // forced inline
-typename stream_summary<T>::count_type const &
-stream_summary<T>::item_context::count () const
-{
-    return m_parent->m_count;
-}
+    for (index_type k = 0; k <= m_combiner_mask; ++ k)
+    {
+        combiner_entry & e = c [k];
 
-template<typename T> // forced inline
-typename stream_summary<T>::count_type const &
-stream_summary<T>::item_context::count_error () const
-{
-    return m_count_error;
+        if (e.m_count)
+        {
+            add (e.m_value, e.m_count);
+            e.m_count = 0;
+        }
+    }
 }
 
 } // end of namespace
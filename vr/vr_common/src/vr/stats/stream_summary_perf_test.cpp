@@ -0,0 +1,87 @@
+
+#include "vr/macros.h" // VR_RELEASE
+#if VR_RELEASE // perf testcases in release builds only
+
+#include "vr/stats/stream_summary.h"
+#include "vr/util/logging.h"
+
+#include "vr/test/random.h"
+#include "vr/test/timing.h"
+#include "vr/test/utility.h"
+
+#include <cmath>
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+//............................................................................
+//............................................................................
+namespace
+{
+
+template<typename F>
+VR_NOINLINE int64_t
+measure (F && f, int32_t const passes)
+{
+    int64_t best { std::numeric_limits<int64_t>::max () };
+
+    for (int32_t pass = 0; pass < passes; ++ pass)
+    {
+        int64_t tsc = VR_TSC_START ();
+        {
+            f ();
+        }
+        VR_TSC_STOP (tsc);
+
+        best = std::min (best, tsc);
+    }
+
+    return best;
+}
+
+} // end of anonymous
+//............................................................................
+//............................................................................
+/*
+ * per-value update cost on skewed (oid/instrument activity-like) data, one value at
+ * a time vs batched
+ */
+TEST (perf_stream_summary, update)
+{
+    using value_type        = int64_t;
+
+    int32_t const max_size      = 1000;
+    int32_t const sample_count  = 4000000;
+    int32_t const passes        = 5;
+
+    int64_t const tsc_overhead = test::tsc_macro_overhead ();
+
+    uint64_t rnd = test::env::random_seed<uint64_t> ();
+
+    for (double const alpha : { 10.0, 1000.0, 100000.0 }) // scale of an exponential distribution of values
+    {
+        std::vector<value_type> values (sample_count);
+        for (value_type & v : values) v = std::floor (- alpha * std::log (1.0e-8 + test::next_random<uint64_t, double> (rnd)));
+
+        int64_t const t_one = measure ([&]()
+            {
+                stream_summary<value_type> ss { max_size };
+                for (value_type const v : values) ss.add (v);
+            }, passes) - tsc_overhead;
+
+        int64_t const t_batch = measure ([&]()
+            {
+                stream_summary<value_type> ss { max_size };
+                ss.update (& values [0], sample_count);
+            }, passes) - tsc_overhead;
+
+        double const n = sample_count;
+
+        LOG_info << "[alpha: " << alpha << "] update (cycles/value): one at a time " << std::setprecision (3) << (t_one / n) << ", batched " << (t_batch / n);
+    }
+}
+
+} // end of namespace
+//----------------------------------------------------------------------------
+
+#endif // VR_RELEASE
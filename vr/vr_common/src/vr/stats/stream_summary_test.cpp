@@ -181,6 +181,94 @@ TEST (stream_summary_test, edge_cases)
 }
 //..........................................................................
 
+TEST (stream_summary_test, weighted)
+{
+    using summary_type          = stream_summary<int64_t, int32_t>; // compact counts
+
+    summary_type ss { 4 };
+
+    ss.add (10, 5);
+    ss.add (20, 1);
+    ss.add (30, 3);
+    ss.add (20, 4); // ties with 10
+    ss.add (40, 2);
+
+    ASSERT_EQ (ss.size (), 4);
+
+    {
+        std::vector<std::pair<int64_t, int32_t>> items;
+        for (auto const & item : ss) items.emplace_back (item.value (), item.count ());
+
+        ASSERT_EQ (items.size (), 4);
+
+        EXPECT_EQ (items [0].second, 5);
+        EXPECT_EQ (items [1].second, 5);
+        EXPECT_EQ (items [2], std::make_pair (30L, 3));
+        EXPECT_EQ (items [3], std::make_pair (40L, 2));
+    }
+
+    ss.add (50, 1); // evicts 40 (the min item)
+
+    ASSERT_EQ (ss.size (), 4);
+    {
+        bool found { false };
+        for (auto const & item : ss)
+        {
+            ASSERT_NE (item.value (), 40);
+
+            if (item.value () == 50)
+            {
+                found = true;
+                EXPECT_EQ (item.count (), 3);
+                EXPECT_EQ (item.count_error (), 2);
+            }
+        }
+        EXPECT_TRUE (found);
+    }
+}
+/*
+ * with enough capacity, batched 'update()' must count exactly
+ */
+TEST (stream_summary_test, batched_exact)
+{
+    using value_type            = int64_t;
+    using summary_type          = stream_summary<value_type>;
+    using count_type            = summary_type::count_type;
+
+    uint64_t rnd = test::env::random_seed<uint64_t> ();
+
+    int32_t const range = 3000;
+    int32_t const size  = 100000;
+
+    summary_type ss { 2 * range }; // enough for all distinct values
+
+    std::vector<value_type> values;
+    boost::unordered_map<value_type, count_type> h { };
+
+    for (int32_t i = 0; i < size; ++ i)
+    {
+        value_type const x = (test::next_random (rnd) % range) * (test::next_random (rnd) % 3); // skewed towards zero, sparse keys
+
+        values.push_back (x);
+        ++ h.emplace (x, 0).first->second;
+    }
+
+    ss.update (& values [0], size);
+
+    ASSERT_EQ (ss.size (), signed_cast (h.size ()));
+
+    count_type count_prev { std::numeric_limits<count_type>::max () };
+    for (auto const & item : ss)
+    {
+        ASSERT_EQ (item.count (), h [item.value ()]) << "value " << item.value ();
+        ASSERT_EQ (item.count_error (), 0);
+
+        ASSERT_GE (count_prev, item.count ());
+        count_prev = item.count ();
+    }
+}
+//..........................................................................
+
 TYPED_TEST (stream_summary_test, uniform_data_pdf)
 {
     using value_type    = TypeParam; // testcase parameter
@@ -9,6 +9,8 @@
 
 #include <hwloc.h>
 
+#include <algorithm>
+
 //----------------------------------------------------------------------------
 namespace vr
 {
@@ -29,6 +31,7 @@ struct cpu_info::state final: private noncopyable
     ::hwloc_topology_t m_hw_topo { nullptr };
     std::vector<int32_t> m_obj_counts;
     std::vector<cache_data_all_types> m_cache_data;
+    std::vector<PU_location> m_PU_topology { };
     cache m_cache { }; // pimpl-like wrapper around 'm_cache_data'
 
 }; // end of nested class
@@ -191,6 +194,50 @@ cpu_info::cpu_info () :
     }
     cache_data.shrink_to_fit ();
 
+    // per-PU topology (walk each PU's ancestor chain):
+    {
+        int32_t const LLC_lvl = cache_data.size ();
+        std::vector<PU_location> & PU_topology = m_state->m_PU_topology;
+
+        for (::hwloc_obj_t pu = ::hwloc_get_next_obj_by_type (hw_topo, HWLOC_OBJ_PU, nullptr); pu != nullptr; pu = ::hwloc_get_next_obj_by_type (hw_topo, HWLOC_OBJ_PU, pu))
+        {
+            PU_location loc { };
+            loc.m_PU = pu->os_index;
+
+            for (::hwloc_obj_t a = pu->parent; a != nullptr; a = a->parent)
+            {
+#           if HWLOC_API_VERSION >= 0x00020000
+                bool const is_cache = ::hwloc_obj_type_is_cache (a->type);
+#           else
+                bool const is_cache = (a->type == HWLOC_OBJ_CACHE);
+#           endif
+
+                if (is_cache)
+                {
+                    if (a->attr->cache.type == HWLOC_OBJ_CACHE_INSTRUCTION) continue;
+
+                    int32_t const lvl = a->attr->cache.depth;
+
+                    if (lvl == L2) loc.m_L2 = a->logical_index;
+                    if (lvl == LLC_lvl) loc.m_LLC = a->logical_index;
+                }
+                else switch (a->type)
+                {
+                    case HWLOC_OBJ_CORE:    loc.m_core = a->logical_index; break;
+                    case HWLOC_OBJ_PACKAGE: loc.m_socket = a->logical_index; break;
+
+                    default: break;
+
+                } // end of switch
+            }
+
+            PU_topology.push_back (loc);
+        }
+
+        std::sort (PU_topology.begin (), PU_topology.end (), [](PU_location const & lhs, PU_location const & rhs) { return (lhs.m_PU < rhs.m_PU); });
+        PU_topology.shrink_to_fit ();
+    }
+
     if (m_state->m_obj_counts [hw_obj::PU] > signed_cast (bit_set::bits_per_block)) // see convert() TODOs below
         LOG_warn << "count of PUs (" << m_state->m_obj_counts [hw_obj::PU] << ") too large, the affinity API needs upgrading";
 }
@@ -215,6 +262,19 @@ cpu_info::cache_info () const
 {
     return m_state->m_cache;
 }
+
+std::vector<cpu_info::PU_location> const &
+cpu_info::PU_topology () const
+{
+    return m_state->m_PU_topology;
+}
+//............................................................................
+
+std::ostream &
+operator<< (std::ostream & os, cpu_info::PU_location const & obj) VR_NOEXCEPT
+{
+    return os << "PU #" << obj.m_PU << " {core: " << obj.m_core << ", L2: " << obj.m_L2 << ", LLC: " << obj.m_LLC << ", socket: " << obj.m_socket << '}';
+}
 //............................................................................
 //............................................................................
 namespace
@@ -4,6 +4,8 @@
 #include "vr/util/function_traits.h"
 #include "vr/sys/defs.h"
 
+#include <vector>
+
 //----------------------------------------------------------------------------
 namespace vr
 {
@@ -59,6 +61,22 @@ class cpu_info final: noncopyable
 
         }; // end of nested class
 
+        /**
+         * location of a PU within the machine topology (all values except 'm_PU' are
+         * logical indices of the containing objects, -1 if not present/could not be determined)
+         */
+        struct PU_location final
+        {
+            int32_t m_PU { -1 };        // OS index (as used by the @ref affinity API)
+            int32_t m_core { -1 };
+            int32_t m_L2 { -1 };
+            int32_t m_LLC { -1 };
+            int32_t m_socket { -1 };
+
+            friend VR_ASSUME_COLD std::ostream & operator<< (std::ostream & os, PU_location const & obj) VR_NOEXCEPT;
+
+        }; // end of nested class
+
 
         static cpu_info const & instance ();
         VR_ASSUME_COLD ~cpu_info () VR_NOEXCEPT;
@@ -81,6 +99,11 @@ class cpu_info final: noncopyable
          */
         cache const & cache_info () const;
 
+        /**
+         * @return locations of all PUs in the system, in ascending 'm_PU' order
+         */
+        std::vector<PU_location> const & PU_topology () const;
+
 
         template<typename A> class access_by;
 
@@ -61,6 +61,24 @@ TEST (cpu_info, cache_details)
         EXPECT_GT (cl.m_size, 0UL);
     }
 }
+
+TEST (cpu_info, PU_topology)
+{
+    cpu_info const & ci = cpu_info::instance ();
+
+    std::vector<cpu_info::PU_location> const & topo = ci.PU_topology ();
+    ASSERT_EQ (ci.PU_count (), signed_cast (topo.size ()));
+
+    for (int32_t i = 0, i_limit = topo.size (); i < i_limit; ++ i)
+    {
+        cpu_info::PU_location const & loc = topo [i];
+        LOG_info << "  " << loc;
+
+        if (i) EXPECT_LT (topo [i - 1].m_PU, loc.m_PU);
+
+        EXPECT_TRUE (vr_is_within (loc.m_core, ci.count (hw_obj::core))) << loc;
+    }
+}
 //............................................................................
 
 TEST (affinity, sniff)
@@ -0,0 +1,329 @@
+
+#include "vr/util/di/PU_planner.h"
+
+#include "vr/util/logging.h"
+
+#include <algorithm>
+#include <deque>
+#include <tuple>
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace util
+{
+namespace di
+{
+//............................................................................
+//............................................................................
+namespace
+{
+
+VR_FORCEINLINE bool
+shares (int32_t const lhs, int32_t const rhs)
+{
+    return ((lhs >= 0) & (lhs == rhs)); // [-1 is "unknown", not a shared object]
+}
+
+VR_FORCEINLINE int32_t
+core_key (sys::cpu_info::PU_location const & loc)
+{
+    return (loc.m_core >= 0 ? loc.m_core : (-2 - loc.m_PU)); // [treat a PU with unknown core as its own core]
+}
+
+} // end of anonymous
+//............................................................................
+//............................................................................
+
+PU_planner::PU_planner (topology const & topo) :
+    m_topology (topo) // note: copy
+{
+}
+//............................................................................
+
+int32_t
+PU_planner::add_group (std::string const & name, int32_t const PU)
+{
+    m_groups.push_back ({ name, PU, PU });
+
+    return (m_groups.size () - 1);
+}
+
+void
+PU_planner::add_link (int32_t const g0, int32_t const g1)
+{
+    check_within (g0, m_groups.size ());
+    check_within (g1, m_groups.size ());
+
+    if (g0 == g1) return;
+
+    std::vector<int32_t> & links0 = m_groups [g0].m_links;
+
+    if (std::find (links0.begin (), links0.end (), g1) == links0.end ())
+    {
+        links0.push_back (g1);
+        m_groups [g1].m_links.push_back (g0);
+    }
+}
+//............................................................................
+
+std::string const &
+PU_planner::name (int32_t const g) const
+{
+    check_within (g, m_groups.size ());
+
+    return m_groups [g].m_name;
+}
+
+int32_t
+PU_planner::PU (int32_t const g) const
+{
+    check_within (g, m_groups.size ());
+
+    return m_groups [g].m_PU;
+}
+//............................................................................
+
+sys::cpu_info::PU_location const *
+PU_planner::location (int32_t const PU) const
+{
+    auto const i = std::lower_bound (m_topology.begin (), m_topology.end (), PU, [](sys::cpu_info::PU_location const & lhs, int32_t const rhs) { return (lhs.m_PU < rhs); });
+
+    return ((i != m_topology.end ()) && (i->m_PU == PU) ? & (* i) : nullptr);
+}
+//............................................................................
+
+void
+PU_planner::plan ()
+{
+    m_issues.clear ();
+
+    int32_t const g_count = m_groups.size ();
+    int32_t const t_count = m_topology.size ();
+
+    std::vector<int32_t> PU_load (t_count, 0); // parallel to 'm_topology'
+    boost::unordered_map</* core key */int32_t, int32_t> core_load { };
+
+    auto const occupy = [&](int32_t const PU)
+        {
+            sys::cpu_info::PU_location const * const loc = location (PU);
+            if (loc)
+            {
+                ++ PU_load [loc - & m_topology [0]];
+                ++ core_load [core_key (* loc)];
+            }
+        };
+
+    // fixed groups first:
+
+    for (group & g : m_groups)
+    {
+        g.m_PU = g.m_PU_cfg;
+        if (g.m_PU >= 0) occupy (g.m_PU);
+    }
+
+    // find connected components of the link graph and place them, largest first, in BFS
+    // order from a fixed member (if any) so that each placement is near its already placed
+    // neighbors:
+
+    std::vector<std::vector<int32_t>> components { };
+    {
+        std::vector<bool> visited (g_count, false);
+
+        for (int32_t g = 0; g < g_count; ++ g)
+        {
+            if (visited [g] || (m_groups [g].m_PU_cfg == -1)) continue;
+
+            std::vector<int32_t> members { };
+            int32_t seed { -1 };
+            {
+                std::deque<int32_t> q { g };
+                visited [g] = true;
+
+                while (! q.empty ())
+                {
+                    int32_t const m = q.front (); q.pop_front ();
+                    members.push_back (m);
+
+                    group const & mg = m_groups [m];
+                    if ((mg.m_PU_cfg >= 0) && (seed < 0)) seed = m;
+
+                    for (int32_t n : mg.m_links)
+                    {
+                        if (! visited [n] && (m_groups [n].m_PU_cfg != -1))
+                        {
+                            visited [n] = true;
+                            q.push_back (n);
+                        }
+                    }
+                }
+            }
+
+            if (seed < 0) // no fixed member, start with the most connected one
+            {
+                seed = * std::max_element (members.begin (), members.end (), [this](int32_t const lhs, int32_t const rhs)
+                    {
+                        return (m_groups [lhs].m_links.size () < m_groups [rhs].m_links.size ());
+                    });
+            }
+
+            // re-traverse from 'seed' to get the placement order:
+
+            std::vector<int32_t> order { };
+            {
+                boost::unordered_set<int32_t> seen { seed };
+                std::deque<int32_t> q { seed };
+
+                while (! q.empty ())
+                {
+                    int32_t const m = q.front (); q.pop_front ();
+                    order.push_back (m);
+
+                    for (int32_t n : m_groups [m].m_links)
+                    {
+                        if ((m_groups [n].m_PU_cfg != -1) && seen.insert (n).second)
+                            q.push_back (n);
+                    }
+                }
+            }
+            assert_eq (order.size (), members.size ());
+
+            components.push_back (std::move (order));
+        }
+
+        std::stable_sort (components.begin (), components.end (), [](std::vector<int32_t> const & lhs, std::vector<int32_t> const & rhs) { return (lhs.size () > rhs.size ()); });
+    }
+
+    for (std::vector<int32_t> const & c : components)
+    {
+        for (int32_t const g : c)
+        {
+            group & pg = m_groups [g];
+            if (pg.m_PU_cfg >= 0) continue; // fixed
+
+            // count free cores per LLC ("room" for the rest of this group's component):
+
+            boost::unordered_map</* LLC */int32_t, boost::unordered_set</* core key */int32_t>> LLC_free_cores { };
+
+            for (sys::cpu_info::PU_location const & loc : m_topology)
+            {
+                int32_t const ck = core_key (loc);
+                if (! core_load [ck]) LLC_free_cores [loc.m_LLC].insert (ck);
+            }
+
+            using score         = std::tuple<bool, int32_t, int32_t, int32_t>; // (free core, affinity, LLC room, -topology index)
+
+            int32_t t_best { -1 };
+            score s_best { };
+
+            for (int32_t t = 0; t < t_count; ++ t)
+            {
+                if (PU_load [t]) continue;
+
+                sys::cpu_info::PU_location const & loc = m_topology [t];
+
+                int32_t affinity { };
+                for (int32_t n : pg.m_links)
+                {
+                    int32_t const n_PU = m_groups [n].m_PU;
+                    if (n_PU < 0) continue; // not placed (yet)
+
+                    sys::cpu_info::PU_location const * const n_loc = location (n_PU);
+                    if (! n_loc) continue;
+
+                    affinity += 4 * shares (loc.m_L2, n_loc->m_L2) + 2 * shares (loc.m_LLC, n_loc->m_LLC) + shares (loc.m_socket, n_loc->m_socket);
+                }
+
+                score const s { (core_load [core_key (loc)] == 0), affinity, LLC_free_cores [loc.m_LLC].size (), - t };
+
+                if ((t_best < 0) || (s_best < s))
+                {
+                    t_best = t;
+                    s_best = s;
+                }
+            }
+
+            if (VR_UNLIKELY (t_best < 0))
+                throw_x (illegal_state, "no free PU left for group " + print (pg.m_name) + " (" + string_cast (g_count) + " group(s), " + string_cast (t_count) + " PU(s))");
+
+            pg.m_PU = m_topology [t_best].m_PU;
+            occupy (pg.m_PU);
+
+            DLOG_trace2 << "  placed " << print (pg.m_name) << " on " << m_topology [t_best];
+        }
+    }
+
+    validate ();
+}
+
+void
+PU_planner::validate ()
+{
+    int32_t const g_count = m_groups.size ();
+
+    for (int32_t a = 0; a < g_count; ++ a)
+    {
+        group const & ga = m_groups [a];
+        if (ga.m_PU < 0) continue;
+
+        sys::cpu_info::PU_location const * const loc_a = location (ga.m_PU);
+        if (VR_UNLIKELY (! loc_a))
+        {
+            m_issues.push_back ("group " + print (ga.m_name) + " is assigned to PU #" + string_cast (ga.m_PU) + " which is not present in the system");
+            continue;
+        }
+
+        for (int32_t b = a + 1; b < g_count; ++ b)
+        {
+            group const & gb = m_groups [b];
+            if (gb.m_PU < 0) continue;
+
+            sys::cpu_info::PU_location const * const loc_b = location (gb.m_PU);
+            if (! loc_b) continue;
+
+            if (ga.m_PU == gb.m_PU)
+                m_issues.push_back ("groups " + print (ga.m_name) + " and " + print (gb.m_name) + " share PU #" + string_cast (ga.m_PU));
+            else if (core_key (* loc_a) == core_key (* loc_b))
+                m_issues.push_back ("groups " + print (ga.m_name) + " and " + print (gb.m_name) + " are on SMT siblings (PU #" + string_cast (ga.m_PU) + ", PU #" + string_cast (gb.m_PU) + ") of core " + string_cast (loc_a->m_core));
+
+            if ((std::find (ga.m_links.begin (), ga.m_links.end (), b) != ga.m_links.end ()) && ! shares (loc_a->m_LLC, loc_b->m_LLC))
+                m_issues.push_back ("linked groups " + print (ga.m_name) + " and " + print (gb.m_name) + " don't share an LLC (PU #" + string_cast (ga.m_PU) + ": LLC " + string_cast (loc_a->m_LLC) + ", PU #" + string_cast (gb.m_PU) + ": LLC " + string_cast (loc_b->m_LLC) + ')');
+        }
+    }
+}
+//............................................................................
+
+std::ostream &
+operator<< (std::ostream & os, PU_planner const & obj) VR_NOEXCEPT
+{
+    for (PU_planner::group const & g : obj.m_groups)
+    {
+        os << "\n  " << print (g.m_name) << ": ";
+
+        if (g.m_PU < 0)
+            os << "not bound";
+        else
+        {
+            sys::cpu_info::PU_location const * const loc = obj.location (g.m_PU);
+
+            if (loc)
+                os << (* loc);
+            else
+                os << "PU #" << g.m_PU << " {not present}";
+
+            if (g.m_PU_cfg < 0) os << " [planned]";
+        }
+    }
+
+    for (std::string const & i : obj.m_issues)
+    {
+        os << "\n  ISSUE: " << i;
+    }
+
+    return os;
+}
+
+} // end of 'di'
+} // end of 'util'
+} // end of namespace
+//----------------------------------------------------------------------------
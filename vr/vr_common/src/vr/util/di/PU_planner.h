@@ -0,0 +1,109 @@
+#pragma once
+
+#include "vr/sys/cpu.h"
+#include "vr/types.h"
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace util
+{
+namespace di
+{
+/**
+ * a planner for assigning PU groups (sets of steppables sharing a thread, all assumed
+ * to be "hot", i.e. busy-polling) to PUs, given the machine topology and the
+ * communication links between groups (e.g. a market data feed and the agents it
+ * feeds):
+ *
+ *  - groups with a fixed PU are kept where they are;
+ *  - groups to be placed by @ref plan() get PUs on cores not occupied by any other
+ *    group (i.e. not on an SMT sibling of another hot thread) whenever possible and
+ *    are drawn towards the caches (L2, then LLC, then socket) of the groups they
+ *    are linked with;
+ *  - the resulting plan (fixed and planned groups alike) is validated and any
+ *    SMT sharing or cross-LLC links are reported as @ref issues()
+ *
+ * @see container
+ */
+class PU_planner final: noncopyable
+{
+    public: // ...............................................................
+
+        using topology          = std::vector<sys::cpu_info::PU_location>;
+
+        PU_planner (topology const & topo);
+
+        // MUTATORs:
+
+        /**
+         * @param PU >= 0: fixed assignment, < -1: to be chosen by @ref plan(), -1: not bound
+         *        (such a group is neither placed nor validated)
+         *
+         * @return index of the new group
+         */
+        int32_t add_group (std::string const & name, int32_t const PU);
+        /**
+         * declare that groups 'g0' and 'g1' communicate (the link is undirected)
+         */
+        void add_link (int32_t const g0, int32_t const g1);
+
+        /**
+         * @throws illegal_state if there are not enough free PUs for all groups to be placed
+         */
+        VR_ASSUME_COLD void plan ();
+
+        // ACCESSORs:
+
+        int32_t group_count () const
+        {
+            return m_groups.size ();
+        }
+
+        std::string const & name (int32_t const g) const;
+        /**
+         * @return PU assigned to group 'g' (valid after @ref plan())
+         */
+        int32_t PU (int32_t const g) const;
+
+        /**
+         * @return human-readable descriptions of plan deficiencies (valid after @ref plan())
+         */
+        std::vector<std::string> const & issues () const
+        {
+            return m_issues;
+        }
+
+        friend VR_ASSUME_COLD std::ostream & operator<< (std::ostream & os, PU_planner const & obj) VR_NOEXCEPT;
+
+    private: // ..............................................................
+
+        struct group final
+        {
+            std::string const m_name;
+            int32_t const m_PU_cfg;
+            int32_t m_PU;
+            std::vector<int32_t> m_links { }; // unique group indices
+
+        }; // end of nested class
+
+
+        sys::cpu_info::PU_location const * location (int32_t const PU) const; // 'nullptr' if 'PU' is not in 'm_topology'
+
+        void validate ();
+
+
+        topology const m_topology;
+        std::vector<group> m_groups { };
+        std::vector<std::string> m_issues { };
+
+}; // end of class
+
+} // end of 'di'
+} // end of 'util'
+} // end of namespace
+//----------------------------------------------------------------------------
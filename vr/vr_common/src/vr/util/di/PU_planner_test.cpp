@@ -0,0 +1,179 @@
+
+#include "vr/util/di/PU_planner.h"
+
+#include "vr/test/utility.h"
+
+#include <set>
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace util
+{
+namespace di
+{
+//............................................................................
+//............................................................................
+namespace
+{
+/*
+ * 2 sockets x (1 LLC, 4 cores with private L2s) x 2 SMT threads, with siblings
+ * numbered Linux-style (PU 'p' and 'p + 8' share a core)
+ */
+PU_planner::topology
+make_topology ()
+{
+    PU_planner::topology r { };
+
+    for (int32_t PU = 0; PU < 16; ++ PU)
+    {
+        sys::cpu_info::PU_location loc { };
+        {
+            loc.m_PU = PU;
+            loc.m_core = (PU % 8);
+            loc.m_L2 = loc.m_core;
+            loc.m_LLC = loc.m_socket = (loc.m_core / 4);
+        }
+        r.push_back (loc);
+    }
+
+    return r;
+}
+
+sys::cpu_info::PU_location const &
+location_of (PU_planner::topology const & topo, int32_t const PU)
+{
+    return topo [PU]; // [by construction]
+}
+
+} // end of anonymous
+//............................................................................
+//............................................................................
+
+TEST (PU_planner, linked_groups_share_LLC)
+{
+    PU_planner::topology const topo = make_topology ();
+
+    PU_planner p { topo };
+
+    // a fixed feed on socket 1 with 2 agents and an execution link to be placed,
+    // plus an unrelated pair to be placed:
+
+    int32_t const feed = p.add_group ("feed", 5);
+    int32_t const xl = p.add_group ("xl", -2);
+
+    std::vector<int32_t> agents { };
+    for (int32_t a = 0; a < 2; ++ a)
+    {
+        agents.push_back (p.add_group ("agent." + string_cast (a), -3 - a));
+        p.add_link (feed, agents.back ());
+        p.add_link (agents.back (), xl);
+    }
+
+    int32_t const x = p.add_group ("x", -10);
+    int32_t const y = p.add_group ("y", -11);
+    p.add_link (x, y);
+
+    int32_t const unbound = p.add_group ("unbound", -1);
+
+    p.plan ();
+    LOG_info << "plan:" << p;
+
+    EXPECT_TRUE (p.issues ().empty ()) << print (p.issues ());
+
+    EXPECT_EQ (5, p.PU (feed));
+    EXPECT_EQ (-1, p.PU (unbound));
+
+    // all members of the feed component are on the feed's LLC and on distinct cores:
+
+    std::set<int32_t> cores { };
+    for (int32_t g : { feed, xl, agents [0], agents [1] })
+    {
+        sys::cpu_info::PU_location const & loc = location_of (topo, p.PU (g));
+
+        EXPECT_EQ (1, loc.m_LLC) << p.name (g);
+        EXPECT_TRUE (cores.insert (loc.m_core).second) << p.name (g);
+    }
+
+    // the unrelated pair doesn't fit there anymore and goes to the other LLC, but stays together:
+
+    EXPECT_EQ (location_of (topo, p.PU (x)).m_LLC, location_of (topo, p.PU (y)).m_LLC);
+    EXPECT_EQ (0, location_of (topo, p.PU (x)).m_LLC);
+}
+
+TEST (PU_planner, validation)
+{
+    PU_planner::topology const topo = make_topology ();
+
+    // fixed assignments: SMT siblings and a cross-LLC link:
+    {
+        PU_planner p { topo };
+
+        int32_t const a = p.add_group ("a", 1);
+        int32_t const b = p.add_group ("b", 9); // sibling of "a"
+        int32_t const c = p.add_group ("c", 4); // different LLC
+
+        p.add_link (a, c);
+        (void) b;
+
+        p.plan ();
+        LOG_info << "plan:" << p;
+
+        EXPECT_EQ (2, signed_cast (p.issues ().size ())) << print (p.issues ());
+    }
+    // non-existent PU:
+    {
+        PU_planner p { topo };
+
+        p.add_group ("a", 100);
+
+        p.plan ();
+
+        EXPECT_EQ (1, signed_cast (p.issues ().size ())) << print (p.issues ());
+    }
+}
+
+TEST (PU_planner, oversubscription)
+{
+    PU_planner::topology const topo = make_topology ();
+
+    // more groups than cores: every core gets used before any SMT sibling is:
+    {
+        PU_planner p { topo };
+
+        for (int32_t g = 0; g < 10; ++ g)
+        {
+            p.add_group ("g." + string_cast (g), -2 - g);
+        }
+
+        p.plan ();
+
+        std::set<int32_t> PUs { };
+        std::set<int32_t> cores { };
+
+        for (int32_t g = 0; g < p.group_count (); ++ g)
+        {
+            EXPECT_TRUE (PUs.insert (p.PU (g)).second);
+            cores.insert (location_of (topo, p.PU (g)).m_core);
+        }
+
+        EXPECT_EQ (8, signed_cast (cores.size ()));
+        EXPECT_EQ (2, signed_cast (p.issues ().size ())) << print (p.issues ()); // two sibling pairs
+    }
+    // more groups than PUs:
+    {
+        PU_planner p { topo };
+
+        for (int32_t g = 0; g < 17; ++ g)
+        {
+            p.add_group ("g." + string_cast (g), -2 - g);
+        }
+
+        EXPECT_THROW (p.plan (), illegal_state);
+    }
+}
+
+} // end of 'di'
+} // end of 'util'
+} // end of namespace
+//----------------------------------------------------------------------------
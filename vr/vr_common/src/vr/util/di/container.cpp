@@ -4,6 +4,7 @@
 #include "vr/mc/step_runnable.h" // TODO cyclic dep on 'mc::'
 #include "vr/mc/waitable.h" // TODO cyclic dep on 'mc::'
 #include "vr/util/di/container_barrier.h"
+#include "vr/util/di/PU_planner.h"
 #include "vr/util/logging.h"
 
 #include <boost/bimap.hpp>
@@ -67,6 +68,7 @@ struct PU_affinity_group
 {
     boost::unordered_set<std::string> m_members { }; // actual components names or aliases/logical thread names
     int32_t m_PU { std::numeric_limits<int32_t>::min () }; // >= 0: strict assignment to indicated PU, < -1: strict assignment to a PU chosen by container, -1: not bound
+    mc::idle_policy m_idle { };
 
 }; // end of class
 
@@ -76,7 +78,8 @@ using PU_affinity_group_map = boost::unordered_map</* PU **/int32_t, PU_affinity
 
 struct component_PU_affinity_group
 {
-    int32_t const m_PU;
+    int32_t m_PU; // note: non-const, PUs chosen by container are filled in by 'plan_placement()'
+    mc::idle_policy const m_idle;
     std::string m_name { };
     std::vector<mc::steppable *> m_steps { }; // [non-owning]
 
@@ -147,6 +150,7 @@ parse_affinity_cfg (settings const & cfg, PU_affinity_group_map & out)
     {
         std::vector<json> elements { }; // indexed by ID
         std::vector<std::string> names { }; // parallel to 'elements'
+        boost::unordered_map<ID_t, mc::idle_policy> idle_policies { }; // direct specs with options only
 
         boost::unordered_map<std::string, ID_t> name_map { };
         boost::unordered_map</* PU **/int32_t, ID_t> PU_map { }; // direct specs only, not "aliases"
@@ -159,13 +163,24 @@ parse_affinity_cfg (settings const & cfg, PU_affinity_group_map & out)
             if (VR_UNLIKELY (! name_map.emplace (name, ID).second))
                 throw_x (invalid_input, "duplicate affinity mapping for " + print (name));
 
-            if (i.value ().is_number ()) // direct PU mapping
+            json v = i.value ();
+
+            if (v.is_object ()) // direct PU mapping with options, e.g. { "PU": 3, "idle": { "backoff": true } }
             {
-                int32_t const PU = i.value ().get<int32_t> ();
+                auto const idle = v.find ("idle");
+                if (idle != v.end ()) idle_policies.emplace (ID, mc::idle_policy { * idle });
+
+                v = v.at ("PU"); // normalize to a direct PU mapping
+                check_condition (v.is_number (), name, v.type ());
+            }
+
+            if (v.is_number ()) // direct PU mapping
+            {
+                int32_t const PU = v.get<int32_t> ();
                 PU_map.emplace (PU, ID); // ok if this PU has been mapped already
             }
 
-            elements.push_back (i.value ());
+            elements.push_back (std::move (v));
             names.push_back (name);
         }
         assert_eq (elements.size (), name_map.size ());
@@ -233,6 +248,9 @@ parse_affinity_cfg (settings const & cfg, PU_affinity_group_map & out)
                     g.m_PU = v.get<int32_t> ();
                 else
                     check_eq (g.m_PU, v.get<int32_t> ());
+
+                auto const ii = idle_policies.find (id);
+                if (ii != idle_policies.end ()) g.m_idle = ii->second; // [if a PU has several specs with options, last one wins]
             }
         }
     }
@@ -395,7 +413,7 @@ struct container::pimpl final
                 for (auto const & kv : m_PU_group_cfg)
                 {
                     PU_affinity_group const & g = kv.second;
-                    component_PU_affinity_group component_g { g.m_PU };
+                    component_PU_affinity_group component_g { g.m_PU, g.m_idle };
 
                     for (std::string const & name : g.m_members)
                     {
@@ -465,6 +483,10 @@ struct container::pimpl final
                     cg.m_name = ns.str ();
                 }
             }
+
+            // pass 4: choose PUs for groups that requested it and validate the overall placement:
+
+            plan_placement (component_groups);
         }
 
 
@@ -505,7 +527,7 @@ struct container::pimpl final
 
             for (component_PU_affinity_group const & cg : component_groups)
             {
-                m_PU_tasks.emplace_back (mc::step_runnable::create (cg.m_PU, cg.m_name, * m_step_ctl, cg.m_steps));
+                m_PU_tasks.emplace_back (mc::step_runnable::create (cg.m_PU, cg.m_name, * m_step_ctl, cg.m_steps, cg.m_idle));
             }
 
             // move-assign real threads to 'm_PU_tasks':
@@ -678,6 +700,52 @@ struct container::pimpl final
         }
     }
 
+    /*
+     * groups with a PU < -1 in the affinity cfg are placed by a 'PU_planner', using
+     * deps between 'steppable's in different groups as communication links
+     */
+    VR_ASSUME_COLD void plan_placement (std::vector<component_PU_affinity_group> & component_groups)
+    {
+        PU_planner planner { sys::cpu_info::instance ().PU_topology () };
+
+        boost::unordered_map<component const *, /* group */int32_t> group_map { };
+
+        for (component_PU_affinity_group const & cg : component_groups)
+        {
+            int32_t const g = planner.add_group (cg.m_name, cg.m_PU);
+
+            for (mc::steppable * const s : cg.m_steps)
+            {
+                group_map.emplace (dynamic_cast<component const *> (s), g);
+            }
+        }
+
+        for (auto const & e : m_deps)
+        {
+            auto const i0 = group_map.find (e.first);
+            if (i0 == group_map.end ()) continue;
+
+            auto const i1 = group_map.find (e.second);
+            if (i1 == group_map.end ()) continue;
+
+            planner.add_link (i0->second, i1->second);
+        }
+
+        planner.plan ();
+
+        for (int32_t g = 0, g_limit = component_groups.size (); g < g_limit; ++ g)
+        {
+            component_groups [g].m_PU = planner.PU (g);
+        }
+
+        LOG_info << "PU placement:" << planner;
+
+        for (std::string const & i : planner.issues ())
+        {
+            LOG_warn << "PU placement: " << i;
+        }
+    }
+
     /*
      * DFS traversal starting at 'c'
      *
@@ -697,6 +765,7 @@ struct container::pimpl final
                 throw_x (invalid_input, "component " + print (c_name) + " references " + print (succ_name) + " which is not present");
 
             component * const succ = succ_i->second;
+            m_deps.emplace_back (c, succ);
 
             // bind 'c' dep field to 'succ':
 
@@ -777,6 +846,7 @@ struct container::pimpl final
     PU_affinity_group_map m_PU_group_cfg { }; // parsed affinity configuration
     component_bimap m_components { }; // [non-owning] populated by 'configure()'
     std::vector<component *> m_dep_order { }; // [owning] dependencies at lower indices than dependent components
+    std::vector<std::pair<component const *, component const *>> m_deps { }; // (dependent, dependency) edges, populated by 'bind_visit()'
     std::unique_ptr<step_ctl_impl> m_step_ctl { };
     state::enum_t m_state { state::created };
     int32_t m_last_started { }; // tracks the number of successfully start()ed components [index into 'm_dep_order']
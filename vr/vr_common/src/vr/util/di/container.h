@@ -17,6 +17,10 @@ namespace di
 class container_barrier; // forward
 
 /**
+ * 'cfg' maps 'steppable' component names (or aliases of other names) to PUs; a negative
+ * PU value less than -1 asks the container to choose a PU (see @ref PU_planner), with
+ * distinct such values denoting distinct PU groups
+ *
  * TODO to support active components and NUMA efficiency, add() component factories, not already created instances
  * TODO make start()/stop() MT-safe?
  *
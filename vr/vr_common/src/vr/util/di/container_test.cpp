@@ -722,6 +722,214 @@ TEST (container, lifecycle_exceptions)
     }
 }
 
+//............................................................................
+//............................................................................
+namespace test4
+{
+/*
+ * a step that never has any work except for noticing a flag raised by another thread
+ */
+class idle_ST final: public mc::steppable, public component
+{
+    public:
+
+        void signal ()
+        {
+            m_ts_signaled = sys::realtime_utc ();
+            m_flag.store (true, std::memory_order_release);
+
+            wake ();
+        }
+
+        int64_t m_step_count { };
+        std::atomic<bool> m_flag { false };
+        timestamp_t m_ts_signaled { };
+        timestamp_t m_ts_noticed { };
+
+    private:
+
+        // steppable:
+
+        void step () override
+        {
+            ++ m_step_count;
+
+            if (VR_UNLIKELY (m_flag.load (std::memory_order_acquire) && ! m_ts_noticed))
+                m_ts_noticed = sys::realtime_utc ();
+            else
+                report_idle ();
+        }
+
+}; // end of class
+
+/*
+ * notices every new value of a counter bumped by another thread
+ */
+class counting_ST final: public mc::steppable, public component
+{
+    public:
+
+        void signal (int32_t const value)
+        {
+            m_value.store (value, std::memory_order_release);
+
+            wake ();
+        }
+
+        std::atomic<int32_t> m_value { };
+        std::atomic<int32_t> m_seen { };
+
+    private:
+
+        // steppable:
+
+        void step () override
+        {
+            int32_t const v = m_value.load (std::memory_order_acquire);
+
+            if (v != m_seen.load (std::memory_order_relaxed))
+                m_seen.store (v, std::memory_order_release);
+            else
+                report_idle ();
+        }
+
+}; // end of class
+
+} // end of 'test4'
+//............................................................................
+//............................................................................
+
+TEST (container, idle_backoff)
+{
+    using namespace test4;
+
+    int32_t const PU            = 0;
+    timestamp_t const run_time  = 300 * _1_millisecond ();
+
+    // baseline: an idle step keeps getting spun on:
+
+    int64_t spin_step_count { };
+    {
+        container app { "APP",
+            {
+                { "default", PU },
+
+                { "S",      "default" }
+            }
+        };
+
+        app.configure ()
+            ("S",   new idle_ST { })
+        ;
+
+        idle_ST & s = app["S"];
+
+        app.start ();
+        {
+            app.run_for (run_time);
+        }
+        app.stop ();
+
+        spin_step_count = s.m_step_count;
+    }
+
+    // with backoff enabled, the runnable parks (with a long timeout) and has to be woken up:
+
+    int64_t backoff_step_count { };
+    {
+        container app { "APP",
+            {
+                { "default", PU },
+
+                { "S",      { { "PU", PU }, { "idle", { { "backoff", true }, { "park_timeout", 10 * _1_second () }, { "report_interval", 100 * _1_millisecond () } } } } }
+            }
+        };
+
+        app.configure ()
+            ("S",   new idle_ST { })
+        ;
+
+        idle_ST & s = app["S"];
+
+        app.start ();
+        {
+            boost::thread signaler { [& s, run_time]()
+                {
+                    sys::long_sleep_for (run_time / 2);
+                    s.signal ();
+                } };
+
+            app.run_for (run_time); // note: 'stop' also needs to un-park
+
+            signaler.join ();
+        }
+        app.stop ();
+
+        backoff_step_count = s.m_step_count;
+
+        ASSERT_GT (s.m_ts_noticed, 0);
+        EXPECT_LT (s.m_ts_noticed - s.m_ts_signaled, run_time / 2) << "wake() did not un-park the runnable";
+    }
+
+    LOG_info << "idle step count over " << run_time << " ns: spinning " << spin_step_count << ", with backoff " << backoff_step_count;
+
+    EXPECT_LT (backoff_step_count * 10, spin_step_count);
+}
+
+/*
+ * signals landing at random points of the backoff stages (including right after a pass
+ * that saw no data) must never be lost, i.e. wait out the (long) park timeout
+ */
+TEST (container, idle_backoff_wakeups)
+{
+    using namespace test4;
+
+    int32_t const PU                = 0;
+    int32_t const signal_count      = VR_IF_THEN_ELSE (VR_DEBUG)(100, 500);
+    timestamp_t const latency_max   = 500 * _1_millisecond (); // well below 'park_timeout'
+
+    uint64_t rnd = test::env::random_seed<uint64_t> ();
+
+    container app { "APP",
+        {
+            { "default", PU },
+
+            { "S",      { { "PU", PU }, { "idle", { { "backoff", true }, { "park_timeout", 10 * _1_second () } } } } }
+        }
+    };
+
+    app.configure ()
+        ("S",   new counting_ST { })
+    ;
+
+    counting_ST & s = app["S"];
+
+    timestamp_t latency_worst { };
+
+    app.start ();
+    {
+        for (int32_t i = 1; i <= signal_count; ++ i)
+        {
+            sys::short_sleep_for (unsigned_cast (test::next_random (rnd)) % (3 * _1_millisecond ())); // spans the spin, pause, wait, and park stages
+
+            timestamp_t const t_start = sys::realtime_utc ();
+            s.signal (i);
+
+            timestamp_t latency { };
+            while (s.m_seen.load (std::memory_order_acquire) != i)
+            {
+                latency = sys::realtime_utc () - t_start;
+                ASSERT_LT (latency, latency_max) << "signal " << i << " was not noticed";
+            }
+
+            latency_worst = std::max (latency_worst, latency);
+        }
+    }
+    app.stop ();
+
+    LOG_info << signal_count << " signal(s), worst latency " << latency_worst << " ns";
+}
+
 } // end of 'di'
 } // end of 'util'
 } // end of namespace
@@ -0,0 +1,349 @@
+#pragma once
+
+// note: this is an impl detail of "vr/util/logging.h", don't include directly
+
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace util
+{
+//............................................................................
+//............................................................................
+namespace impl_log
+{
+/*
+ * an async record is a 'record_header' followed by 'm_size' bytes of args, each
+ * a 1-byte 'arg_tag' followed by its raw value ('tag_str' values are a 4-byte length
+ * followed by that many chars)
+ */
+enum arg_tag : uint8_t
+{
+    tag_i64,
+    tag_u64,
+    tag_f64,
+    tag_char,
+    tag_bool,
+    tag_ptr,
+    tag_str
+};
+
+struct record_header final
+{
+    char const * m_file;    // a '__FILE__' literal, i.e. of static storage
+    int64_t m_ts;           // capture time [ns since epoch]
+    int32_t m_line;
+    int32_t m_severity;
+    int32_t m_size;         // byte size of the args following this header
+    int32_t m_truncated;    // [non-zero if some args didn't fit]
+
+}; // end of class
+//............................................................................
+constexpr int32_t max_record_size ()   { return 4096; } // including header
+
+/*
+ * per-thread async logging state, written by its owning thread only (the ring itself
+ * is defined in "logging_async.cpp")
+ */
+struct producer final
+{
+    static constexpr int32_t capacity ()    { return max_record_size (); }
+
+    void * const m_ring;            // [owned by the backend]
+    std::ostream & m_text;          // for args that can't be captured in binary form
+    int32_t m_position { };         // within 'm_data'
+    bool m_active { false };        // a record is being built (guards against nested logging)
+    bool m_text_mode { false };     // 'm_text' has content (and possibly formatting state)
+    alignas (8) char m_data [max_record_size ()];
+
+}; // end of class
+
+inline producer * &
+tls_producer ()
+{
+    static thread_local producer * t_producer { }; // note: constant-initialized, no TLS guard
+    return t_producer;
+}
+
+extern void
+commit (producer & p); // timestamps and publishes 'p's current record, drops it if the ring is full
+
+extern void
+end_text (producer & p); // appends 'm_text' content as a 'tag_str' arg and resets it to default formatting state
+
+//............................................................................
+
+template<typename T, typename = void>
+struct arg_traits
+{
+    static constexpr bool binary ()     { return false; }
+
+}; // end of master
+
+template<typename T>
+struct arg_traits<T, typename std::enable_if<(std::is_integral<T>::value && ! std::is_same<T, bool>::value && (sizeof (T) > 1))>::type>
+{
+    static constexpr bool binary ()     { return true; }
+    static constexpr arg_tag tag ()     { return (std::is_signed<T>::value ? tag_i64 : tag_u64); }
+
+    using wire_type     = typename std::conditional<std::is_signed<T>::value, int64_t, uint64_t>::type;
+
+}; // end of specialization
+
+template<typename T>
+struct arg_traits<T, typename std::enable_if<std::is_floating_point<T>::value && (sizeof (T) <= sizeof (double))>::type>
+{
+    static constexpr bool binary ()     { return true; }
+    static constexpr arg_tag tag ()     { return tag_f64; }
+
+    using wire_type     = double;
+
+}; // end of specialization
+
+template<typename T>
+struct arg_traits<T, typename std::enable_if<(std::is_integral<T>::value && ! std::is_same<T, bool>::value && (sizeof (T) == 1))>::type> // streamed as chars
+{
+    static constexpr bool binary ()     { return true; }
+    static constexpr arg_tag tag ()     { return tag_char; }
+
+    using wire_type     = char;
+
+}; // end of specialization
+
+template<>
+struct arg_traits<bool>
+{
+    static constexpr bool binary ()     { return true; }
+    static constexpr arg_tag tag ()     { return tag_bool; }
+
+    using wire_type     = bool;
+
+}; // end of specialization
+
+template<typename T>
+struct arg_traits<T *, typename std::enable_if<! std::is_same<typename std::remove_cv<T>::type, char>::value>::type>
+{
+    static constexpr bool binary ()     { return true; }
+    static constexpr arg_tag tag ()     { return tag_ptr; }
+
+    using wire_type     = void const *;
+
+}; // end of specialization
+//............................................................................
+/**
+ * what 'LOG_*' macros expand into: if the current thread has attached to the async
+ * backend (see @ref log_async_attach()), the args are captured in binary form into a
+ * thread-private buffer and published into the thread's ring when the statement ends;
+ * otherwise this is a thin wrapper around a 'google::LogMessage'
+ *
+ * in async mode, args that aren't arithmetic values, pointers or strings (as well as
+ * all args following them, since they could be stream manipulators) are formatted
+ * on the calling thread via a reusable per-thread 'std::ostream'
+ */
+class log_line final
+{
+    public: // ...............................................................
+
+        VR_FORCEINLINE log_line (char const * const file, int32_t const line, int32_t const severity) :
+            m_p { tls_producer () }
+        {
+            if (VR_LIKELY (m_p == nullptr) || VR_UNLIKELY (m_p->m_active)) // sync mode (or a nested log statement)
+            {
+                m_p = nullptr;
+                new (& m_msg) ::google::LogMessage { file, line, severity };
+            }
+            else
+            {
+                m_p->m_active = true;
+                m_p->m_position = sizeof (record_header);
+
+                record_header & h = header ();
+
+                h.m_file = file;
+                h.m_line = line;
+                h.m_severity = severity;
+                h.m_truncated = false;
+            }
+        }
+
+        VR_FORCEINLINE ~log_line ()
+        {
+            if (m_p == nullptr)
+                msg ().~LogMessage (); // emits
+            else
+            {
+                if (VR_UNLIKELY (m_p->m_text_mode)) end_text (* m_p);
+
+                header ().m_size = m_p->m_position - sizeof (record_header);
+                commit (* m_p);
+
+                m_p->m_active = false;
+            }
+        }
+
+        log_line (log_line const &) = delete;
+        log_line & operator= (log_line const &) = delete;
+
+
+        template<typename T>
+        VR_FORCEINLINE log_line & operator<< (T const & v)
+        {
+            if (m_p == nullptr)
+                msg ().stream () << v;
+            else
+                put (v, std::integral_constant<bool, arg_traits<T>::binary ()> { });
+
+            return (* this);
+        }
+
+        VR_FORCEINLINE log_line & operator<< (std::string const & v)
+        {
+            if (m_p == nullptr)
+                msg ().stream () << v;
+            else
+                put_str (v.data (), v.size ());
+
+            return (* this);
+        }
+
+        VR_FORCEINLINE log_line & operator<< (char const * const v)
+        {
+            if (m_p == nullptr)
+                msg ().stream () << v;
+            else
+                put_str (v, (v ? std::strlen (v) : 0));
+
+            return (* this);
+        }
+
+        template<std::size_t N>
+        VR_FORCEINLINE log_line & operator<< (char const (& v) [N])
+        {
+            return operator<< (static_cast<char const *> (v));
+        }
+
+        log_line & operator<< (std::ostream & (* const manip) (std::ostream &)) // e.g. 'std::endl', 'std::hex'
+        {
+            if (m_p == nullptr)
+                msg ().stream () << manip;
+            else
+                text () << manip;
+
+            return (* this);
+        }
+
+        log_line & operator<< (std::ios_base & (* const manip) (std::ios_base &))
+        {
+            if (m_p == nullptr)
+                msg ().stream () << manip;
+            else
+                text () << manip;
+
+            return (* this);
+        }
+
+    private: // ..............................................................
+
+        VR_FORCEINLINE ::google::LogMessage & msg ()
+        {
+            return (* reinterpret_cast<::google::LogMessage *> (& m_msg));
+        }
+
+        VR_FORCEINLINE record_header & header ()
+        {
+            return (* reinterpret_cast<record_header *> (m_p->m_data));
+        }
+
+        VR_FORCEINLINE std::ostream & text ()
+        {
+            m_p->m_text_mode = true;
+            return m_p->m_text;
+        }
+
+        template<typename T>
+        VR_FORCEINLINE void put (T const & v, std::true_type)
+        {
+            if (VR_UNLIKELY (m_p->m_text_mode)) // preserve any formatting state set by earlier args
+            {
+                m_p->m_text << v;
+                return;
+            }
+
+            using wire_type     = typename arg_traits<T>::wire_type;
+
+            int32_t const pos = m_p->m_position;
+            if (VR_UNLIKELY (pos + 1 + static_cast<int32_t> (sizeof (wire_type)) > producer::capacity ()))
+            {
+                header ().m_truncated = true;
+                return;
+            }
+
+            wire_type const w = static_cast<wire_type> (v);
+
+            m_p->m_data [pos] = arg_traits<T>::tag ();
+            std::memcpy (m_p->m_data + pos + 1, & w, sizeof (w));
+
+            m_p->m_position = pos + 1 + sizeof (w);
+        }
+
+        template<typename T>
+        void put (T const & v, std::false_type)
+        {
+            text () << v;
+        }
+
+        VR_FORCEINLINE void put_str (char const * const s, std::size_t const len)
+        {
+            if (VR_UNLIKELY (m_p->m_text_mode))
+            {
+                m_p->m_text.write (s, len);
+                return;
+            }
+
+            int32_t const pos = m_p->m_position;
+            int32_t const room = producer::capacity () - (pos + 1 + static_cast<int32_t> (sizeof (uint32_t)));
+
+            if (VR_UNLIKELY (room < 0))
+            {
+                header ().m_truncated = true;
+                return;
+            }
+
+            uint32_t n = len;
+            if (VR_UNLIKELY (static_cast<int64_t> (n) > room))
+            {
+                n = room;
+                header ().m_truncated = true;
+            }
+
+            m_p->m_data [pos] = tag_str;
+            std::memcpy (m_p->m_data + pos + 1, & n, sizeof (n));
+            std::memcpy (m_p->m_data + pos + 1 + sizeof (n), s, n);
+
+            m_p->m_position = pos + 1 + sizeof (n) + n;
+        }
+
+
+        producer * m_p;
+        typename std::aligned_storage<sizeof (::google::LogMessage), alignof (::google::LogMessage)>::type m_msg;
+
+}; // end of class
+
+struct voidify final
+{
+    // note: '&' has lower precedence than '<<' but higher than '?:'
+
+    VR_FORCEINLINE void operator& (log_line &) { }
+
+}; // end of class
+
+} // end of 'impl_log'
+} // end of 'util'
+} // end of namespace
+//----------------------------------------------------------------------------
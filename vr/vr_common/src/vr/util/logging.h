@@ -5,34 +5,53 @@
 #define GLOG_NO_ABBREVIATED_SEVERITIES
 #include <glog/logging.h>
 
+#include "vr/util/impl/log_line.h"
+
 //----------------------------------------------------------------------------
 
+#define VR_LOG_LINE(severity)       ::vr::util::impl_log::log_line { __FILE__, __LINE__, ::google::GLOG_ ## severity }
+#define VR_LOG_LINE_IF(severity, condition) \
+        ! (condition) ? (void) 0 : ::vr::util::impl_log::voidify { } & VR_LOG_LINE (severity)
+
 // logging that is never elided (with verbosity controlled at runtime):
 
 #define LOG_trace_enabled(verbosity)    VLOG_IS_ON(verbosity)
 
-#define LOG_trace1                  VLOG(1)
-#define LOG_trace2                  VLOG(2)
-#define LOG_trace3                  VLOG(3)
+#define LOG_trace1                  LOG_trace (1)
+#define LOG_trace2                  LOG_trace (2)
+#define LOG_trace3                  LOG_trace (3)
 
-#define LOG_trace(verbosity)        VLOG(verbosity)
+#define LOG_trace(verbosity)        VR_LOG_LINE_IF (INFO, VLOG_IS_ON (verbosity))
 
-#define LOG_info                    LOG(INFO)
-#define LOG_warn                    LOG(WARNING)
-#define LOG_error                   LOG(ERROR)
-#define LOG_fatal                   LOG(DFATAL)
+#define LOG_info                    VR_LOG_LINE (INFO)
+#define LOG_warn                    VR_LOG_LINE (WARNING)
+#define LOG_error                   VR_LOG_LINE (ERROR)
+#define LOG_fatal                   (::vr::util::log_async_flush (), LOG(DFATAL)) // always synchronous, after this thread's pending async records
 
 // logging that is elided in release builds:
 
-#define DLOG_trace1                 DVLOG(1)
-#define DLOG_trace2                 DVLOG(2)
-#define DLOG_trace3                 DVLOG(3)
+#if defined (NDEBUG)
+
+#   define DLOG_trace(verbosity)    VR_LOG_LINE_IF (INFO, false)
+
+#   define DLOG_info                VR_LOG_LINE_IF (INFO, false)
+#   define DLOG_warn                VR_LOG_LINE_IF (WARNING, false)
+#   define DLOG_error               VR_LOG_LINE_IF (ERROR, false)
+
+#else
 
-#define DLOG_trace(verbosity)       DVLOG(verbosity)
+#   define DLOG_trace(verbosity)    LOG_trace (verbosity)
+
+#   define DLOG_info                LOG_info
+#   define DLOG_warn                LOG_warn
+#   define DLOG_error               LOG_error
+
+#endif // NDEBUG
+
+#define DLOG_trace1                 DLOG_trace (1)
+#define DLOG_trace2                 DLOG_trace (2)
+#define DLOG_trace3                 DLOG_trace (3)
 
-#define DLOG_info                   DLOG(INFO)
-#define DLOG_warn                   DLOG(WARNING)
-#define DLOG_error                  DLOG(ERROR)
 #define DLOG_fatal                  DLOG(DFATAL)
 
 //............................................................................
@@ -47,6 +66,50 @@ namespace util
  */
 extern VR_ASSUME_COLD bool log_initialize ();
 
+/**
+ * switch the calling thread to async logging: 'LOG_{trace*,info,warn,error}' (and their
+ * 'DLOG_' versions) will capture their args in binary form into a per-thread SPSC ring,
+ * to be formatted and written through glog by a background thread
+ *
+ * since glog stamps each line with the time it is written, an async record's text
+ * is prefixed with its capture time ("[<capture ts>] ...")
+ *
+ * this is a no-op unless enabled via the 'VR_ENV_LOG_ASYNC' environment variable
+ *
+ * @return 'true' if the calling thread is now attached [idempotent]
+ */
+extern VR_ASSUME_COLD bool log_async_attach ();
+/**
+ * switch the calling thread back to synchronous logging, after its pending records
+ * have been written out [no-op if the thread is not attached]
+ */
+extern VR_ASSUME_COLD void log_async_detach ();
+/**
+ * block until all of the calling thread's pending async records have been written
+ * out [no-op if the thread is not attached]
+ */
+extern VR_ASSUME_COLD void log_async_flush ();
+
+/**
+ * RAII helper for @ref log_async_attach()/@ref log_async_detach()
+ */
+struct log_async_scope final
+{
+    log_async_scope ()
+    {
+        log_async_attach ();
+    }
+
+    ~log_async_scope ()
+    {
+        log_async_detach ();
+    }
+
+    log_async_scope (log_async_scope const &) = delete;
+    log_async_scope & operator= (log_async_scope const &) = delete;
+
+}; // end of class
+
 } // end of 'util'
 } // end of namespace
 //............................................................................
@@ -0,0 +1,451 @@
+
+#include "vr/util/logging.h"
+
+#include "vr/asserts.h"
+#include "vr/config.h"
+#include "vr/mc/mc.h" // compiler_fence(), volatile_cast()
+#include "vr/sys/os.h"
+#include "vr/util/datetime.h"
+#include "vr/util/env.h"
+
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace util
+{
+namespace impl_log
+{
+//............................................................................
+//............................................................................
+namespace
+{
+
+constexpr int32_t ring_capacity_log2 ()     { return 20; } // 1MiB per attached thread
+constexpr timestamp_t idle_sleep ()         { return 200 * _1_microsecond (); }
+
+constexpr int32_t align8 (int32_t const x)  { return ((x + 7) & ~7); }
+
+//............................................................................
+/*
+ * a byte ring of variable-length frames, each starting with an 8-byte length (negative
+ * for padding that skips to the end of the ring); like 'mc::lf_spsc_buffer', this relies
+ * on x86-TSO for correctness (no atomic RMW ops or fences other than compiler ones)
+ */
+class log_ring final: noncopyable
+{
+    public: // ...............................................................
+
+        static constexpr int64_t capacity ()    { return (1L << ring_capacity_log2 ()); }
+
+
+        log_ring () :
+            m_data { std::make_unique<char []> (capacity ()) }
+        {
+        }
+
+        // producer:
+
+        /*
+         * @return 'false' if there isn't enough room (the record is then dropped)
+         */
+        bool push (char const * const record, int32_t const size)
+        {
+            int64_t const len = align8 (sizeof (int64_t) + size);
+            int64_t pos = m_p_position;
+
+            int64_t const pad = ((pos & (capacity () - 1)) + len > capacity () ? capacity () - (pos & (capacity () - 1)) : 0);
+
+            if (VR_UNLIKELY (pos + pad + len - m_c_local > capacity ()))
+            {
+                m_c_local = mc::volatile_cast (m_c_position);
+
+                if (pos + pad + len - m_c_local > capacity ())
+                {
+                    mc::volatile_cast (m_dropped) = m_dropped + 1;
+                    return false;
+                }
+            }
+
+            if (pad)
+            {
+                * reinterpret_cast<int64_t *> (& m_data [pos & (capacity () - 1)]) = - pad;
+                pos += pad;
+            }
+
+            char * const frame = & m_data [pos & (capacity () - 1)];
+
+            * reinterpret_cast<int64_t *> (frame) = len;
+            std::memcpy (frame + sizeof (int64_t), record, size);
+
+            mc::compiler_fence ();
+            mc::volatile_cast (m_p_position) = pos + len; // publish
+
+            return true;
+        }
+
+        // consumer:
+
+        /*
+         * invoke 'f (record_header const &)' on all records published so far
+         *
+         * @return number of records consumed
+         */
+        template<typename F>
+        int32_t drain (F && f)
+        {
+            int64_t const p_pos = mc::volatile_cast (m_p_position);
+            mc::compiler_fence ();
+
+            int64_t c_pos = m_c_position;
+            int32_t r { };
+
+            while (c_pos < p_pos)
+            {
+                char const * const frame = & m_data [c_pos & (capacity () - 1)];
+                int64_t const len = * reinterpret_cast<int64_t const *> (frame);
+
+                if (len > 0)
+                {
+                    f (* reinterpret_cast<record_header const *> (frame + sizeof (int64_t)));
+                    ++ r;
+
+                    c_pos += len;
+                }
+                else
+                    c_pos -= len;
+            }
+
+            mc::compiler_fence ();
+            mc::volatile_cast (m_c_position) = c_pos; // release space
+
+            return r;
+        }
+
+        bool empty () const
+        {
+            return (mc::volatile_cast (m_c_position) >= mc::volatile_cast (m_p_position));
+        }
+
+        int64_t const & p_position () const
+        {
+            return m_p_position;
+        }
+
+        int64_t c_position () const
+        {
+            return mc::volatile_cast (m_c_position);
+        }
+
+        int64_t dropped () const
+        {
+            return mc::volatile_cast (m_dropped);
+        }
+
+    private: // ..............................................................
+
+        std::unique_ptr<char []> const m_data;
+
+        alignas (64) int64_t m_p_position { };  // [owned by P, read by C]
+        int64_t m_c_local { };                  // [P's cached copy of 'm_c_position']
+        int64_t m_dropped { };                  // [owned by P, read by C]
+
+        alignas (64) int64_t m_c_position { };  // [owned by C, read by P]
+
+}; // end of class
+//............................................................................
+
+struct producer_slot final
+{
+    producer_slot () :
+        m_producer { & m_ring, m_text }
+    {
+    }
+
+    log_ring m_ring { };
+    std::ostringstream m_text { };
+    producer m_producer;                // references 'm_ring' and 'm_text'
+    int64_t m_dropped_reported { };     // [owned by the backend thread]
+    bool m_detached { false };          // [written by P under the backend lock]
+
+}; // end of class
+//............................................................................
+
+void
+decode (record_header const & h, std::ostream & os)
+{
+    char const * a = reinterpret_cast<char const *> (& h + 1);
+    char const * const a_limit = a + h.m_size;
+
+    os << '[' << print_timestamp (h.m_ts) << "] ";
+
+    while (a < a_limit)
+    {
+        arg_tag const tag = static_cast<arg_tag> (* a ++);
+
+        switch (tag)
+        {
+#       define vr_CASE(tag, type) \
+            case tag: { type v; std::memcpy (& v, a, sizeof (v)); a += sizeof (v); os << v; } break; \
+            /* */
+
+            vr_CASE (tag_i64,   int64_t)
+            vr_CASE (tag_u64,   uint64_t)
+            vr_CASE (tag_f64,   double)
+            vr_CASE (tag_char,  char)
+            vr_CASE (tag_bool,  bool)
+            vr_CASE (tag_ptr,   void const *)
+
+#       undef vr_CASE
+
+            case tag_str:
+            {
+                uint32_t n;
+                std::memcpy (& n, a, sizeof (n));
+                a += sizeof (n);
+
+                os.write (a, n);
+                a += n;
+            }
+            break;
+
+            default: VR_ASSUME_UNREACHABLE (tag);
+
+        } // end of switch
+    }
+
+    if (h.m_truncated) os << " [TRUNCATED]";
+}
+//............................................................................
+
+class backend final: noncopyable
+{
+    public: // ...............................................................
+
+        backend ()  = default;
+
+        ~backend ()
+        {
+            if (m_thread.joinable ())
+            {
+                mc::volatile_cast (m_stop) = true;
+                m_thread.join ();
+            }
+        }
+
+
+        producer * attach ()
+        {
+            std::unique_ptr<producer_slot> s { std::make_unique<producer_slot> () };
+            producer * const p = & s->m_producer;
+
+            {
+                boost::mutex::scoped_lock _ { m_lock };
+
+                m_slots.push_back (std::move (s)); // last use of 's'
+
+                if (! m_thread.joinable ())
+                {
+                    m_thread = boost::thread { [this]() { run (); } };
+                }
+            }
+
+            return p;
+        }
+
+        void detach (producer * const p)
+        {
+            flush (p);
+
+            boost::mutex::scoped_lock _ { m_lock };
+
+            for (auto const & s : m_slots)
+            {
+                if (& s->m_producer == p)
+                {
+                    s->m_detached = true; // the backend will reclaim it
+                    break;
+                }
+            }
+        }
+
+        void flush (producer * const p)
+        {
+            log_ring const & r = * static_cast<log_ring const *> (p->m_ring);
+
+            int64_t const target = r.p_position ();
+
+            while (r.c_position () < target)
+            {
+                if (VR_UNLIKELY (mc::volatile_cast (m_stop))) break; // the backend thread is gone (process exit)
+
+                sys::short_sleep_for (idle_sleep () / 4);
+            }
+        }
+
+    private: // ..............................................................
+
+        int32_t drain_all ()
+        {
+            int32_t r { };
+
+            boost::mutex::scoped_lock _ { m_lock };
+
+            for (auto i = m_slots.begin (); i != m_slots.end (); )
+            {
+                producer_slot & s = ** i;
+
+                bool const detached = s.m_detached; // read before draining
+
+                r += s.m_ring.drain ([](record_header const & h)
+                    {
+                        ::google::LogMessage msg { h.m_file, h.m_line, h.m_severity };
+                        decode (h, msg.stream ());
+                    });
+
+                int64_t const dropped = s.m_ring.dropped ();
+                if (VR_UNLIKELY (dropped != s.m_dropped_reported))
+                {
+                    ::google::LogMessage { __FILE__, __LINE__, ::google::GLOG_WARNING }.stream () << "async logging: dropped " << (dropped - s.m_dropped_reported) << " record(s) (ring full)";
+                    s.m_dropped_reported = dropped;
+                }
+
+                if (detached && s.m_ring.empty ())
+                    i = m_slots.erase (i);
+                else
+                    ++ i;
+            }
+
+            return r;
+        }
+
+        void run ()
+        {
+            while (! mc::volatile_cast (m_stop))
+            {
+                if (! drain_all ())
+                    sys::short_sleep_for (idle_sleep ());
+            }
+
+            drain_all (); // final
+        }
+
+
+        boost::mutex m_lock { }; // protects 'm_slots' (producers only lock it to attach/detach)
+        std::vector<std::unique_ptr<producer_slot>> m_slots { };
+        boost::thread m_thread { };
+        bool m_stop { false };
+
+}; // end of class
+
+backend &
+get_backend ()
+{
+    static backend g_backend { }; // note: its destructor does a final drain
+
+    return g_backend;
+}
+
+} // end of anonymous
+//............................................................................
+//............................................................................
+
+void
+commit (producer & p)
+{
+    record_header & h = * reinterpret_cast<record_header *> (p.m_data);
+
+    h.m_ts = sys::realtime_utc ();
+
+    static_cast<log_ring *> (p.m_ring)->push (p.m_data, p.m_position);
+}
+
+void
+end_text (producer & p)
+{
+    std::ostringstream & os = static_cast<std::ostringstream &> (p.m_text);
+
+    p.m_text_mode = false;
+    {
+        std::string const s { os.str () };
+
+        // append as a 'tag_str' (can't use 'log_line::put_str()' here):
+
+        int32_t const pos = p.m_position;
+        int32_t const room = producer::capacity () - (pos + 1 + static_cast<int32_t> (sizeof (uint32_t)));
+
+        if (room >= 0)
+        {
+            uint32_t const n = std::min<int64_t> (s.size (), room);
+
+            p.m_data [pos] = tag_str;
+            std::memcpy (p.m_data + pos + 1, & n, sizeof (n));
+            std::memcpy (p.m_data + pos + 1 + sizeof (n), s.data (), n);
+
+            p.m_position = pos + 1 + sizeof (n) + n;
+
+            if (n < s.size ()) reinterpret_cast<record_header *> (p.m_data)->m_truncated = true;
+        }
+        else
+            reinterpret_cast<record_header *> (p.m_data)->m_truncated = true;
+    }
+
+    // reset to default state:
+
+    static std::ios const g_default_state { nullptr };
+
+    os.str (std::string { });
+    os.clear ();
+    os.copyfmt (g_default_state);
+}
+
+} // end of 'impl_log'
+//............................................................................
+//............................................................................
+
+bool
+log_async_attach ()
+{
+    impl_log::producer * & p = impl_log::tls_producer ();
+    if (p) return true;
+
+    if (! util::getenv<bool> (VR_ENV_LOG_ASYNC, false)) return false; // note: re-read on every attach
+
+    p = impl_log::get_backend ().attach ();
+
+    LOG_trace1 << "attached to async logging";
+    return true;
+}
+
+void
+log_async_detach ()
+{
+    impl_log::producer * & p = impl_log::tls_producer ();
+    if (p == nullptr) return;
+
+    impl_log::producer * const p_saved = p;
+    p = nullptr; // this thread is back to sync mode
+
+    impl_log::get_backend ().detach (p_saved);
+}
+
+void
+log_async_flush ()
+{
+    impl_log::producer * const p = impl_log::tls_producer ();
+    if (p == nullptr) return;
+
+    impl_log::get_backend ().flush (p);
+}
+
+} // end of 'util'
+} // end of namespace
+//----------------------------------------------------------------------------
@@ -0,0 +1,299 @@
+
+#include "vr/config.h"
+#include "vr/sys/os.h"
+#include "vr/util/datetime.h"
+#include "vr/util/logging.h"
+
+#include "vr/test/utility.h"
+
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <cstdlib>
+#include <iomanip>
+#include <utility>
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace util
+{
+//............................................................................
+//............................................................................
+namespace
+{
+
+class capturing_sink final: public ::google::LogSink
+{
+    public: // ...............................................................
+
+        capturing_sink ()
+        {
+            ::google::AddLogSink (this);
+        }
+
+        ~capturing_sink ()
+        {
+            ::google::RemoveLogSink (this);
+        }
+
+        void send (::google::LogSeverity const severity, char const * const full_filename, char const * const base_filename, int const line,
+                   struct ::tm const * const tm_time, char const * const message, std::size_t const message_len) override
+        {
+            boost::mutex::scoped_lock _ { m_lock };
+
+            m_messages.emplace_back (message, message_len);
+        }
+
+        string_vector messages ()
+        {
+            boost::mutex::scoped_lock _ { m_lock };
+
+            return m_messages;
+        }
+
+    private: // ..............................................................
+
+        boost::mutex m_lock { };
+        string_vector m_messages { };
+
+}; // end of class
+
+struct opaque final // formatted on the calling thread
+{
+    int32_t m_v;
+
+    friend std::ostream & operator<< (std::ostream & os, opaque const & obj)
+    {
+        return os << "opaque{" << obj.m_v << '}';
+    }
+
+}; // end of class
+
+/*
+ * split an async record's text into its "[<capture ts>] " prefix and the rest
+ */
+std::pair<std::string, std::string>
+split_capture_ts (std::string const & m)
+{
+    std::size_t const end = m.find ("] ");
+    if ((m.empty () || (m [0] != '[')) || (end == std::string::npos))
+        return { { }, m };
+
+    return { m.substr (1, end - 1), m.substr (end + 2) };
+}
+
+string_vector
+strip_capture_ts (string_vector const & messages)
+{
+    string_vector r { };
+
+    for (std::string const & m : messages)
+    {
+        auto const ts_text = split_capture_ts (m);
+        EXPECT_FALSE (ts_text.first.empty ()) << "no capture ts prefix: " << m;
+
+        r.push_back (ts_text.second);
+    }
+
+    return r;
+}
+
+} // end of anonymous
+
+class log_async: public ::testing::Test
+{
+    protected: // ............................................................
+
+        void TearDown () override
+        {
+            ::unsetenv (VR_ENV_LOG_ASYNC); // don't leak async mode into other tests
+        }
+
+}; // end of class
+//............................................................................
+//............................................................................
+
+TEST_F (log_async, disabled)
+{
+    ::unsetenv (VR_ENV_LOG_ASYNC);
+
+    boost::thread t { []()
+        {
+            log_async_scope const _ { };
+
+            ASSERT_FALSE (log_async_attach ());
+        }};
+    t.join ();
+}
+
+TEST_F (log_async, formatting)
+{
+    ::setenv (VR_ENV_LOG_ASYNC, "1", 1);
+
+    int8_t const i1 { -1 };
+    uint16_t const u2 { 65535 };
+    int64_t const i8 { std::numeric_limits<int64_t>::min () };
+    uint64_t const u8 { std::numeric_limits<uint64_t>::max () };
+    float const f4 { 1.5 };
+    double const f8 { -1.0 / 3 };
+    void const * const ptr { & i8 };
+    std::string const s { "a std::string" };
+    char const * const cs { "a C string" };
+
+    string_vector expected;
+    {
+        std::ostringstream os;
+        os << i1 << ' ' << u2 << ' ' << i8 << ' ' << u8 << ' ' << f4 << ' ' << f8 << ' ' << true << ' ' << ptr << ' ' << s << ' ' << cs << '|' << "literal";
+        expected.push_back (os.str ());
+    }
+    {
+        std::ostringstream os;
+        os << "x = " << opaque { 123 } << ", " << std::hex << 255 << ' ' << std::setw (6) << std::setfill ('0') << 17 << " " << s;
+        expected.push_back (os.str ());
+    }
+    {
+        std::ostringstream os;
+        os << 255 << " (formatting state was reset)";
+        expected.push_back (os.str ());
+    }
+
+    capturing_sink sink { };
+
+    boost::thread t { [&]()
+        {
+            log_async_scope const _ { };
+
+            ASSERT_TRUE (log_async_attach ()); // idempotent
+
+            LOG_info << i1 << ' ' << u2 << ' ' << i8 << ' ' << u8 << ' ' << f4 << ' ' << f8 << ' ' << true << ' ' << ptr << ' ' << s << ' ' << cs << '|' << "literal";
+            LOG_warn << "x = " << opaque { 123 } << ", " << std::hex << 255 << ' ' << std::setw (6) << std::setfill ('0') << 17 << " " << s;
+            LOG_error << 255 << " (formatting state was reset)";
+
+            log_async_flush ();
+        }};
+    t.join ();
+
+    string_vector const actual = strip_capture_ts (sink.messages ());
+
+    ASSERT_EQ (expected.size (), actual.size ());
+    for (std::size_t i = 0; i < expected.size (); ++ i)
+    {
+        EXPECT_EQ (expected [i], actual [i]) << " [record #" << i << ']';
+    }
+}
+
+TEST_F (log_async, truncation)
+{
+    ::setenv (VR_ENV_LOG_ASYNC, "1", 1);
+
+    capturing_sink sink { };
+
+    boost::thread t { []()
+        {
+            log_async_scope const _ { };
+
+            LOG_info << std::string (100000, 'x') << " this won't fit";
+        }}; // detach() flushes
+    t.join ();
+
+    string_vector const actual = strip_capture_ts (sink.messages ());
+
+    ASSERT_EQ (1, signed_cast (actual.size ()));
+    EXPECT_EQ (0, actual [0].find ("xxxxxxxx"));
+    EXPECT_LT (actual [0].size (), 100000U);
+    EXPECT_NE (std::string::npos, actual [0].find ("[TRUNCATED]"));
+}
+
+TEST_F (log_async, ordering)
+{
+    ::setenv (VR_ENV_LOG_ASYNC, "1", 1);
+
+    int32_t const thread_count  = 2;
+    int32_t const record_count  = 20000; // per thread, enough to wrap the ring a few times
+
+    capturing_sink sink { };
+    {
+        boost::thread_group tg { };
+
+        for (int32_t t = 0; t < thread_count; ++ t)
+        {
+            tg.create_thread ([t]()
+                {
+                    log_async_scope const _ { };
+
+                    for (int32_t i = 0; i < record_count; ++ i)
+                    {
+                        LOG_info << 'T' << t << ':' << i;
+
+                        if ((i & 1023) == 1023) log_async_flush (); // don't overrun the ring
+                    }
+                });
+        }
+
+        tg.join_all ();
+    }
+
+    string_vector const actual = strip_capture_ts (sink.messages ());
+    ASSERT_EQ (thread_count * record_count, signed_cast (actual.size ()));
+
+    // records from any given thread must be in program order:
+
+    std::vector<int32_t> next (thread_count, 0);
+
+    for (std::string const & m : actual)
+    {
+        ASSERT_EQ ('T', m [0]) << m;
+
+        std::size_t const colon = m.find (':');
+        ASSERT_NE (std::string::npos, colon) << m;
+
+        int32_t const t = std::stoi (m.substr (1, colon - 1));
+        int32_t const i = std::stoi (m.substr (colon + 1));
+
+        ASSERT_EQ (next [t], i) << m;
+        ++ next [t];
+    }
+}
+
+TEST_F (log_async, capture_time)
+{
+    ::setenv (VR_ENV_LOG_ASYNC, "1", 1);
+
+    timestamp_t ts_before { }, ts_after { };
+
+    capturing_sink sink { };
+
+    boost::thread t { [&]()
+        {
+            log_async_scope const _ { };
+
+            ts_before = sys::realtime_utc ();
+            LOG_info << "captured";
+            ts_after = sys::realtime_utc ();
+
+            sys::short_sleep_for (100 * _1_millisecond ()); // make write time lag capture time
+
+            log_async_flush ();
+        }};
+    t.join ();
+
+    string_vector const actual = sink.messages ();
+    ASSERT_EQ (1, signed_cast (actual.size ()));
+
+    auto const ts_text = split_capture_ts (actual [0]);
+    EXPECT_EQ ("captured", ts_text.second);
+
+    // same fixed-width format, so these compare lexicographically:
+
+    std::string const before = string_cast (print_timestamp (ts_before));
+    std::string const after = string_cast (print_timestamp (ts_after));
+
+    ASSERT_EQ (before.size (), ts_text.first.size ()) << actual [0];
+    EXPECT_LE (before, ts_text.first);
+    EXPECT_LE (ts_text.first, after);
+}
+
+} // end of 'util'
+} // end of namespace
+//----------------------------------------------------------------------------
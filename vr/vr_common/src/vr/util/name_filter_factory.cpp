@@ -3,6 +3,7 @@
 
 #include "vr/io/files.h" // read_lines()
 #include "vr/util/parse.h" // split()
+#include "vr/util/parse/compiled_expr.h"
 
 //----------------------------------------------------------------------------
 namespace vr
@@ -10,12 +11,44 @@ namespace vr
 namespace util
 {
 //............................................................................
+//............................................................................
+namespace
+{
+
+bool
+is_logical_expr (std::string const & spec)
+{
+    static boost::regex const g_lop_re { R"((^|.*[\s(])(AND|OR|NOT)([\s(].*|$))" };
+
+    return boost::regex_match (spec, g_lop_re);
+}
+
+} // end of anonymous
+//............................................................................
+//............................................................................
+
+expr_name_filter::expr_name_filter (std::string const & spec)
+{
+    parse::compiled_expr const expr { spec };
+
+    string_vector const & leaves = expr.leaves ();
+
+    m_default = expr.evaluate (0);
+
+    for (int32_t l = 0, l_limit = leaves.size (); l < l_limit; ++ l)
+    {
+        m_values.emplace (leaves [l], expr.evaluate (static_cast<parse::compiled_expr::bitset_type> (1) << l));
+    }
+}
+//............................................................................
 
 name_filter
 name_filter_factory::create (std::string const & spec)
 {
     if (spec.size () > 1 && spec [0] == '@') // an "@-file"
         return set_name_filter { io::read_lines (spec.substr (1)) };
+    else if (is_logical_expr (spec))
+        return expr_name_filter { spec };
     else if (spec.find (',') != std::string::npos) // {comma, space}-delimited set of strings
         return set_name_filter { util::split (spec, ", ") };
 
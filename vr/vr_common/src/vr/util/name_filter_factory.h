@@ -2,17 +2,62 @@
 
 #include "vr/strings.h"
 
+#include <boost/unordered_map.hpp>
+
 //----------------------------------------------------------------------------
 namespace vr
 {
 namespace util
 {
+/**
+ * a filter for logical expressions over names, e.g. "(BHP OR RIO OR CBA) AND NOT RIO"
+ * (an identifier matches a name that is equal to it)
+ *
+ * since a given name can be equal to at most one identifier, the expression is compiled
+ * (see @ref parse::compiled_expr) and evaluated once per distinct identifier (plus once
+ * for "no identifier matched") at construction time; after that matching a name is a single
+ * hash lookup
+ */
+class expr_name_filter final
+{
+        using map_type              = boost::unordered_map<std::string, bool>;
+
+    public: // ...............................................................
+
+        /**
+         * @throws parse_failure on invalid 'spec'
+         */
+        expr_name_filter (std::string const & spec);
+
+        // name_filter:
+
+        VR_ASSUME_HOT bool operator() (std::string const & s) const
+        {
+            auto const i = m_values.find (s);
+
+            return (i == m_values.end () ? m_default : i->second);
+        }
+
+    private: // ..............................................................
+
+        map_type m_values { }; // leaf image -> expression value when only that leaf is 'true'
+        bool m_default { };    // expression value when all leaves are 'false'
+
+}; // end of class
+//............................................................................
 /**
  */
 class name_filter_factory: noncopyable
 {
     public: // ...............................................................
 
+        /**
+         * @param spec one of
+         *  - "@<file>": a set of names read from a file, one per line;
+         *  - a logical expression using 'AND', 'OR', 'NOT' and parentheses (see @ref expr_name_filter);
+         *  - a {comma, space}-delimited set of names;
+         *  - a regex
+         */
         static name_filter create (std::string const & spec);
 
 }; // end of class
@@ -0,0 +1,54 @@
+
+#include "vr/util/name_filter_factory.h"
+
+#include "vr/test/utility.h"
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace util
+{
+//............................................................................
+
+TEST (name_filter_factory, create)
+{
+    // set:
+    {
+        name_filter const nf = name_filter_factory::create ("BHP, RIO,CBA");
+
+        EXPECT_TRUE (nf ("BHP"));
+        EXPECT_TRUE (nf ("CBA"));
+        EXPECT_FALSE (nf ("ANZ"));
+    }
+    // regex:
+    {
+        name_filter const nf = name_filter_factory::create ("B.P|ORG");
+
+        EXPECT_TRUE (nf ("BHP"));
+        EXPECT_TRUE (nf ("ORG"));
+        EXPECT_FALSE (nf ("RIO"));
+    }
+    // logical expression:
+    {
+        name_filter const nf = name_filter_factory::create ("(BHP OR RIO OR CBA) AND NOT RIO");
+
+        EXPECT_TRUE (nf ("BHP"));
+        EXPECT_TRUE (nf ("CBA"));
+        EXPECT_FALSE (nf ("RIO"));
+        EXPECT_FALSE (nf ("ANZ"));
+    }
+    {
+        name_filter const nf = name_filter_factory::create ("NOT (BHP OR RIO)"); // everything but
+
+        EXPECT_FALSE (nf ("BHP"));
+        EXPECT_FALSE (nf ("RIO"));
+        EXPECT_TRUE (nf ("ANZ"));
+        EXPECT_TRUE (nf ("ORG"));
+    }
+
+    EXPECT_THROW (name_filter_factory::create ("BHP OR OR RIO"), parse_failure);
+}
+
+} // end of 'util'
+} // end of namespace
+//----------------------------------------------------------------------------
@@ -5,12 +5,14 @@
 #include "vr/util/classes.h" // destruct()
 #include "vr/util/logging.h"
 #include "vr/util/memory.h"
+#include "vr/util/type_traits.h"
 #include "vr/sys/os.h"
 
 #include <boost/integer/static_min_max.hpp>
 #include <boost/math/common_factor_ct.hpp> // note: moved to boost.integer in 1.66+
 
 #include <tuple>
+#include <vector>
 
 //----------------------------------------------------------------------------
 namespace vr
@@ -91,6 +93,95 @@ class fixed_size_allocator_base
         std::unique_ptr</* owning */addr_t []> m_chunks; // dynamically growable array of chunks (size managed by subclass)
 
 }; // end of class
+//............................................................................
+/*
+ * 'T::cold_type' if 'T' declares it, 'void' otherwise
+ */
+template<typename T, typename = void>
+struct cold_type_of
+{
+    using type          = void;
+
+}; // end of master
+
+template<typename T>
+struct cold_type_of<T, util::void_t<typename T::cold_type>>
+{
+    using type          = typename T::cold_type;
+
+}; // end of specialization
+//............................................................................
+/*
+ * a chunked array of 'T_COLD' slots that parallels an allocator's slots (and is
+ * indexed by the same refs); chunks are added lazily as higher refs are seated
+ */
+template<typename T_COLD, std::size_t CHUNK_CAPACITY, typename T_FAST_REF>
+class cold_storage
+{
+    private: // ..............................................................
+
+        using slot          = typename std::aligned_storage<sizeof (T_COLD), alignof (T_COLD)>::type;
+
+        static constexpr T_FAST_REF chunk_index_shift   = meta::static_log2_floor<CHUNK_CAPACITY>::value;
+        static constexpr T_FAST_REF chunk_offset_mask   = (CHUNK_CAPACITY - 1);
+
+    public: // ...............................................................
+
+        // ACCESSORs:
+
+        VR_FORCEINLINE T_COLD const & cold (T_FAST_REF const ref) const
+        {
+            assert_within (ref >> chunk_index_shift, m_chunks.size ());
+
+            return reinterpret_cast<T_COLD const &> (m_chunks [ref >> chunk_index_shift][ref & chunk_offset_mask]);
+        }
+
+        // MUTATORs:
+
+        VR_FORCEINLINE T_COLD & cold (T_FAST_REF const ref)
+        {
+            return const_cast<T_COLD &> (const_cast<cold_storage const *> (this)->cold (ref));
+        }
+
+    protected: // ............................................................
+
+        VR_FORCEINLINE void construct (T_FAST_REF const ref)
+        {
+            if (VR_UNLIKELY ((ref >> chunk_index_shift) >= m_chunks.size ()))
+                add_chunks (ref >> chunk_index_shift);
+
+            new (& cold (ref)) T_COLD { };
+        }
+
+        VR_FORCEINLINE void destruct (T_FAST_REF const ref)
+        {
+            util::destruct (cold (ref));
+        }
+
+    private: // ..............................................................
+
+        VR_ASSUME_COLD VR_NOINLINE void add_chunks (T_FAST_REF const chunk_index)
+        {
+            while (m_chunks.size () <= chunk_index)
+            {
+                m_chunks.emplace_back (std::make_unique<slot []> (CHUNK_CAPACITY));
+            }
+        }
+
+
+        std::vector<std::unique_ptr<slot []>> m_chunks { };
+
+}; // end of class
+
+template<std::size_t CHUNK_CAPACITY, typename T_FAST_REF>
+class cold_storage<void, CHUNK_CAPACITY, T_FAST_REF> // no cold fields
+{
+    protected: // ............................................................
+
+        VR_FORCEINLINE void construct (T_FAST_REF const ref)    { }
+        VR_FORCEINLINE void destruct (T_FAST_REF const ref)     { }
+
+}; // end of specialization
 
 } // end of 'impl'
 //............................................................................
@@ -378,13 +469,20 @@ using default_pool_options_t        = typename pool_options<T, int32_t>::type;
  * @note this implementation can separate allocated slots from free slots and hence
  *       destruct all allocated slots on pool destruction (client code does not have
  *       to explicitly release all "leftover" objects after it's done using a pool)
+ *
+ * if 'T' declares a nested 'cold_type' (typically made from the 'meta::cold<>' fields
+ * of a schema, see @ref meta::cold_schema_t), each slot also gets a (value-initialized)
+ * 'cold_type' instance that is kept in a separate parallel array and is accessible via
+ * 'cold(ref)': this keeps rarely used fields from diluting the cache lines occupied by 'T's
  */
 template<typename T, typename OPTIONS = default_pool_options_t<T> >
-class object_pool: protected fixed_size_allocator<sizeof (T), alignof (T), OPTIONS>
+class object_pool: protected fixed_size_allocator<sizeof (T), alignof (T), OPTIONS>,
+                   public impl::cold_storage<typename impl::cold_type_of<T>::type, OPTIONS::chunk_capacity (), typename fixed_size_allocator<sizeof (T), alignof (T), OPTIONS>::fast_pointer_type>
 {
     private: // ..............................................................
 
         using super         = fixed_size_allocator<sizeof (T), alignof (T), OPTIONS>;
+        using cold_super    = impl::cold_storage<typename impl::cold_type_of<T>::type, OPTIONS::chunk_capacity (), typename super::fast_pointer_type>;
 
     public: // ...............................................................
 
@@ -394,6 +492,9 @@ class object_pool: protected fixed_size_allocator<sizeof (T), alignof (T), OPTIO
         using typename super::pointer_type;
         using typename super::size_type;
 
+        using value_type        = T;
+        using cold_type         = typename impl::cold_type_of<T>::type; // 'void' if 'T' has no cold part
+
         using alloc_result      = std::tuple<T &, pointer_type>;
 
         /**
@@ -417,6 +518,8 @@ class object_pool: protected fixed_size_allocator<sizeof (T), alignof (T), OPTIO
             {
                 T & obj = dereference<false> (ref);
                 util::destruct (obj);
+
+                cold_super::destruct (ref);
             }
         }
 
@@ -458,6 +561,7 @@ class object_pool: protected fixed_size_allocator<sizeof (T), alignof (T), OPTIO
             typename super::alloc_result const ar = super::allocate ();
 
             new (ar.first) T { std::forward<ARGs> (args) ... };
+            cold_super::construct (ar.second);
 
             return std::forward_as_tuple (* static_cast<T *> (ar.first), ar.second);
         }
@@ -467,6 +571,7 @@ class object_pool: protected fixed_size_allocator<sizeof (T), alignof (T), OPTIO
          */
         void release (fast_pointer_type const ref)
         {
+            cold_super::destruct (ref);
             super::template destruct<T> (ref);
         }
 
@@ -361,6 +361,88 @@ TYPED_TEST (object_pool_test, object_lifecycle)
 
     EXPECT_EQ (IC::instance_count (), iIC_start);
 }
+//............................................................................
+//............................................................................
+namespace
+{
+
+struct CC final: public virtual test::instance_counter<CC> // a "cold" part
+{
+    std::string m_s;
+
+}; // end of class
+
+struct HC final // a "hot" part
+{
+    using cold_type     = CC;
+
+    int32_t m_i4;
+
+}; // end of class
+
+} // end of anonymous
+//............................................................................
+//............................................................................
+/*
+ * 'cold_type' slots follow their hot slots through allocation, recycling and
+ * pool destruction
+ */
+TEST (object_pool, cold_storage)
+{
+    using pool_type         = object_pool<HC>;
+
+    vr_static_assert (std::is_same<pool_type::cold_type, CC>::value);
+    vr_static_assert (std::is_same<object_pool<T>::cold_type, void>::value);
+
+    vr_static_assert (pool_type::options::storage_size () == sizeof (HC)); // cold part is not stored inline
+
+    int32_t const count     = 3 * pool_type::options::chunk_capacity () + 1; // span several chunks
+
+    auto const iCC_start    = CC::instance_count ();
+    {
+        pool_type pool { };
+
+        std::vector<pool_type::pointer_type> refs { };
+
+        for (int32_t i = 0; i < count; ++ i)
+        {
+            auto const ar = pool.allocate (HC { i });
+            auto const ref = std::get<1> (ar);
+
+            ASSERT_TRUE (pool.cold (ref).m_s.empty ()); // value-initialized
+            pool.cold (ref).m_s = string_cast (i);
+
+            refs.push_back (ref);
+        }
+        EXPECT_EQ (CC::instance_count (), iCC_start + count);
+
+        for (int32_t i = 0; i < count; ++ i)
+        {
+            ASSERT_EQ (pool [refs [i]].m_i4, i);
+            ASSERT_EQ (pool.cold (refs [i]).m_s, string_cast (i));
+        }
+
+        // release every other object, then re-allocate into the recycled slots:
+
+        for (int32_t i = 0; i < count; i += 2) pool.release (refs [i]);
+        EXPECT_EQ (CC::instance_count (), iCC_start + count / 2);
+
+        for (int32_t i = 0; i < count; i += 2)
+        {
+            auto const ar = pool.allocate (HC { - i });
+            refs [i] = std::get<1> (ar);
+
+            ASSERT_TRUE (pool.cold (refs [i]).m_s.empty ()); // recycled slots are value-initialized, too
+        }
+        EXPECT_EQ (CC::instance_count (), iCC_start + count);
+
+        pool.check ();
+    }
+
+    // 'pool' destructed, leftover cold parts must have been destructed as well:
+
+    EXPECT_EQ (CC::instance_count (), iCC_start);
+}
 
 } // end of 'util'
 } // end of namespace
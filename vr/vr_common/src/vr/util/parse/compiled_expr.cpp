@@ -0,0 +1,124 @@
+
+#include "vr/util/parse/compiled_expr.h"
+
+#include "vr/util/logging.h"
+#include "vr/util/parse/expr_parser.h"
+
+#include <algorithm>
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace util
+{
+namespace parse
+{
+//............................................................................
+
+compiled_expr::compiled_expr (expr_node const & root)
+{
+    int32_t depth { };
+    int32_t max_depth { };
+
+    compile (root, depth, max_depth);
+
+    assert_eq (depth, 1);
+    check_le (max_depth, compiled_expr::max_depth ());
+
+    int32_t const leaf_count = m_leaves.size ();
+
+    m_leaf_mask = (leaf_count < max_leaf_count () ? (static_cast<bitset_type> (1) << leaf_count) - 1 : static_cast<bitset_type> (-1));
+
+    if (leaf_count <= 6) // 2^6 truth table entries fit in a 'bitset_type'
+    {
+        for (bitset_type v = 0; v <= m_leaf_mask; ++ v)
+        {
+            m_table |= (static_cast<bitset_type> (run (v)) << v);
+        }
+
+        m_has_table = true;
+    }
+
+    LOG_trace2 << "compiled " << leaf_count << " leaf/leaves into " << size () << " op(s), max stack depth " << max_depth << (m_has_table ? " (tabulated)" : "");
+}
+
+compiled_expr::compiled_expr (std::string const & spec) :
+    compiled_expr (* parse_expr (spec)) // 'parse_expr()' throws on failure
+{
+}
+//............................................................................
+
+int32_t
+compiled_expr::leaf_index (std::string const & image) const
+{
+    auto const i = std::find (m_leaves.begin (), m_leaves.end (), image);
+
+    return (i == m_leaves.end () ? -1 : static_cast<int32_t> (i - m_leaves.begin ()));
+}
+//............................................................................
+
+void
+compiled_expr::compile (expr_node const & node, int32_t & depth, int32_t & max_depth)
+{
+    switch (node.m_type)
+    {
+        case node_type::identifier:
+        {
+            std::string const & image = static_cast<identifier const &> (node).m_image;
+
+            int32_t ix = leaf_index (image);
+            if (ix < 0)
+            {
+                ix = m_leaves.size ();
+                check_lt (ix, max_leaf_count ());
+
+                m_leaves.push_back (image);
+            }
+
+            m_program.push_back ({ op_push, static_cast<uint8_t> (ix) });
+            max_depth = std::max (max_depth, ++ depth);
+        }
+        break;
+
+        case node_type::logical_expr:
+        {
+            logical_expr const & le = static_cast<logical_expr const &> (node);
+
+            switch (le.m_op)
+            {
+                case lop::NOT:
+                {
+                    compile (* le.m_rhs, depth, max_depth);
+
+                    m_program.push_back ({ op_not, 0 });
+                }
+                break;
+
+                case lop::AND:
+                case lop::OR:
+                {
+                    binary_logical_expr const & be = static_cast<binary_logical_expr const &> (le);
+
+                    compile (* be.m_lhs, depth, max_depth);
+                    compile (* be.m_rhs, depth, max_depth);
+
+                    m_program.push_back ({ (le.m_op == lop::AND ? op_and : op_or), 0 });
+                    -- depth;
+                }
+                break;
+
+                default: VR_ASSUME_UNREACHABLE (le.m_op);
+
+            } // end of switch
+        }
+        break;
+
+        default: VR_ASSUME_UNREACHABLE (node.m_type);
+
+    } // end of switch
+}
+
+} // end of 'parse'
+} // end of 'util'
+} // end of namespace
+//----------------------------------------------------------------------------
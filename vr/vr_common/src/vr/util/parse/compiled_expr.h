@@ -0,0 +1,122 @@
+#pragma once
+
+#include "vr/util/parse/expressions.h"
+
+#include <vector>
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace util
+{
+namespace parse
+{
+/**
+ * a logical expression (as parsed by @ref parse_expr()) flattened into a postfix
+ * program over at most 64 distinct identifiers ("leaves")
+ *
+ * evaluation takes a bitmask of leaf values (bit 'i' is the value of @ref leaves()[i])
+ * and runs the program over a 64-bit stack of bits, so it never allocates and has no
+ * data-dependent branches other than the opcode dispatch; for expressions with at most
+ * 6 distinct leaves the entire truth table is precomputed and evaluation is a single
+ * shift of a 64-bit word
+ */
+class compiled_expr final
+{
+    public: // ...............................................................
+
+        using bitset_type       = bitset64_t;
+
+        static constexpr int32_t max_leaf_count ()  { return (8 * sizeof (bitset_type)); }
+        static constexpr int32_t max_depth ()       { return (8 * sizeof (bitset_type)); }
+
+
+        compiled_expr (expr_node const & root);
+        compiled_expr (std::string const & spec); // convenience: 'parse_expr (spec)' + compile
+
+        // ACCESSORs:
+
+        /**
+         * @return distinct identifier images, in the order of first appearance in the expression
+         */
+        string_vector const & leaves () const
+        {
+            return m_leaves;
+        }
+
+        /**
+         * @return index of identifier 'image' within @ref leaves() [-1 if not a leaf]
+         */
+        int32_t leaf_index (std::string const & image) const;
+
+        /**
+         * @return program length (in ops)
+         */
+        int32_t size () const
+        {
+            return m_program.size ();
+        }
+
+        /**
+         * @param leaf_values bit 'i' is the value of leaf 'i' [bits past @ref leaves() size are ignored]
+         */
+        VR_ASSUME_HOT bool evaluate (bitset_type const leaf_values) const
+        {
+            if (m_has_table)
+                return ((m_table >> (leaf_values & m_leaf_mask)) & 1);
+
+            return run (leaf_values);
+        }
+
+    private: // ..............................................................
+
+        enum opcode : uint8_t
+        {
+            op_push,    // push leaf 'm_arg'
+            op_not,
+            op_and,
+            op_or
+        };
+
+        struct op final
+        {
+            opcode m_code;
+            uint8_t m_arg;
+
+        }; // end of nested class
+
+
+        void compile (expr_node const & node, int32_t & depth, int32_t & max_depth);
+
+        VR_ASSUME_HOT bool run (bitset_type const leaf_values) const
+        {
+            bitset_type s { }; // bit stack, top at bit 0
+
+            for (op const o : m_program)
+            {
+                switch (o.m_code)
+                {
+                    case op_push:   s = ((s << 1) | ((leaf_values >> o.m_arg) & 1)); break;
+                    case op_not:    s ^= 1; break;
+                    case op_and:    s = ((s >> 1) & (s | ~static_cast<bitset_type> (1))); break;
+                    case op_or:     s = ((s >> 1) | (s & 1)); break;
+
+                } // end of switch
+            }
+
+            return (s & 1);
+        }
+
+
+        std::vector<op> m_program { };
+        string_vector m_leaves { };
+        bitset_type m_table { };        // valid iff 'm_has_table'
+        bitset_type m_leaf_mask { };
+        bool m_has_table { false };
+
+}; // end of class
+
+} // end of 'parse'
+} // end of 'util'
+} // end of namespace
+//----------------------------------------------------------------------------
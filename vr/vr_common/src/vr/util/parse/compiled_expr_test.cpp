@@ -0,0 +1,127 @@
+
+#include "vr/util/parse/compiled_expr.h"
+#include "vr/util/parse/expr_parser.h"
+
+#include "vr/test/utility.h"
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace util
+{
+namespace parse
+{
+//............................................................................
+//............................................................................
+namespace
+{
+
+std::string
+random_expr (int32_t const leaf_count, int32_t const size, uint64_t & rnd)
+{
+    if (size <= 1)
+        return ("L" + string_cast (test::next_random (rnd) % leaf_count));
+
+    switch (test::next_random (rnd) % 4)
+    {
+        case 0: return ("NOT " + random_expr (leaf_count, size - 1, rnd));
+        case 1: return ("(" + random_expr (leaf_count, size - 1, rnd) + ")");
+
+        default:
+        {
+            int32_t const lsize = 1 + test::next_random (rnd) % (size - 1);
+
+            return (random_expr (leaf_count, lsize, rnd) + ((test::next_random (rnd) & 1) ? " AND " : " OR ") + random_expr (leaf_count, size - lsize, rnd));
+        }
+
+    } // end of switch
+}
+
+// reference: walk the parse tree
+
+bool
+tree_evaluate (expr_node const & node, compiled_expr const & expr, compiled_expr::bitset_type const leaf_values)
+{
+    if (node.m_type == node_type::identifier)
+    {
+        int32_t const l = expr.leaf_index (static_cast<identifier const &> (node).m_image);
+        check_nonnegative (l);
+
+        return ((leaf_values >> l) & 1);
+    }
+
+    logical_expr const & le = static_cast<logical_expr const &> (node);
+
+    switch (le.m_op)
+    {
+        case lop::NOT: return (! tree_evaluate (* le.m_rhs, expr, leaf_values));
+
+        case lop::AND: return (tree_evaluate (* static_cast<binary_logical_expr const &> (le).m_lhs, expr, leaf_values) && tree_evaluate (* le.m_rhs, expr, leaf_values));
+        case lop::OR:  return (tree_evaluate (* static_cast<binary_logical_expr const &> (le).m_lhs, expr, leaf_values) || tree_evaluate (* le.m_rhs, expr, leaf_values));
+
+        default: VR_ASSUME_UNREACHABLE (le.m_op);
+
+    } // end of switch
+}
+
+} // end of anonymous
+//............................................................................
+//............................................................................
+
+TEST (compiled_expr, simple)
+{
+    compiled_expr const expr { "(a OR b) AND NOT c" };
+
+    ASSERT_EQ (expr.leaves (), (string_vector { "a", "b", "c" }));
+    EXPECT_EQ (expr.leaf_index ("c"), 2);
+    EXPECT_EQ (expr.leaf_index ("d"), -1);
+
+    EXPECT_FALSE (expr.evaluate (0b000));
+    EXPECT_TRUE  (expr.evaluate (0b001));
+    EXPECT_TRUE  (expr.evaluate (0b010));
+    EXPECT_TRUE  (expr.evaluate (0b011));
+    EXPECT_FALSE (expr.evaluate (0b100));
+    EXPECT_FALSE (expr.evaluate (0b111));
+
+    // repeated identifiers share a leaf:
+    {
+        compiled_expr const e { "a AND NOT a" };
+
+        ASSERT_EQ (e.leaves ().size (), 1);
+        EXPECT_FALSE (e.evaluate (0));
+        EXPECT_FALSE (e.evaluate (1));
+    }
+
+    EXPECT_THROW (compiled_expr { "a AND" }, parse_failure);
+}
+/*
+ * compare against tree walking for random expressions, both small enough to be
+ * tabulated and not
+ */
+TEST (compiled_expr, vs_tree)
+{
+    uint64_t rnd = test::env::random_seed<uint64_t> ();
+
+    for (int32_t const leaf_count : { 1, 3, 6, 12, 40 })
+    {
+        for (int32_t repeat = 0; repeat < 200; ++ repeat)
+        {
+            std::string const spec = random_expr (leaf_count, 2 + test::next_random (rnd) % 60, rnd);
+
+            std::unique_ptr<expr_node> const tree { parse_expr (spec) };
+            compiled_expr const expr { * tree };
+
+            for (int32_t v = 0; v < 200; ++ v)
+            {
+                compiled_expr::bitset_type const leaf_values = test::next_random (rnd);
+
+                ASSERT_EQ (expr.evaluate (leaf_values), tree_evaluate (* tree, expr, leaf_values)) << "spec: " << spec << ", leaf values: " << std::hex << leaf_values;
+            }
+        }
+    }
+}
+
+} // end of 'parse'
+} // end of 'util'
+} // end of namespace
+//----------------------------------------------------------------------------
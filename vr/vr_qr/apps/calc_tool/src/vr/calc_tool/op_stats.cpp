@@ -11,6 +11,7 @@
 #include "vr/io/stream_factory.h"
 #include "vr/market/books/asx/market_data_listener.h"
 #include "vr/market/books/asx/market_data_view.h"
+#include "vr/market/books/asx/trade_signals.h"
 #include "vr/market/books/book_event_context.h"
 #include "vr/market/sources/asx/itch/ITCH_pipeline.h"
 #include "vr/rt/cfg/app_cfg.h"
@@ -67,6 +68,10 @@ run (std::string const & cfg_name, fs::path const & in_root, util::date_t const
             }
         };
 
+        using signals_type      = trade_signals<>;
+
+        signals_type signals { static_cast<int32_t> (mdv.size ()) }; // same windows as live agents get from 'market_data_manager'
+
         using reader            = cap_reader;
 
         // consume all glimpse data:
@@ -116,11 +121,13 @@ run (std::string const & cfg_name, fs::path const & in_root, util::date_t const
             using selector          = view::instrument_selector<visit_ctx>;
             using listener          = market_data_listener<this_source (), book_type, visit_ctx>;
             using stats             = stats_calc<view, visit_ctx>;
+            using signal_tracker    = signals_type::tracker<view, visit_ctx>;
 
             using pipeline          = ITCH_pipeline
                                     <
                                         selector,
                                         stats, // needs to be ahead of the book listener to handle final fills
+                                        signal_tracker, // ditto
                                         listener
                                     >;
 
@@ -133,6 +140,7 @@ run (std::string const & cfg_name, fs::path const & in_root, util::date_t const
                     { "tz",         tz },
 
                     { "view",       std::cref (mdv) }, // TODO support std::ref
+                    { "trade_signals", & signals },
                     { "out_dir",    out_dir },
                     { "ref_data",   std::cref (rd) },
                 }
@@ -147,6 +155,20 @@ run (std::string const & cfg_name, fs::path const & in_root, util::date_t const
                 r.evaluate (ctx, v);
             }
             v.get<stats> ().emit (std::cerr); // dump stats
+
+            // dump trade signal windows as of each instrument's last trade:
+
+            std::cerr << "iid,ts_last,px_last,count,qty,px_vwap,qty_signed" << std::endl;
+
+            for (auto const & e : mdv)
+            {
+                auto const & s = signals [mdv.liid_of (* field<_value_> (e))];
+                auto const & h = s.horizon<signals_type::horizon_count () - 1> (); // longest horizon
+
+                std::cerr << field<_key_> (e) << ',' << s.ts_last () << ',' << price_book_to_print (s.price_last ())
+                          << ',' << h.count () << ',' << h.volume () << ',' << price_book_to_print (h.VWAP ()) << ',' << h.signed_volume ()
+                          << std::endl;
+            }
         }
         LOG_info << "[itch DONE]";
     }
@@ -13,7 +13,7 @@ VR_APP_MAIN ()
 
     bpopt::options_description opts { "usage: " + sys::proc_name () + " [options] <op> [op options]" };
     opts.add_options ()
-        ("op",          bpopt::value<std::string> ()->value_name ("<op>")->required (),  "operation ('dump|test')")
+        ("op",          bpopt::value<std::string> ()->value_name ("<op>")->required (),  "operation ('dump|export|test')")
         ("op_args",     bpopt::value<string_vector> (),                                  "operation options")
     ;
 
@@ -32,6 +32,7 @@ VR_APP_MAIN ()
         switch (str_hash_32 (op))
         {
             case "dump"_hash:       rc = op_dump (op_args); break;
+            case "export"_hash:     rc = op_export (op_args); break;
             case "test"_hash:       rc = op_test (op_args); break;
 
             default: { rc = 1; std::cerr << "unrecognized option '" << op << "'\n" << opts; }
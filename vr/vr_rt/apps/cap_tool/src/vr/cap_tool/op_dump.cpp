@@ -42,6 +42,7 @@ struct run_args final
     std::string const m_tz;
     bitset128_t const m_mf;
     std::set<int64_t> const & m_iidf;
+    std::string const m_symf;
     bitset32_t const m_ptf;
     bitset32_t const m_pf;
 
@@ -127,6 +128,7 @@ run_impl (std::istream & in, run_args const & args, cap_format::enum_t const for
             { "prefix",         args.m_prefix },
             { "messages",       args.m_mf },
             { "instruments",    args.m_iidf },
+            { "symbols",        args.m_symf },
             { "products",       args.m_ptf },
             { "partitions",     args.m_pf }
         }
@@ -187,6 +189,7 @@ op_dump (string_vector const & av)
     std::string date_override { };
     std::string tz { "Australia/Sydney" };
     std::string partitions { };
+    std::string symbols { };
     bool prefix { false };
 
     bpopt::options_description opts { "usage: " + sys::proc_name () + " dump [options] file" };
@@ -199,6 +202,7 @@ op_dump (string_vector const & av)
         ("time_zone,z",     bpopt::value (& tz)->value_name ("TIMEZONE"), "tz for timestamps [default: Australia/Sydney]")
         ("message,m",       bpopt::value<std::vector<char> > (), "message type(s) to include [default: all except 'seconds']")
         ("iid,s",           bpopt::value<std::vector<int64_t> > (), "symbol iids to include [default: all]")
+        ("symbols,S",       bpopt::value (& symbols)->value_name ("SPEC"), "symbols to include: a set, regex, @file or a logical expression, e.g. \"(BHP OR RIO) AND NOT CBA\" [default: all]")
         ("product,p",       bpopt::value<string_vector> (), "product type(s) to include [default: all]")
         ("partitions,P",    bpopt::value (& partitions)->value_name ("<num,num,...>"), "partition(s) to include [default: all]")
         ("prefix",          bpopt::bool_switch (& prefix), "print detailed message headers [default: false]")
@@ -293,6 +297,13 @@ op_dump (string_vector const & av)
             LOG_info << "[filtering for " << iidf.size () << " instrument(s): " << print (iidf) << ']';
         }
 
+        // symbol(s):
+
+        if (! symbols.empty ())
+        {
+            LOG_info << "[filtering for symbol(s): " << print (symbols) << ']';
+        }
+
         // ITCH product type:
 
         bitset32_t ptf { static_cast<bitset32_t> (-1) }; // default to "all"
@@ -317,7 +328,7 @@ op_dump (string_vector const & av)
             for (int32_t pix : ps) pf |= (1 << pix);
         }
 
-        run_args const rargs { kind, io_mode, prefix, date, tz, mf, iidf, ptf, pf };
+        run_args const rargs { kind, io_mode, prefix, date, tz, mf, iidf, symbols, ptf, pf };
 
         run (* in, rargs, format);
     }
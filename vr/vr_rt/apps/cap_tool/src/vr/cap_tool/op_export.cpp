@@ -0,0 +1,295 @@
+#include "vr/cap_tool/ops.h"
+
+#include "vr/cap_tool/util/op_common.h"
+
+#include "vr/io/cap/cap_reader.h"
+#include "vr/io/files.h"
+#include "vr/io/net/IP_.h"
+#include "vr/io/net/pcap_.h"
+#include "vr/io/net/UDP_.h"
+#include "vr/io/stream_factory.h"
+#include "vr/market/events/market_event_context.h"
+#include "vr/market/sources/asx/itch/ITCH_exporter.h"
+#include "vr/market/sources/asx/itch/ITCH_filters.h"
+#include "vr/market/sources/asx/itch/ITCH_pipeline.h"
+#include "vr/market/sources/asx/itch/Mold_frame_.h"
+#include "vr/sys/os.h"
+#include "vr/util/argparse.h"
+#include "vr/util/datetime.h"
+#include "vr/util/logging.h"
+#include "vr/util/parse.h"
+
+#include <boost/thread/thread.hpp>
+
+#include <atomic>
+#include <bitset>
+#include <exception>
+#include <map>
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+using namespace io;
+using namespace io::net;
+using namespace market;
+
+//............................................................................
+//............................................................................
+namespace
+{
+
+struct run_args final
+{
+    fs::path const m_out_root;
+    io::format::enum_t const m_format;
+    io::clobber::enum_t const m_clobber;
+    io::filter::enum_t const m_filter;
+    int32_t const m_rows;
+    bitset128_t const m_mf;
+    std::set<int64_t> const & m_iidf;
+    std::string const m_symf;
+    bitset32_t const m_pf;
+    boost::mutex * const m_io_mutex; // serializes output I/O across work items and writers [HDF only]
+
+}; // end of class
+//............................................................................
+/*
+ * a unit of parallel work: one (pcap ITCH) capture file, decoded once with rows routed
+ * into per-partition frames (each written out by a writer thread of its own)
+ */
+struct work_item final
+{
+    fs::path m_in_file;
+    util::date_t m_date;
+
+}; // end of class
+//............................................................................
+
+void
+run_item (work_item const & item, run_args const & args)
+{
+    using namespace ASX;
+
+    using reader            = cap_reader;
+
+    using ctx               = market_event_context<_ts_origin_, _packet_index_, _partition_, _ts_local_, _ts_local_delta_, _seqnum_, _dst_port_>;
+
+    using exporter          = ITCH_exporter<ctx>; // note: 'ITCH_ts_tracker' base requires '_partition_'
+
+    using pipeline          = ITCH_pipeline
+                            <
+                                ITCH_message_filter<ctx>,
+                                ITCH_iid_filter<ctx>,
+
+                                exporter
+                            >;
+    using visitor           = pcap_<IP_<UDP_<Mold_frame_<pipeline>>>>;
+
+    fs::path const out_dir = args.m_out_root / gd::to_iso_string (item.m_date); // [partitions go into 'P<pix>' subdirs]
+
+    visitor v
+    {
+        {
+            { "out_dir",        out_dir },
+            { "format",         args.m_format },
+            { "clobber",        args.m_clobber },
+            { "filter",         args.m_filter },
+            { "rows",           args.m_rows },
+            { "messages",       args.m_mf },
+            { "instruments",    args.m_iidf },
+            { "symbols",        args.m_symf },
+            { "partitions",     args.m_pf },
+            { "io_mutex",       args.m_io_mutex },
+            { "writer_threads", true }
+        }
+    };
+
+    std::unique_ptr<std::istream> const in = io::stream_factory::open_input (item.m_in_file);
+
+    LOG_info << "exporting " << print (item.m_in_file) << " into " << print (out_dir) << " ...";
+
+    ctx c { };
+    reader r { * in, cap_format::pcap };
+
+    r.evaluate (c, v);
+
+    v.get<exporter> ().close (); // flush and close output frames (on this thread, so that failures propagate)
+}
+//............................................................................
+
+void
+run (std::vector<work_item> const & items, run_args const & args, int32_t const thread_count)
+{
+    std::atomic<int32_t> next_item { 0 };
+    std::exception_ptr failure { };
+    std::atomic_flag failure_lock = ATOMIC_FLAG_INIT;
+
+    auto const worker = [&]()
+        {
+            for (int32_t i; (i = next_item ++) < signed_cast (items.size ()); )
+            {
+                try
+                {
+                    run_item (items [i], args);
+                }
+                catch (...)
+                {
+                    if (! failure_lock.test_and_set ()) failure = std::current_exception (); // first failure wins
+                    next_item = items.size (); // stop handing out work
+                }
+            }
+        };
+
+    LOG_info << "exporting " << items.size () << " work item(s) on " << thread_count << " decoding thread(s), with a writer thread per partition ...";
+
+    timestamp_t const ts_start = sys::realtime_utc ();
+    {
+        std::vector<boost::thread> threads { };
+
+        for (int32_t t = 0; t < thread_count; ++ t)
+        {
+            threads.emplace_back (worker);
+        }
+
+        for (boost::thread & t : threads) t.join ();
+    }
+
+    if (failure) std::rethrow_exception (failure);
+
+    LOG_info << "export done in " << ((sys::realtime_utc () - ts_start) / _1_millisecond ()) << " ms";
+}
+
+}// end of anonymous
+//----------------------------------------------------------------------------
+
+int32_t
+op_export (string_vector const & av)
+{
+    string_vector in_files { };
+    fs::path out_root { };
+    std::string format_str { "HDF" };
+    std::string filter_str { "none" };
+    std::string date_override { };
+    std::string partitions { };
+    std::string symbols { };
+    int32_t thread_count { };
+    int32_t rows { 64 * 1024 };
+    bool overwrite { false };
+
+    bpopt::options_description opts { "usage: " + sys::proc_name () + " export [options] file(s)" };
+    opts.add_options ()
+        ("input,i",         bpopt::value (& in_files)->value_name ("FILE")->required (), "input pathname(s) (pcap ITCH captures)")
+        ("out,o",           bpopt::value (& out_root)->value_name ("DIR")->required (), "output root dir (frames go into <DIR>/<date>/P<partition>/)")
+        ("format,f",        bpopt::value (& format_str)->value_name ("HDF|CSV"), "output format [default: HDF]")
+        ("filter",          bpopt::value (& filter_str)->value_name ("none|zlib|blosc"), "HDF compression filter [default: none]")
+        ("date,d",          bpopt::value (& date_override)->value_name ("DATE"), "capture date (single input only) [default: infer from pathname]")
+        ("message,m",       bpopt::value<std::vector<char> > (), "message type(s) to include [default: all exported]")
+        ("iid,s",           bpopt::value<std::vector<int64_t> > (), "symbol iids to include [default: all]")
+        ("symbols,S",       bpopt::value (& symbols)->value_name ("SPEC"), "symbols to include: a set, regex, @file or a logical expression, e.g. \"(BHP OR RIO) AND NOT CBA\" [default: all]")
+        ("partitions,P",    bpopt::value (& partitions)->value_name ("<num,num,...>"), "partition(s) to include [default: all]")
+        ("threads,t",       bpopt::value (& thread_count)->value_name ("N"), "number of decoding threads [default: one per file, up to the PU count]")
+        ("rows",            bpopt::value (& rows)->value_name ("N"), "frame buffer size, in rows [default: 64K]")
+        ("overwrite",       bpopt::bool_switch (& overwrite), "overwrite existing output files [default: false]")
+
+        ("help,h",  "print usage information")
+        ("version", "print build version")
+    ;
+
+    bpopt::positional_options_description popts { };
+    popts.add ("input", -1);    // alias all positional options
+
+    int32_t rc { };
+    try
+    {
+        VR_ARGPARSE (av, opts, popts);
+
+        check_condition (date_override.empty () || (in_files.size () == 1), in_files.size ());
+
+        // message(s):
+
+        bitset128_t mf { ~(_one_128 () << ASX::itch::message_type::seconds) }; // [non-exported types are skipped by 'ITCH_exporter']
+        if (args.count ("message"))
+        {
+            std::vector<char> const messages = args ["message"].as<std::vector<char> > ();
+
+            mf = 0;
+            for (char m : messages) mf |= (_one_128 () << static_cast<uint32_t> (m));
+            LOG_info << "[filtering for message type(s): " << print (messages) << ']';
+        }
+
+        // iid(s):
+
+        std::set<int64_t> iidf { }; // default to "no iid filtering"
+        if (args.count ("iid"))
+        {
+            std::vector<int64_t> const instruments = args ["iid"].as<std::vector<int64_t> > ();
+            for (auto const & iid : instruments) iidf.insert (iid);
+            LOG_info << "[filtering for " << iidf.size () << " instrument(s): " << print (iidf) << ']';
+        }
+
+        // symbol(s):
+
+        if (! symbols.empty ())
+        {
+            LOG_info << "[filtering for symbol(s): " << print (symbols) << ']';
+        }
+
+        // ASX partition mask:
+
+        bitset32_t pf { static_cast<bitset32_t> ((1 << ASX::partition_count ()) - 1) }; // default to "all"
+        if (! partitions.empty ())
+        {
+            std::vector<int32_t> const ps { util::parse_int_list<int32_t> (partitions) };
+
+            pf = 0;
+            for (int32_t pix : ps)
+            {
+                check_within (pix, ASX::partition_count ());
+                pf |= (1 << pix);
+            }
+        }
+
+        // work items, one per file (with distinct dates, as those name the output dirs):
+
+        std::vector<work_item> items { };
+        std::map<util::date_t, fs::path> date_files { };
+
+        for (std::string const & f : in_files)
+        {
+            fs::path const in_file { f };
+            check_condition (boost::regex_match (in_file.filename ().native (), pcap_regex ()), in_file); // TODO Soup-framed ITCH (glimpse)
+
+            util::date_t const date = (date_override.empty () ? util::extract_date (io::weak_canonical_path (in_file).native ()) : util::parse_date (date_override));
+            check_condition (! date.is_special ());
+
+            auto const i = date_files.emplace (date, in_file);
+            if (! i.second)
+                throw_x (invalid_input, "inputs " + print (i.first->second) + " and " + print (in_file) + " have the same date " + gd::to_iso_string (date));
+
+            items.push_back ({ in_file, date });
+        }
+        check_nonempty (items);
+
+        if (thread_count <= 0)
+            thread_count = std::min<int32_t> (items.size (), std::max<int32_t> (1, boost::thread::hardware_concurrency ()));
+        else
+            thread_count = std::min<int32_t> (items.size (), thread_count);
+
+        io::format::enum_t const format = to_enum<io::format> (format_str);
+        boost::mutex io_mutex { }; // HDF5 is not thread-safe
+
+        run_args const rargs { out_root, format, (overwrite ? io::clobber::trunc : io::clobber::error), to_enum<io::filter> (filter_str), rows, mf, iidf, symbols, pf, (format == io::format::HDF ? & io_mutex : nullptr) };
+
+        run (items, rargs, thread_count);
+    }
+    catch (std::exception const & e)
+    {
+        rc = 2;
+        LOG_error << exc_info (e);
+    }
+
+    return rc;
+}
+
+} // end of namespace
+//----------------------------------------------------------------------------
@@ -9,6 +9,9 @@ namespace vr
 extern int32_t
 op_dump (string_vector const & av);
 
+extern int32_t
+op_export (string_vector const & av);
+
 extern int32_t
 op_test (string_vector const & av);
 
@@ -28,6 +28,7 @@
 #include "vr/mc/bound_runnable.h"
 #include "vr/mc/spinlock.h"
 #include "vr/util/memory.h"
+#include "vr/util/name_filter_factory.h"
 #include "vr/util/parse.h"
 
 #include <iostream>
@@ -451,7 +452,7 @@ class itch_session::itch_session_runnable final: public mc::bound_runnable
                 {
                     std::lock_guard<lock_type> _ { m_lock };
 
-                    return m_rt_ref_data.list_symbols (regex_name_filter { re }, out);
+                    return m_rt_ref_data.list_symbols (util::name_filter_factory::create (re), out);
                 }
             }
             else if (args.count ("name"))
@@ -461,7 +462,7 @@ class itch_session::itch_session_runnable final: public mc::bound_runnable
                 {
                     std::lock_guard<lock_type> _ { m_lock };
 
-                    return m_rt_ref_data.list_names (regex_name_filter { re }, out);
+                    return m_rt_ref_data.list_names (util::name_filter_factory::create (re), out);
                 }
             }
             else if (args.count ("iid"))
@@ -47,7 +47,7 @@ run (settings const & app_cfg, scope_path const & itch_cfg_path, scope_path cons
     if (! itch_cfg_path.empty ())
         app.add ("server.itch",     new mock_mcast_server { itch_cfg_path });
     if (! ouch_cfg_path.empty ())
-        app.add ("server.ouch",     new mock_ouch_server { ouch_cfg_path });
+        app.add ("server.ouch",     new mock_ouch_server { ouch_cfg_path, (itch_cfg_path.empty () ? "" : "server.itch") }); // share the ITCH replay clock, if any
 
 
     app.start ();
@@ -13,6 +13,7 @@
 #include "vr/io/sql/sql_connection_factory.h"
 #include "vr/io/stream_factory.h"
 #include "vr/market/events/market_event_context.h"
+#include "vr/market/ref/asx/ref_image.h"
 #include "vr/market/sources/asx/itch/ITCH_filters.h"
 #include "vr/market/sources/asx/itch/ITCH_pipeline.h"
 #include "vr/rt/cfg/resources.h"
@@ -24,6 +25,7 @@
 #include "vr/util/logging.h"
 #include "vr/util/parse.h"
 
+#include <algorithm>
 #include <iterator>
 
 //----------------------------------------------------------------------------
@@ -125,7 +127,22 @@ process_date (fs::path const & root_dir, util::date_t const & date, std::string
 }
 
 void
-run (vr::json const & cfg, fs::path const & root_dir, std::tuple<util::date_t, util::date_t> const & dates, std::string const & tz, bitset32_t const ptf)
+write_image (fs::path const & out_file, util::date_t const & date, instrument_map const & im)
+{
+    std::vector<ASX::instrument> instruments { };
+    instruments.reserve (im.size ());
+
+    for (auto const & kv : im) instruments.push_back (kv.second);
+
+    // make the output deterministic:
+
+    std::sort (instruments.begin (), instruments.end (), [](ASX::instrument const & lhs, ASX::instrument const & rhs) { return (lhs.symbol () < rhs.symbol ()); });
+
+    ASX::ref_image::write (out_file, date, instruments);
+}
+
+void
+run (vr::json const & cfg, fs::path const & root_dir, std::tuple<util::date_t, util::date_t> const & dates, std::string const & tz, bitset32_t const ptf, fs::path const & image_file)
 {
     util::di::container app { join_as_name (sys::proc_name (), net::hostname ()) };
 
@@ -144,6 +161,7 @@ run (vr::json const & cfg, fs::path const & root_dir, std::tuple<util::date_t, u
             auto tx { instruments.tx_begin () }; // do all of the DAO I/O within one transaction
 
             std::unique_ptr<instrument_map> im_prev { };
+            util::date_t d_prev { };
 
             for (auto d = std::get<0> (dates); d <= std::get<1> (dates); d += gd::days { 1 })
             {
@@ -198,9 +216,17 @@ run (vr::json const & cfg, fs::path const & root_dir, std::tuple<util::date_t, u
                 LOG_info << '[' << d << "]: found " << im->size () << " instrument(s), changed " << change_count;
 
                 im_prev.swap (im);
+                d_prev = d;
             }
 
             tx.commit ();
+
+            if (! image_file.empty ())
+            {
+                check_nonnull (im_prev); // no data in the date range
+
+                write_image (image_file, d_prev, * im_prev); // the universe as of the last date with data
+            }
         }
     }
     app.stop ();
@@ -215,6 +241,7 @@ op_make_ref (string_vector const & av)
     std::string cfg_name { };
     fs::path in_root { };
     fs::path out_file { };
+    fs::path image_file { };
     std::string tz { "Australia/Sydney" };
     std::string date_range_str { };
 
@@ -223,6 +250,7 @@ op_make_ref (string_vector const & av)
         ("config,c",        bpopt::value (& cfg_name)->value_name ("FILE|NAME"), "configuration file/ID")
         ("in,i",            bpopt::value (& in_root)->value_name ("DIR")->required (), "input dir")
         ("out,o",           bpopt::value (& out_file)->value_name ("FILE")->required (), "output db file")
+        ("image",           bpopt::value (& image_file)->value_name ("FILE"), "also write a binary ref image as of the last date with data")
         ("date_range,d",    bpopt::value (& date_range_str)->value_name ("DATE-DATE")->required (), "capture date range (inclusive)")
         ("time_zone,z",     bpopt::value (& tz)->value_name ("TIMEZONE"), "tz for timestamps [default: Australia/Sydney]")
         ("product,p",       bpopt::value<string_vector> (), "product type(s) to include [default: all]")
@@ -261,7 +289,7 @@ op_make_ref (string_vector const & av)
             LOG_info << "[filtering for products type(s): " << print (products) << ']';
         }
 
-        run (cfg, in_root, dates, tz, ptf);
+        run (cfg, in_root, dates, tz, ptf, image_file);
     }
     catch (std::exception const & e)
     {
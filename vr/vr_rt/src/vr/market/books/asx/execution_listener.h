@@ -72,7 +72,7 @@ class execution_listener<source::ASX, EXECUTION_BOOK, CTX, DERIVED>: public ASX:
 
             DLOG_trace2 << "visit: " << msg;
 
-            otk_type const & otk = otk_of<_otk_> (msg); // lookup by otk is the only option
+            otk_type const otk = otk_of<_otk_> (msg); // lookup by otk is the only option
             order_type * const o_ptr = m_book.m_otk_map.get (static_cast<otk_storage_type> (otk));
 
             if (VR_LIKELY (o_ptr != nullptr))
@@ -157,7 +157,7 @@ class execution_listener<source::ASX, EXECUTION_BOOK, CTX, DERIVED>: public ASX:
 
             DLOG_trace2 << "visit: " << msg;
 
-            otk_type const & otk = otk_of<_otk_> (msg); // lookup by otk is the only option
+            otk_type const otk = otk_of<_otk_> (msg); // lookup by otk is the only option
             order_type * const o_ptr = m_book.m_otk_map.get (static_cast<otk_storage_type> (otk));
 
             if (VR_LIKELY (o_ptr != nullptr))
@@ -383,16 +383,20 @@ class execution_listener<source::ASX, EXECUTION_BOOK, CTX, DERIVED>: public ASX:
         using fsm_bitset_t  = typename meta::find_field_def_t<_state_, order_type>::value_type::bitset_type;
 
         /*
-         * taking perf advantage of our token scheme:
+         * full-width tokens (our token scheme) cost about the same as reading the wire
+         * field in place, blank-padded ones are decoded properly
          *
          * TODO handle the blank token cancel special case
          */
         template<typename TAG, typename MSG>
-        static VR_FORCEINLINE otk_type const & otk_of (MSG const & msg)
+        static VR_FORCEINLINE otk_type otk_of (MSG const & msg)
         {
             vr_static_assert (has_field<TAG, MSG> ());
 
-            return (* reinterpret_cast<otk_type const *> (& field<TAG> (msg)[0]));
+            otk_type r;
+            copy_from_alphanum (field<TAG> (msg), r);
+
+            return r;
         }
 
         EXECUTION_BOOK & m_book;
@@ -0,0 +1,206 @@
+
+#include "vr/macros.h" // VR_RELEASE
+#if VR_RELEASE // perf testcases in release builds only
+
+#include "vr/market/books/execution_order_book.h"
+#include "vr/market/rt/asx/utility.h" // order_token_generator
+#include "vr/market/sources/asx/schema.h"
+#include "vr/util/logging.h"
+
+#include "vr/test/timing.h"
+#include "vr/test/utility.h"
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace market
+{
+namespace ASX
+{
+//............................................................................
+//............................................................................
+namespace
+{
+
+struct order final
+{
+    int64_t m_id;
+
+}; // end of class
+
+using otk_map           = ex::impl::make_otk_map<order_token, order>::type; // same as 'execution_listener' uses
+using otk_storage_type  = order_token::storage_type;
+
+//............................................................................
+// otk decoding alternatives:
+
+/*
+ * a straightforward impl: strip trailing blanks, then construct from a char range
+ */
+VR_FORCEINLINE order_token
+decode_scalar (otk_ft const & f)
+{
+    int32_t size = order_token::max_size ();
+    while (size && (f [size - 1] == ' ')) -- size;
+
+    return { f.data (), size };
+}
+
+/*
+ * what 'execution_listener' does
+ */
+VR_FORCEINLINE order_token
+decode_vectorized (otk_ft const & f)
+{
+    order_token r;
+    copy_from_alphanum (f, r);
+
+    return r;
+}
+
+/*
+ * reading the wire field in place (a lower bound, valid only for full-width tokens
+ * like the ones 'order_token_generator' makes)
+ */
+VR_FORCEINLINE order_token const &
+decode_in_place (otk_ft const & f)
+{
+    return (* reinterpret_cast<order_token const *> (& f [0]));
+}
+//............................................................................
+
+template<typename F>
+VR_NOINLINE int64_t
+measure (F && f, int32_t const passes)
+{
+    int64_t best { std::numeric_limits<int64_t>::max () };
+
+    for (int32_t pass = 0; pass < passes; ++ pass)
+    {
+        int64_t tsc = VR_TSC_START ();
+        {
+            f ();
+        }
+        VR_TSC_STOP (tsc);
+
+        best = std::min (best, tsc);
+    }
+
+    return best;
+}
+
+} // end of anonymous
+//............................................................................
+//............................................................................
+
+TEST (perf_execution_listener, otk_lookup)
+{
+    int32_t const order_count   = 4 * 1024;
+    int32_t const lookup_count  = 64 * 1024;
+    int32_t const passes        = 20;
+
+    std::vector<order> orders (order_count);
+    std::vector<order_token> otks;
+
+    otk_map map { 2 * order_count };
+
+    uint32_t counter { 100 };
+    for (int32_t o = 0; o < order_count; ++ o)
+    {
+        order_token const otk = order_token_generator::make_with_prefix<1> (counter ++, 0xA);
+
+        orders [o].m_id = o;
+        otks.push_back (otk);
+
+        map.put (static_cast<otk_storage_type> (otk), & orders [o]);
+    }
+
+    // wire images of a random sequence of tokens, as they would appear in OUCH messages:
+
+    uint64_t rnd = test::env::random_seed<uint64_t> ();
+
+    std::vector<order_token> src (lookup_count);
+    std::vector<otk_ft> wire (lookup_count);
+    {
+        for (int32_t i = 0; i < lookup_count; ++ i)
+        {
+            src [i] = otks [test::next_random (rnd) % order_count];
+
+            fill_alphanum<' '> (wire [i]);
+            copy_to_alphanum (src [i], wire [i]);
+        }
+    }
+
+    int64_t const tsc_overhead = test::tsc_macro_overhead ();
+    int64_t checksum { };
+
+    // encode (emit side):
+
+    std::vector<otk_ft> dst (wire);
+
+    int64_t const encode_memcpy = measure ([&]()
+        {
+            for (int32_t i = 0; i < lookup_count; ++ i)
+            {
+                order_token const & otk = src [i];
+                std::memcpy (dst [i].data (), otk.data (), otk.size ()); // previous impl
+            }
+        }, passes) - tsc_overhead;
+
+    int64_t const encode_vectorized = measure ([&]()
+        {
+            for (int32_t i = 0; i < lookup_count; ++ i)
+            {
+                copy_to_alphanum (src [i], dst [i]);
+            }
+        }, passes) - tsc_overhead;
+
+    // decode + lookup (listener side):
+
+    int64_t const lookup_scalar = measure ([&]()
+        {
+            for (int32_t i = 0; i < lookup_count; ++ i)
+            {
+                order const * const o = map.get (static_cast<otk_storage_type> (decode_scalar (wire [i])));
+                checksum += o->m_id;
+            }
+        }, passes) - tsc_overhead;
+
+    int64_t const lookup_vectorized = measure ([&]()
+        {
+            for (int32_t i = 0; i < lookup_count; ++ i)
+            {
+                order const * const o = map.get (static_cast<otk_storage_type> (decode_vectorized (wire [i])));
+                checksum += o->m_id;
+            }
+        }, passes) - tsc_overhead;
+
+    int64_t const lookup_in_place = measure ([&]()
+        {
+            for (int32_t i = 0; i < lookup_count; ++ i)
+            {
+                order const * const o = map.get (static_cast<otk_storage_type> (decode_in_place (wire [i])));
+                checksum += o->m_id;
+            }
+        }, passes) - tsc_overhead;
+
+    double const n = lookup_count;
+
+    LOG_info << "otk encode (cycles/op): memcpy " << std::setprecision (3) << (encode_memcpy / n) << ", vectorized " << (encode_vectorized / n);
+    LOG_info << "otk decode+lookup (cycles/op): scalar " << (lookup_scalar / n) << ", vectorized " << (lookup_vectorized / n)
+             << ", in-place " << (lookup_in_place / n) << " (checksum " << checksum << ')';
+
+    // the two encodings must agree:
+
+    for (int32_t i = 0; i < lookup_count; ++ i)
+    {
+        ASSERT_EQ (dst [i], wire [i]) << "i = " << i;
+    }
+}
+
+} // end of 'ASX'
+} // end of 'market'
+} // end of namespace
+//----------------------------------------------------------------------------
+
+#endif // VR_RELEASE
@@ -0,0 +1,542 @@
+#pragma once
+
+#include "vr/io/cap/cap_reader.h"
+#include "vr/io/links/TCP_link.h"
+#include "vr/market/books/asx/market_data_listener.h"
+#include "vr/market/books/asx/market_data_view.h"
+#include "vr/market/books/book_event_context.h"
+#include "vr/market/sources/asx/itch/ITCH_pipeline.h"
+#include "vr/market/sources/asx/market_data.h"
+#include "vr/mc/bound_runnable.h"
+#include "vr/mc/mc.h" // volatile_cast()
+#include "vr/sys/os.h"
+#include "vr/util/format.h"
+#include "vr/util/parse.h"
+
+#include <boost/thread/thread.hpp>
+
+#include <bitset>
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace market
+{
+namespace ASX
+{
+/**
+ * recovers the state of all books in a @ref market_data_view from Glimpse snapshots:
+ *
+ *  - the SoupTCP sessions of all active partitions are opened and logged into at
+ *    once, each then drained by its own thread (optionally bound to a PU);
+ *  - books are built into a private staging view whose books draw from per-partition
+ *    pool arenas, so the partition threads share no mutable state;
+ *  - once every active partition has delivered its 'end_of_snapshot' message,
+ *    @ref install() swaps the staging books and per-partition seqnums into the
+ *    target view in O(1); since that replaces all of the target's books, it is refused
+ *    unless every partition with books in the target has been recovered
+ *
+ * the same machinery can replay captured Glimpse streams (@ref replay()), which is
+ * also how it is tested
+ *
+ * @note instrument partitions in ref data must agree with the feed (as is already
+ *       assumed by @ref execution_link)
+ */
+template<typename LIMIT_ORDER_BOOK>
+class glimpse_recovery final: noncopyable
+{
+    private: // ..............................................................
+
+        using this_type     = glimpse_recovery<LIMIT_ORDER_BOOK>;
+
+    public: // ...............................................................
+
+        using book_type     = LIMIT_ORDER_BOOK;
+        using view_type     = market_data_view<book_type>;
+        using seqnum_array  = typename view_type::seqnum_array;
+
+        using credentials   = std::pair<std::string, std::string>;
+
+        struct endpoint final
+        {
+            std::string m_server;
+            uint16_t m_port_base;   // partition 'pix' is at 'm_port_base + pix'
+            credentials m_credentials;
+            bool m_disable_nagle { true };
+
+        }; // end of nested class
+
+
+        /**
+         * @param args required: "agents"   -> agent_cfg,
+         *                       "ref_data" -> ref_data,
+         *             optional: "PUs"      -> std::vector<int32_t> (PU for each partition's thread, negative means unbound),
+         *                       "timeout"  -> timestamp_t (for an entire recovery, default 5 min)
+         */
+        glimpse_recovery (arg_map const & args);
+
+        // ACCESSORs:
+
+        /**
+         * @return partitions whose snapshots have been received in full by the last
+         *         @ref recover() or @ref replay()
+         */
+        bitset32_t const & completed () const
+        {
+            return m_completed;
+        }
+
+        // MUTATORs:
+
+        /**
+         * connect to Glimpse sessions of all partitions with non-zero 'login_seqnums'
+         * and drain them concurrently into the staging view
+         *
+         * @throw on login rejection, EOF or timeout in any partition before its end of snapshot
+         */
+        VR_ASSUME_COLD void recover (endpoint const & ep, std::vector<int64_t> const & login_seqnums);
+
+        /**
+         * offline version of @ref recover(): 'inputs [pix]' are captured Glimpse recv
+         * streams (null for inactive partitions)
+         */
+        VR_ASSUME_COLD void replay (std::array<std::istream *, partition_count ()> const & inputs, io::cap_format::enum_t const format = io::cap_format::wire);
+
+        /**
+         * hand over recovered books and per-partition seqnums (next live Mold seqnum to apply,
+         * see @ref view_type::seqnums()) to 'target', which must have been constructed with the
+         * same "agents" cfg
+         *
+         * seqnums of partitions that were not recovered (and hence have no books in 'target')
+         * are left as they were
+         *
+         * @throw if some partition in 'target.partitions()' hasn't been recovered (nothing is
+         *        installed in that case)
+         *
+         * @note caller must be the only thread visiting 'target' at the time
+         */
+        VR_ASSUME_COLD void install (view_type & target);
+
+    private: // ..............................................................
+
+        using visit_ctx         = book_event_context<_book_, _ts_origin_, _partition_>;
+
+        using link_impl         = io::TCP_link<io::recv<_timestamp_>, io::send<_timestamp_>>; // SoupTCP, Glimpse
+
+        /*
+         * written by a single partition thread, read by the recovering thread after a join
+         */
+        struct partition_state final
+        {
+            int64_t m_seqnum { -1 };        // Mold seqnum from 'end_of_snapshot'
+            bool m_done { false };
+
+        }; // end of nested class
+
+        /*
+         * a pipeline stage that captures 'end_of_snapshot' seqnums
+         */
+        template<typename CTX>
+        class snapshot_tracker final: public ITCH_visitor<snapshot_tracker<CTX>>
+        {
+            private: // ..............................................................
+
+                using super         = ITCH_visitor<snapshot_tracker<CTX>>;
+
+                vr_static_assert (has_field<_partition_, CTX> ());
+
+            public: // ...............................................................
+
+                snapshot_tracker (arg_map const & args) :
+                    super (args),
+                    m_state { * args.get<partition_state *> ("state") } // note: passed as a pointer since this stage is a writer
+                {
+                }
+
+                // overridden ITCH visits:
+
+                using super::visit;
+
+                VR_ASSUME_COLD bool visit (itch::end_of_snapshot const & msg, CTX & ctx) // override
+                {
+                    auto const sn = util::ltrim (msg.seqnum (), '0'); // NOTE: left-padded with zero chars, not blanks
+
+                    m_state.m_seqnum = (sn.empty () ? 0 : util::parse_decimal<int64_t> (sn.m_start, sn.m_size));
+                    m_state.m_done = true;
+
+                    LOG_info << "[P" << field<_partition_> (ctx) << "] end of snapshot, seqnum " << m_state.m_seqnum;
+
+                    return super::visit (msg, ctx); // [chain]
+                }
+
+            private: // ..............................................................
+
+                partition_state & m_state;
+
+        }; // end of nested class
+
+
+        using pipeline          = ITCH_pipeline
+                                <
+                                    snapshot_tracker<visit_ctx>,
+                                    typename view_type::template instrument_selector<visit_ctx>,
+                                    market_data_listener<this_source (), book_type, visit_ctx>
+                                >;
+
+        class partition_worker; // forward
+
+
+        VR_ASSUME_COLD void run_workers (std::vector<std::unique_ptr<partition_worker>> & workers);
+
+        VR_FORCEINLINE bool aborted () const
+        {
+            return mc::volatile_cast (m_aborted);
+        }
+
+        void abort ()
+        {
+            mc::volatile_cast (m_aborted) = true;
+        }
+
+
+        agent_cfg const & m_agents;
+        ref_data const & m_ref_data;
+        std::vector<int32_t> const m_PUs;
+        timestamp_t const m_timeout;
+        std::unique_ptr<view_type> m_staging { };
+        std::array<partition_state, partition_count ()> m_state { };
+        bitset32_t m_active { };
+        bitset32_t m_completed { };
+        bool m_aborted { false }; // [set by any partition thread, read by all]
+
+}; // end of class
+//............................................................................
+
+template<typename LIMIT_ORDER_BOOK>
+class glimpse_recovery<LIMIT_ORDER_BOOK>::partition_worker final: public Soup_frame_<io::mode::recv, pipeline, partition_worker>,
+                                                                  public mc::bound_runnable
+{
+    private: // ..............................................................
+
+        using super         = Soup_frame_<io::mode::recv, pipeline, partition_worker>;
+        using bound         = mc::bound_runnable;
+
+    public: // ...............................................................
+
+        partition_worker (this_type & parent, int32_t const pix, int32_t const PU) :
+            super (arg_map { { "view", std::cref (* parent.m_staging) }, { "state", & parent.m_state [pix] } }),
+            bound (PU, "glimpse.P" + string_cast (pix)),
+            m_parent { parent },
+            m_pix { pix }
+        {
+            field<_partition_> (m_ctx) = pix;
+        }
+
+        VR_ASSUME_COLD void connect (endpoint const & ep, int64_t const login_seqnum)
+        {
+            LOG_info << "[P" << m_pix << "] connecting to " << ep.m_server << ':' << (ep.m_port_base + m_pix) << " ...";
+
+            m_link = std::make_unique<link_impl> (ep.m_server, string_cast (ep.m_port_base + m_pix),
+                io::recv_arg_map { { "capacity", itch_snapsnot_link_capacity () } },
+                io::send_arg_map { { "capacity", itch_snapsnot_link_capacity () } },
+                ep.m_disable_nagle);
+
+            super::seqnums ()[m_pix] = login_seqnum; // note: this is a Glimpse seqnum
+
+            // send login request:
+
+            link_impl & link = * m_link;
+
+            int32_t const len = sizeof (SoupTCP_packet_hdr) + sizeof (SoupTCP_login_request);
+            addr_t const msg_buf = link.send_allocate (len); // blank-filled by default
+
+            SoupTCP_packet_hdr & hdr = * static_cast<SoupTCP_packet_hdr *> (msg_buf);
+            {
+                hdr.length () = 1 + sizeof (SoupTCP_login_request);
+                hdr.type () = 'L'; // [SoupTCP] client login request
+            }
+
+            SoupTCP_login_request & msg = * static_cast<SoupTCP_login_request *> (addr_plus (msg_buf, sizeof (SoupTCP_packet_hdr)));
+            {
+                copy_to_alphanum (ep.m_credentials.first, msg.username ());
+                copy_to_alphanum (ep.m_credentials.second, msg.password ());
+                util::rjust_print_decimal_nonnegative (login_seqnum, msg.seqnum ().data (), msg.seqnum ().max_size ());
+            }
+
+            if (VR_UNLIKELY (! link.send_flush (len)))
+                throw_x (io_exception, "[P" + string_cast (m_pix) + "] EOF while sending login request");
+
+            LOG_trace1 << "  [P" << m_pix << "] sent login request with seqnum " << login_seqnum;
+        }
+
+        VR_ASSUME_COLD void open_replay (std::istream & in, io::cap_format::enum_t const format)
+        {
+            m_replay_in = & in;
+            m_replay_format = format;
+        }
+
+        int32_t const & pix () const
+        {
+            return m_pix;
+        }
+
+        std::exception_ptr const & failure () const
+        {
+            return m_failure;
+        }
+
+        // runnable:
+
+        VR_ASSUME_HOT void operator() () final override
+        {
+            try
+            {
+                bound::bind ();
+
+                if (m_link)
+                    drain_session ();
+                else
+                    drain_replay ();
+            }
+            catch (...)
+            {
+                m_failure = std::current_exception ();
+                m_parent.abort (); // stop all other partitions
+            }
+
+            bound::unbind ();
+            m_link.reset (); // disconnect on this thread
+        }
+
+        // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+        // SoupTCP, server->client:
+        // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+        // overridden SoupTCP visits [base versions from 'SoupTCP_<>']:
+
+        void visit_SoupTCP_login (visit_ctx & ctx, SoupTCP_packet_hdr const & soup_hdr, SoupTCP_login_accepted const & msg) // override
+        {
+            super::visit_SoupTCP_login (ctx, soup_hdr, msg); // [chain]
+
+            LOG_info << "[P" << m_pix << "] login accepted: " << msg;
+        }
+
+        void visit_SoupTCP_login (visit_ctx & ctx, SoupTCP_packet_hdr const & soup_hdr, SoupTCP_login_rejected const & msg) // override
+        {
+            super::visit_SoupTCP_login (ctx, soup_hdr, msg); // [chain]
+
+            throw_x (io_exception, "[P" + string_cast (m_pix) + "] login rejected (" + (msg.reject_code ()[0] == 'A' ? "'NOT AUTHORIZED'" : "'SESSION NOT AVAILABLE'") + ')');
+        }
+
+    private: // ..............................................................
+
+        VR_ASSUME_HOT void drain_session ()
+        {
+            link_impl & link = * m_link;
+            partition_state const & state = m_parent.m_state [m_pix];
+
+            timestamp_t const deadline = sys::realtime_utc () + m_parent.m_timeout;
+
+            while (! state.m_done)
+            {
+                if (VR_UNLIKELY (m_parent.aborted ()))
+                    return;
+
+                // drain and process server -> client bytes:
+                {
+                    static constexpr int32_t min_available  = super::min_size ();
+
+                    std::pair<addr_const_t, io::capacity_t> const rc = link.recv_poll (); // non-blocking read, throws on EOF
+
+                    auto available = rc.second;
+                    int32_t consumed { };
+
+                    while ((available >= min_available) && ! state.m_done) // consume all complete records in the recv buffer, but nothing past the end of snapshot
+                    {
+                        int32_t const vrc = super::consume (m_ctx, addr_plus (rc.first, consumed), available);
+                        if (vrc <= 0)
+                            break;
+
+                        available -= vrc;
+                        consumed += vrc;
+                    }
+
+                    if (consumed) link.recv_flush (consumed);
+                }
+
+                // client -> server heartbeats, timeout:
+                {
+                    timestamp_t const now = sys::realtime_utc ();
+
+                    if (now >= link.ts_last_send () + heartbeat_timeout ())
+                        send_heartbeat (link);
+
+                    if (VR_UNLIKELY (now >= deadline))
+                        throw_x (io_exception, "[P" + string_cast (m_pix) + "] timed out waiting for end of snapshot");
+                }
+            }
+        }
+
+        VR_ASSUME_COLD void drain_replay ()
+        {
+            check_nonnull (m_replay_in);
+
+            io::cap_reader r { * m_replay_in, m_replay_format };
+
+            r.evaluate (m_ctx, * this);
+        }
+
+        void send_heartbeat (link_impl & link)
+        {
+            int32_t const len = sizeof (SoupTCP_packet_hdr);
+            addr_t const msg_buf = link.send_allocate (len, /* special case: no actual low-level protocol payload */false);
+
+            SoupTCP_packet_hdr & hdr = * static_cast<SoupTCP_packet_hdr *> (msg_buf);
+            {
+                hdr.length () = 1;
+                hdr.type () = 'R'; // [SoupTCP] client heartbeat
+            }
+
+            link.send_flush (len);
+        }
+
+
+        this_type & m_parent;
+        int32_t const m_pix;
+        visit_ctx m_ctx { };
+        std::unique_ptr<link_impl> m_link { };          // set iff recovering from a live session
+        std::istream * m_replay_in { };                 // set iff replaying
+        io::cap_format::enum_t m_replay_format { io::cap_format::wire };
+        std::exception_ptr m_failure { };
+
+}; // end of nested class
+//............................................................................
+
+template<typename LIMIT_ORDER_BOOK>
+glimpse_recovery<LIMIT_ORDER_BOOK>::glimpse_recovery (arg_map const & args) :
+    m_agents { args.get<agent_cfg const &> ("agents") },
+    m_ref_data { args.get<ref_data const &> ("ref_data") },
+    m_PUs (args.get<std::vector<int32_t>> ("PUs", { })),
+    m_timeout { args.get<timestamp_t> ("timeout", 300 * _1_second ()) }
+{
+    check_positive (m_timeout);
+}
+//............................................................................
+
+template<typename LIMIT_ORDER_BOOK>
+void
+glimpse_recovery<LIMIT_ORDER_BOOK>::recover (endpoint const & ep, std::vector<int64_t> const & login_seqnums)
+{
+    check_ge (login_seqnums.size (), partition_count ());
+
+    m_staging = std::make_unique<view_type> (arg_map { { "agents", std::cref (m_agents) }, { "ref_data", std::cref (m_ref_data) } });
+
+    std::vector<std::unique_ptr<partition_worker>> workers { };
+
+    for (int32_t pix = 0; pix < partition_count (); ++ pix)
+    {
+        if (login_seqnums [pix] == 0) continue; // seqnum of 0 means the server will not send a snapshot
+
+        workers.emplace_back (std::make_unique<partition_worker> (* this, pix, (pix < signed_cast (m_PUs.size ()) ? m_PUs [pix] : -1)));
+    }
+
+    // connect and log into all sessions at once, before any draining starts:
+
+    for (auto const & w : workers)
+    {
+        w->connect (ep, login_seqnums [w->pix ()]);
+    }
+
+    run_workers (workers);
+}
+
+template<typename LIMIT_ORDER_BOOK>
+void
+glimpse_recovery<LIMIT_ORDER_BOOK>::replay (std::array<std::istream *, partition_count ()> const & inputs, io::cap_format::enum_t const format)
+{
+    m_staging = std::make_unique<view_type> (arg_map { { "agents", std::cref (m_agents) }, { "ref_data", std::cref (m_ref_data) } });
+
+    std::vector<std::unique_ptr<partition_worker>> workers { };
+
+    for (int32_t pix = 0; pix < partition_count (); ++ pix)
+    {
+        if (inputs [pix] == nullptr) continue;
+
+        workers.emplace_back (std::make_unique<partition_worker> (* this, pix, (pix < signed_cast (m_PUs.size ()) ? m_PUs [pix] : -1)));
+        workers.back ()->open_replay (* inputs [pix], format);
+    }
+
+    run_workers (workers);
+}
+//............................................................................
+
+template<typename LIMIT_ORDER_BOOK>
+void
+glimpse_recovery<LIMIT_ORDER_BOOK>::run_workers (std::vector<std::unique_ptr<partition_worker>> & workers)
+{
+    m_active = m_completed = 0;
+    m_aborted = false;
+
+    for (partition_state & s : m_state) s = { };
+
+    for (auto const & w : workers) m_active |= (1 << w->pix ());
+
+    LOG_info << "recovering partition set " << std::bitset<partition_count ()> { m_active } << " on " << workers.size () << " thread(s) ...";
+
+    timestamp_t const ts_start = sys::realtime_utc ();
+    {
+        std::vector<boost::thread> threads { };
+
+        for (auto const & w : workers)
+        {
+            partition_worker * const wp = w.get ();
+            threads.emplace_back ([wp]() { (* wp) (); });
+        }
+
+        for (boost::thread & t : threads) t.join (); // 'm_state' is safe to read after this
+    }
+
+    for (auto const & w : workers)
+    {
+        if (w->failure ()) std::rethrow_exception (w->failure ()); // first failure wins
+    }
+
+    for (int32_t pix = 0; pix < partition_count (); ++ pix)
+    {
+        if (m_state [pix].m_done)
+        {
+            m_completed |= (1 << pix);
+            m_staging->seqnums ()[pix] = m_state [pix].m_seqnum;
+        }
+    }
+
+    LOG_info << "recovered partition set " << std::bitset<partition_count ()> { m_completed } << " in " << ((sys::realtime_utc () - ts_start) / 1000000) << " ms";
+
+    check_eq (m_completed, m_active); // every active partition must have delivered its end of snapshot
+}
+//............................................................................
+
+template<typename LIMIT_ORDER_BOOK>
+void
+glimpse_recovery<LIMIT_ORDER_BOOK>::install (view_type & target)
+{
+    check_nonnull (m_staging);
+    check_eq (m_completed, m_active);
+
+    bitset32_t const required = target.partitions ();
+    check_eq (m_completed & required, required, "partition set " + string_cast (std::bitset<partition_count ()> { m_completed }) + " doesn't cover all books in the target view");
+
+    target.swap (* m_staging);
+
+    for (int32_t pix = 0; pix < partition_count (); ++ pix)
+    {
+        if (! (m_completed & (1 << pix))) target.seqnums ()[pix] = m_staging->seqnums ()[pix]; // keep 'target's own
+    }
+
+    m_staging.reset (); // release the books 'target' has just given up
+    m_active = m_completed = 0;
+}
+
+} // end of 'ASX'
+} // end of 'market'
+} // end of namespace
+//----------------------------------------------------------------------------
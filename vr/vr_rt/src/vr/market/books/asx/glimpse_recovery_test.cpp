@@ -0,0 +1,201 @@
+
+#include "vr/market/books/asx/glimpse_recovery.h"
+
+#include "vr/io/files.h"
+#include "vr/io/stream_factory.h"
+#include "vr/market/rt/cfg/agent_cfg.h"
+#include "vr/market/ref/asx/ref_data.h"
+#include "vr/rt/cfg/resources.h"
+#include "vr/util/di/container.h"
+
+#include "vr/test/configure.h"
+#include "vr/test/files.h"
+#include "vr/test/utility.h"
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+using namespace io;
+
+namespace market
+{
+namespace ASX
+{
+//............................................................................
+//............................................................................
+namespace
+{
+
+std::string
+glimpse_capture_file (int32_t const pix)
+{
+    return ("glimpse.recv.203.0.119.213_2180" + string_cast (pix + 1) + ".soup");
+}
+
+template<typename BOOK_SIDE>
+void
+check_sides_equal (BOOK_SIDE const & lhs, BOOK_SIDE const & rhs)
+{
+    auto r = rhs.begin ();
+
+    for (auto const & l_level : lhs)
+    {
+        ASSERT_TRUE (r != rhs.end ());
+
+        EXPECT_EQ (field<_price_> (l_level), field<_price_> (* r));
+        EXPECT_EQ (field<_qty_> (l_level), field<_qty_> (* r));
+        EXPECT_EQ (field<_order_count_> (l_level), field<_order_count_> (* r));
+
+        ++ r;
+    }
+
+    EXPECT_TRUE (r == rhs.end ());
+}
+
+} // end of anonymous
+//............................................................................
+//............................................................................
+/*
+ * build books for a random subset of symbols from captured Glimpse data twice:
+ *
+ *  - serially, one partition after another, directly into a view;
+ *  - via 'glimpse_recovery::replay()', all partitions in parallel, then installed
+ *    into a separate view;
+ *
+ * and check that the results are identical (also checks that a partial recovery
+ * is refused by 'install()')
+ */
+TEST (ASX_glimpse_recovery, replay_vs_serial)
+{
+    uint32_t rnd { test::env::random_seed<uint32_t> () };
+
+    fs::path const test_input = test::find_capture (source::ASX, "<"_rop, util::current_date_in ("Australia/Sydney"));
+    LOG_info << "using test data in " << print (test_input);
+
+    string_vector symbols = io::read_json (rt::resolve_as_uri ("asx/symbols.asx300.json"));
+    {
+        for (int32_t i = symbols.size (); i > 1; -- i) // shuffle
+        {
+            std::swap (symbols [i - 1], symbols [test::next_random (rnd) % i]);
+        }
+        symbols.resize (std::min<std::size_t> (symbols.size (), 100));
+    }
+
+    util::di::container app { join_as_name ("APP", test::current_test_name ()) };
+    {
+        test::configure_app_ref_data (app, symbols);
+    }
+
+    app.start ();
+    {
+        ref_data const & rd = app ["ref_data"];
+        agent_cfg const & ac = app ["agents"];
+
+        using book_type         = limit_order_book<price_si_t, oid_t, level<_qty_, _order_count_>>;
+        using view              = market_data_view<book_type>;
+
+        arg_map const view_args { { "ref_data", std::cref (rd) }, { "agents", std::cref (ac) } };
+
+        // serial build:
+
+        view mdv_serial { view_args };
+        {
+            using visit_ctx         = book_event_context<_book_, _ts_origin_, _partition_>;
+
+            using pipeline          = ITCH_pipeline
+                                    <
+                                        view::instrument_selector<visit_ctx>,
+                                        market_data_listener<this_source (), book_type, visit_ctx>
+                                    >;
+
+            using visitor           = Soup_frame_<io::mode::recv, pipeline>;
+
+            for (int32_t pix = 0; pix < partition_count (); ++ pix)
+            {
+                visitor v { { { "view", std::cref (mdv_serial) } } };
+
+                visit_ctx ctx { };
+                field<_partition_> (ctx) = pix;
+
+                std::unique_ptr<std::istream> const in = stream_factory::open_input (test_input / glimpse_capture_file (pix));
+
+                cap_reader r { * in, cap_format::wire };
+
+                r.evaluate (ctx, v);
+            }
+        }
+        mdv_serial.check ();
+
+        // parallel recovery:
+
+        view mdv { view_args };
+        {
+            glimpse_recovery<book_type> gr { view_args };
+
+            std::array<std::unique_ptr<std::istream>, partition_count ()> ins;
+            std::array<std::istream *, partition_count ()> inputs;
+
+            for (int32_t pix = 0; pix < partition_count (); ++ pix)
+            {
+                ins [pix] = stream_factory::open_input (test_input / glimpse_capture_file (pix));
+                inputs [pix] = ins [pix].get ();
+            }
+
+            gr.replay (inputs);
+
+            ASSERT_EQ ((1 << partition_count ()) - 1, gr.completed ());
+
+            gr.install (mdv);
+        }
+        mdv.check ();
+
+        // a partial recovery must not be installed over books in other partitions:
+
+        if (mdv.partitions () & ~1)
+        {
+            glimpse_recovery<book_type> gr { view_args };
+
+            std::unique_ptr<std::istream> const in = stream_factory::open_input (test_input / glimpse_capture_file (0));
+
+            std::array<std::istream *, partition_count ()> inputs { };
+            inputs [0] = in.get ();
+
+            gr.replay (inputs);
+
+            ASSERT_EQ (1, gr.completed ());
+
+            view::seqnum_array const seqnums = mdv.seqnums ();
+
+            EXPECT_THROW (gr.install (mdv), check_failure);
+            EXPECT_EQ (seqnums, mdv.seqnums ()); // 'mdv' is left alone (its books are compared below)
+        }
+
+        // compare:
+
+        for (int32_t pix = 0; pix < partition_count (); ++ pix)
+        {
+            EXPECT_GT (mdv.seqnums ()[pix], 0) << "P" << pix;
+        }
+
+        ASSERT_EQ (mdv_serial.size (), mdv.size ());
+
+        for (std::string const & s : symbols)
+        {
+            iid_t const iid = rd [s].iid ();
+
+            book_type const & l = mdv_serial [iid];
+            book_type const & r = mdv [iid];
+
+            for (side::enum_t sd : side::values ())
+            {
+                check_sides_equal (l.at (sd), r.at (sd));
+            }
+        }
+    }
+    app.stop ();
+}
+
+} // end of 'ASX
+} // end of 'market'
+} // end of namespace
+//----------------------------------------------------------------------------
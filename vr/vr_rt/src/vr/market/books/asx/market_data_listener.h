@@ -34,6 +34,7 @@ class market_data_listener<source::ASX, LIMIT_ORDER_BOOK, CTX> final: public ASX
 
         using book_price_type       = typename book_type::price_type;
         using price_traits          = typename source_traits<source::ASX>::price_traits<book_price_type>;
+        using qty_traits            = typename source_traits<source::ASX>::qty_traits<qty_t>; // book qty is narrower than wire qty
 
         using side_type             = typename book_type::side_type;
         using level_type            = typename book_type::level_type;
@@ -42,6 +43,7 @@ class market_data_listener<source::ASX, LIMIT_ORDER_BOOK, CTX> final: public ASX
         using price_map_type        = typename book_type::price_map_type;
         using order_list_type       = typename book_type::order_list_type;
 
+        using order_ref_type        = typename book_type::order_ref_type;
         using fast_order_ref_type   = typename book_type::fast_order_ref_type;
         using fast_level_ref_type   = typename book_type::fast_level_ref_type;
 
@@ -104,7 +106,7 @@ class market_data_listener<source::ASX, LIMIT_ORDER_BOOK, CTX> final: public ASX
             book_side.m_oid_map.put (msg.oid (), std::get<1> (o_ref));
 
             book_price_type const o_price = price_traits::wire_to_book (msg.price ());
-            auto const o_qty = msg.qty ();
+            qty_t const o_qty = qty_traits::wire_to_book (msg.qty ());
 
             typename book_type::price_map_type::insert_commit_data _;
             auto pm_insert = book_side.m_price_map.insert_check (o_price, _);
@@ -199,7 +201,7 @@ class market_data_listener<source::ASX, LIMIT_ORDER_BOOK, CTX> final: public ASX
             auto const oid = msg.oid ();
             auto const qty = msg.qty ();
 
-            md::order_ref_type * const o_ref_ptr = book_side.m_oid_map.get (oid);
+            order_ref_type * const o_ref_ptr = book_side.m_oid_map.get (oid);
 
             if (VR_LIKELY (o_ref_ptr != nullptr))
             {
@@ -275,7 +277,7 @@ class market_data_listener<source::ASX, LIMIT_ORDER_BOOK, CTX> final: public ASX
             // lool up [oid -> order pool ref] mapping in the oid map:
             // [allow for this to be a no-op in case we've not seen the corresponding add]
 
-            md::order_ref_type * const o_ref = book_side.m_oid_map.get (msg.oid ());
+            order_ref_type * const o_ref = book_side.m_oid_map.get (msg.oid ());
 
             if (VR_LIKELY (o_ref != nullptr))
             {
@@ -283,10 +285,14 @@ class market_data_listener<source::ASX, LIMIT_ORDER_BOOK, CTX> final: public ASX
 
                 order_type & o = book.order_pool ()[* o_ref];
 
+                // note: 'o's current level must be captured before '_parent_' is relinked below
+
+                fast_level_ref_type const o_parent_ref = field<_parent_> (o);
+
                 // find destination price level:
 
                 book_price_type const o_price = price_traits::wire_to_book (msg.price ());
-                auto const o_qty = msg.qty ();
+                qty_t const o_qty = qty_traits::wire_to_book (msg.qty ());
 
                 typename book_type::price_map_type::insert_commit_data _;
                 auto pm_insert = book_side.m_price_map.insert_check (o_price, _);
@@ -328,7 +334,6 @@ class market_data_listener<source::ASX, LIMIT_ORDER_BOOK, CTX> final: public ASX
 
                 // splice 'o' from its current parent level to 'new_l':
 
-                fast_level_ref_type const o_parent_ref = field<_parent_> (o);
                 level_type & l = book.level_pool ()[o_parent_ref];
 
                 if (& l != new_l)
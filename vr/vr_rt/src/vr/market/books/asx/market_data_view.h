@@ -1,7 +1,7 @@
 #pragma once
 
 #include "vr/arg_map.h"
-#include "vr/containers/util/chained_scatter_table.h"
+#include "vr/containers/util/perfect_hash_table.h"
 #include "vr/market/books/asx/market_data_view_checker.h"
 #include "vr/market/books/asx/pool_arenas.h"
 #include "vr/market/books/defs.h"
@@ -22,6 +22,10 @@ namespace ASX
 /**
  * view limited to one or more instances of the same 'limit_order_book' specialization
  * (which usually mean they represent some subset of instruments at a given venue)
+ *
+ * books draw their orders and levels from per-partition pool arenas, so books in
+ * different partitions share no mutable state and can be built concurrently (see
+ * @ref glimpse_recovery)
  */
 template<typename LIMIT_ORDER_BOOK>
 class market_data_view final
@@ -33,13 +37,14 @@ class market_data_view final
     public: // ...............................................................
 
         using book_type     = LIMIT_ORDER_BOOK;
+        using seqnum_array  = impl::seqnum_state::seqnum_array;
 
     private: // ..............................................................
 
         template<typename, typename> friend class market_data_view_checker; // grant private access
 
         using iid_type          = this_source_traits::iid_type;
-        using iid_map_type      = util::chained_scatter_table<iid_type, book_type *, util::identity_hash<iid_type>>;
+        using iid_map_type      = util::perfect_hash_table<iid_type, book_type *>; // the view instrument set is fixed at construction time
         using size_type         = typename iid_map_type::size_type;
 
         vr_static_assert (std::is_signed<size_type>::value); // used for looping below
@@ -149,6 +154,34 @@ class market_data_view final
             return (* book_ref);
         }
 
+        /**
+         * @return per-partition Mold seqnums of the next live messages to apply to the
+         *         books [all zeros unless set by a snapshot, e.g. @ref glimpse_recovery]
+         */
+        seqnum_array const & seqnums () const
+        {
+            return m_seqnums;
+        }
+
+        /**
+         * @return set of partitions with at least one book in this view
+         */
+        bitset32_t const & partitions () const
+        {
+            return m_partitions;
+        }
+
+        /**
+         * @return liid of a 'book' owned by this view (books are laid out in liid order)
+         */
+        VR_FORCEINLINE liid_t liid_of (book_type const & book) const
+        {
+            liid_t const liid = (reinterpret_cast<book_storage const *> (& book) - m_liid_map.get ());
+            assert_within (liid, size ());
+
+            return liid;
+        }
+
         // iteration:
 
         const_iterator begin () const
@@ -175,6 +208,28 @@ class market_data_view final
             return m_iid_map.end ();
         }
 
+        seqnum_array & seqnums ()
+        {
+            return m_seqnums;
+        }
+
+        /**
+         * exchange all book state (and @ref seqnums()) with 'other', which must have been
+         * constructed with the same config [O(1), doesn't touch any books]
+         *
+         * @note this is not synchronized with any concurrent visitors of either view
+         */
+        void swap (this_type & other)
+        {
+            check_eq (other.size (), size ());
+
+            std::swap (m_iid_map, other.m_iid_map);
+            std::swap (m_pool_arenas, other.m_pool_arenas);
+            std::swap (m_liid_map, other.m_liid_map);
+            std::swap (m_seqnums, other.m_seqnums);
+            std::swap (m_partitions, other.m_partitions);
+        }
+
         // debug assists:
 
         VR_ASSUME_COLD void check () const
@@ -200,16 +255,18 @@ class market_data_view final
 
 
         iid_map_type m_iid_map;
-        pool_arena_impl m_pool_arena; // must construct before 'm_liid_map'
-        std::unique_ptr<book_storage [/* liid */]> const m_liid_map;
+        std::array<std::unique_ptr<pool_arena_impl>, partition_count ()> m_pool_arenas; // must construct before any books in 'm_liid_map'
+        std::unique_ptr<book_storage [/* liid */]> m_liid_map;
+        seqnum_array m_seqnums { meta::create_array_fill<mold_seqnum_t, partition_count (), 0> () };
+        bitset32_t m_partitions { };
 
 }; // end of class
 //............................................................................
 
 template<typename LIMIT_ORDER_BOOK>
 market_data_view<LIMIT_ORDER_BOOK>::market_data_view (arg_map const & args) :
-    m_iid_map { args.get<agent_cfg &> ("agents").liid_limit () }, // will be populated and then trimmed to fit below
-    m_pool_arena { /* TODO scale capacity */ },
+    m_iid_map { }, // will be built below
+    m_pool_arenas { }, // will be built below, sized for the books in each partition
     m_liid_map { boost::make_unique_noinit<book_storage []> (args.get<agent_cfg &> ("agents").liid_limit ()) }
 {
     agent_cfg const & config = args.get<agent_cfg &> ("agents"); // required
@@ -219,6 +276,24 @@ market_data_view<LIMIT_ORDER_BOOK>::market_data_view (arg_map const & args) :
 
     size_type const sz = config.liid_limit ();
 
+    std::array<int32_t, partition_count ()> book_counts { };
+
+    for (liid_t liid = 0; liid < sz; ++ liid)
+    {
+        instrument const & i = rd [config.liid_table ()[liid].m_symbol];
+
+        check_within (i.partition (), partition_count ());
+        ++ book_counts [i.partition ()];
+    }
+
+    for (int32_t pix = 0; pix < partition_count (); ++ pix)
+    {
+        m_pool_arenas [pix] = std::make_unique<pool_arena_impl> (book_counts [pix]);
+        if (book_counts [pix]) m_partitions |= (1 << pix);
+    }
+
+    std::vector<std::pair<iid_type, book_type *>> iid_entries;
+
     for (liid_t liid = 0; liid < sz; ++ liid)
     {
         std::string const & symbol = config.liid_table ()[liid].m_symbol;
@@ -228,12 +303,13 @@ market_data_view<LIMIT_ORDER_BOOK>::market_data_view (arg_map const & args) :
 
         book_type * const book_addr = & at (liid);
 
-        new (book_addr) book_type { m_pool_arena };
-        m_iid_map.put (i.iid (), book_addr);
+        new (book_addr) book_type { * m_pool_arenas [i.partition ()] };
+        iid_entries.emplace_back (i.iid (), book_addr);
     }
-    m_iid_map.rehash (m_iid_map.size ()); // trim to fit
 
-    check_eq (m_iid_map.size (), sz); // iids are unique by ref data construction
+    m_iid_map = iid_map_type { iid_entries.begin (), iid_entries.end () }; // iids are unique by ref data construction
+
+    check_eq (m_iid_map.size (), sz);
 }
 
 template<typename LIMIT_ORDER_BOOK>
@@ -20,11 +20,6 @@ struct market_data_view_checker final
 
     static void check_view (MARKET_DATA_VIEW const & view)
     {
-        auto const & arena = view.m_pool_arena;
-
-        arena.object_pools ().m_order_pool.check ();
-        arena.object_pools ().m_level_pool.check ();
-
         int32_t ord_count { }; // total orders in 'view'
         int32_t lvl_count { }; // total levels in 'view'
 
@@ -36,13 +31,24 @@ struct market_data_view_checker final
             lvl_count += std::get<1> (rc);
         }
 
-        // traverse object pools and get their alloc maps:
+        // traverse (per-partition) object pools and get their alloc maps:
 
-        bit_set const order_alloc_map = arena.object_pools ().m_order_pool.allocation_bitmap ();
-        bit_set const level_alloc_map = arena.object_pools ().m_level_pool.allocation_bitmap ();
+        int64_t ord_alloc_count { };
+        int64_t lvl_alloc_count { };
+
+        for (int32_t pix = 0; pix < partition_count (); ++ pix)
+        {
+            auto const & arena = * view.m_pool_arenas [pix];
+
+            arena.object_pools ().m_order_pool.check ();
+            arena.object_pools ().m_level_pool.check ();
+
+            ord_alloc_count += arena.object_pools ().m_order_pool.allocation_bitmap ().count ();
+            lvl_alloc_count += arena.object_pools ().m_level_pool.allocation_bitmap ().count ();
+        }
 
-        check_eq (signed_cast (order_alloc_map.count ()), ord_count);
-        check_eq (signed_cast (level_alloc_map.count ()), lvl_count);
+        check_eq (ord_alloc_count, ord_count);
+        check_eq (lvl_alloc_count, lvl_count);
     }
 
 }; // end of class
@@ -2,6 +2,8 @@
 
 #include "vr/types.h"
 
+#include <algorithm>
+
 //----------------------------------------------------------------------------
 namespace vr
 {
@@ -19,7 +21,27 @@ namespace impl
 template<typename OBJECT_POOLS>
 struct market_data_view_pool_arena: private noncopyable
 {
-    // TODO clever logic for initial pool sizing specific to market data
+    using order_pool    = decltype (OBJECT_POOLS::m_order_pool);
+    using level_pool    = decltype (OBJECT_POOLS::m_level_pool);
+
+    // initial pool sizing (the pools still grow as needed):
+
+    static constexpr int32_t orders_per_book ()     { return 256; }
+    static constexpr int32_t levels_per_book ()     { return 32; }
+
+    market_data_view_pool_arena () = default;
+
+    /**
+     * @param book_count number of books that will draw from this arena
+     */
+    market_data_view_pool_arena (int32_t const book_count) :
+        m_object_pools
+        {
+            { initial_capacity<order_pool> (book_count, orders_per_book ()) },
+            { initial_capacity<level_pool> (book_count, levels_per_book ()) }
+        }
+    {
+    }
 
     OBJECT_POOLS const & object_pools () const
     {
@@ -31,6 +53,12 @@ struct market_data_view_pool_arena: private noncopyable
         return m_object_pools;
     }
 
+    template<typename POOL>
+    static typename POOL::size_type initial_capacity (int32_t const book_count, int32_t const objects_per_book)
+    {
+        return std::max<int64_t> (POOL::options::chunk_capacity (), static_cast<int64_t> (book_count) * objects_per_book);
+    }
+
     OBJECT_POOLS m_object_pools { };
 
 }; // end of class
@@ -0,0 +1,354 @@
+#pragma once
+
+#include "vr/arg_map.h"
+#include "vr/data/NA.h"
+#include "vr/market/books/defs.h" // _book_
+#include "vr/market/defs.h" // liid_t
+#include "vr/market/prices.h"
+#include "vr/market/sources/asx/itch/ITCH_ts_tracker.h"
+#include "vr/mc/cache_aware.h"
+#include "vr/mc/lf_broadcast_buffer.h"
+#include "vr/mc/seqlock.h"
+#include "vr/util/logging.h"
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace market
+{
+namespace ASX
+{
+
+struct book_level_snapshot final
+{
+    price_si_t m_price;
+    qty_t m_qty;
+    order_count_t m_order_count;
+
+}; // end of class
+//............................................................................
+/**
+ * best level on each side (an empty side has NA price and zero qty/order count)
+ */
+struct book_top final
+{
+    timestamp_t m_ts_origin;    // of the last message applied to the book
+    book_level_snapshot m_level [side::size];
+
+}; // end of class
+//............................................................................
+/**
+ * up to 'DEPTH' best levels on each side
+ */
+template<int32_t DEPTH>
+struct book_depth final
+{
+    static constexpr int32_t max_depth ()  { return DEPTH; }
+
+    timestamp_t m_ts_origin;    // of the last message applied to the book
+    int32_t m_depth [side::size];
+    book_level_snapshot m_levels [side::size][DEPTH]; // best level first, 'm_depth [s]' entries valid
+
+}; // end of class
+//............................................................................
+/**
+ * a "book changed" event (sized to take a single cache line in a broadcast buffer slot)
+ */
+struct book_update final
+{
+    int64_t m_version;          // of the book's snapshots as of this update
+    liid_t m_liid;
+    book_top m_top;
+
+}; // end of class
+
+vr_static_assert (sizeof (book_update) + sizeof (int64_t) <= sys::cpu_info::cache::static_line_size ());
+
+//............................................................................
+//............................................................................
+namespace impl
+{
+
+template<typename SHARED_BOOKS, typename MARKET_DATA_VIEW, typename CTX> class shared_books_tracker; // forward
+
+} // end of 'impl'
+//............................................................................
+//............................................................................
+/**
+ * books built by one thread (the writer) and read by any number of others without
+ * locking and without re-decoding any market data:
+ *
+ *  - each book (indexed by liid) has seqlock-versioned @ref book_top and @ref book_depth
+ *    snapshots, re-published after every batch of data that has changed the book;
+ *  - each re-publish also appends a @ref book_update to a broadcast buffer, which a reader
+ *    consumes through its own cursor (see @ref mc::lf_broadcast_buffer)
+ *
+ * the writer is never slowed down by readers; a reader that falls more than 'UPDATE_CAPACITY'
+ * updates behind gets 'mc::broadcast_read::overrun' and should @ref resync() and re-read the
+ * snapshots of the books it cares about
+ *
+ * books to re-publish are marked by a @ref tracker ITCH pipeline stage
+ */
+template<typename MARKET_DATA_VIEW, int32_t DEPTH = 8, int32_t UPDATE_CAPACITY = (8 * 1024)>
+class shared_books final: noncopyable
+{
+    private: // ..............................................................
+
+        using this_type     = shared_books<MARKET_DATA_VIEW, DEPTH, UPDATE_CAPACITY>;
+
+        using update_buffer = mc::lf_broadcast_buffer<book_update, UPDATE_CAPACITY>;
+
+    public: // ...............................................................
+
+        using book_type     = typename MARKET_DATA_VIEW::book_type;
+
+        using depth_type    = book_depth<DEPTH>;
+        using cursor_type   = typename update_buffer::size_type;
+        using version_type  = typename mc::seqlock<book_top>::version_type;
+
+        template<typename CTX>
+        using tracker       = impl::shared_books_tracker<this_type, MARKET_DATA_VIEW, CTX>; // a public connector type to use in ITCH_pipelines
+
+
+        shared_books (int32_t const liid_count) :
+            m_books { std::make_unique<book_state []> (liid_count) },
+            m_marks (liid_count),
+            m_size { liid_count }
+        {
+            m_marked.reserve (liid_count);
+
+            LOG_trace1 << "sharing " << liid_count << " book(s), depth " << DEPTH << ", " << UPDATE_CAPACITY << " update slot(s)";
+        }
+
+        // ACCESSORs [any thread]:
+
+        int32_t size () const
+        {
+            return m_size;
+        }
+
+        /**
+         * @return version of 'out'
+         */
+        version_type top (liid_t const liid, book_top & out) const
+        {
+            assert_within (liid, size ());
+
+            return m_books [liid].m_top.value ().read (out);
+        }
+
+        /**
+         * @return version of 'out' (may be newer than that of a previous @ref top() read)
+         */
+        version_type depth (liid_t const liid, depth_type & out) const
+        {
+            assert_within (liid, size ());
+
+            return m_books [liid].m_depth.value ().read (out);
+        }
+
+        // update events:
+
+        /**
+         * @return a cursor positioned past all updates published so far
+         */
+        cursor_type cursor () const
+        {
+            return m_updates.position ();
+        }
+
+        /**
+         * @see mc::lf_broadcast_buffer::try_read()
+         */
+        VR_FORCEINLINE mc::broadcast_read::enum_t next_update (cursor_type & cursor, book_update & out) const
+        {
+            return m_updates.try_read (cursor, out);
+        }
+
+        /**
+         * @see mc::lf_broadcast_buffer::resync()
+         */
+        cursor_type resync (cursor_type & cursor) const
+        {
+            return m_updates.resync (cursor);
+        }
+
+        // MUTATORs [writer thread only]:
+
+        /**
+         * note that 'book' (with liid 'liid') has changed as of 'ts_origin'
+         */
+        VR_FORCEINLINE void mark (liid_t const liid, book_type const & book, timestamp_t const ts_origin)
+        {
+            assert_within (liid, size ());
+
+            mark_state & m = m_marks [liid];
+
+            if (m.m_book == nullptr)
+            {
+                m.m_book = & book;
+                m_marked.push_back (liid);
+            }
+            m.m_ts_origin = ts_origin;
+        }
+
+        /**
+         * re-publish snapshots of all books marked since the last call and clear the marks
+         *
+         * @return number of books published
+         */
+        VR_ASSUME_HOT int32_t publish ()
+        {
+            for (liid_t const liid : m_marked)
+            {
+                mark_state & m = m_marks [liid];
+                assert_nonnull (m.m_book, liid);
+
+                book_type const & book = (* m.m_book);
+                book_state & bs = m_books [liid];
+
+                book_top top;
+                {
+                    top.m_ts_origin = m.m_ts_origin;
+
+                    bs.m_depth.value ().write ([&](depth_type & dst)
+                        {
+                            dst.m_ts_origin = m.m_ts_origin;
+
+                            for (side::enum_t s : side::values ())
+                            {
+                                auto const & book_side = book.at (s);
+
+                                int32_t d { };
+                                for (auto i = book_side.begin (); (d < DEPTH) && (i != book_side.end ()); ++ i, ++ d)
+                                {
+                                    dst.m_levels [s][d] = { i->price (), i->qty (), i->order_count () };
+                                }
+                                dst.m_depth [s] = d;
+
+                                top.m_level [s] = (d ? dst.m_levels [s][0] : book_level_snapshot { data::NA<price_si_t> (), 0, 0 });
+                            }
+                        });
+                }
+
+                version_type const v = bs.m_top.value ().store (top); // same version as the depth snapshot
+
+                m_updates.write ([&](book_update & u)
+                    {
+                        u.m_version = v;
+                        u.m_liid = liid;
+                        u.m_top = top;
+                    });
+
+                m.m_book = nullptr;
+            }
+
+            int32_t const r = m_marked.size ();
+            m_marked.clear ();
+
+            return r;
+        }
+
+    private: // ..............................................................
+
+        struct book_state final
+        {
+            mc::cache_line_padded_field<mc::seqlock<book_top>> m_top;       // read more often than 'm_depth'
+            mc::cache_line_padded_field<mc::seqlock<depth_type>> m_depth;
+
+        }; // end of nested class
+
+        struct mark_state final
+        {
+            book_type const * m_book { };   // non-null iff marked
+            timestamp_t m_ts_origin { };
+
+        }; // end of nested class
+
+
+        std::unique_ptr<book_state [/* liid */]> const m_books;
+        std::vector<mark_state> m_marks;    // indexed by liid [writer-private]
+        std::vector<liid_t> m_marked { };   // [writer-private]
+        int32_t const m_size;
+        update_buffer m_updates { };
+
+}; // end of class
+//............................................................................
+//............................................................................
+namespace impl
+{
+/**
+ * an ITCH pipeline stage that marks books changed by add/fill/replace/delete and
+ * book state messages for the next @ref shared_books::publish()
+ *
+ * required args: "view" -> MARKET_DATA_VIEW, "shared_books" -> SHARED_BOOKS *
+ */
+template<typename SHARED_BOOKS, typename MARKET_DATA_VIEW, typename CTX>
+class shared_books_tracker final: public ITCH_ts_tracker<CTX, shared_books_tracker<SHARED_BOOKS, MARKET_DATA_VIEW, CTX>>
+{
+    private: // ..............................................................
+
+        using super         = ITCH_ts_tracker<CTX, shared_books_tracker<SHARED_BOOKS, MARKET_DATA_VIEW, CTX>>;
+
+        vr_static_assert (has_field<_book_, CTX> ());
+        vr_static_assert (has_field<_ts_origin_, CTX> ());
+
+        using book_type     = typename MARKET_DATA_VIEW::book_type;
+
+    public: // ...............................................................
+
+        shared_books_tracker (arg_map const & args) :
+            super (args),
+            m_mdv { args.get<MARKET_DATA_VIEW &> ("view") },
+            m_books { * args.get<SHARED_BOOKS *> ("shared_books") } // note: passed as a pointer since this stage is a writer
+        {
+            check_eq (m_books.size (), m_mdv.size ());
+        }
+
+        // overridden ITCH visits:
+
+        using super::visit;
+
+#define vr_VISIT_MESSAGE(r, unused, MSG) \
+        VR_ASSUME_HOT bool visit (itch:: MSG const & msg, CTX & ctx) /* override */ \
+        { \
+            auto const rc = super::visit (msg, ctx); /* [chain] */ \
+            \
+            mark (ctx); \
+            \
+            return rc; \
+        } \
+        /* */
+
+        BOOST_PP_SEQ_FOR_EACH (vr_VISIT_MESSAGE, unused,
+            (order_book_state)
+            (order_add)(order_add_with_participant)
+            (order_fill)(order_fill_with_price)
+            (order_replace)(order_delete)
+        )
+
+#undef vr_VISIT_MESSAGE
+
+    private: // ..............................................................
+
+        VR_FORCEINLINE void mark (CTX & ctx)
+        {
+            addr_const_t const book_ref = field<_book_> (ctx);
+            assert_nonnull (book_ref); // relying on a selector ahead of us in the pipeline
+
+            book_type const & book = (* static_cast<book_type const *> (book_ref));
+
+            m_books.mark (m_mdv.liid_of (book), book, field<_ts_origin_> (ctx));
+        }
+
+
+        MARKET_DATA_VIEW const & m_mdv;
+        SHARED_BOOKS & m_books;
+
+}; // end of class
+
+} // end of 'impl'
+} // end of 'ASX'
+} // end of 'market'
+} // end of namespace
+//----------------------------------------------------------------------------
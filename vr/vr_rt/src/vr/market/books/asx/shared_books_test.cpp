@@ -0,0 +1,265 @@
+
+#include "vr/io/cap/cap_reader.h"
+#include "vr/io/files.h"
+#include "vr/io/net/IP_.h"
+#include "vr/io/net/pcap_.h"
+#include "vr/io/net/UDP_.h"
+#include "vr/io/stream_factory.h"
+#include "vr/io/streams.h"
+#include "vr/market/books/asx/market_data_listener.h"
+#include "vr/market/books/asx/market_data_view.h"
+#include "vr/market/books/asx/shared_books.h"
+#include "vr/market/books/book_event_context.h"
+#include "vr/market/rt/cfg/agent_cfg.h"
+#include "vr/market/ref/asx/ref_data.h"
+#include "vr/market/sources/asx/itch/ITCH_pipeline.h"
+#include "vr/market/sources/asx/market_data.h"
+#include "vr/rt/cfg/resources.h"
+#include "vr/util/di/container.h"
+
+#include "vr/test/configure.h"
+#include "vr/test/files.h"
+#include "vr/test/utility.h"
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+using namespace io;
+using namespace io::net;
+
+namespace market
+{
+namespace ASX
+{
+//............................................................................
+//............................................................................
+namespace
+{
+/*
+ * publishes marked books at the end of every packet, like 'book_builder' does
+ * after every poll of its feed
+ */
+template<typename SHARED_BOOKS, typename CTX>
+class publisher: public ITCH_visitor<publisher<SHARED_BOOKS, CTX>>
+{
+    private: // ..............................................................
+
+        using super         = ITCH_visitor<publisher<SHARED_BOOKS, CTX>>;
+
+    public: // ...............................................................
+
+        publisher (arg_map const & args) :
+            super (args),
+            m_books { * args.get<SHARED_BOOKS *> ("shared_books") }
+        {
+        }
+
+        // overridden ITCH visits:
+
+        using super::visit;
+
+        VR_ASSUME_HOT void visit (post_packet const msg_count, CTX & ctx) // override
+        {
+            super::visit (msg_count, ctx); // [chain]
+
+            m_books.publish ();
+        }
+
+    private: // ..............................................................
+
+        SHARED_BOOKS & m_books;
+
+}; // end of class
+
+} // end of anonymous
+//............................................................................
+//............................................................................
+/*
+ * replay captured data through a pipeline with a shared books tracker, then check
+ * that all snapshots are consistent with the books and that a reader cursor has
+ * seen the latest update for each book
+ */
+TEST (shared_books, capture_replay)
+{
+    fs::path const test_input = test::find_capture (source::ASX, "<"_rop, util::current_date_in ("Australia/Sydney"));
+    LOG_info << "using test data in " << print (test_input);
+
+    string_vector const universe = io::read_json (rt::resolve_as_uri ("asx/symbols.asx300.json"));
+    string_vector const symbols (universe.begin (), universe.begin () + std::min<int32_t> (universe.size (), 10));
+
+    util::di::container app { join_as_name ("APP", test::current_test_name ()) };
+    {
+        test::configure_app_ref_data (app, symbols);
+    }
+
+    app.start ();
+    {
+        ref_data const & rd = app ["ref_data"];
+        agent_cfg const & ac = app ["agents"];
+
+        int64_t const record_limit  = 2000000;
+
+        using book_type         = limit_order_book<price_si_t, oid_t, level<_qty_, _order_count_>>;
+        using view              = market_data_view<book_type>;
+        using books_type        = shared_books<view, 4>;
+
+        view mdv
+        {
+            {
+                { "ref_data",   std::cref (rd) },
+                { "agents",     std::cref (ac) }
+            }
+        };
+
+        books_type books { static_cast<int32_t> (mdv.size ()) };
+        ASSERT_EQ (books.size (), signed_cast (symbols.size ()));
+
+        books_type::cursor_type cursor = books.cursor ();
+        ASSERT_EQ (cursor, 0);
+
+        using reader            = cap_reader;
+
+        // start with glimpse snapshot state:
+        {
+            using visit_ctx         = book_event_context<_book_, _ts_origin_, _packet_index_, _partition_>;
+
+            using pipeline          = ITCH_pipeline
+                                    <
+                                        view::instrument_selector<visit_ctx>,
+                                        books_type::tracker<visit_ctx>,
+                                        market_data_listener<this_source (), book_type, visit_ctx>
+                                    >;
+
+            using visitor           = Soup_frame_<io::mode::recv, pipeline>;
+
+            for (int32_t pix = 0; pix < partition_count (); ++ pix) // consume all glimpse data
+            {
+                visitor v
+                {
+                    {
+                        { "view",           std::cref (mdv) },
+                        { "shared_books",   & books }
+                    }
+                };
+
+                visit_ctx ctx { };
+
+                std::string const filename = "glimpse.recv.203.0.119.213_2180" + string_cast (pix + 1) + ".soup";
+
+                std::unique_ptr<std::istream> const in = stream_factory::open_input (test_input / filename);
+
+                reader r { * in, cap_format::wire };
+
+                r.evaluate (ctx, v);
+            }
+
+            books.publish ();
+        }
+
+        // continue by consuming mcast data, publishing after every packet:
+        {
+            using visit_ctx         = book_event_context<_book_, _ts_origin_, _packet_index_, _partition_, _ts_local_, _ts_local_delta_, _seqnum_,  _dst_port_>;
+
+            using pipeline          = ITCH_pipeline
+                                    <
+                                        view::instrument_selector<visit_ctx>,
+                                        books_type::tracker<visit_ctx>,
+                                        market_data_listener<this_source (), book_type, visit_ctx>,
+                                        publisher<books_type, visit_ctx>
+                                    >;
+
+            using visitor           = pcap_<IP_<UDP_<Mold_frame_<pipeline>>>>;
+
+            visitor v
+            {
+                {
+                    { "view",           std::cref (mdv) },
+                    { "shared_books",   & books }
+                }
+            };
+
+            visit_ctx ctx { };
+
+            std::unique_ptr<std::istream> const in = stream_factory::open_input (test_input / "mcast.recv.p1p2.pcap.zst");
+
+            reader r { * in, cap_format::pcap };
+
+            r.evaluate (ctx, v, record_limit);
+        }
+
+        // drain the update buffer:
+
+        std::vector<books_type::version_type> last_version (books.size (), 0);
+        bool overrun { false };
+        int64_t update_count { };
+        {
+            book_update u;
+
+            for (mc::broadcast_read::enum_t rc; (rc = books.next_update (cursor, u)) != mc::broadcast_read::empty; )
+            {
+                if (rc == mc::broadcast_read::overrun) // the replay can easily publish more than the buffer capacity
+                {
+                    books.resync (cursor);
+                    overrun = true;
+                    break;
+                }
+
+                ASSERT_LT (last_version [u.m_liid], u.m_version);
+                last_version [u.m_liid] = u.m_version;
+                ++ update_count;
+            }
+        }
+        LOG_info << "read " << update_count << " update(s)" << (overrun ? " before an overrun" : "");
+
+        ASSERT_EQ (cursor, books.cursor ());
+
+        // check all snapshots against the books:
+
+        for (liid_t liid = 0; liid < books.size (); ++ liid)
+        {
+            book_type const & book = mdv [rd [ac.liid_table ()[liid].m_symbol].iid ()];
+
+            book_top top;
+            books_type::depth_type depth;
+
+            books_type::version_type const v_top = books.top (liid, top);
+            books_type::version_type const v_depth = books.depth (liid, depth);
+
+            EXPECT_EQ (v_top, v_depth) << "liid " << liid; // quiescent
+            if (! overrun) EXPECT_EQ (last_version [liid], v_top) << "liid " << liid;
+
+            for (side::enum_t s : side::values ())
+            {
+                auto const & book_side = book.at (s);
+
+                int32_t d { };
+                for (auto i = book_side.begin (); (d < books_type::depth_type::max_depth ()) && (i != book_side.end ()); ++ i, ++ d)
+                {
+                    ASSERT_LT (d, depth.m_depth [s]) << "liid " << liid << ", " << s;
+
+                    EXPECT_EQ (depth.m_levels [s][d].m_price, i->price ()) << "liid " << liid << ", " << s << " level " << d;
+                    EXPECT_EQ (depth.m_levels [s][d].m_qty, i->qty ()) << "liid " << liid << ", " << s << " level " << d;
+                    EXPECT_EQ (depth.m_levels [s][d].m_order_count, i->order_count ()) << "liid " << liid << ", " << s << " level " << d;
+                }
+                EXPECT_EQ (depth.m_depth [s], d) << "liid " << liid << ", " << s;
+
+                if (d)
+                {
+                    EXPECT_EQ (top.m_level [s].m_price, depth.m_levels [s][0].m_price);
+                    EXPECT_EQ (top.m_level [s].m_qty, depth.m_levels [s][0].m_qty);
+                }
+                else if (v_top) // a book that was never published has a zeroed snapshot
+                {
+                    EXPECT_TRUE (data::is_NA (top.m_level [s].m_price));
+                    EXPECT_EQ (top.m_level [s].m_qty, 0);
+                }
+            }
+        }
+    }
+    app.stop ();
+}
+
+} // end of 'ASX
+} // end of 'market'
+} // end of namespace
+//----------------------------------------------------------------------------
@@ -0,0 +1,380 @@
+#pragma once
+
+#include "vr/arg_map.h"
+#include "vr/containers/util/fenwick_window.h"
+#include "vr/data/NA.h"
+#include "vr/market/books/defs.h" // _book_
+#include "vr/market/defs.h" // liid_t
+#include "vr/market/prices.h"
+#include "vr/market/sources/asx/itch/ITCH_ts_tracker.h"
+#include "vr/market/sources/asx/market_data.h"
+#include "vr/util/logging.h"
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace market
+{
+namespace ASX
+{
+/**
+ * a set of rolling window lengths, each '2 ^ LOG2_WINDOW' ns
+ */
+template<int32_t ... LOG2_WINDOWs>
+struct trade_signal_horizons
+{
+    static constexpr int32_t size ()    { return sizeof ... (LOG2_WINDOWs); }
+
+}; // end of traits
+
+using default_trade_signal_horizons     = trade_signal_horizons<30, 33, 36>; // ~1.07s, ~8.6s, ~68.7s
+//............................................................................
+//............................................................................
+namespace impl
+{
+
+template<int32_t LOG2_WINDOW>
+class trade_window_set final
+{
+    private: // ..............................................................
+
+        template<typename BIN_TYPE>
+        using window_type       = util::fenwick_window<timestamp_t, util::fenwick_window_options<(1L << LOG2_WINDOW), BIN_TYPE, 16, /* MEMOIZED */true>>;
+
+    public: // ...............................................................
+
+        static constexpr timestamp_t window ()  { return (1L << LOG2_WINDOW); }
+
+
+        trade_window_set (timestamp_t const start_time) :
+            m_count { start_time },
+            m_volume { start_time },
+            m_notional { start_time },
+            m_signed_volume { start_time }
+        {
+        }
+
+        // ACCESSORs:
+
+        // O(1), as of the last trade time:
+
+        int32_t count () const                  { return m_count.count (); }
+        int64_t volume () const                 { return m_volume.count (); }
+        int64_t notional () const               { return m_notional.count (); } // [qty * price_si_t]
+        int64_t signed_volume () const          { return m_signed_volume.count (); } // buyer- minus seller-initiated (tick rule)
+
+        price_si_t VWAP () const
+        {
+            int64_t const v = volume ();
+            return (VR_LIKELY (v > 0) ? static_cast<price_si_t> (notional () / v) : data::NA<price_si_t> ());
+        }
+
+        // O(log(bin count)), as of a given time (not earlier than the last trade time):
+
+        int32_t count (timestamp_t const ts) const          { return m_count.count (ts); }
+        int64_t volume (timestamp_t const ts) const         { return m_volume.count (ts); }
+        int64_t notional (timestamp_t const ts) const       { return m_notional.count (ts); }
+        int64_t signed_volume (timestamp_t const ts) const  { return m_signed_volume.count (ts); }
+
+        // MUTATORs:
+
+        VR_FORCEINLINE void add (timestamp_t const ts, int64_t const qty, int64_t const notional, int32_t const sign)
+        {
+            m_count.template add<false> (ts);
+            m_volume.template add<false> (ts, qty);
+            m_notional.template add<false> (ts, notional);
+            m_signed_volume.template add<false> (ts, sign * qty); // note: also advances the window if 'sign' is zero
+        }
+
+    private: // ..............................................................
+
+        window_type<int32_t> m_count;
+        window_type<int64_t> m_volume;
+        window_type<int64_t> m_notional;
+        window_type<int64_t> m_signed_volume;
+
+}; // end of class
+
+template<typename TRADE_SIGNALS, typename MARKET_DATA_VIEW, typename CTX> class trade_signals_tracker; // forward
+
+} // end of 'impl'
+//............................................................................
+//............................................................................
+
+template<typename HORIZONS = default_trade_signal_horizons>
+class trade_signals; // master
+
+/**
+ * per-liid rolling window trade count, volume, notional, and signed (tick rule) volume
+ * over several horizons at once
+ *
+ * written by a '@ref tracker' ITCH pipeline stage, readable in O(1) by anything that
+ * has a (const) reference to this object
+ *
+ * @note window values are as of the last trade in a given instrument (see @ref instrument_signals::ts_last());
+ *       use the 'ts'-taking accessors to look at a window as of a later time
+ */
+template<int32_t ... LOG2_WINDOWs>
+class trade_signals<trade_signal_horizons<LOG2_WINDOWs ...>> final: noncopyable
+{
+    private: // ..............................................................
+
+        using this_type     = trade_signals<trade_signal_horizons<LOG2_WINDOWs ...>>;
+
+        using horizon_tuple = std::tuple<impl::trade_window_set<LOG2_WINDOWs> ...>;
+
+    public: // ...............................................................
+
+        static constexpr int32_t horizon_count ()   { return sizeof ... (LOG2_WINDOWs); }
+
+        class instrument_signals final
+        {
+            public: // ...............................................................
+
+                instrument_signals () :
+                    m_horizons { impl::trade_window_set<LOG2_WINDOWs> { 0 } ... }
+                {
+                }
+
+                // ACCESSORs:
+
+                /**
+                 * @return window set for horizon with index 'H'
+                 */
+                template<int32_t H>
+                auto const & horizon () const
+                {
+                    return std::get<H> (m_horizons);
+                }
+
+                /**
+                 * @return timestamp of the last recorded trade [0 if none]
+                 */
+                timestamp_t const & ts_last () const
+                {
+                    return m_ts_last;
+                }
+
+                price_si_t const & price_last () const
+                {
+                    return m_price_last;
+                }
+
+            private: // ..............................................................
+
+                friend class trade_signals;
+
+                horizon_tuple m_horizons;
+                timestamp_t m_ts_last { };
+                price_si_t m_price_last { };
+                int32_t m_sign { }; // tick rule state: sign of the last non-zero price change
+
+        }; // end of nested class
+
+
+        template<typename MARKET_DATA_VIEW, typename CTX>
+        using tracker       = impl::trade_signals_tracker<this_type, MARKET_DATA_VIEW, CTX>; // a public connector type to use in ITCH_pipelines
+
+
+        trade_signals (int32_t const liid_count) :
+            m_signals (liid_count)
+        {
+            LOG_trace1 << "tracking " << horizon_count () << " horizon(s) for " << liid_count << " instrument(s), " << (liid_count * sizeof (instrument_signals)) << " byte(s)";
+        }
+
+        // ACCESSORs:
+
+        int32_t size () const
+        {
+            return m_signals.size ();
+        }
+
+        instrument_signals const & operator[] (liid_t const liid) const
+        {
+            assert_within (liid, size ());
+
+            return m_signals [liid];
+        }
+
+        // MUTATORs:
+
+        /**
+         * @param ts [clamped to be monotonic per instrument]
+         * @param qty [must be positive]
+         */
+        VR_ASSUME_HOT void record (liid_t const liid, timestamp_t const ts, price_si_t const price, int64_t const qty)
+        {
+            assert_within (liid, size ());
+            assert_positive (qty);
+
+            instrument_signals & s = m_signals [liid];
+
+            timestamp_t const t = std::max (ts, s.m_ts_last); // windows only move forward
+
+            if (price != s.m_price_last)
+            {
+                if (VR_LIKELY (s.m_price_last != 0)) s.m_sign = (price > s.m_price_last ? 1 : -1);
+                s.m_price_last = price;
+            }
+
+            add (s.m_horizons, t, qty, qty * price, s.m_sign, std::make_index_sequence<horizon_count ()> { });
+
+            s.m_ts_last = t;
+        }
+
+    private: // ..............................................................
+
+        template<std::size_t ... Is>
+        static VR_FORCEINLINE void add (horizon_tuple & horizons, timestamp_t const ts, int64_t const qty, int64_t const notional, int32_t const sign, std::index_sequence<Is ...>)
+        {
+            int32_t const unused[] = { (std::get<Is> (horizons).add (ts, qty, notional, sign), 0) ... };
+            (void) unused;
+        }
+
+
+        std::vector<instrument_signals> m_signals; // indexed by liid
+
+}; // end of class
+//............................................................................
+//............................................................................
+namespace impl
+{
+/**
+ * an ITCH pipeline stage that feeds 'order_fill'/'trade' executions into @ref trade_signals
+ *
+ * qty accounting follows 'stats_calc' (c.f ASX ITCH 2.10):
+ *
+ *  - 'order_fill's on one side (avoid double-counting), priced by looking up the
+ *    filled order in the book (hence this must run before the book listener can
+ *    possibly delete an order);
+ *  - 'order_fill_with_price's and 'trade's that are 'printable'==Y;
+ *
+ * if the book user data has a '_state_' field, only executions during the regular
+ * session are counted
+ *
+ * required args: "view" -> MARKET_DATA_VIEW, "trade_signals" -> TRADE_SIGNALS *
+ */
+template<typename TRADE_SIGNALS, typename MARKET_DATA_VIEW, typename CTX>
+class trade_signals_tracker final: public ITCH_ts_tracker<CTX, trade_signals_tracker<TRADE_SIGNALS, MARKET_DATA_VIEW, CTX>>
+{
+    private: // ..............................................................
+
+        using super         = ITCH_ts_tracker<CTX, trade_signals_tracker<TRADE_SIGNALS, MARKET_DATA_VIEW, CTX>>;
+
+        vr_static_assert (has_field<_book_, CTX> ());
+        vr_static_assert (has_field<_ts_origin_, CTX> ());
+
+        using book_type         = typename MARKET_DATA_VIEW::book_type;
+
+        using book_price_type   = typename book_type::price_type;
+        using price_traits      = typename this_source_traits::price_traits<book_price_type>;
+
+        static constexpr side::enum_t counting_side ()  { return side::BID; }
+
+        static constexpr bool has_book_state ()         { return has_field<_state_, typename book_type::book_user_data> (); }
+
+    public: // ...............................................................
+
+        trade_signals_tracker (arg_map const & args) :
+            super (args),
+            m_mdv { args.get<MARKET_DATA_VIEW &> ("view") },
+            m_signals { * args.get<TRADE_SIGNALS *> ("trade_signals") } // note: passed as a pointer since this stage is a writer
+        {
+            check_eq (m_signals.size (), m_mdv.size ());
+        }
+
+        // overridden ITCH visits:
+
+        using super::visit;
+
+        VR_ASSUME_HOT bool visit (itch::order_fill const & msg, CTX & ctx) // override
+        {
+            auto const rc = super::visit (msg, ctx); // [chain]
+
+            if (counting_side () == ord_side::to_side (msg.side ()))
+            {
+                book_type const & book = current_book (ctx);
+
+                if (is_open (book, std::integral_constant<bool, has_book_state ()> { }))
+                {
+                    auto const * const o = book.find_order (counting_side (), msg.oid ());
+                    if (VR_LIKELY (o != nullptr)) // allow for this to be a no-op in case we've not seen the corresponding add
+                    {
+                        record (book, ctx, field<_price_> (book.level_of (* o)), msg.qty ());
+                    }
+                }
+            }
+
+            return rc;
+        }
+
+        VR_ASSUME_HOT bool visit (itch::order_fill_with_price const & msg, CTX & ctx) // override
+        {
+            auto const rc = super::visit (msg, ctx); // [chain]
+
+            if (msg.printable () == itch::boolean::yes)
+            {
+                book_type const & book = current_book (ctx);
+
+                if (is_open (book, std::integral_constant<bool, has_book_state ()> { }))
+                {
+                    record (book, ctx, price_traits::wire_to_book (msg.price ()), msg.qty ());
+                }
+            }
+
+            return rc;
+        }
+
+        VR_ASSUME_HOT bool visit (itch::trade const & msg, CTX & ctx) // override
+        {
+            auto const rc = super::visit (msg, ctx); // [chain]
+
+            if (msg.printable () == itch::boolean::yes)
+            {
+                book_type const & book = current_book (ctx);
+
+                if (is_open (book, std::integral_constant<bool, has_book_state ()> { }))
+                {
+                    record (book, ctx, price_traits::wire_to_book (msg.price ()), msg.qty ());
+                }
+            }
+
+            return rc;
+        }
+
+    private: // ..............................................................
+
+        static VR_FORCEINLINE book_type const & current_book (CTX & ctx)
+        {
+            addr_const_t const book_ref = field<_book_> (ctx);
+            assert_nonnull (book_ref); // relying on a selector ahead of us in the pipeline
+
+            return (* static_cast<book_type const *> (book_ref));
+        }
+
+        static VR_FORCEINLINE bool is_open (book_type const & book, std::true_type)
+        {
+            return (field<_state_> (book.user_data ()) == itch::book_state::OPEN);
+        }
+
+        static VR_FORCEINLINE bool is_open (book_type const & book, std::false_type)
+        {
+            return true;
+        }
+
+        VR_FORCEINLINE void record (book_type const & book, CTX & ctx, price_si_t const price, int64_t const qty)
+        {
+            m_signals.record (m_mdv.liid_of (book), field<_ts_origin_> (ctx), price, qty);
+        }
+
+
+        MARKET_DATA_VIEW const & m_mdv;
+        TRADE_SIGNALS & m_signals;
+
+}; // end of class
+
+} // end of 'impl'
+} // end of 'ASX'
+} // end of 'market'
+} // end of namespace
+//----------------------------------------------------------------------------
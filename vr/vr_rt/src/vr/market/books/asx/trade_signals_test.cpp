@@ -0,0 +1,128 @@
+
+#include "vr/market/books/asx/trade_signals.h"
+
+#include "vr/test/utility.h"
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace market
+{
+namespace ASX
+{
+//............................................................................
+//............................................................................
+namespace
+{
+
+struct trade final
+{
+    timestamp_t m_ts;
+    price_si_t m_price;
+    int64_t m_qty;
+    int32_t m_sign;
+
+}; // end of class
+
+} // end of anonymous
+//............................................................................
+//............................................................................
+/*
+ * compare all window values against a brute force calculation over all trades
+ * (with tick rule signs assigned independently) for a few instruments
+ */
+TEST (trade_signals, record)
+{
+    using horizons          = trade_signal_horizons<14, 20>; // short enough for the test to slide through many windows
+    using signals_type      = trade_signals<horizons>;
+
+    constexpr int32_t liid_count    = 3;
+    constexpr int32_t trade_count   = 20000;
+
+    signals_type signals { liid_count };
+
+    ASSERT_EQ (signals.size (), liid_count);
+    ASSERT_EQ (signals_type::horizon_count (), 2);
+
+    uint64_t rnd = test::env::random_seed<uint64_t> (); // note: unsigned
+
+    std::array<std::vector<trade>, liid_count> history { };
+    std::array<timestamp_t, liid_count> ts { };
+    std::array<int32_t, liid_count> sign { };
+
+    auto const check = [&](liid_t const liid, auto const & h, timestamp_t const t)
+        {
+            constexpr int64_t bin_width = std::remove_reference_t<decltype (h)>::window () / 16;
+
+            int32_t count { };
+            int64_t volume { };
+            int64_t notional { };
+            int64_t signed_volume { };
+
+            for (trade const & tr : history [liid])
+            {
+                if ((tr.m_ts / bin_width) > (t / bin_width) - 16)
+                {
+                    ++ count;
+                    volume += tr.m_qty;
+                    notional += tr.m_qty * tr.m_price;
+                    signed_volume += tr.m_sign * tr.m_qty;
+                }
+            }
+
+            EXPECT_EQ (h.count (t), count) << "liid " << liid << ", t " << t;
+            EXPECT_EQ (h.volume (t), volume) << "liid " << liid << ", t " << t;
+            EXPECT_EQ (h.notional (t), notional) << "liid " << liid << ", t " << t;
+            EXPECT_EQ (h.signed_volume (t), signed_volume) << "liid " << liid << ", t " << t;
+
+            if (t == signals [liid].ts_last ()) // O(1) accessors
+            {
+                EXPECT_EQ (h.count (), count);
+                EXPECT_EQ (h.volume (), volume);
+                EXPECT_EQ (h.signed_volume (), signed_volume);
+
+                if (volume > 0) EXPECT_EQ (h.VWAP (), notional / volume);
+            }
+        };
+
+    for (int32_t i = 0; i < trade_count; ++ i)
+    {
+        liid_t const liid = test::next_random (rnd) % liid_count;
+
+        ts [liid] += test::next_random (rnd) % 2000;
+
+        price_si_t const price = (100 + (test::next_random (rnd) % 5)) * price_si_scale ();
+        int64_t const qty = 1 + test::next_random (rnd) % 1000;
+
+        // tick rule:
+
+        if (! history [liid].empty ())
+        {
+            price_si_t const price_last = history [liid].back ().m_price;
+            if (price != price_last) sign [liid] = (price > price_last ? 1 : -1);
+        }
+
+        history [liid].push_back ({ ts [liid], price, qty, sign [liid] });
+
+        signals.record (liid, ts [liid], price, qty);
+
+        auto const & s = signals [liid];
+
+        ASSERT_EQ (s.ts_last (), ts [liid]);
+        ASSERT_EQ (s.price_last (), price);
+
+        check (liid, s.horizon<0> (), ts [liid]);
+        check (liid, s.horizon<1> (), ts [liid]);
+
+        // look ahead:
+
+        check (liid, s.horizon<0> (), ts [liid] + (test::next_random (rnd) % 20000));
+
+        if (history [liid].size () > 4000) history [liid].erase (history [liid].begin (), history [liid].begin () + 2000); // keep the brute force cheap (what remains spans more than the longest horizon)
+    }
+}
+
+} // end of 'ASX'
+} // end of 'market'
+} // end of namespace
+//----------------------------------------------------------------------------
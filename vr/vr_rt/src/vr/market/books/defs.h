@@ -12,6 +12,7 @@ namespace market
 
 VR_META_TAG (book);
 
+VR_META_TAG (compact_refs);
 VR_META_TAG (depth);
 VR_META_TAG (order_count);
 VR_META_TAG (order_queue);
@@ -23,7 +23,9 @@ namespace md
 //............................................................................
 
 using order_ref_type        = uint32_t;
-using level_ref_type        = uint32_t; // ASX-55 TODO add design option to choose uint16_t for sufficiently small universes
+using level_ref_type        = uint32_t;
+
+using compact_ref_type      = uint16_t; // both order and level refs with '_compact_refs_' book trait
 
 template<typename ORDER_POOL, typename LEVEL_POOL>
 struct object_pool_arena
@@ -48,7 +50,8 @@ struct ot_bit final
 {
     enum enum_t
     {
-        participant
+        participant,
+        compact_parent  // not a user-visible order trait, set from book traits
     };
 
 }; // end of enum
@@ -56,16 +59,18 @@ struct ot_bit final
 template<bitset32_t SELECTED>
 struct book_order_schema
 {
+    using parent_type   = util::if_t<(SELECTED & (1 << ot_bit::compact_parent)), compact_ref_type, level_ref_type>;
+
     using type          = meta::make_schema_t
                         <
                             // always present fields:
 
-                            meta::fdef_<level_ref_type,     _parent_>,      // [immutable] references parent level
+                            meta::fdef_<parent_type,        _parent_>,      // [immutable] references parent level
                             meta::fdef_<qty_t,              _qty_>,         // current qty of this order
 
                             // configurable fields:
 
-                            meta::fdef_<participant_t,      _participant_,  meta::elide<(! (SELECTED & (1 << ot_bit::participant)))>>
+                            meta::fdef_<participant_t,      _participant_,  meta::elide<(! (SELECTED & (1 << ot_bit::participant)))>, meta::cold<>>
                         >;
 
 }; // end of metafunction
@@ -132,8 +137,9 @@ struct bt_bit final
 {
     enum enum_t
     {
-        depth,      // if chosen, O(1) book side depth is available
-        user_data
+        depth,          // if chosen, O(1) book side depth is available
+        user_data,
+        compact_refs    // if chosen, order and level pools use 16-bit refs (caps the number of live orders and levels per pool arena)
     };
 
 }; // end of enum
@@ -147,7 +153,8 @@ struct book_traits
     static constexpr bool user_data_empty ()    { return std::is_same<user_data_type, empty_ud>::value; }
 
     static constexpr bitset32_t trait_set       = (util::contains<_depth_, ATTRIBUTEs ...>::value   << bt_bit::depth)
-                                                | (! user_data_empty ()                             << bt_bit::user_data);
+                                                | (! user_data_empty ()                             << bt_bit::user_data)
+                                                | (util::contains<_compact_refs_, ATTRIBUTEs ...>::value << bt_bit::compact_refs);
 
 }; // end of traits
 
@@ -185,13 +192,20 @@ struct book_object_pool_traits
  *
  * hence each 'book_order' is a node in an intrusive dl list owned by its parent 'book_level':
  *
+ * only the hot part of the order schema (what add/fill/delete paths touch) is stored inline
+ * with the list hooks; 'cold<>' fields (if any are selected) go into a 'cold_type' that
+ * the order pool keeps in a parallel array (see 'util::object_pool')
+ *
  * TODO use a dl list only in no-_order_queue_ mode, otherwise use ? to manage queue ranks
  */
 using book_order_base   = intrusive::bi::list_base_hook<intrusive::bi_traits::link_mode>;
 
 template<bitset32_t ORDER_TRAITs>
-struct book_order: public meta::make_compact_struct_t<typename book_order_schema<ORDER_TRAITs>::type, book_order_base>
+struct book_order: public meta::make_compact_struct_t<meta::hot_schema_t<typename book_order_schema<ORDER_TRAITs>::type>, book_order_base>
 {
+    using schema        = typename book_order_schema<ORDER_TRAITs>::type;
+    using cold_type     = util::if_t<meta::has_cold_fields<schema> (), meta::make_compact_struct_t<meta::cold_schema_t<schema>>, void>; // accessed as 'order_pool ().cold (o_ref)'
+
     // ACCESSORs:
 
     qty_t const & qty () const VR_NOEXCEPT // always available
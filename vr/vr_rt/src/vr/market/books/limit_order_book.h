@@ -241,6 +241,9 @@ class limit_order_book_impl: public meta::make_compact_struct_t<typename book_ba
         using level_type            = book_level<T_PRICE, LEVEL_TRAITs, ORDER_TRAITs>;
         using order_type            = typename level_type::order_type;
 
+        using order_ref_type        = util::if_t<(BOOK_TRAITs & (1 << bt_bit::compact_refs)), compact_ref_type, md::order_ref_type>;
+        using level_ref_type        = typename book_order_schema<ORDER_TRAITs>::parent_type; // [set consistently by 'make_limit_order_book']
+
         using order_pool_traits     = book_object_pool_traits<order_type, order_ref_type>;
         using order_pool_type       = typename order_pool_traits::pool_type;
 
@@ -262,6 +265,8 @@ class limit_order_book_impl: public meta::make_compact_struct_t<typename book_ba
         using order_list_type       = typename level_type::order_list;
 
         vr_static_assert (std::is_same<typename order_pool_traits::ref_type, order_ref_type>::value);
+        vr_static_assert (std::is_same<typename level_pool_traits::ref_type, level_ref_type>::value);
+        vr_static_assert (std::is_same<order_ref_type, level_ref_type>::value); // both are either compact or not
 
         using fast_order_ref_type   = typename order_pool_traits::fast_ref_type;
         using fast_level_ref_type   = typename level_pool_traits::fast_ref_type;
@@ -339,6 +344,8 @@ class limit_order_book_impl: public meta::make_compact_struct_t<typename book_ba
 
         }; // end of nested scope
 
+        static constexpr bool compact_refs ()           { return (BOOK_TRAITs & (1 << bt_bit::compact_refs)); }
+
         static constexpr bool const_time_depth ()       { return (BOOK_TRAITs & (1 << bt_bit::depth)); }
         static constexpr bool has_user_data ()          { return (BOOK_TRAITs & (1 << bt_bit::user_data)); }
 
@@ -432,7 +439,11 @@ struct make_limit_order_book
     using lmark             = util::find_derived_t<level_mark, default_level, ATTRIBUTEs ...>;
     using omark             = typename lmark::order_def;
 
-    using type          = limit_order_book_impl<T_PRICE, T_OID, user_data_type, bt::trait_set, lmark::trait_set, omark::trait_set>;
+    // order parent refs must be as wide as level pool refs:
+
+    static constexpr bitset32_t ot_set      = omark::trait_set | (((bt::trait_set >> bt_bit::compact_refs) & 1) << ot_bit::compact_parent);
+
+    using type          = limit_order_book_impl<T_PRICE, T_OID, user_data_type, bt::trait_set, lmark::trait_set, ot_set>;
 
 }; // end of metafunction
 
@@ -458,7 +469,7 @@ template
 <
     typename T_PRICE,       // "book" price type (likely 'price_si_t')
     typename T_OID,         // source-specific oid type
-    typename ... ATTRIBUTEs // user_data<...>, level<order<_qty_, ...>, _order_queue_, ...>, ...
+    typename ... ATTRIBUTEs // user_data<...>, level<order<_qty_, ...>, _order_queue_, ...>, _depth_, _compact_refs_, ...
 >
 class limit_order_book final: public md::impl::make_limit_order_book<T_PRICE, T_OID, ATTRIBUTEs ...>::type
 {
@@ -62,6 +62,20 @@ TEST (limit_order_book, traits)
         vr_static_assert (book_type::level::has_price ());
         vr_static_assert (! book_type::level::has_qty ());
         vr_static_assert (! book_type::level::has_order_count ());
+
+        // participant is a cold field, kept by the order pool out of line:
+
+        using order_pool_type   = decltype (book_type::traits::pool_arena::m_order_pool);
+        using order_cold_type   = order_pool_type::cold_type;
+
+        vr_static_assert (! std::is_void<order_cold_type>::value);
+        vr_static_assert (has_field<_participant_, order_cold_type> ());
+
+        using book_type2        = limit_order_book<price_si_t, oid_type>;
+        using order_pool_type2  = decltype (book_type2::traits::pool_arena::m_order_pool);
+
+        vr_static_assert (std::is_void<order_pool_type2::cold_type>::value);
+        vr_static_assert (sizeof (order_pool_type::value_type) == sizeof (order_pool_type2::value_type)); // hot part size is unchanged by cold fields
     }
 
     // add aggregate level qty:
@@ -101,6 +115,28 @@ TEST (limit_order_book, traits)
         vr_static_assert (book_type::level::has_order_count ()); // ***
     }
 
+    // use 16-bit pool refs:
+    {
+        using book_type         = limit_order_book<int32_t, oid_type, _compact_refs_, level<_qty_>>;
+        LOG_info << "sizeof {" << cn_<book_type> () << "} = " << sizeof (book_type);
+
+        vr_static_assert (book_type::compact_refs ()); // ***
+
+        using order_pool_type   = decltype (book_type::traits::pool_arena::m_order_pool);
+        using level_pool_type   = decltype (book_type::traits::pool_arena::m_level_pool);
+
+        vr_static_assert (std::is_same<order_pool_type::pointer_type, uint16_t>::value);
+        vr_static_assert (std::is_same<level_pool_type::pointer_type, uint16_t>::value);
+        vr_static_assert (std::is_same<std::decay_t<decltype (field<_parent_> (std::declval<order_pool_type::value_type> ()))>, uint16_t>::value);
+
+        using book_type2        = limit_order_book<int32_t, oid_type, level<_qty_>>;
+        using order_pool_type2  = decltype (book_type2::traits::pool_arena::m_order_pool);
+
+        vr_static_assert (! book_type2::compact_refs ());
+        vr_static_assert (std::is_same<order_pool_type2::pointer_type, uint32_t>::value);
+        vr_static_assert (sizeof (order_pool_type::value_type) <= sizeof (order_pool_type2::value_type));
+    }
+
     // make side depth O(1):
     {
         using book_type         = limit_order_book<double, oid_type, _depth_>;
@@ -148,6 +184,31 @@ TEST (limit_order_book, traits)
     }
 }
 
+//............................................................................
+
+TEST (limit_order_book, wire_to_book_narrowing)
+{
+    using price_traits      = price_ops<int32_t, std::ratio<price_si_scale (), 10000>, int32_t>; // narrow book prices
+    using qty_traits        = qty_ops<int64_t, int16_t>; // narrow book qtys
+
+    EXPECT_EQ (price_traits::wire_to_book (12345), 12345000);
+    EXPECT_EQ (price_traits::wire_to_book (- 12345), - 12345000);
+    EXPECT_THROW (price_traits::wire_to_book (std::numeric_limits<int32_t>::max () / 10), out_of_bounds);
+
+    EXPECT_TRUE (data::is_NA (price_traits::wire_to_book (data::NA<int32_t> ()))); // NA passes through
+
+    EXPECT_EQ (qty_traits::wire_to_book (std::numeric_limits<int16_t>::max ()), std::numeric_limits<int16_t>::max ());
+    EXPECT_EQ (qty_traits::wire_to_book (std::numeric_limits<int16_t>::min ()), std::numeric_limits<int16_t>::min ());
+    EXPECT_THROW (qty_traits::wire_to_book (std::numeric_limits<int16_t>::max () + 1L), out_of_bounds);
+    EXPECT_THROW (qty_traits::wire_to_book (std::numeric_limits<int16_t>::min () - 1L), out_of_bounds);
+
+    // no narrowing, no checks:
+
+    using price_traits2     = price_ops<int32_t, std::ratio<price_si_scale (), 10000>, price_si_t>;
+
+    EXPECT_EQ (price_traits2::wire_to_book (std::numeric_limits<int32_t>::max () / 10), (std::numeric_limits<int32_t>::max () / 10) * 1000L);
+}
+
 } // end of 'market'
 } // end of namespace
 //----------------------------------------------------------------------------
@@ -42,6 +42,7 @@ VR_STRONG_ALIAS (post_message,      int32_t)
 // TODO maintain a schema (w/ inheritance) hierarchy of field types/tags elsewhere?:
 
 using io::_ts_origin_;
+using io::_ts_sent_;
 using io::_ts_local_;
 using io::_ts_local_delta_;
 
@@ -48,13 +48,153 @@ copy_to_alphanum (std::string const & src, std::array<char, SIZE> & dst)
     std::memcpy (dst.data (), src.data (), src.size ());
 }
 
+//............................................................................
+//............................................................................
+namespace impl
+{
+
+template<std::size_t N>
+struct xmm_io; // master
+
+template<>
+struct xmm_io<4>
+{
+    static VR_FORCEINLINE __m128i load (char_const_ptr_t const src)
+    {
+        int32_t x;
+        __builtin_memcpy (& x, src, sizeof (x));
+
+        return _mm_cvtsi32_si128 (x);
+    }
+
+    static VR_FORCEINLINE void store (__m128i const v, char * const dst)
+    {
+        int32_t const x = _mm_cvtsi128_si32 (v);
+        __builtin_memcpy (dst, & x, sizeof (x));
+    }
+
+}; // end of specialization
+
+template<>
+struct xmm_io<8>
+{
+    static VR_FORCEINLINE __m128i load (char_const_ptr_t const src)
+    {
+        return _mm_loadl_epi64 (reinterpret_cast<__m128i const *> (src));
+    }
+
+    static VR_FORCEINLINE void store (__m128i const v, char * const dst)
+    {
+        _mm_storel_epi64 (reinterpret_cast<__m128i *> (dst), v);
+    }
+
+}; // end of specialization
+
+template<>
+struct xmm_io<16>
+{
+    static VR_FORCEINLINE __m128i load (char_const_ptr_t const src)
+    {
+        return _mm_loadu_si128 (reinterpret_cast<__m128i const *> (src));
+    }
+
+    static VR_FORCEINLINE void store (__m128i const v, char * const dst)
+    {
+        _mm_storeu_si128 (reinterpret_cast<__m128i *> (dst), v);
+    }
+
+}; // end of specialization
+//............................................................................
+/*
+ * 'fw_string' <-> blank-padded alphanum field conversions, selected at compile time
+ * by string width:
+ *
+ *  - if the entire 'fw_string' storage slot fits into the field (e.g. 'order_token' vs
+ *    the OUCH '_otk_' field), this is done within an xmm register (null <-> blank byte
+ *    substitution) plus a single store, without having to compute the string size first;
+ *  - otherwise, it falls back to a size-aware copy
+ */
+template<std::size_t N, std::size_t SIZE, bool FITS = (N <= SIZE)>
+struct alphanum_ops
+{
+    template<bool CHECK_BOUNDS>
+    static VR_FORCEINLINE void encode (fw_string<N, CHECK_BOUNDS> const & src, std::array<char, SIZE> & dst)
+    {
+        __m128i const v = xmm_io<N>::load (src.data ());
+        __m128i const blanks = _mm_and_si128 (_mm_cmpeq_epi8 (v, _mm_setzero_si128 ()), _mm_set1_epi8 (' '));
+
+        xmm_io<N>::store (_mm_or_si128 (v, blanks), dst.data ());
+    }
+
+    template<bool CHECK_BOUNDS>
+    static VR_FORCEINLINE void decode (std::array<char, SIZE> const & src, fw_string<N, CHECK_BOUNDS> & dst)
+    {
+        if (VR_LIKELY (src [N - 1] != ' ')) // a full-width string (e.g. 'order_token_generator' output)
+        {
+            __builtin_memcpy (dst.data (), src.data (), N);
+            return;
+        }
+
+        __m128i const v = xmm_io<N>::load (src.data ());
+
+        uint32_t const non_blanks = (~ _mm_movemask_epi8 (_mm_cmpeq_epi8 (v, _mm_set1_epi8 (' '))) & ((1U << N) - 1));
+        int32_t const size = (non_blanks ? (32 - __builtin_clz (non_blanks)) : 0); // only trailing blanks are padding
+
+        __m128i const keep = _mm_cmpgt_epi8 (_mm_set1_epi8 (size), _mm_setr_epi8 (0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+
+        xmm_io<N>::store (_mm_and_si128 (v, keep), dst.data ());
+    }
+
+}; // end of master
+
 template<std::size_t N, std::size_t SIZE>
-inline void
-copy_to_alphanum (fw_string<N> const & src, std::array<char, SIZE> & dst) // avoid a std::string intermediary
+struct alphanum_ops<N, SIZE, /* FITS */false>
 {
-    assert_le (static_cast<std::size_t> (src.size ()), SIZE);
+    template<bool CHECK_BOUNDS>
+    static void encode (fw_string<N, CHECK_BOUNDS> const & src, std::array<char, SIZE> & dst)
+    {
+        std::size_t const size = src.size ();
+        assert_le (size, SIZE);
 
-    std::memcpy (dst.data (), src.data (), src.size ());
+        std::memcpy (dst.data (), src.data (), size);
+        std::memset (dst.data () + size, ' ', SIZE - size);
+    }
+
+    template<bool CHECK_BOUNDS>
+    static void decode (std::array<char, SIZE> const & src, fw_string<N, CHECK_BOUNDS> & dst)
+    {
+        std::size_t size = SIZE;
+        while (size && (src [size - 1] == ' ')) -- size;
+
+        dst = fw_string<N, CHECK_BOUNDS> { src.data (), size };
+    }
+
+}; // end of specialization
+
+} // end of 'impl'
+//............................................................................
+//............................................................................
+/**
+ * writes 'src' into the first 'min (N, SIZE)' bytes of 'dst', right-padded with blanks
+ * (any remaining bytes of 'dst' are left as they were)
+ */
+template<std::size_t N, bool CHECK_BOUNDS, std::size_t SIZE>
+VR_FORCEINLINE void
+copy_to_alphanum (fw_string<N, CHECK_BOUNDS> const & src, std::array<char, SIZE> & dst) // avoid a std::string intermediary
+{
+    impl::alphanum_ops<N, SIZE>::encode (src, dst);
+}
+/**
+ * inverse of @ref copy_to_alphanum(): trailing blanks are stripped
+ *
+ * @note if 'N < SIZE', only the first 'N' bytes of 'src' are read (the rest are
+ *       expected to be blanks)
+ */
+template<std::size_t SIZE, std::size_t N, bool CHECK_BOUNDS>
+VR_FORCEINLINE void
+copy_from_alphanum (std::array<char, SIZE> const & src, fw_string<N, CHECK_BOUNDS> & dst)
+{
+    impl::alphanum_ops<N, SIZE>::decode (src, dst);
 }
 
 } // end of 'market'
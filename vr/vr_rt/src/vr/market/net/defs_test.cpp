@@ -0,0 +1,111 @@
+
+#include "vr/market/net/defs.h"
+
+#include "vr/test/utility.h"
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace market
+{
+//............................................................................
+//............................................................................
+namespace
+{
+
+template<std::size_t N, std::size_t SIZE>
+struct alphanum_scenario
+{
+    using string_type           = fw_string<N>;
+    using field_type            = alphanum_ft<SIZE>;
+
+}; // end of scenario
+
+using tested_scenarios      = gt::Types
+<
+    alphanum_scenario<4,  4>,
+    alphanum_scenario<4,  7>,
+    alphanum_scenario<8,  8>,
+    alphanum_scenario<8,  14>, // 'order_token' vs OUCH '_otk_'
+    alphanum_scenario<8,  6>,  // falls back to a size-aware copy
+    alphanum_scenario<16, 20>,
+    alphanum_scenario<16, 10>  // falls back to a size-aware copy
+>;
+
+template<typename T> struct alphanum_test: public gt::Test { };
+TYPED_TEST_CASE (alphanum_test, tested_scenarios);
+
+} // end of anonymous
+//............................................................................
+//............................................................................
+
+TYPED_TEST (alphanum_test, round_trip)
+{
+    using scenario              = TypeParam; // test parameter
+
+    using string_type           = typename scenario::string_type;
+    using field_type            = typename scenario::field_type;
+
+    constexpr int32_t max_size      = std::min<int32_t> (string_type::max_size (), std::tuple_size<field_type>::value);
+    constexpr int32_t field_size    = std::tuple_size<field_type>::value;
+
+    uint64_t rnd = test::env::random_seed<uint64_t> (); // note: unsigned
+    int64_t const repeats = 10000;
+
+    for (int64_t r = 0; r < repeats; ++ r)
+    {
+        int32_t const len = test::next_random (rnd) % (max_size + 1);
+
+        char buf [max_size];
+        for (int32_t i = 0; i < len; ++ i)
+        {
+            // any printable chars (including interior blanks) except for the last one:
+
+            buf [i] = ' ' + test::next_random (rnd) % ('~' - ' ' + 1);
+            if ((i == len - 1) && (buf [i] == ' ')) buf [i] = '_';
+        }
+
+        string_type const s { buf, len };
+
+        field_type f;
+        std::memset (f.data (), '?', field_size); // make sure 'copy_to_alphanum()' does the padding
+
+        copy_to_alphanum (s, f);
+
+        for (int32_t i = 0; i < len; ++ i)
+        {
+            ASSERT_EQ (f [i], buf [i]) << "[len " << len << ", i " << i << "] " << print (s);
+        }
+        for (int32_t i = len; i < max_size; ++ i)
+        {
+            ASSERT_EQ (f [i], ' ') << "[len " << len << ", i " << i << "] " << print (s);
+        }
+
+        // bytes past the string width are left as they were unless the field is narrower:
+
+        for (int32_t i = max_size; i < field_size; ++ i) f [i] = ' ';
+
+        string_type s_decoded { "junk" };
+        copy_from_alphanum (f, s_decoded);
+
+        ASSERT_EQ (s_decoded.size (), len) << print (s);
+        ASSERT_EQ (s_decoded, s);
+    }
+}
+//............................................................................
+
+TEST (alphanum, decode_blank_field)
+{
+    alphanum_ft<14> f;
+    fill_alphanum<' '> (f);
+
+    fw_string8 s { "A0000001" };
+    copy_from_alphanum (f, s);
+
+    EXPECT_TRUE (s.empty ());
+    EXPECT_EQ (s, fw_string8 { });
+}
+
+} // end of 'market'
+} // end of namespace
+//----------------------------------------------------------------------------
@@ -4,6 +4,7 @@
 #include "vr/market/defs.h"
 
 #include <cmath>
+#include <limits>
 #include <ratio>
 
 //----------------------------------------------------------------------------
@@ -23,6 +24,24 @@ constexpr ratio_si_t ratio_si_scale ()  { return util::si_scale (); }
 //............................................................................
 namespace impl
 {
+/*
+ * 'v' converted to 'T_LHS', with an overflow check iff 'T_LHS' can't represent all 'T_RHS' values
+ */
+template<typename T_LHS, typename T_RHS>
+VR_FORCEINLINE T_LHS
+checked_narrow (T_RHS const v)
+{
+    vr_static_assert (std::is_integral<T_LHS>::value && std::is_integral<T_RHS>::value);
+    vr_static_assert (std::is_signed<T_LHS>::value == std::is_signed<T_RHS>::value); // mixed signedness is not supported
+
+    if (sizeof (T_LHS) < sizeof (T_RHS)) // compile-time check
+    {
+        check_in_inclusive_range (v, static_cast<T_RHS> (std::numeric_limits<T_LHS>::min ()), static_cast<T_RHS> (std::numeric_limits<T_LHS>::max ()), cn_<T_LHS> ());
+    }
+
+    return static_cast<T_LHS> (v);
+}
+//............................................................................
 /*
  *  fp price := book / price_si_scale () := wire / wire_scale
  */
@@ -44,7 +63,7 @@ struct scale_price<T_LHS, T_RHS, SCALE_RATIO, NA_AWARE,
                 return data::NA<T_LHS> ();
         }
 
-        return ((v * scale_ratio::num) / scale_ratio::den); // TODO guard against int mul overflow more carefully
+        return checked_narrow<T_LHS> ((v * scale_ratio::num) / scale_ratio::den); // TODO guard against int mul overflow more carefully
     }
 
 }; // end of specialization
@@ -166,6 +185,28 @@ struct price_ops
 }; // end of class
 //............................................................................
 
+/**
+ * qty analog of 'price_ops' (no scaling, but 'T_BOOK' can be narrower than 'T_WIRE')
+ */
+template<typename T_WIRE, typename T_BOOK>
+struct qty_ops
+{
+    /*
+     * @throws out_of_bounds if 'v' is not representable as 'T_BOOK'
+     */
+    static VR_FORCEINLINE T_BOOK wire_to_book (T_WIRE const & v)
+    {
+        return impl::checked_narrow<T_BOOK> (v);
+    }
+
+    static VR_FORCEINLINE T_WIRE book_to_wire (T_BOOK const & v)
+    {
+        return v;
+    }
+
+}; // end of class
+//............................................................................
+
 // TODO obsolete/rm these
 
 template<typename R>
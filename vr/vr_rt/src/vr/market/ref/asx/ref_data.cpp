@@ -2,6 +2,7 @@
 #include "vr/market/ref/asx/ref_data.h"
 
 #include "vr/io/dao/object_DAO.h"
+#include "vr/market/ref/asx/ref_image.h"
 #include "vr/market/rt/cfg/agent_cfg.h"
 #include "vr/rt/cfg/app_cfg.h"
 #include "vr/settings.h"
@@ -16,92 +17,126 @@ namespace ASX
 {
 //............................................................................
 
-ref_data::ref_data (settings const & cfg)
+ref_data::ref_data (settings const & cfg) :
+    m_image { cfg.is_object () ? cfg.value ("image", std::string { }) : std::string { } }
 {
     dep (m_config) = "config";
     dep (m_agents) = "agents";
-    dep (m_dao) = "DAO";
+
+    if (m_image.empty ()) dep (m_dao) = "DAO";
 }
 //............................................................................
 
 void
 ref_data::start ()
+{
+    util::date_t const effective_date = m_config->start_date ();
+
+    // pass 1: populate 'm_instruments'
+
+    if (m_image.empty ())
+        load_from_DAO (effective_date);
+    else
+        load_from_image (effective_date);
+
+    // pass 2: build 'm_symbol_map' and 'm_iid_map' ('m_instruments' slots are stable from now on):
+    {
+        std::vector<std::pair<std::string, instrument const *>> symbol_entries;
+        std::vector<std::pair<iid_t, instrument const *>> iid_entries;
+
+        for (instrument const & i : m_instruments)
+        {
+            symbol_entries.emplace_back (i.symbol (), & i);
+            iid_entries.emplace_back (i.iid (), & i);
+        }
+
+        m_symbol_map = symbol_map { symbol_entries.begin (), symbol_entries.end () }; // throws on duplicate symbols
+        m_iid_map = iid_map { iid_entries.begin (), iid_entries.end () }; // throws on duplicate iids
+    }
+
+    LOG_trace1 << "loaded " << m_iid_map.size () << " instrument definition(s)";
+}
+
+void
+ref_data::load_from_DAO (util::date_t const & effective_date)
 {
     liid_descriptor const * const liid_table = m_agents->liid_table ();
     liid_t const liid_limit = m_agents->liid_limit ();
 
     auto & ifc = m_dao->ro_ifc<instrument> (); // read-only
 
-    util::date_t const effective_date = m_config->start_date ();
-
     LOG_trace1 << "reading instrument definitions as of [" << effective_date << "] ...";
 
-    // pass 1: populate 'm_symbol_map'
+    // a single table scan, the 'find_as_of()'s below are then served from memory:
 
-    {
-        auto const tx { ifc.tx_begin () }; // do all of the DAO read I/O within one transaction
+    int32_t const snapshot_size = ifc.snapshot_as_of (effective_date);
+    LOG_trace1 << "  snapshot of " << snapshot_size << " instrument definition(s)";
 
-        for (liid_t liid = 0; liid < liid_limit; ++ liid)
-        {
-            std::string const & symbol = liid_table [liid].m_symbol;
+    m_instruments.reserve (liid_limit);
 
-            optional<instrument> i = ifc.find_as_of (effective_date, symbol);
-            if (VR_UNLIKELY (! i)) // for now, guard against delisted symbols TODO 'strict' mode for prod
-            {
-                LOG_warn << "failed to load instrument definition for " << print (symbol) << ", skipping";
-                continue;
-            }
+    for (liid_t liid = 0; liid < liid_limit; ++ liid)
+    {
+        std::string const & symbol = liid_table [liid].m_symbol;
 
-            m_symbol_map.emplace (symbol, std::move (* i));
+        optional<instrument> i = ifc.find_as_of (effective_date, symbol);
+        if (VR_UNLIKELY (! i)) // for now, guard against delisted symbols TODO 'strict' mode for prod
+        {
+            LOG_warn << "failed to load instrument definition for " << print (symbol) << ", skipping";
+            continue;
         }
 
-        // [ 'tx' rolls back, which is ok for read-only I/O ]
+        m_instruments.push_back (std::move (* i));
     }
+}
+
+void
+ref_data::load_from_image (util::date_t const & effective_date)
+{
+    liid_descriptor const * const liid_table = m_agents->liid_table ();
+    liid_t const liid_limit = m_agents->liid_limit ();
+
+    ref_image const image { m_image };
+
+    if (VR_UNLIKELY (image.as_of () != effective_date))
+        LOG_warn << "using ref image as of [" << image.as_of () << "] for [" << effective_date << ']';
 
-    // pass 2: populate 'm_iid_map':
+    m_instruments.reserve (liid_limit);
 
-    for (auto const & kv : m_symbol_map)
+    for (liid_t liid = 0; liid < liid_limit; ++ liid)
     {
-        instrument const & i = kv.second;
+        std::string const & symbol = liid_table [liid].m_symbol;
 
-        m_iid_map.put (i.iid (), & i);
-    }
-    check_eq (m_iid_map.size (), static_cast<iid_map::size_type> (m_symbol_map.size ())); // no duplicate iids
+        int32_t const ix = image.find (symbol);
+        if (VR_UNLIKELY (ix < 0)) // for now, guard against delisted symbols TODO 'strict' mode for prod
+        {
+            LOG_warn << "no instrument definition for " << print (symbol) << " in the ref image, skipping";
+            continue;
+        }
 
-    m_iid_map.rehash (m_iid_map.size ()); // trim to fit
+        m_instruments.push_back (image.at (ix));
+    }
 
-    LOG_trace1 << "loaded " << m_iid_map.size () << " instrument definition(s)";
+    // ['image' is unmapped here: 'm_instruments' are self-contained]
 }
 
 void
 ref_data::stop ()
 {
-    // m_iid_map.clear (); TODO ASX-47
-    m_symbol_map.clear ();
-}
-//............................................................................
-
-instrument const &
-ref_data::operator[] (std::string const & symbol) const
-{
-    auto const i = m_symbol_map.find (symbol);
-    if (VR_UNLIKELY (i == m_symbol_map.end ()))
-        throw_x (invalid_input, "invalid symbol " + print (symbol));
-
-    return i->second;
+    // m_iid_map = { }; TODO ASX-47
+    m_symbol_map = { };
 }
 //............................................................................
 
 ref_data::const_iterator
 ref_data::begin () const
 {
-    return { m_symbol_map.begin () };
+    return m_instruments.begin ();
 }
 
 ref_data::const_iterator
 ref_data::end () const
 {
-    return { m_symbol_map.end () };
+    return m_instruments.end ();
 }
 
 } // end of 'ASX'
@@ -1,6 +1,7 @@
 #pragma once
 
-#include "vr/containers/util/chained_scatter_table.h"
+#include "vr/containers/util/perfect_hash_table.h"
+#include "vr/filesystem.h"
 #include "vr/io/dao/object_DAO_fwd.h"
 #include "vr/market/ref/asx/instrument.h"
 #include "vr/market/rt/cfg/agent_cfg_fwd.h"
@@ -8,9 +9,10 @@
 #include "vr/rt/cfg/app_cfg_fwd.h"
 #include "vr/settings_fwd.h"
 #include "vr/startable.h"
+#include "vr/util/datetime.h"
 #include "vr/util/di/component.h"
 
-#include <boost/iterator/iterator_facade.hpp>
+#include <vector>
 
 //----------------------------------------------------------------------------
 namespace vr
@@ -23,18 +25,21 @@ namespace ASX
  * this pre-loads reference data that is meant to stay fixed and pinned in memory
  * for the duration of a session
  *
+ * instrument definitions are read either from the "DAO" dependency or, if "image" is
+ * set in the cfg, from a binary @ref ref_image (in which case no "DAO" is needed)
+ *
  * @see io::object_DAO
+ * @see ref_image
  */
 class ref_data final: public util::di::component, public startable
 {
-    private: // ..............................................................
-
-        class iterator_impl; // forward
-
     public: // ...............................................................
 
-        using const_iterator    = iterator_impl;
+        using const_iterator    = std::vector<instrument>::const_iterator;
 
+        /**
+         * @param cfg optional: "image" -> ref image file path
+         */
         ref_data (settings const & cfg);
 
         // ACCESSORs:
@@ -49,40 +54,11 @@ class ref_data final: public util::di::component, public startable
 
     private: // ..............................................................
 
-        using symbol_map    = boost::unordered_map<std::string, instrument>; // TODO a good use case for a perfect hashmap
-        using iid_map       = util::chained_scatter_table<iid_t, instrument const *, util::identity_hash<iid_t> >; // TODO check iid pdf
-
-        struct iterator_impl final: public boost::iterator_facade<iterator_impl, instrument const, boost::forward_traversal_tag>
-        {
-            friend class boost::iterator_core_access;
-
-            iterator_impl (symbol_map::const_iterator const & position) VR_NOEXCEPT :
-                m_position { position }
-            {
-            }
-
-            // iterator_facade:
-
-            void increment ()
-            {
-                ++ m_position;
-            }
-
-            const instrument & dereference () const
-            {
-                return m_position->second; // TODO except for this deref of the 'instrument' part, this entire iterator impl seems almost redundant
-            }
-
-            bool equal (iterator_impl const & rhs) const
-            {
-                return (m_position == rhs.m_position);
-            }
-
-            symbol_map::const_iterator m_position;
+        // ref data doesn't change after start(), so both lookup maps are built once
+        // (and then are single-probe):
 
-        }; // end of nested class
-
-        static constexpr iid_map::size_type initial_iid_map_capacity () { return 256; }
+        using symbol_map    = util::perfect_hash_table<std::string, instrument const *>;
+        using iid_map       = util::perfect_hash_table<iid_t, instrument const *>;
 
         // startable:
 
@@ -91,13 +67,19 @@ class ref_data final: public util::di::component, public startable
 
         // TODO use pimpl here?
 
+        VR_ASSUME_COLD void load_from_DAO (util::date_t const & effective_date);
+        VR_ASSUME_COLD void load_from_image (util::date_t const & effective_date);
+
 
         rt::app_cfg const * m_config { };   // [dep]
         agent_cfg const * m_agents { };     // [dep]
-        io::object_DAO const * m_dao { };   // [dep]
+        io::object_DAO const * m_dao { };   // [dep, unless using an image]
+
+        fs::path const m_image;
 
-        symbol_map m_symbol_map { }; // [owning]
-        iid_map m_iid_map { initial_iid_map_capacity () }; // value entries reference 'm_symbol_map' slots (after it's been fully populated)
+        std::vector<instrument> m_instruments { }; // [owning]
+        symbol_map m_symbol_map { };
+        iid_map m_iid_map { }; // value entries of both maps reference 'm_instruments' slots (after it's been fully populated)
 
 }; // end of class
 //............................................................................
@@ -113,6 +95,17 @@ ref_data::operator[] (iid_t const iid) const
     return (* i);
 }
 
+inline instrument const &
+ref_data::operator[] (std::string const & symbol) const
+{
+    instrument const * const i = m_symbol_map.get (symbol);
+    if (VR_UNLIKELY (i == nullptr))
+        throw_x (invalid_input, "invalid symbol " + print (symbol));
+
+    assert_nonnull (i);
+    return (* i);
+}
+
 } // end of 'ASX'
 } // end of 'market'
 } // end of namespace
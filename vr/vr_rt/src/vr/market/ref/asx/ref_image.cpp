@@ -0,0 +1,422 @@
+
+#include "vr/market/ref/asx/ref_image.h"
+
+#include "vr/io/files.h"
+#include "vr/io/mapped_files.h" // mmap_fd()
+#include "vr/sys/defs.h" // VR_CHECKED_SYS_CALL
+#include "vr/sys/os.h"
+#include "vr/util/crc32.h"
+#include "vr/util/logging.h"
+
+#include <cstring>
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace market
+{
+namespace ASX
+{
+//............................................................................
+//............................................................................
+namespace
+{
+/*
+ * on-disk layout (all offsets are from the start of the image, all sections
+ * are 8-byte aligned):
+ */
+struct image_header final
+{
+    uint64_t m_magic;
+    int32_t m_version;
+    int32_t m_count;            // instrument record count
+    int32_t m_as_of;            // days since epoch
+    int32_t m_index_capacity;   // slot count of each index table (a power of 2)
+    int64_t m_records;          // -> image_record [m_count]
+    int64_t m_ticks;            // -> image_tick []
+    int64_t m_strings;          // -> char []
+    int64_t m_symbol_index;     // -> int32_t [m_index_capacity]
+    int64_t m_iid_index;        // -> int32_t [m_index_capacity]
+    int64_t m_size;             // image size (the file itself is padded to a page multiple)
+
+}; // end of class
+
+struct image_record final
+{
+    int32_t m_symbol;           // string pool offset
+    int32_t m_symbol_len;
+    int32_t m_name;             // string pool offset
+    int32_t m_name_len;
+    int32_t m_tick_begin;       // tick entry array index
+    int32_t m_tick_count;
+    iid_t m_iid;
+    int32_t m_partition;
+    uint8_t m_product;
+    uint8_t m_ccy;
+    std::array<char, std::tuple_size<ISIN_code>::value> m_ISIN;
+    int8_t m_pad [2];
+
+}; // end of class
+
+struct image_tick final
+{
+    price_si_t m_tick_size;
+    price_si_t m_begin;
+
+}; // end of class
+
+vr_static_assert (std::is_standard_layout<image_header>::value);
+vr_static_assert (std::is_standard_layout<image_record>::value);
+vr_static_assert (sizeof (image_record) % 8 == 0);
+vr_static_assert (sizeof (image_tick) == 16);
+
+constexpr int64_t align8 (int64_t const x)  { return ((x + 7) & ~7L); }
+
+// note: these hashes are part of the image format (must be stable across processes and builds)
+
+inline uint32_t
+symbol_hash (char const * const s, int32_t const len)
+{
+    return util::crc32 (reinterpret_cast<uint8_t const *> (s), len, 0);
+}
+
+inline uint32_t
+iid_hash (iid_t const iid)
+{
+    return util::i_crc32 (0U, static_cast<uint32_t> (iid));
+}
+//............................................................................
+/*
+ * bounds-check all sections of a mapped image (and all references into them)
+ * against its 'extent', so that no lookup can read outside of the mapping or
+ * probe forever
+ *
+ * @return description of the first inconsistency found or 'nullptr' if none
+ */
+char const *
+validate_layout (image_header const & hdr, int8_t const * const base, int64_t const extent)
+{
+    for (int64_t const offset : { hdr.m_records, hdr.m_ticks, hdr.m_strings, hdr.m_symbol_index, hdr.m_iid_index, hdr.m_size })
+    {
+        if ((offset < 0) || (offset > extent) || (offset & 7)) return "section offset out of bounds or misaligned";
+    }
+
+    int32_t const count = hdr.m_count;
+    int32_t const index_capacity = hdr.m_index_capacity;
+
+    if ((count < 0) || (index_capacity <= count) || (index_capacity & (index_capacity - 1)))
+        return "bad record count or index capacity";
+
+    int64_t const index_size = index_capacity * static_cast<int64_t> (sizeof (int32_t));
+
+    if ((hdr.m_records < static_cast<int64_t> (sizeof (image_header))) ||
+        (hdr.m_records + count * static_cast<int64_t> (sizeof (image_record)) > hdr.m_ticks) ||
+        (hdr.m_ticks > hdr.m_strings) ||
+        (hdr.m_strings > hdr.m_symbol_index) ||
+        (hdr.m_symbol_index + index_size > hdr.m_iid_index) ||
+        (hdr.m_iid_index + index_size > hdr.m_size))
+        return "sections overlap or are out of order";
+
+    int64_t const tick_count = (hdr.m_strings - hdr.m_ticks) / static_cast<int64_t> (sizeof (image_tick));
+    int64_t const strings_size = (hdr.m_symbol_index - hdr.m_strings);
+
+    image_record const * const records = reinterpret_cast<image_record const *> (base + hdr.m_records);
+
+    for (int32_t ix = 0; ix < count; ++ ix)
+    {
+        image_record const & r = records [ix];
+
+        if ((r.m_symbol < 0) || (r.m_symbol_len < 0) || (r.m_symbol + static_cast<int64_t> (r.m_symbol_len) > strings_size) ||
+            (r.m_name < 0) || (r.m_name_len < 0) || (r.m_name + static_cast<int64_t> (r.m_name_len) > strings_size))
+            return "record string out of bounds";
+
+        if ((r.m_tick_begin < 0) || (r.m_tick_count < 0) || (r.m_tick_begin + static_cast<int64_t> (r.m_tick_count) > tick_count))
+            return "record tick table out of bounds";
+    }
+
+    for (int64_t const index : { hdr.m_symbol_index, hdr.m_iid_index })
+    {
+        int32_t const * const slots = reinterpret_cast<int32_t const *> (base + index);
+        int32_t used { };
+
+        for (int32_t s = 0; s < index_capacity; ++ s)
+        {
+            int32_t const ix = slots [s];
+
+            if ((ix < -1) || (ix >= count)) return "index slot out of bounds";
+            used += (ix >= 0);
+        }
+
+        if (used != count) return "index slot count mismatch"; // [also guarantees an empty slot to end every probe at]
+    }
+
+    return nullptr;
+}
+
+} // end of anonymous
+//............................................................................
+//............................................................................
+
+ref_image::ref_image (fs::path const & file)
+{
+    int32_t const fd = VR_CHECKED_SYS_CALL (::open (file.c_str (), (O_RDONLY | O_CLOEXEC)));
+    try
+    {
+        struct ::stat st;
+        VR_CHECKED_SYS_CALL (::fstat (fd, & st));
+
+        int32_t const page_size = sys::os_info::instance ().page_size ();
+
+        if (VR_UNLIKELY ((st.st_size < static_cast<signed_size_t> (sizeof (image_header))) || (st.st_size % page_size)))
+            throw_x (invalid_input, "not a ref image (size " + string_cast (st.st_size) + "): " + print (io::absolute_path (file)));
+
+        m_extent = st.st_size;
+        m_base = static_cast<int8_t const *> (io::mmap_fd (nullptr, m_extent, PROT_READ, MAP_SHARED, fd, 0));
+    }
+    catch (...)
+    {
+        ::close (fd);
+        throw;
+    }
+    ::close (fd); // the mapping stays valid
+
+    image_header const & hdr = * reinterpret_cast<image_header const *> (m_base);
+
+    if (VR_UNLIKELY ((hdr.m_magic != magic ()) || (hdr.m_version != version ())))
+    {
+        int32_t const hdr_version = hdr.m_version;
+
+        ::munmap (const_cast<int8_t *> (m_base), m_extent); // destructor won't run
+        throw_x (invalid_input, "invalid ref image (version " + string_cast (hdr_version) + ", expected " + string_cast (version ()) + "): " + print (io::absolute_path (file)));
+    }
+
+    char const * const layout_error = validate_layout (hdr, m_base, m_extent);
+    if (VR_UNLIKELY (layout_error != nullptr))
+    {
+        ::munmap (const_cast<int8_t *> (m_base), m_extent); // destructor won't run
+        throw_x (invalid_input, "invalid ref image (" + std::string { layout_error } + "): " + print (io::absolute_path (file)));
+    }
+
+    m_as_of = util::epoch_date () + gd::days { hdr.m_as_of };
+
+    LOG_trace1 << "mapped ref image " << print (io::absolute_path (file)) << " as of [" << m_as_of << "]: " << hdr.m_count << " instrument(s), " << m_extent << " byte(s)";
+}
+
+ref_image::~ref_image () VR_NOEXCEPT
+{
+    if (m_base)
+    {
+        ::munmap (const_cast<int8_t *> (m_base), m_extent);
+        m_base = nullptr;
+    }
+}
+//............................................................................
+
+int32_t
+ref_image::size () const
+{
+    return reinterpret_cast<image_header const *> (m_base)->m_count;
+}
+
+int32_t
+ref_image::find (std::string const & symbol) const
+{
+    image_header const & hdr = * reinterpret_cast<image_header const *> (m_base);
+
+    image_record const * const records = reinterpret_cast<image_record const *> (m_base + hdr.m_records);
+    char const * const strings = reinterpret_cast<char const *> (m_base + hdr.m_strings);
+    int32_t const * const slots = reinterpret_cast<int32_t const *> (m_base + hdr.m_symbol_index);
+
+    int32_t const len = symbol.size ();
+    uint32_t const mask = hdr.m_index_capacity - 1;
+
+    for (uint32_t s = symbol_hash (symbol.data (), len); ; ++ s) // linear probing (the tables are at most half full)
+    {
+        int32_t const ix = slots [s & mask];
+        if (ix < 0) return -1;
+
+        image_record const & r = records [ix];
+        if ((r.m_symbol_len == len) && ! std::memcmp (strings + r.m_symbol, symbol.data (), len))
+            return ix;
+    }
+}
+
+int32_t
+ref_image::find (iid_t const iid) const
+{
+    image_header const & hdr = * reinterpret_cast<image_header const *> (m_base);
+
+    image_record const * const records = reinterpret_cast<image_record const *> (m_base + hdr.m_records);
+    int32_t const * const slots = reinterpret_cast<int32_t const *> (m_base + hdr.m_iid_index);
+
+    uint32_t const mask = hdr.m_index_capacity - 1;
+
+    for (uint32_t s = iid_hash (iid); ; ++ s) // linear probing (the tables are at most half full)
+    {
+        int32_t const ix = slots [s & mask];
+        if ((ix < 0) || (records [ix].m_iid == iid)) return ix;
+    }
+}
+
+instrument
+ref_image::at (int32_t const ix) const
+{
+    image_header const & hdr = * reinterpret_cast<image_header const *> (m_base);
+    check_within (ix, hdr.m_count);
+
+    image_record const & r = reinterpret_cast<image_record const *> (m_base + hdr.m_records) [ix];
+    image_tick const * const ticks = reinterpret_cast<image_tick const *> (m_base + hdr.m_ticks);
+    char const * const strings = reinterpret_cast<char const *> (m_base + hdr.m_strings);
+
+    instrument i { };
+    {
+        i.symbol ().assign (strings + r.m_symbol, r.m_symbol_len);
+        i.iid () = r.m_iid;
+        i.partition () = r.m_partition;
+        i.product () = static_cast<ITCH_product::enum_t> (r.m_product);
+        i.ccy () = static_cast<currency::enum_t> (r.m_ccy);
+        i.ISIN () = r.m_ISIN;
+        i.name ().assign (strings + r.m_name, r.m_name_len);
+
+        auto & tt = i.tick_table ();
+        tt.reserve (r.m_tick_count);
+
+        for (int32_t t = r.m_tick_begin, t_limit = r.m_tick_begin + r.m_tick_count; t < t_limit; ++ t)
+        {
+            tick_size_entry e { };
+            e.tick_size () = ticks [t].m_tick_size;
+            e.begin () = ticks [t].m_begin;
+
+            tt.push_back (e);
+        }
+    }
+
+    return i;
+}
+//............................................................................
+
+void
+ref_image::write (fs::path const & file, util::date_t const & as_of, std::vector<instrument> const & instruments)
+{
+    int32_t const count = instruments.size ();
+
+    int32_t index_capacity = 16;
+    while (index_capacity < 2 * count) index_capacity <<= 1;
+
+    // lay out the string pool and the tick entries:
+
+    std::vector<image_record> records (count);
+    std::vector<image_tick> ticks { };
+    std::string strings { };
+
+    for (int32_t ix = 0; ix < count; ++ ix)
+    {
+        instrument const & i = instruments [ix];
+        image_record & r = records [ix];
+
+        std::memset (& r, 0, sizeof (r));
+
+        r.m_symbol = strings.size ();
+        r.m_symbol_len = i.symbol ().size ();
+        strings.append (i.symbol ());
+
+        r.m_name = strings.size ();
+        r.m_name_len = i.name ().size ();
+        strings.append (i.name ());
+
+        r.m_tick_begin = ticks.size ();
+        r.m_tick_count = i.tick_table ().size ();
+        for (tick_size_entry const & e : i.tick_table ())
+        {
+            ticks.push_back ({ e.tick_size (), e.begin () });
+        }
+
+        r.m_iid = i.iid ();
+        r.m_partition = i.partition ();
+        r.m_product = i.product ();
+        r.m_ccy = i.ccy ();
+        r.m_ISIN = i.ISIN ();
+    }
+
+    // build the index tables:
+
+    std::vector<int32_t> symbol_index (index_capacity, -1);
+    std::vector<int32_t> iid_index (index_capacity, -1);
+    {
+        uint32_t const mask = index_capacity - 1;
+
+        for (int32_t ix = 0; ix < count; ++ ix)
+        {
+            instrument const & i = instruments [ix];
+
+            for (uint32_t s = symbol_hash (i.symbol ().data (), i.symbol ().size ()); ; ++ s)
+            {
+                int32_t & slot = symbol_index [s & mask];
+                if (slot < 0) { slot = ix; break; }
+
+                if (VR_UNLIKELY (instruments [slot].symbol () == i.symbol ()))
+                    throw_x (invalid_input, "duplicate symbol " + print (i.symbol ()));
+            }
+
+            for (uint32_t s = iid_hash (i.iid ()); ; ++ s)
+            {
+                int32_t & slot = iid_index [s & mask];
+                if (slot < 0) { slot = ix; break; }
+
+                if (VR_UNLIKELY (instruments [slot].iid () == i.iid ()))
+                    throw_x (invalid_input, "duplicate iid " + string_cast (i.iid ()));
+            }
+        }
+    }
+
+    image_header hdr;
+    std::memset (& hdr, 0, sizeof (hdr));
+    {
+        hdr.m_magic = magic ();
+        hdr.m_version = version ();
+        hdr.m_count = count;
+        hdr.m_as_of = (as_of - util::epoch_date ()).days ();
+        hdr.m_index_capacity = index_capacity;
+
+        hdr.m_records       = align8 (sizeof (image_header));
+        hdr.m_ticks         = align8 (hdr.m_records + count * sizeof (image_record));
+        hdr.m_strings       = align8 (hdr.m_ticks + ticks.size () * sizeof (image_tick));
+        hdr.m_symbol_index  = align8 (hdr.m_strings + strings.size ());
+        hdr.m_iid_index     = align8 (hdr.m_symbol_index + index_capacity * sizeof (int32_t));
+        hdr.m_size          = (hdr.m_iid_index + index_capacity * sizeof (int32_t));
+    }
+
+    int32_t const page_size = sys::os_info::instance ().page_size ();
+
+    std::string image (((hdr.m_size + page_size - 1) / page_size) * page_size, '\0');
+    {
+        std::memcpy (& image [0], & hdr, sizeof (hdr));
+        std::memcpy (& image [hdr.m_records], records.data (), count * sizeof (image_record));
+        std::memcpy (& image [hdr.m_ticks], ticks.data (), ticks.size () * sizeof (image_tick));
+        std::memcpy (& image [hdr.m_strings], strings.data (), strings.size ());
+        std::memcpy (& image [hdr.m_symbol_index], symbol_index.data (), index_capacity * sizeof (int32_t));
+        std::memcpy (& image [hdr.m_iid_index], iid_index.data (), index_capacity * sizeof (int32_t));
+    }
+
+    fs::path const tmp_file { file.native () + ".tmp" };
+    {
+        std::ofstream out { tmp_file.c_str (), (io::default_ostream_mode () | std::ios_base::trunc) };
+        out.write (image.data (), image.size ());
+
+        if (VR_UNLIKELY (! out.flush ()))
+            throw_x (io_exception, "failed to write " + print (io::absolute_path (tmp_file)));
+    }
+    fs::rename (tmp_file, file);
+
+    LOG_info << "wrote ref image " << print (io::absolute_path (file)) << " as of [" << as_of << "]: " << count << " instrument(s), " << image.size () << " byte(s)";
+}
+
+} // end of 'ASX'
+} // end of 'market'
+} // end of namespace
+//----------------------------------------------------------------------------
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "vr/filesystem.h"
+#include "vr/market/ref/asx/instrument.h"
+#include "vr/market/sources/asx/defs.h" // iid_t
+#include "vr/util/datetime.h"
+
+#include <vector>
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace market
+{
+namespace ASX
+{
+/**
+ * a read-only view of a binary instrument universe image (as written by @ref write(), e.g.
+ * by 'ref_tool make-ref --image'), mapped with MAP_SHARED so that all processes on a host
+ * share a single page cache copy
+ *
+ * the image is position-independent (all references are file offsets) and consists of
+ *
+ *  - a versioned header;
+ *  - a flat fixed-size instrument record array;
+ *  - a tick size table entry array and a string pool (both referenced from the records);
+ *  - two prebuilt open-addressed index tables (symbol -> record, iid -> record)
+ *
+ * @see ref_data
+ */
+class ref_image final: noncopyable
+{
+    public: // ...............................................................
+
+        static constexpr uint64_t magic ()      { return 0x474D494645525256; } // "VRREFIMG" [little-endian]
+        static constexpr int32_t version ()     { return 1; }
+
+        /**
+         * @throws invalid_input if 'file' is not a valid image of the current @ref version()
+         */
+        ref_image (fs::path const & file);
+        ~ref_image () VR_NOEXCEPT;
+
+        // ACCESSORs:
+
+        util::date_t const & as_of () const
+        {
+            return m_as_of;
+        }
+
+        int32_t size () const;
+
+        /**
+         * @return record index of 'symbol' or -1 if not found
+         */
+        int32_t find (std::string const & symbol) const;
+
+        /**
+         * @return record index of 'iid' or -1 if not found
+         */
+        int32_t find (iid_t const iid) const;
+
+        /**
+         * @return instrument definition materialized from record 'ix'
+         */
+        instrument at (int32_t const ix) const;
+
+        // writing:
+
+        /**
+         * write an image of 'instruments' atomically (via a temp file rename, so that existing
+         * mappings of a previous 'file' version stay valid)
+         *
+         * @throws invalid_input on duplicate symbols or iids
+         */
+        static void write (fs::path const & file, util::date_t const & as_of, std::vector<instrument> const & instruments);
+
+    private: // ..............................................................
+
+        int8_t const * m_base { };
+        signed_size_t m_extent { };
+        util::date_t m_as_of { };
+
+}; // end of class
+
+} // end of 'ASX'
+} // end of 'market'
+} // end of namespace
+//----------------------------------------------------------------------------
@@ -0,0 +1,179 @@
+
+#include "vr/market/ref/asx/ref_image.h"
+
+#include "vr/io/files.h"
+#include "vr/util/random.h"
+
+#include "vr/test/utility.h"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace market
+{
+namespace ASX
+{
+//............................................................................
+
+TEST (ref_image, round_trip)
+{
+    uint64_t rnd = test::env::random_seed<uint64_t> ();
+
+    constexpr int32_t instrument_count      = 3000;
+
+    std::vector<instrument> instruments { };
+
+    for (int32_t ix = 0; ix < instrument_count; ++ ix)
+    {
+        instrument i { };
+        {
+            i.symbol () = "S" + string_cast (ix);
+            i.iid () = 10000 + 7 * ix;
+            i.partition () = ix % partition_count ();
+            i.product () = (ix % 3 ? ITCH_product::equity : ITCH_product::option);
+            i.ccy () = (ix % 2 ? currency::AUD : currency::USD);
+            i.ISIN () = { { 'A', 'U', '0', '0', '0', '0', '0', '0', '0', '0', '0', static_cast<char> ('0' + ix % 10) } };
+            i.name () = "instrument #" + string_cast (ix);
+
+            for (int32_t t = 0, t_limit = unsigned_cast (util::xorshift (rnd)) % 4; t < t_limit; ++ t)
+            {
+                tick_size_entry e { };
+                e.tick_size () = 1 + t;
+                e.begin () = 1000 * t;
+
+                i.tick_table ().push_back (e);
+            }
+        }
+        instruments.push_back (std::move (i));
+    }
+
+    fs::path const out_dir { test::unique_test_path () };
+    io::create_dirs (out_dir);
+
+    fs::path const file { out_dir / "ref.img" };
+    util::date_t const as_of { 2018, 2, 21 };
+
+    ref_image::write (file, as_of, instruments);
+
+    ref_image const image { file };
+
+    EXPECT_EQ (as_of, image.as_of ());
+    ASSERT_EQ (instrument_count, image.size ());
+
+    for (instrument const & i : instruments)
+    {
+        int32_t const ix = image.find (i.symbol ());
+        ASSERT_TRUE (vr_is_within (ix, instrument_count)) << i.symbol ();
+        EXPECT_EQ (ix, image.find (i.iid ())) << i.symbol ();
+
+        instrument const i_image = image.at (ix);
+
+        EXPECT_EQ (i.symbol (), i_image.symbol ());
+        EXPECT_EQ (i.iid (), i_image.iid ());
+        EXPECT_EQ (i.partition (), i_image.partition ());
+        EXPECT_EQ (i.product (), i_image.product ());
+        EXPECT_EQ (i.ccy (), i_image.ccy ());
+        EXPECT_EQ (i.ISIN (), i_image.ISIN ());
+        EXPECT_EQ (i.name (), i_image.name ());
+        EXPECT_EQ (i.tick_table (), i_image.tick_table ());
+    }
+
+    // misses:
+
+    EXPECT_EQ (-1, image.find (std::string { "NOT.THERE" }));
+    EXPECT_EQ (-1, image.find (iid_t { 3 }));
+}
+
+TEST (ref_image, duplicates_rejected)
+{
+    fs::path const out_dir { test::unique_test_path () };
+    io::create_dirs (out_dir);
+
+    instrument i { };
+    {
+        i.symbol () = "BHP";
+        i.iid () = 1;
+    }
+    instrument j { i };
+    j.iid () = 2; // same symbol
+
+    EXPECT_THROW (ref_image::write (out_dir / "ref.img", util::date_t { 2018, 2, 21 }, { i, j }), invalid_input);
+}
+
+/*
+ * patch individual header/record fields of a valid image and check that each corruption
+ * is rejected at load time (rather than faulting or probing forever in lookups)
+ */
+TEST (ref_image, corrupt_layout_rejected)
+{
+    fs::path const out_dir { test::unique_test_path () };
+    io::create_dirs (out_dir);
+
+    std::vector<instrument> instruments { };
+    for (int32_t ix = 0; ix < 10; ++ ix)
+    {
+        instrument i { };
+        {
+            i.symbol () = "S" + string_cast (ix);
+            i.iid () = 100 + ix;
+            i.name () = "instrument #" + string_cast (ix);
+            i.tick_table ().push_back ({ });
+        }
+        instruments.push_back (std::move (i));
+    }
+
+    fs::path const file { out_dir / "ref.img" };
+    ref_image::write (file, util::date_t { 2018, 2, 21 }, instruments);
+
+    std::string image { };
+    {
+        std::ifstream in { file.c_str (), std::ios_base::binary };
+        image.assign (std::istreambuf_iterator<char> { in }, std::istreambuf_iterator<char> { });
+    }
+    ASSERT_NO_THROW (ref_image { file });
+
+    // (version 1 layout) header: count @12, index capacity @20, section offsets @24..64; records start @72:
+
+    struct patch final
+    {
+        int32_t m_offset;
+        int64_t m_value;
+        int32_t m_size;
+
+    }; // end of class
+
+    for (patch const & p : std::vector<patch>
+        {
+            { 12,   -1,                 4 },    // negative count
+            { 12,   1000000,            4 },    // count overruns the record section
+            { 20,   24,                 4 },    // index capacity not a power of 2
+            { 20,   8,                  4 },    // index capacity not larger than count
+            { 24,   (1L << 40),         8 },    // records beyond the mapping
+            { 40,   (1L << 40),         8 },    // strings beyond the mapping
+            { 48,   28,                 8 },    // misaligned symbol index
+            { 64,   (1L << 40),         8 },    // size beyond the mapping
+            { 72,   (1 << 20),          4 },    // first record's symbol beyond the string pool
+            { 72 + 16, 1000,            4 },    // first record's tick table beyond the tick section
+        })
+    {
+        std::string corrupt { image };
+        std::memcpy (& corrupt [p.m_offset], & p.m_value, p.m_size); // [little-endian]
+
+        fs::path const corrupt_file { out_dir / ("ref." + string_cast (p.m_offset) + '.' + string_cast (p.m_value) + ".img") };
+        {
+            std::ofstream out { corrupt_file.c_str (), std::ios_base::binary };
+            out.write (corrupt.data (), corrupt.size ());
+        }
+
+        EXPECT_THROW (ref_image { corrupt_file }, invalid_input) << "offset " << p.m_offset << ", value " << p.m_value;
+    }
+}
+
+} // end of 'ASX'
+} // end of 'market'
+} // end of namespace
+//----------------------------------------------------------------------------
@@ -2,6 +2,7 @@
 #include "vr/market/rt/agents/asx/agent.h"
 
 #include "vr/market/ref/asx/ref_data.h"
+#include "vr/market/rt/asx/book_builder.h"
 #include "vr/util/parse.h"
 
 //----------------------------------------------------------------------------
@@ -30,7 +31,7 @@ extract_ID (scope_path const cfg_path)
 namespace impl
 {
 
-agent_base::agent_base (scope_path const cfg_path) :
+agent_base::agent_base (scope_path const cfg_path, std::string const & book_builder) :
     market_data_manager (),
     execution_manager (extract_ID (cfg_path)), // note: this base constructor makes 'ID ()' accessor valid
     m_cfg_path { cfg_path }
@@ -38,6 +39,8 @@ agent_base::agent_base (scope_path const cfg_path) :
     dep (m_mdf) = "mdf";    // note: dep inherited from 'market_data_manager' but bound here
     dep (m_xl)  = "xl";     // note: dep inherited from 'execution_manager' but bound here
 
+    if (! book_builder.empty ()) dep (m_builder) = book_builder; // note: dep inherited from 'market_data_manager' but bound here
+
     dep (m_config) = "config";
     dep (m_agents) = "agents";
     dep (m_ref_data) = "ref_data";
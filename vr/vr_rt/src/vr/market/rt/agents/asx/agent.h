@@ -35,8 +35,10 @@ class agent_base: public mc::steppable_<mc::rcu<_reader_>>, public util::di::com
 
         /**
          * @param cfg_path in the form '/.../<agent ID>'
+         * @param book_builder if not empty, name of a @ref book_builder dep whose books this
+         *        agent will read instead of decoding market data itself
          */
-        agent_base (scope_path const cfg_path);
+        agent_base (scope_path const cfg_path, std::string const & book_builder = { });
 
 
         // ACCESSORs:
@@ -499,7 +499,7 @@ TEST (agent, single_instrument)
         ("sql",         new io::sql_connection_factory { { { "sql.ro", cfg ["sql"]["sql.ro"] } } })
 
         ("server.itch", new mock_mcast_server { "/mock_server/itch" })
-        ("server.ouch", new mock_ouch_server  { "/mock_server/ouch" })
+        ("server.ouch", new mock_ouch_server  { "/mock_server/ouch", "server.itch" }) // note: shares the replay clock of "server.itch"
 
         ("threads",     new mc::thread_pool   { "/thread_pool" })
         ("agents",      new agent_cfg         { "/agents" })
@@ -38,7 +38,7 @@ using namespace io::net;
 using book_type         = execution_order_book<price_si_t, order_token, this_source_traits>;
 using view_type         = execution_view<book_type>;
 
-using visit_ctx         = market_event_context<_ts_local_, _ts_origin_, _partition_>;
+using visit_ctx         = market_event_context<_ts_local_, _ts_origin_, _ts_sent_, _partition_>;
 
 template<typename DERIVED>
 using make_listener     = execution_listener<this_source (), book_type, visit_ctx, DERIVED>;
@@ -184,6 +184,7 @@ class execution_manager: public impl::ex::view_type, public impl::ex::make_liste
                         visit_ctx ctx { };
                         {
                             field<_ts_local_> (ctx) = rcvd.m_ts_local;
+                            field<_ts_sent_> (ctx) = rcvd.m_ts_sent;
                             field<_partition_> (ctx) = pix;
                         }
 
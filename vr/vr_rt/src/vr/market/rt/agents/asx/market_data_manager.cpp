@@ -2,6 +2,7 @@
 #include "vr/market/rt/agents/asx/market_data_manager.h"
 
 #include "vr/market/ref/asx/ref_data.h"
+#include "vr/market/rt/asx/book_builder.h"
 #include "vr/market/rt/cfg/agent_cfg.h"
 #include "vr/rt/cfg/app_cfg.h"
 
@@ -20,7 +21,17 @@ namespace md
 {
 consume_context::consume_context (arg_map const & args) :
     m_mdv { args },
-    m_visitor { { { "view", std::cref (m_mdv) } } }
+    m_signals { static_cast<int32_t> (m_mdv.size ()) },
+    m_rewinder { args.get<market_data_feed const &> ("mdf").create_rewinder () },
+    m_visitor { { { "view", std::cref (m_mdv) }, { "trade_signals", & m_signals }, { "rewinder", m_rewinder.get () } } }
+{
+}
+
+build_context::build_context (arg_map const & args) :
+    m_mdv { args },
+    m_books { static_cast<int32_t> (m_mdv.size ()) },
+    m_rewinder { args.get<market_data_feed const &> ("mdf").create_rewinder () },
+    m_visitor { { { "view", std::cref (m_mdv) }, { "shared_books", & m_books }, { "rewinder", m_rewinder.get () } } }
 {
 }
 
@@ -32,15 +43,34 @@ consume_context::consume_context (arg_map const & args) :
 void
 market_data_manager::start (rt::app_cfg const & config, agent_cfg const & agents, ref_data const & rd, agent_ID const & ID)
 {
+    if (m_builder) // shared mode
+    {
+        m_shared_books = & m_builder->books ();
+        m_cursor = m_shared_books->cursor (); // start with the next update
+
+        LOG_info << '[' << ID << "] reading " << m_shared_books->size () << " shared book(s)";
+        return;
+    }
+
     m_consume_ctx = std::make_unique<impl::md::consume_context>
     (
         arg_map
         {
             { "agents",     std::cref (agents) },
-            { "ref_data",   std::cref (rd) }
+            { "ref_data",   std::cref (rd) },
+            { "mdf",        std::cref (* m_mdf) }
         }
     );
 }
+//............................................................................
+
+void
+market_data_manager::on_overrun ()
+{
+    auto const skipped = m_shared_books->resync (m_cursor);
+
+    LOG_warn << "book update overrun #" << (++ m_overrun_count) << ", skipped " << skipped << " update(s)";
+}
 
 } // end of 'ASX'
 } // end of 'market'
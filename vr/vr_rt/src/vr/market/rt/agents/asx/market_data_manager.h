@@ -5,6 +5,8 @@
 #include "vr/io/net/utility.h" // min_size_or_zero
 #include "vr/market/books/asx/market_data_listener.h"
 #include "vr/market/books/asx/market_data_view.h"
+#include "vr/market/books/asx/shared_books.h"
+#include "vr/market/books/asx/trade_signals.h"
 #include "vr/market/books/book_event_context.h"
 #include "vr/market/defs.h" // agent_ID, liid_t
 #include "vr/market/rt/agents/defs.h"
@@ -23,6 +25,8 @@ namespace market
 {
 namespace ASX
 {
+class book_builder; // forward
+
 //............................................................................
 //............................................................................
 namespace impl
@@ -35,31 +39,140 @@ using namespace io::net;
 
 using book_type         = limit_order_book<price_si_t, oid_t, level<_qty_, _order_count_>>;
 using view_type         = market_data_view<book_type>;
+using signals_type      = trade_signals<>;
 
 using visit_ctx         = book_event_context<_book_, _ts_origin_, _packet_index_, _partition_, _ts_local_, _seqnum_,  _dst_port_>;
 
 using selector          = view_type::instrument_selector<visit_ctx>;
+using signal_tracker    = signals_type::tracker<view_type, visit_ctx>;
 using listener          = market_data_listener<this_source (), book_type, visit_ctx>;
 
 using pipeline          = ITCH_pipeline
                         <
                             selector,
+                            signal_tracker, // needs to be ahead of the book listener to handle final fills
                             listener
                         >;
 
 using visitor           = IP_<UDP_<Mold_frame_<pipeline>>>;
 
+// a 'book_builder' pipeline (books only, published for sharing):
+
+using shared_books_type = shared_books<view_type>;
+using shared_tracker    = shared_books_type::tracker<visit_ctx>;
+
+using builder_pipeline  = ITCH_pipeline
+                        <
+                            selector,
+                            shared_tracker,
+                            listener
+                        >;
+
+using builder_visitor   = IP_<UDP_<Mold_frame_<builder_pipeline>>>;
+
 struct consume_context final
 {
     static constexpr int32_t min_available ()   { return net::min_size_or_zero<visitor>::value (); }
 
+    /*
+     * @param args required: "agents", "ref_data" (see 'view_type'), "mdf" -> market_data_feed
+     */
     consume_context (arg_map const & args);
 
     view_type m_mdv; // TODO needs 'ref_data' and 'instruments' args
+    signals_type m_signals;
+    std::unique_ptr<Mold_rewind_client> const m_rewinder; // [null unless "mdf" has gap recovery configured]
     visitor m_visitor;
 
 }; // end of class
 
+struct build_context final
+{
+    /*
+     * @param args same as for 'consume_context'
+     */
+    build_context (arg_map const & args);
+
+    view_type m_mdv;
+    shared_books_type m_books;
+    std::unique_ptr<Mold_rewind_client> const m_rewinder; // [null unless "mdf" has gap recovery configured]
+    builder_visitor m_visitor;
+
+}; // end of class
+//............................................................................
+/*
+ * consume all data published by 'mdf' past 'md_ctx' with 'v' (and, if 'v' is recovering
+ * from a seqnum gap, any data its rewinder has received)
+ *
+ * @return 'true' iff there was new data
+ */
+template<typename VISITOR>
+VR_FORCEINLINE bool
+poll_feed (market_data_feed const & mdf, link_context & md_ctx, VISITOR & v)
+{
+    constexpr int32_t min_available = net::min_size_or_zero<VISITOR>::value ();
+
+    bool r { false };
+
+    rcu_read_lock (); // [no-op on x86]
+    {
+        vr_static_assert (market_data_feed::poll_descriptor::width () == 1);
+
+        market_data_feed::poll_descriptor const & pd = mdf.poll ();
+
+        int32_t available = (pd [0].m_pos - md_ctx.m_pos);
+        if (available > 0)
+        {
+            DLOG_trace3 << '[' << print_timestamp (pd [0].m_ts_local) << "]: " << available << " byte(s) of ITCH data";
+
+            VR_IF_DEBUG // track local ts monotonicity
+            (
+                assert_le (md_ctx.m_ts_local_last, pd [0].m_ts_local, md_ctx.m_pos);
+                md_ctx.m_ts_local_last = pd [0].m_ts_local;
+            )
+
+            addr_const_t const data = addr_plus (pd [0].m_end, -/* ! */available); // start of all new data bytes
+
+            // although the UDP mcast socket used by 'market_data_feed' will always return a single UDP datagram
+            // when it is read, the feed/link can and will buffer datagrams if for whatever reasons we aren't
+            // consuming them in a timely manner; thus, we must loop here to ensure that we always catch
+            // up when given a chance -- this is part of the design contract for an RCU reader:
+
+            int32_t consumed { };
+
+            assert_ge (available, min_available); // framing guarantee
+            do
+            {
+                visit_ctx ctx { };
+                int32_t const rrc = v.consume (ctx, addr_plus (data, consumed), available);
+                if (rrc < 0)
+                    break;
+
+                available -= rrc;
+                consumed += rrc;
+
+                assert_nonnegative (available);
+                assert_le (consumed, (pd [0].m_pos - md_ctx.m_pos));
+            }
+            while (VR_UNLIKELY (available >= min_available));
+
+            assert_zero (available);    // RCU reader design contract
+            md_ctx.m_pos += consumed;   // equivalent to 'md_ctx.m_pos = pd [0].m_pos' but updates only local cache line(s)
+
+            r = true;
+        }
+    }
+    rcu_read_unlock (); // [no-op on x86]
+
+    if (VR_UNLIKELY (v.gap_mask ())) // splice in whatever the rewinder has recovered so far
+    {
+        visit_ctx ctx { };
+        r |= (v.poll_rewinder (ctx) > 0);
+    }
+
+    return r;
+}
+
 } // end of 'md'
 } // end of 'impl'
 //............................................................................
@@ -71,6 +184,10 @@ struct consume_context final
  * keyed by their iid's) and structures necessary to interface with a market_data_feed,
  * and implements ITCH visits via an event pipeline that updates limit_order_books in the view
  *
+ * alternatively, if bound to a @ref book_builder ("shared" mode), this does no ITCH decoding
+ * of its own and instead reads books published by the builder: snapshots via @ref shared_books()
+ * and book change events via @ref next_book_update()
+ *
  * @see limit_order_book
  * @see market_data_view
  * @see market_data_feed
@@ -86,67 +203,70 @@ class market_data_manager
         static constexpr int32_t min_available ()   { return impl::md::consume_context::min_available (); }
 
         /*
-         * poll this manager's market data feed and make the market data view current
+         * rolling window trade signals, indexed by liid [valid after 'start()', not available in shared mode]
          */
-        VR_FORCEINLINE void update ()
+        VR_FORCEINLINE impl::md::signals_type const & signals () const
         {
             assert_nonnull (m_consume_ctx);
 
-            rcu_read_lock (); // [no-op on x86]
-            {
-                vr_static_assert (market_data_feed::poll_descriptor::width () == 1);
-
-                market_data_feed::poll_descriptor const & pd = m_mdf->poll ();
+            return m_consume_ctx->m_signals;
+        }
 
-                int32_t available = (pd [0].m_pos - m_md_ctx.m_pos);
-                if (available > 0)
-                {
-                    DLOG_trace3 << '[' << print_timestamp (pd [0].m_ts_local) << "]: " << available << " byte(s) of ITCH data";
+        /*
+         * [shared mode] books published by the @ref book_builder, indexed by liid [valid after 'start()']
+         */
+        VR_FORCEINLINE impl::md::shared_books_type const & shared_books () const
+        {
+            assert_nonnull (m_shared_books);
 
-                    VR_IF_DEBUG // track local ts monotonicity
-                    (
-                        assert_le (m_md_ctx.m_ts_local_last, pd [0].m_ts_local, m_md_ctx.m_pos);
-                        m_md_ctx.m_ts_local_last = pd [0].m_ts_local;
-                    )
+            return (* m_shared_books);
+        }
 
-                    addr_const_t const data = addr_plus (pd [0].m_end, -/* ! */available); // start of all new data bytes
+        /*
+         * [shared mode] read the next book change event past this manager's cursor
+         *
+         * on 'mc::broadcast_read::overrun' (this agent has fallen more than the update buffer capacity
+         * behind) the cursor is moved past all published updates and the caller should re-read
+         * any book snapshots it depends on
+         */
+        VR_FORCEINLINE mc::broadcast_read::enum_t next_book_update (book_update & u)
+        {
+            assert_nonnull (m_shared_books);
 
-                    // although the UDP mcast socket used by 'market_data_feed' will always return a single UDP datagram
-                    // when it is read, the feed/link can and will buffer datagrams if for whatever reasons we aren't
-                    // consuming them in a timely manner; thus, we must loop here to ensure that we always catch
-                    // up when given a chance -- this is part of the design contract for an RCU reader:
+            mc::broadcast_read::enum_t const rc = m_shared_books->next_update (m_cursor, u);
 
-                    int32_t consumed { };
+            if (VR_UNLIKELY (rc == mc::broadcast_read::overrun))
+                on_overrun ();
 
-                    assert_ge (available, min_available ()); // framing guarantee
-                    do
-                    {
-                        impl::md::visit_ctx ctx { };
-                        int32_t const rrc = m_consume_ctx->m_visitor.consume (ctx, addr_plus (data, consumed), available);
-                        if (rrc < 0)
-                            break;
+            return rc;
+        }
 
-                        available -= rrc;
-                        consumed += rrc;
+        /*
+         * poll this manager's market data feed and make the market data view current
+         * [a no-op in shared mode]
+         */
+        VR_FORCEINLINE void update ()
+        {
+            if (m_shared_books) return; // nothing to decode
 
-                        assert_nonnegative (available);
-                        assert_le (consumed, (pd [0].m_pos - m_md_ctx.m_pos));
-                    }
-                    while (VR_UNLIKELY (available >= min_available ()));
+            assert_nonnull (m_consume_ctx);
 
-                    assert_zero (available);    // RCU reader design contract
-                    m_md_ctx.m_pos += consumed; // equivalent to 'm_md_ctx.m_pos = pd [0].m_pos' but updates only local cache line(s)
-                }
-            }
-            rcu_read_unlock (); // [no-op on x86]
+            impl::md::poll_feed (* m_mdf, m_md_ctx, m_consume_ctx->m_visitor);
         }
 
         market_data_feed const * m_mdf { }; // [dep]
+        book_builder const * m_builder { }; // [dep, optional]
 
     private: // ..............................................................
 
+        VR_ASSUME_COLD VR_NOINLINE void on_overrun ();
+
+
         link_context m_md_ctx { };
-        std::unique_ptr<impl::md::consume_context> m_consume_ctx { }; // set by 'start()'
+        std::unique_ptr<impl::md::consume_context> m_consume_ctx { }; // set by 'start()' [local mode]
+        impl::md::shared_books_type const * m_shared_books { };     // set by 'start()' [shared mode]
+        impl::md::shared_books_type::cursor_type m_cursor { };
+        int64_t m_overrun_count { };
 
 }; // end of class
 
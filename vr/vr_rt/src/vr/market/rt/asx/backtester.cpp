@@ -0,0 +1,750 @@
+
+#include "vr/market/rt/asx/backtester.h"
+
+#include "vr/io/mapped_ring_buffer.h"
+#include "vr/io/net/IP_.h"
+#include "vr/io/net/UDP_.h"
+#include "vr/io/pcap/pcap_reader.h"
+#include "vr/io/stream_factory.h"
+#include "vr/io/streams.h" // read_fully
+#include "vr/market/books/asx/market_data_listener.h"
+#include "vr/market/books/book_event_context.h"
+#include "vr/market/books/limit_order_book.h"
+#include "vr/market/net/SoupTCP_.h"
+#include "vr/market/ref/asx/ref_data.h"
+#include "vr/market/rt/cfg/agent_cfg.h"
+#include "vr/market/sources/asx/itch/ITCH_pipeline.h"
+#include "vr/market/sources/asx/itch/Mold_frame_.h"
+#include "vr/market/sources/asx/ouch/error_codes.h"
+#include "vr/market/sources/asx/ouch/messages.h"
+#include "vr/market/sources/mock/asx/mock_matching_engine.h"
+#include "vr/market/sources/mock/asx/mock_ouch_orders.h"
+#include "vr/market/sources/mock/utility.h" // runif_nonnegative
+#include "vr/rt/cfg/app_cfg.h"
+#include "vr/settings.h"
+#include "vr/sys/os.h"
+#include "vr/util/format.h"
+#include "vr/util/ops_int.h"
+
+#include <bitset>
+#include <deque>
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace market
+{
+namespace ASX
+{
+using namespace io;
+
+//............................................................................
+
+using int_ops           = util::ops_int<util::arg_policy<util::zero_arg_policy::ignore, 0>, false>; // unchecked
+
+static constexpr int32_t part_count ()          { return backtester::xl_poll_descriptor::width (); }
+
+static constexpr int32_t soup_hdr_len ()        { return sizeof (SoupTCP_packet_hdr); }
+
+static constexpr int32_t max_response_size ()
+{
+    return std::max ({ sizeof (ouch::order_accepted), sizeof (ouch::order_replaced), sizeof (ouch::order_canceled),
+                       sizeof (ouch::order_execution), sizeof (ouch::order_rejected), sizeof (SoupTCP_login_accepted) });
+}
+
+//............................................................................
+
+using book_type         = limit_order_book<price_si_t, oid_t, level<_qty_, _order_count_>>; // same as what agents use
+using engine_type       = mock_matching_engine<book_type>;
+
+using price_traits      = engine_type::price_traits;
+vr_static_assert (std::is_same<meta::find_field_def_t<_price_, xl_request>::value_type, engine_type::price_type>::value); // no rescaling of request prices
+
+using visit_ctx         = book_event_context<_book_, _partition_, _ts_local_, _seqnum_, net::_dst_port_>;
+
+using pipeline          = ITCH_pipeline
+                        <
+                            engine_type::selector<visit_ctx>,
+                            engine_type::tracker<visit_ctx>, // needs to be ahead of the book listener
+                            market_data_listener<source::ASX, book_type, visit_ctx>
+                        >;
+/*
+ * a Mold frame that also counts ITCH messages
+ */
+class counted_frame: public Mold_frame_<pipeline, counted_frame>
+{
+    private: // ..............................................................
+
+        using super         = Mold_frame_<pipeline, counted_frame>;
+
+    public: // ...............................................................
+
+        using super::super; // inherit constructors
+
+        // MoldUDP64_:
+
+        template<typename CTX>
+        VR_FORCEINLINE void
+        visit_MoldUDP64_payload (CTX & ctx, MoldUDP64_recv_packet_hdr const & packet_hdr, int32_t const msg_count, addr_const_t data) // override
+        {
+            m_message_count += msg_count;
+
+            super::visit_MoldUDP64_payload (ctx, packet_hdr, msg_count, data); // [chain]
+        }
+
+        int64_t m_message_count { };
+
+}; // end of class
+
+using visitor           = net::IP_<net::UDP_<counted_frame>>;
+
+//............................................................................
+
+using liid_map_entry    = meta::make_compact_struct_t<meta::make_schema_t
+                        <
+                            meta::fdef_<iid_t,      _iid_>,
+                            meta::fdef_<int32_t,    _partition_>
+                        >>;
+//............................................................................
+//............................................................................
+
+struct backtester::pimpl final
+{
+    using pcap_defs         = pcap_reader<>;
+    using size_type         = mapped_ring_buffer::size_type;
+
+    using order_ref         = engine_type::order_ref;
+    using report            = engine_type::report;
+
+    static constexpr int32_t min_available ()   { return pcap_defs::read_offset (); }
+
+
+    pimpl (backtester & parent, scope_path const & cfg_path) :
+        m_parent { parent },
+        m_cfg_path { cfg_path }
+    {
+        m_md_pd.clear ();
+        m_xl_pd.clear ();
+    }
+
+
+    VR_ASSUME_COLD void start ()
+    {
+        rt::app_cfg const & config = (* m_parent.m_config);
+
+        settings const & cfg = config.scope (m_cfg_path);
+        LOG_trace1 << "using cfg:\n" << print (cfg);
+        check_condition (cfg.is_object (), cfg.type ());
+
+        m_rnd = config.rng_seed ();
+        check_nonzero (m_rnd);
+
+        m_latency = cfg.value ("latency", 50 * _1_microsecond ());
+        m_latency_range = cfg.value ("latency_range", timestamp_t { });
+        m_response_latency = cfg.value ("response_latency", m_latency);
+        m_quantum = cfg.value ("quantum", timestamp_t { });
+        m_batch_limit = cfg.value ("batch_limit", 64);
+        m_packet_limit = cfg.value ("packet_limit", std::numeric_limits<int64_t>::max ());
+
+        check_nonnegative (m_latency);
+        check_nonnegative (m_latency_range);
+        check_nonnegative (m_response_latency);
+        check_nonnegative (m_quantum);
+        check_positive (m_batch_limit);
+
+        LOG_info << "request latency " << m_latency << " (range " << m_latency_range << "), response latency " << m_response_latency
+                 << ", quantum " << m_quantum << ", batch limit " << m_batch_limit;
+
+        // (same layout as used by 'mock_ouch_server' in "matching" mode):
+
+        fs::path const data_root = cfg.at ("cap_root").get<std::string> ();
+        fs::path const in_file = data_root / "ASX" / gd::to_iso_string (config.start_date ()) / "asx-02" / "mcast.recv.p1p2.pcap.zst";
+
+        LOG_info << "replaying " << print (in_file);
+
+        m_in = stream_factory::open_input (in_file);
+        pcap_defs::read_header (* m_in);
+
+        // agent/liid configuration (as 'execution_link' would do it):
+        {
+            agent_cfg const & agents = (* m_parent.m_agents);
+            ref_data const & ref = (* m_parent.m_ref_data);
+
+            m_liid_limit = agents.liid_limit ();
+            m_liid_map = std::make_unique<liid_map_entry []> (m_liid_limit);
+
+            for (auto const & a : agents.agents ())
+            {
+                bitset32_t & a_pix_mask = m_agent_partitions [a.first];
+
+                for (auto const & sl : a.second.m_symbol_mapping.left)
+                {
+                    instrument const & i = ref [sl.first]; // throws on lookup failure
+
+                    liid_map_entry & lme = m_liid_map [sl.second];
+                    {
+                        field<_iid_> (lme) = i.iid ();
+                        field<_partition_> (lme) = i.partition ();
+                    }
+
+                    a_pix_mask |= (1 << field<_partition_> (lme));
+                }
+
+                m_active_partitions |= a_pix_mask;
+            }
+            check_nonempty (m_agent_partitions);
+            check_nonzero (m_active_partitions);
+
+            m_request_queues = std::make_unique<ifc_request_queue []> (m_agent_partitions.size ());
+        }
+
+    }
+
+    VR_ASSUME_COLD void stop ()
+    {
+        replay_stats const s = stats ();
+        timestamp_t const elapsed = std::max<timestamp_t> (1, s.m_replay_time);
+
+        LOG_info << "replayed " << s << " in " << (elapsed / _1_millisecond ()) << " ms: " << (s.m_messages * 1.0e9 / elapsed) << " msg(s)/s";
+        LOG_info << m_engine.live_order_count () << " order(s) live at stop time";
+    }
+
+    replay_stats stats () const
+    {
+        replay_stats r { m_stats };
+
+        r.m_messages = m_visitor.m_message_count;
+        if (m_wall_start > 0)
+            r.m_replay_time = (m_wall_end > 0 ? m_wall_end : sys::realtime_utc ()) - m_wall_start;
+
+        return r;
+    }
+
+    VR_FORCEINLINE execution_link::ifc connect (call_traits<agent_ID>::param aid)
+    {
+        assert_nonnull (m_request_queues);
+
+        auto const i = m_agent_partitions.find (aid);
+        if (VR_UNLIKELY (i == m_agent_partitions.end ()))
+            throw_x (invalid_input, "invalid agent ID " + print (aid));
+
+        int32_t const ifc_index = m_agent_connect_count ++;
+        if (VR_UNLIKELY (ifc_index >= signed_cast (m_agent_partitions.size ())))
+            throw_x (out_of_bounds, "too many connect attempts");
+
+        LOG_trace1 << "agent " << print (aid) << " connected @ ifc index " << ifc_index;
+
+        return { i->second, static_cast<uint32_t> (0xA + ifc_index), m_request_queues [ifc_index] };
+    }
+
+    // core step logic:
+
+    /*
+     * @return 'true' iff anything was published
+     */
+    VR_FORCEINLINE bool step () // note: force-inlined
+    {
+        // by RCU reader contract, everything published in the previous step has been
+        // consumed by now and the staging buffers can be reused:
+
+        m_md_size = 0;
+        m_xl_size.fill (0);
+
+        drain_request_queues ();
+
+        if (VR_LIKELY (m_replaying))
+        {
+            if (VR_LIKELY (! m_src_eof))
+                replay ();
+            else // drain whatever is still in flight:
+            {
+                timestamp_t const ts_next = std::min (m_requests.empty () ? std::numeric_limits<timestamp_t>::max () : m_requests.front ().m_ts_due,
+                                                      m_responses.empty () ? std::numeric_limits<timestamp_t>::max () : m_responses.front ().m_ts_due);
+
+                if (ts_next == std::numeric_limits<timestamp_t>::max ())
+                {
+                    if (! m_stop_requested)
+                    {
+                        m_wall_end = sys::realtime_utc ();
+                        LOG_info << "end of replay @ " << print_timestamp (m_now);
+
+                        m_stop_requested = true;
+                        m_parent.request_stop ();
+                    }
+                }
+                else
+                {
+                    m_now = std::max (m_now, ts_next);
+                    apply_requests (m_now);
+                }
+            }
+        }
+
+        deliver_responses (m_now);
+
+        return publish ();
+    }
+
+
+    struct pending_request final
+    {
+        timestamp_t m_ts_due;
+        xl_request m_request;
+
+    }; // end of nested class
+
+    struct pending_response final
+    {
+        timestamp_t m_ts_due;
+        int32_t m_pix;
+        int32_t m_len;
+        std::array<int8_t, soup_hdr_len () + max_response_size ()> m_data;
+
+    }; // end of nested class
+
+    using ifc_request_queue     = execution_link::ifc::request_queue;
+
+    using agent_partition_map   = boost::unordered_map<agent_ID, bitset32_t>; // not perf-critical
+
+
+    void drain_request_queues ()
+    {
+        for (int32_t ifc_index = 0; ifc_index < m_agent_connect_count; ++ ifc_index)
+        {
+            while (true)
+            {
+                auto const e = m_request_queues [ifc_index].try_dequeue ();
+                if (! e) break;
+
+                xl_request const & req = xl_request_cast (e);
+                DLOG_trace1 << "[ifc " << ifc_index << ", " << print_timestamp (m_now) << "] xl_request: " << print (req);
+
+                if (VR_LIKELY (field<_type_> (req) != xl_req::start_login))
+                {
+                    timestamp_t ts_due = m_now + m_latency;
+                    if (m_latency_range > 2) ts_due = m_now + runif_nonnegative (m_latency, m_latency_range, m_rnd);
+
+                    ts_due = m_ts_request_last = std::max (ts_due, m_ts_request_last); // FIFO
+
+                    m_requests.push_back ({ ts_due, req });
+                }
+                else if (++ m_agent_login_count == signed_cast (m_agent_partitions.size ())) // all configured agents have logged in
+                {
+                    emit_login ();
+                    m_replaying = true;
+                    m_wall_start = sys::realtime_utc ();
+
+                    LOG_info << "all " << m_agent_login_count << " agent(s) logged in, starting replay";
+                }
+            }
+        }
+    }
+
+    /*
+     * replay a batch of packets, letting in requests that arrive at the exchange ahead
+     * of each packet
+     */
+    void replay ()
+    {
+        timestamp_t ts_limit { std::numeric_limits<timestamp_t>::max () };
+
+        for (int32_t k = 0; k < m_batch_limit; )
+        {
+            if (VR_UNLIKELY (m_available < min_available ())) // ensure we can read up to the included length field
+            {
+                if (! read ()) break;
+                continue;
+            }
+
+            addr_const_t const r = m_buf.r_position (); // invariant: points at the start of a capture header
+
+            pcap_defs::pcap_hdr_type const & pcap_hdr = * reinterpret_cast<pcap_defs::pcap_hdr_type const *> (r);
+
+            size_type const pcap_incl_len = pcap_hdr.incl_len ();
+            size_type const pcap_size = min_available () + pcap_incl_len;
+
+            if (VR_UNLIKELY (m_available < pcap_size))
+            {
+                if (! read ()) break;
+                continue; // 'm_buf' could have been remapped
+            }
+
+            timestamp_t const ts_capture = pcap_hdr.get_timestamp ();
+
+            if (k == 0)
+                ts_limit = ts_capture + m_quantum;
+            else if (ts_capture > ts_limit)
+                break; // leave for the next step
+
+            apply_requests (ts_capture);
+            m_now = std::max (m_now, ts_capture);
+
+            // update the engine's view of the market (this can execute resting client orders):
+
+            addr_const_t const packet = addr_plus (r, min_available ());
+
+            field<_ts_local_> (m_ctx) = ts_capture;
+            int32_t const rc = m_visitor.consume (m_ctx, packet, pcap_incl_len);
+
+            dispatch_market_reports ();
+
+            // stage the same packet for the agent(s):
+
+            if (VR_LIKELY (rc > 0))
+            {
+                if (VR_UNLIKELY (signed_cast (m_md_buf.size ()) < m_md_size + rc)) m_md_buf.resize (2 * (m_md_size + rc));
+
+                __builtin_memcpy (& m_md_buf [m_md_size], packet, rc);
+                m_md_size += rc;
+            }
+
+            m_available -= pcap_size;
+            m_buf.r_advance (pcap_size); // consumed
+
+            ++ k;
+
+            if (VR_UNLIKELY (++ m_stats.m_packets >= m_packet_limit))
+            {
+                LOG_info << "reached packet limit " << m_packet_limit;
+                m_src_eof = true;
+                break;
+            }
+        }
+    }
+
+    /*
+     * @return 'false' on EOF
+     */
+    bool read ()
+    {
+        size_type const r_count = read_fully (* m_in, m_buf.w_window (), m_buf.w_position ());
+
+        if (VR_LIKELY (r_count > 0))
+        {
+            m_buf.w_advance (r_count);
+            m_available += r_count;
+
+            return true;
+        }
+
+        LOG_info << "reached end of market data after " << m_stats.m_packets << " packet(s)";
+        m_src_eof = true;
+
+        return false;
+    }
+
+    // exchange side:
+
+    /*
+     * let in all requests that are due by 'ts'
+     */
+    void apply_requests (timestamp_t const ts)
+    {
+        while (! m_requests.empty () && (m_requests.front ().m_ts_due <= ts))
+        {
+            pending_request const & pr = m_requests.front ();
+            xl_request const & req = pr.m_request;
+
+            timestamp_t const ts_exch = pr.m_ts_due;
+
+            switch (field<_type_> (req))
+            {
+                case xl_req::submit_order:  apply_submit  (ts_exch, req); break;
+                case xl_req::replace_order: apply_replace (ts_exch, req); break;
+                default:                    apply_cancel  (ts_exch, req); break;
+
+            } // end of switch
+
+            ++ m_stats.m_requests;
+            m_requests.pop_front ();
+        }
+    }
+
+    void apply_submit (timestamp_t const ts_exch, xl_request const & req)
+    {
+        liid_map_entry const & lme = lookup (field<_liid_> (req));
+
+        m_orders.submit (* this, field<_partition_> (lme), ts_exch, ++ m_ref_counter, field<_otk_> (req),
+                         field<_iid_> (lme), field<_side_> (req), field<_price_> (req), field<_qty_> (req), field<_TIF_> (req));
+    }
+
+    void apply_replace (timestamp_t const ts_exch, xl_request const & req)
+    {
+        liid_map_entry const & lme = lookup (field<_liid_> (req));
+
+        m_orders.replace (* this, field<_partition_> (lme), ts_exch, ++ m_ref_counter, field<_otk_> (req), field<_new_otk_> (req),
+                          field<_price_> (req), field<_qty_> (req));
+    }
+
+    void apply_cancel (timestamp_t const ts_exch, xl_request const & req)
+    {
+        liid_map_entry const & lme = lookup (field<_liid_> (req));
+
+        m_orders.cancel (* this, field<_partition_> (lme), ts_exch, field<_otk_> (req));
+    }
+
+    /*
+     * executions/cancels of resting client orders caused by the packet just replayed
+     */
+    VR_FORCEINLINE void dispatch_market_reports ()
+    {
+        std::vector<report> & reports = m_engine.reports ();
+
+        if (VR_LIKELY (reports.empty ())) return;
+
+        timestamp_t ts = m_now;
+        for (report const & r : reports)
+        {
+            m_orders.on_market_report (* this, ts ++, r);
+        }
+        reports.clear ();
+    }
+
+    // mock_ouch_orders sink:
+
+    template<typename RESPONSE, typename FILL>
+    void respond (int32_t const pix, timestamp_t const ts_exch, FILL && fill)
+    {
+        fill (enqueue_frame<RESPONSE> ('S', pix, ts_exch + m_response_latency));
+
+        if (std::is_same<RESPONSE, ouch::order_execution>::value) ++ m_stats.m_executions;
+    }
+
+    VR_ASSUME_COLD void emit_login ()
+    {
+        bitset32_t pix_mask { m_active_partitions };
+        while (pix_mask > 0)
+        {
+            int32_t const pix_bit = (pix_mask & - pix_mask);
+            int32_t const pix = int_ops::log2_floor (pix_bit);
+            pix_mask ^= pix_bit;
+
+            SoupTCP_login_accepted & msg = enqueue_frame<SoupTCP_login_accepted> ('A', pix, m_now);
+            {
+                copy_to_alphanum (join_as_name<'_'> ("BT", pix), msg.session ()); // right-padded with spaces
+                util::rjust_print_decimal_nonnegative (1, msg.seqnum ().data (), msg.seqnum ().max_size ()); // right-padded with spaces
+            }
+        }
+    }
+
+    /*
+     * @return blank-filled payload of a new Soup frame of 'type' (due at no earlier than 'ts_due')
+     */
+    template<typename MSG>
+    MSG & enqueue_frame (char const type, int32_t const pix, timestamp_t const ts_due)
+    {
+        vr_static_assert (sizeof (MSG) <= max_response_size ());
+
+        constexpr int32_t len = soup_hdr_len () + sizeof (MSG);
+
+        m_responses.emplace_back ();
+        pending_response & pr = m_responses.back ();
+        {
+            pr.m_ts_due = m_ts_response_last = std::max (ts_due, m_ts_response_last); // FIFO
+            pr.m_pix = pix;
+            pr.m_len = len;
+
+            __builtin_memset (pr.m_data.data (), ' ', len);
+        }
+
+        SoupTCP_packet_hdr & hdr = * reinterpret_cast<SoupTCP_packet_hdr *> (pr.m_data.data ());
+        {
+            hdr.length () = 1 + sizeof (MSG);
+            hdr.type () = type;
+        }
+
+        return (* reinterpret_cast<MSG *> (addr_plus (pr.m_data.data (), soup_hdr_len ())));
+    }
+
+    /*
+     * stage all responses that have reached the agent(s) by 'ts'
+     */
+    VR_FORCEINLINE void deliver_responses (timestamp_t const ts)
+    {
+        while (! m_responses.empty () && (m_responses.front ().m_ts_due <= ts))
+        {
+            pending_response const & pr = m_responses.front ();
+
+            std::vector<int8_t> & buf = m_xl_buf [pr.m_pix];
+            int32_t & size = m_xl_size [pr.m_pix];
+
+            if (VR_UNLIKELY (signed_cast (buf.size ()) < size + pr.m_len)) buf.resize (2 * (size + pr.m_len));
+
+            __builtin_memcpy (& buf [size], pr.m_data.data (), pr.m_len);
+            size += pr.m_len;
+
+            ++ m_stats.m_responses;
+            m_responses.pop_front ();
+        }
+    }
+
+    /*
+     * @return 'true' iff anything was published
+     */
+    VR_FORCEINLINE bool publish ()
+    {
+        bool published { false };
+
+        if (m_md_size > 0)
+        {
+            recv_position & p = m_md_pd [0];
+
+            p.m_pos += m_md_size;
+            p.m_end = addr_plus (m_md_buf.data (), m_md_size);
+            p.m_ts_local = m_now;
+
+            published = true;
+        }
+
+        for (int32_t pix = 0; pix < part_count (); ++ pix)
+        {
+            int32_t const size = m_xl_size [pix];
+
+            if (size > 0)
+            {
+                recv_position & p = m_xl_pd [pix];
+
+                p.m_pos += size;
+                p.m_end = addr_plus (m_xl_buf [pix].data (), size);
+                p.m_ts_local = p.m_ts_sent = m_now;
+
+                published = true;
+            }
+        }
+
+        return published;
+    }
+
+
+    VR_FORCEINLINE liid_map_entry const & lookup (liid_t const liid) const
+    {
+        assert_within (liid, m_liid_limit);
+
+        return m_liid_map [liid];
+    }
+
+    backtester & m_parent;
+    scope_path const m_cfg_path;
+    // replay:
+    std::unique_ptr<std::istream> m_in { };     // set in 'start()'
+    engine_type m_engine { };
+    visitor m_visitor { { { "engine", & m_engine } } };
+    visit_ctx m_ctx { };
+    mapped_ring_buffer m_buf { 256 * 1024 };
+    size_type m_available { };
+    timestamp_t m_now { };
+    timestamp_t m_quantum { };
+    int64_t m_packet_limit { };
+    int32_t m_batch_limit { };
+    bool m_replaying { false };                 // set once all agents have logged in
+    bool m_src_eof { false };
+    bool m_stop_requested { false };
+    // latency model:
+    std::deque<pending_request> m_requests { };
+    std::deque<pending_response> m_responses { };
+    timestamp_t m_latency { };
+    timestamp_t m_latency_range { };
+    timestamp_t m_response_latency { };
+    timestamp_t m_ts_request_last { };
+    timestamp_t m_ts_response_last { };
+    uint64_t m_rnd { };
+    // published to the agent(s):
+    md_poll_descriptor m_md_pd;
+    xl_poll_descriptor m_xl_pd;
+    std::vector<int8_t> m_md_buf { std::vector<int8_t> (64 * 1024) };
+    std::array<std::vector<int8_t>, part_count ()> m_xl_buf { };
+    std::array<int32_t, part_count ()> m_xl_size { };
+    int32_t m_md_size { };
+    // agents and orders:
+    std::unique_ptr<ifc_request_queue []> m_request_queues { };     // set in 'start()'
+    std::unique_ptr<liid_map_entry [/* liid */]> m_liid_map { };    // set in 'start()'
+    agent_partition_map m_agent_partitions { };                     // set in 'start()'
+    bitset32_t m_active_partitions { };
+    int32_t m_liid_limit { };
+    int32_t m_agent_connect_count { };
+    int32_t m_agent_login_count { };
+    mock_ouch_orders<engine_type> m_orders { m_engine };
+    order_ref m_ref_counter { };
+    replay_stats m_stats { };
+    timestamp_t m_wall_start { };   // set when replay starts
+    timestamp_t m_wall_end { };     // set when replay ends
+
+}; // end of class
+//............................................................................
+//............................................................................
+
+backtester::backtester (scope_path const & cfg_path) :
+    m_impl { std::make_unique<pimpl> (* this, cfg_path) }
+{
+    dep (m_config) = "config";
+    dep (m_agents) = "agents";
+    dep (m_ref_data) = "ref_data";
+}
+
+backtester::~backtester ()    = default; // pimpl
+//............................................................................
+
+timestamp_t const &
+backtester::now () const
+{
+    return m_impl->m_now;
+}
+
+backtester::replay_stats
+backtester::stats () const
+{
+    return m_impl->stats ();
+}
+//............................................................................
+
+backtester::md_poll_descriptor *
+backtester::md_descriptor ()
+{
+    return (& m_impl->m_md_pd);
+}
+
+backtester::xl_poll_descriptor *
+backtester::xl_descriptor ()
+{
+    return (& m_impl->m_xl_pd);
+}
+
+execution_link::ifc
+backtester::connect (call_traits<agent_ID>::param aid)
+{
+    return m_impl->connect (aid);
+}
+//............................................................................
+
+void
+backtester::start ()
+{
+    m_impl->start ();
+}
+
+void
+backtester::stop ()
+{
+    m_impl->stop ();
+}
+//............................................................................
+
+void
+backtester::step ()
+{
+    if (! m_impl->step ()) // force-inlined
+        report_idle ();
+}
+//............................................................................
+
+std::ostream &
+operator<< (std::ostream & os, backtester::replay_stats const & obj) VR_NOEXCEPT
+{
+    return os << "{packets: " << obj.m_packets << ", messages: " << obj.m_messages << ", requests: " << obj.m_requests
+              << ", responses: " << obj.m_responses << ", executions: " << obj.m_executions << '}';
+}
+
+} // end of 'ASX'
+} // end of 'market'
+} // end of namespace
+//----------------------------------------------------------------------------
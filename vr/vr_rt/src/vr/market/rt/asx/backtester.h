@@ -0,0 +1,119 @@
+#pragma once
+
+#include "vr/market/defs.h" // agent_ID
+#include "vr/market/ref/asx/ref_data_fwd.h"
+#include "vr/market/rt/asx/execution_link.h"
+#include "vr/market/rt/cfg/agent_cfg_fwd.h"
+#include "vr/market/rt/market_data_feed.h"
+#include "vr/mc/steppable.h"
+#include "vr/rt/cfg/app_cfg_fwd.h"
+#include "vr/settings_fwd.h"
+#include "vr/startable.h"
+#include "vr/util/di/component.h"
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace market
+{
+namespace ASX
+{
+/**
+ * a simulated-time market for running (unmodified) agents against a day of
+ * captured ITCH:
+ *
+ *  - a 'market_data_feed' and an 'execution_link' constructed with this component's
+ *    name as their "backtester" arg stop doing any I/O and instead publish poll
+ *    descriptors owned by this component;
+ *  - market data is replayed as fast as the agent(s) consume it, with the simulated clock
+ *    (@ref now()) following capture timestamps; a step publishes a batch of packets
+ *    spanning at most "quantum" of capture time (and at most "batch_limit" packets);
+ *  - agent requests reach the exchange "latency" (+/- "latency_range" / 2) after the
+ *    step in which they were made and responses reach the agent(s) "response_latency"
+ *    after the exchange event, both in FIFO order (as over a TCP session);
+ *  - order outcomes (incl. passive fills) are decided by a @ref mock_matching_engine
+ *    that tracks queue positions on the replayed books, and are delivered as Soup-framed
+ *    OUCH, exactly as 'execution_link' would
+ *
+ * because agents see market data only in this component's steps, it must be stepped
+ * in the same PU group as (and hence ahead of) the agent(s) it drives; replay
+ * starts once all agents have logged in and the component requests a stop once
+ * the capture is exhausted and no requests/responses are in flight
+ *
+ * @note the ITCH books are built twice (once for the engine, once by each agent)
+ */
+class backtester final: public mc::steppable, public util::di::component, public startable
+{
+    public: // ...............................................................
+
+        using md_poll_descriptor    = market_data_feed::poll_descriptor;
+        using xl_poll_descriptor    = execution_link::poll_descriptor;
+
+        struct replay_stats final
+        {
+            int64_t m_packets { };
+            int64_t m_messages { };     // ITCH messages (as counted by Mold frames)
+            int64_t m_requests { };     // agent requests that have reached the exchange
+            int64_t m_responses { };    // OUCH messages delivered to the agent(s)
+            int64_t m_executions { };
+            timestamp_t m_replay_time { };  // wall time since all agents logged in (until end of replay, if reached)
+
+            friend VR_ASSUME_COLD std::ostream & operator<< (std::ostream & os, replay_stats const & obj) VR_NOEXCEPT;
+
+        }; // end of nested class
+
+
+        VR_ASSUME_COLD backtester (scope_path const & cfg_path);
+        ~backtester ();
+
+
+        // ACCESSORs:
+
+        /**
+         * @return current simulated time (capture time of the latest replayed packet)
+         */
+        timestamp_t const & now () const;
+
+        /**
+         * @return a snapshot of replay stats so far
+         */
+        replay_stats stats () const;
+
+        // MUTATORs:
+
+        // [used by 'market_data_feed' and 'execution_link' in backtest mode]
+
+        VR_ASSUME_COLD md_poll_descriptor * md_descriptor ();
+        VR_ASSUME_COLD xl_poll_descriptor * xl_descriptor ();
+
+        /**
+         * @see execution_link::connect()
+         */
+        VR_ASSUME_COLD execution_link::ifc connect (call_traits<agent_ID>::param aid);
+
+    private: // ..............................................................
+
+        class pimpl; // forward
+
+        // startable:
+
+        VR_ASSUME_COLD void start () override;
+        VR_ASSUME_COLD void stop () override;
+
+        // steppable:
+
+        VR_ASSUME_HOT void step () final override;
+
+
+        rt::app_cfg const * m_config { };   // [dep]
+        agent_cfg const * m_agents { };     // [dep]
+        ref_data const * m_ref_data { };    // [dep]
+
+        std::unique_ptr<pimpl> const m_impl;
+
+}; // end of class
+
+} // end of 'ASX'
+} // end of 'market'
+} // end of namespace
+//----------------------------------------------------------------------------
@@ -0,0 +1,181 @@
+#include "vr/macros.h" // VR_RELEASE
+#if VR_RELEASE // perf testcases in release builds only
+
+#include "vr/market/rt/asx/backtester.h"
+
+#include "vr/io/dao/object_DAO.h"
+#include "vr/io/sql/sql_connection_factory.h"
+#include "vr/market/ref/asx/ref_data.h"
+#include "vr/market/rt/agents/asx/agent.h"
+#include "vr/market/rt/cfg/agent_cfg.h"
+#include "vr/mc/thread_pool.h"
+#include "vr/rt/cfg/app_cfg.h"
+#include "vr/rt/cfg/resources.h"
+#include "vr/settings.h"
+#include "vr/util/di/container.h"
+#include "vr/util/env.h"
+
+#include "vr/test/files.h"
+#include "vr/test/utility.h"
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace market
+{
+namespace ASX
+{
+//............................................................................
+//............................................................................
+namespace test_
+{
+/*
+ * only keeps its books current, never trades
+ */
+class idle_agent final: public agent<idle_agent>
+{
+    private: // ..............................................................
+
+        using super         = agent<idle_agent>;
+
+    public: // ...............................................................
+
+        idle_agent (scope_path const & cfg_path) :
+            super (cfg_path)
+        {
+        }
+
+        // agent:
+
+        void evaluate ()
+        {
+            ++ m_evaluate_count;
+        }
+
+
+        int64_t m_evaluate_count { };
+
+}; // end of class
+
+} // end of 'test_'
+//............................................................................
+//............................................................................
+/*
+ * replay of a full day of captured market data through the matching engine and
+ * a (passive) agent's books
+ */
+TEST (perf_backtester, replay_throughput)
+{
+    using namespace test_;
+
+    constexpr double rate_min       = 10.0e6; // ITCH messages/s
+
+    fs::path const test_input = test::find_capture (source::ASX, "<"_rop, util::current_date_in ("Australia/Sydney"));
+    LOG_info << "using test data in " << print (test_input);
+
+    util::date_t const date = util::extract_date (test_input.native ());
+
+    settings cfg
+    {
+        { "app_cfg", {
+            { "time", util::format_time (util::ptime_t { date, pt::seconds (0) }, "%Y-%b-%d %H:%M:%S") }
+        }}
+        ,
+        { "agents", {
+            { "TEST", {
+                "/strategies/A_STRATEGY", {
+                    { "instruments", { "BHP" } }
+                }
+            }}
+        }}
+        ,
+        { "sql", {
+            { "sql.ro", {
+                { "mode",   "ro" },
+                { "cache",  "shared" },
+                { "pool_size",  2 },
+                { "on_open", {
+                    "PRAGMA read_uncommitted=true;"
+                }},
+                { "db", rt::resolve_as_uri ("asx/ref.equity.db").native () }
+            }}
+        }}
+        ,
+        { "backtester", {
+            { "latency",        20 * _1_microsecond () },
+            { "batch_limit",    1024 },
+            { "cap_root", util::getenv<fs::path> ("VR_CAP_ROOT", "").native () } // TODO
+        }}
+        ,
+        { "thread_pool", {
+            { "rcu", {
+                { "use_RT_callback", true },
+                { "callback_PU", -1 },
+            }}
+        }}
+        ,
+        { "market_data_feed", { { "mode", "backtest" } } },
+        { "execution_link", { { "mode", "backtest" } } }
+        ,
+        { "strategies", {
+            { "A_STRATEGY", {
+                { "class", { /* ...not used yet... */ } },
+            }}
+        }}
+    };
+
+    int32_t const PU_default    = 0;
+    int32_t const PU_test       = 1;
+
+    util::di::container app { join_as_name ("APP", test::current_test_name ()),
+        {
+            { "default",        PU_default },
+
+            { "mdf",            "default" },
+            { "xl",             "default" },
+            { "bt",             PU_test },
+            { "test",           "bt" }, // must be stepped together with "bt"
+        }
+    };
+
+    app.configure ()
+        ("config",      new rt::app_cfg { cfg })
+        ("ref_data",    new ref_data { { } })
+        ("DAO",         new io::object_DAO { { { "cfg.ro", "sql.ro" } } })
+        ("sql",         new io::sql_connection_factory { { { "sql.ro", cfg ["sql"]["sql.ro"] } } })
+
+        ("threads",     new mc::thread_pool   { "/thread_pool" })
+        ("agents",      new agent_cfg         { "/agents" })
+        ("bt",          new backtester        { "/backtester" })
+        ("mdf",         new market_data_feed  { "/market_data_feed", "bt" })
+        ("xl",          new execution_link    { "/execution_link", { }, "bt" })
+
+        ("test",        new idle_agent        { "/agents/TEST" })
+    ;
+
+    app.start ();
+    {
+        app.run_for (600 * _1_second ()); // will terminate sooner when "bt" reaches end of replay
+    }
+    app.stop ();
+
+    backtester const & bt = app ["bt"];
+    backtester::replay_stats const s = bt.stats ();
+
+    ASSERT_GT (s.m_messages, 0);
+    ASSERT_GT (s.m_replay_time, 0);
+
+    double const rate = s.m_messages * 1.0e9 / s.m_replay_time;
+
+    idle_agent const & a = app ["test"];
+    LOG_info << "replayed " << s << " in " << (s.m_replay_time / _1_millisecond ()) << " ms (" << a.m_evaluate_count << " agent evaluation(s)): " << rate << " msg(s)/s";
+
+    EXPECT_GE (rate, rate_min);
+}
+
+} // end of 'ASX'
+} // end of 'market'
+} // end of namespace
+//----------------------------------------------------------------------------
+
+#endif // VR_RELEASE
@@ -0,0 +1,237 @@
+
+#include "vr/market/rt/asx/backtester.h"
+
+#include "vr/io/dao/object_DAO.h"
+#include "vr/io/sql/sql_connection_factory.h"
+#include "vr/market/ref/asx/ref_data.h"
+#include "vr/market/rt/agents/asx/agent.h"
+#include "vr/market/rt/cfg/agent_cfg.h"
+#include "vr/mc/thread_pool.h"
+#include "vr/rt/cfg/app_cfg.h"
+#include "vr/rt/cfg/resources.h"
+#include "vr/settings.h"
+#include "vr/util/di/container.h"
+#include "vr/util/env.h"
+
+#include "vr/test/files.h"
+#include "vr/test/utility.h"
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace market
+{
+namespace ASX
+{
+//............................................................................
+//............................................................................
+namespace test_
+{
+/*
+ * waits for some market data to go by, then sends an aggressive IOC and waits
+ * for it to be done
+ */
+class IOC_agent final: public agent<IOC_agent>
+{
+    private: // ..............................................................
+
+        using super         = agent<IOC_agent>;
+
+    public: // ...............................................................
+
+        IOC_agent (scope_path const & cfg_path) :
+            super (cfg_path)
+        {
+        }
+
+        // agent:
+
+        void evaluate ()
+        {
+            switch (m_step)
+            {
+                case 0:
+                {
+                    if (++ m_evaluate_count < m_wait_count) break;
+
+                    order_type const & o = submit_IOC_order (m_liid, side::BID, 1000 * 1000000, 1); // 1000.000: marketable if anything is offered
+                    LOG_info << "order " << print (o.otk ()) << " submitted";
+
+                    m_order = & o;
+                    ++ m_step;
+                }
+                break;
+
+                case 1:
+                {
+                    assert_nonnull (m_order);
+                    order_type const & o = (* m_order);
+
+                    if (o.fsm ().order_state () == order_type::fsm_state::order::done)
+                    {
+                        LOG_info << "order " << print (o.otk ()) << " is done, filled qty " << o.qty_filled ();
+                        LOG_trace2 << "  " << print (o);
+
+                        check_zero (o.fsm ().pending_state ());
+                        check_le (o.qty_filled (), 1);
+
+                        m_success = true;
+                        ++ m_step;
+                    }
+                }
+                break;
+
+            } // end of switch
+        }
+
+        // startable:
+
+        void start () override
+        {
+            super::start (); // [chain]
+
+            m_wait_count = parameters ().value ("wait_count", 1000);
+            m_liid = liids ().front ();
+        }
+
+
+        bool success () const
+        {
+            return m_success;
+        }
+
+        int32_t const & scenario_step () const
+        {
+            return m_step;
+        }
+
+    private: // ..............................................................
+
+        liid_t m_liid { -1 };
+        int32_t m_wait_count { };
+        int32_t m_evaluate_count { };
+        order_type const * m_order { };
+        int32_t m_step { };
+        bool m_success { false };
+
+}; // end of class
+
+} // end of 'test_'
+//............................................................................
+//............................................................................
+
+TEST (backtester, IOC_round_trip)
+{
+    using namespace test_;
+
+    // HACK find a date for which capture exists and set it as session date:
+
+    fs::path const test_input = test::find_capture (source::ASX, "<"_rop, util::current_date_in ("Australia/Sydney"));
+    LOG_info << "using test data in " << print (test_input);
+
+    util::date_t const date = util::extract_date (test_input.native ());
+
+    int64_t const packet_limit = 1000000;
+
+    settings cfg
+    {
+        { "app_cfg", {
+            { "time", util::format_time (util::ptime_t { date, pt::seconds (0) }, "%Y-%b-%d %H:%M:%S") }
+        }}
+        ,
+        { "agents", {
+            { "TEST", {
+                "/strategies/A_STRATEGY", {
+                    { "instruments", { "BHP" } },
+                    { "wait_count", 1000 }
+                }
+            }}
+        }}
+        ,
+        { "sql", {
+            { "sql.ro", {
+                { "mode",   "ro" },
+                { "cache",  "shared" },
+                { "pool_size",  2 },
+                { "on_open", {
+                    "PRAGMA read_uncommitted=true;"
+                }},
+                { "db", rt::resolve_as_uri ("asx/ref.equity.db").native () }
+            }}
+        }}
+        ,
+        { "backtester", {
+            { "packet_limit",   packet_limit },
+            { "latency",        20 * _1_microsecond () },
+            { "latency_range",  10 * _1_microsecond () },
+            { "quantum",        _1_millisecond () },
+            { "cap_root", util::getenv<fs::path> ("VR_CAP_ROOT", "").native () } // TODO
+        }}
+        ,
+        { "thread_pool", {
+            { "rcu", {
+                { "use_RT_callback", true },
+                { "callback_PU", -1 },
+            }}
+        }}
+        ,
+        { "market_data_feed", { { "mode", "backtest" } } }, // not used in backtest mode except as a scope
+        { "execution_link", { { "mode", "backtest" } } }
+        ,
+        { "strategies", {
+            { "A_STRATEGY", {
+                { "class", { /* ...not used yet... */ } },
+            }}
+        }}
+    };
+
+    int32_t const PU_default    = 0;
+    int32_t const PU_test       = 1;
+
+    util::di::container app { join_as_name ("APP", test::current_test_name ()),
+        {
+            { "default",        PU_default },
+
+            { "mdf",            "default" },
+            { "xl",             "default" },
+            { "bt",             PU_test },
+            { "test",           "bt" }, // must be stepped together with "bt"
+        }
+    };
+
+    app.configure ()
+        ("config",      new rt::app_cfg { cfg })
+        ("ref_data",    new ref_data { { } })
+        ("DAO",         new io::object_DAO { { { "cfg.ro", "sql.ro" } } })
+        ("sql",         new io::sql_connection_factory { { { "sql.ro", cfg ["sql"]["sql.ro"] } } })
+
+        ("threads",     new mc::thread_pool   { "/thread_pool" })
+        ("agents",      new agent_cfg         { "/agents" })
+        ("bt",          new backtester        { "/backtester" })
+        ("mdf",         new market_data_feed  { "/market_data_feed", "bt" })
+        ("xl",          new execution_link    { "/execution_link", { }, "bt" })
+
+        ("test",        new IOC_agent         { "/agents/TEST" })
+    ;
+
+    app.start ();
+    {
+        app.run_for (60 * _1_second ()); // will terminate sooner when "bt" runs out of packets
+    }
+    app.stop ();
+
+    backtester const & bt = app ["bt"];
+    LOG_info << "replay stats: " << bt.stats ();
+
+    IOC_agent const & a = app ["test"];
+    EXPECT_TRUE (a.success ()) << "\tlast scenario step reached: " << a.scenario_step ();
+
+    EXPECT_LE (bt.stats ().m_packets, packet_limit);
+    EXPECT_GE (bt.stats ().m_requests, 1);
+    EXPECT_GE (bt.stats ().m_responses, 2); // at least a login and an 'order_accepted'
+}
+
+} // end of 'ASX'
+} // end of 'market'
+} // end of namespace
+//----------------------------------------------------------------------------
@@ -0,0 +1,78 @@
+
+#include "vr/market/rt/asx/book_builder.h"
+
+#include "vr/market/ref/asx/ref_data.h"
+#include "vr/market/rt/cfg/agent_cfg.h"
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace market
+{
+namespace ASX
+{
+//............................................................................
+
+book_builder::book_builder ()
+{
+    dep (m_mdf) = "mdf";
+    dep (m_agents) = "agents";
+    dep (m_ref_data) = "ref_data";
+}
+
+book_builder::~book_builder ()
+{
+    LOG_info << "published " << m_publish_count << " book update(s)";
+}
+//............................................................................
+
+book_builder::shared_books_type const &
+book_builder::books () const
+{
+    assert_nonnull (m_build_ctx);
+
+    return m_build_ctx->m_books;
+}
+//............................................................................
+
+void
+book_builder::start ()
+{
+    check_nonnull (m_mdf);
+
+    m_mdf->add_waiter (* this); // un-park our runnable (if it backs off) as soon as there is new data
+
+    m_build_ctx = std::make_unique<impl::md::build_context>
+    (
+        arg_map
+        {
+            { "agents",     std::cref (* m_agents) },
+            { "ref_data",   std::cref (* m_ref_data) },
+            { "mdf",        std::cref (* m_mdf) }
+        }
+    );
+
+    LOG_info << "building " << m_build_ctx->m_books.size () << " shared book(s)";
+}
+
+void
+book_builder::stop ()
+{
+}
+//............................................................................
+
+void
+book_builder::step ()
+{
+    assert_nonnull (m_build_ctx);
+
+    if (impl::md::poll_feed (* m_mdf, m_md_ctx, m_build_ctx->m_visitor))
+        m_publish_count += m_build_ctx->m_books.publish ();
+    else
+        report_idle ();
+}
+
+} // end of 'ASX'
+} // end of 'market'
+} // end of namespace
+//----------------------------------------------------------------------------
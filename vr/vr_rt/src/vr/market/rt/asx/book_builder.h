@@ -0,0 +1,82 @@
+#pragma once
+
+#include "vr/market/ref/asx/ref_data_fwd.h"
+#include "vr/market/rt/agents/asx/market_data_manager.h"
+#include "vr/market/rt/cfg/agent_cfg_fwd.h"
+#include "vr/mc/steppable.h"
+#include "vr/startable.h"
+#include "vr/util/di/component.h"
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace market
+{
+namespace ASX
+{
+/**
+ * decodes a 'market_data_feed' once and builds the books for all instruments in
+ * the agent cfg liid table on its own thread, publishing them for any number of
+ * agents as @ref shared_books
+ *
+ * an agent constructed with this component's name as its "book_builder" arg does no
+ * ITCH decoding of its own (see @ref market_data_manager), so with N agents on a host
+ * every packet is decoded and every book updated once rather than N times
+ *
+ * this is an RCU reader of the feed, like an agent in the default mode; readers of
+ * its books are never blocked by it (and vice versa)
+ *
+ * @note trade signals are not shared (yet)
+ */
+class book_builder final: public mc::steppable_<mc::rcu<_reader_>>, public util::di::component, public startable
+{
+    public: // ...............................................................
+
+        using shared_books_type     = impl::md::shared_books_type;
+
+
+        VR_ASSUME_COLD book_builder ();
+        ~book_builder ();
+
+
+        // ACCESSORs:
+
+        /**
+         * @note valid after 'start()'
+         */
+        shared_books_type const & books () const;
+
+        /**
+         * @return total number of book re-publishes so far
+         */
+        int64_t const & publish_count () const
+        {
+            return m_publish_count;
+        }
+
+    private: // ..............................................................
+
+        // startable:
+
+        VR_ASSUME_COLD void start () override;
+        VR_ASSUME_COLD void stop () override;
+
+        // steppable:
+
+        VR_ASSUME_HOT void step () final override;
+
+
+        market_data_feed const * m_mdf { }; // [dep]
+        agent_cfg const * m_agents { };     // [dep]
+        ref_data const * m_ref_data { };    // [dep]
+
+        link_context m_md_ctx { };
+        std::unique_ptr<impl::md::build_context> m_build_ctx { }; // set by 'start()'
+        int64_t m_publish_count { };
+
+}; // end of class
+
+} // end of 'ASX'
+} // end of 'market'
+} // end of namespace
+//----------------------------------------------------------------------------
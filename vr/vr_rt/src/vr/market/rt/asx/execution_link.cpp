@@ -5,6 +5,7 @@
 #include "vr/io/links/link_factory.h"
 #include "vr/io/links/TCP_link.h"
 #include "vr/market/net/SoupTCP_.h"
+#include "vr/market/rt/asx/backtester.h"
 #include "vr/market/ref/asx/ref_data.h"
 #include "vr/market/rt/cfg/agent_cfg.h"
 #include "vr/market/rt/impl/reclamation.h" // release_poll_descriptor()
@@ -132,6 +133,14 @@ struct execution_link::pimpl final: public SoupTCP_<mode::recv, null_encapsulate
         LOG_trace1 << "using cfg:\n" << print (cfg);
         check_condition (cfg.is_object (), cfg.type ());
 
+        if (m_parent.m_backtester) // backtest mode: the backtester acts as the exchange (and publishes in place)
+        {
+            mc::volatile_cast (m_published) = m_parent.m_backtester->xl_descriptor ();
+
+            LOG_info << "backtest mode, no sessions opened";
+            return;
+        }
+
         bitset32_t pix_mask { }; // will be inferred from agent cfs below
         {
             // iterate over agent cfg(s) and configure:
@@ -198,7 +207,16 @@ struct execution_link::pimpl final: public SoupTCP_<mode::recv, null_encapsulate
         }
 
         int32_t const capacity = cfg.value ("capacity", io::net::default_tcp_link_capacity ());
-        // TODO 'ts_policy' when supported for TCP
+
+        // rx timestamps are used for '_ts_local_', tx completion timestamps for '_ts_sent_'
+        // (hw timestamping needs an "ifc" to configure, otherwise 'hw_fallback_to_sw' becomes 'sw'):
+
+        arg_map const link_args
+        {
+            { "tsp", to_enum<io::net::ts_policy> (cfg.value ("tsp", "hw_fallback_to_sw")) },
+            { "ifc", cfg.value ("ifc", std::string { }) },
+            { "tx_timestamps", true }
+        };
 
         settings const & svr_cfg = cfg.at ("server");
         check_condition (svr_cfg.is_object (), svr_cfg.type ());
@@ -242,13 +260,15 @@ struct execution_link::pimpl final: public SoupTCP_<mode::recv, null_encapsulate
 
             partition & p = m_partitions [pix];
             {
-                p.m_link = io::tcp_link_factory<data_link>::create ("ouch", server, string_cast (port_base + pix), capacity);
+                p.m_link = io::tcp_link_factory<data_link>::create ("ouch", server, string_cast (port_base + pix), capacity, link_args);
             }
         }
     }
 
     VR_ASSUME_COLD void stop ()
     {
+        if (m_parent.m_backtester) return; // nothing was attached in 'start()'
+
         bitset32_t pix_mask { m_active_partitions };
         while (pix_mask > 0)
         {
@@ -370,6 +390,7 @@ struct execution_link::pimpl final: public SoupTCP_<mode::recv, null_encapsulate
                                 p_current.m_pos = link_pos_flushed [pix] + parsed + recv_size_adj; // 'm_recv_pos_begin' is updated when allowed by the call_rcu() callback(s)
                                 p_current.m_end = addr_plus (data, parsed);
                                 p_current.m_ts_local = p.m_link->ts_last_recv ();
+                                p_current.m_ts_sent = p.m_ts_sent;
 
                                 DLOG_trace2 << "[P" << pix << "]: consumed " << parsed << ", available " << available << ", publishing {pos: " << p_current.m_pos << '}';
                             }
@@ -542,6 +563,22 @@ struct execution_link::pimpl final: public SoupTCP_<mode::recv, null_encapsulate
                     }
                 }
 
+                // tx completion timestamps (only polled for while some sent bytes are not covered by one):
+
+                if (p.m_send_ts_pos < p.m_link->send_position ())
+                {
+                    io::pos_t pos;
+                    timestamp_t ts;
+
+                    while (p.m_link->send_ts_poll (pos, ts))
+                    {
+                        DLOG_trace2 << "[P" << pix << "]: sent up to " << pos << " @ " << print_timestamp (ts);
+
+                        p.m_send_ts_pos = pos;
+                        p.m_ts_sent = ts;
+                    }
+                }
+
                 // flushed received bytes:
 
                 io::pos_t const pos_min_bound_pix { pos_min_bound [pix] };
@@ -625,11 +662,11 @@ struct execution_link::pimpl final: public SoupTCP_<mode::recv, null_encapsulate
         {
             if (has_field<_otk_, REQUEST> ())       // submit/replace
             {
-                copy_to_alphanum (field<_otk_> (req), field<_otk_> (msg)); // TODO fast otk copy
+                copy_to_alphanum (field<_otk_> (req), field<_otk_> (msg));
             }
             if (has_field<_new_otk_, REQUEST> ())   // replace
             {
-                copy_to_alphanum (field<_new_otk_> (req), field<_new_otk_> (msg)); // TODO fast otk copy
+                copy_to_alphanum (field<_new_otk_> (req), field<_new_otk_> (msg));
             }
             if (has_field<_iid_, REQUEST> ())       // submit
             {
@@ -693,7 +730,7 @@ struct execution_link::pimpl final: public SoupTCP_<mode::recv, null_encapsulate
 
         ouch::cancel_order & msg = field<_payload_> (frame);
         {
-            copy_to_alphanum (field<_otk_> (req), field<_otk_> (msg)); // TODO fast otk copy
+            copy_to_alphanum (field<_otk_> (req), field<_otk_> (msg));
         }
         DLOG_trace2 << "send: " << msg;
         p.m_send_committed += len; // note: this just increases commit count, the actual send I/O is coalesced and done elsewhere
@@ -864,6 +901,8 @@ struct execution_link::pimpl final: public SoupTCP_<mode::recv, null_encapsulate
         int64_t   m_send_committed { };
         int64_t   m_send_flushed { };       // tracks 'send_flush()'es
         io::pos_t m_recv_pos_begin { };     // tracks 'recv_flush()'es
+        io::pos_t m_send_ts_pos { };        // send position covered by the latest tx completion timestamp
+        timestamp_t m_ts_sent { };          // latest tx completion timestamp
         int32_t   m_recv_size { };
         int32_t   m_recv_available { };
 
@@ -923,7 +962,7 @@ struct execution_link::pimpl final: public SoupTCP_<mode::recv, null_encapsulate
 //............................................................................
 //............................................................................
 
-execution_link::execution_link (scope_path const & cfg_path, std::string const & mock) :
+execution_link::execution_link (scope_path const & cfg_path, std::string const & mock, std::string const & backtester) :
     m_impl { std::make_unique<pimpl> (* this, cfg_path) }
 {
     m_impl->initialize (); // slightly tricky initialization order here
@@ -934,6 +973,7 @@ execution_link::execution_link (scope_path const & cfg_path, std::string const &
     dep (m_ref_data) = "ref_data";
 
     if (! mock.empty ()) dep (m_mock) = mock;
+    if (! backtester.empty ()) dep (m_backtester) = backtester;
 }
 
 execution_link::~execution_link ()    = default; // pimpl
@@ -955,6 +995,8 @@ execution_link::stop ()
 execution_link::ifc
 execution_link::connect (call_traits<agent_ID>::param aid)
 {
+    if (m_backtester) return m_backtester->connect (aid);
+
     return m_impl->connect (aid);
 }
 //............................................................................
@@ -962,7 +1004,10 @@ execution_link::connect (call_traits<agent_ID>::param aid)
 void
 execution_link::step ()
 {
-    m_impl->step (); // force-inlined
+    if (VR_UNLIKELY (m_backtester != nullptr))
+        report_idle ();
+    else
+        m_impl->step (); // force-inlined
 }
 
 } // end of 'ASX'
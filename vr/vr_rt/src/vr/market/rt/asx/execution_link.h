@@ -23,6 +23,8 @@ namespace market
 {
 namespace ASX
 {
+class backtester; // forward
+
 /**
  */
 class execution_link final: public mc::steppable_<mc::rcu<_writer_>>, public util::di::component, public startable
@@ -33,7 +35,11 @@ class execution_link final: public mc::steppable_<mc::rcu<_writer_>>, public uti
         using poll_descriptor       = recv_descriptor<4>; // TODO ASX-specific; can't use a constexpr here due to std defect
 
 
-        VR_ASSUME_COLD execution_link (scope_path const & cfg_path, std::string const & mock = { });
+        /**
+         * @param backtester if not empty, name of an @ref backtester dep that will act as the
+         *        exchange instead of any OUCH sessions
+         */
+        VR_ASSUME_COLD execution_link (scope_path const & cfg_path, std::string const & mock = { }, std::string const & backtester = { });
         ~execution_link ();
 
 
@@ -71,6 +77,7 @@ class execution_link final: public mc::steppable_<mc::rcu<_writer_>>, public uti
         agent_cfg const * m_agents { };     // [dep]
         ref_data const * m_ref_data { };    // [dep]
         util::di::component const * m_mock { }; // [dep, a dummy one to force start() ordering wrt mock components]
+        backtester * m_backtester { };      // [dep, optional]
 
         std::unique_ptr<pimpl> const m_impl;
 
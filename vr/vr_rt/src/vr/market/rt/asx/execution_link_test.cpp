@@ -592,7 +592,7 @@ TEST (ASX_integration_execution, multiple_consumers)
         ("sql",         new io::sql_connection_factory { { { "sql.ro", cfg ["sql"]["sql.ro"] } } })
 
         ("server.itch", new mock_mcast_server { "/mock_server/itch" })
-        ("server.ouch", new mock_ouch_server  { "/mock_server/ouch" })
+        ("server.ouch", new mock_ouch_server  { "/mock_server/ouch", "server.itch" }) // note: shares the replay clock of "server.itch"
 
         ("threads",     new mc::thread_pool   { "/thread_pool" })
         ("agents",      new agent_cfg         { "/agents" })
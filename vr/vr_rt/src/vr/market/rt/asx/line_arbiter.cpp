@@ -0,0 +1,303 @@
+
+#include "vr/market/rt/asx/line_arbiter.h"
+
+#include "vr/util/logging.h"
+#include "vr/util/ops_int.h"
+
+#include <cstring>
+
+#include <net/ethernet.h>
+#include <netinet/ip.h>
+#include <netinet/udp.h>
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace market
+{
+namespace ASX
+{
+//............................................................................
+//............................................................................
+namespace
+{
+
+constexpr int32_t eth_hdr_len ()            { return sizeof (::ether_header); }
+constexpr int32_t min_payload ()            { return 46; } // see 'io::net::IP_'
+
+} // end of anonymous
+//............................................................................
+//............................................................................
+
+std::ostream &
+operator<< (std::ostream & os, line_arbiter::line_stats const & obj) VR_NOEXCEPT
+{
+    os << "packets: " << obj.m_packets << ", wins: " << obj.m_wins << ", dups: " << obj.m_dups;
+
+    if (obj.m_lag_count)
+        os << ", lag (mean/max): " << (obj.m_lag_sum / obj.m_lag_count) << '/' << obj.m_lag_max << " ns";
+
+    return os;
+}
+//............................................................................
+//............................................................................
+
+line_arbiter::line_arbiter (arg_map const & args) :
+    m_merged (args.get<int32_t> ("capacity")),
+    m_max_hold { args.get<timestamp_t> ("max_hold", _1_millisecond ()) },
+    m_line_timeout { args.get<timestamp_t> ("line_timeout", 2 * _1_second ()) }
+{
+    check_nonnegative (m_max_hold);
+    check_positive (m_line_timeout);
+}
+
+line_arbiter::~line_arbiter ()
+{
+    for (int32_t line = 0; line < line_count (); ++ line)
+    {
+        LOG_info << "line " << static_cast<char> ('A' + line) << " {" << m_stats [line] << '}';
+    }
+    LOG_info << "gaps missed by both lines: " << m_gap_count << ", merged buffer full " << m_full_count << " time(s)";
+}
+//............................................................................
+
+int32_t
+line_arbiter::consume (int32_t const line, addr_const_t const data, int32_t const available, timestamp_t const ts)
+{
+    assert_within (line, line_count ());
+
+    int32_t consumed { };
+
+    while (available - consumed >= eth_hdr_len () + static_cast<int32_t> (sizeof (::ip)))
+    {
+        addr_t const packet = const_cast<addr_t> (addr_plus (data, consumed)); // note: B packets are patched in place
+
+        ::ip const * const ip_hdr = static_cast<::ip const *> (addr_plus (packet, eth_hdr_len ()));
+
+        int32_t const ip_len = util::net_to_host (ip_hdr->ip_len);
+        int32_t const raw_len = (eth_hdr_len () + std::max<int32_t> (min_payload (), ip_len)); // raw, possibly padded
+
+        if (VR_UNLIKELY (available - consumed < raw_len)) break; // partial packet read
+
+        // backpressure: leave the rest in the link until readers of the merged buffer catch up
+        // (allowing for 'packet' releasing all held packets):
+
+        if (VR_UNLIKELY (m_merged.w_window () < raw_len + m_held_size))
+        {
+            ++ m_full_count;
+            break;
+        }
+
+        consume_packet (line, packet, raw_len, ts);
+
+        consumed += raw_len;
+    }
+
+    return consumed;
+}
+
+int32_t
+line_arbiter::expire (timestamp_t const now)
+{
+    int32_t r { };
+
+    if (m_held_count)
+    {
+        for (partition & p : m_partitions)
+        {
+            while (! p.m_held.empty ())
+            {
+                auto const i = p.m_held.begin ();
+                held_packet const & hp = i->second;
+
+                if (hp.m_ts + m_max_hold > now) break;
+                if (VR_UNLIKELY (m_merged.w_window () < m_held_size)) return r; // retry when readers have caught up
+
+                // neither line has filled the gap in time, give up on it:
+
+                DLOG_trace1 << "gap [" << p.m_next << ", " << i->first << ") expired";
+                ++ m_gap_count;
+
+                forward (p, hp.m_line, i->first, hp.m_msg_count, hp.m_data.data (), hp.m_data.size (), hp.m_ts);
+                m_held_size -= hp.m_data.size ();
+                p.m_held.erase (i);
+                -- m_held_count;
+                ++ r;
+
+                drain (p);
+            }
+        }
+    }
+
+    return r;
+}
+//............................................................................
+
+void
+line_arbiter::consume_packet (int32_t const line, addr_t const packet, int32_t const raw_len, timestamp_t const ts)
+{
+    m_ts_last_recv [line] = ts;
+
+    ::ip const * const ip_hdr = static_cast<::ip const *> (addr_plus (packet, eth_hdr_len ()));
+
+    if (VR_UNLIKELY (ip_hdr->ip_p != IPPROTO_UDP))
+    {
+        if (is_control_line (line, ts)) forward (packet, raw_len, ts);
+        return;
+    }
+
+    int32_t const ip_hl = ((ip_hdr->ip_hl) << 2);
+    ::udphdr * const udp_hdr = static_cast<::udphdr *> (addr_plus (packet, eth_hdr_len () + ip_hl));
+
+    int32_t const pix = util::net_to_host (udp_hdr->dest) - partition_port_base ('A' + line);
+    int32_t const payload_len = util::net_to_host (udp_hdr->len) - static_cast<int32_t> (sizeof (::udphdr));
+
+    if (VR_UNLIKELY (! vr_is_within (pix, partition_count ()) || (payload_len < static_cast<int32_t> (sizeof (MoldUDP64_recv_packet_hdr)))))
+    {
+        if (is_control_line (line, ts)) forward (packet, raw_len, ts);
+        return;
+    }
+
+    MoldUDP64_recv_packet_hdr const & hdr = * static_cast<MoldUDP64_recv_packet_hdr const *> (addr_plus (udp_hdr, sizeof (::udphdr)));
+
+    int32_t const msg_count = hdr.msg_count ();
+
+    if (! vr_is_in_exclusive_range (msg_count, 0, 0xFFFF)) // heartbeat or EOS
+    {
+        if (is_control_line (line, ts))
+        {
+            if (line) udp_hdr->dest = util::byteswap<uint16_t> (partition_port_base ('A') + pix);
+            forward (packet, raw_len, ts);
+        }
+        return;
+    }
+
+    if (line) udp_hdr->dest = util::byteswap<uint16_t> (partition_port_base ('A') + pix); // downstream partition inference assumes line A ports
+
+    line_stats & ls = m_stats [line];
+    ++ ls.m_packets;
+
+    partition & p = m_partitions [pix];
+    seqnum_t const sn = hdr.seqnum ();
+
+    if (VR_LIKELY ((sn == p.m_next) | (p.m_next == 0))) // first copy, in sequence (or the very first packet seen)
+    {
+        forward (p, line, sn, msg_count, packet, raw_len, ts);
+        if (m_held_count) drain (p);
+
+        return;
+    }
+
+    if (sn < p.m_next) // a copy of something already forwarded
+    {
+        if (VR_LIKELY (sn + msg_count <= p.m_next))
+        {
+            ++ ls.m_dups;
+
+            arrival const & a = p.m_arrivals [sn & (p.m_arrivals.size () - 1)];
+            if (a.m_seqnum == sn)
+            {
+                timestamp_t const lag = ts - a.m_ts;
+
+                ++ ls.m_lag_count;
+                ls.m_lag_sum += lag;
+                ls.m_lag_max = std::max (ls.m_lag_max, lag);
+            }
+        }
+        else // the lines packetized differently: forward and let downstream deal with the overlap
+        {
+            LOG_warn << "[P" << pix << ", line " << static_cast<char> ('A' + line) << "] packet [" << sn << ", " << (sn + msg_count) << ") overlaps next expected seqnum " << p.m_next;
+            forward (p, line, sn, msg_count, packet, raw_len, ts);
+            if (m_held_count) drain (p);
+        }
+
+        return;
+    }
+
+    // 'sn' is ahead of the next expected seqnum, hold it back until the other line fills the gap
+    // (or the hold expires):
+
+    auto const rc = p.m_held.emplace (sn, held_packet { std::string { static_cast<char const *> (packet), static_cast<std::size_t> (raw_len) }, ts, msg_count, line });
+
+    if (rc.second)
+    {
+        ++ m_held_count;
+        m_held_size += raw_len;
+    }
+    else // the other line's copy is already held
+    {
+        ++ ls.m_dups;
+
+        timestamp_t const lag = ts - rc.first->second.m_ts;
+
+        ++ ls.m_lag_count;
+        ls.m_lag_sum += lag;
+        ls.m_lag_max = std::max (ls.m_lag_max, lag);
+    }
+}
+//............................................................................
+
+bool
+line_arbiter::is_control_line (int32_t const line, timestamp_t const ts)
+{
+    if (VR_LIKELY (line == m_control_line)) return true;
+
+    if (ts - m_ts_last_recv [m_control_line] <= m_line_timeout) return false; // the control line is still alive
+
+    LOG_warn << "line " << static_cast<char> ('A' + m_control_line) << " silent for " << (ts - m_ts_last_recv [m_control_line]) << " ns, forwarding non-payload packets from line " << static_cast<char> ('A' + line);
+    m_control_line = line;
+
+    return true;
+}
+//............................................................................
+
+void
+line_arbiter::forward (addr_const_t const packet, int32_t const raw_len, timestamp_t const ts)
+{
+    assert_le (raw_len, m_merged.w_window ()); // guaranteed by 'consume()'/'expire()' backpressure
+
+    std::memcpy (m_merged.w_position (), packet, raw_len);
+    m_merged.w_advance (raw_len);
+
+    m_ts_last = std::max (m_ts_last, ts); // note: held packets are forwarded late
+}
+
+void
+line_arbiter::forward (partition & p, int32_t const line, seqnum_t const sn, int32_t const msg_count, addr_const_t const packet, int32_t const raw_len, timestamp_t const ts)
+{
+    forward (packet, raw_len, ts);
+
+    ++ m_stats [line].m_wins;
+
+    p.m_arrivals [sn & (p.m_arrivals.size () - 1)] = { sn, ts };
+    p.m_next = sn + msg_count;
+}
+
+void
+line_arbiter::drain (partition & p)
+{
+    while (! p.m_held.empty ())
+    {
+        auto const i = p.m_held.begin ();
+        seqnum_t const sn = i->first;
+        held_packet const & hp = i->second;
+
+        if (sn > p.m_next) break; // still a gap
+
+        if (sn + hp.m_msg_count > p.m_next) // not yet covered by what's been forwarded
+        {
+            forward (p, hp.m_line, sn, hp.m_msg_count, hp.m_data.data (), hp.m_data.size (), hp.m_ts);
+        }
+        else
+            ++ m_stats [hp.m_line].m_dups;
+
+        m_held_size -= hp.m_data.size ();
+        p.m_held.erase (i);
+        -- m_held_count;
+    }
+}
+
+} // end of 'ASX'
+} // end of 'market'
+} // end of namespace
+//----------------------------------------------------------------------------
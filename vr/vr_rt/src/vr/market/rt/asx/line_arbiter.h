@@ -0,0 +1,206 @@
+#pragma once
+
+#include "vr/arg_map.h"
+#include "vr/io/mapped_ring_buffer.h"
+#include "vr/market/net/MoldUDP64_.h"
+#include "vr/market/sources/asx/defs.h" // partition_count(), partition_port_base()
+
+#include <map>
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace market
+{
+namespace ASX
+{
+constexpr int32_t line_count ()                              { return 2; } // A, B
+//............................................................................
+/**
+ * merges raw (eth-framed) ITCH packets received on the redundant A and B multicast
+ * lines into a single packet stream:
+ *
+ *  - the first copy of each (partition, Mold seqnum) packet is forwarded into a merged
+ *    buffer (B copies get their UDP destination port rewritten to the A partition port so
+ *    that downstream partition inference works unchanged), later copies are dropped;
+ *  - a packet that arrives ahead of its partition's next expected seqnum is held back
+ *    for up to "max_hold" to give the other line a chance to fill the gap; if neither
+ *    line does, the held packets are forwarded anyway (see @ref expire()) and the gap
+ *    is left to downstream Mold gap handling;
+ *  - non-payload (heartbeat/EOS) and non-partition packets are forwarded from one "control"
+ *    line only: line A to begin with, switching to the other line whenever the current one
+ *    has been silent for longer than "line_timeout";
+ *  - packets are consumed only while the merged buffer has room for them (and for all held
+ *    packets), so slow readers of the merged stream backpressure into the line links
+ *    instead of overrunning the buffer
+ *
+ * per-line stats: "wins" (copies forwarded) and "lag" (how far behind the forwarded copy
+ * a duplicate from that line arrived)
+ *
+ * @note not thread-safe (meant to be driven by a single feed thread)
+ */
+class line_arbiter final: noncopyable
+{
+    public: // ...............................................................
+
+        using seqnum_t          = mold_seqnum_t;
+
+        struct line_stats final
+        {
+            int64_t m_packets { };      // partition payload packets received
+            int64_t m_wins { };         // ... of which were forwarded
+            int64_t m_dups { };         // ... of which were dropped as duplicates
+            int64_t m_lag_count { };    // dups whose winning copy's arrival time was still known
+            timestamp_t m_lag_sum { };
+            timestamp_t m_lag_max { };
+
+            friend VR_ASSUME_COLD std::ostream & operator<< (std::ostream & os, line_stats const & obj) VR_NOEXCEPT;
+
+        }; // end of nested class
+
+        /**
+         * @param args required: "capacity"     -> int32_t (merged buffer capacity)
+         *             optional: "max_hold"     -> timestamp_t (how long to wait for the other line to fill a gap),
+         *                       "line_timeout" -> timestamp_t (silence after which the control line fails over)
+         */
+        line_arbiter (arg_map const & args);
+        ~line_arbiter ();
+
+        // ACCESSORs:
+
+        line_stats const & stats (int32_t const line) const
+        {
+            assert_within (line, line_count ());
+
+            return m_stats [line];
+        }
+
+        /**
+         * @return count of packets forwarded with their partition's preceding seqnum range
+         *         missing on both lines
+         */
+        int64_t const & gap_count () const
+        {
+            return m_gap_count;
+        }
+
+        int32_t held_count () const
+        {
+            return m_held_count;
+        }
+
+        /**
+         * @return count of @ref consume() calls that stopped short because the merged
+         *         buffer was full
+         */
+        int64_t const & full_count () const
+        {
+            return m_full_count;
+        }
+
+        /**
+         * @return line (0 for A, 1 for B) whose non-payload packets are currently forwarded
+         */
+        int32_t const & control_line () const
+        {
+            return m_control_line;
+        }
+
+        /**
+         * @return receive timestamp of the most recently forwarded packet
+         */
+        timestamp_t const & ts_last_forwarded () const
+        {
+            return m_ts_last;
+        }
+
+        // merged buffer (read side):
+
+        addr_const_t r_position () const
+        {
+            return m_merged.r_position ();
+        }
+
+        int32_t size () const
+        {
+            return m_merged.size ();
+        }
+
+        // MUTATORs:
+
+        /**
+         * consume raw packets received on 'line' (0 for A, 1 for B)
+         *
+         * @return number of bytes consumed (only whole packets are consumed, and only as
+         *         many as the merged buffer has room for)
+         */
+        int32_t consume (int32_t const line, addr_const_t/* ::ether_header */const data, int32_t const available, timestamp_t const ts);
+
+        /**
+         * forward held packets that have been waiting since before 'now - max_hold'
+         * (if the merged buffer has room for them)
+         *
+         * @return number of packets forwarded
+         */
+        int32_t expire (timestamp_t const now);
+
+        void r_advance (int32_t const step)
+        {
+            m_merged.r_advance (step);
+        }
+
+    private: // ..............................................................
+
+        struct held_packet final
+        {
+            std::string m_data; // raw frame
+            timestamp_t m_ts;
+            int32_t m_msg_count;
+            int32_t m_line;
+
+        }; // end of nested class
+
+        struct arrival final
+        {
+            seqnum_t m_seqnum;
+            timestamp_t m_ts;
+
+        }; // end of nested class
+
+        struct partition final
+        {
+            seqnum_t m_next { };                    // next expected seqnum (0: not synced yet)
+            std::map<seqnum_t, held_packet> m_held { };
+            std::array<arrival, 1024> m_arrivals { }; // direct-mapped by seqnum of forwarded packets (size must be a power of 2)
+
+        }; // end of nested class
+
+
+        VR_ASSUME_HOT void consume_packet (int32_t const line, addr_t const packet, int32_t const raw_len, timestamp_t const ts);
+
+        bool is_control_line (int32_t const line, timestamp_t const ts);
+
+        void forward (addr_const_t const packet, int32_t const raw_len, timestamp_t const ts);
+        void forward (partition & p, int32_t const line, seqnum_t const sn, int32_t const msg_count, addr_const_t const packet, int32_t const raw_len, timestamp_t const ts);
+        void drain (partition & p);
+
+
+        io::mapped_ring_buffer m_merged;
+        timestamp_t const m_max_hold;
+        timestamp_t const m_line_timeout;
+        std::array<partition, partition_count ()> m_partitions { };
+        std::array<line_stats, line_count ()> m_stats { };
+        std::array<timestamp_t, line_count ()> m_ts_last_recv { };
+        timestamp_t m_ts_last { };
+        int64_t m_gap_count { };
+        int64_t m_full_count { };
+        int32_t m_held_count { };
+        int32_t m_held_size { };    // byte size of all held packets
+        int32_t m_control_line { };
+
+}; // end of class
+
+} // end of 'ASX'
+} // end of 'market'
+} // end of namespace
+//----------------------------------------------------------------------------
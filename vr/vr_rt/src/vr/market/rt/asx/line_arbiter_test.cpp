@@ -0,0 +1,326 @@
+
+#include "vr/market/rt/asx/line_arbiter.h"
+
+#include "vr/util/ops_int.h"
+#include "vr/util/random.h"
+
+#include "vr/test/utility.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <net/ethernet.h>
+#include <netinet/in.h>
+#include <netinet/ip.h>
+#include <netinet/udp.h>
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace market
+{
+namespace ASX
+{
+//............................................................................
+//............................................................................
+namespace
+{
+/*
+ * a raw eth/IP/UDP frame carrying a MoldUDP64 packet of 'msg_count' (empty-bodied) messages
+ */
+std::string
+make_frame (char const line, int32_t const pix, mold_seqnum_t const sn, int32_t const msg_count)
+{
+    int32_t const mold_len = sizeof (MoldUDP64_recv_packet_hdr) + msg_count * sizeof (MoldUDP64_recv_message_hdr);
+    int32_t const udp_len = sizeof (::udphdr) + mold_len;
+    int32_t const ip_len = sizeof (::ip) + udp_len;
+
+    std::string r (sizeof (::ether_header) + std::max<int32_t> (46, ip_len), '\0');
+
+    ::ether_header & eth_hdr = * reinterpret_cast<::ether_header *> (& r [0]);
+    eth_hdr.ether_type = util::byteswap<uint16_t> (ETHERTYPE_IP);
+
+    ::ip & ip_hdr = * reinterpret_cast<::ip *> (& r [sizeof (::ether_header)]);
+    {
+        ip_hdr.ip_v = 4;
+        ip_hdr.ip_hl = sizeof (::ip) >> 2;
+        ip_hdr.ip_len = util::byteswap<uint16_t> (ip_len);
+        ip_hdr.ip_p = IPPROTO_UDP;
+    }
+
+    ::udphdr & udp_hdr = * reinterpret_cast<::udphdr *> (& r [sizeof (::ether_header) + sizeof (::ip)]);
+    {
+        udp_hdr.dest = util::byteswap<uint16_t> (partition_port_base (line) + pix);
+        udp_hdr.len = util::byteswap<uint16_t> (udp_len);
+    }
+
+    MoldUDP64_recv_packet_hdr & hdr = * reinterpret_cast<MoldUDP64_recv_packet_hdr *> (& r [sizeof (::ether_header) + sizeof (::ip) + sizeof (::udphdr)]);
+    {
+        std::memcpy (hdr.session ().data (), "TEST000001", hdr.session ().size ());
+        hdr.seqnum () = sn;
+        hdr.msg_count () = msg_count;
+    }
+
+    return r;
+}
+
+/*
+ * read (and release) all of 'la's merged buffer content as a list of (partition, seqnum) pairs
+ */
+std::vector<std::pair<int32_t, mold_seqnum_t>>
+read_merged (line_arbiter & la)
+{
+    std::vector<std::pair<int32_t, mold_seqnum_t>> r { };
+
+    addr_const_t data = la.r_position ();
+    int32_t available = la.size ();
+
+    while (available > 0)
+    {
+        ::ip const & ip_hdr = * static_cast<::ip const *> (addr_plus (data, sizeof (::ether_header)));
+        int32_t const raw_len = sizeof (::ether_header) + std::max<int32_t> (46, util::net_to_host (ip_hdr.ip_len));
+        check_le (raw_len, available);
+
+        ::udphdr const & udp_hdr = * static_cast<::udphdr const *> (addr_plus (& ip_hdr, sizeof (::ip)));
+        MoldUDP64_recv_packet_hdr const & hdr = * static_cast<MoldUDP64_recv_packet_hdr const *> (addr_plus (& udp_hdr, sizeof (::udphdr)));
+
+        r.emplace_back (util::net_to_host (udp_hdr.dest) - partition_port_base ('A'), hdr.seqnum ());
+
+        data = addr_plus (data, raw_len);
+        available -= raw_len;
+    }
+
+    la.r_advance (la.size ());
+
+    return r;
+}
+
+struct event final
+{
+    timestamp_t m_ts;
+    int32_t m_line;
+    std::string m_frame;
+
+}; // end of class
+
+} // end of anonymous
+//............................................................................
+//............................................................................
+/*
+ * publish the same packet sequence on both lines, with line B lagging and each line
+ * randomly dropping packets; check that the merged stream contains every packet that
+ * made it through on at least one line exactly once and in seqnum order
+ */
+TEST (line_arbiter, merge)
+{
+    uint64_t rnd = test::env::random_seed<uint64_t> ();
+
+    constexpr int32_t packet_count      = 20000; // across all partitions
+    constexpr int32_t drop_pct          = 3; // per line
+    constexpr timestamp_t ts_step       = 1000;
+    constexpr timestamp_t B_lag         = 1500;
+
+    line_arbiter la { { { "capacity", 16 * 1024 * 1024 }, { "max_hold", 10 * ts_step } } };
+
+    std::array<mold_seqnum_t, partition_count ()> sn_next = meta::create_array_fill<mold_seqnum_t, partition_count (), 1> ();
+    std::array<std::vector<mold_seqnum_t>, partition_count ()> expected { };
+
+    std::vector<event> events { };
+    int32_t dup_count { };
+    int32_t lost_count { };
+
+    for (int32_t i = 0; i < packet_count; ++ i)
+    {
+        int32_t const pix = unsigned_cast (util::xorshift (rnd)) % partition_count ();
+        int32_t const msg_count = 1 + unsigned_cast (util::xorshift (rnd)) % 4;
+
+        mold_seqnum_t const sn = sn_next [pix];
+        sn_next [pix] += msg_count;
+
+        bool const drop_A = (sn > 1) && (unsigned_cast (util::xorshift (rnd)) % 100 < drop_pct); // [the arbiter syncs on the first packet seen]
+        bool const drop_B = (unsigned_cast (util::xorshift (rnd)) % 100 < drop_pct);
+
+        timestamp_t const ts = (i + 1) * ts_step;
+
+        if (! drop_A) events.push_back ({ ts, 0, make_frame ('A', pix, sn, msg_count) });
+        if (! drop_B) events.push_back ({ ts + B_lag, 1, make_frame ('B', pix, sn, msg_count) });
+
+        if (drop_A & drop_B)
+            ++ lost_count;
+        else
+        {
+            expected [pix].push_back (sn);
+            dup_count += ! (drop_A | drop_B);
+        }
+    }
+
+    std::stable_sort (events.begin (), events.end (), [](event const & lhs, event const & rhs) { return (lhs.m_ts < rhs.m_ts); });
+
+    for (event const & e : events)
+    {
+        std::string frame { e.m_frame }; // 'consume()' may patch in place
+
+        ASSERT_EQ (signed_cast (frame.size ()), la.consume (e.m_line, frame.data (), frame.size (), e.m_ts));
+        la.expire (e.m_ts);
+    }
+    la.expire (std::numeric_limits<timestamp_t>::max ());
+
+    ASSERT_EQ (0, la.held_count ());
+
+    // walk the merged stream:
+
+    std::array<std::vector<mold_seqnum_t>, partition_count ()> merged { };
+    {
+        addr_const_t data = la.r_position ();
+        int32_t available = la.size ();
+
+        while (available > 0)
+        {
+            ::ip const & ip_hdr = * static_cast<::ip const *> (addr_plus (data, sizeof (::ether_header)));
+            int32_t const raw_len = sizeof (::ether_header) + std::max<int32_t> (46, util::net_to_host (ip_hdr.ip_len));
+            ASSERT_LE (raw_len, available);
+
+            ::udphdr const & udp_hdr = * static_cast<::udphdr const *> (addr_plus (& ip_hdr, sizeof (::ip)));
+            int32_t const pix = util::net_to_host (udp_hdr.dest) - partition_port_base ('A'); // B copies are expected to be re-addressed
+            ASSERT_TRUE (vr_is_within (pix, partition_count ())) << pix;
+
+            MoldUDP64_recv_packet_hdr const & hdr = * static_cast<MoldUDP64_recv_packet_hdr const *> (addr_plus (& udp_hdr, sizeof (::udphdr)));
+            merged [pix].push_back (hdr.seqnum ());
+
+            data = addr_plus (data, raw_len);
+            available -= raw_len;
+        }
+
+        la.r_advance (la.size ());
+    }
+
+    for (int32_t pix = 0; pix < partition_count (); ++ pix)
+    {
+        EXPECT_EQ (expected [pix], merged [pix]) << "P" << pix;
+    }
+
+    line_arbiter::line_stats const & A = la.stats (0);
+    line_arbiter::line_stats const & B = la.stats (1);
+
+    LOG_info << "A {" << A << "}, B {" << B << "}, lost on both lines: " << lost_count;
+
+    EXPECT_EQ (A.m_wins + B.m_wins + A.m_dups + B.m_dups, A.m_packets + B.m_packets);
+    EXPECT_EQ (dup_count, A.m_dups + B.m_dups);
+
+    EXPECT_GT (B.m_wins, 0); // B filled some of A's drops
+    EXPECT_GT (A.m_wins, B.m_wins); // but A is faster
+
+    ASSERT_GT (B.m_lag_count, 0);
+    EXPECT_EQ (B_lag, B.m_lag_max);
+    EXPECT_EQ (B_lag, B.m_lag_sum / B.m_lag_count);
+
+    EXPECT_LE (la.gap_count (), lost_count); // consecutive losses in a partition expire as one gap
+}
+
+/*
+ * feed a batch of packets that doesn't fit into the merged buffer: 'consume()' must
+ * take only what fits and resume where it left off once the buffer has been read
+ */
+TEST (line_arbiter, backpressure)
+{
+    constexpr int32_t packet_count      = 500;
+    constexpr int32_t msg_count         = 4;
+
+    line_arbiter la { { { "capacity", 4096 } } };
+
+    std::string batch { };
+    for (int32_t i = 0; i < packet_count; ++ i)
+    {
+        batch += make_frame ('A', 0, 1 + i * msg_count, msg_count);
+    }
+    ASSERT_GT (signed_cast (batch.size ()), 2 * 4096); // make sure this needs several rounds
+
+    std::vector<mold_seqnum_t> merged { };
+    int32_t consumed { };
+    int32_t rounds { };
+
+    while (consumed < signed_cast (batch.size ()))
+    {
+        int32_t const rc = la.consume (0, & batch [consumed], batch.size () - consumed, 1000 + rounds);
+        ASSERT_GT (rc, 0) << "round " << rounds; // the merged buffer was drained after the last round
+
+        consumed += rc;
+        ++ rounds;
+
+        for (auto const & ps : read_merged (la))
+        {
+            ASSERT_EQ (0, ps.first);
+            merged.push_back (ps.second);
+        }
+    }
+
+    EXPECT_GT (rounds, 1);
+    EXPECT_EQ (rounds - 1, la.full_count ());
+
+    ASSERT_EQ (packet_count, signed_cast (merged.size ()));
+    for (int32_t i = 0; i < packet_count; ++ i)
+    {
+        EXPECT_EQ (1 + i * msg_count, merged [i]) << "packet #" << i;
+    }
+}
+
+/*
+ * heartbeats are forwarded from line A while it's alive and from line B once A has
+ * gone silent for longer than "line_timeout"
+ */
+TEST (line_arbiter, control_line_failover)
+{
+    constexpr timestamp_t line_timeout  = 2 * _1_second ();
+    constexpr timestamp_t hb_interval   = _1_second ();
+    constexpr timestamp_t B_lag         = 1000;
+
+    line_arbiter la { { { "capacity", 64 * 1024 }, { "line_timeout", line_timeout } } };
+
+    auto const heartbeat = [& la](int32_t const line, timestamp_t const ts)
+        {
+            std::string frame = make_frame ('A' + line, 0, 100, 0); // a heartbeat
+
+            check_eq (la.consume (line, & frame [0], frame.size (), ts), signed_cast (frame.size ()));
+        };
+
+    timestamp_t ts { 10 * _1_second () };
+
+    // both lines alive: one heartbeat forwarded per interval, from A
+
+    for (int32_t i = 0; i < 3; ++ i, ts += hb_interval)
+    {
+        heartbeat (0, ts);
+        heartbeat (1, ts + B_lag);
+    }
+    EXPECT_EQ (3, signed_cast (read_merged (la).size ()));
+    EXPECT_EQ (0, la.control_line ());
+
+    // A goes silent, B takes over after 'line_timeout':
+
+    int32_t forwarded { };
+    for (int32_t i = 0; i < 5; ++ i, ts += hb_interval)
+    {
+        heartbeat (1, ts + B_lag);
+
+        for (auto const & ps : read_merged (la))
+        {
+            EXPECT_EQ (0, ps.first) << "B frames must be re-addressed to A ports";
+            ++ forwarded;
+        }
+    }
+    EXPECT_EQ (1, la.control_line ());
+    EXPECT_EQ (4, forwarded); // all but the first one (sent within 'line_timeout' of A's last heartbeat)
+
+    // A comes back, but B is now the control line and still alive:
+
+    heartbeat (0, ts);
+    heartbeat (1, ts + B_lag);
+
+    EXPECT_EQ (1, signed_cast (read_merged (la).size ()));
+    EXPECT_EQ (1, la.control_line ());
+}
+
+} // end of 'ASX'
+} // end of 'market'
+} // end of namespace
+//----------------------------------------------------------------------------
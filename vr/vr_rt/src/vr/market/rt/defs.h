@@ -16,6 +16,7 @@ struct recv_position final
     io::pos_t m_pos;        // cumulative count of bytes received
     addr_const_t m_end;     // points just past the available data
     timestamp_t m_ts_local; // '_ts_last_recv_' from the link that supplied the latest version
+    timestamp_t m_ts_sent;  // latest tx completion timestamp (if the link supplies them) as of the latest version
 
 }; // end of class
 //............................................................................
@@ -3,12 +3,16 @@
 
 #include "vr/io/links/link_factory.h"
 #include "vr/io/links/UDP_mcast_link.h"
+#include "vr/market/rt/asx/backtester.h"
+#include "vr/market/rt/asx/line_arbiter.h"
+#include "vr/market/sources/asx/itch/Mold_rewind_client.h"
 #include "vr/market/rt/impl/reclamation.h" // release_poll_descriptor()
 #include "vr/mc/atomic.h"
 #include "vr/mc/mc.h"
 #include "vr/mc/thread_pool.h"
 #include "vr/rt/cfg/app_cfg.h"
 #include "vr/settings.h"
+#include "vr/sys/os.h"
 #include "vr/util/object_pools.h"
 
 //----------------------------------------------------------------------------
@@ -80,6 +84,14 @@ struct market_data_feed::pimpl final
         LOG_trace1 << "using cfg:\n" << print (cfg);
         check_condition (cfg.is_object (), cfg.type ());
 
+        if (m_parent.m_backtester) // backtest mode: publish the backtester's replay (in place, from the readers' own PU group)
+        {
+            mc::volatile_cast (m_published) = m_parent.m_backtester->md_descriptor ();
+
+            LOG_info << "backtest mode, no links opened";
+            return;
+        }
+
         std::string const ifc = cfg.at ("ifc");
         net::mcast_source const ms { cfg.at ("sources").get<std::string> () };
         int32_t const capacity = cfg.value ("capacity", io::net::default_mcast_link_recv_capacity ());
@@ -87,14 +99,60 @@ struct market_data_feed::pimpl final
 
         m_parent.m_threads->attach_to_rcu_callback_thread ();
 
-        m_recv_link = io::mcast_link_factory<data_link, data_link::recv_buffer_tag>::create ("itch", ifc,
-            { ms }, capacity, { { "tsp", tsp } });
+        std::string const sources_B = cfg.value ("sources_B", std::string { }); // if set, arbitrate between A and B lines
+
+        if (! sources_B.empty ())
+        {
+            net::mcast_source const ms_B { sources_B };
+
+            m_recv_link = io::mcast_link_factory<data_link, data_link::recv_buffer_tag>::create ("itch.A", ifc,
+                { ms }, capacity, { { "tsp", tsp } });
+            m_recv_link_B = io::mcast_link_factory<data_link, data_link::recv_buffer_tag>::create ("itch.B", ifc,
+                { ms_B }, capacity, { { "tsp", tsp } });
+
+            check_nonnull (m_recv_link_B);
+
+            m_arbiter = std::make_unique<ASX::line_arbiter> (arg_map { { "capacity", capacity }, { "max_hold", cfg.value ("max_hold", _1_millisecond ()) } });
+
+            LOG_info << "arbitrating lines A " << print (ms) << " and B " << print (ms_B);
+        }
+        else
+        {
+            m_recv_link = io::mcast_link_factory<data_link, data_link::recv_buffer_tag>::create ("itch", ifc,
+                { ms }, capacity, { { "tsp", tsp } });
+        }
 
         check_nonnull (m_recv_link);
+
+        auto const rw = cfg.find ("rewinder"); // if set, readers recover from seqnum gaps via the partition rewinders
+        if (rw != cfg.end ())
+        {
+            settings const & rw_cfg = (* rw);
+            check_condition (rw_cfg.is_object (), rw_cfg.type ());
+
+            int32_t const port_base = rw_cfg.at ("port");
+            check_within (port_base + ASX::partition_count (), 64 * 1024);
+
+            m_rewinder_args = std::make_unique<arg_map> (arg_map
+                {
+                    { "server",        rw_cfg.at ("host").get<std::string> () },
+                    { "port_base",     port_base },
+                    { "timeout",       rw_cfg.value ("timeout", 50 * _1_millisecond ()) },
+                    { "max_gap_age",   rw_cfg.value ("max_gap_age", 2 * _1_second ()) },
+                    { "max_buffered",  rw_cfg.value ("max_buffered", int64_t { 32 * 1024 * 1024 }) }
+                });
+
+            LOG_info << "seqnum gap recovery via rewinders at " << rw_cfg.at ("host").get<std::string> () << ':' << port_base << "+";
+        }
     }
 
     VR_ASSUME_COLD void stop ()
     {
+        if (m_parent.m_backtester) return; // nothing was attached in 'start()'
+
+        m_rewinder_args.reset ();
+        m_arbiter.reset (); // logs per-line stats
+        m_recv_link_B.reset ();
         m_recv_link.reset ();
 
         m_parent.m_threads->detach_from_rcu_callback_thread ();
@@ -104,18 +162,24 @@ struct market_data_feed::pimpl final
 
     // core step logic:
 
-    VR_FORCEINLINE void step () // note: force-inlined
+    /*
+     * @return 'true' iff new bytes were received
+     */
+    VR_FORCEINLINE bool step () // note: force-inlined
     {
         assert_ne (m_published, m_current); // invariant
 
         io::pos_t const link_pos_flushed { m_link_pos_begin };
         int32_t link_size { m_link_size };
+        bool received { false };
 
         {
-            std::pair<addr_const_t, capacity_t> const rc = m_recv_link->recv_poll (); // non-blocking read
+            std::pair<addr_const_t, capacity_t> const rc = (m_arbiter ? poll_arbitrated () : m_recv_link->recv_poll ()); // non-blocking read
 
             if (rc.second > link_size) // have new byte(s)
             {
+                received = true;
+
                 link_size = m_link_size = rc.second; // remember new link size
 
                 poll_descriptor * VR_RESTRICT const published = m_published;
@@ -128,7 +192,7 @@ struct market_data_feed::pimpl final
 
                     (* current) [0].m_pos = link_pos_flushed + link_size; // 'm_link_pos_begin' is updated when allowed by the call_rcu() callback(s)
                     (* current) [0].m_end = addr_plus (rc.first, link_size);
-                    (* current) [0].m_ts_local = ts_local = m_recv_link->ts_last_recv ();
+                    (* current) [0].m_ts_local = ts_local = (m_arbiter ? m_arbiter->ts_last_forwarded () : m_recv_link->ts_last_recv ());
 
                     rcu_assign_pointer (m_published, current); // publish a new descriptor (pointed to by 'current')
                 }
@@ -143,6 +207,8 @@ struct market_data_feed::pimpl final
 
                 call_rcu (& published->m_rcu_head, release_poll_descriptor); // [doesn't block]
 
+                for (mc::steppable * const w : m_parent.m_waiters) w->wake (); // a fence and a shared load unless 'w' is backing off
+
                 // allocate 'm_current' replacement:
                 {
                     auto const ar = m_pds.allocate ();
@@ -203,8 +269,43 @@ struct market_data_feed::pimpl final
             m_link_pos_begin = pos_min_bound;
             m_link_size = link_size - pos_increment;
 
-            m_recv_link->recv_flush (pos_increment);
+            if (m_arbiter)
+                m_arbiter->r_advance (pos_increment);
+            else
+                m_recv_link->recv_flush (pos_increment);
         }
+
+        return received;
+    }
+
+    /*
+     * drain both lines into the arbiter (whatever doesn't fit into its merged buffer
+     * because of slow readers stays in the links for the next step, see 'line_arbiter::consume()')
+     *
+     * @return the arbiter's merged buffer, in the same form as 'recv_poll()'
+     */
+    std::pair<addr_const_t, capacity_t> poll_arbitrated ()
+    {
+        ASX::line_arbiter & arbiter = (* m_arbiter);
+
+        data_link * const links [ASX::line_count ()] { m_recv_link.get (), m_recv_link_B.get () };
+
+        for (int32_t line = 0; line < ASX::line_count (); ++ line)
+        {
+            data_link & link = (* links [line]);
+
+            std::pair<addr_const_t, capacity_t> const rc = link.recv_poll (); // non-blocking read
+
+            if (rc.second > 0)
+            {
+                int32_t const consumed = arbiter.consume (line, rc.first, rc.second, link.ts_last_recv ()); // copies what it keeps
+                link.recv_flush (consumed);
+            }
+        }
+
+        if (arbiter.held_count ()) arbiter.expire (sys::realtime_utc ());
+
+        return { arbiter.r_position (), arbiter.size () };
     }
 
 
@@ -218,7 +319,10 @@ struct market_data_feed::pimpl final
 
     market_data_feed & m_parent;
     poll_descriptor * & m_published;            // aliases 'm_parent::m_published.value ()'
-    std::unique_ptr<data_link> m_recv_link { }; // set up in 'start()'
+    std::unique_ptr<data_link> m_recv_link { }; // set up in 'start()' [line A if arbitrating]
+    std::unique_ptr<data_link> m_recv_link_B { };       // [arbitrating only]
+    std::unique_ptr<ASX::line_arbiter> m_arbiter { };   // [arbitrating only]
+    std::unique_ptr<arg_map> m_rewinder_args { };       // [gap recovery only]
     poll_descriptor * m_current { nullptr };    // next 'm_published' (private to this RCU writer)
     io::pos_t m_link_pos_begin { };             // tracks 'recv_flush()'es
     pd_pool m_pds { };
@@ -233,18 +337,43 @@ struct market_data_feed::pimpl final
 //............................................................................
 //............................................................................
 
-market_data_feed::market_data_feed (scope_path const & cfg_path) :
+market_data_feed::market_data_feed (scope_path const & cfg_path, std::string const & backtester) :
     m_impl { std::make_unique<pimpl> (* this, cfg_path) }
 {
     m_impl->initialize (); // slightly tricky initialization order here
 
     dep (m_config) = "config";
     dep (m_threads) = "threads";
+
+    if (! backtester.empty ()) dep (m_backtester) = backtester;
 }
 
 market_data_feed::~market_data_feed ()    = default; // pimpl
 //............................................................................
 
+ASX::line_arbiter const *
+market_data_feed::arbiter () const
+{
+    return m_impl->m_arbiter.get ();
+}
+//............................................................................
+
+std::unique_ptr<ASX::Mold_rewind_client>
+market_data_feed::create_rewinder () const
+{
+    if (! m_impl->m_rewinder_args) return { };
+
+    return std::make_unique<ASX::Mold_rewind_client> (* m_impl->m_rewinder_args);
+}
+//............................................................................
+
+void
+market_data_feed::add_waiter (mc::steppable & reader) const
+{
+    m_waiters.push_back (& reader);
+}
+//............................................................................
+
 void
 market_data_feed::start ()
 {
@@ -261,7 +390,8 @@ market_data_feed::stop ()
 void
 market_data_feed::step ()
 {
-    m_impl->step (); // force-inlined
+    if (VR_UNLIKELY (m_backtester != nullptr) || ! m_impl->step ()) // force-inlined
+        report_idle ();
 }
 
 } // end of 'market'
@@ -16,6 +16,12 @@ namespace vr
 {
 namespace market
 {
+namespace ASX
+{
+class backtester; // forward
+class line_arbiter; // forward
+class Mold_rewind_client; // forward
+}
 //TODO move into ASX ns?
 
 class market_data_feed final: public mc::steppable_<mc::rcu<_writer_>>, public util::di::component, public startable
@@ -24,7 +30,11 @@ class market_data_feed final: public mc::steppable_<mc::rcu<_writer_>>, public u
 
         using poll_descriptor   = recv_descriptor<1>;
 
-        VR_ASSUME_COLD market_data_feed (scope_path const & cfg_path);
+        /**
+         * @param backtester if not empty, name of an @ref ASX::backtester dep whose market data
+         *        replay this feed will publish instead of doing any I/O
+         */
+        VR_ASSUME_COLD market_data_feed (scope_path const & cfg_path, std::string const & backtester = { });
         ~market_data_feed ();
 
         // ACCESSORs:
@@ -35,6 +45,32 @@ class market_data_feed final: public mc::steppable_<mc::rcu<_writer_>>, public u
          */
         VR_FORCEINLINE poll_descriptor const & poll () const;
 
+        /**
+         * @return A/B line arbiter (for its per-line stats) if configured with "sources_B",
+         *         'nullptr' otherwise
+         *
+         * @note the stats are updated by this component's stepping thread
+         */
+        ASX::line_arbiter const * arbiter () const;
+
+        /**
+         * @return a new MoldUDP64 gap recovery client (to pass as "rewinder" to a reader's
+         *         @ref ASX::Mold_frame_) if configured with "rewinder", 'nullptr' otherwise
+         *
+         * @note each reader needs its own (a client holds that reader's gap state);
+         *       valid after this feed has started
+         */
+        VR_ASSUME_COLD std::unique_ptr<ASX::Mold_rewind_client> create_rewinder () const;
+
+        /**
+         * have 'reader' @ref mc::steppable::wake()d every time this feed publishes new
+         * data (useful for readers that @ref mc::steppable::report_idle() and hence can
+         * have their 'step_runnable' back off)
+         *
+         * @note must be called before this feed starts stepping (e.g. from the reader's 'start()')
+         */
+        VR_ASSUME_COLD void add_waiter (mc::steppable & reader) const;
+
     private: // ..............................................................
 
         class pimpl; // forward
@@ -51,8 +87,10 @@ class market_data_feed final: public mc::steppable_<mc::rcu<_writer_>>, public u
 
         rt::app_cfg const * m_config { };   // [dep]
         mc::thread_pool * m_threads { };    // [dep]
+        ASX::backtester * m_backtester { }; // [dep, optional]
 
         std::unique_ptr<pimpl> const m_impl;
+        mutable std::vector<mc::steppable *> m_waiters { }; // [not part of the feed's observable state]
 
         mc::cache_line_padded_field<poll_descriptor *> m_published { }; // [RCU-assigned]
 
@@ -1,4 +1,5 @@
 
+#include "vr/market/rt/agents/asx/market_data_manager.h" // poll_feed()
 #include "vr/market/rt/market_data_feed.h"
 #include "vr/market/sources/mock/mock_mcast_server.h"
 #include "vr/mc/mc.h"
@@ -92,6 +93,94 @@ struct market_data_consumer final: public mc::steppable_<mc::rcu<_reader_>>, pub
     uint64_t m_rnd;
     uint32_t m_checksum { 1 };
 
+}; // end of class
+//............................................................................
+
+using partition_counts      = std::array<int64_t, ASX::partition_count ()>;
+
+/*
+ * counts ITCH messages visited in each partition and remembers the seqnum of the
+ * first one
+ */
+template<typename CTX>
+class message_counter: public ASX::ITCH_visitor<message_counter<CTX>>
+{
+    private: // ..............................................................
+
+        using super         = ASX::ITCH_visitor<message_counter<CTX>>;
+
+    public: // ...............................................................
+
+        message_counter (arg_map const & args) :
+            super (args),
+            m_counts { * args.get<partition_counts *> ("counts") },
+            m_first_seqnums { * args.get<partition_counts *> ("first_seqnums") }
+        {
+        }
+
+        using super::visit;
+
+        VR_FORCEINLINE bool visit (pre_message const msg_type, addr_const_t const msg, CTX & ctx) // override
+        {
+            int32_t const pix = field<_partition_> (ctx);
+
+            if (VR_UNLIKELY (! m_counts [pix])) m_first_seqnums [pix] = field<_seqnum_> (ctx);
+            ++ m_counts [pix];
+
+            return false; // no need to visit the message itself
+        }
+
+    private: // ..............................................................
+
+        partition_counts & m_counts;
+        partition_counts & m_first_seqnums;
+
+}; // end of class
+
+/*
+ * a market data reader that does its own Mold framing with gap recovery enabled
+ * (the way 'market_data_manager' and 'book_builder' do)
+ */
+struct gap_checker final: public mc::steppable_<mc::rcu<_reader_>>, public util::di::component, public startable
+{
+    using visit_ctx     = ASX::impl::md::visit_ctx;
+    using visitor       = io::net::IP_<io::net::UDP_<ASX::Mold_frame_<ASX::ITCH_pipeline<message_counter<visit_ctx>>>>>;
+
+    gap_checker ()
+    {
+        dep (m_mdf) = "mdf";
+    }
+
+    // startable:
+
+    VR_ASSUME_COLD void start () override
+    {
+        m_rewinder = m_mdf->create_rewinder ();
+        check_nonnull (m_rewinder);
+
+        m_visitor = std::make_unique<visitor> (arg_map { { "rewinder", m_rewinder.get () }, { "counts", & m_counts }, { "first_seqnums", & m_first_seqnums } });
+    }
+
+    VR_ASSUME_COLD void stop () override
+    {
+    }
+
+    // steppable:
+
+    VR_ASSUME_HOT void step () final override
+    {
+        ASX::impl::md::poll_feed (* m_mdf, m_md_ctx, * m_visitor);
+    }
+
+
+    market_data_feed const * m_mdf { };  // [dep]
+
+    link_context m_md_ctx { };
+    std::unique_ptr<ASX::Mold_rewind_client> m_rewinder { };
+    std::unique_ptr<visitor> m_visitor { };
+    partition_counts m_counts { };
+    partition_counts m_first_seqnums { };
+
 }; // end of class
 
 } // end of 'test_'
@@ -199,6 +288,97 @@ TEST (integration_market_data, multiple_consumers)
 //    EXPECT_EQ (c0.m_checksum, c2.m_checksum);
 }
 
+/*
+ * have the mock server drop some partition packets and check that a reader whose
+ * rewinder comes from a feed configured with "rewinder" sees every message (in each
+ * partition that isn't in the middle of a recovery when the app stops)
+ */
+TEST (integration_market_data, gap_recovery)
+{
+    using namespace test_;
+
+    fs::path const test_input = test::find_capture (source::ASX, "<"_rop, util::current_date_in ("Australia/Sydney"));
+    LOG_info << "using test data in " << print (test_input);
+
+    util::date_t const date = util::extract_date (test_input.native ());
+
+    int32_t const rewinder_port_base    = 22701;
+
+    settings cfg
+    {
+        { "app_cfg", {
+            { "time", util::format_time (util::ptime_t { date, pt::seconds (0) }, "%Y-%b-%d %H:%M:%S") }
+        }}
+        ,
+        { "mock_server", {
+            { "itch", {
+                { "ifc", "lo" },
+                { "packet_begin",   3000000 },
+                { "packet_limit",   3050000 },
+                { "cap_root", util::getenv<fs::path> ("VR_CAP_ROOT", "").native () }, // TODO
+                { "rewinder_port_base", rewinder_port_base },
+                { "drop_rate",      0.01 }
+            }}
+        }}
+        ,
+        { "thread_pool", {
+            { "rcu", {
+                { "use_RT_callback", true },
+                { "callback_PU", -1 },
+            }}
+        }}
+        ,
+        { "market_data_feed", {
+            { "ifc", "lo" },
+            { "tsp", "hw_fallback_to_sw" }, // note: more permissive mode than prod
+            { "sources", "203.0.119.212->233.71.185.8, 233.71.185.9, 233.71.185.10, 233.71.185.11, 233.71.185.12" },
+            { "rewinder", {
+                { "host", "127.0.0.1" },
+                { "port", rewinder_port_base }
+            }}
+        }}
+    };
+
+    util::di::container app { join_as_name ("APP", test::current_test_name ()),
+        {
+            { "default",        0 },
+
+            { "server.itch",    "default" },
+            { "mdf",            1 },
+            { "c0",             2 },
+        }
+    };
+
+    app.configure ()
+        ("config",      new rt::app_cfg { cfg })
+
+        ("server.itch", new mock_mcast_server { "/mock_server/itch" })
+
+        ("threads",     new mc::thread_pool   { "/thread_pool" })
+        ("mdf",         new market_data_feed  { "/market_data_feed" })
+
+        ("c0",          new gap_checker { })
+    ;
+
+    app.start ();
+    {
+        app.run_for (VR_IF_THEN_ELSE (VR_DEBUG)(10, 30) * _1_second ());
+    }
+    app.stop ();
+
+    gap_checker const & c0 = app ["c0"];
+
+    EXPECT_GT (c0.m_rewinder->request_count (), 0);
+    EXPECT_GT (c0.m_rewinder->recv_count (), 0);
+
+    for (int32_t pix = 0; pix < ASX::partition_count (); ++ pix)
+    {
+        if ((! c0.m_counts [pix]) || (c0.m_visitor->gap_mask () & (1 << pix))) continue;
+
+        EXPECT_EQ (c0.m_visitor->seqnums ()[pix] - c0.m_first_seqnums [pix], c0.m_counts [pix]) << "P" << pix;
+    }
+}
+
 } // end of 'market'
 } // end of namespace
 //----------------------------------------------------------------------------
@@ -28,6 +28,9 @@ struct source_traits<source::ASX>: public source_traits<>
     template<typename T_BOOK_PRICE>
     using price_traits              = price_ops<price_type, std::ratio<price_si_scale (), 10000>, T_BOOK_PRICE>;
 
+    template<typename T_BOOK_QTY>
+    using qty_traits                = qty_ops<qty_type, T_BOOK_QTY>;
+
 }; // end of specialization
 //............................................................................
 //............................................................................
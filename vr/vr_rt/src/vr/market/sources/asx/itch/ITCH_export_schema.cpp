@@ -0,0 +1,154 @@
+
+#include "vr/market/sources/asx/itch/ITCH_export_schema.h"
+
+#include "vr/data/attributes.h"
+#include "vr/market/schema.h"
+#include "vr/util/singleton.h"
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace market
+{
+namespace ASX
+{
+//............................................................................
+//............................................................................
+namespace
+{
+using namespace data;
+using namespace schema;
+
+constexpr atype::enum_t price_at ()     { return atype::for_numeric<this_source_traits::price_type> (); }
+constexpr atype::enum_t qty_at ()       { return atype::for_numeric<this_source_traits::qty_type> (); }
+
+template<itch::message_type::enum_t TYPE>
+struct make_ITCH_export_schema final: public util::singleton_constructor<std::vector<attribute> >
+{
+    make_ITCH_export_schema (std::vector<attribute> * const obj)
+    {
+        new (obj) std::vector<attribute>
+        {
+            { TS_ORIGIN,    atype::timestamp },
+            { TS_LOCAL,     atype::timestamp },
+            { "partition",  atype::i4 },
+            { "seqnum",     atype::i8 },
+            { "iid",        atype::for_numeric<iid_t> () }
+        };
+
+        std::vector<attribute> & r = (* obj);
+
+        switch (TYPE)
+        {
+            case itch::message_type::order_book_state:
+            {
+                r.emplace_back (STATE,          attr_type::for_enum<itch::book_state> ());
+            }
+            break;
+
+            case itch::message_type::auction_update:
+            {
+                for (side::enum_t s : side::values ())
+                {
+                    r.emplace_back (join_as_name<'_'> (QTY, s),             qty_at ());
+                }
+                r.emplace_back (PRICE,                                      price_at ());
+                for (side::enum_t s : side::values ())
+                {
+                    r.emplace_back (join_as_name<'_'> (PRICE, s, "best"),   price_at ());
+                }
+                for (side::enum_t s : side::values ())
+                {
+                    r.emplace_back (join_as_name<'_'> (QTY, s, "best"),     qty_at ());
+                }
+            }
+            break;
+
+            case itch::message_type::order_add:
+            case itch::message_type::order_add_with_participant: // note: 'participant' is not exported
+            case itch::message_type::order_replace:
+            {
+                r.emplace_back ("oid",          atype::for_numeric<oid_t> ());
+                r.emplace_back (SIDE,           attr_type::for_enum<side> ());
+                r.emplace_back ("queue_rank",   atype::i4);
+                r.emplace_back (QTY,            qty_at ());
+                r.emplace_back (PRICE,          price_at ());
+                r.emplace_back ("order_attrs",  atype::i4);
+
+                if (TYPE != itch::message_type::order_replace)
+                    r.emplace_back ("lot_type", atype::i4);
+            }
+            break;
+
+            case itch::message_type::order_fill:
+            case itch::message_type::order_fill_with_price:
+            {
+                r.emplace_back ("oid",          atype::for_numeric<oid_t> ());
+                r.emplace_back (SIDE,           attr_type::for_enum<side> ());
+                r.emplace_back (QTY,            qty_at ());
+                r.emplace_back ("match",        atype::i8);
+                r.emplace_back ("combo_group",  atype::i4);
+
+                if (TYPE == itch::message_type::order_fill_with_price)
+                {
+                    r.emplace_back (PRICE,          price_at ());
+                    r.emplace_back ("at_auction",   atype::i4);
+                    r.emplace_back ("printable",    atype::i4);
+                }
+            }
+            break;
+
+            case itch::message_type::order_delete:
+            {
+                r.emplace_back ("oid",          atype::for_numeric<oid_t> ());
+                r.emplace_back (SIDE,           attr_type::for_enum<side> ());
+            }
+            break;
+
+            case itch::message_type::trade:
+            {
+                r.emplace_back ("match",        atype::i8);
+                r.emplace_back ("combo_group",  atype::i4);
+                r.emplace_back (SIDE,           attr_type::for_enum<side> ()); // NA if not disclosed
+                r.emplace_back (QTY,            qty_at ());
+                r.emplace_back (PRICE,          price_at ());
+                r.emplace_back ("printable",    atype::i4);
+                r.emplace_back ("at_auction",   atype::i4);
+            }
+            break;
+
+            default: VR_ASSUME_UNREACHABLE (TYPE);
+
+        } // end of switch
+
+        r.shrink_to_fit ();
+    }
+
+}; // end of class
+
+} // end of anonymous
+//............................................................................
+//............................................................................
+
+std::vector<data::attribute> const &
+ITCH_export_attributes (itch::message_type::enum_t const type)
+{
+    switch (type)
+    {
+#   define vr_CASE(r, unused, MSG) \
+        case itch::message_type:: MSG : return util::singleton<std::vector<attribute>, make_ITCH_export_schema<itch::message_type:: MSG > >::instance (); \
+        /* */
+
+        BOOST_PP_SEQ_FOR_EACH (vr_CASE, unused, VR_MARKET_ITCH_EXPORT_SEQ)
+
+#   undef vr_CASE
+
+        default: throw_x (invalid_input, "ITCH message type " + print (type) + " is not exported");
+
+    } // end of switch
+}
+
+} // end of 'ASX'
+} // end of 'market'
+} // end of namespace
+//----------------------------------------------------------------------------
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "vr/data/attributes_fwd.h"
+#include "vr/market/sources/asx/itch/messages.h"
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace market
+{
+namespace ASX
+{
+/*
+ * ITCH message types exported by 'ITCH_exporter' (directory, system and 'seconds'
+ * messages are not)
+ */
+#define VR_MARKET_ITCH_EXPORT_SEQ       \
+        (order_book_state)              \
+        (auction_update)                \
+        (order_add)                     \
+        (order_add_with_participant)    \
+        (order_fill)                    \
+        (order_fill_with_price)         \
+        (order_replace)                 \
+        (order_delete)                  \
+        (trade)                         \
+    /* */
+
+/**
+ * @return column schema of the frame exported for ITCH message 'type': common columns
+ *         { ts_origin, ts_local, partition, seqnum, iid } followed by message fields
+ *         (prices and quantities are in wire units)
+ *
+ * @see ITCH_exporter
+ */
+extern std::vector<data::attribute> const &
+ITCH_export_attributes (itch::message_type::enum_t const type);
+
+} // end of 'ASX'
+} // end of 'market'
+} // end of namespace
+//----------------------------------------------------------------------------
@@ -0,0 +1,587 @@
+#pragma once
+
+#include "vr/market/sources/asx/itch/ITCH_export_schema.h"
+
+#include "vr/data/dataframe.h"
+#include "vr/data/NA.h"
+#include "vr/fields.h"
+#include "vr/filesystem.h"
+#include "vr/io/files.h"
+#include "vr/io/frame_streams.h"
+#include "vr/market/sources/asx/itch/ITCH_ts_tracker.h"
+#include "vr/util/logging.h"
+
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <deque>
+#include <exception>
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace market
+{
+namespace ASX
+{
+//............................................................................
+//............................................................................
+namespace impl
+{
+
+class ITCH_exporter_base
+{
+    protected: // ............................................................
+
+        /*
+         * a no-op if not given a mutex
+         */
+        struct io_lock final
+        {
+            io_lock (boost::mutex * const m) :
+                m_mutex { m }
+            {
+                if (m_mutex) m_mutex->lock ();
+            }
+
+            ~io_lock ()
+            {
+                if (m_mutex) m_mutex->unlock ();
+            }
+
+            boost::mutex * const m_mutex;
+
+        }; // end of nested class
+
+        struct table; // forward
+
+        /*
+         * a thread that writes out the full frame buffers of one partition, so that the
+         * decoding thread only swaps buffers (and blocks only when the same table's
+         * previous buffer is still being written)
+         */
+        class writer final: noncopyable
+        {
+            private: // ..........................................................
+
+                using lock_type             = boost::unique_lock<boost::mutex>;
+
+            public: // ...........................................................
+
+                writer (boost::mutex * const io_mutex) :
+                    m_io_mutex { io_mutex }
+                {
+                    m_thread = boost::thread { [this]() { write_loop (); } };
+                }
+
+                ~writer () VR_NOEXCEPT // note: completes writes already submitted
+                {
+                    join ();
+                }
+
+
+                /*
+                 * decoding thread: queue 't.m_buf' for writing (swapping in 't.m_spare'
+                 * once its own previous write has completed)
+                 *
+                 * @throws the first failure of any earlier write
+                 */
+                void submit (table & t)
+                {
+                    {
+                        lock_type _ { m_mutex };
+
+                        while (t.m_pending && (m_failure == nullptr)) m_done_cv.wait (_);
+
+                        if (VR_UNLIKELY (m_failure != nullptr)) std::rethrow_exception (m_failure);
+
+                        std::swap (t.m_buf, t.m_spare);
+                        t.m_pending = true;
+
+                        m_queue.push_back (& t);
+                        ++ m_in_flight;
+                    }
+                    m_queue_cv.notify_one ();
+                }
+
+                /*
+                 * decoding thread: wait for all submitted writes to complete
+                 *
+                 * @throws the first failure of any write
+                 */
+                void drain ()
+                {
+                    lock_type _ { m_mutex };
+
+                    while ((m_in_flight > 0) && (m_failure == nullptr)) m_done_cv.wait (_);
+
+                    if (VR_UNLIKELY (m_failure != nullptr)) std::rethrow_exception (m_failure);
+                }
+
+            private: // ..........................................................
+
+                void join () VR_NOEXCEPT
+                {
+                    {
+                        lock_type _ { m_mutex };
+
+                        m_closing = true;
+                    }
+                    m_queue_cv.notify_all ();
+
+                    if (m_thread.joinable ()) m_thread.join ();
+                }
+
+                void write_loop ()
+                {
+                    while (true)
+                    {
+                        table * t;
+                        data::dataframe * buf;
+                        {
+                            lock_type _ { m_mutex };
+
+                            while (m_queue.empty () && ! m_closing) m_queue_cv.wait (_);
+
+                            if (m_queue.empty ()) // implies 'm_closing'
+                                return;
+
+                            t = m_queue.front ();
+                            m_queue.pop_front ();
+
+                            buf = t->m_spare.get ();
+                        }
+
+                        try
+                        {
+                            {
+                                io_lock _ { m_io_mutex };
+
+                                t->m_out->write (* buf);
+                            }
+                            buf->resize_row_count (0);
+                        }
+                        catch (...)
+                        {
+                            {
+                                lock_type _ { m_mutex };
+
+                                if (m_failure == nullptr) m_failure = std::current_exception ();
+                            }
+                            m_done_cv.notify_all ();
+                            return;
+                        }
+
+                        {
+                            lock_type _ { m_mutex };
+
+                            t->m_pending = false;
+                            -- m_in_flight;
+                        }
+                        m_done_cv.notify_all ();
+                    }
+                }
+
+
+                boost::mutex * const m_io_mutex;            // [optional]
+                boost::mutex m_mutex { };
+                boost::condition_variable m_queue_cv { };
+                boost::condition_variable m_done_cv { };
+                std::deque<table *> m_queue { };            // protected by 'm_mutex'
+                int32_t m_in_flight { };                    // submitted but not yet written (protected by 'm_mutex')
+                std::exception_ptr m_failure { };           // protected by 'm_mutex'
+                bool m_closing { false };                   // protected by 'm_mutex'
+                boost::thread m_thread { };
+
+        }; // end of nested class
+
+        /*
+         * an output frame (and its row buffer) for one ITCH message type, opened lazily
+         * so that message types not present in the input don't produce empty files
+         */
+        struct table final
+        {
+            table (itch::message_type::enum_t const type, int32_t const row_capacity, writer * const w) :
+                m_buf { std::make_unique<data::dataframe> (row_capacity, ITCH_export_attributes (type)) },
+                m_spare { w ? std::make_unique<data::dataframe> (row_capacity, ITCH_export_attributes (type)) : nullptr },
+                m_writer { w },
+                m_type { type }
+            {
+            }
+
+            VR_ASSUME_COLD void open (fs::path const & out_dir, arg_map const & parms, boost::mutex * const io_mutex)
+            {
+                check_condition (! m_out); // called once
+
+                io::create_dirs (out_dir);
+
+                io_lock _ { io_mutex };
+                m_out = io::frame_ostream::create (out_dir / print (m_type), parms, & m_out_file);
+            }
+
+            VR_ASSUME_COLD VR_NOINLINE void flush (boost::mutex * const io_mutex)
+            {
+                if (m_buf->row_count ())
+                {
+                    if (m_writer)
+                        m_writer->submit (* this);
+                    else
+                    {
+                        io_lock _ { io_mutex };
+
+                        m_out->write (* m_buf);
+                        m_buf->resize_row_count (0);
+                    }
+                }
+            }
+
+            /*
+             * note: the caller must have flushed this table and drained its writer, if any
+             */
+            VR_ASSUME_COLD void close (boost::mutex * const io_mutex)
+            {
+                if (m_out)
+                {
+                    {
+                        io_lock _ { io_mutex };
+
+                        m_out->close ();
+                        m_out.reset ();
+                    }
+
+                    LOG_info << "  " << print (m_out_file) << ": " << m_row_count << " row(s)";
+                }
+            }
+
+
+            std::unique_ptr<data::dataframe> m_buf;     // being filled by the decoding thread
+            std::unique_ptr<data::dataframe> m_spare;   // being written by 'm_writer' [null if no writer]
+            writer * const m_writer;                    // [optional]
+            std::unique_ptr<io::frame_ostream> m_out { };
+            fs::path m_out_file { };
+            int64_t m_row_count { };
+            itch::message_type::enum_t const m_type;
+            bool m_pending { false };                   // 'm_spare' is queued or being written (protected by writer's mutex)
+
+        }; // end of nested class
+
+
+        /*
+         * the output frames of one partition (in their own subdirectory)
+         */
+        struct partition final
+        {
+            partition (fs::path const & out_dir, boost::mutex * const writer_io_mutex, bool const use_writer) :
+                m_out_dir { out_dir },
+                m_writer { use_writer ? std::make_unique<writer> (writer_io_mutex) : nullptr }
+            {
+                m_tables.fill (nullptr);
+            }
+
+            fs::path const m_out_dir;
+            std::array<table *, 128> m_tables;          // indexed by (ASCII) message type
+            std::unique_ptr<writer> m_writer;           // [null unless "writer_threads" is set]
+
+        }; // end of nested class
+
+
+        ITCH_exporter_base (arg_map const & args) :
+            m_parms
+            {
+                {
+                    { "format",     args.get<io::format> ("format", io::format::HDF) },
+                    { "clobber",    args.get<io::clobber> ("clobber", io::clobber::error) },
+                    { "filter",     args.get<io::filter> ("filter", io::filter::none) }
+                }
+            },
+            m_row_capacity { args.get<int32_t> ("rows", 64 * 1024) },
+            m_pf { args.get<bitset32_t> ("partitions", static_cast<bitset32_t> (-1)) },
+            m_io_mutex { args.get<boost::mutex *> ("io_mutex", nullptr) }
+        {
+            check_positive (m_row_capacity);
+
+            fs::path const out_dir = args.get<fs::path> ("out_dir");
+            bool const writer_threads = args.get<bool> ("writer_threads", false);
+
+            // HDF5 is not thread-safe: if not given an 'io_mutex', the writers of this exporter share one of their own:
+
+            boost::mutex * const writer_io_mutex = ((m_io_mutex || (m_parms.get<io::format> ("format") != io::format::HDF)) ? m_io_mutex : & m_own_io_mutex);
+
+            for (int32_t pix = 0; pix < partition_count (); ++ pix)
+            {
+                m_partitions [pix] = std::make_unique<partition> (out_dir / join_as_name ("P", pix), writer_io_mutex, (writer_threads && pix_included (pix)));
+            }
+        }
+
+        ~ITCH_exporter_base () // flushes if 'close()' hasn't been called
+        {
+            try
+            {
+                close ();
+            }
+            catch (std::exception const & e)
+            {
+                LOG_error << "failure on destruction: " << exc_info (e);
+            }
+
+            for (auto & p : m_partitions) p->m_writer.reset (); // join writers before tables are destroyed
+        }
+
+
+        VR_ASSUME_COLD void close ()
+        {
+            for (auto const & t : m_table_list) t->flush (m_io_mutex);
+
+            for (auto const & p : m_partitions)
+            {
+                if (p->m_writer) p->m_writer->drain ();
+            }
+
+            for (auto const & t : m_table_list) t->close (m_io_mutex);
+        }
+
+
+        VR_FORCEINLINE bool pix_included (int32_t const pix) const
+        {
+            return (m_pf & (1 << pix));
+        }
+
+        /*
+         * @return table for 'type' in partition 'pix', with room for at least one more row
+         */
+        VR_FORCEINLINE table & table_for (int32_t const pix, itch::message_type::enum_t const type)
+        {
+            assert_within (pix, partition_count ());
+
+            partition & p = (* m_partitions [pix]);
+            table * t = p.m_tables [type];
+
+            if (VR_UNLIKELY (t == nullptr))
+                t = open_table (p, type);
+            else if (VR_UNLIKELY (t->m_buf->row_count () == t->m_buf->row_capacity ()))
+                t->flush (m_io_mutex);
+
+            ++ t->m_row_count;
+            return (* t);
+        }
+
+    private: // ..............................................................
+
+        VR_ASSUME_COLD VR_NOINLINE table * open_table (partition & p, itch::message_type::enum_t const type)
+        {
+            m_table_list.emplace_back (std::make_unique<table> (type, m_row_capacity, p.m_writer.get ()));
+            table * const t = m_table_list.back ().get ();
+
+            t->open (p.m_out_dir, m_parms, m_io_mutex);
+            p.m_tables [type] = t;
+
+            return t;
+        }
+
+
+        arg_map const m_parms;                          // passed to 'io::frame_ostream::create()'
+        int32_t const m_row_capacity;
+        bitset32_t const m_pf;
+        boost::mutex * const m_io_mutex;                // [optional]
+        boost::mutex m_own_io_mutex { };                // used by writers if not given 'm_io_mutex' (HDF only)
+        std::array<std::unique_ptr<partition>, partition_count ()> m_partitions { };
+        std::vector<std::unique_ptr<table>> m_table_list { };
+
+}; // end of class
+
+} // end of 'impl'
+//............................................................................
+//............................................................................
+/**
+ * decodes ITCH messages into typed columnar frames (one per partition and exported
+ * message type, see @ref ITCH_export_attributes()) written via @ref io::frame_ostream
+ * into "out_dir"/P<partition>/
+ *
+ * recognized 'args' (in addition to those of 'ITCH_ts_tracker'):
+ *
+ *  "out_dir"       output root directory (required)
+ *  "format"        output format (default: HDF)
+ *  "clobber"       what to do with existing output files (default: error)
+ *  "filter"        HDF compression filter (default: none)
+ *  "rows"          row capacity of each frame buffer (default: 64K)
+ *  "partitions"    mask of partitions to export (default: all)
+ *  "io_mutex"      if set, a 'boost::mutex *' to hold while doing any output I/O (HDF5 is not
+ *                  thread-safe, so this is needed when several exporters run concurrently)
+ *  "writer_threads" if 'true', write each exported partition's full frame buffers on a
+ *                  thread of its own (double-buffered), overlapping output with decoding
+ *                  (default: false)
+ *
+ * @note "seqnum" is the seqnum of the MoldUDP64 packet containing the message
+ */
+template<typename CTX>
+class ITCH_exporter: public impl::ITCH_exporter_base, public ITCH_ts_tracker<CTX, ITCH_exporter<CTX>>
+{
+    private: // ..............................................................
+
+        using super         = ITCH_ts_tracker<CTX, ITCH_exporter<CTX>>;
+
+        vr_static_assert (has_field<_ts_origin_, CTX> ());
+        vr_static_assert (has_field<_ts_local_, CTX> ());
+        vr_static_assert (has_field<_seqnum_, CTX> ());
+
+        using price_type    = this_source_traits::price_type;
+        using qty_type      = this_source_traits::qty_type;
+
+    public: // ...............................................................
+
+        ITCH_exporter (arg_map const & args) :
+            impl::ITCH_exporter_base (args),
+            super (args)
+        {
+        }
+
+        /**
+         * flush and close all output frames
+         */
+        using impl::ITCH_exporter_base::close;
+
+        // overridden ITCH visits:
+
+        using super::visit;
+
+        VR_ASSUME_HOT bool visit (itch::order_book_state const & msg, CTX & ctx) // override
+        {
+            auto const rc = super::visit (msg, ctx); // [chain]
+
+            emit (ctx, msg, itch::book_state::name_to_value (msg.name ()));
+
+            return rc;
+        }
+
+        VR_ASSUME_HOT bool visit (itch::auction_update const & msg, CTX & ctx) // override
+        {
+            auto const rc = super::visit (msg, ctx); // [chain]
+
+            emit (ctx, msg,
+                qty_type { msg.qty ()[side::BID] }, qty_type { msg.qty ()[side::ASK] },
+                price_type { msg.price () },
+                price_type { msg.best_price ()[side::BID] }, price_type { msg.best_price ()[side::ASK] },
+                qty_type { msg.best_qty ()[side::BID] }, qty_type { msg.best_qty ()[side::ASK] });
+
+            return rc;
+        }
+
+        VR_ASSUME_HOT bool visit (itch::order_add const & msg, CTX & ctx) // override
+        {
+            auto const rc = super::visit (msg, ctx); // [chain]
+
+            emit (ctx, msg, oid_t { msg.oid () }, ord_side::to_side (msg.side ()), int32_t { msg.queue_rank () },
+                qty_type { msg.qty () }, price_type { msg.price () }, static_cast<int32_t> (msg.order_attrs ()), static_cast<int32_t> (msg.lot_type ()));
+
+            return rc;
+        }
+
+        VR_ASSUME_HOT bool visit (itch::order_add_with_participant const & msg, CTX & ctx) // override
+        {
+            auto const rc = super::visit (msg, ctx); // [chain]
+
+            emit (ctx, msg, oid_t { msg.oid () }, ord_side::to_side (msg.side ()), int32_t { msg.queue_rank () },
+                qty_type { msg.qty () }, price_type { msg.price () }, static_cast<int32_t> (msg.order_attrs ()), static_cast<int32_t> (msg.lot_type ()));
+
+            return rc;
+        }
+
+        VR_ASSUME_HOT bool visit (itch::order_fill const & msg, CTX & ctx) // override
+        {
+            auto const rc = super::visit (msg, ctx); // [chain]
+
+            emit (ctx, msg, oid_t { msg.oid () }, ord_side::to_side (msg.side ()), qty_type { msg.qty () },
+                int64_t { msg.match ().match () }, int32_t { msg.match ().combo_group () });
+
+            return rc;
+        }
+
+        VR_ASSUME_HOT bool visit (itch::order_fill_with_price const & msg, CTX & ctx) // override
+        {
+            auto const rc = super::visit (msg, ctx); // [chain]
+
+            emit (ctx, msg, oid_t { msg.oid () }, ord_side::to_side (msg.side ()), qty_type { msg.qty () },
+                int64_t { msg.match ().match () }, int32_t { msg.match ().combo_group () },
+                price_type { msg.price () }, to_int (msg.at_auction ()), to_int (msg.printable ()));
+
+            return rc;
+        }
+
+        VR_ASSUME_HOT bool visit (itch::order_replace const & msg, CTX & ctx) // override
+        {
+            auto const rc = super::visit (msg, ctx); // [chain]
+
+            emit (ctx, msg, oid_t { msg.oid () }, ord_side::to_side (msg.side ()), int32_t { msg.queue_rank () },
+                qty_type { msg.qty () }, price_type { msg.price () }, static_cast<int32_t> (msg.order_attrs ()));
+
+            return rc;
+        }
+
+        VR_ASSUME_HOT bool visit (itch::order_delete const & msg, CTX & ctx) // override
+        {
+            auto const rc = super::visit (msg, ctx); // [chain]
+
+            emit (ctx, msg, oid_t { msg.oid () }, ord_side::to_side (msg.side ()));
+
+            return rc;
+        }
+
+        VR_ASSUME_HOT bool visit (itch::trade const & msg, CTX & ctx) // override
+        {
+            auto const rc = super::visit (msg, ctx); // [chain]
+
+            side::enum_t s { data::NA<side::enum_t> () };
+            switch (msg.side ())
+            {
+                case trade_side::BUY:   s = side::BID; break;
+                case trade_side::SELL:  s = side::ASK; break;
+                default: break;
+
+            } // end of switch
+
+            emit (ctx, msg, int64_t { msg.match ().match () }, int32_t { msg.match ().combo_group () }, s,
+                qty_type { msg.qty () }, price_type { msg.price () }, to_int (msg.printable ()), to_int (msg.at_auction ()));
+
+            return rc;
+        }
+
+    private: // ..............................................................
+
+        static VR_FORCEINLINE int32_t to_int (itch::boolean::enum_t const b)
+        {
+            return (b == itch::boolean::yes);
+        }
+
+        /*
+         * note: the column types in 'ITCH_export_attributes()' are matched by the (exact)
+         *       types of 'vs', hence all the explicit conversions by the callers
+         *       (column count and types are checked in debug builds)
+         */
+        template<typename MSG, typename ... Ts>
+        VR_FORCEINLINE void emit (CTX & ctx, MSG const & msg, Ts && ... vs)
+        {
+            int32_t const pix = field<_partition_> (ctx);
+
+            if (pix_included (pix))
+            {
+                table & t = table_for (pix, msg.hdr ().type ());
+
+                t.m_buf->add_row<VR_CHECK_INPUT>
+                (
+                    timestamp_t { field<_ts_origin_> (ctx) },
+                    timestamp_t { field<_ts_local_> (ctx) },
+                    pix,
+                    static_cast<int64_t> (field<_seqnum_> (ctx)),
+                    iid_t { msg.iid () },
+                    std::forward<Ts> (vs) ...
+                );
+            }
+        }
+
+}; // end of class
+
+} // end of 'ASX'
+} // end of 'market'
+} // end of namespace
+//----------------------------------------------------------------------------
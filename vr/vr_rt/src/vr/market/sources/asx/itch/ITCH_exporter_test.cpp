@@ -0,0 +1,322 @@
+#include "vr/market/sources/asx/itch/ITCH_exporter.h"
+
+#include "vr/data/attributes.h"
+#include "vr/data/dataframe.h"
+#include "vr/market/events/market_event_context.h"
+#include "vr/market/net/defs.h" // copy_to_alphanum, fill_alphanum
+
+#include "vr/test/utility.h"
+
+#include <map>
+#include <tuple>
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace market
+{
+namespace ASX
+{
+//............................................................................
+//............................................................................
+namespace
+{
+
+using ctx_type          = market_event_context<_ts_origin_, _partition_, _ts_local_, _seqnum_>;
+using exporter          = ITCH_exporter<ctx_type>;
+
+using row               = std::vector<int64_t>;
+using expected_map      = std::map<std::tuple<int32_t, itch::message_type::enum_t>, std::vector<row>>; // (partition, message type) -> rows
+
+struct cell_reader final // stateless
+{
+    template<data::atype::enum_t ATYPE>
+    VR_FORCEINLINE int64_t operator() (data::atype_<ATYPE>, addr_const_t const col_raw, int64_t const r) const
+    {
+        using data_type             = typename data::atype::traits<ATYPE>::type;
+
+        return static_cast<int64_t> (static_cast<data_type const *> (col_raw)[r]);
+    }
+
+}; // end of class
+//............................................................................
+/*
+ * feeds messages to an 'ITCH_exporter' and records the rows expected for them
+ */
+struct driver final
+{
+    driver (fs::path const & out_dir, bitset32_t const pf, int32_t const rows, bool const writer_threads) :
+        m_exporter { { { "out_dir", out_dir }, { "partitions", pf }, { "rows", rows }, { "writer_threads", writer_threads } } },
+        m_pf { pf }
+    {
+    }
+
+    void start_partition (int32_t const pix, int32_t const ts_sec)
+    {
+        field<_partition_> (m_ctx) = pix;
+
+        itch::seconds msg { };
+        {
+            msg.type () = itch::message_type::seconds;
+            msg.ts_sec () = ts_sec;
+        }
+        m_exporter.visit (msg, m_ctx);
+
+        m_ts_sec = ts_sec;
+    }
+
+    template<typename MSG>
+    void visit (MSG & msg, itch::message_type::enum_t const type, int32_t const ts_ns, iid_t const iid, row const & fields)
+    {
+        msg.hdr ().type () = type;
+        msg.hdr ().ts_ns () = ts_ns;
+        msg.iid () = iid;
+
+        field<_ts_local_> (m_ctx) = (m_ts_local += 1000);
+        field<_seqnum_> (m_ctx) = ++ m_seqnum;
+
+        m_exporter.visit (msg, m_ctx);
+
+        int32_t const pix = field<_partition_> (m_ctx);
+
+        if (m_pf & (1 << pix))
+        {
+            row r { m_ts_sec * _1_second () + ts_ns, m_ts_local, pix, m_seqnum, iid };
+            r.insert (r.end (), fields.begin (), fields.end ());
+
+            m_expected [std::make_tuple (pix, type)].push_back (std::move (r));
+        }
+    }
+
+
+    exporter m_exporter;
+    ctx_type m_ctx { };
+    expected_map m_expected { };
+    bitset32_t const m_pf;
+    timestamp_t m_ts_local { };
+    int64_t m_seqnum { };
+    int32_t m_ts_sec { };
+
+}; // end of class
+
+//............................................................................
+/*
+ * export a few messages of each exported type into two of three partitions and
+ * read them back, using a row capacity that forces several buffer flushes
+ */
+void
+round_trip (bool const writer_threads)
+{
+    constexpr int32_t msg_count     = 5; // per message type and partition
+    constexpr int32_t rows          = 2;
+    constexpr bitset32_t pf         = 0b101; // P1 is visited but not exported
+
+    fs::path const out_dir { test::unique_test_path () };
+
+    std::array<itch::book_state::enum_t, 3> const states { { itch::book_state::PRE_OPEN, itch::book_state::OPEN, itch::book_state::CLOSE } };
+
+    expected_map expected { };
+    {
+        driver d { out_dir, pf, rows, writer_threads };
+
+        for (int32_t pix = 0; pix < 3; ++ pix)
+        {
+            d.start_partition (pix, 36000 + pix);
+
+            for (int32_t i = 0; i < msg_count; ++ i)
+            {
+                iid_t const iid = 100 * (pix + 1) + i;
+                int32_t ts_ns = 1000 * i;
+
+                int64_t const oid = 1000000 * (pix + 1) + i;
+                int64_t const match = 2000000 * (pix + 1) + i;
+                int32_t const price = 10000 + 10 * i;
+                int64_t const qty = 100 + i;
+
+                ord_side::enum_t const os = (i % 2 ? ord_side::SELL : ord_side::BUY);
+                int64_t const s = ord_side::to_side (os);
+
+                {
+                    itch::book_state::enum_t const st = states [i % states.size ()];
+
+                    itch::order_book_state msg { };
+                    {
+                        fill_alphanum<' '> (msg.name ()); // right-padded with spaces
+                        copy_to_alphanum (itch::book_state::name (st), msg.name ());
+                    }
+
+                    d.visit (msg, itch::message_type::order_book_state, ++ ts_ns, iid, { st });
+                }
+                {
+                    itch::auction_update msg { };
+                    {
+                        msg.qty ()[side::BID] = qty;
+                        msg.qty ()[side::ASK] = qty + 1;
+                        msg.price () = price;
+                        msg.best_price ()[side::BID] = price - 1;
+                        msg.best_price ()[side::ASK] = price + 1;
+                        msg.best_qty ()[side::BID] = qty + 2;
+                        msg.best_qty ()[side::ASK] = qty + 3;
+                    }
+
+                    d.visit (msg, itch::message_type::auction_update, ++ ts_ns, iid, { qty, qty + 1, price, price - 1, price + 1, qty + 2, qty + 3 });
+                }
+                {
+                    itch::order_add msg { };
+                    {
+                        msg.oid () = oid;
+                        msg.side () = os;
+                        msg.queue_rank () = i + 1;
+                        msg.qty () = qty;
+                        msg.price () = price;
+                        msg.order_attrs () = 0x10 + i;
+                        msg.lot_type () = itch::ord_lot_type::round;
+                    }
+
+                    d.visit (msg, itch::message_type::order_add, ++ ts_ns, iid, { oid, s, i + 1, qty, price, 0x10 + i, itch::ord_lot_type::round });
+                }
+                {
+                    itch::order_add_with_participant msg { };
+                    {
+                        msg.oid () = oid + 1;
+                        msg.side () = os;
+                        msg.queue_rank () = i + 2;
+                        msg.qty () = qty;
+                        msg.price () = price;
+                        msg.order_attrs () = 0x20 + i;
+                        msg.lot_type () = itch::ord_lot_type::odd;
+                        copy_to_alphanum ("BRKR", msg.participant ());
+                    }
+
+                    d.visit (msg, itch::message_type::order_add_with_participant, ++ ts_ns, iid, { oid + 1, s, i + 2, qty, price, 0x20 + i, itch::ord_lot_type::odd });
+                }
+                {
+                    itch::order_fill msg { };
+                    {
+                        msg.oid () = oid;
+                        msg.side () = os;
+                        msg.qty () = qty - 1;
+                        msg.match ().match () = match;
+                        msg.match ().combo_group () = i;
+                    }
+
+                    d.visit (msg, itch::message_type::order_fill, ++ ts_ns, iid, { oid, s, qty - 1, match, i });
+                }
+                {
+                    itch::order_fill_with_price msg { };
+                    {
+                        msg.oid () = oid + 1;
+                        msg.side () = os;
+                        msg.qty () = qty - 2;
+                        msg.match ().match () = match + 1;
+                        msg.match ().combo_group () = i + 1;
+                        msg.price () = price + 5;
+                        msg.at_auction () = (i % 2 ? itch::boolean::yes : itch::boolean::no);
+                        msg.printable () = (i % 2 ? itch::boolean::no : itch::boolean::yes);
+                    }
+
+                    d.visit (msg, itch::message_type::order_fill_with_price, ++ ts_ns, iid, { oid + 1, s, qty - 2, match + 1, i + 1, price + 5, (i % 2), ! (i % 2) });
+                }
+                {
+                    itch::order_replace msg { };
+                    {
+                        msg.oid () = oid;
+                        msg.side () = os;
+                        msg.queue_rank () = i + 3;
+                        msg.qty () = qty + 10;
+                        msg.price () = price - 5;
+                        msg.order_attrs () = 0x30 + i;
+                    }
+
+                    d.visit (msg, itch::message_type::order_replace, ++ ts_ns, iid, { oid, s, i + 3, qty + 10, price - 5, 0x30 + i });
+                }
+                {
+                    itch::order_delete msg { };
+                    {
+                        msg.oid () = oid;
+                        msg.side () = os;
+                    }
+
+                    d.visit (msg, itch::message_type::order_delete, ++ ts_ns, iid, { oid, s });
+                }
+                {
+                    itch::trade msg { };
+                    {
+                        msg.match ().match () = match + 2;
+                        msg.match ().combo_group () = i + 2;
+                        msg.side () = (i % 2 ? trade_side::SELL : trade_side::BUY);
+                        msg.qty () = qty + 20;
+                        msg.price () = price + 10;
+                        msg.printable () = itch::boolean::yes;
+                        msg.at_auction () = itch::boolean::no;
+                    }
+
+                    d.visit (msg, itch::message_type::trade, ++ ts_ns, iid, { match + 2, i + 2, s, qty + 20, price + 10, 1, 0 });
+                }
+            }
+        }
+
+        d.m_exporter.close ();
+
+        expected = std::move (d.m_expected);
+    }
+
+    ASSERT_EQ (signed_cast (expected.size ()), 2 * 9); // (exported partitions) x (exported message types)
+    EXPECT_FALSE (fs::exists (out_dir / "P1"));
+
+    for (auto const & kv : expected)
+    {
+        int32_t const pix = std::get<0> (kv.first);
+        itch::message_type::enum_t const type = std::get<1> (kv.first);
+        std::vector<row> const & rows_expected = kv.second;
+
+        std::vector<data::attribute> const & attrs = ITCH_export_attributes (type);
+        ASSERT_EQ (signed_cast (attrs.size ()), signed_cast (rows_expected.front ().size ())) << "type " << print (type);
+
+        fs::path const file = out_dir / join_as_name ("P", pix) / print (type);
+        LOG_trace1 << "reading " << print (file);
+
+        std::unique_ptr<io::frame_istream> const in = io::frame_istream::open (file, { { "format", io::format::HDF } });
+
+        data::dataframe df { 4, attrs };
+
+        int64_t row_count { };
+        for (int64_t rc; (rc = in->read (df)) > 0; row_count += rc)
+        {
+            ASSERT_LE (row_count + rc, signed_cast (rows_expected.size ())) << "P" << pix << ", type " << print (type);
+
+            for (int64_t r = 0; r < rc; ++ r)
+            {
+                row const & r_expected = rows_expected [row_count + r];
+
+                for (int32_t c = 0; c < signed_cast (attrs.size ()); ++ c)
+                {
+                    int64_t const v = data::dispatch_on_atype (attrs [c].atype (), cell_reader { }, df.at_raw<false> (c), r);
+
+                    EXPECT_EQ (v, r_expected [c]) << "P" << pix << ", type " << print (type) << ", row " << (row_count + r) << ", column " << print (attrs [c].name ());
+                }
+            }
+        }
+
+        EXPECT_EQ (row_count, signed_cast (rows_expected.size ())) << "P" << pix << ", type " << print (type);
+    }
+}
+
+} // end of anonymous
+//............................................................................
+//............................................................................
+
+TEST (ITCH_exporter, round_trip)
+{
+    round_trip (false);
+}
+
+TEST (ITCH_exporter, round_trip_writer_threads)
+{
+    round_trip (true);
+}
+
+} // end of 'ASX'
+} // end of 'market'
+} // end of namespace
+//----------------------------------------------------------------------------
@@ -5,6 +5,8 @@
 #include "vr/fields.h"
 #include "vr/market/sources/asx/itch/ITCH_visitor.h"
 #include "vr/market/sources/asx/itch/messages_io.h" // print_message()
+#include "vr/util/name_filter_factory.h"
+#include "vr/util/parse.h" // rtrim()
 
 #include <set>
 
@@ -54,6 +56,14 @@ class ITCH_message_filter: public ITCH_visitor<ITCH_message_filter<CTX> >
 //............................................................................
 /**
  * filter by '_iid_' field
+ *
+ * the set of iids to pass through is given either explicitly ("instruments") or as
+ * a @ref util::name_filter_factory spec over symbols ("symbols"), or both (in which case
+ * their union passes); the latter is resolved into the same iid table as '[combo_]order_book_dir'
+ * messages arrive (which happens once per instrument per session, so per-message cost
+ * is the same single table lookup in both cases)
+ *
+ * @note with "symbols", messages for instruments whose directory messages haven't been seen are filtered out
  */
 template<typename CTX>
 class ITCH_iid_filter: public ITCH_visitor<ITCH_iid_filter<CTX> >
@@ -67,17 +77,23 @@ class ITCH_iid_filter: public ITCH_visitor<ITCH_iid_filter<CTX> >
         ITCH_iid_filter (arg_map const & args)
         {
             auto const & iids = args.get<std::set<int64_t> > ("instruments", std::set<int64_t> { });
+            std::string const & symbols = args.get<std::string> ("symbols", std::string { });
 
-            if (! iids.empty ())
+            if (! symbols.empty ())
             {
-                m_iid_set = std::make_unique<iid_set> (static_cast<typename iid_set::size_type> (iids.size ()));
+                m_symbol_filter = util::name_filter_factory::create (symbols);
+            }
+
+            if (! iids.empty () || m_symbol_filter)
+            {
+                m_iid_set = std::make_unique<iid_set> (std::max<typename iid_set::size_type> (iids.size (), (m_symbol_filter ? 1024 : 0)));
 
                 for (iid_t const & iid : iids)
                 {
-                    m_iid_set->put (iid, true); // TODO actual value not used
+                    m_iid_set->put (iid, true);
                 }
 
-                m_iid_set->rehash (iids.size ()); // trim to fit
+                if (! m_symbol_filter) m_iid_set->rehash (iids.size ()); // trim to fit
             }
         }
 
@@ -92,7 +108,7 @@ class ITCH_iid_filter: public ITCH_visitor<ITCH_iid_filter<CTX> >
          */
         VR_FORCEINLINE bool visit (pre_message const msg_type, addr_const_t const msg, CTX & ctx) // override
         {
-            iid_set const * const m = m_iid_set.get ();
+            iid_set * const m = m_iid_set.get ();
             if (m == nullptr) return true; // "all"
 
             itch::message_type::enum_t const mt = static_cast<itch::message_type::enum_t> (static_cast<int32_t> (msg_type));
@@ -102,7 +118,14 @@ class ITCH_iid_filter: public ITCH_visitor<ITCH_iid_filter<CTX> >
 
             typename iid_set::key_type const iid = (* static_cast<iid_ft const *> (addr_plus (msg, iid_offset)));
 
-            bool const rc = (m->get (iid) != nullptr);
+            if (VR_UNLIKELY ((mt == itch::message_type::order_book_dir) | (mt == itch::message_type::combo_order_book_dir)) && m_symbol_filter)
+            {
+                resolve (* m, iid, * static_cast<itch::order_book_dir const *> (msg));
+            }
+
+            bool const * const v = m->get (iid);
+
+            bool const rc = ((v != nullptr) && (* v));
             VR_IF_DEBUG (if (rc) DLOG_trace3 << "iid " << iid << ": " << itch::print_message (mt, msg);) // display what's filtered through, message-specific only (all of traffic can always be traced via "parsing.h")
             return rc;
         }
@@ -112,7 +135,20 @@ class ITCH_iid_filter: public ITCH_visitor<ITCH_iid_filter<CTX> >
         // TODO support 'V' = void in fast hashtables (ASX-31):
         using iid_set       = util::chained_scatter_table<oid_t, bool, util::identity_hash<oid_t> >;
 
+        VR_ASSUME_COLD void resolve (iid_set & m, typename iid_set::key_type const iid, itch::order_book_dir const & msg) const
+        {
+            if (m.get (iid) != nullptr) return; // explicit iids take precedence, repeated dir messages are ignored
+
+            std::string const symbol = util::rtrim (msg.symbol ()).to_string ();
+            bool const rc = m_symbol_filter (symbol);
+
+            LOG_trace1 << "iid " << iid << " (" << print (symbol) << "): " << (rc ? "included" : "excluded");
+
+            m.put (iid, rc);
+        }
+
 
+        name_filter m_symbol_filter { }; // empty unless "symbols" was specified
         std::unique_ptr<iid_set> m_iid_set { }; // TODO parent cls needs to be movable
 
 }; // end of class
@@ -4,6 +4,7 @@
 #include "vr/io/net/defs.h" // _packet_index_, _src/dst_port_
 #include "vr/market/net/MoldUDP64_.h"
 #include "vr/market/sources/asx/defs.h" // _partition_, partition_count(), impl::seqnum_state
+#include "vr/market/sources/asx/itch/Mold_rewind_client.h"
 #include "vr/util/logging.h"
 
 //----------------------------------------------------------------------------
@@ -17,6 +18,19 @@ namespace ASX
  * extension of 'MoldUDP64_' that overrides only 'visit_MoldUDP64_payload()'
  * and adds seqnum checking logic
  *
+ * if constructed with a "rewinder" arg (a @ref Mold_rewind_client), seqnum gaps are
+ * also recovered from: packets that arrive ahead of a gap are buffered (per partition,
+ * other partitions continue to be visited), missing seqnums are requested from the
+ * rewinder and the recovered messages are spliced back in seqnum order; the caller needs
+ * to call @ref poll_rewinder() in its event loop for this to make progress
+ *
+ * a gap that the rewinder reports as expired (open for too long, or too much data buffered
+ * behind it) is declared lost: its messages are skipped and the buffered packets are visited
+ *
+ * @note spliced messages are visited with the 'CTX' of the packet that closed the gap
+ *       (or the one passed into @ref poll_rewinder()), i.e. non-Mold 'CTX' fields such
+ *       as local timestamps are not those of the original packets
+ *
  * @note you only need to use non-void 'DERIVED' if you're overriding MoldUDP64 visits
  */
 template<typename ENCAPSULATED, typename DERIVED = void> // a slight twist on CRTP
@@ -31,6 +45,72 @@ class Mold_frame_: public impl::seqnum_state, public MoldUDP64_<ENCAPSULATED, ut
 
         using super::super; // inherit constructors
 
+        /**
+         * @param args optional: "rewinder" -> Mold_rewind_client * (enables gap recovery)
+         */
+        Mold_frame_ (arg_map const & args) :
+            super (args),
+            m_rewinder { args.get<Mold_rewind_client *> ("rewinder", nullptr) }
+        {
+        }
+
+        // ACCESSORs:
+
+        /**
+         * @return bitmask of partitions currently recovering from a seqnum gap
+         */
+        int32_t const & gap_mask () const
+        {
+            return m_gap_mask;
+        }
+
+        // MUTATORs:
+
+        /**
+         * visit any messages recovered by the rewinder so far (a no-op unless some partition
+         * has a gap in progress; re-issues timed out requests)
+         *
+         * @return number of recovered packets received
+         */
+        template<typename CTX>
+        int32_t poll_rewinder (CTX & ctx)
+        {
+            if (VR_LIKELY (! m_gap_mask)) return 0;
+
+            assert_nonnull (m_rewinder);
+
+            int32_t r { };
+
+            for (int32_t pix = 0; pix < partition_count (); ++ pix)
+            {
+                if (! (m_gap_mask & (1 << pix))) continue;
+
+                if (has_field<_partition_, CTX> ())
+                {
+                    field<_partition_> (ctx) = pix;
+                }
+
+                r += m_rewinder->poll (pix, [this, & ctx, pix](MoldUDP64_recv_packet_hdr const & packet_hdr)
+                    {
+                        splice_packet (ctx, pix, packet_hdr, packet_hdr.msg_count (), addr_plus (& packet_hdr, sizeof (MoldUDP64_recv_packet_hdr)));
+                    });
+
+                if (m_gap_mask & (1 << pix)) // still open: give up on it or re-request if the last request has timed out
+                {
+                    if (VR_UNLIKELY (m_rewinder->expired (pix)))
+                    {
+                        drain (ctx, pix, true);
+                        continue;
+                    }
+
+                    seqnum_t const sn = m_seqnum_expected [pix];
+                    m_rewinder->request (pix, sn, m_rewinder->front (pix).seqnum () - sn);
+                }
+            }
+
+            return r;
+        }
+
 
         // MoldUDP64_:
 
@@ -86,16 +166,22 @@ class Mold_frame_: public impl::seqnum_state, public MoldUDP64_<ENCAPSULATED, ut
                 seqnum_t & sn = m_seqnum_expected [pix];
                 seqnum_t const sn_expected = sn;
 
-                sn = sn_incoming + msg_count; // always set the next expectation
-
-                if (VR_UNLIKELY (sn_incoming != sn_expected))
+                if (VR_UNLIKELY ((sn_incoming != sn_expected) | ((m_gap_mask >> pix) & 1)))
                 {
                     if (VR_LIKELY (sn_expected != 0)) // initial condition guard
                     {
+                        if (m_rewinder != nullptr) // gap recovery is enabled
+                        {
+                            splice_packet (ctx, pix, packet_hdr, msg_count, data);
+                            return;
+                        }
+
                         LOG_warn << "[P" << pix << ", " << print_timestamp (field<_ts_> (ctx)) << "] seqnum GAP (" << (sn_incoming - sn_expected) << "): " << sn_incoming << ", expected " << sn_expected;
                     }
                 }
 
+                sn = sn_incoming + msg_count; // always set the next expectation
+
                 DLOG_trace1 << "  [P" << pix << ", sn " << sn_expected << " -> " << sn << ", " << print_timestamp (field<_ts_> (ctx)) << "] Mold msg count " << msg_count;
             }
             else
@@ -115,6 +201,15 @@ class Mold_frame_: public impl::seqnum_state, public MoldUDP64_<ENCAPSULATED, ut
              *        to have to keep passing the return codes through, so changed the design to use the MoldUDP
              *        header length after all:
              */
+            visit_messages (ctx, msg_count, data);
+        }
+
+    private: // ..............................................................
+
+        template<typename CTX>
+        VR_FORCEINLINE void
+        visit_messages (CTX & ctx, int32_t const msg_count, addr_const_t/* MoldUDP64_recv_message_hdr */data)
+        {
             ENCAPSULATED::_internal_packet_mark (pre_packet { msg_count }, ctx);
             {
                 for (int32_t m = 0; m < msg_count; ++ m)
@@ -131,6 +226,124 @@ class Mold_frame_: public impl::seqnum_state, public MoldUDP64_<ENCAPSULATED, ut
             ENCAPSULATED::_internal_packet_mark (post_packet { msg_count }, ctx);
         }
 
+        /*
+         * visit the part of a packet that starts at or before the next expected seqnum in 'pix'
+         * (dropping any messages that have already been visited)
+         */
+        template<typename CTX>
+        void
+        apply_packet (CTX & ctx, int32_t const pix, seqnum_t const sn_incoming, int32_t const msg_count, addr_const_t/* MoldUDP64_recv_message_hdr */data)
+        {
+            seqnum_t & sn = m_seqnum_expected [pix];
+            assert_le (sn_incoming, sn, pix);
+
+            int32_t const skip_count = (sn - sn_incoming);
+            if (skip_count >= msg_count) // a duplicate
+                return;
+
+            for (int32_t m = 0; m < skip_count; ++ m)
+            {
+                data = addr_plus (data, sizeof (MoldUDP64_recv_message_hdr) + static_cast<MoldUDP64_recv_message_hdr const *> (data)->length ());
+            }
+
+            if (has_field<_seqnum_, CTX> ())
+            {
+                field<_seqnum_> (ctx) = sn;
+            }
+
+            sn = sn_incoming + msg_count;
+
+            visit_messages (ctx, msg_count - skip_count, data);
+        }
+
+        /*
+         * handle a packet that is out of sequence (or arrived while 'pix' has a gap open)
+         */
+        template<typename CTX>
+        VR_NOINLINE void
+        splice_packet (CTX & ctx, int32_t const pix, MoldUDP64_recv_packet_hdr const & packet_hdr, int32_t const msg_count, addr_const_t/* MoldUDP64_recv_message_hdr */const data)
+        {
+            using _ts_          = select_display_ts_t<CTX>;
+
+            seqnum_t & sn = m_seqnum_expected [pix];
+            seqnum_t const sn_incoming = packet_hdr.seqnum ();
+
+            if (sn_incoming > sn) // ahead of a gap: buffer and (re-)request the missing range
+            {
+                int32_t payload_size { };
+                for (int32_t m = 0; m < msg_count; ++ m)
+                {
+                    payload_size += sizeof (MoldUDP64_recv_message_hdr) + static_cast<MoldUDP64_recv_message_hdr const *> (addr_plus (data, payload_size))->length ();
+                }
+
+                if (! (m_gap_mask & (1 << pix)))
+                {
+                    LOG_warn << "[P" << pix << ", " << print_timestamp (field<_ts_> (ctx)) << "] seqnum GAP (" << (sn_incoming - sn) << "): " << sn_incoming << ", expected " << sn << ", requesting retransmission";
+                    m_gap_mask |= (1 << pix);
+                }
+
+                m_rewinder->buffer (pix, & packet_hdr, sizeof (MoldUDP64_recv_packet_hdr) + payload_size);
+
+                if (VR_UNLIKELY (m_rewinder->expired (pix)))
+                    drain (ctx, pix, true);
+                else
+                    m_rewinder->request (pix, sn, m_rewinder->front (pix).seqnum () - sn);
+
+                return;
+            }
+
+            apply_packet (ctx, pix, sn_incoming, msg_count, data);
+
+            if (! (m_gap_mask & (1 << pix))) // a stale duplicate while not recovering
+                return;
+
+            drain (ctx, pix, false);
+        }
+
+        /*
+         * visit buffered packets that are now in sequence, closing the gap in 'pix' if that
+         * empties the buffer; if 'skip_gaps' is set, any seqnums still missing are declared lost
+         */
+        template<typename CTX>
+        void
+        drain (CTX & ctx, int32_t const pix, bool const skip_gaps)
+        {
+            using _ts_          = select_display_ts_t<CTX>;
+
+            seqnum_t & sn = m_seqnum_expected [pix];
+
+            while (! m_rewinder->empty (pix))
+            {
+                MoldUDP64_recv_packet_hdr const & front = m_rewinder->front (pix);
+
+                if (front.seqnum () > sn) // still a gap
+                {
+                    if (! skip_gaps)
+                    {
+                        m_rewinder->request (pix, sn, front.seqnum () - sn);
+                        return;
+                    }
+
+                    LOG_error << "[P" << pix << ", " << print_timestamp (field<_ts_> (ctx)) << "] seqnum GAP (" << (front.seqnum () - sn) << ") at " << sn << " not recovered, skipping to " << front.seqnum ();
+
+                    m_rewinder->declare_lost (pix, front.seqnum () - sn);
+                    sn = front.seqnum ();
+                }
+
+                apply_packet (ctx, pix, front.seqnum (), front.msg_count (), addr_plus (& front, sizeof (MoldUDP64_recv_packet_hdr)));
+                m_rewinder->pop_front (pix);
+            }
+
+            LOG_info << "[P" << pix << ", " << print_timestamp (field<_ts_> (ctx)) << "] seqnum gap closed at " << sn;
+
+            m_gap_mask &= ~(1 << pix);
+            m_rewinder->reset (pix);
+        }
+
+
+        Mold_rewind_client * const m_rewinder { };  // [optional]
+        int32_t m_gap_mask { };                     // bit 'p' is set iff partition 'p' has a gap open
+
 }; // end of class
 
 } // end of 'ASX'
@@ -0,0 +1,276 @@
+
+#include "vr/market/sources/asx/itch/Mold_frame_.h"
+
+#include "vr/market/events/market_event_context.h"
+#include "vr/market/sources/asx/itch/ITCH_visitor.h"
+#include "vr/market/sources/mock/asx/mock_Mold_rewinder.h"
+#include "vr/sys/os.h"
+#include "vr/util/random.h"
+
+#include "vr/test/utility.h"
+
+#include <algorithm>
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace market
+{
+namespace ASX
+{
+//............................................................................
+//............................................................................
+namespace
+{
+
+using visit_ctx         = market_event_context<_ts_origin_, _partition_, _seqnum_>;
+
+/*
+ * records 'seconds.ts_sec' values visited in each partition (the test packets
+ * below set those to their Mold seqnums)
+ */
+class seqnum_recorder: public ITCH_visitor<seqnum_recorder>
+{
+    private: // ..............................................................
+
+        using super         = ITCH_visitor<seqnum_recorder>;
+
+    public: // ...............................................................
+
+        seqnum_recorder (arg_map const & args) :
+            super (args)
+        {
+        }
+
+        using super::visit;
+
+        bool visit (itch::seconds const & msg, visit_ctx & ctx) // override
+        {
+            m_visited [field<_partition_> (ctx)].push_back (msg.ts_sec ());
+            return true;
+        }
+
+        std::array<std::vector<mold_seqnum_t>, partition_count ()> m_visited { };
+
+}; // end of class
+
+using visitor           = Mold_frame_<seqnum_recorder>;
+
+//............................................................................
+
+std::string
+make_packet (mold_seqnum_t const sn, int32_t const msg_count)
+{
+    std::string r (sizeof (MoldUDP64_recv_packet_hdr) + msg_count * (sizeof (MoldUDP64_recv_message_hdr) + sizeof (itch::seconds)), '\0');
+
+    MoldUDP64_recv_packet_hdr & hdr = * reinterpret_cast<MoldUDP64_recv_packet_hdr *> (& r [0]);
+    {
+        std::memcpy (hdr.session ().data (), "TEST000001", hdr.session ().size ());
+        hdr.seqnum () = sn;
+        hdr.msg_count () = msg_count;
+    }
+
+    addr_t m = addr_plus (& hdr, sizeof (hdr));
+
+    for (int32_t i = 0; i < msg_count; ++ i)
+    {
+        static_cast<MoldUDP64_recv_message_hdr *> (m)->length () = sizeof (itch::seconds);
+        m = addr_plus (m, sizeof (MoldUDP64_recv_message_hdr));
+
+        itch::seconds & msg = * static_cast<itch::seconds *> (m);
+        {
+            msg.type () = itch::message_type::seconds;
+            msg.ts_sec () = sn + i;
+        }
+        m = addr_plus (m, sizeof (itch::seconds));
+    }
+
+    return r;
+}
+
+} // end of anonymous
+//............................................................................
+//............................................................................
+/*
+ * publish interleaved packets in all partitions, randomly dropping some of them (in bursts),
+ * and check that 'Mold_frame_' recovers every message exactly once and in seqnum order via a
+ * 'Mold_rewind_client' talking to a local 'mock_Mold_rewinder' over loopback UDP
+ */
+TEST (Mold_frame_, gap_recovery)
+{
+    uint64_t rnd = test::env::random_seed<uint64_t> ();
+
+    constexpr int32_t packet_count      = 20000; // per partition
+    constexpr int32_t drop_pct          = 5;
+    constexpr int32_t port_base         = 22601;
+
+    mock_Mold_rewinder server { { { "port_base", port_base } } };
+    Mold_rewind_client client { { { "server", std::string { "127.0.0.1" } }, { "port_base", port_base }, { "timeout", 5 * _1_millisecond () }, { "max_request", 64 } } };
+
+    visitor v { { { "rewinder", & client } } };
+
+    for (int32_t pix = 0; pix < partition_count (); ++ pix)
+    {
+        v.seqnums ()[pix] = 1; // so that a drop of the very first packet is detected as well
+    }
+
+    std::array<mold_seqnum_t, partition_count ()> sn_next = meta::create_array_fill<mold_seqnum_t, partition_count (), 1> ();
+    std::array<int32_t, partition_count ()> packets_left = meta::create_array_fill<int32_t, partition_count (), packet_count> ();
+    std::array<int32_t, partition_count ()> burst_left = meta::create_array_fill<int32_t, partition_count (), 0> ();
+
+    int64_t dropped_count { };
+    timestamp_t const ts_start = sys::realtime_utc ();
+
+    for (int32_t remaining = partition_count () * packet_count; remaining > 0; )
+    {
+        int32_t const pix = unsigned_cast (util::xorshift (rnd)) % partition_count ();
+        if (! packets_left [pix]) continue;
+
+        int32_t const msg_count = 1 + unsigned_cast (util::xorshift (rnd)) % 4;
+        std::string const packet = make_packet (sn_next [pix], msg_count);
+
+        sn_next [pix] += msg_count;
+        -- packets_left [pix];
+        -- remaining;
+
+        server.record (pix, packet.data (), packet.size ());
+
+        if ((burst_left [pix] == 0) && (packets_left [pix] > 0) && (unsigned_cast (util::xorshift (rnd)) % 100 < drop_pct)) // start a burst of drops (but never drop the last packet)
+        {
+            burst_left [pix] = 1 + unsigned_cast (util::xorshift (rnd)) % 8;
+        }
+
+        if (burst_left [pix] > 0)
+        {
+            -- burst_left [pix];
+            if (packets_left [pix] > 0)
+            {
+                ++ dropped_count;
+                continue;
+            }
+        }
+
+        visit_ctx ctx { };
+        field<_partition_> (ctx) = pix;
+
+        v.visit_data (ctx, packet.data (), packet.size ());
+
+        server.poll ();
+        v.poll_rewinder (ctx);
+    }
+
+    // finish recovering any gaps still open:
+
+    timestamp_t const ts_limit = sys::realtime_utc () + 10 * _1_second ();
+
+    while (v.gap_mask () && (sys::realtime_utc () < ts_limit))
+    {
+        visit_ctx ctx { };
+
+        server.poll ();
+        v.poll_rewinder (ctx);
+    }
+
+    timestamp_t const ts_end = sys::realtime_utc ();
+
+    LOG_info << "dropped " << dropped_count << " packet(s), recovered via " << client.request_count () << " request(s) (" << client.recv_count ()
+             << " packet(s) received, " << server.resend_count () << " resent) in " << (ts_end - ts_start) / _1_millisecond () << " ms";
+
+    ASSERT_EQ (0, v.gap_mask ());
+    EXPECT_GT (dropped_count, 0);
+
+    for (int32_t pix = 0; pix < partition_count (); ++ pix)
+    {
+        std::vector<mold_seqnum_t> const & visited = v.m_visited [pix];
+
+        ASSERT_EQ (sn_next [pix] - 1, signed_cast (visited.size ())) << "P" << pix;
+
+        for (int32_t i = 0, i_limit = visited.size (); i < i_limit; ++ i)
+        {
+            ASSERT_EQ (i + 1, visited [i]) << "P" << pix << ": wrong message at position " << i;
+        }
+
+        EXPECT_EQ (sn_next [pix], v.seqnums ()[pix]) << "P" << pix;
+    }
+}
+
+//............................................................................
+/*
+ * a rewinder that never answers: gaps must be given up on once they expire (by
+ * age in P0, by buffered size in P1), with the messages buffered behind them
+ * still visited in seqnum order
+ */
+TEST (Mold_frame_, gap_lost)
+{
+    constexpr int32_t port_base         = 22701;
+    constexpr timestamp_t max_gap_age   = 20 * _1_millisecond ();
+    constexpr int32_t max_buffered      = 1024;
+
+    mock_Mold_rewinder server { { { "port_base", port_base } } }; // never polled
+    Mold_rewind_client client { { { "server", std::string { "127.0.0.1" } }, { "port_base", port_base }, { "max_gap_age", max_gap_age }, { "max_buffered", max_buffered } } };
+
+    visitor v { { { "rewinder", & client } } };
+
+    for (int32_t pix = 0; pix < 2; ++ pix)
+    {
+        v.seqnums ()[pix] = 1;
+    }
+
+    auto const visit = [& v](int32_t const pix, mold_seqnum_t const sn, int32_t const msg_count)
+        {
+            std::string const packet = make_packet (sn, msg_count);
+
+            visit_ctx ctx { };
+            field<_partition_> (ctx) = pix;
+
+            v.visit_data (ctx, packet.data (), packet.size ());
+        };
+
+    // P0: [1, 3), gap [3, 5), [5, 7):
+
+    visit (0, 1, 2);
+    visit (0, 5, 2);
+
+    ASSERT_EQ (0b01, v.gap_mask ());
+
+    sys::short_sleep_for (2 * max_gap_age);
+    {
+        visit_ctx ctx { };
+        v.poll_rewinder (ctx);
+    }
+
+    ASSERT_EQ (0, v.gap_mask ());
+    EXPECT_EQ (2, client.lost_count ());
+    EXPECT_EQ ((std::vector<mold_seqnum_t> { 1, 2, 5, 6 }), v.m_visited [0]);
+    EXPECT_EQ (7, v.seqnums ()[0]);
+
+    // P1: [1, 2), gap [2, 3), then single-message packets until 'max_buffered' is exceeded:
+
+    visit (1, 1, 1);
+
+    mold_seqnum_t sn = 3;
+    do
+    {
+        ASSERT_LT (sn, max_buffered) << "gap not given up on";
+
+        visit (1, sn ++, 1);
+    }
+    while (v.gap_mask ());
+
+    EXPECT_EQ (3, client.lost_count ());
+    EXPECT_TRUE (client.empty (1));
+
+    std::vector<mold_seqnum_t> const & visited = v.m_visited [1];
+
+    ASSERT_EQ (sn - 2, signed_cast (visited.size ()));
+    EXPECT_EQ (1, visited.front ());
+    for (int32_t i = 1, i_limit = visited.size (); i < i_limit; ++ i)
+    {
+        ASSERT_EQ (i + 2, visited [i]) << "P1: wrong message at position " << i;
+    }
+}
+
+} // end of 'ASX'
+} // end of 'market'
+} // end of namespace
+//----------------------------------------------------------------------------
@@ -0,0 +1,152 @@
+
+#include "vr/market/sources/asx/itch/Mold_rewind_client.h"
+
+#include "vr/sys/os.h"
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace market
+{
+namespace ASX
+{
+
+Mold_rewind_client::Mold_rewind_client (arg_map const & args) :
+    m_timeout { args.get<timestamp_t> ("timeout", 50 * _1_millisecond ()) },
+    m_max_gap_age { args.get<timestamp_t> ("max_gap_age", 2 * _1_second ()) },
+    m_max_buffered { args.get<int64_t> ("max_buffered", 32 * 1024 * 1024) },
+    m_max_request { args.get<int32_t> ("max_request", 0x7FFF) }
+{
+    std::string const & server = args.get<std::string> ("server");
+    int32_t const port_base = args.get<int32_t> ("port_base");
+
+    check_positive (m_timeout);
+    check_positive (m_max_gap_age);
+    check_positive (m_max_buffered);
+    check_in_inclusive_range (m_max_request, 1, 0x7FFF); // 'MoldUDP64_rewind_request::msg_count' is a signed 16-bit field
+
+    for (int32_t pix = 0; pix < partition_count (); ++ pix)
+    {
+        m_partitions [pix].m_link = std::make_unique<link_impl> (server, string_cast (port_base + pix),
+            io::recv_arg_map { { "capacity", itch_rewind_link_capacity () } },
+            io::send_arg_map { { "capacity", itch_rewind_link_capacity () } });
+    }
+
+    LOG_trace1 << "connected to rewinder " << print (server) << ", port base " << port_base;
+}
+
+Mold_rewind_client::~Mold_rewind_client ()
+{
+    LOG_trace1 << "sent " << m_request_count << " rewind request(s), received " << m_recv_count << " packet(s)";
+
+    if (m_lost_count | m_malformed_count)
+    {
+        LOG_warn << "gave up on " << m_lost_count << " message(s), dropped " << m_malformed_count << " malformed datagram(s)";
+    }
+}
+//............................................................................
+
+bool
+Mold_rewind_client::expired (int32_t const pix) const
+{
+    assert_within (pix, partition_count ());
+
+    partition const & p = m_partitions [pix];
+
+    return ((p.m_buffered_size > m_max_buffered) || (p.m_gap_ts && (sys::realtime_utc () - p.m_gap_ts > m_max_gap_age)));
+}
+//............................................................................
+
+void
+Mold_rewind_client::buffer (int32_t const pix, addr_const_t const packet, int32_t const size)
+{
+    assert_within (pix, partition_count ());
+    assert_le (static_cast<int32_t> (sizeof (MoldUDP64_recv_packet_hdr)), size);
+
+    seqnum_t const sn = static_cast<MoldUDP64_recv_packet_hdr const *> (packet)->seqnum ();
+
+    partition & p = m_partitions [pix];
+
+    if (p.m_buffered.emplace (sn, std::string { static_cast<char const *> (packet), static_cast<std::size_t> (size) }).second)
+    {
+        p.m_buffered_size += size;
+        if (! p.m_gap_ts) p.m_gap_ts = sys::realtime_utc ();
+    }
+}
+
+void
+Mold_rewind_client::pop_front (int32_t const pix)
+{
+    assert_within (pix, partition_count ());
+
+    partition & p = m_partitions [pix];
+    assert_nonempty (p.m_buffered);
+
+    auto const i = p.m_buffered.begin ();
+
+    p.m_buffered_size -= i->second.size ();
+    p.m_buffered.erase (i);
+}
+//............................................................................
+
+void
+Mold_rewind_client::request (int32_t const pix, seqnum_t const seqnum, int64_t const count)
+{
+    assert_within (pix, partition_count ());
+    assert_positive (count);
+
+    partition & p = m_partitions [pix];
+
+    timestamp_t const now_utc = sys::realtime_utc ();
+
+    if ((seqnum < p.m_rq_end) && (now_utc < p.m_rq_ts + m_timeout)) // an earlier request is still being answered
+        return;
+
+    int32_t const rq_count = std::min<int64_t> (count, m_max_request);
+
+    link_impl & link = * p.m_link;
+
+    addr_t const msg_buf = link.send_allocate (sizeof (MoldUDP64_rewind_request));
+
+    MoldUDP64_rewind_request & rq = * static_cast<MoldUDP64_rewind_request *> (msg_buf);
+    {
+        rq.session () = front (pix).session ();
+        rq.seqnum () = seqnum;
+        rq.msg_count () = rq_count;
+    }
+
+    link.send_flush (sizeof (MoldUDP64_rewind_request));
+
+    LOG_trace1 << "[P" << pix << "] requested " << rq_count << " message(s) starting at seqnum " << seqnum << (p.m_rq_end > seqnum ? " (timed out)" : "");
+
+    p.m_rq_end = seqnum + rq_count;
+    p.m_rq_ts = now_utc;
+
+    ++ m_request_count;
+}
+
+void
+Mold_rewind_client::reset (int32_t const pix)
+{
+    assert_within (pix, partition_count ());
+
+    partition & p = m_partitions [pix];
+
+    p.m_rq_end = 0;
+    p.m_rq_ts = 0;
+    p.m_gap_ts = 0;
+}
+
+void
+Mold_rewind_client::declare_lost (int32_t const pix, int64_t const count)
+{
+    assert_within (pix, partition_count ());
+    assert_positive (count);
+
+    m_lost_count += count;
+}
+
+} // end of 'ASX'
+} // end of 'market'
+} // end of namespace
+//----------------------------------------------------------------------------
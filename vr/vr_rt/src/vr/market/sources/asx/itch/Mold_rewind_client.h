@@ -0,0 +1,240 @@
+#pragma once
+
+#include "vr/arg_map.h"
+#include "vr/io/links/UDP_ucast_link.h"
+#include "vr/market/net/MoldUDP64_.h"
+#include "vr/market/sources/asx/defs.h" // partition_count(), itch_rewind_link_capacity()
+#include "vr/util/logging.h"
+
+#include <map>
+#include <memory>
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace market
+{
+namespace ASX
+{
+/**
+ * per-partition MoldUDP64 gap recovery state used by @ref Mold_frame_:
+ *
+ *  - a seqnum-ordered buffer of packets received ahead of a gap (so that one partition's
+ *    gap doesn't hold up any other partition);
+ *  - a MoldUDP64 request channel (a UDP unicast link to the partition's rewinder) used
+ *    for retransmission requests and their responses
+ *
+ * requests are rate-limited: a new one is sent only after the previous one has been
+ * fully answered or has timed out
+ *
+ * buffering is bounded: once a partition's gap has been open for longer than "max_gap_age"
+ * or its buffered packets exceed "max_buffered" bytes, @ref expired() becomes 'true' and the
+ * caller is expected to give up on the gap (see @ref declare_lost())
+ *
+ * @see mock_Mold_rewinder
+ */
+class Mold_rewind_client final: noncopyable
+{
+    public: // ...............................................................
+
+        using seqnum_t          = mold_seqnum_t;
+        using link_impl         = io::UDP_ucast_link<io::recv<_timestamp_>, io::send<_timestamp_>>;
+
+        /**
+         * @param args required: "server"      -> std::string,
+         *                       "port_base"   -> int32_t (partition 'p' rewinder listens on 'port_base + p')
+         *             optional: "timeout"     -> timestamp_t (re-request interval),
+         *                       "max_request" -> int32_t (message count limit per request),
+         *                       "max_gap_age" -> timestamp_t (how long a gap may stay open),
+         *                       "max_buffered"-> int64_t (byte limit on packets buffered per partition)
+         */
+        Mold_rewind_client (arg_map const & args);
+        ~Mold_rewind_client ();
+
+        // ACCESSORs:
+
+        int64_t const & request_count () const
+        {
+            return m_request_count;
+        }
+
+        int64_t const & recv_count () const
+        {
+            return m_recv_count;
+        }
+
+        /**
+         * @return number of messages given up on (see @ref declare_lost())
+         */
+        int64_t const & lost_count () const
+        {
+            return m_lost_count;
+        }
+
+        /**
+         * @return number of request channel datagrams dropped because their Mold framing
+         *         didn't fit the datagram size
+         */
+        int64_t const & malformed_count () const
+        {
+            return m_malformed_count;
+        }
+
+        /**
+         * @return 'true' if there are no packets buffered for partition 'pix'
+         */
+        bool empty (int32_t const pix) const
+        {
+            assert_within (pix, partition_count ());
+
+            return m_partitions [pix].m_buffered.empty ();
+        }
+
+        /**
+         * @return lowest-seqnum buffered packet for partition 'pix'
+         *
+         * @note must not be empty
+         */
+        MoldUDP64_recv_packet_hdr const & front (int32_t const pix) const
+        {
+            assert_within (pix, partition_count ());
+            assert_nonempty (m_partitions [pix].m_buffered);
+
+            return (* reinterpret_cast<MoldUDP64_recv_packet_hdr const *> (m_partitions [pix].m_buffered.begin ()->second.data ()));
+        }
+
+        /**
+         * @return 'true' if the gap in partition 'pix' has been open for too long or has
+         *         too much data buffered behind it
+         */
+        bool expired (int32_t const pix) const;
+
+        // MUTATORs:
+
+        /**
+         * copy a MoldUDP64 packet (header included) that arrived ahead of a gap in partition 'pix'
+         * (duplicate seqnums are ignored)
+         */
+        void buffer (int32_t const pix, addr_const_t/* MoldUDP64_recv_packet_hdr */const packet, int32_t const size);
+
+        void pop_front (int32_t const pix);
+
+        /**
+         * request retransmission of '[seqnum, seqnum + count)' in partition 'pix', unless a request
+         * covering 'seqnum' is already outstanding
+         *
+         * @note must not be empty (the session name is taken from the buffered packets)
+         */
+        void request (int32_t const pix, seqnum_t const seqnum, int64_t const count);
+
+        /**
+         * forget outstanding request state for partition 'pix' (call once its gap is closed)
+         */
+        void reset (int32_t const pix);
+
+        /**
+         * account for 'count' messages in partition 'pix' that will not be recovered
+         */
+        void declare_lost (int32_t const pix, int64_t const count);
+
+        /**
+         * invoke 'f (MoldUDP64_recv_packet_hdr const &)' on all payload (non-heartbeat) MoldUDP64
+         * packets received so far on partition 'pix's request channel
+         *
+         * @return number of packets visited
+         */
+        template<typename F>
+        int32_t poll (int32_t const pix, F && f);
+
+    private: // ..............................................................
+
+        struct partition final
+        {
+            std::unique_ptr<link_impl> m_link { };
+            std::map<seqnum_t, std::string> m_buffered { }; // keyed by packet seqnum
+            int64_t m_buffered_size { };    // total size of 'm_buffered' packets
+            seqnum_t m_rq_end { };      // one past the last seqnum of the outstanding request
+            timestamp_t m_rq_ts { };    // when the outstanding request was sent
+            timestamp_t m_gap_ts { };   // when the first packet was buffered (zero if no gap is open)
+
+        }; // end of nested class
+
+
+        std::array<partition, partition_count ()> m_partitions { };
+        timestamp_t const m_timeout;
+        timestamp_t const m_max_gap_age;
+        int64_t const m_max_buffered;
+        int32_t const m_max_request;
+        int64_t m_request_count { };
+        int64_t m_recv_count { };
+        int64_t m_lost_count { };
+        int64_t m_malformed_count { };
+
+}; // end of class
+//............................................................................
+
+template<typename F>
+int32_t
+Mold_rewind_client::poll (int32_t const pix, F && f)
+{
+    assert_within (pix, partition_count ());
+
+    link_impl & link = * m_partitions [pix].m_link;
+
+    int32_t r { };
+
+    while (true) // note: each 'recv_poll()' reads at most one datagram
+    {
+        auto const rc = link.recv_poll (); // non-blocking
+        int32_t available = rc.second;
+
+        if (available <= 0) break;
+
+        // each datagram is a single MoldUDP64 packet, so the data can be walked using Mold framing:
+
+        addr_const_t data = rc.first;
+        int32_t const size = available;
+
+        while (available >= static_cast<int32_t> (sizeof (MoldUDP64_recv_packet_hdr)))
+        {
+            MoldUDP64_recv_packet_hdr const & packet_hdr = * static_cast<MoldUDP64_recv_packet_hdr const *> (data);
+
+            int32_t const msg_count = packet_hdr.msg_count ();
+            int32_t len = sizeof (MoldUDP64_recv_packet_hdr);
+
+            if (vr_is_in_exclusive_range (msg_count, 0, 0xFFFF))
+            {
+                int32_t m = 0;
+                for ( ; (m < msg_count) && (len + static_cast<int32_t> (sizeof (MoldUDP64_recv_message_hdr)) <= available); ++ m)
+                {
+                    len += sizeof (MoldUDP64_recv_message_hdr) + static_cast<MoldUDP64_recv_message_hdr const *> (addr_plus (data, len))->length ();
+                }
+
+                if (VR_UNLIKELY ((m < msg_count) | (len > available))) // framing overruns the datagram: drop the rest of it
+                {
+                    LOG_warn << "[P" << pix << "] dropping malformed rewinder datagram (" << size << " byte(s), Mold msg count " << msg_count << ')';
+                    ++ m_malformed_count;
+
+                    break;
+                }
+
+                f (packet_hdr);
+                ++ r;
+            }
+
+            data = addr_plus (data, len);
+            available -= len;
+        }
+
+        link.recv_flush (size);
+    }
+
+    m_recv_count += r;
+
+    return r;
+}
+
+} // end of 'ASX'
+} // end of 'market'
+} // end of namespace
+//----------------------------------------------------------------------------
@@ -0,0 +1,205 @@
+
+#include "vr/market/sources/mock/asx/mock_Mold_rewinder.h"
+
+#include "vr/io/net/socket_factory.h"
+#include "vr/market/net/MoldUDP64_.h"
+#include "vr/util/logging.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <deque>
+
+#include <sys/socket.h>
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace market
+{
+namespace ASX
+{
+using namespace io;
+
+//............................................................................
+//............................................................................
+
+struct mock_Mold_rewinder::pimpl final
+{
+    using seqnum_t          = mold_seqnum_t;
+
+    struct retained_packet final
+    {
+        seqnum_t m_seqnum;
+        int32_t m_msg_count;
+        std::string m_data; // header included
+
+    }; // end of class
+
+    struct partition final
+    {
+        std::unique_ptr<net::socket_handle> m_socket { };
+        std::deque<retained_packet> m_history { }; // in seqnum order
+
+    }; // end of class
+
+
+    pimpl (arg_map const & args) :
+        m_depth { args.get<int32_t> ("depth", 1024 * 1024) }
+    {
+        int32_t const port_base = args.get<int32_t> ("port_base");
+
+        check_positive (m_depth);
+
+        for (int32_t pix = 0; pix < partition_count (); ++ pix)
+        {
+            m_partitions [pix].m_socket = std::make_unique<net::socket_handle> (net::socket_factory::create_UDP_server (string_cast (port_base + pix)));
+        }
+
+        LOG_info << "rewinding on ports [" << port_base << ", " << (port_base + partition_count ()) << "), depth " << m_depth << " packet(s)";
+    }
+
+    ~pimpl ()
+    {
+        LOG_info << "answered " << m_request_count << " rewind request(s), resent " << m_resend_count << " packet(s)";
+    }
+
+
+    void record (int32_t const pix, addr_const_t const packet, int32_t const size)
+    {
+        assert_within (pix, partition_count ());
+        assert_le (static_cast<int32_t> (sizeof (MoldUDP64_recv_packet_hdr)), size);
+
+        MoldUDP64_recv_packet_hdr const & hdr = * static_cast<MoldUDP64_recv_packet_hdr const *> (packet);
+
+        int32_t const msg_count = hdr.msg_count ();
+        if (! vr_is_in_exclusive_range (msg_count, 0, 0xFFFF)) return; // heartbeat or EOS
+
+        auto & history = m_partitions [pix].m_history;
+
+        if (static_cast<int32_t> (history.size ()) >= m_depth) history.pop_front ();
+
+        history.push_back ({ hdr.seqnum (), msg_count, std::string { static_cast<char const *> (packet), static_cast<std::size_t> (size) } });
+    }
+
+    int32_t poll ()
+    {
+        int32_t r { };
+
+        for (int32_t pix = 0; pix < partition_count (); ++ pix)
+        {
+            int32_t const fd = m_partitions [pix].m_socket->fd ();
+
+            while (true)
+            {
+                MoldUDP64_rewind_request rq;
+
+                ::sockaddr_storage sa;
+                ::socklen_t sa_len { sizeof (sa) };
+
+                auto const rc = ::recvfrom (fd, & rq, sizeof (rq), MSG_DONTWAIT, reinterpret_cast<::sockaddr *> (& sa), & sa_len);
+                if (rc < 0)
+                {
+                    auto const e = errno;
+                    if (VR_LIKELY (e == EAGAIN)) break;
+
+                    throw_x (io_exception, "recvfrom() error (" + string_cast (e) + "): " + std::strerror (e));
+                }
+
+                if (VR_UNLIKELY (rc != sizeof (rq)))
+                {
+                    LOG_warn << "[P" << pix << "] ignoring malformed rewind request of size " << rc;
+                    continue;
+                }
+
+                answer (pix, rq, fd, sa, sa_len);
+                ++ r;
+            }
+        }
+
+        return r;
+    }
+
+    void answer (int32_t const pix, MoldUDP64_rewind_request const & rq, int32_t const fd, ::sockaddr_storage const & sa, ::socklen_t const sa_len)
+    {
+        seqnum_t const sn_begin = rq.seqnum ();
+        seqnum_t const sn_end = sn_begin + rq.msg_count ();
+
+        DLOG_trace1 << "[P" << pix << "] rewind request [" << sn_begin << ", " << sn_end << ')';
+
+        ++ m_request_count;
+
+        auto const & history = m_partitions [pix].m_history;
+
+        // find the first retained packet that ends after 'sn_begin':
+
+        auto i = std::upper_bound (history.begin (), history.end (), sn_begin, [](seqnum_t const sn, retained_packet const & p) { return (sn < p.m_seqnum); });
+        if (i != history.begin ()) -- i;
+
+        if (VR_UNLIKELY ((i == history.end ()) || (i->m_seqnum > sn_begin)))
+            LOG_warn << "[P" << pix << "] rewind request [" << sn_begin << ", " << sn_end << ") is (partially) outside of the retained window";
+
+        for ( ; (i != history.end ()) && (i->m_seqnum < sn_end); ++ i)
+        {
+            if (i->m_seqnum + i->m_msg_count <= sn_begin) continue;
+
+            auto const rc = ::sendto (fd, i->m_data.data (), i->m_data.size (), MSG_DONTWAIT, reinterpret_cast<::sockaddr const *> (& sa), sa_len);
+            if (VR_UNLIKELY (rc < 0))
+            {
+                auto const e = errno;
+                if (e == EAGAIN) break; // the client will time out and re-request
+
+                throw_x (io_exception, "sendto() error (" + string_cast (e) + "): " + std::strerror (e));
+            }
+
+            ++ m_resend_count;
+        }
+    }
+
+
+    std::array<partition, partition_count ()> m_partitions { };
+    int32_t const m_depth;
+    int64_t m_request_count { };
+    int64_t m_resend_count { };
+
+}; // end of nested class
+//............................................................................
+//............................................................................
+
+mock_Mold_rewinder::mock_Mold_rewinder (arg_map const & args) :
+    m_impl { std::make_unique<pimpl> (args) }
+{
+}
+
+mock_Mold_rewinder::~mock_Mold_rewinder ()    = default; // pimpl
+//............................................................................
+
+int64_t const &
+mock_Mold_rewinder::request_count () const
+{
+    return m_impl->m_request_count;
+}
+
+int64_t const &
+mock_Mold_rewinder::resend_count () const
+{
+    return m_impl->m_resend_count;
+}
+//............................................................................
+
+void
+mock_Mold_rewinder::record (int32_t const pix, addr_const_t const packet, int32_t const size)
+{
+    m_impl->record (pix, packet, size);
+}
+
+int32_t
+mock_Mold_rewinder::poll ()
+{
+    return m_impl->poll ();
+}
+
+} // end of 'ASX'
+} // end of 'market'
+} // end of namespace
+//----------------------------------------------------------------------------
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "vr/arg_map.h"
+#include "vr/market/sources/asx/defs.h"
+
+#include <memory>
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace market
+{
+namespace ASX
+{
+/**
+ * a local stand-in for the per-partition MoldUDP64 rewinders: retains a window of the
+ * most recent packets published in each partition (see @ref record()) and answers
+ * 'MoldUDP64_rewind_request's received on UDP ports '[port_base, port_base + partition_count())'
+ * by resending the retained packets that overlap the requested range
+ *
+ * @see Mold_rewind_client
+ */
+class mock_Mold_rewinder final: noncopyable
+{
+    public: // ...............................................................
+
+        /**
+         * @param args required: "port_base" -> int32_t
+         *             optional: "depth"     -> int32_t (max packets retained per partition)
+         */
+        mock_Mold_rewinder (arg_map const & args);
+        ~mock_Mold_rewinder ();
+
+        // ACCESSORs:
+
+        int64_t const & request_count () const;
+        int64_t const & resend_count () const;
+
+        // MUTATORs:
+
+        /**
+         * @param packet a MoldUDP64 packet (header included) published in partition 'pix'
+         *        [heartbeats and EOS packets are ignored]
+         */
+        void record (int32_t const pix, addr_const_t const packet, int32_t const size);
+
+        /**
+         * answer all rewind requests received so far [non-blocking]
+         *
+         * @return number of requests answered
+         */
+        int32_t poll ();
+
+    private: // ..............................................................
+
+        class pimpl; // forward
+
+        std::unique_ptr<pimpl> const m_impl;
+
+}; // end of class
+
+} // end of 'ASX'
+} // end of 'market'
+} // end of namespace
+//----------------------------------------------------------------------------
@@ -0,0 +1,821 @@
+#pragma once
+
+#include "vr/arg_map.h"
+#include "vr/enums.h"
+#include "vr/fields.h"
+#include "vr/market/books/asx/pool_arenas.h"
+#include "vr/market/books/defs.h" // _book_
+#include "vr/market/sources/asx/defs.h"
+#include "vr/market/sources/asx/itch/ITCH_visitor.h"
+#include "vr/util/logging.h"
+
+#include <map>
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace market
+{
+namespace ASX
+{
+
+VR_ENUM (match_report,
+    (
+        accepted,
+        replaced,
+        executed,
+        canceled,
+        rejected
+    ),
+    printable
+
+); // end of enum
+//............................................................................
+/**
+ * an exchange simulator that matches client orders against replayed market data,
+ * following price-time priority:
+ *
+ *  - market liquidity is a set of (read-only) @ref limit_order_book instances,
+ *    maintained by a 'market_data_listener' from the same capture that would be
+ *    replayed by 'mock_mcast_server';
+ *  - an order that crosses the opposite side executes against displayed levels
+ *    (best price first) up to its limit, any remainder either rests or, for IOC/FOK
+ *    orders, is canceled;
+ *  - a resting order is queued behind all displayed qty at its price at the time
+ *    of entry; that queue is reduced by market fills at the order's price and
+ *    (proportionally) by market cancels/deletes at that price; market fill qty that
+ *    exceeds what was queued ahead executes the client order; market fills at a worse
+ *    price than the order trade through it and execute it outright;
+ *  - a resting order also executes (at its own price) against new or replaced market
+ *    orders on the opposite side that cross it, unless the market book itself would be
+ *    crossed by them (as happens during auctions)
+ *
+ * replayed market data is not impacted by client executions (the usual
+ * non-intrusive simulation assumption), and client orders are not matched against
+ * each other
+ *
+ * market data is fed through an ITCH pipeline of
+ *
+ *      @ref selector -> @ref tracker -> 'market_data_listener'
+ *
+ * (the tracker must see a message before the listener updates the book)
+ *
+ * all outcomes are appended to @ref reports() for the caller to drain
+ *
+ * @note not thread-safe
+ */
+template<typename LIMIT_ORDER_BOOK>
+class mock_matching_engine final: noncopyable
+{
+    private: // ..............................................................
+
+        using this_type         = mock_matching_engine<LIMIT_ORDER_BOOK>;
+
+    public: // ...............................................................
+
+        using book_type         = LIMIT_ORDER_BOOK;
+        using price_type        = typename book_type::price_type;
+        using qty_type          = this_source_traits::qty_type;
+        using iid_type          = this_source_traits::iid_type;
+
+        using price_traits      = this_source_traits::price_traits<price_type>;
+
+        vr_static_assert (book_type::level::has_qty ()); // queue positions are tracked from aggregate level qty
+
+        /**
+         * a client-chosen handle, unique among live orders
+         */
+        using order_ref         = int64_t;
+
+        struct report final
+        {
+            match_report::enum_t m_type;
+            order_ref m_ref;
+            order_ref m_ref_prev;   // 'replaced' only
+            iid_type m_iid;
+            side::enum_t m_side;
+            oid_t m_oid;            // assigned by the engine ('accepted', 'replaced', 'executed', 'canceled')
+            price_type m_price;     // order price or, for 'executed', trade price
+            qty_type m_qty;         // open qty or, for 'executed', traded qty
+            int64_t m_match;        // 'executed' only
+
+        }; // end of nested class
+
+
+        template<typename CTX> class selector;  // forward
+        template<typename CTX> class tracker;   // forward
+
+
+        mock_matching_engine (arg_map const & args = { }) :
+            m_oid_counter { args.get<oid_t> ("oid_seed", 0x1000000) }
+        {
+        }
+
+        // ACCESSORs:
+
+        /**
+         * @return book for 'iid' [nullptr if no market data for 'iid' has been seen yet]
+         */
+        book_type const * book (iid_type const iid) const
+        {
+            auto const i = m_instruments.find (iid);
+
+            return (i == m_instruments.end () ? nullptr : & i->second->m_book);
+        }
+
+        int32_t live_order_count () const
+        {
+            return m_ref_map.size ();
+        }
+
+        /**
+         * @return open qty of a live order 'ref' [0 if not live]
+         */
+        qty_type open_qty (order_ref const ref) const
+        {
+            auto const i = m_ref_map.find (ref);
+
+            return (i == m_ref_map.end () ? 0 : m_orders [i->second].m_qty);
+        }
+
+        /**
+         * @return qty queued ahead of a live resting order 'ref' [0 if not live]
+         */
+        qty_type queue_ahead (order_ref const ref) const
+        {
+            auto const i = m_ref_map.find (ref);
+
+            return (i == m_ref_map.end () ? 0 : m_orders [i->second].m_ahead);
+        }
+
+        std::vector<report> const & reports () const
+        {
+            return m_reports;
+        }
+
+        // MUTATORs:
+
+        /**
+         * caller is expected to clear this after consuming
+         */
+        std::vector<report> & reports ()
+        {
+            return m_reports;
+        }
+
+        VR_ASSUME_HOT void submit (order_ref const ref, iid_type const iid, side::enum_t const s, price_type const price, qty_type const qty, ord_TIF::enum_t const TIF);
+
+        /**
+         * 'qty' is the new open qty; the order keeps its queue position unless its price
+         * changes or its qty increases
+         */
+        VR_ASSUME_HOT void replace (order_ref const ref, order_ref const new_ref, price_type const price, qty_type const qty);
+
+        VR_ASSUME_HOT void cancel (order_ref const ref);
+
+    private: // ..............................................................
+
+        using level_queue       = std::vector<int32_t>; // indices into 'm_orders', in time priority
+        using price_queue_map   = std::map<price_type, level_queue>; // keyed on "side key": best price first
+
+        struct instrument final
+        {
+            template<typename POOL_ARENA>
+            instrument (POOL_ARENA & arena) :
+                m_book { arena }
+            {
+            }
+
+            book_type m_book;
+            std::array<price_queue_map, side::size> m_queues { };
+
+        }; // end of nested class
+
+        struct sim_order final
+        {
+            order_ref m_ref;
+            instrument * m_instrument;
+            oid_t m_oid;
+            price_type m_price;
+            qty_type m_qty;         // open
+            qty_type m_ahead;       // market qty queued ahead
+            iid_type m_iid;
+            side::enum_t m_side;
+
+        }; // end of nested class
+
+        using pool_arena        = impl::market_data_view_pool_arena<typename book_type::traits::pool_arena>;
+        using instrument_map    = boost::unordered_map<iid_type, std::unique_ptr<instrument>>;
+        using ref_map           = boost::unordered_map<order_ref, int32_t>;
+
+
+        static VR_FORCEINLINE price_type side_key (side::enum_t const s, price_type const price)
+        {
+            return (s == side::BID ? - price : price); // ascending keys are from the inside out
+        }
+
+        instrument & lookup_or_create (iid_type const iid)
+        {
+            auto i = m_instruments.find (iid);
+
+            if (VR_UNLIKELY (i == m_instruments.end ()))
+            {
+                i = m_instruments.emplace (iid, std::make_unique<instrument> (m_arena)).first;
+            }
+
+            return (* i->second);
+        }
+
+        void report_ (match_report::enum_t const type, sim_order const & o, order_ref const ref_prev = 0)
+        {
+            m_reports.push_back ({ type, o.m_ref, ref_prev, o.m_iid, o.m_side, o.m_oid, o.m_price, o.m_qty, 0 });
+        }
+
+        void report_execution (sim_order const & o, price_type const price, qty_type const qty)
+        {
+            m_reports.push_back ({ match_report::executed, o.m_ref, 0, o.m_iid, o.m_side, o.m_oid, price, qty, ++ m_match_counter });
+        }
+
+        void reject (order_ref const ref, iid_type const iid, side::enum_t const s)
+        {
+            m_reports.push_back ({ match_report::rejected, ref, 0, iid, s, 0, 0, 0, 0 });
+        }
+
+        int32_t allocate_order ()
+        {
+            if (m_free.empty ())
+            {
+                m_orders.emplace_back ();
+                return (m_orders.size () - 1);
+            }
+
+            int32_t const ix = m_free.back ();
+            m_free.pop_back ();
+
+            return ix;
+        }
+
+        void release_order (int32_t const ix)
+        {
+            m_ref_map.erase (m_orders [ix].m_ref);
+            m_free.push_back (ix);
+        }
+
+        /*
+         * execute 'o' against the displayed opposite side, up to its limit price
+         */
+        void take (sim_order & o);
+
+        /*
+         * queue 'o' (at 'ix') at the back of its price level
+         */
+        void rest (sim_order & o, int32_t const ix);
+
+        void unqueue (sim_order const & o, int32_t const ix);
+
+        // driven by 'tracker':
+
+        /*
+         * 'price' is that of the filled market order's level, 'exec_price' is the price to
+         * report executions at that level with (they differ for 'order_fill_with_price')
+         */
+        void on_market_fill (instrument & i, side::enum_t const s, price_type const price, qty_type const qty, price_type const exec_price);
+        void on_market_add (instrument & i, side::enum_t const s, price_type const price, qty_type const qty);
+        void on_market_cancel (instrument & i, side::enum_t const s, price_type const price, qty_type const qty, qty_type const level_qty);
+
+
+        pool_arena m_arena { };
+        instrument_map m_instruments { };
+        std::vector<sim_order> m_orders { };
+        std::vector<int32_t> m_free { };
+        ref_map m_ref_map { };
+        std::vector<report> m_reports { };
+        instrument * m_current { }; // set by 'selector'
+        oid_t m_oid_counter;
+        int64_t m_match_counter { };
+
+}; // end of class
+//............................................................................
+/**
+ * an ITCH pipeline stage that places the (possibly newly created) book for a message's
+ * iid into 'CTX'
+ *
+ * required args: "engine" -> mock_matching_engine *
+ */
+template<typename LIMIT_ORDER_BOOK>
+template<typename CTX>
+class mock_matching_engine<LIMIT_ORDER_BOOK>::selector final: public ITCH_visitor<selector<CTX>>
+{
+    private: // ..............................................................
+
+        using super         = ITCH_visitor<selector<CTX>>;
+
+        vr_static_assert (has_field<_book_, CTX> ());
+
+    public: // ...............................................................
+
+        selector (arg_map const & args) :
+            super (args),
+            m_parent { * args.get<this_type *> ("engine") }
+        {
+        }
+
+        // message visits:
+
+        using super::visit;
+
+        VR_FORCEINLINE bool visit (pre_message const msg_type, addr_const_t const msg, CTX & ctx) // override
+        {
+            itch::message_type::enum_t const mt = static_cast<itch::message_type::enum_t> (static_cast<int32_t> (msg_type));
+            int32_t const iid_offset = itch::message_type::offsetof_iid (mt);
+
+            if (iid_offset < 0) return true; // non-instrument-specific message type
+
+            iid_type const iid = (* static_cast<iid_ft const *> (addr_plus (msg, iid_offset)));
+
+            instrument & i = m_parent.lookup_or_create (iid);
+
+            m_parent.m_current = & i;
+            field<_book_, CTX> (ctx) = & i.m_book;
+
+            return true;
+        }
+
+    private: // ..............................................................
+
+        this_type & m_parent;
+
+}; // end of nested class
+//............................................................................
+/**
+ * an ITCH pipeline stage that updates client order queue positions and executes
+ * client orders; must run ahead of the book listener (needs to see market orders
+ * before they are updated or removed)
+ *
+ * required args: "engine" -> mock_matching_engine *
+ */
+template<typename LIMIT_ORDER_BOOK>
+template<typename CTX>
+class mock_matching_engine<LIMIT_ORDER_BOOK>::tracker final: public ITCH_visitor<tracker<CTX>>
+{
+    private: // ..............................................................
+
+        using super         = ITCH_visitor<tracker<CTX>>;
+
+        vr_static_assert (has_field<_book_, CTX> ());
+
+    public: // ...............................................................
+
+        tracker (arg_map const & args) :
+            super (args),
+            m_parent { * args.get<this_type *> ("engine") }
+        {
+        }
+
+        // overridden ITCH visits:
+
+        using super::visit;
+
+        VR_ASSUME_HOT bool visit (itch::order_add const & msg, CTX & ctx) // override
+        {
+            instrument & i = current (ctx);
+
+            side::enum_t const s = ord_side::to_side (msg.side ());
+            if (i.m_queues [~ s].empty ()) return true; // fast path: no client orders this could cross
+
+            m_parent.on_market_add (i, s, price_traits::wire_to_book (msg.price ()), msg.qty ());
+
+            return true;
+        }
+
+        VR_ASSUME_HOT bool visit (itch::order_add_with_participant const & msg, CTX & ctx) // override
+        {
+            return visit (static_cast<itch::order_add const &> (msg), ctx);
+        }
+
+        VR_ASSUME_HOT bool visit (itch::order_fill const & msg, CTX & ctx) // override
+        {
+            instrument & i = current (ctx);
+            if (i.m_queues [side::BID].empty () & i.m_queues [side::ASK].empty ()) return true; // fast path: no client orders in this instrument
+
+            side::enum_t const s = ord_side::to_side (msg.side ());
+
+            auto const * const o = i.m_book.find_order (s, msg.oid ());
+            if (VR_LIKELY (o != nullptr)) // allow for this to be a no-op in case we've not seen the corresponding add
+            {
+                price_type const price = field<_price_> (i.m_book.level_of (* o));
+
+                m_parent.on_market_fill (i, s, price, msg.qty (), price);
+            }
+
+            return true;
+        }
+
+        VR_ASSUME_HOT bool visit (itch::order_fill_with_price const & msg, CTX & ctx) // override
+        {
+            instrument & i = current (ctx);
+            if (i.m_queues [side::BID].empty () & i.m_queues [side::ASK].empty ()) return true; // fast path
+
+            side::enum_t const s = ord_side::to_side (msg.side ());
+
+            auto const * const o = i.m_book.find_order (s, msg.oid ());
+            if (VR_LIKELY (o != nullptr))
+            {
+                m_parent.on_market_fill (i, s, field<_price_> (i.m_book.level_of (* o)), msg.qty (), price_traits::wire_to_book (msg.price ()));
+            }
+
+            return true;
+        }
+
+        VR_ASSUME_HOT bool visit (itch::order_replace const & msg, CTX & ctx) // override
+        {
+            instrument & i = current (ctx);
+            if (i.m_queues [side::BID].empty () & i.m_queues [side::ASK].empty ()) return true; // fast path
+
+            side::enum_t const s = ord_side::to_side (msg.side ());
+
+            auto const * const o = i.m_book.find_order (s, msg.oid ());
+            if (VR_LIKELY (o != nullptr))
+            {
+                auto const & l = i.m_book.level_of (* o);
+
+                price_type const price = field<_price_> (l);
+                qty_type const o_qty = field<_qty_> (* o);
+                qty_type const new_qty = msg.qty ();
+
+                // the market order keeps its priority (i.e. the change is a partial cancel) only
+                // if its price doesn't change and its qty doesn't increase:
+
+                price_type const new_price = price_traits::wire_to_book (msg.price ());
+
+                if ((new_price != price) | (new_qty > o_qty))
+                    m_parent.on_market_cancel (i, s, price, o_qty, field<_qty_> (l));
+                else if (new_qty < o_qty)
+                    m_parent.on_market_cancel (i, s, price, o_qty - new_qty, field<_qty_> (l));
+
+                if ((new_price != price) & ! i.m_queues [~ s].empty ()) // the replacement is new liquidity at 'new_price'
+                    m_parent.on_market_add (i, s, new_price, new_qty);
+            }
+
+            return true;
+        }
+
+        VR_ASSUME_HOT bool visit (itch::order_delete const & msg, CTX & ctx) // override
+        {
+            instrument & i = current (ctx);
+            if (i.m_queues [side::BID].empty () & i.m_queues [side::ASK].empty ()) return true; // fast path
+
+            side::enum_t const s = ord_side::to_side (msg.side ());
+
+            auto const * const o = i.m_book.find_order (s, msg.oid ());
+            if (VR_LIKELY (o != nullptr))
+            {
+                auto const & l = i.m_book.level_of (* o);
+
+                m_parent.on_market_cancel (i, s, field<_price_> (l), field<_qty_> (* o), field<_qty_> (l));
+            }
+
+            return true;
+        }
+
+    private: // ..............................................................
+
+        VR_FORCEINLINE instrument & current (CTX & ctx) const
+        {
+            assert_nonnull (m_parent.m_current); // relying on a selector ahead of us in the pipeline
+            assert_eq (field<_book_> (ctx), & m_parent.m_current->m_book);
+
+            return (* m_parent.m_current);
+        }
+
+
+        this_type & m_parent;
+
+}; // end of nested class
+//............................................................................
+
+template<typename LIMIT_ORDER_BOOK>
+void
+mock_matching_engine<LIMIT_ORDER_BOOK>::submit (order_ref const ref, iid_type const iid, side::enum_t const s, price_type const price, qty_type const qty, ord_TIF::enum_t const TIF)
+{
+    if (VR_UNLIKELY ((qty <= 0) || m_ref_map.count (ref)))
+    {
+        reject (ref, iid, s);
+        return;
+    }
+
+    instrument & i = lookup_or_create (iid);
+
+    int32_t const ix = allocate_order ();
+    sim_order & o = m_orders [ix];
+    {
+        o.m_ref = ref;
+        o.m_instrument = & i;
+        o.m_oid = ++ m_oid_counter;
+        o.m_price = price;
+        o.m_qty = qty;
+        o.m_ahead = 0;
+        o.m_iid = iid;
+        o.m_side = s;
+    }
+    m_ref_map.emplace (ref, ix);
+
+    if (TIF == ord_TIF::FOK) // all or nothing: check available qty first
+    {
+        side::enum_t const s_opp = ~ s;
+        price_type const limit_key = side_key (s_opp, price);
+
+        qty_type available { };
+        for (auto const & l : i.m_book [s_opp])
+        {
+            if ((side_key (s_opp, field<_price_> (l)) > limit_key) || (available >= qty)) break;
+            available += field<_qty_> (l);
+        }
+
+        if (available < qty)
+        {
+            report_ (match_report::accepted, o);
+            report_ (match_report::canceled, o);
+            release_order (ix);
+            return;
+        }
+    }
+
+    report_ (match_report::accepted, o);
+
+    take (o);
+
+    if (o.m_qty <= 0)
+        release_order (ix);
+    else if (TIF != ord_TIF::DAY)
+    {
+        report_ (match_report::canceled, o);
+        release_order (ix);
+    }
+    else
+        rest (o, ix);
+}
+
+template<typename LIMIT_ORDER_BOOK>
+void
+mock_matching_engine<LIMIT_ORDER_BOOK>::replace (order_ref const ref, order_ref const new_ref, price_type const price, qty_type const qty)
+{
+    auto const i = m_ref_map.find (ref);
+
+    if (VR_UNLIKELY ((i == m_ref_map.end ()) || (qty <= 0) || ((new_ref != ref) && m_ref_map.count (new_ref))))
+    {
+        reject (new_ref, 0, side::BID);
+        return;
+    }
+
+    int32_t const ix = i->second;
+    sim_order & o = m_orders [ix];
+
+    m_ref_map.erase (i);
+    m_ref_map.emplace (new_ref, ix);
+    o.m_ref = new_ref;
+
+    if ((price == o.m_price) & (qty <= o.m_qty)) // keeps priority
+    {
+        o.m_qty = qty;
+        report_ (match_report::replaced, o, ref);
+        return;
+    }
+
+    unqueue (o, ix);
+
+    o.m_price = price;
+    o.m_qty = qty;
+    report_ (match_report::replaced, o, ref);
+
+    take (o);
+
+    if (o.m_qty <= 0)
+        release_order (ix);
+    else
+        rest (o, ix);
+}
+
+template<typename LIMIT_ORDER_BOOK>
+void
+mock_matching_engine<LIMIT_ORDER_BOOK>::cancel (order_ref const ref)
+{
+    auto const i = m_ref_map.find (ref);
+
+    if (VR_UNLIKELY (i == m_ref_map.end ()))
+    {
+        reject (ref, 0, side::BID);
+        return;
+    }
+
+    int32_t const ix = i->second;
+    sim_order & o = m_orders [ix];
+
+    unqueue (o, ix);
+
+    o.m_qty = 0;
+    report_ (match_report::canceled, o);
+
+    release_order (ix);
+}
+//............................................................................
+
+template<typename LIMIT_ORDER_BOOK>
+void
+mock_matching_engine<LIMIT_ORDER_BOOK>::take (sim_order & o)
+{
+    side::enum_t const s_opp = ~ o.m_side;
+    price_type const limit_key = side_key (s_opp, o.m_price);
+
+    for (auto const & l : o.m_instrument->m_book [s_opp]) // best price first
+    {
+        price_type const l_price = field<_price_> (l);
+        if (side_key (s_opp, l_price) > limit_key) break; // no longer marketable
+
+        qty_type const qty = std::min<qty_type> (o.m_qty, field<_qty_> (l));
+        if (qty <= 0) continue;
+
+        report_execution (o, l_price, qty);
+
+        if ((o.m_qty -= qty) <= 0) break;
+    }
+}
+
+template<typename LIMIT_ORDER_BOOK>
+void
+mock_matching_engine<LIMIT_ORDER_BOOK>::rest (sim_order & o, int32_t const ix)
+{
+    auto const * const l = o.m_instrument->m_book [o.m_side].eq_price (o.m_price);
+
+    o.m_ahead = (l == nullptr ? 0 : field<_qty_> (* l)); // behind everything displayed at this price
+
+    o.m_instrument->m_queues [o.m_side][side_key (o.m_side, o.m_price)].push_back (ix);
+}
+
+template<typename LIMIT_ORDER_BOOK>
+void
+mock_matching_engine<LIMIT_ORDER_BOOK>::unqueue (sim_order const & o, int32_t const ix)
+{
+    price_queue_map & queues = o.m_instrument->m_queues [o.m_side];
+
+    auto const qi = queues.find (side_key (o.m_side, o.m_price));
+    if (qi == queues.end ()) return; // not resting
+
+    level_queue & q = qi->second;
+
+    auto const i = std::find (q.begin (), q.end (), ix);
+    if (i != q.end ())
+    {
+        q.erase (i);
+        if (q.empty ()) queues.erase (qi);
+    }
+}
+//............................................................................
+
+template<typename LIMIT_ORDER_BOOK>
+void
+mock_matching_engine<LIMIT_ORDER_BOOK>::on_market_fill (instrument & i, side::enum_t const s, price_type const price, qty_type const qty, price_type const exec_price)
+{
+    price_queue_map & queues = i.m_queues [s];
+    price_type const fill_key = side_key (s, price);
+
+    qty_type through_qty { }; // fill qty taken by client orders at better prices (traded through)
+
+    for (auto qi = queues.begin (); qi != queues.end (); )
+    {
+        if (qi->first > fill_key) break; // remaining client levels are behind the fill price
+
+        level_queue & q = qi->second;
+
+        if (qi->first < fill_key) // traded through
+        {
+            for (auto oi = q.begin (); (oi != q.end ()) && (through_qty < qty); )
+            {
+                sim_order & o = m_orders [* oi];
+
+                qty_type const f = std::min (o.m_qty, qty - through_qty);
+                through_qty += f;
+
+                report_execution (o, o.m_price, f);
+
+                if ((o.m_qty -= f) <= 0)
+                {
+                    release_order (* oi);
+                    oi = q.erase (oi);
+                }
+                else
+                    ++ oi;
+            }
+        }
+        else // at the fill price: consume queue positions with whatever fill qty is left
+        {
+            qty_type const level_qty = qty - through_qty;
+            qty_type ours_ahead { }; // client qty with higher priority at this level
+
+            for (auto oi = q.begin (); oi != q.end (); )
+            {
+                sim_order & o = m_orders [* oi];
+
+                qty_type const reaching = level_qty - o.m_ahead - ours_ahead; // fill qty that would have reached 'o'
+                ours_ahead += o.m_qty;
+                o.m_ahead = std::max<qty_type> (o.m_ahead - level_qty, 0);
+
+                if (reaching > 0)
+                {
+                    qty_type const f = std::min (o.m_qty, reaching);
+
+                    report_execution (o, exec_price, f);
+
+                    if ((o.m_qty -= f) <= 0)
+                    {
+                        release_order (* oi);
+                        oi = q.erase (oi);
+                        continue;
+                    }
+                }
+                ++ oi;
+            }
+        }
+
+        if (q.empty ())
+            qi = queues.erase (qi);
+        else
+            ++ qi;
+    }
+}
+
+template<typename LIMIT_ORDER_BOOK>
+void
+mock_matching_engine<LIMIT_ORDER_BOOK>::on_market_add (instrument & i, side::enum_t const s, price_type const price, qty_type const qty)
+{
+    side::enum_t const s_opp = ~ s;
+
+    price_queue_map & queues = i.m_queues [s_opp];
+    price_type const limit_key = side_key (s_opp, price); // client levels with keys up to this are crossed
+
+    // if the market's own opposite side is marketable against 'price', the market didn't
+    // trade this order either (e.g. an auction is in progress):
+
+    for (auto const & l : i.m_book [s_opp]) // best price first
+    {
+        if ((field<_qty_> (l) > 0) && (side_key (s_opp, field<_price_> (l)) <= limit_key)) return;
+        break;
+    }
+
+    qty_type left = qty;
+
+    for (auto qi = queues.begin (); (qi != queues.end ()) && (qi->first <= limit_key) && (left > 0); ) // best price first, then time priority
+    {
+        level_queue & q = qi->second;
+
+        for (auto oi = q.begin (); (oi != q.end ()) && (left > 0); )
+        {
+            sim_order & o = m_orders [* oi];
+
+            qty_type const f = std::min (o.m_qty, left);
+            left -= f;
+
+            report_execution (o, o.m_price, f); // a resting order sets the trade price
+
+            if ((o.m_qty -= f) <= 0)
+            {
+                release_order (* oi);
+                oi = q.erase (oi);
+            }
+            else
+                ++ oi;
+        }
+
+        if (q.empty ())
+            qi = queues.erase (qi);
+        else
+            ++ qi;
+    }
+}
+
+template<typename LIMIT_ORDER_BOOK>
+void
+mock_matching_engine<LIMIT_ORDER_BOOK>::on_market_cancel (instrument & i, side::enum_t const s, price_type const price, qty_type const qty, qty_type const level_qty)
+{
+    if (VR_UNLIKELY (level_qty <= 0)) return;
+
+    price_queue_map & queues = i.m_queues [s];
+
+    auto const qi = queues.find (side_key (s, price));
+    if (qi == queues.end ()) return;
+
+    // without knowing where in the queue the canceled qty was, assume it was spread
+    // evenly through the level:
+
+    for (int32_t const ix : qi->second)
+    {
+        sim_order & o = m_orders [ix];
+
+        o.m_ahead = std::max<qty_type> (o.m_ahead - (qty * o.m_ahead) / level_qty, 0);
+    }
+}
+
+} // end of 'ASX'
+} // end of 'market'
+} // end of namespace
+//----------------------------------------------------------------------------
@@ -0,0 +1,256 @@
+#include "vr/macros.h" // VR_RELEASE
+#if VR_RELEASE // perf testcases in release builds only
+
+#include "vr/market/books/asx/market_data_listener.h"
+#include "vr/market/books/book_event_context.h"
+#include "vr/market/books/limit_order_book.h"
+#include "vr/market/rt/asx/utility.h" // order_token_generator
+#include "vr/market/sources/asx/itch/ITCH_pipeline.h"
+#include "vr/market/sources/mock/asx/mock_matching_engine.h"
+#include "vr/market/sources/mock/asx/mock_ouch_handlers.h"
+#include "vr/market/sources/mock/mock_market_event_context.h"
+#include "vr/meta/structs.h"
+#include "vr/sys/os.h"
+#include "vr/util/random.h"
+
+#include "vr/test/utility.h"
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace market
+{
+namespace ASX
+{
+//............................................................................
+//............................................................................
+namespace
+{
+
+using book_type         = limit_order_book<price_si_t, oid_t, level<_qty_, _order_count_>>;
+using engine_type       = mock_matching_engine<book_type>;
+
+using visit_ctx         = book_event_context<_book_, _partition_>;
+
+using pipeline          = ITCH_pipeline
+                        <
+                            engine_type::selector<visit_ctx>,
+                            engine_type::tracker<visit_ctx>,
+                            market_data_listener<source::ASX, book_type, visit_ctx>
+                        >;
+
+using handler_ctx       = mock_market_event_context<_ts_origin_, _partition_, _ts_local_, _mock_scenario_>; // same as 'mock_ouch_server' uses
+
+constexpr iid_t iid     = 123;
+
+//............................................................................
+/*
+ * a stand-in for 'mock_ouch_server' that drops all responses scheduled by its handler
+ */
+struct server final
+{
+    using matching_engine_type  = engine_type;
+
+    util::date_t const & session_date () const
+    {
+        return m_session_date;
+    }
+
+    matching_engine_type & matching_engine ()
+    {
+        return m_engine;
+    }
+
+    void enqueue_action (int32_t const pix, std::unique_ptr<mock_response> && action)
+    {
+        ++ m_action_count; // [and 'action' is destructed]
+    }
+
+
+    util::date_t const m_session_date { util::current_date_local () };
+    matching_engine_type m_engine { };
+    int64_t m_action_count { };
+
+}; // end of class
+
+using handler           = matching_handler<server, handler_ctx>;
+
+//............................................................................
+
+template<typename MSG>
+using framed            = meta::make_packed_struct_t<meta::make_schema_t
+                        <
+                            meta::fdef_<SoupTCP_packet_hdr, _hdr_>,
+                            meta::fdef_<MSG,                _payload_>
+                        >>; // same as 'execution_link' sends
+
+template<typename MSG>
+MSG &
+append (std::vector<int8_t> & buf)
+{
+    buf.resize (buf.size () + sizeof (framed<MSG>), ' ');
+
+    framed<MSG> & f = * reinterpret_cast<framed<MSG> *> (& buf [buf.size () - sizeof (framed<MSG>)]);
+
+    SoupTCP_packet_hdr & hdr = field<_hdr_> (f);
+    {
+        hdr.length () = 1 + sizeof (MSG);
+        hdr.type () = 'U'; // [SoupTCP] client unsequenced data
+    }
+
+    return field<_payload_> (f);
+}
+
+/*
+ * displayed depth on both sides of a spread of 1000/1001
+ */
+void
+add_market_depth (engine_type & e, int32_t const depth)
+{
+    pipeline p { { { "engine", & e } } };
+    visit_ctx ctx { };
+
+    oid_t oid { };
+
+    for (int32_t l = 0; l < depth; ++ l)
+    {
+        for (side::enum_t const s : side::values ())
+        {
+            itch::order_add msg { };
+            {
+                msg.hdr ().type () = itch::message_type::order_add;
+                msg.oid () = ++ oid;
+                msg.iid () = iid;
+                msg.side () = (s == side::BID ? ord_side::BUY : ord_side::SELL);
+                msg.qty () = 100 + l;
+                msg.price () = (s == side::BID ? 1000 - l : 1001 + l);
+            }
+
+            if (p.visit (pre_message { msg.hdr ().type () }, & msg, ctx))
+            {
+                p.visit (msg, ctx);
+                p.visit (post_message { msg.hdr ().type () }, ctx);
+            }
+        }
+    }
+}
+
+} // end of anonymous
+//............................................................................
+//............................................................................
+/*
+ * an order entry/cancel mix against a static book, through the OUCH request handler
+ * of 'mock_ouch_server' "matching" mode (Soup framing, OUCH decoding, engine, and
+ * response scheduling)
+ */
+TEST (perf_mock_matching_engine, order_throughput)
+{
+    constexpr int32_t depth         = 20;
+    constexpr int32_t request_count = 1000000;
+    constexpr int32_t live_limit    = 1000;
+    constexpr int32_t passes        = 3;
+
+    constexpr double rate_min       = 1.0e6; // requests/s
+
+    uint64_t rnd = test::env::random_seed<uint64_t> ();
+
+    // pre-build a wire image of all requests (cancels target orders submitted as DAY, which
+    // may no longer be live by then):
+
+    std::vector<int8_t> requests { };
+    {
+        requests.reserve (request_count * sizeof (framed<ouch::submit_order>));
+
+        std::vector<order_token> live { };
+        live.reserve (live_limit);
+
+        uint32_t counter { 100 };
+
+        for (int32_t i = 0; i < request_count; ++ i)
+        {
+            uint64_t const r = util::xorshift (rnd);
+
+            if (! live.empty () && ((signed_cast (live.size ()) >= live_limit) || ((r & 0x3) == 0)))
+            {
+                int32_t const ix = (r >> 8) % live.size ();
+
+                ouch::cancel_order & msg = append<ouch::cancel_order> (requests);
+                {
+                    msg.type () = ouch::send_message_type::cancel_order;
+                    copy_to_alphanum (live [ix], msg.otk ());
+                }
+
+                live [ix] = live.back ();
+                live.pop_back ();
+            }
+            else
+            {
+                side::enum_t const s = static_cast<side::enum_t> ((r >> 2) & 0x1);
+                int32_t const offset = ((r >> 3) % (depth + 2)) - 2; // some marketable
+
+                order_token const otk = order_token_generator::make_with_prefix<1> (counter ++, 0xA);
+
+                ouch::submit_order & msg = append<ouch::submit_order> (requests);
+                {
+                    msg.type () = ouch::send_message_type::submit_order;
+                    copy_to_alphanum (otk, msg.otk ());
+                    msg.iid () = iid;
+                    msg.side () = (s == side::BID ? ord_side::BUY : ord_side::SELL);
+                    msg.qty () = 1 + ((r >> 16) % 100);
+                    msg.price () = (s == side::BID ? 1000 - offset : 1001 + offset);
+                    msg.TIF () = (offset < 0 ? ord_TIF::IOC : ord_TIF::DAY);
+                }
+
+                if (offset >= 0) live.push_back (otk);
+            }
+        }
+    }
+    LOG_info << "request wire image: " << requests.size () << " byte(s)";
+
+    double rate_best { };
+
+    for (int32_t pass = 0; pass < passes; ++ pass)
+    {
+        server s { };
+        add_market_depth (s.m_engine, depth);
+
+        io::client_connection cc { { } }; // [responses are never sent]
+        handler h { s, cc, { { "seed", test::env::random_seed<uint64_t> () }, { "session_ID", 1 } } };
+
+        handler_ctx ctx { };
+        field<_partition_> (ctx) = 0;
+
+        int32_t const size = requests.size ();
+        int32_t consumed { };
+
+        timestamp_t const t_start = sys::realtime_utc ();
+        {
+            field<_ts_local_> (ctx) = t_start;
+
+            while (consumed < size)
+            {
+                int32_t const rc = h.consume (ctx, & requests [consumed], size - consumed);
+                ASSERT_GT (rc, 0);
+
+                consumed += rc;
+            }
+        }
+        timestamp_t const t_elapsed = sys::realtime_utc () - t_start;
+
+        double const rate = request_count * 1.0e9 / t_elapsed;
+        rate_best = std::max (rate_best, rate);
+
+        LOG_info << "[pass " << pass << "] " << request_count << " client requests (" << s.m_action_count << " responses) in " << (t_elapsed / 1000) << " usec: " << rate << " request(s)/s";
+
+        EXPECT_GE (s.m_action_count, request_count); // every request gets at least one response
+    }
+
+    EXPECT_GE (rate_best, rate_min);
+}
+
+} // end of 'ASX'
+} // end of 'market'
+} // end of namespace
+//----------------------------------------------------------------------------
+
+#endif // VR_RELEASE
@@ -0,0 +1,392 @@
+
+#include "vr/market/sources/mock/asx/mock_matching_engine.h"
+
+#include "vr/market/books/asx/market_data_listener.h"
+#include "vr/market/books/book_event_context.h"
+#include "vr/market/books/limit_order_book.h"
+#include "vr/market/sources/asx/itch/ITCH_pipeline.h"
+
+#include "vr/test/utility.h"
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace market
+{
+namespace ASX
+{
+//............................................................................
+//............................................................................
+namespace
+{
+
+using book_type         = limit_order_book<price_si_t, oid_t, level<_qty_, _order_count_>>;
+using engine_type       = mock_matching_engine<book_type>;
+
+using visit_ctx         = book_event_context<_book_, _partition_>;
+
+using pipeline          = ITCH_pipeline
+                        <
+                            engine_type::selector<visit_ctx>,
+                            engine_type::tracker<visit_ctx>,
+                            market_data_listener<source::ASX, book_type, visit_ctx>
+                        >;
+
+using price_traits      = engine_type::price_traits;
+
+constexpr iid_t iid     = 123;
+
+//............................................................................
+/*
+ * builds ITCH messages and pushes them through a pipeline the way 'Mold_frame_' would
+ */
+struct market final
+{
+    market (engine_type & engine) :
+        m_pipeline { { { "engine", & engine } } }
+    {
+    }
+
+    template<typename MSG>
+    void deliver (MSG const & msg)
+    {
+        if (m_pipeline.visit (pre_message { msg.hdr ().type () }, & msg, m_ctx))
+        {
+            m_pipeline.visit (msg, m_ctx);
+            m_pipeline.visit (post_message { msg.hdr ().type () }, m_ctx);
+        }
+    }
+
+    void add (oid_t const oid, side::enum_t const s, int32_t const price, int64_t const qty)
+    {
+        itch::order_add msg { };
+        {
+            msg.hdr ().type () = itch::message_type::order_add;
+            msg.oid () = oid;
+            msg.iid () = iid;
+            msg.side () = (s == side::BID ? ord_side::BUY : ord_side::SELL);
+            msg.qty () = qty;
+            msg.price () = price;
+        }
+        deliver (msg);
+    }
+
+    void fill (oid_t const oid, side::enum_t const s, int64_t const qty)
+    {
+        itch::order_fill msg { };
+        {
+            msg.hdr ().type () = itch::message_type::order_fill;
+            msg.oid () = oid;
+            msg.iid () = iid;
+            msg.side () = (s == side::BID ? ord_side::BUY : ord_side::SELL);
+            msg.qty () = qty;
+        }
+        deliver (msg);
+    }
+
+    void fill_with_price (oid_t const oid, side::enum_t const s, int64_t const qty, int32_t const price)
+    {
+        itch::order_fill_with_price msg { };
+        {
+            msg.hdr ().type () = itch::message_type::order_fill_with_price;
+            msg.oid () = oid;
+            msg.iid () = iid;
+            msg.side () = (s == side::BID ? ord_side::BUY : ord_side::SELL);
+            msg.qty () = qty;
+            msg.price () = price;
+        }
+        deliver (msg);
+    }
+
+    void replace (oid_t const oid, side::enum_t const s, int32_t const price, int64_t const qty)
+    {
+        itch::order_replace msg { };
+        {
+            msg.hdr ().type () = itch::message_type::order_replace;
+            msg.oid () = oid;
+            msg.iid () = iid;
+            msg.side () = (s == side::BID ? ord_side::BUY : ord_side::SELL);
+            msg.qty () = qty;
+            msg.price () = price;
+        }
+        deliver (msg);
+    }
+
+    void remove (oid_t const oid, side::enum_t const s)
+    {
+        itch::order_delete msg { };
+        {
+            msg.hdr ().type () = itch::message_type::order_delete;
+            msg.oid () = oid;
+            msg.iid () = iid;
+            msg.side () = (s == side::BID ? ord_side::BUY : ord_side::SELL);
+        }
+        deliver (msg);
+    }
+
+    pipeline m_pipeline;
+    visit_ctx m_ctx { };
+
+}; // end of class
+
+VR_FORCEINLINE price_si_t
+px (int32_t const wire_price)
+{
+    return price_traits::wire_to_book (wire_price);
+}
+
+int64_t
+executed_qty (std::vector<engine_type::report> const & reports, engine_type::order_ref const ref)
+{
+    int64_t r { };
+
+    for (auto const & rp : reports)
+    {
+        if ((rp.m_type == match_report::executed) & (rp.m_ref == ref)) r += rp.m_qty;
+    }
+
+    return r;
+}
+
+} // end of anonymous
+//............................................................................
+//............................................................................
+
+TEST (mock_matching_engine, aggressive)
+{
+    engine_type e { };
+    market m { e };
+
+    // asks: 100 @ 1010, 200 @ 1020; bids: 50 @ 1000
+
+    m.add (1, side::ASK, 1010, 100);
+    m.add (2, side::ASK, 1020, 200);
+    m.add (3, side::BID, 1000, 50);
+
+    // IOC buy 250 @ 1020: takes 100 @ 1010 and 150 @ 1020, nothing left to cancel:
+    {
+        e.submit (10, iid, side::BID, px (1020), 250, ord_TIF::IOC);
+
+        auto const & rs = e.reports ();
+        ASSERT_EQ (3, signed_cast (rs.size ()));
+
+        EXPECT_EQ (match_report::accepted, rs [0].m_type);
+
+        EXPECT_EQ (match_report::executed, rs [1].m_type);
+        EXPECT_EQ (px (1010), rs [1].m_price);
+        EXPECT_EQ (100, rs [1].m_qty);
+
+        EXPECT_EQ (match_report::executed, rs [2].m_type);
+        EXPECT_EQ (px (1020), rs [2].m_price);
+        EXPECT_EQ (150, rs [2].m_qty);
+
+        EXPECT_EQ (0, e.live_order_count ());
+        e.reports ().clear ();
+    }
+    // the displayed book is not depleted by client executions; a FOK sell for more than
+    // what is bid is canceled outright:
+    {
+        e.submit (11, iid, side::ASK, px (1000), 60, ord_TIF::FOK);
+
+        auto const & rs = e.reports ();
+        ASSERT_EQ (2, signed_cast (rs.size ()));
+
+        EXPECT_EQ (match_report::accepted, rs [0].m_type);
+        EXPECT_EQ (match_report::canceled, rs [1].m_type);
+
+        e.reports ().clear ();
+    }
+    // a partially marketable DAY order rests the remainder:
+    {
+        e.submit (12, iid, side::ASK, px (1000), 80, ord_TIF::DAY);
+
+        EXPECT_EQ (50, executed_qty (e.reports (), 12));
+        EXPECT_EQ (30, e.open_qty (12));
+        EXPECT_EQ (0, e.queue_ahead (12)); // nothing else displayed at 1000 on the ask side
+
+        e.reports ().clear ();
+    }
+    // duplicate refs are rejected:
+    {
+        e.submit (12, iid, side::ASK, px (1100), 10, ord_TIF::DAY);
+
+        ASSERT_EQ (1, signed_cast (e.reports ().size ()));
+        EXPECT_EQ (match_report::rejected, e.reports ()[0].m_type);
+    }
+}
+
+TEST (mock_matching_engine, queue_position)
+{
+    engine_type e { };
+    market m { e };
+
+    m.add (1, side::BID, 1000, 100);
+    m.add (2, side::BID, 1000, 200);
+    m.add (3, side::BID, 990, 500);
+
+    // join the 1000 bid behind 300:
+
+    e.submit (10, iid, side::BID, px (1000), 50, ord_TIF::DAY);
+    EXPECT_EQ (300, e.queue_ahead (10));
+
+    // later market orders at the same price queue behind us:
+
+    m.add (4, side::BID, 1000, 1000);
+    EXPECT_EQ (300, e.queue_ahead (10));
+
+    // a fill of 100 at 1000 moves us up:
+
+    m.fill (1, side::BID, 100);
+    EXPECT_EQ (200, e.queue_ahead (10));
+    EXPECT_EQ (0, executed_qty (e.reports (), 10));
+
+    // a delete of a market order at our level reduces what's ahead proportionally
+    // (200 of 1200 displayed, of which 200 are ahead of us):
+
+    m.remove (4, side::BID);
+    EXPECT_EQ (200 - (1000 * 200) / 1200, e.queue_ahead (10));
+
+    int64_t const ahead = e.queue_ahead (10);
+
+    // a fill exceeding what's ahead reaches us:
+
+    m.fill (2, side::BID, 200);
+
+    EXPECT_EQ (0, e.queue_ahead (10));
+    EXPECT_EQ (std::min<int64_t> (50, 200 - ahead), executed_qty (e.reports (), 10));
+
+    e.reports ().clear ();
+
+    // a resting order behind the market price is traded through:
+
+    e.submit (11, iid, side::BID, px (995), 40, ord_TIF::DAY);
+    EXPECT_EQ (0, e.queue_ahead (11));
+
+    m.fill (3, side::BID, 30); // a trade at 990 means 995 would have been hit first
+
+    EXPECT_EQ (30, executed_qty (e.reports (), 11));
+    EXPECT_EQ (10, e.open_qty (11));
+
+    e.reports ().clear ();
+
+    // cancel and replace:
+
+    e.replace (11, 12, px (995), 5); // qty reduction keeps priority
+    ASSERT_EQ (1, signed_cast (e.reports ().size ()));
+    EXPECT_EQ (match_report::replaced, e.reports ()[0].m_type);
+    EXPECT_EQ (11, e.reports ()[0].m_ref_prev);
+    EXPECT_EQ (5, e.open_qty (12));
+    EXPECT_EQ (0, e.open_qty (11));
+
+    e.cancel (12);
+    EXPECT_EQ (match_report::canceled, e.reports ().back ().m_type);
+    EXPECT_EQ (0, e.live_order_count () - (e.open_qty (10) > 0));
+}
+
+TEST (mock_matching_engine, trade_through)
+{
+    engine_type e { };
+    market m { e };
+
+    // a client bid at 990 that is ahead of all displayed qty at 990, and one at 995 (which
+    // any market trade at 990 trades through):
+
+    e.submit (10, iid, side::BID, px (990), 50, ord_TIF::DAY);
+    EXPECT_EQ (0, e.queue_ahead (10));
+
+    m.add (1, side::BID, 990, 30);
+
+    e.submit (11, iid, side::BID, px (995), 20, ord_TIF::DAY);
+    EXPECT_EQ (0, e.queue_ahead (11));
+
+    e.reports ().clear ();
+
+    // a market fill of 30 at 990 would have hit 995 first and only what's left of it
+    // would have reached 990:
+
+    m.fill (1, side::BID, 30);
+
+    EXPECT_EQ (20, executed_qty (e.reports (), 11));
+    EXPECT_EQ (10, executed_qty (e.reports (), 10));
+    EXPECT_EQ (40, e.open_qty (10));
+    EXPECT_EQ (0, e.open_qty (11));
+
+    // client fills never add up to more than the market fill:
+
+    e.reports ().clear ();
+
+    m.add (2, side::BID, 990, 100);
+    e.submit (12, iid, side::BID, px (995), 100, ord_TIF::DAY);
+    e.reports ().clear ();
+
+    m.fill (2, side::BID, 60);
+
+    EXPECT_EQ (60, executed_qty (e.reports (), 12));
+    EXPECT_EQ (0, executed_qty (e.reports (), 10));
+}
+
+
+TEST (mock_matching_engine, fill_with_price)
+{
+    engine_type e { };
+    market m { e };
+
+    e.submit (10, iid, side::BID, px (990), 50, ord_TIF::DAY);
+    m.add (1, side::BID, 990, 30);
+
+    e.reports ().clear ();
+
+    // a fill of a market order behind the client order, at a price other than its level's:
+
+    m.fill_with_price (1, side::BID, 20, 985);
+
+    ASSERT_EQ (20, executed_qty (e.reports (), 10));
+    EXPECT_EQ (px (985), e.reports ().back ().m_price);
+    EXPECT_EQ (30, e.open_qty (10));
+}
+
+TEST (mock_matching_engine, crossing_liquidity)
+{
+    engine_type e { };
+    market m { e };
+
+    m.add (1, side::BID, 990, 100);
+    m.add (2, side::ASK, 1010, 100);
+
+    // a client ask improving the market:
+
+    e.submit (10, iid, side::ASK, px (1000), 50, ord_TIF::DAY);
+    ASSERT_EQ (50, e.open_qty (10));
+
+    e.reports ().clear ();
+
+    // a market bid that also crosses the market's own asks (e.g. in an auction) doesn't trade:
+
+    m.add (3, side::BID, 1010, 30);
+
+    EXPECT_EQ (0, executed_qty (e.reports (), 10));
+    m.remove (3, side::BID);
+
+    // new market bids that cross only the client ask execute it, at the client order's price:
+
+    m.add (4, side::BID, 1000, 30);
+
+    EXPECT_EQ (30, executed_qty (e.reports (), 10));
+    EXPECT_EQ (px (1000), e.reports ().back ().m_price);
+    EXPECT_EQ (20, e.open_qty (10));
+
+    e.reports ().clear ();
+
+    // so does a market bid replaced to a crossing price (but only up to the remaining client qty):
+
+    m.replace (1, side::BID, 1005, 40);
+
+    EXPECT_EQ (20, executed_qty (e.reports (), 10));
+    EXPECT_EQ (0, e.open_qty (10));
+    EXPECT_EQ (0, e.live_order_count ());
+}
+
+} // end of 'ASX'
+} // end of 'market'
+} // end of namespace
+//----------------------------------------------------------------------------
@@ -3,8 +3,10 @@
 #include "vr/market/sources/asx/ouch/error_codes.h"
 #include "vr/market/sources/asx/ouch/OUCH_visitor.h"
 #include "vr/market/sources/asx/ouch/Soup_frame_.h"
+#include "vr/market/sources/mock/asx/mock_matching_engine.h"
 #include "vr/market/sources/mock/asx/mock_oid_counter.h"
 #include "vr/market/sources/mock/asx/mock_order.h"
+#include "vr/market/sources/mock/asx/mock_ouch_orders.h"
 #include "vr/market/sources/mock/mock_market_event_context.h"
 #include "vr/market/sources/mock/mock_response.h"
 #include "vr/market/sources/mock/utility.h" // random_range_split
@@ -31,12 +33,15 @@ constexpr int64_t mock_seqnum_seed ()       { return 100; }
 //............................................................................
 
 template<typename TAG, typename MSG>
-VR_FORCEINLINE order_token const &
+VR_FORCEINLINE order_token
 otk_of (MSG const & msg)
 {
     vr_static_assert (has_field<TAG, MSG> ());
 
-    return (* reinterpret_cast<order_token const *> (& field<TAG> (msg)[0]));
+    order_token r;
+    copy_from_alphanum (field<TAG> (msg), r); // note: client tokens can be blank-padded
+
+    return r;
 }
 //............................................................................
 // OUCH response utilities:
@@ -230,7 +235,7 @@ struct scripted_handler: public mock_ouch_handler_base<SERVER, CTX, /* DERIVED *
         timestamp_t const ts_start = ts_local + runif_nonnegative (m_eval_time_mean, m_eval_time_range, m_rnd);
         std::unique_ptr<mock_response> action { };
 
-        order_token const & otk = impl::otk_of<_otk_> (msg);
+        order_token const otk = impl::otk_of<_otk_> (msg);
         check_condition (! m_otk_map.count (otk), otk);
 
         switch (str_hash_32 (scenario))
@@ -334,7 +339,7 @@ struct scripted_handler: public mock_ouch_handler_base<SERVER, CTX, /* DERIVED *
         timestamp_t const ts_start = ts_local + runif_nonnegative (m_eval_time_mean, m_eval_time_range, m_rnd);
         std::unique_ptr<mock_response> action { };
 
-        order_token const & otk = impl::otk_of<_otk_> (msg);
+        order_token const otk = impl::otk_of<_otk_> (msg);
 
         auto const i = m_otk_map.find (otk);
         check_condition (i != m_otk_map.end (), otk);
@@ -346,7 +351,7 @@ struct scripted_handler: public mock_ouch_handler_base<SERVER, CTX, /* DERIVED *
         mo.m_qty = msg.qty ();
         // TODO short_sell_qty and MAQ ?
 
-        order_token const & new_otk = impl::otk_of<_new_otk_> (msg);
+        order_token const new_otk = impl::otk_of<_new_otk_> (msg);
         m_otk_map.emplace (new_otk, & mo); // alias
          {
             // enqueue 'order_replaced' response:
@@ -399,7 +404,7 @@ struct scripted_handler: public mock_ouch_handler_base<SERVER, CTX, /* DERIVED *
         timestamp_t const ts_start = ts_local + runif_nonnegative (m_eval_time_mean, m_eval_time_range, m_rnd);
         std::unique_ptr<mock_response> action { };
 
-        order_token const & otk = impl::otk_of<_otk_> (msg);
+        order_token const otk = impl::otk_of<_otk_> (msg);
 
         auto const i = m_otk_map.find (otk);
         check_condition (i != m_otk_map.end (), otk);
@@ -461,6 +466,168 @@ struct scripted_handler: public mock_ouch_handler_base<SERVER, CTX, /* DERIVED *
 
 }; // end of class
 
+//............................................................................
+/*
+ * like 'scripted_handler', this is in 1:1 association with a client connection ('m_cc'),
+ * but order outcomes are decided by a 'mock_matching_engine' shared by all sessions
+ * of the 'SERVER':
+ *
+ *  - 'SERVER' must provide 'matching_engine_type', 'matching_engine()', and
+ *    'enqueue_action(pix, action)';
+ *  - engine order refs are ('session_ID' << 32 | per-session counter), which is how
+ *    the server routes executions triggered by market data back to their sessions
+ *    (via @ref on_market_report());
+ *  - token bookkeeping and report -> OUCH translation are done by 'mock_ouch_orders'
+ *    (shared with 'backtester'), with this handler acting as its response sink
+ *
+ * responses to a given request are sequenced 1ns apart to preserve their order in
+ * the server's action queue
+ */
+template<typename SERVER, typename CTX>
+struct matching_handler: public mock_ouch_handler_base<SERVER, CTX, /* DERIVED */matching_handler<SERVER, CTX>>
+{
+    using super         = mock_ouch_handler_base<SERVER, CTX, matching_handler<SERVER, CTX>>;
+
+    using engine_type   = typename SERVER::matching_engine_type;
+    using order_ref     = typename engine_type::order_ref;
+    using report        = typename engine_type::report;
+    using price_traits  = typename engine_type::price_traits;
+
+    using super::hdr_len;
+
+
+    matching_handler (SERVER & parent, io::client_connection & cc, arg_map const & args) :
+        super (parent, cc, args),
+        m_session_ID { args.get<int32_t> ("session_ID") },
+        m_orders { parent.matching_engine () }
+    {
+    }
+
+    // OUCH_visitor<send>:
+
+    using super::visit;
+
+    /*
+     * submit_order
+     */
+    bool visit (ouch::submit_order const & msg, CTX & ctx) // override
+    {
+        vr_static_assert (has_field<_partition_, CTX> ());
+        vr_static_assert (has_field<_ts_local_, CTX> ());
+
+        int32_t const pix = field<_partition_> (ctx);
+        timestamp_t const ts_local = field<_ts_local_> (ctx); // this is actually 'now_utc' clock time of the parent server
+
+        LOG_trace1 <<  "[P" << pix << ", " << print_timestamp (ts_local) << "] client request " << print (msg);
+
+        timestamp_t const ts_start = ts_local + runif_nonnegative (m_eval_time_mean, m_eval_time_range, m_rnd);
+
+        m_orders.submit (* this, pix, ts_start, next_ref (), impl::otk_of<_otk_> (msg),
+                         msg.iid (), msg.side (), price_traits::wire_to_book (msg.price ()), msg.qty (), msg.TIF ());
+
+        return true;
+    }
+
+    /*
+     * replace_order
+     */
+    bool visit (ouch::replace_order const & msg, CTX & ctx) // override
+    {
+        vr_static_assert (has_field<_partition_, CTX> ());
+        vr_static_assert (has_field<_ts_local_, CTX> ());
+
+        int32_t const pix = field<_partition_> (ctx);
+        timestamp_t const ts_local = field<_ts_local_> (ctx); // this is actually 'now_utc' clock time of the parent server
+
+        LOG_trace1 <<  "[P" << pix << ", " << print_timestamp (ts_local) << "] client request " << print (msg);
+
+        timestamp_t const ts_start = ts_local + runif_nonnegative (m_eval_time_mean, m_eval_time_range, m_rnd);
+
+        m_orders.replace (* this, pix, ts_start, next_ref (), impl::otk_of<_otk_> (msg), impl::otk_of<_new_otk_> (msg),
+                          price_traits::wire_to_book (msg.price ()), msg.qty ());
+
+        return true;
+    }
+
+    /*
+     * cancel_order
+     */
+    bool visit (ouch::cancel_order const & msg, CTX & ctx) // override
+    {
+        vr_static_assert (has_field<_partition_, CTX> ());
+        vr_static_assert (has_field<_ts_local_, CTX> ());
+
+        int32_t const pix = field<_partition_> (ctx);
+        timestamp_t const ts_local = field<_ts_local_> (ctx); // this is actually 'now_utc' clock time of the parent server
+
+        LOG_trace1 <<  "[P" << pix << ", " << print_timestamp (ts_local) << "] client request " << print (msg);
+
+        timestamp_t const ts_start = ts_local + runif_nonnegative (m_eval_time_mean, m_eval_time_range, m_rnd);
+
+        m_orders.cancel (* this, pix, ts_start, impl::otk_of<_otk_> (msg));
+
+        return true;
+    }
+
+    // server callbacks:
+
+    /*
+     * handle a report caused by market data for an order that belongs to this session
+     */
+    void on_market_report (int32_t const pix, timestamp_t const now_utc, report const & r)
+    {
+        timestamp_t const ts_start = now_utc + runif_nonnegative (m_eval_time_mean, m_eval_time_range, m_rnd);
+
+        m_orders.on_market_report (* this, ts_start, r);
+    }
+
+    /*
+     * cancel all of this session's live orders in the engine, without responding
+     * (the session is closing)
+     */
+    VR_ASSUME_COLD void cancel_all ()
+    {
+        int32_t const count = m_orders.cancel_all ();
+
+        LOG_trace1 << "[session " << m_session_ID << "] canceled " << count << " live order(s)";
+    }
+
+    // mock_ouch_orders sink:
+
+    template<typename RESPONSE, typename FILL>
+    void respond (int32_t const pix, timestamp_t const ts_start, FILL && fill)
+    {
+        std::unique_ptr<int8_t []> r_data { super::template allocate_<RESPONSE> () };
+
+        fill (* static_cast<RESPONSE *> (addr_plus (r_data.get (), hdr_len ())));
+
+        constexpr int32_t r_len = hdr_len () + sizeof (RESPONSE);
+
+        std::vector<int32_t> len_steps { random_range_split (r_len, 2, m_rnd) }; // TODO randomize 'n'
+
+        std::unique_ptr<mock_response> action { new ouch_response { m_cc, ts_start, std::move (len_steps), std::move (r_data) } };
+
+        m_parent.enqueue_action (pix, std::move (action)); // note: last use of 'action'
+    }
+
+
+    order_ref next_ref ()
+    {
+        return ((static_cast<int64_t> (m_session_ID) << 32) | (++ m_ref_counter));
+    }
+
+
+    using super::m_parent;
+    using super::m_cc;
+    using super::m_rnd;
+    using super::m_eval_time_mean;
+    using super::m_eval_time_range;
+    int32_t const m_session_ID;
+    int32_t m_ref_counter { };
+    mock_ouch_orders<engine_type> m_orders;     // this session's live orders
+
+}; // end of class
+
 } // end of 'ASX'
 } // end of 'market'
 } // end of namespace
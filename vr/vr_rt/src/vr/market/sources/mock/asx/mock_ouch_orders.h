@@ -0,0 +1,360 @@
+#pragma once
+
+#include "vr/market/sources/asx/defs.h"
+#include "vr/market/sources/asx/ouch/error_codes.h"
+#include "vr/market/sources/asx/ouch/messages.h"
+#include "vr/market/sources/mock/asx/mock_matching_engine.h"
+#include "vr/util/logging.h"
+
+#include <boost/unordered_map.hpp>
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace market
+{
+namespace ASX
+{
+/**
+ * client order bookkeeping shared by the OUCH front ends of a @ref mock_matching_engine
+ * ('matching_handler' and 'backtester'): maps client order tokens to engine order refs
+ * and translates engine reports into OUCH responses
+ *
+ * responses are produced through a 'SINK' (passed into each call) that must provide
+ *
+ *      template<typename MSG, typename FILL>
+ *      void respond (int32_t pix, timestamp_t ts, FILL && fill);
+ *
+ * which is expected to allocate a blank-filled 'MSG' payload, invoke 'fill (MSG &)' on
+ * it (this sets all fields, including the header) and queue the result; successive
+ * responses to the same request are sequenced 1ns apart
+ *
+ * @note order refs are chosen by the caller and must be unique among live orders
+ * @note a replace that the engine rejects leaves the original order live under its
+ *       original token
+ * @note not thread-safe
+ */
+template<typename ENGINE>
+class mock_ouch_orders final: noncopyable
+{
+    public: // ...............................................................
+
+        using engine_type       = ENGINE;
+        using order_ref         = typename engine_type::order_ref;
+        using report            = typename engine_type::report;
+        using price_type        = typename engine_type::price_type;
+        using qty_type          = typename engine_type::qty_type;
+        using iid_type          = typename engine_type::iid_type;
+        using price_traits      = typename engine_type::price_traits;
+
+
+        mock_ouch_orders (engine_type & engine) :
+            m_engine { engine }
+        {
+        }
+
+        // ACCESSORs:
+
+        int32_t live_order_count () const
+        {
+            return m_orders.size ();
+        }
+
+        // MUTATORs:
+
+        template<typename SINK>
+        void submit (SINK & sink, int32_t const pix, timestamp_t ts, order_ref const ref, order_token const & otk,
+                     iid_type const iid, ord_side::enum_t const os, price_type const price, qty_type const qty, ord_TIF::enum_t const TIF)
+        {
+            if (VR_UNLIKELY (m_otk_map.count (otk)))
+            {
+                reject (sink, pix, ts, otk, fixnetix_reject::REJ_DUP_CLIENT_ORDER_ID);
+                return;
+            }
+
+            m_otk_map.emplace (otk, ref);
+            m_orders.emplace (ref, live_order { otk, pix });
+
+            m_engine.submit (ref, iid, ord_side::to_side (os), price, qty, TIF);
+
+            for (report const & r : m_engine.reports ())
+            {
+                if (r.m_type == match_report::accepted)
+                {
+                    ord_state::enum_t const state = (m_engine.open_qty (ref) > 0 ? ord_state::LIVE : ord_state::NOT_ON_BOOK);
+
+                    timestamp_t const ts_r = ts ++;
+
+                    sink.template respond<ouch::order_accepted> (pix, ts_r, [&](ouch::order_accepted & msg)
+                        {
+                            msg.hdr ().type () = ouch::recv_message_type::order_accepted;
+                            msg.hdr ().ts () = ts_r;
+
+                            copy_to_alphanum (otk, msg.otk ());
+                            msg.iid () = r.m_iid;
+                            msg.side () = os;
+                            msg.oid () = r.m_oid;
+                            msg.qty () = qty;
+                            msg.price () = price_traits::book_to_wire (price);
+                            msg.TIF () = TIF;
+                            msg.state () = state;
+                            msg.order_type () = ord_type::LIMIT;
+                            msg.short_sell_qty () = 0; // not modeled by the engine
+                            msg.MAQ () = 0;            // not modeled by the engine
+                        });
+                }
+                else
+                    emit (sink, pix, ts ++, r, otk);
+            }
+            m_engine.reports ().clear ();
+
+            release_if_done (ref);
+        }
+
+        template<typename SINK>
+        void replace (SINK & sink, int32_t const pix, timestamp_t ts, order_ref const new_ref, order_token const & otk, order_token const & new_otk,
+                      price_type const price, qty_type const qty)
+        {
+            auto const i = m_otk_map.find (otk);
+
+            if (VR_UNLIKELY ((i == m_otk_map.end ()) || m_otk_map.count (new_otk))) // no longer live or a token collision
+            {
+                reject (sink, pix, ts, new_otk, (i == m_otk_map.end () ? fixnetix_reject::REJ_NO_MATCH_OR_FULL : fixnetix_reject::REJ_DUP_CLIENT_ORDER_ID));
+                return;
+            }
+
+            order_ref const ref = i->second;
+
+            m_engine.replace (ref, new_ref, price, qty);
+
+            // remap to the new token/ref only if the engine took the replace:
+
+            if (VR_LIKELY (! m_engine.reports ().empty () && (m_engine.reports ().front ().m_type == match_report::replaced)))
+            {
+                int32_t const o_pix = m_orders [ref].m_pix;
+
+                m_otk_map.erase (i);
+                m_orders.erase (ref);
+
+                m_otk_map.emplace (new_otk, new_ref);
+                m_orders.emplace (new_ref, live_order { new_otk, o_pix });
+            }
+
+            for (report const & r : m_engine.reports ())
+            {
+                if (r.m_type == match_report::replaced)
+                {
+                    ord_state::enum_t const state = (m_engine.open_qty (new_ref) > 0 ? ord_state::LIVE : ord_state::NOT_ON_BOOK);
+
+                    timestamp_t const ts_r = ts ++;
+
+                    sink.template respond<ouch::order_replaced> (pix, ts_r, [&](ouch::order_replaced & msg)
+                        {
+                            msg.hdr ().type () = ouch::recv_message_type::order_replaced;
+                            msg.hdr ().ts () = ts_r;
+
+                            copy_to_alphanum (new_otk, msg.new_otk ());
+                            copy_to_alphanum (otk, msg.otk ());
+                            msg.iid () = r.m_iid;
+                            msg.side () = (r.m_side == side::BID ? ord_side::BUY : ord_side::SELL);
+                            msg.oid () = r.m_oid;
+                            msg.qty () = qty;
+                            msg.price () = price_traits::book_to_wire (price);
+                            msg.state () = state;
+                            msg.order_type () = ord_type::LIMIT;
+                            msg.short_sell_qty () = 0; // not modeled by the engine
+                            msg.MAQ () = 0;            // not modeled by the engine
+                        });
+                }
+                else
+                    emit (sink, pix, ts ++, r, new_otk);
+            }
+            m_engine.reports ().clear ();
+
+            release_if_done (new_ref);
+        }
+
+        template<typename SINK>
+        void cancel (SINK & sink, int32_t const pix, timestamp_t ts, order_token const & otk)
+        {
+            auto const i = m_otk_map.find (otk);
+
+            if (VR_UNLIKELY (i == m_otk_map.end ())) // already done (e.g. a fill/cancel race)
+            {
+                reject (sink, pix, ts, otk, fixnetix_reject::REJ_NO_MATCH_OR_FULL);
+                return;
+            }
+
+            order_ref const ref = i->second;
+
+            m_engine.cancel (ref);
+
+            for (report const & r : m_engine.reports ())
+            {
+                emit (sink, pix, ts ++, r, otk);
+            }
+            m_engine.reports ().clear ();
+
+            release_if_done (ref);
+        }
+
+        /**
+         * handle a report caused by market data (an execution or a cancel of a live order);
+         * the caller drains @ref mock_matching_engine::reports()
+         */
+        template<typename SINK>
+        void on_market_report (SINK & sink, timestamp_t const ts, report const & r)
+        {
+            emit (sink, -1, ts, r, order_token { }); // [pix and token are not used for reports other than 'rejected']
+
+            release_if_done (r.m_ref);
+        }
+
+        /**
+         * cancel all live orders in the engine, without responding (the client is gone)
+         *
+         * @return count of orders canceled
+         */
+        VR_ASSUME_COLD int32_t cancel_all ()
+        {
+            auto & reports = m_engine.reports ();
+            auto const report_count = reports.size (); // [may have undispatched reports for other clients]
+
+            for (auto const & kv : m_orders)
+            {
+                m_engine.cancel (kv.first);
+            }
+            reports.erase (reports.begin () + report_count, reports.end ()); // drop our 'canceled's
+
+            int32_t const r = m_orders.size ();
+
+            m_otk_map.clear ();
+            m_orders.clear ();
+
+            return r;
+        }
+
+    private: // ..............................................................
+
+        struct live_order final
+        {
+            order_token m_otk;  // latest token
+            int32_t m_pix;      // partition to respond on
+
+        }; // end of nested class
+
+        using otk_ref_map       = boost::unordered_map<order_token, order_ref>;
+        using order_map         = boost::unordered_map<order_ref, live_order>;
+
+
+        /*
+         * 'executed', 'canceled' and 'rejected' reports
+         *
+         * @param pix partition to reject on (not used for other report types)
+         * @param otk token to reject (not used for other report types)
+         */
+        template<typename SINK>
+        void emit (SINK & sink, int32_t const pix, timestamp_t const ts, report const & r, order_token const & otk)
+        {
+            switch (r.m_type)
+            {
+                case match_report::executed:
+                {
+                    live_order const & o = find_live (r.m_ref);
+
+                    sink.template respond<ouch::order_execution> (o.m_pix, ts, [&](ouch::order_execution & msg)
+                        {
+                            msg.hdr ().type () = ouch::recv_message_type::order_execution;
+                            msg.hdr ().ts () = ts;
+
+                            copy_to_alphanum (o.m_otk, msg.otk ());
+                            msg.iid () = r.m_iid;
+
+                            msg.qty () = r.m_qty;
+                            msg.price () = price_traits::book_to_wire (r.m_price);
+
+                            msg.match ().match () = r.m_match;
+                            msg.match ().combo_group () = 0;
+
+                            msg.deal_source () = 1;
+                            msg.match_attributes () = 0;
+                        });
+                }
+                break;
+
+                case match_report::canceled:
+                {
+                    live_order const & o = find_live (r.m_ref);
+
+                    sink.template respond<ouch::order_canceled> (o.m_pix, ts, [&](ouch::order_canceled & msg)
+                        {
+                            msg.hdr ().type () = ouch::recv_message_type::order_canceled;
+                            msg.hdr ().ts () = ts;
+
+                            copy_to_alphanum (o.m_otk, msg.otk ());
+                            msg.iid () = r.m_iid;
+                            msg.side () = (r.m_side == side::BID ? ord_side::BUY : ord_side::SELL);
+                            msg.oid () = r.m_oid;
+
+                            msg.cancel_code () = (r.m_qty > 0 ? cancel_reason::DELETED_BY_SYSTEM : cancel_reason::REQUESTED_BY_USER); // IOC/FOK remainders vs explicit cancels
+                        });
+                }
+                break;
+
+                case match_report::rejected: // ['r.m_ref' need not be mapped]
+                {
+                    assert_nonnegative (pix);
+
+                    reject (sink, pix, ts, otk, fixnetix_reject::REJ_DEFAULT_CODE);
+                }
+                break;
+
+                default: throw_x (illegal_state, "unexpected report type " + print (r.m_type));
+
+            } // end of switch
+        }
+
+        template<typename SINK>
+        void reject (SINK & sink, int32_t const pix, timestamp_t const ts, order_token const & otk, fixnetix_reject::enum_t const code)
+        {
+            sink.template respond<ouch::order_rejected> (pix, ts, [&](ouch::order_rejected & msg)
+                {
+                    msg.hdr ().type () = ouch::recv_message_type::order_rejected;
+                    msg.hdr ().ts () = ts;
+
+                    copy_to_alphanum (otk, msg.otk ());
+                    msg.reject_code () = code;
+                });
+        }
+
+        live_order const & find_live (order_ref const ref) const
+        {
+            auto const i = m_orders.find (ref);
+            check_condition (i != m_orders.end (), ref);
+
+            return i->second;
+        }
+
+        void release_if_done (order_ref const ref)
+        {
+            if (m_engine.open_qty (ref) > 0) return;
+
+            auto const i = m_orders.find (ref);
+            if (i != m_orders.end ())
+            {
+                m_otk_map.erase (i->second.m_otk);
+                m_orders.erase (i);
+            }
+        }
+
+
+        engine_type & m_engine;
+        otk_ref_map m_otk_map { };      // live orders, by their latest token
+        order_map m_orders { };         // inverse of 'm_otk_map'
+
+}; // end of class
+
+} // end of 'ASX'
+} // end of 'market'
+} // end of namespace
+//----------------------------------------------------------------------------
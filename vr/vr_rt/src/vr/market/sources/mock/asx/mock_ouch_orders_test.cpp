@@ -0,0 +1,221 @@
+#include "vr/market/sources/mock/asx/mock_ouch_orders.h"
+
+#include "vr/market/books/asx/market_data_listener.h"
+#include "vr/market/books/book_event_context.h"
+#include "vr/market/books/limit_order_book.h"
+#include "vr/market/sources/asx/itch/ITCH_pipeline.h"
+
+#include "vr/test/utility.h"
+
+//----------------------------------------------------------------------------
+namespace vr
+{
+namespace market
+{
+namespace ASX
+{
+//............................................................................
+//............................................................................
+namespace
+{
+
+using book_type         = limit_order_book<price_si_t, oid_t, level<_qty_, _order_count_>>;
+using engine_type       = mock_matching_engine<book_type>;
+using orders_type       = mock_ouch_orders<engine_type>;
+
+using visit_ctx         = book_event_context<_book_, _partition_>;
+
+using pipeline          = ITCH_pipeline
+                        <
+                            engine_type::selector<visit_ctx>,
+                            engine_type::tracker<visit_ctx>,
+                            market_data_listener<source::ASX, book_type, visit_ctx>
+                        >;
+
+using price_traits      = engine_type::price_traits;
+
+constexpr iid_t iid     = 123;
+
+//............................................................................
+
+struct market final
+{
+    market (engine_type & engine) :
+        m_pipeline { { { "engine", & engine } } }
+    {
+    }
+
+    template<typename MSG>
+    void deliver (MSG const & msg)
+    {
+        if (m_pipeline.visit (pre_message { msg.hdr ().type () }, & msg, m_ctx))
+        {
+            m_pipeline.visit (msg, m_ctx);
+            m_pipeline.visit (post_message { msg.hdr ().type () }, m_ctx);
+        }
+    }
+
+    void add (oid_t const oid, side::enum_t const s, int32_t const price, int64_t const qty)
+    {
+        itch::order_add msg { };
+        {
+            msg.hdr ().type () = itch::message_type::order_add;
+            msg.oid () = oid;
+            msg.iid () = iid;
+            msg.side () = (s == side::BID ? ord_side::BUY : ord_side::SELL);
+            msg.qty () = qty;
+            msg.price () = price;
+        }
+        deliver (msg);
+    }
+
+
+    pipeline m_pipeline;
+    visit_ctx m_ctx { };
+
+}; // end of class
+//............................................................................
+/*
+ * records responses the way 'matching_handler'/'backtester' would queue them
+ */
+struct recording_sink final
+{
+    template<typename MSG, typename FILL>
+    void respond (int32_t const pix, timestamp_t const ts, FILL && fill)
+    {
+        m_responses.emplace_back (pix, std::vector<int8_t> (sizeof (MSG), ' '));
+
+        fill (* reinterpret_cast<MSG *> (m_responses.back ().second.data ()));
+    }
+
+    template<typename MSG>
+    MSG const & at (int32_t const i) const
+    {
+        return (* reinterpret_cast<MSG const *> (m_responses [i].second.data ()));
+    }
+
+    ouch::recv_message_type::enum_t type (int32_t const i) const
+    {
+        return at<ouch::order_rejected> (i).hdr ().type ();
+    }
+
+    template<typename MSG>
+    order_token otk (int32_t const i) const
+    {
+        order_token r;
+        copy_from_alphanum (at<MSG> (i).otk (), r);
+
+        return r;
+    }
+
+
+    std::vector<std::pair<int32_t, std::vector<int8_t>>> m_responses { };
+
+}; // end of class
+
+VR_FORCEINLINE price_si_t
+px (int32_t const wire_price)
+{
+    return price_traits::wire_to_book (wire_price);
+}
+
+} // end of anonymous
+//............................................................................
+//............................................................................
+/*
+ * a replace that the engine rejects must leave the original order live under its
+ * original token (so that market executions and later cancels still find it)
+ */
+TEST (mock_ouch_orders, rejected_replace)
+{
+    engine_type e { };
+    market m { e };
+    orders_type orders { e };
+    recording_sink sink { };
+
+    int32_t const pix = 3;
+    order_token const otk { "A0000001" };
+    order_token const new_otk { "A0000002" };
+
+    m.add (1, side::ASK, 1010, 100);
+
+    orders.submit (sink, pix, 1000, 10, otk, iid, ord_side::BUY, px (1000), 50, ord_TIF::DAY);
+
+    ASSERT_EQ (1, signed_cast (sink.m_responses.size ()));
+    EXPECT_EQ (ouch::recv_message_type::order_accepted, sink.type (0));
+    EXPECT_EQ (pix, sink.m_responses [0].first);
+    EXPECT_EQ (1, orders.live_order_count ());
+
+    orders.replace (sink, pix, 2000, 11, otk, new_otk, px (1000), 0); // zero qty is rejected by the engine
+
+    ASSERT_EQ (2, signed_cast (sink.m_responses.size ()));
+    EXPECT_EQ (ouch::recv_message_type::order_rejected, sink.type (1));
+    EXPECT_EQ (new_otk, sink.otk<ouch::order_rejected> (1));
+    EXPECT_EQ (1, orders.live_order_count ());
+
+    // a market sell crossing the (still live) original order executes it under 'otk':
+
+    m.add (2, side::ASK, 1000, 20);
+
+    ASSERT_EQ (1, signed_cast (e.reports ().size ()));
+    orders.on_market_report (sink, 3000, e.reports ().front ());
+    e.reports ().clear ();
+
+    ASSERT_EQ (3, signed_cast (sink.m_responses.size ()));
+    EXPECT_EQ (ouch::recv_message_type::order_execution, sink.type (2));
+    EXPECT_EQ (otk, sink.otk<ouch::order_execution> (2));
+    EXPECT_EQ (20, sink.at<ouch::order_execution> (2).qty ());
+
+    // and the original token can still be canceled:
+
+    orders.cancel (sink, pix, 4000, otk);
+
+    ASSERT_EQ (4, signed_cast (sink.m_responses.size ()));
+    EXPECT_EQ (ouch::recv_message_type::order_canceled, sink.type (3));
+    EXPECT_EQ (otk, sink.otk<ouch::order_canceled> (3));
+    EXPECT_EQ (0, orders.live_order_count ());
+    EXPECT_EQ (0, e.live_order_count ());
+}
+
+TEST (mock_ouch_orders, replace)
+{
+    engine_type e { };
+    orders_type orders { e };
+    recording_sink sink { };
+
+    int32_t const pix = 0;
+    order_token const otk { "B0000001" };
+    order_token const new_otk { "B0000002" };
+
+    orders.submit (sink, pix, 1000, 10, otk, iid, ord_side::SELL, px (1010), 50, ord_TIF::DAY);
+    orders.replace (sink, pix, 2000, 11, otk, new_otk, px (1020), 40);
+
+    ASSERT_EQ (2, signed_cast (sink.m_responses.size ()));
+    EXPECT_EQ (ouch::recv_message_type::order_replaced, sink.type (1));
+    {
+        ouch::order_replaced const & msg = sink.at<ouch::order_replaced> (1);
+
+        order_token t;
+        copy_from_alphanum (msg.new_otk (), t);
+        EXPECT_EQ (new_otk, t);
+        EXPECT_EQ (otk, sink.otk<ouch::order_replaced> (1));
+
+        EXPECT_EQ (40, msg.qty ());
+        EXPECT_EQ (1020, msg.price ());
+    }
+
+    // the old token is gone, the new one is live:
+
+    orders.cancel (sink, pix, 3000, otk);
+    EXPECT_EQ (ouch::recv_message_type::order_rejected, sink.type (2));
+
+    orders.cancel (sink, pix, 4000, new_otk);
+    EXPECT_EQ (ouch::recv_message_type::order_canceled, sink.type (3));
+
+    EXPECT_EQ (0, orders.live_order_count ());
+}
+
+} // end of 'ASX'
+} // end of 'market'
+} // end of namespace
+//----------------------------------------------------------------------------
@@ -11,15 +11,20 @@
 #include "vr/io/net/utility.h" // min_size_or_zero, make_group_range_filter
 #include "vr/io/stream_factory.h"
 #include "vr/market/defs.h"
+#include "vr/market/sources/asx/defs.h" // partition_port_base()
+#include "vr/market/sources/mock/asx/mock_Mold_rewinder.h"
+#include "vr/market/sources/mock/utility.h" // mock_replay_clock
 #include "vr/rt/cfg/app_cfg.h"
 #include "vr/settings.h"
 #include "vr/sys/os.h"
 #include "vr/util/logging.h"
+#include "vr/util/random.h"
 #include "vr/util/timer_event_queue.h"
 
 #include <net/ethernet.h>
 #include <netinet/in.h> // IPPROTO_*
 #include <netinet/ip.h>
+#include <netinet/udp.h>
 
 #include <deque>
 
@@ -54,16 +59,25 @@ using mcast_link        = UDP_mcast_link<send<_timestamp_, _ring_>>;
 //............................................................................
 /**
  * c.f 'IP_mcast_sender' in "socket_link_test.cpp"
+ *
+ * optionally, Mold packets in ASX partition ports can be also recorded into a 'mock_Mold_rewinder'
+ * and/or randomly dropped instead of being sent (to exercise client gap recovery)
  */
 template<typename SEND_LINK> // TODO 'SEND_LINK' is always 'mcast_link' for now
 class ITCH_mcast_transform final: public IP_mcast_io_base
 {
     public: // ...............................................................
 
-        ITCH_mcast_transform (send_event_queue & seq, SEND_LINK & link) :
+        ITCH_mcast_transform (send_event_queue & seq, SEND_LINK & link, mock_replay_clock & clock, ASX::mock_Mold_rewinder * const rewinder, double const drop_rate, uint64_t const drop_seed) :
             m_send_event_queue { seq },
-            m_send_link { link }
+            m_send_link { link },
+            m_clock { clock },
+            m_rewinder { rewinder },
+            m_drop_threshold { static_cast<uint64_t> (drop_rate * std::numeric_limits<uint64_t>::max ()) },
+            m_rnd { drop_seed }
         {
+            check_condition ((drop_rate >= 0) && (drop_rate < 1), drop_rate);
+            check_nonzero (m_rnd);
         }
 
         int64_t const & enqueued_count () const
@@ -71,6 +85,11 @@ class ITCH_mcast_transform final: public IP_mcast_io_base
             return m_enqueued_count;
         }
 
+        int64_t const & dropped_count () const
+        {
+            return m_dropped_count;
+        }
+
         /*
          * consume the captured packet at 'data', place its output version it into 'm_send_link',
          * and schedule a send timer event
@@ -86,37 +105,50 @@ class ITCH_mcast_transform final: public IP_mcast_io_base
             if (ip_hdr->ip_p == IPPROTO_UDP) // use only UDP [mcast] packets
             {
                 timestamp_t const ts_local = field<_ts_local_> (ctx);
-                timestamp_t const ts_local_prev = m_ts_local_prev;
 
                 // TODO add an opt for setting the emit rate, faking Mold timestamps, etc
 
-                int64_t interval { };
-                if (VR_LIKELY (ts_local_prev))
-                {
-                    // note: across *different* partition ports, there is a small probability of mcast
-                    // packets read out of order from the capture raw socket;
-                    // rather than restore the true physical '_ts_local_' ordering it is much easier for our
-                    // mock purposes here to clip any negative deltas to zero:
+                // note: across *different* partition ports, there is a small probability of mcast
+                // packets read out of order from the capture raw socket;
+                // rather than restore the true physical '_ts_local_' ordering it is much easier for our
+                // mock purposes here to never schedule a packet ahead of its predecessor:
 
-                    // (similary, a true playback sim would have to edit the Mold timestamps which
-                    // requires an app-level visitor)
+                // (similary, a true playback sim would have to edit the Mold timestamps which
+                // requires an app-level visitor)
 
-                    interval = std::max<timestamp_t> (ts_local - ts_local_prev, 0);
+                timestamp_t const ts_due = m_clock.due_time (ts_local, sys::realtime_utc ()); // [shared with other replays of this capture]
 
-                    DLOG_trace3 << "replay interval " << interval << " ns (actual ts_local delta: " << (ts_local - ts_local_prev) << " ns)";
-                }
-                else
+                DLOG_trace3 << "replay delay " << (ts_due - m_ts_mock) << " ns";
+
+                m_ts_mock = std::max (m_ts_mock, ts_due);
+
+                if ((m_rewinder != nullptr) | (m_drop_threshold != 0))
                 {
-                    m_ts_mock = sys::realtime_utc ();
+                    ::udphdr const * const udp_hdr = static_cast<::udphdr const *> (addr_plus (ip_hdr, ip_hdr->ip_hl * 4));
+                    int32_t const pix = ntohs (udp_hdr->uh_dport) - ASX::partition_port_base ('A'); // TODO hardcoded feed choice
+
+                    if (vr_is_within (pix, ASX::partition_count ()))
+                    {
+                        if (m_rewinder != nullptr)
+                        {
+                            m_rewinder->record (pix, addr_plus (udp_hdr, sizeof (::udphdr)), ntohs (udp_hdr->uh_ulen) - sizeof (::udphdr));
+                        }
+
+                        if (unsigned_cast (util::xorshift (m_rnd)) < m_drop_threshold)
+                        {
+                            DLOG_trace1 << "[P" << pix << "] dropping raw packet of size " << packet_size << " byte(s)";
+
+                            ++ m_dropped_count;
+                            return packet_size;
+                        }
+                    }
                 }
-                m_ts_local_prev = ts_local;
 
                 DLOG_trace2 << '[' << m_enqueued_count << "] enqueuing raw packet of size " << packet_size << " byte(s): " << print (* ip_hdr);
 
                 addr_t const packet = m_send_link.send_allocate (packet_size, /* blank init */false);
                 std::memcpy (packet, data, packet_size);
 
-                m_ts_mock += interval;
                 m_send_event_queue.push_back (send_event { m_ts_mock, packet_size });
 
                 ++ m_enqueued_count;
@@ -129,9 +161,13 @@ class ITCH_mcast_transform final: public IP_mcast_io_base
 
         send_event_queue & m_send_event_queue;
         SEND_LINK & m_send_link;
-        timestamp_t m_ts_local_prev { };
+        mock_replay_clock & m_clock;
+        ASX::mock_Mold_rewinder * const m_rewinder;
+        uint64_t const m_drop_threshold;
+        uint64_t m_rnd;
         timestamp_t m_ts_mock { };
         int64_t m_enqueued_count { };
+        int64_t m_dropped_count { };
 
 }; // end of class
 //............................................................................
@@ -202,7 +238,20 @@ struct mock_mcast_server::pimpl final
         open_mcast (ifc, capacity);
         check_nonnull (m_send_link);
 
-        m_processor = std::make_unique<processor> (m_send_event_queue, * m_send_link);
+        // optional local rewinder stand-in and drop injection:
+
+        int32_t const rewinder_port_base = cfg.value ("rewinder_port_base", 0); // zero disables
+        if (rewinder_port_base > 0)
+        {
+            m_rewinder = std::make_unique<ASX::mock_Mold_rewinder> (arg_map { { "port_base", rewinder_port_base }, { "depth", cfg.value ("rewinder_depth", 1024 * 1024) } });
+        }
+
+        double const drop_rate = cfg.value ("drop_rate", 0.0);
+        uint64_t const drop_seed = cfg.value ("drop_seed", 123456789UL);
+
+        if (drop_rate > 0) LOG_info << "dropping partition packets with probability " << drop_rate << " (seed " << drop_seed << ')';
+
+        m_processor = std::make_unique<processor> (m_send_event_queue, * m_send_link, m_replay_clock, m_rewinder.get (), drop_rate, drop_seed);
 
         if (m_packet_begin > 0) skip_start_packets ();
 
@@ -211,11 +260,14 @@ struct mock_mcast_server::pimpl final
 
     VR_ASSUME_COLD void stop ()
     {
+        int64_t const dropped_count = (m_processor ? m_processor->dropped_count () : 0);
+
         m_processor.reset ();
+        m_rewinder.reset ();
         m_send_link.reset ();
         m_in.reset ();
 
-        LOG_info << "read " << m_packet_index << " source packet(s), skipped " << m_packet_begin << ", sent " << m_send_count;
+        LOG_info << "read " << m_packet_index << " source packet(s), skipped " << m_packet_begin << ", sent " << m_send_count << ", dropped " << dropped_count;
     }
 
     // core step logic:
@@ -224,6 +276,8 @@ struct mock_mcast_server::pimpl final
     {
         DLOG_trace2 << '[' << m_packet_index << '/' << m_packet_limit << ", state: " << m_state << "]: available " << m_available << ", queue size " << (m_processor->enqueued_count () - m_send_count);
 
+        if (m_rewinder) m_rewinder->poll (); // answer any rewind requests
+
         switch (VR_LIKELY_VALUE (m_state, state::running))
         {
             case state::add_src:
@@ -409,7 +463,9 @@ struct mock_mcast_server::pimpl final
     timestamp_t m_tz_offset { };                // set in 'start()'
     std::unique_ptr<std::istream> m_in { }; // opened in 'start()'
     std::unique_ptr<mcast_link> m_send_link { }; // created in 'start()'
+    std::unique_ptr<ASX::mock_Mold_rewinder> m_rewinder { }; // [optional] created in 'start()'
     send_event_queue m_send_event_queue { };
+    mock_replay_clock m_replay_clock { };
     std::unique_ptr<processor> m_processor { }; // created in 'start()'
     mapped_ring_buffer m_buf { initial_buf_capacity () };
     int64_t m_packet_begin { }; // set in 'start()'
@@ -433,6 +489,13 @@ mock_mcast_server::mock_mcast_server (scope_path const & cfg_path) :
 mock_mcast_server::~mock_mcast_server ()    = default; // pimpl
 //............................................................................
 
+mock_replay_clock &
+mock_mcast_server::replay_clock () const
+{
+    return m_impl->m_replay_clock;
+}
+//............................................................................
+
 void
 mock_mcast_server::start ()
 {
@@ -11,6 +11,7 @@ namespace vr
 {
 namespace market
 {
+class mock_replay_clock; // forward
 
 class mock_mcast_server final: public mc::steppable, public util::di::component, public startable
 {
@@ -19,6 +20,14 @@ class mock_mcast_server final: public mc::steppable, public util::di::component,
         mock_mcast_server (scope_path const & cfg_path);
         ~mock_mcast_server ();
 
+        // ACCESSORs:
+
+        /**
+         * @return the clock that paces this server's capture replay (for other mock
+         *         servers replaying the same capture to share)
+         */
+        mock_replay_clock & replay_clock () const;
+
     private: // ..............................................................
 
         class pimpl; // forward
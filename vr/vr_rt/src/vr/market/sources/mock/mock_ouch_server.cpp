@@ -2,14 +2,26 @@
 #include "vr/market/sources/mock/mock_ouch_server.h"
 
 #include "vr/fields.h"
+#include "vr/io/mapped_ring_buffer.h"
+#include "vr/io/net/IP_.h"
 #include "vr/io/net/socket_factory.h"
+#include "vr/io/net/UDP_.h"
 #include "vr/io/pcap/pcap_reader.h"
 #include "vr/io/net/utility.h" // min_size_or_zero, make_group_range_filter
 #include "vr/io/stream_factory.h"
+#include "vr/io/streams.h" // read_fully
+#include "vr/market/books/asx/market_data_listener.h"
+#include "vr/market/books/book_event_context.h"
+#include "vr/market/books/limit_order_book.h"
 #include "vr/market/defs.h"
+#include "vr/market/sources/asx/itch/ITCH_pipeline.h"
+#include "vr/market/sources/asx/itch/Mold_frame_.h"
+#include "vr/market/sources/mock/asx/mock_matching_engine.h"
 #include "vr/market/sources/mock/asx/mock_ouch_handlers.h"
 #include "vr/market/sources/mock/mock_market_event_context.h"
+#include "vr/market/sources/mock/mock_mcast_server.h"
 #include "vr/market/sources/mock/mock_response.h"
+#include "vr/market/sources/mock/utility.h" // mock_replay_clock
 #include "vr/mc/spinflag.h"
 #include "vr/mc/spinlock.h"
 #include "vr/rt/cfg/app_cfg.h"
@@ -59,8 +71,17 @@ struct mock_ouch_server::pimpl final
     using request_handler_ctx   = mock_market_event_context<_ts_origin_, _partition_, _ts_local_, _mock_scenario_>;
     using request_handler       = ASX::scripted_handler<mock_ouch_server::pimpl, request_handler_ctx>;
 
+    // "matching" mode:
+
+    using matching_engine_type  = ASX::mock_matching_engine<limit_order_book<price_si_t, ASX::oid_t, level<_qty_, _order_count_>>>;
+    using matching_handler      = ASX::matching_handler<mock_ouch_server::pimpl, request_handler_ctx>;
+
     static constexpr int32_t min_available ()           { return net::min_size_or_zero<request_handler>::value (); }
 
+    vr_static_assert (net::min_size_or_zero<matching_handler>::value () == net::min_size_or_zero<request_handler>::value ()); // same Soup framing
+
+    static constexpr int32_t replay_batch_limit ()      { return 64; } // max capture packets replayed per step
+
     static constexpr int32_t new_cc_check_mask ()       { return 0xFFFF; }
     static constexpr int32_t new_cc_check_stagger ()    { return 100009; }
 
@@ -101,6 +122,29 @@ struct mock_ouch_server::pimpl final
         check_nonzero (m_rng_seed);
         m_request_handler_args ["seed"] = m_rng_seed;
 
+        // optional response latency overrides:
+
+        for (std::string const n : { "eval_time_mean", "eval_time_range" })
+        {
+            if (cfg.count (n)) m_request_handler_args [n] = cfg.at (n).get<timestamp_t> ();
+        }
+
+        std::string const mode = cfg.value ("mode", "scripted");
+        LOG_info << "request handling mode: " << print (mode);
+
+        if (mode == "matching")
+        {
+            fs::path const data_root = cfg.at ("cap_root").get<std::string> (); // required in this mode
+            fs::path const in_file = data_root / "ASX" / gd::to_iso_string (m_session_date) / "asx-02" / "mcast.recv.p1p2.pcap.zst";
+
+            LOG_info << "matching against market data in " << print (in_file);
+
+            mock_replay_clock & clock = (m_parent.m_mcast_server ? m_parent.m_mcast_server->replay_clock () : m_replay_clock);
+
+            m_replay = std::make_unique<market_replay> (in_file, m_engine, clock);
+        }
+        else check_eq (mode, "scripted");
+
         int32_t const port_base = cfg.at ("server").at ("port");
         check_within (port_base, 64 * 1024);
 
@@ -176,7 +220,7 @@ struct mock_ouch_server::pimpl final
                 {
                     client_session & cs = kv.second;
 
-                    cs.close ();
+                    cs.close (); // [also cancels the session's orders in "matching" mode]
                 }
                 p.m_sessions.clear ();
 
@@ -195,6 +239,14 @@ struct mock_ouch_server::pimpl final
 
         timestamp_t const now_utc = sys::realtime_utc ();
 
+        // in "matching" mode, advance the market to 'now_utc' and send out any resulting executions:
+
+        if (m_replay)
+        {
+            m_replay->step (now_utc);
+            dispatch_market_reports (now_utc);
+        }
+
         // iterate over all active partitions:
 
         while (pix_mask > 0)
@@ -282,13 +334,13 @@ struct mock_ouch_server::pimpl final
                     }
 
                     LOG_trace2 << '[' << m_step_counter << ", " << print_timestamp (now_utc) << ", session " << kv.first << "] available " << available;
-                    assert_condition (cs.m_request_handler); // has been set
+                    assert_condition (cs.m_request_handler || cs.m_matching_handler); // has been set
 
                     int32_t consumed { };
 
                     do // loop over all full messages in the buffer
                     {
-                        int32_t const rrc = cs.m_request_handler->consume (ctx, addr_plus (rc.first, consumed), available);
+                        int32_t const rrc = (cs.m_matching_handler ? cs.m_matching_handler->consume (ctx, addr_plus (rc.first, consumed), available) : cs.m_request_handler->consume (ctx, addr_plus (rc.first, consumed), available));
                         if (rrc < 0)
                             break; // partial message
 
@@ -362,8 +414,10 @@ struct mock_ouch_server::pimpl final
                 {
                     m_request_handler_args ["seed"] = ++ m_rng_seed;
                 }
+                m_request_handler_args ["session_ID"] = cs_ID;
 
                 i->second.configure_handler (* this);
+                m_session_partitions.emplace (cs_ID, pix);
             }
 
             p.m_listener.m_accepted.clear ();
@@ -382,20 +436,139 @@ struct mock_ouch_server::pimpl final
 
         void configure_handler (mock_ouch_server::pimpl & parent)
         {
-            assert_condition (! m_request_handler);
-            m_request_handler = std::make_unique<request_handler> (parent, * this, parent.m_request_handler_args);
+            assert_condition (! m_request_handler && ! m_matching_handler);
+
+            if (parent.m_replay)
+                m_matching_handler = std::make_unique<matching_handler> (parent, * this, parent.m_request_handler_args);
+            else
+                m_request_handler = std::make_unique<request_handler> (parent, * this, parent.m_request_handler_args);
         }
 
         VR_ASSUME_COLD void close ()
         {
+            cancel_orders ();
+
             client_connection::close (); // [chain]
         }
 
+        /*
+         * in "matching" mode, pull all of this session's live orders out of the engine
+         * (otherwise they would keep trading against the market with nobody to report to)
+         */
+        VR_ASSUME_COLD void cancel_orders ()
+        {
+            if (m_matching_handler) m_matching_handler->cancel_all ();
+        }
+
 
         std::unique_ptr<request_handler> m_request_handler { };
+        std::unique_ptr<matching_handler> m_matching_handler { }; // [set instead of 'm_request_handler' in "matching" mode]
 
     }; // end of class
 
+    /*
+     * paces a capture through 'matching_engine_type' so that it tracks wall clock time
+     * as given by a 'mock_replay_clock' (shared with 'mock_mcast_server' if it is replaying
+     * the same capture)
+     */
+    struct market_replay final
+    {
+        using pcap_defs         = pcap_reader<>;
+        using size_type         = typename mapped_ring_buffer::size_type;
+
+        using visit_ctx         = book_event_context<_book_, _partition_, _ts_local_, _seqnum_, net::_dst_port_>;
+
+        using pipeline          = ASX::ITCH_pipeline
+                                <
+                                    matching_engine_type::selector<visit_ctx>,
+                                    matching_engine_type::tracker<visit_ctx>, // needs to be ahead of the book listener
+                                    market_data_listener<source::ASX, matching_engine_type::book_type, visit_ctx>
+                                >;
+
+        using visitor           = net::IP_<net::UDP_<ASX::Mold_frame_<pipeline>>>;
+
+        static constexpr int32_t min_available ()       { return pcap_defs::read_offset (); }
+
+
+        market_replay (fs::path const & in_file, matching_engine_type & engine, mock_replay_clock & clock) :
+            m_in { stream_factory::open_input (in_file) },
+            m_clock { clock },
+            m_visitor { { { "engine", & engine } } }
+        {
+            pcap_defs::read_header (* m_in);
+        }
+
+        void step (timestamp_t const now_utc)
+        {
+            for (int32_t k = 0; (k < replay_batch_limit ()) & ! m_src_eof; ++ k)
+            {
+                if (VR_UNLIKELY (m_available < min_available ())) // ensure we can read up to the included length field
+                {
+                    if (! read ()) break;
+                    continue;
+                }
+
+                addr_const_t const r = m_buf.r_position (); // invariant: points at the start of a capture header
+
+                pcap_defs::pcap_hdr_type const & pcap_hdr = * reinterpret_cast<pcap_defs::pcap_hdr_type const *> (r);
+
+                size_type const pcap_incl_len = pcap_hdr.incl_len ();
+                size_type const pcap_size = min_available () + pcap_incl_len;
+
+                if (VR_UNLIKELY (m_available < pcap_size))
+                {
+                    if (! read ()) break;
+                    continue; // 'm_buf' could have been remapped
+                }
+
+                timestamp_t const ts_capture = pcap_hdr.get_timestamp ();
+
+                if (m_clock.due_time (ts_capture, now_utc) > now_utc) break; // not due yet
+
+                field<_ts_local_> (m_ctx) = ts_capture;
+
+                m_visitor.consume (m_ctx, addr_plus (r, min_available ()), pcap_incl_len);
+
+                m_available -= pcap_size;
+                m_buf.r_advance (pcap_size); // consumed
+
+                ++ m_packet_count;
+            }
+        }
+
+        /*
+         * @return 'false' on EOF
+         */
+        bool read ()
+        {
+            size_type const r_count = read_fully (* m_in, m_buf.w_window (), m_buf.w_position ());
+
+            if (VR_LIKELY (r_count > 0))
+            {
+                m_buf.w_advance (r_count);
+                m_available += r_count;
+
+                return true;
+            }
+
+            LOG_info << "reached end of market data after " << m_packet_count << " packet(s)";
+            m_src_eof = true;
+
+            return false;
+        }
+
+
+        std::unique_ptr<std::istream> const m_in;
+        mock_replay_clock & m_clock;
+        visitor m_visitor;
+        visit_ctx m_ctx { };
+        mapped_ring_buffer m_buf { 256 * 1024 };
+        size_type m_available { };
+        int64_t m_packet_count { };
+        bool m_src_eof { false };
+
+    }; // end of nested class
+
     /*
      * (per-partition) callable for threads that listen for new client connections
      */
@@ -483,6 +656,8 @@ struct mock_ouch_server::pimpl final
 
         void close_client_session (int32_t const cs_ID, client_session & cs)
         {
+            cs.cancel_orders ();
+
             cs.m_data_link.reset ();
             cs.m_state = io::client_connection::state::closed;
         }
@@ -504,6 +679,39 @@ struct mock_ouch_server::pimpl final
         return m_session_date;
     }
 
+    matching_engine_type & matching_engine ()
+    {
+        return m_engine;
+    }
+
+    /*
+     * route executions caused by market data to the sessions that own the orders
+     */
+    void dispatch_market_reports (timestamp_t const now_utc)
+    {
+        auto & reports = m_engine.reports ();
+
+        for (matching_engine_type::report const & r : reports)
+        {
+            int32_t const cs_ID = (r.m_ref >> 32); // see 'matching_handler'
+
+            auto const i = m_session_partitions.find (cs_ID);
+            if (VR_UNLIKELY (i == m_session_partitions.end ())) continue;
+
+            int32_t const pix = i->second;
+            auto const si = m_partitions [pix].m_sessions.find (cs_ID);
+
+            if ((si != m_partitions [pix].m_sessions.end ()) && (si->second.m_state == io::client_connection::state::serving))
+            {
+                assert_condition (si->second.m_matching_handler);
+
+                si->second.m_matching_handler->on_market_report (pix, now_utc, r);
+            }
+        }
+
+        reports.clear ();
+    }
+
     time_action_queue & action_queue (int32_t const pix)
     {
         assert_within (pix, part_count ());
@@ -547,15 +755,20 @@ struct mock_ouch_server::pimpl final
     int32_t m_action_pending_limit { }; // set in 'start()'
     bitset32_t m_active_partitions { }; // set in 'start()'
     int32_t m_session_ID_counter { };
+    boost::unordered_map<int32_t, int32_t> m_session_partitions { }; // session ID -> partition
+    matching_engine_type m_engine { };
+    mock_replay_clock m_replay_clock { }; // [used unless sharing a 'mock_mcast_server's]
+    std::unique_ptr<market_replay> m_replay { }; // [created in 'start()' in "matching" mode only]
 
 }; // end of nested class
 //............................................................................
 //............................................................................
 
-mock_ouch_server::mock_ouch_server (scope_path const & cfg_path) :
+mock_ouch_server::mock_ouch_server (scope_path const & cfg_path, std::string const & mcast_server) :
     m_impl { std::make_unique<pimpl> (* this, cfg_path) }
 {
     dep (m_config) = "config";
+    if (! mcast_server.empty ()) dep (m_mcast_server) = mcast_server;
 }
 
 mock_ouch_server::~mock_ouch_server ()    = default; // pimpl
@@ -11,12 +11,18 @@ namespace vr
 {
 namespace market
 {
+class mock_mcast_server; // forward
 
 class mock_ouch_server final: public mc::steppable, public util::di::component, public startable
 {
     public: // ...............................................................
 
-        mock_ouch_server (scope_path const & cfg_path);
+        /**
+         * @param mcast_server if not empty, name of a @ref mock_mcast_server dep whose replay
+         *        clock "matching" mode will pace its own capture replay with (so that client
+         *        executions line up with the market data that clients see)
+         */
+        mock_ouch_server (scope_path const & cfg_path, std::string const & mcast_server = { });
         ~mock_ouch_server ();
 
     private: // ..............................................................
@@ -34,6 +40,7 @@ class mock_ouch_server final: public mc::steppable, public util::di::component,
 
 
         rt::app_cfg * m_config { }; // [dep]
+        mock_mcast_server * m_mcast_server { }; // [dep, optional]
 
         std::unique_ptr<pimpl> const m_impl;
 
@@ -3,6 +3,7 @@
 #include "vr/util/random.h"
 
 #include <algorithm>
+#include <atomic>
 
 //----------------------------------------------------------------------------
 namespace vr
@@ -61,6 +62,43 @@ random_range_split (T const range, int32_t const n, T_RND & rnd)
     return r;
 }
 
+//............................................................................
+/**
+ * maps capture timestamps to wall clock time for mock servers that replay the same
+ * capture (so that their replays stay in step with each other); the mapping is anchored
+ * by whichever replay asks first, at its then current wall clock time
+ *
+ * @note thread-safe
+ */
+class mock_replay_clock final: noncopyable
+{
+    public: // ...............................................................
+
+        /**
+         * @return wall clock time at which a packet captured at 'ts_capture' is due
+         *         (anchoring this clock to '[ts_capture, now_utc]' if not anchored yet)
+         */
+        VR_FORCEINLINE timestamp_t due_time (timestamp_t const ts_capture, timestamp_t const now_utc)
+        {
+            timestamp_t offset = m_offset.load (std::memory_order_acquire);
+
+            if (VR_UNLIKELY (! offset))
+            {
+                timestamp_t const anchor = (now_utc - ts_capture);
+
+                if (m_offset.compare_exchange_strong (offset, anchor, std::memory_order_acq_rel)) // otherwise 'offset' is set to the winner's value
+                    offset = anchor;
+            }
+
+            return (ts_capture + offset);
+        }
+
+    private: // ..............................................................
+
+        std::atomic<timestamp_t> m_offset { }; // wall clock - capture clock, zero until anchored
+
+}; // end of class
+
 } // end of 'market'
 } // end of namespace
 //----------------------------------------------------------------------------